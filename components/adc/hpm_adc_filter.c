@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_adc_filter.h"
+
+hpm_stat_t hpm_adc_avg_init(hpm_adc_avg_t *f, uint16_t ratio, uint8_t shift)
+{
+    /* the sum of ratio 16-bit samples has to fit */
+    if ((ratio == 0) || (ratio > 32768U) || (shift > 31U)) {
+        return status_invalid_argument;
+    }
+    f->ratio = ratio;
+    f->count = 0;
+    f->shift = shift;
+    f->sum = 0;
+    return status_success;
+}
+
+uint32_t hpm_adc_avg_process(hpm_adc_avg_t *f, const int32_t *in, uint32_t count, int32_t *out)
+{
+    uint32_t n = 0;
+    uint16_t ratio = f->ratio;
+    uint16_t k = f->count;
+    int32_t sum = f->sum;
+
+    for (uint32_t i = 0; i < count; i++) {
+        sum += in[i];
+        if (++k == ratio) {
+            out[n++] = sum >> f->shift;
+            sum = 0;
+            k = 0;
+        }
+    }
+    f->count = k;
+    f->sum = sum;
+    return n;
+}
+
+hpm_stat_t hpm_adc_cic_init(hpm_adc_cic_t *f, uint8_t order, uint16_t ratio, uint8_t input_bits)
+{
+    uint32_t bits = 0;
+    uint64_t gain = 1;
+
+    if ((order == 0) || (order > HPM_ADC_CIC_MAX_ORDER) || (ratio < 2U)) {
+        return status_invalid_argument;
+    }
+    /* the integrators need order * ceil(log2(ratio)) bits above the input */
+    while ((1UL << bits) < ratio) {
+        bits++;
+    }
+    bits *= order;
+    if (input_bits + bits > 31U) {
+        return status_invalid_argument;
+    }
+    memset(f, 0, sizeof(*f));
+    f->ratio = ratio;
+    f->order = order;
+    /* the gain ratio ^ order goes by a shift, a ratio that is not a power of two leaves a factor of 0.5 to 1 */
+    for (uint32_t s = 0; s < order; s++) {
+        gain *= ratio;
+    }
+    bits = 0;
+    while ((gain >> (bits + 1U)) != 0) {
+        bits++;
+    }
+    f->shift = bits;
+    if ((gain & (gain - 1U)) != 0) {
+        f->gain = (uint32_t)((((uint64_t)1 << (bits + 31U)) + gain / 2U) / gain);
+    }
+    return status_success;
+}
+
+uint32_t hpm_adc_cic_process(hpm_adc_cic_t *f, const int32_t *in, uint32_t count, int32_t *out)
+{
+    uint32_t n = 0;
+    uint32_t order = f->order;
+    uint32_t y, t;
+
+    for (uint32_t i = 0; i < count; i++) {
+        y = (uint32_t)in[i];
+        for (uint32_t s = 0; s < order; s++) {
+            f->integ[s] += y;
+            y = f->integ[s];
+        }
+        if (++f->phase == f->ratio) {
+            f->phase = 0;
+            for (uint32_t s = 0; s < order; s++) {
+                t = y;
+                y -= f->comb[s];
+                f->comb[s] = t;
+            }
+            if (f->gain == 0) {
+                out[n++] = (int32_t)y >> f->shift;
+            } else {
+                out[n++] = (int32_t)(((int64_t)(int32_t)y * f->gain) >> (f->shift + 31U));
+            }
+        }
+    }
+    return n;
+}
+
+hpm_stat_t hpm_adc_fir_init(hpm_adc_fir_t *f, const int16_t *coef, uint16_t taps, uint16_t ratio, int32_t *history)
+{
+    if ((coef == NULL) || (history == NULL) || (taps == 0) || (ratio == 0)) {
+        return status_invalid_argument;
+    }
+    f->coef = coef;
+    f->history = history;
+    f->taps = taps;
+    f->ratio = ratio;
+    f->phase = 0;
+    f->pos = 0;
+    memset(history, 0, 2U * taps * sizeof(int32_t));
+    return status_success;
+}
+
+uint32_t hpm_adc_fir_process(hpm_adc_fir_t *f, const int32_t *in, uint32_t count, int32_t *out)
+{
+    uint32_t n = 0;
+    uint32_t taps = f->taps;
+    const int16_t *coef = f->coef;
+    int32_t *window;
+    int64_t acc;
+
+    for (uint32_t i = 0; i < count; i++) {
+        /* every sample is stored twice so that the window is always contiguous */
+        f->history[f->pos] = in[i];
+        f->history[f->pos + taps] = in[i];
+        if (++f->pos == taps) {
+            f->pos = 0;
+        }
+        if (++f->phase < f->ratio) {
+            continue;
+        }
+        f->phase = 0;
+        /* oldest sample first, newest last */
+        window = &f->history[f->pos];
+        acc = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += (int64_t)coef[k] * window[taps - 1U - k];
+        }
+        out[n++] = (int32_t)((acc + ((int64_t)1 << 14)) >> 15);
+    }
+    return n;
+}
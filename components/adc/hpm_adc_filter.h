@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef HPM_ADC_FILTER_H
+#define HPM_ADC_FILTER_H
+
+#include "hpm_common.h"
+
+/**
+ * @brief ADC sample decimation stages
+ *
+ * The stages work on blocks of int32_t samples and keep their state between
+ * blocks, so a stream can be filtered in pieces of any length. Each process
+ * call returns the number of output samples; out may be the same buffer as
+ * in. The stages have no hardware dependency.
+ */
+
+#ifndef HPM_ADC_CIC_MAX_ORDER
+#define HPM_ADC_CIC_MAX_ORDER (4U)
+#endif
+
+/**
+ * @brief Oversampling average, one output per ratio inputs
+ */
+typedef struct {
+    uint16_t ratio;                 /**< inputs per output, 0 if the stage is unused */
+    uint16_t count;
+    uint8_t shift;                  /**< output = sum >> shift */
+    int32_t sum;
+} hpm_adc_avg_t;
+
+/**
+ * @brief CIC decimator
+ *
+ * The integrators wrap modulo 2^32, which the combs undo as long as the
+ * output fits in input_bits + order * ceil(log2(ratio)) <= 31 bits.
+ *
+ * The DC gain ratio ^ order is removed so that the output has the scale of
+ * the input. A power of two ratio only takes a shift; any other ratio also
+ * multiplies each output by a Q31 factor, what the shift leaves of the gain,
+ * e.g. 512 / 1000 for ratio 10 and order 3.
+ */
+typedef struct {
+    uint16_t ratio;                 /**< decimation ratio, 0 if the stage is unused */
+    uint16_t phase;
+    uint8_t order;
+    uint8_t shift;                  /**< gain bits removed from the output, floor(log2(ratio ^ order)) */
+    uint32_t gain;                  /**< Q31 2 ^ shift / ratio ^ order, 0 for a power of two ratio */
+    uint32_t integ[HPM_ADC_CIC_MAX_ORDER];
+    uint32_t comb[HPM_ADC_CIC_MAX_ORDER];
+} hpm_adc_cic_t;
+
+/**
+ * @brief FIR decimator, only the kept outputs are computed
+ */
+typedef struct {
+    const int16_t *coef;            /**< Q15 coefficients */
+    int32_t *history;               /**< 2 * taps samples */
+    uint16_t taps;
+    uint16_t ratio;                 /**< decimation ratio, 0 if the stage is unused */
+    uint16_t phase;
+    uint16_t pos;
+} hpm_adc_fir_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize an oversampling average
+ *
+ * @param [out] f stage
+ * @param [in] ratio inputs per output
+ * @param [in] shift right shift of the sum, log2(ratio) for the mean, less to gain resolution
+ * @retval status_invalid_argument if ratio is 0 or the sum could overflow for 16-bit inputs
+ */
+hpm_stat_t hpm_adc_avg_init(hpm_adc_avg_t *f, uint16_t ratio, uint8_t shift);
+
+/**
+ * @brief Run an oversampling average over a block
+ *
+ * @param [in,out] f stage
+ * @param [in] in input samples
+ * @param [in] count number of input samples
+ * @param [out] out output samples, up to count / ratio + 1
+ * @retval number of output samples
+ */
+uint32_t hpm_adc_avg_process(hpm_adc_avg_t *f, const int32_t *in, uint32_t count, int32_t *out);
+
+/**
+ * @brief Initialize a CIC decimator
+ *
+ * @param [out] f stage
+ * @param [in] order number of integrator and comb stages, 1 to HPM_ADC_CIC_MAX_ORDER
+ * @param [in] ratio decimation ratio, 2 or more
+ * @param [in] input_bits significant bits of the input samples
+ * @retval status_invalid_argument if the parameters are out of range or the gain does not fit
+ */
+hpm_stat_t hpm_adc_cic_init(hpm_adc_cic_t *f, uint8_t order, uint16_t ratio, uint8_t input_bits);
+
+/**
+ * @brief Run a CIC decimator over a block
+ *
+ * @param [in,out] f stage
+ * @param [in] in input samples
+ * @param [in] count number of input samples
+ * @param [out] out output samples, up to count / ratio + 1
+ * @retval number of output samples
+ */
+uint32_t hpm_adc_cic_process(hpm_adc_cic_t *f, const int32_t *in, uint32_t count, int32_t *out);
+
+/**
+ * @brief Initialize a FIR decimator
+ *
+ * @param [out] f stage
+ * @param [in] coef Q15 coefficients, kept by reference
+ * @param [in] taps number of coefficients
+ * @param [in] ratio decimation ratio, 1 for plain filtering
+ * @param [in] history state of 2 * taps samples
+ * @retval status_invalid_argument if a parameter is 0 or NULL
+ */
+hpm_stat_t hpm_adc_fir_init(hpm_adc_fir_t *f, const int16_t *coef, uint16_t taps, uint16_t ratio, int32_t *history);
+
+/**
+ * @brief Run a FIR decimator over a block
+ *
+ * @param [in,out] f stage
+ * @param [in] in input samples
+ * @param [in] count number of input samples
+ * @param [out] out output samples, up to count / ratio + 1
+ * @retval number of output samples
+ */
+uint32_t hpm_adc_fir_process(hpm_adc_fir_t *f, const int32_t *in, uint32_t count, int32_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_ADC_FILTER_H */
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_adc_stream.h"
+#include "hpm_l1c_drv.h"
+
+static void hpm_adc_stream_invalidate(uint32_t *start, uint32_t words)
+{
+    uint32_t aligned_start, aligned_end;
+
+    if (l1c_dc_is_enabled()) {
+        aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)start);
+        aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)(start + words));
+        l1c_dc_invalidate(aligned_start, aligned_end - aligned_start);
+    }
+}
+
+static uint8_t hpm_adc_stream_cycle_bit(hpm_adc_stream_t *stream, uint32_t index)
+{
+    if (stream->adc.module == adc_module_adc12) {
+#ifdef HPMSOC_HAS_HPMSDK_ADC12
+        return ((adc12_seq_dma_data_t *)&stream->ring[index])->cycle_bit;
+#endif
+    } else if (stream->adc.module == adc_module_adc16) {
+#ifdef HPMSOC_HAS_HPMSDK_ADC16
+        return ((adc16_seq_dma_data_t *)&stream->ring[index])->cycle_bit;
+#endif
+    }
+    return 0;
+}
+
+/* sort the conversions of a half by sequence number, the slot of a conversion is not taken from its position */
+static void hpm_adc_stream_demux(hpm_adc_stream_t *stream, const uint32_t *words, uint32_t len)
+{
+    uint32_t *count = stream->block.count;
+    uint32_t limit = stream->half_len / stream->seq_len;
+    uint32_t seq;
+
+    memset(count, 0, sizeof(stream->block.count));
+    if (stream->adc.module == adc_module_adc12) {
+#ifdef HPMSOC_HAS_HPMSDK_ADC12
+        const adc12_seq_dma_data_t *data = (const adc12_seq_dma_data_t *)words;
+        for (uint32_t i = 0; i < len; i++) {
+            seq = data[i].seq_num;
+            if ((seq < stream->seq_len) && (count[seq] < limit)) {
+                stream->work[seq][count[seq]++] = data[i].result;
+            } else {
+                stream->stat.dropped++;
+            }
+        }
+#endif
+    } else if (stream->adc.module == adc_module_adc16) {
+#ifdef HPMSOC_HAS_HPMSDK_ADC16
+        const adc16_seq_dma_data_t *data = (const adc16_seq_dma_data_t *)words;
+        for (uint32_t i = 0; i < len; i++) {
+            seq = data[i].seq_num;
+            if ((seq < stream->seq_len) && (count[seq] < limit)) {
+                stream->work[seq][count[seq]++] = data[i].result;
+            } else {
+                stream->stat.dropped++;
+            }
+        }
+#endif
+    }
+}
+
+static uint32_t hpm_adc_stream_filter(hpm_adc_stream_chain_t *chain, int32_t *samples, uint32_t count)
+{
+    if (chain->avg.ratio != 0) {
+        count = hpm_adc_avg_process(&chain->avg, samples, count, samples);
+    }
+    if (chain->cic.ratio != 0) {
+        count = hpm_adc_cic_process(&chain->cic, samples, count, samples);
+    }
+    if (chain->fir.ratio != 0) {
+        count = hpm_adc_fir_process(&chain->fir, samples, count, samples);
+    }
+    return count;
+}
+
+hpm_stat_t hpm_adc_stream_init(hpm_adc_stream_t *stream, const hpm_adc_stream_config_t *config)
+{
+    adc_dma_config_t dma_config;
+    uint32_t aligned_start, aligned_end;
+
+    if ((config->ring == NULL) || (config->seq_len == 0) || (config->seq_len > ADC_SOC_SEQ_MAX_LEN)
+        || (config->ring_len == 0) || (config->ring_len > ADC_SOC_SEQ_MAX_DMA_BUFF_LEN_IN_4BYTES)
+        || ((config->ring_len % (2U * config->seq_len)) != 0) || (((uint32_t)config->ring & 0x3U) != 0)) {
+        return status_invalid_argument;
+    }
+    for (uint32_t i = 0; i < config->seq_len; i++) {
+        if (config->work[i] == NULL) {
+            return status_invalid_argument;
+        }
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->adc = config->adc;
+    stream->ring = config->ring;
+    stream->half_len = config->ring_len / 2U;
+    stream->seq_len = config->seq_len;
+    /* the DMA starts on a zeroed ring and sets the cycle bit in its first pass */
+    stream->cycle = 1;
+    memcpy(stream->work, config->work, sizeof(stream->work));
+    stream->chain = config->chain;
+    stream->callback = config->callback;
+    stream->cb_context = config->cb_context;
+
+    dma_config.module = config->adc.module;
+    dma_config.adc_base = config->adc.adc_base;
+    if (config->adc.module == adc_module_adc12) {
+#ifdef HPMSOC_HAS_HPMSDK_ADC12
+        dma_config.config.adc12.start_addr = (uint32_t *)core_local_mem_to_sys_address(config->running_core, (uint32_t)config->ring);
+        dma_config.config.adc12.buff_len_in_4bytes = config->ring_len;
+        dma_config.config.adc12.stop_en = false;
+        dma_config.config.adc12.stop_pos = 0;
+#endif
+    } else if (config->adc.module == adc_module_adc16) {
+#ifdef HPMSOC_HAS_HPMSDK_ADC16
+        dma_config.config.adc16.start_addr = (uint32_t *)core_local_mem_to_sys_address(config->running_core, (uint32_t)config->ring);
+        dma_config.config.adc16.buff_len_in_4bytes = config->ring_len;
+        dma_config.config.adc16.stop_en = false;
+        dma_config.config.adc16.stop_pos = 0;
+#endif
+    } else {
+        return status_invalid_argument;
+    }
+    hpm_adc_init_seq_dma(&dma_config);
+
+    /* the driver clears the ring with the CPU */
+    if (l1c_dc_is_enabled()) {
+        aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)config->ring);
+        aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)(config->ring + config->ring_len));
+        l1c_dc_flush(aligned_start, aligned_end - aligned_start);
+    }
+    return status_success;
+}
+
+static bool hpm_adc_stream_half_written(hpm_adc_stream_t *stream, uint32_t half, uint8_t cycle)
+{
+    uint32_t last = (half + 1U) * stream->half_len - 1U;
+
+    hpm_adc_stream_invalidate(&stream->ring[last], 1);
+    return hpm_adc_stream_cycle_bit(stream, last) == cycle;
+}
+
+bool hpm_adc_stream_poll(hpm_adc_stream_t *stream)
+{
+    uint32_t start;
+    uint32_t *words;
+    uint8_t cycle;
+    uint8_t other;
+    uint8_t other_cycle;
+
+    if (stream->held) {
+        return false;
+    }
+    if (!hpm_adc_stream_half_written(stream, stream->next_half, stream->cycle)) {
+        /*
+         * Either the half is still being written, or the DMA has lapped it and
+         * its cycle bit is back to the old value. In the latter case the half
+         * written after it is complete; continue from there.
+         */
+        other = stream->next_half ^ 1U;
+        other_cycle = (stream->next_half == 0) ? stream->cycle : (stream->cycle ^ 1U);
+        if (!hpm_adc_stream_half_written(stream, other, other_cycle)) {
+            return false;
+        }
+        stream->stat.overruns++;
+        stream->next_half = other;
+        stream->cycle = other_cycle;
+    }
+    start = stream->next_half * stream->half_len;
+    words = &stream->ring[start];
+    cycle = stream->cycle;
+
+    hpm_adc_stream_invalidate(words, stream->half_len);
+    hpm_adc_stream_demux(stream, words, stream->half_len);
+    stream->next_half ^= 1U;
+    if (stream->next_half == 0) {
+        stream->cycle ^= 1U;
+    }
+
+    /*
+     * The first word is the first one the DMA rewrites on its next pass. If it
+     * changed, the half was torn while it was sorted: drop it before the
+     * decimation chains see it, the other half is complete by now.
+     */
+    hpm_adc_stream_invalidate(words, 1);
+    if (hpm_adc_stream_cycle_bit(stream, start) != cycle) {
+        stream->stat.overruns++;
+        return false;
+    }
+
+    for (uint32_t i = 0; i < stream->seq_len; i++) {
+        if (stream->chain != NULL) {
+            stream->block.count[i] = hpm_adc_stream_filter(&stream->chain[i], stream->work[i], stream->block.count[i]);
+        }
+        stream->block.samples[i] = stream->work[i];
+    }
+    stream->block.index = stream->stat.blocks++;
+
+    stream->held = true;
+    if (stream->callback != NULL) {
+        stream->callback(stream, &stream->block, stream->cb_context);
+    }
+    return true;
+}
+
+const hpm_adc_stream_block_t *hpm_adc_stream_get_block(hpm_adc_stream_t *stream)
+{
+    return stream->held ? &stream->block : NULL;
+}
+
+void hpm_adc_stream_release(hpm_adc_stream_t *stream)
+{
+    stream->held = false;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef HPM_ADC_STREAM_H
+#define HPM_ADC_STREAM_H
+
+#include "hpm_adc.h"
+#include "hpm_adc_filter.h"
+
+/**
+ * @brief Continuous ADC acquisition
+ *
+ * The sequence mode DMA of the ADC writes into a ring buffer without end.
+ * The ring is split into two halves. Once a half has been written, which is
+ * seen from the cycle bit of its last word, hpm_adc_stream_poll() sorts its
+ * conversions by sequence position into one stream per sequence slot. It then
+ * runs the decimation chain of each stream and hands the result to the
+ * consumer as a block. The block points into the stream work buffers and
+ * stays valid until hpm_adc_stream_release(); meanwhile the DMA keeps
+ * filling the other half.
+ *
+ * hpm_adc_stream_poll() may be called from the sequence complete interrupt
+ * or from a task, as long as it is called at least once per half.
+ */
+
+/**
+ * @brief Decimation chain of a stream, stages with ratio 0 are skipped
+ */
+typedef struct {
+    hpm_adc_avg_t avg;              /**< first stage */
+    hpm_adc_cic_t cic;              /**< second stage */
+    hpm_adc_fir_t fir;              /**< third stage */
+} hpm_adc_stream_chain_t;
+
+/**
+ * @brief Block of filtered samples, one stream per sequence slot
+ */
+typedef struct {
+    int32_t *samples[ADC_SOC_SEQ_MAX_LEN];
+    uint32_t count[ADC_SOC_SEQ_MAX_LEN];
+    uint32_t index;                 /**< number of the block since start */
+} hpm_adc_stream_block_t;
+
+struct hpm_adc_stream;
+
+/**
+ * @brief Block callback, called from hpm_adc_stream_poll()
+ */
+typedef void (*hpm_adc_stream_callback_t)(struct hpm_adc_stream *stream, const hpm_adc_stream_block_t *block, void *cb_context);
+
+/**
+ * @brief Stream configuration
+ */
+typedef struct {
+    adc_type adc;                   /**< ADC running the sequence */
+    uint8_t running_core;
+    uint32_t *ring;                 /**< ring buffer, 4-byte aligned */
+    uint32_t ring_len;              /**< words, a multiple of 2 * seq_len */
+    uint8_t seq_len;                /**< conversions per sequence */
+    int32_t *work[ADC_SOC_SEQ_MAX_LEN];     /**< per slot, ring_len / 2 / seq_len samples */
+    hpm_adc_stream_chain_t *chain;  /**< seq_len chains initialized with the stage init functions, NULL for raw samples */
+    hpm_adc_stream_callback_t callback;
+    void *cb_context;
+} hpm_adc_stream_config_t;
+
+/**
+ * @brief Stream statistics
+ */
+typedef struct {
+    uint32_t blocks;                /**< blocks delivered */
+    uint32_t overruns;              /**< halves rewritten by the DMA before they were read */
+    uint32_t dropped;               /**< conversions with a sequence number outside the sequence */
+} hpm_adc_stream_stat_t;
+
+/**
+ * @brief Stream
+ */
+typedef struct hpm_adc_stream {
+    adc_type adc;
+    uint32_t *ring;
+    uint32_t half_len;
+    uint8_t seq_len;
+    uint8_t next_half;              /**< half to be read next */
+    uint8_t cycle;                  /**< cycle bit the DMA writes into the next half */
+    volatile bool held;             /**< block handed out and not yet released */
+    int32_t *work[ADC_SOC_SEQ_MAX_LEN];
+    hpm_adc_stream_chain_t *chain;
+    hpm_adc_stream_block_t block;
+    hpm_adc_stream_callback_t callback;
+    void *cb_context;
+    hpm_adc_stream_stat_t stat;
+} hpm_adc_stream_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize a stream and its sequence DMA
+ *
+ * @note The channels and the sequence are configured by the caller with
+ * hpm_adc_set_sequence_config(); the sequence is started afterwards.
+ *
+ * @param [out] stream stream
+ * @param [in] config configuration
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the ring or the work buffers do not fit the sequence
+ */
+hpm_stat_t hpm_adc_stream_init(hpm_adc_stream_t *stream, const hpm_adc_stream_config_t *config);
+
+/**
+ * @brief Process the next half of the ring once it has been written
+ *
+ * A half the DMA started to rewrite while it was processed is dropped and
+ * counted as overrun, no block is delivered for it.
+ *
+ * @param [in] stream stream
+ * @retval true if a block was delivered
+ */
+bool hpm_adc_stream_poll(hpm_adc_stream_t *stream);
+
+/**
+ * @brief Get the delivered block
+ *
+ * @param [in] stream stream
+ * @retval block, or NULL if none is held
+ */
+const hpm_adc_stream_block_t *hpm_adc_stream_get_block(hpm_adc_stream_t *stream);
+
+/**
+ * @brief Hand the delivered block back, the next half can be processed
+ *
+ * @param [in] stream stream
+ */
+void hpm_adc_stream_release(hpm_adc_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_ADC_STREAM_H */
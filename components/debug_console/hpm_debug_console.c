@@ -22,6 +22,10 @@ hpm_stat_t console_init(console_config_t *cfg)
         uart_default_config((UART_Type *)cfg->base, &config);
         config.src_freq_in_hz = cfg->src_freq_in_hz;
         config.baudrate = cfg->baudrate;
+#if defined(CONSOLE_BUFFERED_TX) && CONSOLE_BUFFERED_TX
+        /* TX DMA requests are only consumed once console_buffered_init() set up the channel */
+        config.dma_enable = true;
+#endif
         stat = uart_init((UART_Type *)cfg->base, &config);
         if (status_success == stat) {
             g_console_uart = (UART_Type *)cfg->base;
@@ -31,6 +35,11 @@ hpm_stat_t console_init(console_config_t *cfg)
     return stat;
 }
 
+uint32_t console_get_base(void)
+{
+    return (uint32_t)g_console_uart;
+}
+
 uint8_t console_receive_byte(void)
 {
     uint8_t c;
@@ -41,6 +50,12 @@ uint8_t console_receive_byte(void)
 
 void console_send_byte(uint8_t c)
 {
+#if defined(CONSOLE_BUFFERED_TX) && CONSOLE_BUFFERED_TX
+    if (console_buffered_is_active()) {
+        console_buffered_write(&c, 1);
+        return;
+    }
+#endif
     while (status_success != uart_send_byte(g_console_uart, c)) {
     }
 }
@@ -65,6 +80,12 @@ int __SEGGER_RTL_X_file_write(__SEGGER_RTL_FILE *file, const char *data, unsigne
 {
     unsigned int count;
     (void)file;
+#if defined(CONSOLE_BUFFERED_TX) && CONSOLE_BUFFERED_TX
+    if (console_buffered_is_active()) {
+        console_buffered_write_text(data, size);
+        return size;
+    }
+#endif
     for (count = 0; count < size; count++) {
         if (data[count] == '\n') {
             while (status_success != uart_send_byte(g_console_uart, '\r')) {
@@ -126,6 +147,12 @@ int _write(int file, char *data, int size)
 {
     int count;
     (void)file;
+#if defined(CONSOLE_BUFFERED_TX) && CONSOLE_BUFFERED_TX
+    if (console_buffered_is_active()) {
+        console_buffered_write_text(data, size);
+        return size;
+    }
+#endif
     for (count = 0; count < size; count++) {
         if (data[count] == '\n') {
             while (status_success != uart_send_byte(g_console_uart, '\r')) {
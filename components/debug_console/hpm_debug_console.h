@@ -18,6 +18,76 @@ typedef struct {
     uint32_t baudrate;
 } console_config_t;
 
+#if defined(CONSOLE_BUFFERED_TX) && CONSOLE_BUFFERED_TX
+/*
+ * Buffered console backend
+ *
+ * Output of printf and console_send_byte is copied into a TX ring and sent by
+ * UART TX DMA through dma_mgr, the caller never waits for the wire.
+ * Needs dma_mgr (CONFIG_DMA_MGR), dma_mgr_init() and console_init() have to
+ * be called before console_buffered_init().
+ */
+
+#define CONSOLE_LOG_MAX_ARGS (6U)
+
+/* Policy when the TX ring has not enough space */
+typedef enum {
+    console_tx_policy_drop_new = 0,     /**< drop the new output */
+    console_tx_policy_overwrite,        /**< discard queued output not yet handed to DMA */
+    console_tx_policy_block,            /**< wait for space, drop_new when called with interrupts disabled */
+} console_tx_policy_t;
+
+typedef struct {
+    uint8_t *tx_buf;            /**< TX ring, noncacheable memory, e.g. ATTR_PLACE_AT_NONCACHEABLE */
+    uint32_t tx_buf_size;       /**< TX ring size, power of 2 */
+    console_tx_policy_t policy; /**< TX ring full policy */
+    uint8_t dmamux_src;         /**< UART TX DMA request, e.g. BOARD_CONSOLE_UART_TX_DMA_REQ */
+    uint8_t running_core;       /**< core running the console, used for address translation */
+    uint32_t dma_irq_priority;  /**< DMA interrupt priority */
+    void *log_buf;              /**< deferred log record buffer, NULL disables console_log */
+    uint32_t log_buf_size;      /**< deferred log record buffer size in bytes */
+} console_buffered_config_t;
+
+typedef struct {
+    uint32_t written;           /**< bytes accepted into the TX ring */
+    uint32_t dropped;           /**< bytes dropped by drop_new policy */
+    uint32_t overwritten;       /**< queued bytes discarded by overwrite policy */
+    uint32_t dma_transfers;     /**< DMA transfers started */
+    uint32_t max_level;         /**< TX ring high-water in bytes */
+    uint32_t log_records;       /**< deferred log records stored */
+    uint32_t log_dropped;       /**< deferred log records dropped */
+} console_tx_stat_t;
+
+/* deferred log record, the format string and string arguments must stay valid */
+typedef struct {
+    const char *fmt;
+    uint32_t argc;
+    uintptr_t args[CONSOLE_LOG_MAX_ARGS];
+} console_log_record_t;
+
+#define CONSOLE_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, N, ...) N
+#define CONSOLE_LOG_NARGS(...) CONSOLE_LOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define CONSOLE_LOG_CAST_(x) ((uintptr_t)(x))
+#define CONSOLE_LOG_ARGS_0()
+#define CONSOLE_LOG_ARGS_1(a) , CONSOLE_LOG_CAST_(a)
+#define CONSOLE_LOG_ARGS_2(a, ...) , CONSOLE_LOG_CAST_(a) CONSOLE_LOG_ARGS_1(__VA_ARGS__)
+#define CONSOLE_LOG_ARGS_3(a, ...) , CONSOLE_LOG_CAST_(a) CONSOLE_LOG_ARGS_2(__VA_ARGS__)
+#define CONSOLE_LOG_ARGS_4(a, ...) , CONSOLE_LOG_CAST_(a) CONSOLE_LOG_ARGS_3(__VA_ARGS__)
+#define CONSOLE_LOG_ARGS_5(a, ...) , CONSOLE_LOG_CAST_(a) CONSOLE_LOG_ARGS_4(__VA_ARGS__)
+#define CONSOLE_LOG_ARGS_6(a, ...) , CONSOLE_LOG_CAST_(a) CONSOLE_LOG_ARGS_5(__VA_ARGS__)
+#define CONSOLE_LOG_ARGS__(n, ...) CONSOLE_LOG_ARGS_##n(__VA_ARGS__)
+#define CONSOLE_LOG_ARGS_(n, ...) CONSOLE_LOG_ARGS__(n, ##__VA_ARGS__)
+
+/*
+ * Deferred log: stores the format pointer and up to CONSOLE_LOG_MAX_ARGS raw
+ * arguments, formatting happens later in console_log_process(). Only integer,
+ * char and pointer conversions up to the pointer width are supported, no
+ * floating point or 64-bit arguments.
+ */
+#define console_log(fmt, ...) \
+    console_log_deferred((fmt), CONSOLE_LOG_NARGS(__VA_ARGS__) CONSOLE_LOG_ARGS_(CONSOLE_LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__))
+#endif
+
 
 #if defined(__cplusplus)
 extern "C" {
@@ -25,10 +95,40 @@ extern "C" {
 
 hpm_stat_t console_init(console_config_t *cfg);
 
+/* base address of the console peripheral, 0 before console_init() succeeded */
+uint32_t console_get_base(void);
+
 uint8_t console_receive_byte(void);
 
 void console_send_byte(uint8_t c);
 
+#if defined(CONSOLE_BUFFERED_TX) && CONSOLE_BUFFERED_TX
+void console_buffered_get_default_config(console_buffered_config_t *cfg);
+
+hpm_stat_t console_buffered_init(console_buffered_config_t *cfg);
+
+/* true once console_buffered_init() succeeded, output goes through the TX ring then */
+bool console_buffered_is_active(void);
+
+/* copy data into the TX ring, returns number of bytes accepted */
+uint32_t console_buffered_write(const uint8_t *data, uint32_t size);
+
+/* same as console_buffered_write, '\n' is sent as "\r\n" */
+uint32_t console_buffered_write_text(const char *data, uint32_t size);
+
+/* wait until the TX ring is empty, drains by polling when called with interrupts disabled */
+void console_buffered_flush(void);
+
+void console_buffered_get_stat(console_tx_stat_t *stat);
+
+void console_buffered_reset_stat(void);
+
+hpm_stat_t console_log_deferred(const char *fmt, uint32_t argc, ...);
+
+/* format and output up to max_records deferred records, call from a low priority task */
+uint32_t console_log_process(uint32_t max_records);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif /* __cplusplus */
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "hpm_debug_console.h"
+#include "hpm_uart_drv.h"
+#include "hpm_dma_mgr.h"
+
+/* producers run in tasks and interrupts, the ring is drained from the DMA interrupt */
+#ifndef CONSOLE_BUFFERED_ENTER_CRITICAL
+#include "hpm_interrupt.h"
+#define CONSOLE_BUFFERED_ENTER_CRITICAL()          disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define CONSOLE_BUFFERED_EXIT_CRITICAL(level)      restore_global_irq((level) & CSR_MSTATUS_MIE_MASK)
+#define CONSOLE_BUFFERED_IRQ_WAS_ENABLED(level)    (((level) & CSR_MSTATUS_MIE_MASK) != 0U)
+#endif
+
+typedef struct {
+    dma_resource_t dma;
+    uint8_t *buf;
+    uint32_t size;
+    volatile uint32_t head;         /* next byte written by producers */
+    volatile uint32_t tail;         /* next byte handed to DMA */
+    volatile uint32_t dma_len;      /* bytes of the ongoing DMA transfer, ending at tail */
+    console_tx_policy_t policy;
+    uint8_t running_core;
+    console_log_record_t *log;
+    uint32_t log_count;
+    volatile uint32_t log_head;
+    volatile uint32_t log_tail;
+    console_tx_stat_t stat;
+    bool initialized;
+} console_buffered_t;
+
+static console_buffered_t s_console;
+
+static inline UART_Type *console_uart(void)
+{
+    return (UART_Type *)console_get_base();
+}
+
+static inline uint32_t console_tx_level(void)
+{
+    return s_console.head - s_console.tail + s_console.dma_len;
+}
+
+/* called with interrupts disabled or from the DMA ISR */
+static void console_tx_start_dma(void)
+{
+    uint32_t offset;
+    uint32_t len;
+
+    if ((s_console.dma_len != 0U) || (s_console.head == s_console.tail)) {
+        return;
+    }
+    offset = s_console.tail & (s_console.size - 1U);
+    len = s_console.head - s_console.tail;
+    if (len > (s_console.size - offset)) {
+        len = s_console.size - offset;
+    }
+    dma_mgr_set_chn_src_addr(&s_console.dma,
+                             core_local_mem_to_sys_address(s_console.running_core, (uint32_t)&s_console.buf[offset]));
+    dma_mgr_set_chn_transize(&s_console.dma, len);
+    s_console.tail += len;
+    s_console.dma_len = len;
+    s_console.stat.dma_transfers++;
+    dma_mgr_enable_channel(&s_console.dma);
+}
+
+static void console_tx_dma_tc_callback(DMA_Type *base, uint32_t channel, void *cb_data_ptr)
+{
+    (void)base;
+    (void)channel;
+    (void)cb_data_ptr;
+
+    s_console.dma_len = 0;
+    console_tx_start_dma();
+}
+
+/* called with interrupts disabled, needed is the size after '\n' translation */
+static bool console_tx_reserve(uint32_t needed)
+{
+    uint32_t free_size = s_console.size - console_tx_level();
+
+    if (needed <= free_size) {
+        return true;
+    }
+    if ((s_console.policy == console_tx_policy_overwrite) && (needed <= (s_console.size - s_console.dma_len))) {
+        /* the ongoing DMA transfer can not be discarded, everything queued behind it can */
+        s_console.stat.overwritten += s_console.head - s_console.tail;
+        s_console.head = s_console.tail;
+        return true;
+    }
+    return false;
+}
+
+static void console_tx_put(const uint8_t *data, uint32_t size, bool crlf)
+{
+    uint32_t mask = s_console.size - 1U;
+    uint32_t head = s_console.head;
+
+    for (uint32_t i = 0; i < size; i++) {
+        if (crlf && (data[i] == '\n')) {
+            s_console.buf[head++ & mask] = '\r';
+        }
+        s_console.buf[head++ & mask] = data[i];
+    }
+    s_console.head = head;
+}
+
+static uint32_t console_tx_write(const uint8_t *data, uint32_t size, bool crlf)
+{
+    uint32_t needed = size;
+    uint32_t level;
+    uint32_t used;
+
+    if (crlf) {
+        for (uint32_t i = 0; i < size; i++) {
+            if (data[i] == '\n') {
+                needed++;
+            }
+        }
+    }
+
+    for (;;) {
+        level = CONSOLE_BUFFERED_ENTER_CRITICAL();
+        if (console_tx_reserve(needed)) {
+            break;
+        }
+        /* blocking needs the DMA interrupt, never wait with interrupts disabled */
+        if ((needed > s_console.size) || (s_console.policy != console_tx_policy_block)
+         || !CONSOLE_BUFFERED_IRQ_WAS_ENABLED(level)) {
+            s_console.stat.dropped += size;
+            CONSOLE_BUFFERED_EXIT_CRITICAL(level);
+            return 0;
+        }
+        CONSOLE_BUFFERED_EXIT_CRITICAL(level);
+    }
+
+    console_tx_put(data, size, crlf);
+    s_console.stat.written += size;
+    used = console_tx_level();
+    if (used > s_console.stat.max_level) {
+        s_console.stat.max_level = used;
+    }
+    console_tx_start_dma();
+    CONSOLE_BUFFERED_EXIT_CRITICAL(level);
+
+    return size;
+}
+
+void console_buffered_get_default_config(console_buffered_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->policy = console_tx_policy_drop_new;
+    cfg->dma_irq_priority = 1;
+}
+
+hpm_stat_t console_buffered_init(console_buffered_config_t *cfg)
+{
+    hpm_stat_t stat;
+    dma_mgr_chn_conf_t chn_config;
+
+    UART_Type *uart = console_uart();
+
+    if ((uart == NULL) || (cfg->tx_buf == NULL) || (cfg->tx_buf_size == 0U)
+     || ((cfg->tx_buf_size & (cfg->tx_buf_size - 1U)) != 0U)
+     || ((cfg->log_buf != NULL) && (cfg->log_buf_size < sizeof(console_log_record_t)))) {
+        return status_invalid_argument;
+    }
+
+    memset(&s_console, 0, sizeof(s_console));
+    s_console.buf = cfg->tx_buf;
+    s_console.size = cfg->tx_buf_size;
+    s_console.policy = cfg->policy;
+    s_console.running_core = cfg->running_core;
+    s_console.log = (console_log_record_t *)cfg->log_buf;
+    s_console.log_count = (cfg->log_buf != NULL) ? (cfg->log_buf_size / sizeof(console_log_record_t)) : 0U;
+
+    stat = dma_mgr_request_resource(&s_console.dma);
+    if (stat != status_success) {
+        return stat;
+    }
+
+    dma_mgr_get_default_chn_config(&chn_config);
+    chn_config.en_dmamux = true;
+    chn_config.dmamux_src = cfg->dmamux_src;
+    chn_config.src_width = DMA_MGR_TRANSFER_WIDTH_BYTE;
+    chn_config.dst_width = DMA_MGR_TRANSFER_WIDTH_BYTE;
+    chn_config.src_addr_ctrl = DMA_MGR_ADDRESS_CONTROL_INCREMENT;
+    chn_config.dst_addr_ctrl = DMA_MGR_ADDRESS_CONTROL_FIXED;
+    chn_config.src_mode = DMA_MGR_HANDSHAKE_MODE_NORMAL;
+    chn_config.dst_mode = DMA_MGR_HANDSHAKE_MODE_HANDSHAKE;
+    chn_config.src_addr = core_local_mem_to_sys_address(cfg->running_core, (uint32_t)cfg->tx_buf);
+    chn_config.dst_addr = (uint32_t)&uart->THR;
+    chn_config.size_in_byte = 1;
+    stat = dma_mgr_setup_channel(&s_console.dma, &chn_config);
+    if (stat == status_success) {
+        stat = dma_mgr_install_chn_tc_callback(&s_console.dma, console_tx_dma_tc_callback, NULL);
+    }
+    if (stat == status_success) {
+        stat = dma_mgr_enable_chn_irq(&s_console.dma, DMA_MGR_INTERRUPT_MASK_TC);
+    }
+    if (stat == status_success) {
+        stat = dma_mgr_enable_dma_irq_with_priority(&s_console.dma, cfg->dma_irq_priority);
+    }
+    if (stat != status_success) {
+        dma_mgr_release_resource(&s_console.dma);
+        return stat;
+    }
+
+    /* let the polled output written so far leave the FIFO before DMA takes over */
+    while (status_success != uart_flush(uart)) {
+    }
+    s_console.initialized = true;
+
+    return status_success;
+}
+
+bool console_buffered_is_active(void)
+{
+    return s_console.initialized;
+}
+
+uint32_t console_buffered_write(const uint8_t *data, uint32_t size)
+{
+    return console_tx_write(data, size, false);
+}
+
+uint32_t console_buffered_write_text(const char *data, uint32_t size)
+{
+    return console_tx_write((const uint8_t *)data, size, true);
+}
+
+/* called with interrupts disabled, the TC interrupt can not complete the transfers */
+static void console_tx_drain_polled(void)
+{
+    uint32_t status;
+
+    while (console_tx_level() != 0U) {
+        if (s_console.dma_len != 0U) {
+            /* reading the status clears TC, no stale callback runs once interrupts are back */
+            do {
+                if (status_success != dma_mgr_check_chn_transfer_status(&s_console.dma, &status)) {
+                    return;
+                }
+            } while (status == DMA_MGR_CHANNEL_STATUS_ONGOING);
+            s_console.dma_len = 0;
+        }
+        console_tx_start_dma();
+    }
+}
+
+void console_buffered_flush(void)
+{
+    uint32_t level = CONSOLE_BUFFERED_ENTER_CRITICAL();
+
+    if (!CONSOLE_BUFFERED_IRQ_WAS_ENABLED(level)) {
+        console_tx_drain_polled();
+    }
+    CONSOLE_BUFFERED_EXIT_CRITICAL(level);
+    while (console_tx_level() != 0U) {
+    }
+    while (status_success != uart_flush(console_uart())) {
+    }
+}
+
+void console_buffered_get_stat(console_tx_stat_t *stat)
+{
+    uint32_t level = CONSOLE_BUFFERED_ENTER_CRITICAL();
+    *stat = s_console.stat;
+    CONSOLE_BUFFERED_EXIT_CRITICAL(level);
+}
+
+void console_buffered_reset_stat(void)
+{
+    uint32_t level = CONSOLE_BUFFERED_ENTER_CRITICAL();
+    memset(&s_console.stat, 0, sizeof(s_console.stat));
+    CONSOLE_BUFFERED_EXIT_CRITICAL(level);
+}
+
+hpm_stat_t console_log_deferred(const char *fmt, uint32_t argc, ...)
+{
+    console_log_record_t *record;
+    va_list ap;
+    uint32_t level;
+
+    if ((s_console.log_count == 0U) || (fmt == NULL) || (argc > CONSOLE_LOG_MAX_ARGS)) {
+        return status_invalid_argument;
+    }
+
+    level = CONSOLE_BUFFERED_ENTER_CRITICAL();
+    if ((s_console.log_head - s_console.log_tail) >= s_console.log_count) {
+        s_console.stat.log_dropped++;
+        CONSOLE_BUFFERED_EXIT_CRITICAL(level);
+        return status_fail;
+    }
+    record = &s_console.log[s_console.log_head % s_console.log_count];
+    record->fmt = fmt;
+    record->argc = argc;
+    va_start(ap, argc);
+    for (uint32_t i = 0; i < argc; i++) {
+        record->args[i] = va_arg(ap, uintptr_t);
+    }
+    va_end(ap);
+    s_console.log_head++;
+    s_console.stat.log_records++;
+    CONSOLE_BUFFERED_EXIT_CRITICAL(level);
+
+    return status_success;
+}
+
+uint32_t console_log_process(uint32_t max_records)
+{
+    console_log_record_t record;
+    uint32_t count = 0;
+
+    while ((count < max_records) && (s_console.log_tail != s_console.log_head)) {
+        record = s_console.log[s_console.log_tail % s_console.log_count];
+        s_console.log_tail++;
+        /* unused arguments are ignored by printf */
+        printf(record.fmt, record.args[0], record.args[1], record.args[2],
+               record.args[3], record.args[4], record.args[5]);
+        count++;
+    }
+
+    return count;
+}
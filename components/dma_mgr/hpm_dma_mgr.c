@@ -9,6 +9,11 @@
 #include "hpm_dma_mgr.h"
 #include "hpm_soc.h"
 
+#ifndef HPM_DMA_MGR_ENTER_CRITICAL
+#define HPM_DMA_MGR_ENTER_CRITICAL()     disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define HPM_DMA_MGR_EXIT_CRITICAL(level) restore_global_irq(level)
+#endif
+
 /*****************************************************************************************************************
  *
  *  Definitions
@@ -35,6 +40,16 @@ typedef struct _dma_channel_context {
     dma_mgr_chn_cb_t abort_cb;                       /**< DMA channel abort callback */
 } dma_chn_context_t;
 
+/**
+ * @brief Pending interrupt status of all channels, bit n stands for channel n
+ */
+typedef struct _dma_mgr_pending {
+    uint32_t tc;
+    uint32_t half_tc;
+    uint32_t error;
+    uint32_t abort;
+} dma_mgr_pending_t;
+
 /**
  * @brief DMA Manager Context Structure
  *
@@ -83,33 +98,72 @@ static dma_mgr_context_t s_dma_mngr_ctx;
  *  Codes
  *
  *****************************************************************************************************************/
+/*
+ * Read and clear the pending interrupt status of all channels at once,
+ * bit n of each word stands for channel n
+ */
+static void dma_mgr_fetch_pending(DMA_Type *ptr, dma_mgr_pending_t *pending)
+{
+#ifdef HPMSOC_HAS_HPMSDK_DMAV2
+    pending->tc = ptr->INTTCSTS;
+    pending->half_tc = ptr->INTHALFSTS;
+    pending->error = ptr->INTERRSTS;
+    pending->abort = ptr->INTABORTSTS;
+    /* W1C, only the bits read above */
+    ptr->INTTCSTS = pending->tc;
+    ptr->INTHALFSTS = pending->half_tc;
+    ptr->INTERRSTS = pending->error;
+    ptr->INTABORTSTS = pending->abort;
+#else
+    uint32_t int_stat = ptr->INTSTATUS;
+    pending->tc = DMA_INTSTATUS_TC_GET(int_stat);
+    pending->half_tc = 0;
+    pending->error = DMA_INTSTATUS_ERROR_GET(int_stat);
+    pending->abort = DMA_INTSTATUS_ABORT_GET(int_stat);
+    /* W1C, only the bits read above */
+    ptr->INTSTATUS = int_stat;
+#endif
+}
+
 void dma_mgr_isr_handler(DMA_Type *ptr, uint32_t instance)
 {
     uint32_t int_disable_mask;
-    uint32_t chn_int_stat;
+    uint32_t chn_bit;
+    uint32_t channels;
+    uint8_t channel;
+    dma_mgr_pending_t pending;
     dma_chn_context_t *chn_ctx;
 
-    for (uint8_t channel = 0; channel < DMA_SOC_CHANNEL_NUM; channel++) {
+    dma_mgr_fetch_pending(ptr, &pending);
+    channels = pending.tc | pending.half_tc | pending.error | pending.abort;
+
+    /* visit only the channels with a pending status, lowest channel first */
+    while (channels != 0U) {
+        channel = (uint8_t)__builtin_ctz(channels);
+        chn_bit = 1UL << channel;
+        channels &= ~chn_bit;
+        if (channel >= DMA_SOC_CHANNEL_NUM) {
+            break;
+        }
         int_disable_mask = dma_check_channel_interrupt_mask(ptr, channel);
-        chn_int_stat = dma_check_transfer_status(ptr, channel);
         chn_ctx = &HPM_DMA_MGR->channels[instance][channel];
 
-        if (((int_disable_mask & DMA_MGR_INTERRUPT_MASK_TC) == 0) && ((chn_int_stat & DMA_MGR_CHANNEL_STATUS_TC) != 0)) {
+        if (((int_disable_mask & DMA_MGR_INTERRUPT_MASK_TC) == 0) && ((pending.tc & chn_bit) != 0)) {
             if (chn_ctx->tc_cb != NULL) {
                 chn_ctx->tc_cb(ptr, channel, chn_ctx->tc_cb_data_ptr);
             }
         }
-        if (((int_disable_mask & DMA_MGR_INTERRUPT_MASK_HALF_TC) == 0) && ((chn_int_stat & DMA_MGR_CHANNEL_STATUS_HALF_TC) != 0)) {
+        if (((int_disable_mask & DMA_MGR_INTERRUPT_MASK_HALF_TC) == 0) && ((pending.half_tc & chn_bit) != 0)) {
             if (chn_ctx->half_tc_cb != NULL) {
                 chn_ctx->half_tc_cb(ptr, channel, chn_ctx->half_tc_cb_data_ptr);
             }
         }
-        if (((int_disable_mask & DMA_MGR_INTERRUPT_MASK_ERROR) == 0) && ((chn_int_stat & DMA_MGR_CHANNEL_STATUS_ERROR) != 0)) {
+        if (((int_disable_mask & DMA_MGR_INTERRUPT_MASK_ERROR) == 0) && ((pending.error & chn_bit) != 0)) {
             if (chn_ctx->error_cb != NULL) {
                 chn_ctx->error_cb(ptr, channel, chn_ctx->error_cb_data_ptr);
             }
         }
-        if (((int_disable_mask & DMA_MGR_INTERRUPT_MASK_ABORT) == 0) && ((chn_int_stat & DMA_MGR_CHANNEL_STATUS_ABORT) != 0)) {
+        if (((int_disable_mask & DMA_MGR_INTERRUPT_MASK_ABORT) == 0) && ((pending.abort & chn_bit) != 0)) {
             if (chn_ctx->abort_cb != NULL) {
                 chn_ctx->abort_cb(ptr, channel, chn_ctx->abort_cb_data_ptr);
             }
@@ -131,12 +185,12 @@ void dma1_isr(void)
 
 static uint32_t dma_mgr_enter_critical(void)
 {
-    return disable_global_irq(CSR_MSTATUS_MIE_MASK);
+    return HPM_DMA_MGR_ENTER_CRITICAL();
 }
 
 static void dma_mgr_exit_critical(uint32_t level)
 {
-    restore_global_irq(level);
+    HPM_DMA_MGR_EXIT_CRITICAL(level);
 }
 
 void dma_mgr_init(void)
@@ -776,3 +830,150 @@ hpm_stat_t dma_mgr_check_chn_transfer_status(const dma_resource_t *resource, uin
     }
     return stat;
 }
+
+/* called with interrupts disabled or from the DMA ISR */
+static void dma_mgr_queue_start_chain(dma_mgr_queue_t *queue)
+{
+    dma_mgr_chn_conf_t config;
+    dma_mgr_xfer_t *xfer;
+    uint32_t chain_mask;
+
+    if ((queue->active != NULL) || (queue->pending_head == NULL)) {
+        return;
+    }
+    queue->active = queue->pending_head;
+    queue->pending_head = NULL;
+    queue->pending_tail = NULL;
+
+    /* only the last descriptor raises TC, error and abort are reported for any of them */
+    chain_mask = queue->config.interrupt_mask & ~(DMA_MGR_INTERRUPT_MASK_TC | DMA_MGR_INTERRUPT_MASK_ERROR | DMA_MGR_INTERRUPT_MASK_ABORT);
+    config = queue->config;
+    for (xfer = queue->active->next; xfer != NULL; xfer = xfer->next) {
+        config.src_addr = xfer->src_addr;
+        config.dst_addr = xfer->dst_addr;
+        config.size_in_byte = xfer->size_in_byte;
+        if (xfer->next != NULL) {
+            config.linked_ptr = core_local_mem_to_sys_address(queue->running_core, (uint32_t)&xfer->next->descriptor);
+            config.interrupt_mask = chain_mask | DMA_MGR_INTERRUPT_MASK_TC;
+        } else {
+            config.linked_ptr = 0;
+            config.interrupt_mask = chain_mask;
+        }
+        (void) dma_mgr_config_linked_descriptor(&queue->resource, &config, &xfer->descriptor);
+    }
+
+    xfer = queue->active;
+    config.src_addr = xfer->src_addr;
+    config.dst_addr = xfer->dst_addr;
+    config.size_in_byte = xfer->size_in_byte;
+    if (xfer->next != NULL) {
+        config.linked_ptr = core_local_mem_to_sys_address(queue->running_core, (uint32_t)&xfer->next->descriptor);
+        config.interrupt_mask = chain_mask | DMA_MGR_INTERRUPT_MASK_TC;
+    } else {
+        config.linked_ptr = 0;
+        config.interrupt_mask = chain_mask;
+    }
+    (void) dma_mgr_setup_channel(&queue->resource, &config);
+    queue->chains++;
+    (void) dma_mgr_enable_channel(&queue->resource);
+}
+
+static void dma_mgr_queue_complete_chain(dma_mgr_queue_t *queue, hpm_stat_t status)
+{
+    dma_mgr_xfer_t *xfer = queue->active;
+    dma_mgr_xfer_t *next;
+
+    queue->active = NULL;
+    /* keep the channel busy before running the callbacks */
+    dma_mgr_queue_start_chain(queue);
+
+    while (xfer != NULL) {
+        next = xfer->next;
+        xfer->next = NULL;
+        queue->xfers++;
+        if (xfer->callback != NULL) {
+            xfer->callback(&queue->resource, xfer, status);
+        }
+        xfer = next;
+    }
+}
+
+static void dma_mgr_queue_tc_callback(DMA_Type *base, uint32_t channel, void *cb_data_ptr)
+{
+    /*
+     * TC status is set at the end of every descriptor, also where its interrupt is masked,
+     * and is seen here once the last one unmasks it. The chain is done when the channel stopped.
+     */
+    if (!dma_channel_is_enable(base, channel)) {
+        dma_mgr_queue_complete_chain((dma_mgr_queue_t *)cb_data_ptr, status_success);
+    }
+}
+
+static void dma_mgr_queue_error_callback(DMA_Type *base, uint32_t channel, void *cb_data_ptr)
+{
+    (void) base;
+    (void) channel;
+    dma_mgr_queue_complete_chain((dma_mgr_queue_t *)cb_data_ptr, status_dma_mgr_xfer_error);
+}
+
+static void dma_mgr_queue_abort_callback(DMA_Type *base, uint32_t channel, void *cb_data_ptr)
+{
+    (void) base;
+    (void) channel;
+    dma_mgr_queue_complete_chain((dma_mgr_queue_t *)cb_data_ptr, status_dma_mgr_xfer_abort);
+}
+
+hpm_stat_t dma_mgr_queue_init(const dma_resource_t *resource, dma_mgr_queue_t *queue,
+                              const dma_mgr_chn_conf_t *config, uint8_t running_core)
+{
+    hpm_stat_t status;
+
+    dma_chn_context_t *chn_ctx = dma_mgr_search_chn_context(resource);
+
+    if ((chn_ctx == NULL) || (queue == NULL) || (config == NULL)) {
+        status = status_invalid_argument;
+    } else {
+        (void) memset(queue, 0, sizeof(*queue));
+        queue->resource = *resource;
+        queue->config = *config;
+        queue->running_core = running_core;
+
+        uint32_t level = dma_mgr_enter_critical();
+        chn_ctx->tc_cb = dma_mgr_queue_tc_callback;
+        chn_ctx->tc_cb_data_ptr = queue;
+        chn_ctx->error_cb = dma_mgr_queue_error_callback;
+        chn_ctx->error_cb_data_ptr = queue;
+        chn_ctx->abort_cb = dma_mgr_queue_abort_callback;
+        chn_ctx->abort_cb_data_ptr = queue;
+        dma_mgr_exit_critical(level);
+        status = status_success;
+    }
+    return status;
+}
+
+hpm_stat_t dma_mgr_queue_submit(dma_mgr_queue_t *queue, dma_mgr_xfer_t *xfer)
+{
+    hpm_stat_t status;
+
+    if ((queue == NULL) || (xfer == NULL) || (xfer->size_in_byte == 0U)) {
+        status = status_invalid_argument;
+    } else {
+        xfer->next = NULL;
+        uint32_t level = dma_mgr_enter_critical();
+        if (queue->pending_tail == NULL) {
+            queue->pending_head = xfer;
+        } else {
+            queue->pending_tail->next = xfer;
+        }
+        queue->pending_tail = xfer;
+        dma_mgr_queue_start_chain(queue);
+        dma_mgr_exit_critical(level);
+        status = status_success;
+    }
+    return status;
+}
+
+bool dma_mgr_queue_is_idle(dma_mgr_queue_t *queue)
+{
+    return (queue->active == NULL) && (queue->pending_head == NULL);
+}
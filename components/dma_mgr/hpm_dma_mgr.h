@@ -98,6 +98,8 @@ extern "C" {
  */
 enum {
     status_dma_mgr_no_resource = MAKE_STATUS(status_group_dma_manager, 0), /**< No DMA resource available */
+    status_dma_mgr_xfer_error = MAKE_STATUS(status_group_dma_manager, 1),  /**< Queued transfer ended with error */
+    status_dma_mgr_xfer_abort = MAKE_STATUS(status_group_dma_manager, 2),  /**< Queued transfer was aborted */
 };
 
 /**
@@ -143,6 +145,51 @@ typedef struct hpm_dma_mgr_linked_descriptor {
     uint32_t descriptor[8];
 } dma_mgr_linked_descriptor_t;
 
+struct hpm_dma_mgr_xfer;
+
+/**
+ * @brief Queued transfer completion callback, called from the DMA ISR
+ *
+ * @param [in] resource DMA resource the transfer was queued on
+ * @param [in] xfer Completed transfer, may be submitted again from the callback
+ * @param [in] status status_success, status_dma_mgr_xfer_error or status_dma_mgr_xfer_abort
+ */
+typedef void (*dma_mgr_xfer_cb_t)(const dma_resource_t *resource, struct hpm_dma_mgr_xfer *xfer, hpm_stat_t status);
+
+/**
+ * @brief Queued transfer
+ *
+ * The structure has to stay valid until the callback is called. The descriptor is read by
+ * the DMA, so the structure has to be placed in noncacheable memory with 8 byte alignment.
+ */
+typedef struct hpm_dma_mgr_xfer {
+    dma_mgr_linked_descriptor_t descriptor; /**< Used internally to chain the transfer */
+    uint32_t src_addr;                      /**< Source address */
+    uint32_t dst_addr;                      /**< Destination address */
+    uint32_t size_in_byte;                  /**< Size to be transferred in byte */
+    dma_mgr_xfer_cb_t callback;             /**< Completion callback, may be NULL */
+    void *user_data;                        /**< User data for the callback */
+    struct hpm_dma_mgr_xfer *next;          /**< Used internally */
+} dma_mgr_xfer_t;
+
+/**
+ * @brief Transfer queue of one DMA channel
+ *
+ * Transfers submitted while the channel is idle start at once. Transfers submitted while
+ * the channel is busy are collected and started from the TC interrupt as one chain of
+ * linked descriptors, so back-to-back transfers do not wait for the CPU one by one.
+ */
+typedef struct hpm_dma_mgr_queue {
+    dma_resource_t resource;                /**< DMA resource */
+    dma_mgr_chn_conf_t config;              /**< Channel configuration template */
+    uint8_t running_core;                   /**< Core running the queue, used for descriptor address translation */
+    dma_mgr_xfer_t *active;                 /**< Chain being transferred */
+    dma_mgr_xfer_t *pending_head;           /**< Transfers waiting for the active chain */
+    dma_mgr_xfer_t *pending_tail;           /**< Last waiting transfer */
+    uint32_t chains;                        /**< Chains started */
+    uint32_t xfers;                         /**< Transfers completed */
+} dma_mgr_queue_t;
+
 /**
  * @brief DMA Manager ISR handler
  */
@@ -550,6 +597,45 @@ hpm_stat_t dma_mgr_abort_chn_transfer(const dma_resource_t *resource);
  */
 hpm_stat_t dma_mgr_check_chn_transfer_status(const dma_resource_t *resource, uint32_t *status);
 
+/**
+ * @brief Initialize transfer queue on a DMA channel
+ *
+ * Installs the TC, error and abort callbacks of the channel, the queued transfers unmask
+ * those interrupts. The DMA interrupt has to be enabled with dma_mgr_enable_dma_irq_with_priority.
+ *
+ * @param [in] resource DMA resource
+ * @param [out] queue Transfer queue
+ * @param [in] config Channel configuration template, address, size and linked pointer are taken from the transfers
+ * @param [in] running_core Core running the queue
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_queue_init(const dma_resource_t *resource, dma_mgr_queue_t *queue,
+                              const dma_mgr_chn_conf_t *config, uint8_t running_core);
+
+/**
+ * @brief Submit transfer to the queue
+ *
+ * May be called from task and interrupt context, including the completion callback.
+ *
+ * @param [in] queue Transfer queue
+ * @param [in] xfer Transfer
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid
+ */
+hpm_stat_t dma_mgr_queue_submit(dma_mgr_queue_t *queue, dma_mgr_xfer_t *xfer);
+
+/**
+ * @brief Check whether the queue has no active or waiting transfer
+ *
+ * @param [in] queue Transfer queue
+ *
+ * @retval true if the queue is idle
+ */
+bool dma_mgr_queue_is_idle(dma_mgr_queue_t *queue);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * Plans, format conversion and the software backend. Nothing in here touches
+ * hardware, so this file also builds and runs on a host.
+ */
+#include <math.h>
+#include <string.h>
+#include "hpm_fft_service.h"
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+#define HPM_FFT_PI (3.14159265358979323846)
+#define HPM_FFT_Q31_SCALE (2147483648.0f)
+
+/*****************************************************************************************************************
+ *
+ *  Prototypes
+ *
+ *****************************************************************************************************************/
+static bool hpm_fft_plan_ffa_supported(const hpm_fft_plan_config_t *config);
+static uint32_t hpm_fft_plan_work_size(const hpm_fft_plan_t *plan);
+static void hpm_fft_sw_radix2(float *data, const float *twiddle, uint32_t num_points, bool inverse);
+static void hpm_fft_sw_fft(const hpm_fft_plan_t *plan, const void *src, void *dst);
+static void hpm_fft_sw_fir(const hpm_fft_plan_t *plan, const void *src, void *dst);
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+static inline bool hpm_fft_is_power_of_2(uint32_t value)
+{
+    return (value != 0U) && ((value & (value - 1U)) == 0U);
+}
+
+static inline int32_t hpm_fft_saturate_q31(int64_t value)
+{
+    if (value > INT32_MAX) {
+        return INT32_MAX;
+    }
+    if (value < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return (int32_t)value;
+}
+
+void hpm_fft_convert_q31_to_float(const int32_t *src, float *dst, uint32_t count, float scale)
+{
+    float factor = scale / HPM_FFT_Q31_SCALE;
+
+    for (uint32_t i = 0; i < count; i++) {
+        dst[i] = (float)src[i] * factor;
+    }
+}
+
+void hpm_fft_convert_float_to_q31(const float *src, int32_t *dst, uint32_t count, float scale)
+{
+    float factor = scale * HPM_FFT_Q31_SCALE;
+    float value;
+
+    for (uint32_t i = 0; i < count; i++) {
+        value = src[i] * factor;
+        if (value >= HPM_FFT_Q31_SCALE) {
+            dst[i] = INT32_MAX;
+        } else if (value <= -HPM_FFT_Q31_SCALE) {
+            dst[i] = INT32_MIN;
+        } else {
+            dst[i] = (int32_t)value;
+        }
+    }
+}
+
+void hpm_fft_plan_get_default_config(hpm_fft_plan_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->op = hpm_fft_op_fft;
+    config->backend = hpm_fft_backend_auto;
+    config->in_format = hpm_fft_format_float;
+    config->out_format = hpm_fft_format_float;
+}
+
+/* same limits as the FFA driver checks in is_point_num_valid(), plus the FFT length field range */
+static bool hpm_fft_plan_ffa_supported(const hpm_fft_plan_config_t *config)
+{
+#if HPM_FFT_SERVICE_USE_FFA
+    if (config->op == hpm_fft_op_fir) {
+        return true;
+    }
+    return hpm_fft_is_power_of_2(config->num_points) && (config->num_points >= 8U)
+        && (config->num_points <= HPM_FFT_SERVICE_FFA_MAX_POINTS);
+#else
+    (void)config;
+    return false;
+#endif
+}
+
+static uint32_t hpm_fft_plan_work_size(const hpm_fft_plan_t *plan)
+{
+    if (plan->op == hpm_fft_op_fir) {
+        if ((plan->backend == hpm_fft_backend_ffa) && (plan->in_format == hpm_fft_format_float)) {
+            return HPM_FFT_SERVICE_FIR_WORK_SIZE(plan->num_points, plan->coef_taps);
+        }
+        return 0;
+    }
+    if (plan->backend == hpm_fft_backend_software) {
+        return HPM_FFT_SERVICE_FFT_WORK_SIZE(plan->num_points);
+    }
+    return (plan->in_format == hpm_fft_format_float) ? (plan->num_points * 8U) : 0U;
+}
+
+hpm_stat_t hpm_fft_plan_init(hpm_fft_plan_t *plan, const hpm_fft_plan_config_t *config)
+{
+    bool ffa_supported;
+    uint32_t half;
+
+    if ((plan == NULL) || (config == NULL) || (config->op > hpm_fft_op_fir)
+     || (config->in_format > hpm_fft_format_float) || (config->out_format > hpm_fft_format_float)
+     || (((uintptr_t)config->work & 7U) != 0U)) {
+        return status_invalid_argument;
+    }
+    if (config->op == hpm_fft_op_fir) {
+        if ((config->coeff == NULL) || (config->coef_taps == 0U) || (config->num_points < config->coef_taps)) {
+            return status_invalid_argument;
+        }
+    } else if (!hpm_fft_is_power_of_2(config->num_points) || (config->num_points < 2U)) {
+        return status_invalid_argument;
+    }
+
+    memset(plan, 0, sizeof(*plan));
+    plan->op = config->op;
+    plan->in_format = config->in_format;
+    plan->out_format = config->out_format;
+    plan->num_points = config->num_points;
+    plan->coef_taps = config->coef_taps;
+    plan->coeff = config->coeff;
+    for (uint32_t n = config->num_points; n > 1U; n >>= 1U) {
+        plan->log2_points++;
+    }
+
+    ffa_supported = hpm_fft_plan_ffa_supported(config);
+    switch (config->backend) {
+    case hpm_fft_backend_auto:
+        plan->backend = ffa_supported ? hpm_fft_backend_ffa : hpm_fft_backend_software;
+        break;
+    case hpm_fft_backend_ffa:
+        if (!ffa_supported) {
+            return status_fft_service_unsupported;
+        }
+        plan->backend = hpm_fft_backend_ffa;
+        break;
+    case hpm_fft_backend_software:
+        plan->backend = hpm_fft_backend_software;
+        break;
+    default:
+        return status_invalid_argument;
+    }
+
+    if (hpm_fft_plan_work_size(plan) > 0U) {
+        if ((config->work == NULL) || (config->work_size < hpm_fft_plan_work_size(plan))) {
+            return status_invalid_argument;
+        }
+        plan->data_buf = config->work;
+    }
+
+    if (plan->op == hpm_fft_op_fir) {
+        if (plan->data_buf != NULL) {
+            /* the FFA only takes q31 coefficients, convert them once here */
+            int32_t *coeff = (int32_t *)plan->data_buf + plan->num_points;
+            hpm_fft_convert_float_to_q31((const float *)config->coeff, coeff, plan->coef_taps, 1.0f);
+            plan->coeff = coeff;
+        }
+    } else if (plan->backend == hpm_fft_backend_software) {
+        /* twiddle factors e^(-2*pi*i*k/N) for k < N/2, follow the data buffer */
+        plan->twiddle = (float *)plan->data_buf + 2U * plan->num_points;
+        half = plan->num_points / 2U;
+        for (uint32_t k = 0; k < half; k++) {
+            double angle = 2.0 * HPM_FFT_PI * (double)k / (double)plan->num_points;
+            plan->twiddle[2U * k] = (float)cos(angle);
+            plan->twiddle[2U * k + 1U] = (float)-sin(angle);
+        }
+    }
+
+    return status_success;
+}
+
+/* in place radix-2 decimation in time on interleaved complex data, not scaled */
+static void hpm_fft_sw_radix2(float *data, const float *twiddle, uint32_t num_points, bool inverse)
+{
+    uint32_t j = 0;
+    uint32_t bit;
+    float tmp;
+
+    for (uint32_t i = 0; i < num_points; i++) {
+        if (i < j) {
+            tmp = data[2U * i];
+            data[2U * i] = data[2U * j];
+            data[2U * j] = tmp;
+            tmp = data[2U * i + 1U];
+            data[2U * i + 1U] = data[2U * j + 1U];
+            data[2U * j + 1U] = tmp;
+        }
+        bit = num_points >> 1U;
+        while ((bit != 0U) && ((j & bit) != 0U)) {
+            j ^= bit;
+            bit >>= 1U;
+        }
+        j |= bit;
+    }
+
+    for (uint32_t half = 1U; half < num_points; half <<= 1U) {
+        uint32_t stride = num_points / (2U * half);
+        for (uint32_t start = 0; start < num_points; start += 2U * half) {
+            for (uint32_t k = 0; k < half; k++) {
+                float wr = twiddle[2U * k * stride];
+                float wi = inverse ? -twiddle[2U * k * stride + 1U] : twiddle[2U * k * stride + 1U];
+                float *a = &data[2U * (start + k)];
+                float *b = &data[2U * (start + k + half)];
+                float tr = wr * b[0] - wi * b[1];
+                float ti = wr * b[1] + wi * b[0];
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+}
+
+static void hpm_fft_sw_fft(const hpm_fft_plan_t *plan, const void *src, void *dst)
+{
+    uint32_t count = 2U * plan->num_points;
+    float scale = 1.0f / (float)plan->num_points;
+    float *buf;
+
+    /* transform in the destination when it is float, in the work memory otherwise */
+    buf = (plan->out_format == hpm_fft_format_float) ? (float *)dst : (float *)plan->data_buf;
+    if (plan->in_format == hpm_fft_format_float) {
+        if ((const void *)buf != src) {
+            memmove(buf, src, count * sizeof(float));
+        }
+    } else {
+        hpm_fft_convert_q31_to_float((const int32_t *)src, buf, count, 1.0f);
+    }
+
+    hpm_fft_sw_radix2(buf, plan->twiddle, plan->num_points, plan->op == hpm_fft_op_ifft);
+
+    if (plan->out_format == hpm_fft_format_q31) {
+        hpm_fft_convert_float_to_q31(buf, (int32_t *)dst, count, scale);
+    } else if (plan->op == hpm_fft_op_ifft) {
+        for (uint32_t i = 0; i < count; i++) {
+            buf[i] *= scale;
+        }
+    }
+}
+
+/* y[i] = sum(coeff[k] * x[i + taps - 1 - k]), only outputs with full overlap */
+static void hpm_fft_sw_fir(const hpm_fft_plan_t *plan, const void *src, void *dst)
+{
+    uint32_t taps = plan->coef_taps;
+    uint32_t out_count = plan->num_points - taps + 1U;
+
+    if (plan->in_format == hpm_fft_format_q31) {
+        const int32_t *x = (const int32_t *)src;
+        const int32_t *h = (const int32_t *)plan->coeff;
+        int32_t *y = (int32_t *)dst;
+        for (uint32_t i = 0; i < out_count; i++) {
+            int64_t acc = 0;
+            for (uint32_t k = 0; k < taps; k++) {
+                acc += (int64_t)h[k] * x[i + taps - 1U - k];
+            }
+            y[i] = hpm_fft_saturate_q31(acc >> 31);
+        }
+        if (plan->out_format == hpm_fft_format_float) {
+            hpm_fft_convert_q31_to_float(y, (float *)dst, out_count, 1.0f);
+        }
+    } else {
+        const float *x = (const float *)src;
+        const float *h = (const float *)plan->coeff;
+        float *y = (float *)dst;
+        for (uint32_t i = 0; i < out_count; i++) {
+            float acc = 0.0f;
+            for (uint32_t k = 0; k < taps; k++) {
+                acc += h[k] * x[i + taps - 1U - k];
+            }
+            y[i] = acc;
+        }
+        if (plan->out_format == hpm_fft_format_q31) {
+            hpm_fft_convert_float_to_q31(y, (int32_t *)dst, out_count, 1.0f);
+        }
+    }
+}
+
+void hpm_fft_sw_execute(const hpm_fft_plan_t *plan, const void *src, void *dst)
+{
+    if (plan->op == hpm_fft_op_fir) {
+        hpm_fft_sw_fir(plan, src, dst);
+    } else {
+        hpm_fft_sw_fft(plan, src, dst);
+    }
+}
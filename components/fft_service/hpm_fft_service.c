@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_fft_service.h"
+#if HPM_FFT_SERVICE_USE_FFA
+#include "hpm_soc.h"
+#include "hpm_interrupt.h"
+#include "hpm_ffa_drv.h"
+#include "hpm_l1c_drv.h"
+#endif
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+#ifndef HPM_FFT_SERVICE_ENTER_CRITICAL
+#if defined(__riscv)
+#include "hpm_soc.h"
+#include "hpm_interrupt.h"
+#define HPM_FFT_SERVICE_ENTER_CRITICAL()    disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define HPM_FFT_SERVICE_EXIT_CRITICAL(level) restore_global_irq((level) & CSR_MSTATUS_MIE_MASK)
+#else
+/* off-target builds have no FFA, requests are submitted and processed by one thread */
+#define HPM_FFT_SERVICE_ENTER_CRITICAL()    (0U)
+#define HPM_FFT_SERVICE_EXIT_CRITICAL(level) ((void)(level))
+#endif
+#endif
+
+#if HPM_FFT_SERVICE_USE_FFA
+#define HPM_FFT_FFA_ERROR_MASKS (FFA_STATUS_FIR_OV_MASK | FFA_STATUS_FFT_OV_MASK | FFA_STATUS_WR_ERR_MASK \
+                               | FFA_STATUS_RD_NXT_ERR_MASK | FFA_STATUS_RD_ERR_MASK)
+#define HPM_FFT_FFA_INT_MASKS (FFA_INT_EN_OP_CMD_DONE_MASK | FFA_INT_EN_FIR_OV_MASK | FFA_INT_EN_FFT_OV_MASK \
+                             | FFA_INT_EN_WR_ERR_MASK | FFA_INT_EN_RD_NXT_ERR_MASK | FFA_INT_EN_RD_ERR_MASK)
+#endif
+
+typedef struct {
+    hpm_fft_request_t *head;
+    hpm_fft_request_t *tail;
+} hpm_fft_queue_t;
+
+typedef struct {
+    hpm_fft_service_config_t config;
+    hpm_fft_queue_t sw_queue;
+    hpm_fft_queue_t ffa_queue;
+    hpm_fft_request_t *ffa_active;
+    uint32_t pending;
+    hpm_fft_service_stat_t stat;
+    bool initialized;
+} hpm_fft_service_t;
+
+/*****************************************************************************************************************
+ *
+ *  Prototypes
+ *
+ *****************************************************************************************************************/
+static void hpm_fft_queue_push(hpm_fft_queue_t *queue, hpm_fft_request_t *request);
+static hpm_fft_request_t *hpm_fft_queue_pop(hpm_fft_queue_t *queue);
+static void hpm_fft_service_complete(hpm_fft_request_t *request, hpm_stat_t status);
+
+#if HPM_FFT_SERVICE_USE_FFA
+static void hpm_fft_ffa_start(hpm_fft_request_t *request);
+static hpm_stat_t hpm_fft_ffa_finish(hpm_fft_request_t *request, uint32_t ffa_status);
+static void hpm_fft_ffa_isr(void);
+SDK_DECLARE_EXT_ISR_M(IRQn_FFA, hpm_fft_ffa_isr);
+#endif
+
+/*****************************************************************************************************************
+ *
+ *  Variables
+ *
+ *****************************************************************************************************************/
+static hpm_fft_service_t s_fft_service;
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+static void hpm_fft_queue_push(hpm_fft_queue_t *queue, hpm_fft_request_t *request)
+{
+    request->next = NULL;
+    if (queue->tail == NULL) {
+        queue->head = request;
+    } else {
+        queue->tail->next = request;
+    }
+    queue->tail = request;
+}
+
+static hpm_fft_request_t *hpm_fft_queue_pop(hpm_fft_queue_t *queue)
+{
+    hpm_fft_request_t *request = queue->head;
+
+    if (request != NULL) {
+        queue->head = request->next;
+        if (queue->head == NULL) {
+            queue->tail = NULL;
+        }
+        request->next = NULL;
+    }
+    return request;
+}
+
+/* called with interrupts disabled */
+static void hpm_fft_service_complete(hpm_fft_request_t *request, hpm_stat_t status)
+{
+    s_fft_service.pending--;
+    if (status != status_success) {
+        s_fft_service.stat.failed++;
+    } else if (request->plan->backend == hpm_fft_backend_ffa) {
+        s_fft_service.stat.ffa_requests++;
+    } else {
+        s_fft_service.stat.sw_requests++;
+    }
+    request->status = status;
+}
+
+void hpm_fft_service_get_default_config(hpm_fft_service_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->ffa_irq_priority = 1;
+}
+
+hpm_stat_t hpm_fft_service_init(const hpm_fft_service_config_t *config)
+{
+    if (config == NULL) {
+        return status_invalid_argument;
+    }
+
+    memset(&s_fft_service, 0, sizeof(s_fft_service));
+    s_fft_service.config = *config;
+
+#if HPM_FFT_SERVICE_USE_FFA
+    ffa_disable(HPM_FFA);
+    ffa_disable_interrupt(HPM_FFA, HPM_FFT_FFA_INT_MASKS);
+    intc_m_enable_irq_with_priority(IRQn_FFA, config->ffa_irq_priority);
+#endif
+    s_fft_service.initialized = true;
+
+    return status_success;
+}
+
+hpm_stat_t hpm_fft_service_submit(hpm_fft_request_t *request)
+{
+    const hpm_fft_plan_t *plan;
+    uint32_t level;
+    bool start_ffa = false;
+    bool notify = false;
+
+    if ((request == NULL) || (request->plan == NULL) || (request->src == NULL) || (request->dst == NULL)) {
+        return status_invalid_argument;
+    }
+    if (!s_fft_service.initialized) {
+        return status_fft_service_not_ready;
+    }
+    plan = request->plan;
+#if HPM_FFT_SERVICE_USE_FFA
+    if ((plan->backend == hpm_fft_backend_ffa) && l1c_dc_is_enabled()
+     && (((uint32_t)request->dst % HPM_L1C_CACHELINE_SIZE) != 0U)) {
+        /* invalidating the destination would drop data sharing its first cache line */
+        return status_invalid_argument;
+    }
+#else
+    if (plan->backend == hpm_fft_backend_ffa) {
+        return status_fft_service_unsupported;
+    }
+#endif
+
+    level = HPM_FFT_SERVICE_ENTER_CRITICAL();
+    if (request->status == status_fft_service_busy) {
+        HPM_FFT_SERVICE_EXIT_CRITICAL(level);
+        return status_fft_service_busy;
+    }
+    request->status = status_fft_service_busy;
+    if (plan->backend == hpm_fft_backend_ffa) {
+        if (s_fft_service.ffa_active == NULL) {
+            s_fft_service.ffa_active = request;
+            start_ffa = true;
+        } else {
+            hpm_fft_queue_push(&s_fft_service.ffa_queue, request);
+        }
+    } else {
+        notify = (s_fft_service.sw_queue.head == NULL);
+        hpm_fft_queue_push(&s_fft_service.sw_queue, request);
+    }
+    s_fft_service.pending++;
+    if (s_fft_service.pending > s_fft_service.stat.max_pending) {
+        s_fft_service.stat.max_pending = s_fft_service.pending;
+    }
+#if HPM_FFT_SERVICE_USE_FFA
+    if (start_ffa) {
+        hpm_fft_ffa_start(request);
+    }
+#else
+    (void)start_ffa;
+#endif
+    HPM_FFT_SERVICE_EXIT_CRITICAL(level);
+
+    /* wake the worker only for the first request of a batch */
+    if (notify && (s_fft_service.config.notify != NULL)) {
+        s_fft_service.config.notify(s_fft_service.config.notify_context);
+    }
+
+    return status_success;
+}
+
+uint32_t hpm_fft_service_process(uint32_t max_requests)
+{
+    hpm_fft_request_t *request;
+    uint32_t level;
+    uint32_t count = 0;
+
+    while (count < max_requests) {
+        level = HPM_FFT_SERVICE_ENTER_CRITICAL();
+        request = hpm_fft_queue_pop(&s_fft_service.sw_queue);
+        HPM_FFT_SERVICE_EXIT_CRITICAL(level);
+        if (request == NULL) {
+            break;
+        }
+
+        hpm_fft_sw_execute(request->plan, request->src, request->dst);
+
+        level = HPM_FFT_SERVICE_ENTER_CRITICAL();
+        hpm_fft_service_complete(request, status_success);
+        HPM_FFT_SERVICE_EXIT_CRITICAL(level);
+        if (request->callback != NULL) {
+            request->callback(request);
+        }
+        count++;
+    }
+
+    return count;
+}
+
+void hpm_fft_service_get_stat(hpm_fft_service_stat_t *stat)
+{
+    uint32_t level = HPM_FFT_SERVICE_ENTER_CRITICAL();
+    *stat = s_fft_service.stat;
+    HPM_FFT_SERVICE_EXIT_CRITICAL(level);
+}
+
+void hpm_fft_service_reset_stat(void)
+{
+    uint32_t level = HPM_FFT_SERVICE_ENTER_CRITICAL();
+    memset(&s_fft_service.stat, 0, sizeof(s_fft_service.stat));
+    s_fft_service.stat.max_pending = s_fft_service.pending;
+    HPM_FFT_SERVICE_EXIT_CRITICAL(level);
+}
+
+#if HPM_FFT_SERVICE_USE_FFA
+static uint32_t hpm_fft_ffa_src_size(const hpm_fft_plan_t *plan)
+{
+    return (plan->op == hpm_fft_op_fir) ? (plan->num_points * sizeof(int32_t))
+                                        : (plan->num_points * 2U * sizeof(int32_t));
+}
+
+static uint32_t hpm_fft_ffa_dst_count(const hpm_fft_plan_t *plan)
+{
+    return (plan->op == hpm_fft_op_fir) ? (plan->num_points - plan->coef_taps + 1U) : (plan->num_points * 2U);
+}
+
+static void hpm_fft_ffa_writeback(const void *addr, uint32_t size)
+{
+    uint32_t start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)addr);
+    uint32_t end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)addr + size);
+
+    l1c_dc_writeback(start, end - start);
+}
+
+/* called with interrupts disabled or from the FFA ISR */
+static void hpm_fft_ffa_start(hpm_fft_request_t *request)
+{
+    const hpm_fft_plan_t *plan = request->plan;
+    const void *src = request->src;
+    uint32_t src_size = hpm_fft_ffa_src_size(plan);
+
+    /* the FFA only takes q31, float input is converted into the work memory */
+    if (plan->in_format == hpm_fft_format_float) {
+        hpm_fft_convert_float_to_q31((const float *)src, (int32_t *)plan->data_buf, src_size / sizeof(int32_t), 1.0f);
+        src = plan->data_buf;
+    }
+    if (l1c_dc_is_enabled()) {
+        hpm_fft_ffa_writeback(src, src_size);
+        if (plan->op == hpm_fft_op_fir) {
+            hpm_fft_ffa_writeback(plan->coeff, plan->coef_taps * sizeof(int32_t));
+        }
+        /* drop dirty destination lines before the FFA writes behind the cache */
+        hpm_fft_ffa_writeback(request->dst, hpm_fft_ffa_dst_count(plan) * sizeof(int32_t));
+    }
+
+    if (plan->op == hpm_fft_op_fir) {
+        fir_xfer_t xfer = { 0 };
+        xfer.data_type = FFA_DATA_TYPE_REAL_Q31;
+        xfer.coef_taps = (uint16_t)plan->coef_taps;
+        xfer.input_taps = (uint16_t)plan->num_points;
+        xfer.src = (void *)src;
+        xfer.coeff = (void *)plan->coeff;
+        xfer.dst = request->dst;
+        xfer.interrupt_mask = HPM_FFT_FFA_INT_MASKS;
+        ffa_start_fir(HPM_FFA, &xfer);
+    } else {
+        fft_xfer_t xfer = { 0 };
+        xfer.is_ifft = (plan->op == hpm_fft_op_ifft);
+        xfer.src_data_type = FFA_DATA_TYPE_COMPLEX_Q31;
+        xfer.dst_data_type = FFA_DATA_TYPE_COMPLEX_Q31;
+        xfer.num_points = (uint16_t)plan->num_points;
+        xfer.src = (void *)src;
+        xfer.dst = request->dst;
+        xfer.interrupt_mask = HPM_FFT_FFA_INT_MASKS;
+        ffa_start_fft(HPM_FFA, &xfer);
+    }
+}
+
+static hpm_stat_t hpm_fft_ffa_finish(hpm_fft_request_t *request, uint32_t ffa_status)
+{
+    const hpm_fft_plan_t *plan = request->plan;
+    uint32_t dst_count = hpm_fft_ffa_dst_count(plan);
+    float scale;
+
+    if (IS_HPM_BITMASK_SET(ffa_status, FFA_STATUS_FIR_OV_MASK)) {
+        return status_ffa_fir_overflow;
+    } else if (IS_HPM_BITMASK_SET(ffa_status, FFA_STATUS_FFT_OV_MASK)) {
+        return status_ffa_fft_overflow;
+    } else if (IS_HPM_BITMASK_SET(ffa_status, FFA_STATUS_WR_ERR_MASK)) {
+        return status_ffa_write_error;
+    } else if (IS_HPM_BITMASK_SET(ffa_status, FFA_STATUS_RD_NXT_ERR_MASK)) {
+        return status_ffa_read_next_error;
+    } else if (IS_HPM_BITMASK_SET(ffa_status, FFA_STATUS_RD_ERR_MASK)) {
+        return status_ffa_read_error;
+    }
+
+    if (l1c_dc_is_enabled()) {
+        l1c_dc_invalidate((uint32_t)request->dst, HPM_L1C_CACHELINE_ALIGN_UP(dst_count * sizeof(int32_t)));
+    }
+    if (plan->out_format == hpm_fft_format_float) {
+        /* the FFA scales FFT results by 1/N, float FFT results are not scaled */
+        scale = (plan->op == hpm_fft_op_fft) ? (float)plan->num_points : 1.0f;
+        hpm_fft_convert_q31_to_float((const int32_t *)request->dst, (float *)request->dst, dst_count, scale);
+    }
+
+    return status_success;
+}
+
+static void hpm_fft_ffa_isr(void)
+{
+    hpm_fft_request_t *request = s_fft_service.ffa_active;
+    hpm_fft_request_t *next;
+    uint32_t ffa_status = ffa_get_status(HPM_FFA);
+    hpm_stat_t status;
+
+    if (!IS_HPM_BITMASK_SET(ffa_status, FFA_STATUS_OP_CMD_DONE_MASK | HPM_FFT_FFA_ERROR_MASKS)) {
+        return;
+    }
+    ffa_disable_interrupt(HPM_FFA, HPM_FFT_FFA_INT_MASKS);
+    ffa_disable(HPM_FFA);
+    if (request == NULL) {
+        return;
+    }
+
+    /* keep the FFA busy while the finished request is post processed */
+    next = hpm_fft_queue_pop(&s_fft_service.ffa_queue);
+    s_fft_service.ffa_active = next;
+    if (next != NULL) {
+        hpm_fft_ffa_start(next);
+    }
+
+    status = hpm_fft_ffa_finish(request, ffa_status);
+    hpm_fft_service_complete(request, status);
+    if (request->callback != NULL) {
+        request->callback(request);
+    }
+}
+#endif
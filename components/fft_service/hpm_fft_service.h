@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_FFT_SERVICE_H
+#define HPM_FFT_SERVICE_H
+
+#include "hpm_common.h"
+
+/**
+ * @brief FFT service
+ *
+ * Runs complex FFT/IFFT and real FIR requests asynchronously on the FFA
+ * accelerator, or on the CPU when the FFA is not present or can not handle
+ * the plan. A plan describes the operation once (size, data formats,
+ * backend, work memory), requests referencing a plan are queued and
+ * completed through a callback.
+ *
+ * FFA requests complete in the FFA ISR, the next FFA request is started from
+ * the ISR as well. Software requests are run by hpm_fft_service_process(),
+ * called from the application main loop or a worker task woken by notify.
+ *
+ * Data formats:
+ *  - complex data are interleaved [real, imaginary, real, imaginary, ...]
+ *  - q31 FFT/IFFT results are scaled by 1/N, which is what the FFA produces
+ *  - float FFT results are not scaled, float IFFT results are scaled by 1/N
+ *  - float data passed to or from the FFA are converted from/to q31 at the
+ *    service boundary, float input must be in the range [-1, 1)
+ *
+ * FFA destination buffers must be placed in noncacheable memory or be
+ * aligned to and sized in multiples of the cache line size, the service
+ * writes back the source and invalidates the destination.
+ */
+
+/* Set to 0 to build the service without FFA support, e.g. on a host */
+#ifndef HPM_FFT_SERVICE_USE_FFA
+#if defined(HPMSOC_HAS_HPMSDK_FFA)
+#define HPM_FFT_SERVICE_USE_FFA (1)
+#else
+#define HPM_FFT_SERVICE_USE_FFA (0)
+#endif
+#endif
+
+/* Largest FFT the FFA backend is used for */
+#ifndef HPM_FFT_SERVICE_FFA_MAX_POINTS
+#define HPM_FFT_SERVICE_FFA_MAX_POINTS (512U)
+#endif
+
+/* Work memory needed by a FFT/IFFT plan of num_points complex points */
+#define HPM_FFT_SERVICE_FFT_WORK_SIZE(num_points) ((num_points) * 12U)
+
+/* Work memory needed by a FIR plan of num_samples input samples and coef_taps coefficients */
+#define HPM_FFT_SERVICE_FIR_WORK_SIZE(num_samples, coef_taps) (((num_samples) + (coef_taps)) * 4U)
+
+enum {
+    status_fft_service_unsupported = MAKE_STATUS(status_group_fft_service, 0), /**< Plan not supported by the backend */
+    status_fft_service_busy = MAKE_STATUS(status_group_fft_service, 1),        /**< Request is still queued */
+    status_fft_service_not_ready = MAKE_STATUS(status_group_fft_service, 2),   /**< Service is not initialized */
+};
+
+/**
+ * @brief Operation of a plan
+ */
+typedef enum {
+    hpm_fft_op_fft = 0,     /**< complex forward FFT */
+    hpm_fft_op_ifft,        /**< complex inverse FFT */
+    hpm_fft_op_fir,         /**< real FIR, num_samples - coef_taps + 1 outputs */
+} hpm_fft_op_t;
+
+/**
+ * @brief Sample format at the service boundary
+ */
+typedef enum {
+    hpm_fft_format_q31 = 0,
+    hpm_fft_format_float,
+} hpm_fft_format_t;
+
+/**
+ * @brief Backend executing a plan
+ */
+typedef enum {
+    hpm_fft_backend_auto = 0,   /**< FFA if it supports the plan, software otherwise */
+    hpm_fft_backend_ffa,
+    hpm_fft_backend_software,
+} hpm_fft_backend_t;
+
+/**
+ * @brief Plan configuration
+ */
+typedef struct {
+    hpm_fft_op_t op;                /**< operation */
+    hpm_fft_backend_t backend;      /**< requested backend */
+    hpm_fft_format_t in_format;     /**< source format, also the FIR coefficient format */
+    hpm_fft_format_t out_format;    /**< destination format */
+    uint32_t num_points;            /**< FFT points (power of 2) or FIR input samples */
+    uint32_t coef_taps;             /**< FIR coefficient count */
+    const void *coeff;              /**< FIR coefficients, must stay valid for the plan lifetime */
+    void *work;                     /**< work memory, 8 byte aligned */
+    uint32_t work_size;             /**< see HPM_FFT_SERVICE_FFT_WORK_SIZE and HPM_FFT_SERVICE_FIR_WORK_SIZE */
+} hpm_fft_plan_config_t;
+
+/**
+ * @brief Plan, filled by hpm_fft_plan_init()
+ */
+typedef struct {
+    hpm_fft_op_t op;
+    hpm_fft_backend_t backend;      /**< selected backend, never hpm_fft_backend_auto */
+    hpm_fft_format_t in_format;
+    hpm_fft_format_t out_format;
+    uint32_t num_points;
+    uint32_t log2_points;
+    uint32_t coef_taps;
+    const void *coeff;              /**< coefficients as passed to the backend */
+    void *data_buf;                 /**< format conversion buffer in the work memory */
+    float *twiddle;                 /**< software FFT twiddle factors in the work memory */
+} hpm_fft_plan_t;
+
+struct hpm_fft_request;
+
+/**
+ * @brief Request completion callback
+ *
+ * Called from the FFA ISR for FFA requests, from hpm_fft_service_process()
+ * for software requests.
+ */
+typedef void (*hpm_fft_done_callback_t)(struct hpm_fft_request *request);
+
+/**
+ * @brief Request, owned by the service from submit until completion
+ */
+typedef struct hpm_fft_request {
+    struct hpm_fft_request *next;       /**< queue link, used by the service */
+    const hpm_fft_plan_t *plan;         /**< plan */
+    const void *src;                    /**< source, 2 * num_points or num_samples values */
+    void *dst;                          /**< destination, may equal src for FFT/IFFT */
+    hpm_fft_done_callback_t callback;   /**< completion callback, may be NULL */
+    void *context;                      /**< callback context */
+    volatile hpm_stat_t status;         /**< status_fft_service_busy until completion */
+} hpm_fft_request_t;
+
+/**
+ * @brief Called when a software request was queued, e.g. to wake a worker task
+ */
+typedef void (*hpm_fft_service_notify_t)(void *context);
+
+/**
+ * @brief Service configuration
+ */
+typedef struct {
+    uint8_t ffa_irq_priority;           /**< FFA interrupt priority */
+    hpm_fft_service_notify_t notify;    /**< software request wakeup, may be NULL */
+    void *notify_context;               /**< notify context */
+} hpm_fft_service_config_t;
+
+/**
+ * @brief Service statistics
+ */
+typedef struct {
+    uint32_t ffa_requests;      /**< requests completed by the FFA */
+    uint32_t sw_requests;       /**< requests completed in software */
+    uint32_t failed;            /**< requests completed with an error */
+    uint32_t max_pending;       /**< maximum number of queued requests */
+} hpm_fft_service_stat_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get default plan configuration, a float forward FFT on the automatically selected backend
+ *
+ * @param [out] config plan configuration
+ */
+void hpm_fft_plan_get_default_config(hpm_fft_plan_config_t *config);
+
+/**
+ * @brief Initialize a plan
+ *
+ * Selects the backend, lays out the work memory and precomputes what the
+ * backend needs (twiddle factors, converted FIR coefficients).
+ *
+ * @param [out] plan plan
+ * @param [in] config plan configuration
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the configuration is invalid or the work memory is too small
+ * @retval status_fft_service_unsupported if the requested backend can not run the plan
+ */
+hpm_stat_t hpm_fft_plan_init(hpm_fft_plan_t *plan, const hpm_fft_plan_config_t *config);
+
+/**
+ * @brief Get default service configuration
+ *
+ * @param [out] config service configuration
+ */
+void hpm_fft_service_get_default_config(hpm_fft_service_config_t *config);
+
+/**
+ * @brief Initialize the service
+ *
+ * @param [in] config service configuration
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the configuration is invalid
+ */
+hpm_stat_t hpm_fft_service_init(const hpm_fft_service_config_t *config);
+
+/**
+ * @brief Queue a request
+ *
+ * Safe to be called from task and interrupt context. The request, its
+ * buffers and its plan must stay valid until completion.
+ *
+ * @param [in] request request
+ *
+ * @retval status_success if the request was queued
+ * @retval status_invalid_argument if the request is invalid
+ * @retval status_fft_service_busy if the request is still queued
+ * @retval status_fft_service_not_ready if the service is not initialized
+ */
+hpm_stat_t hpm_fft_service_submit(hpm_fft_request_t *request);
+
+/**
+ * @brief Run queued software requests
+ *
+ * @param [in] max_requests maximum number of requests to run
+ *
+ * @return number of completed requests
+ */
+uint32_t hpm_fft_service_process(uint32_t max_requests);
+
+/**
+ * @brief Check whether a request is completed
+ *
+ * @param [in] request request
+ * @return true if the request is completed, request->status holds the result
+ */
+static inline bool hpm_fft_request_is_done(const hpm_fft_request_t *request)
+{
+    return request->status != status_fft_service_busy;
+}
+
+/**
+ * @brief Get service statistics
+ *
+ * @param [out] stat statistics
+ */
+void hpm_fft_service_get_stat(hpm_fft_service_stat_t *stat);
+
+/**
+ * @brief Clear service statistics
+ */
+void hpm_fft_service_reset_stat(void);
+
+/**
+ * @brief Run a plan in software
+ *
+ * The software backend used by the service, callable directly for
+ * synchronous use. The plan must use the software backend.
+ *
+ * @param [in] plan plan
+ * @param [in] src source
+ * @param [out] dst destination
+ */
+void hpm_fft_sw_execute(const hpm_fft_plan_t *plan, const void *src, void *dst);
+
+/**
+ * @brief Convert q31 values to float
+ *
+ * @param [in] src q31 values
+ * @param [out] dst float values, may equal src
+ * @param [in] count number of values
+ * @param [in] scale factor applied to the converted values
+ */
+void hpm_fft_convert_q31_to_float(const int32_t *src, float *dst, uint32_t count, float scale);
+
+/**
+ * @brief Convert float values to q31 with saturation
+ *
+ * @param [in] src float values
+ * @param [out] dst q31 values, may equal src
+ * @param [in] count number of values
+ * @param [in] scale factor applied before the conversion
+ */
+void hpm_fft_convert_float_to_q31(const float *src, int32_t *dst, uint32_t count, float scale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_FFT_SERVICE_H */
@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_i2c.h"
+
+/* transactions are queued from tasks and interrupts and completed from the I2C interrupt */
+#ifndef HPM_I2C_BUS_ENTER_CRITICAL
+#include "hpm_interrupt.h"
+#define HPM_I2C_BUS_ENTER_CRITICAL()     disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define HPM_I2C_BUS_EXIT_CRITICAL(level) restore_global_irq((level) & CSR_MSTATUS_MIE_MASK)
+#endif
+
+#define HPM_I2C_BUS_STATUS_W1C_MASK (I2C_STATUS_CMPL_MASK | I2C_STATUS_BYTERECV_MASK | I2C_STATUS_BYTETRANS_MASK \
+                                     | I2C_STATUS_START_MASK | I2C_STATUS_STOP_MASK | I2C_STATUS_ARBLOSE_MASK \
+                                     | I2C_STATUS_ADDRHIT_MASK)
+
+static void hpm_i2c_bus_start_segment(hpm_i2c_bus_t *bus);
+
+void hpm_i2c_bus_init(hpm_i2c_bus_t *bus, I2C_Type *ptr)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->ptr = ptr;
+    i2c_disable_irq(ptr, I2C_EVENT_ALL_MASK);
+}
+
+void hpm_i2c_trans_write(hpm_i2c_trans_t *trans, const hpm_i2c_device_t *device, uint8_t *buf, uint32_t size)
+{
+    memset(trans, 0, sizeof(*trans));
+    trans->device = device;
+    trans->seg[0].buf = buf;
+    trans->seg[0].len = size;
+    trans->seg[0].flags = HPM_I2C_SEG_WRITE | HPM_I2C_SEG_START | HPM_I2C_SEG_STOP;
+    trans->seg_count = 1;
+}
+
+void hpm_i2c_trans_read(hpm_i2c_trans_t *trans, const hpm_i2c_device_t *device, uint8_t *buf, uint32_t size)
+{
+    memset(trans, 0, sizeof(*trans));
+    trans->device = device;
+    trans->seg[0].buf = buf;
+    trans->seg[0].len = size;
+    trans->seg[0].flags = HPM_I2C_SEG_READ | HPM_I2C_SEG_START | HPM_I2C_SEG_STOP;
+    trans->seg_count = 1;
+}
+
+void hpm_i2c_trans_write_read(hpm_i2c_trans_t *trans, const hpm_i2c_device_t *device,
+                              uint8_t *wbuf, uint32_t wsize, uint8_t *rbuf, uint32_t rsize)
+{
+    memset(trans, 0, sizeof(*trans));
+    trans->device = device;
+    trans->seg[0].buf = wbuf;
+    trans->seg[0].len = wsize;
+    trans->seg[0].flags = HPM_I2C_SEG_WRITE | HPM_I2C_SEG_START;
+    trans->seg[1].buf = rbuf;
+    trans->seg[1].len = rsize;
+    trans->seg[1].flags = HPM_I2C_SEG_READ | HPM_I2C_SEG_START | HPM_I2C_SEG_STOP;
+    trans->seg_count = 2;
+}
+
+static hpm_stat_t hpm_i2c_trans_check(hpm_i2c_trans_t *trans)
+{
+    hpm_i2c_seg_t *seg;
+
+    if ((trans->device == NULL) || (trans->seg_count == 0) || (trans->seg_count > HPM_I2C_TRANS_MAX_SEGMENTS)
+        || !(trans->seg[0].flags & HPM_I2C_SEG_START)
+        || !(trans->seg[trans->seg_count - 1].flags & HPM_I2C_SEG_STOP)) {
+        return status_invalid_argument;
+    }
+    for (uint32_t i = 0; i < trans->seg_count; i++) {
+        seg = &trans->seg[i];
+        if ((seg->buf == NULL) || (seg->len == 0) || (seg->len > I2C_SOC_TRANSFER_COUNT_MAX)
+            || ((seg->flags & HPM_I2C_SEG_STOP) && (i != trans->seg_count - 1U))) {
+            return status_invalid_argument;
+        }
+        if ((seg->flags & HPM_I2C_SEG_LEN_FROM_PREV)
+            && (!(seg->flags & HPM_I2C_SEG_READ) || (i == 0) || !(trans->seg[i - 1U].flags & HPM_I2C_SEG_READ))) {
+            return status_invalid_argument;
+        }
+    }
+    return status_success;
+}
+
+static void hpm_i2c_bus_complete(hpm_i2c_bus_t *bus, hpm_stat_t stat)
+{
+    hpm_i2c_trans_t *trans;
+    hpm_i2c_trans_t *next;
+    uint32_t level;
+
+    i2c_disable_irq(bus->ptr, I2C_EVENT_ALL_MASK);
+
+    level = HPM_I2C_BUS_ENTER_CRITICAL();
+    trans = bus->head;
+    next = trans->next;
+    bus->head = next;
+    if (next == NULL) {
+        bus->tail = NULL;
+    }
+    bus->queued--;
+    HPM_I2C_BUS_EXIT_CRITICAL(level);
+
+    trans->next = NULL;
+    trans->last_len = bus->pos;
+    if (stat == status_success) {
+        bus->stat.transfers++;
+    } else if (stat == status_timeout) {
+        bus->stat.timeouts++;
+    } else {
+        bus->stat.errors++;
+    }
+    trans->status = stat;
+
+    /* keep the bus going before handing the result over */
+    if (next != NULL) {
+        bus->seg_index = 0;
+        bus->ticks_left = next->device->timeout_ticks;
+        i2c_enable_10bit_address_mode(bus->ptr, next->device->is_10bit_addressing);
+        hpm_i2c_bus_start_segment(bus);
+    }
+    if (trans->callback != NULL) {
+        trans->callback(trans, trans->cb_context);
+    }
+}
+
+/* end the transaction, sending a STOP first if the segment that failed had none */
+static void hpm_i2c_bus_fail(hpm_i2c_bus_t *bus, hpm_stat_t stat, bool send_stop)
+{
+    I2C_Type *ptr = bus->ptr;
+
+    if (!send_stop) {
+        hpm_i2c_bus_complete(bus, stat);
+        return;
+    }
+    bus->stopping = stat;
+    i2c_disable_irq(ptr, I2C_EVENT_ALL_MASK);
+    ptr->STATUS = HPM_I2C_BUS_STATUS_W1C_MASK;
+    ptr->CTRL = I2C_CTRL_PHASE_STOP_MASK;
+    ptr->CMD = I2C_CMD_ISSUE_DATA_TRANSMISSION;
+    i2c_enable_irq(ptr, I2C_EVENT_TRANSACTION_COMPLETE);
+}
+
+static void hpm_i2c_bus_start_segment(hpm_i2c_bus_t *bus)
+{
+    I2C_Type *ptr = bus->ptr;
+    hpm_i2c_trans_t *trans = bus->head;
+    hpm_i2c_seg_t *seg = &trans->seg[bus->seg_index];
+    bool read = (seg->flags & HPM_I2C_SEG_READ) != 0;
+    bool start = (seg->flags & HPM_I2C_SEG_START) != 0;
+    uint32_t len = seg->len;
+    uint32_t irq;
+
+    if (seg->flags & HPM_I2C_SEG_LEN_FROM_PREV) {
+        len = (uint32_t)bus->last_byte + seg->len_extra;
+        if ((len == 0) || (len > seg->len)) {
+            /* the previous segment ended without STOP */
+            hpm_i2c_bus_fail(bus, status_i2c_invalid_data, true);
+            return;
+        }
+    }
+    bus->seg_len = len;
+    bus->pos = 0;
+
+    /* W1C, clear CMPL bit to avoid blocking the transmission */
+    ptr->STATUS = HPM_I2C_BUS_STATUS_W1C_MASK;
+    ptr->CMD = I2C_CMD_CLEAR_FIFO;
+    if (start) {
+        ptr->ADDR = I2C_ADDR_ADDR_SET(trans->device->address);
+    }
+    ptr->CTRL = I2C_CTRL_PHASE_START_SET(start)
+                | I2C_CTRL_PHASE_ADDR_SET(start)
+                | I2C_CTRL_PHASE_STOP_SET((seg->flags & HPM_I2C_SEG_STOP) != 0)
+                | I2C_CTRL_PHASE_DATA_MASK
+                | I2C_CTRL_DIR_SET(read ? I2C_DIR_MASTER_READ : I2C_DIR_MASTER_WRITE)
+                | I2C_CTRL_DATACNT_HIGH_SET(I2C_DATACNT_MAP(len) >> 8U)
+                | I2C_CTRL_DATACNT_SET(I2C_DATACNT_MAP(len));
+
+    irq = I2C_EVENT_TRANSACTION_COMPLETE | I2C_EVENT_LOSS_ARBITRATION;
+    if (read) {
+        /* disable auto ack, every byte is acknowledged from the interrupt */
+        irq |= I2C_EVENT_BYTE_RECEIVED;
+    } else {
+        while ((bus->pos < len) && !i2c_fifo_is_full(ptr)) {
+            ptr->DATA = seg->buf[bus->pos++];
+        }
+        if (bus->pos < len) {
+            irq |= I2C_EVENT_FIFO_EMPTY;
+        }
+    }
+    ptr->INTEN = irq;
+    ptr->CMD = I2C_CMD_ISSUE_DATA_TRANSMISSION;
+}
+
+static void hpm_i2c_bus_next_segment(hpm_i2c_bus_t *bus)
+{
+    bus->seg_index++;
+    if (bus->seg_index == bus->head->seg_count) {
+        hpm_i2c_bus_complete(bus, status_success);
+    } else {
+        hpm_i2c_bus_start_segment(bus);
+    }
+}
+
+hpm_stat_t hpm_i2c_bus_submit(hpm_i2c_bus_t *bus, hpm_i2c_trans_t *trans,
+                              hpm_i2c_trans_callback_t callback, void *cb_context)
+{
+    hpm_stat_t stat;
+    uint32_t level;
+    bool start;
+
+    if (trans == NULL) {
+        return status_invalid_argument;
+    }
+    stat = hpm_i2c_trans_check(trans);
+    if (stat != status_success) {
+        return stat;
+    }
+
+    level = HPM_I2C_BUS_ENTER_CRITICAL();
+    if (trans->status == status_i2c_trans_busy) {
+        HPM_I2C_BUS_EXIT_CRITICAL(level);
+        return status_i2c_trans_busy;
+    }
+    trans->status = status_i2c_trans_busy;
+    trans->callback = callback;
+    trans->cb_context = cb_context;
+    trans->next = NULL;
+    start = (bus->head == NULL);
+    if (start) {
+        bus->head = trans;
+    } else {
+        bus->tail->next = trans;
+    }
+    bus->tail = trans;
+    bus->queued++;
+    if (bus->queued > bus->stat.max_queued) {
+        bus->stat.max_queued = bus->queued;
+    }
+    if (start) {
+        bus->seg_index = 0;
+        bus->stopping = status_success;
+        bus->ticks_left = trans->device->timeout_ticks;
+        i2c_enable_10bit_address_mode(bus->ptr, trans->device->is_10bit_addressing);
+        hpm_i2c_bus_start_segment(bus);
+    }
+    HPM_I2C_BUS_EXIT_CRITICAL(level);
+
+    return status_success;
+}
+
+bool hpm_i2c_bus_is_busy(hpm_i2c_bus_t *bus)
+{
+    return bus->head != NULL;
+}
+
+void hpm_i2c_bus_tick(hpm_i2c_bus_t *bus)
+{
+    I2C_Type *ptr = bus->ptr;
+    uint32_t level;
+    bool expired = false;
+
+    level = HPM_I2C_BUS_ENTER_CRITICAL();
+    if ((bus->head != NULL) && (bus->ticks_left != 0)) {
+        bus->ticks_left--;
+        if (bus->ticks_left == 0) {
+            /* the reset command aborts the transfer and releases SCL and SDA */
+            i2c_disable_irq(ptr, I2C_EVENT_ALL_MASK);
+            ptr->CMD = I2C_CMD_RESET;
+            ptr->STATUS = HPM_I2C_BUS_STATUS_W1C_MASK;
+            bus->stopping = status_success;
+            expired = true;
+        }
+    }
+    HPM_I2C_BUS_EXIT_CRITICAL(level);
+
+    if (expired) {
+        hpm_i2c_bus_complete(bus, status_timeout);
+    }
+}
+
+void hpm_i2c_bus_isr_handler(hpm_i2c_bus_t *bus)
+{
+    I2C_Type *ptr = bus->ptr;
+    hpm_i2c_trans_t *trans = bus->head;
+    hpm_i2c_seg_t *seg;
+    hpm_stat_t stat;
+    uint32_t status, irq;
+    uint8_t data;
+
+    status = i2c_get_status(ptr);
+    irq = i2c_get_irq_setting(ptr);
+    if (trans == NULL) {
+        i2c_disable_irq(ptr, I2C_EVENT_ALL_MASK);
+        return;
+    }
+
+    if (bus->stopping != status_success) {
+        if (status & I2C_STATUS_CMPL_MASK) {
+            ptr->STATUS = HPM_I2C_BUS_STATUS_W1C_MASK;
+            stat = bus->stopping;
+            bus->stopping = status_success;
+            hpm_i2c_bus_complete(bus, stat);
+        }
+        return;
+    }
+
+    if ((status & I2C_STATUS_ARBLOSE_MASK) && (irq & I2C_EVENT_LOSS_ARBITRATION)) {
+        /* the controller has left the bus to the other master */
+        ptr->STATUS = HPM_I2C_BUS_STATUS_W1C_MASK;
+        hpm_i2c_bus_complete(bus, status_i2c_arbitration_lost);
+        return;
+    }
+
+    seg = &trans->seg[bus->seg_index];
+    if (seg->flags & HPM_I2C_SEG_READ) {
+        if ((status & I2C_STATUS_BYTERECV_MASK) && (irq & I2C_EVENT_BYTE_RECEIVED)) {
+            ptr->STATUS = I2C_STATUS_BYTERECV_MASK;
+            while (!i2c_fifo_is_empty(ptr) && (bus->pos < bus->seg_len)) {
+                data = ptr->DATA;
+                seg->buf[bus->pos++] = data;
+                bus->last_byte = data;
+                if ((bus->pos == bus->seg_len) && (seg->flags & HPM_I2C_SEG_STOP)) {
+                    ptr->CMD = I2C_CMD_NACK;
+                } else {
+                    ptr->CMD = I2C_CMD_ACK;
+                }
+            }
+            if ((bus->pos == bus->seg_len) && !(seg->flags & HPM_I2C_SEG_STOP)) {
+                /* the bus is held after the acknowledge until the next segment is issued */
+                hpm_i2c_bus_next_segment(bus);
+                return;
+            }
+        }
+    } else if ((status & I2C_STATUS_FIFOEMPTY_MASK) && (irq & I2C_EVENT_FIFO_EMPTY)) {
+        while ((bus->pos < bus->seg_len) && !i2c_fifo_is_full(ptr)) {
+            ptr->DATA = seg->buf[bus->pos++];
+        }
+        if (bus->pos == bus->seg_len) {
+            i2c_disable_irq(ptr, I2C_EVENT_FIFO_EMPTY);
+        }
+    }
+
+    if (status & I2C_STATUS_CMPL_MASK) {
+        ptr->STATUS = I2C_STATUS_CMPL_MASK;
+        if ((seg->flags & HPM_I2C_SEG_START) && !(status & I2C_STATUS_ADDRHIT_MASK)) {
+            stat = status_i2c_no_addr_hit;
+        } else if ((bus->pos < bus->seg_len) || (i2c_get_data_count(ptr) != 0)) {
+            stat = (seg->flags & HPM_I2C_SEG_READ) ? status_i2c_transmit_not_completed : status_i2c_no_ack;
+        } else {
+            stat = status_success;
+        }
+        if (stat != status_success) {
+            hpm_i2c_bus_fail(bus, stat, !(seg->flags & HPM_I2C_SEG_STOP));
+        } else {
+            hpm_i2c_bus_next_segment(bus);
+        }
+    }
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_COMPONENT_I2C_H
+#define HPM_COMPONENT_I2C_H
+
+#include "hpm_common.h"
+#include "hpm_soc_feature.h"
+#include "hpm_i2c_drv.h"
+
+/**
+ * @brief Interrupt driven I2C master transaction queue
+ *
+ * Transactions of several devices on one I2C are queued on a bus and run back
+ * to back from the I2C interrupt, so polling many devices does not keep the
+ * CPU spinning on the bus. A transaction is made of up to
+ * HPM_I2C_TRANS_MAX_SEGMENTS segments which share one START ... STOP, e.g.
+ * write the register then read the value after a repeated START.
+ *
+ * The application owns the I2C interrupt and calls hpm_i2c_bus_isr_handler()
+ * from it. Device timeouts are counted by hpm_i2c_bus_tick(), called from a
+ * periodic timer at the priority of the I2C interrupt or from a task.
+ */
+
+#ifndef HPM_I2C_TRANS_MAX_SEGMENTS
+#define HPM_I2C_TRANS_MAX_SEGMENTS (3U)
+#endif
+
+/* Segment flags */
+#define HPM_I2C_SEG_WRITE           (0U)
+#define HPM_I2C_SEG_READ            (1U << 0)   /**< master read, else master write */
+#define HPM_I2C_SEG_START           (1U << 1)   /**< (repeated) START and address before the data */
+#define HPM_I2C_SEG_STOP            (1U << 2)   /**< STOP after the data */
+#define HPM_I2C_SEG_LEN_FROM_PREV   (1U << 3)   /**< read length is the last byte read before, plus len_extra */
+
+enum {
+    status_i2c_trans_busy = MAKE_STATUS(status_group_i2c, 10),          /**< Transaction is queued or running */
+    status_i2c_arbitration_lost = MAKE_STATUS(status_group_i2c, 11),    /**< Another master won the bus */
+};
+
+/**
+ * @brief Device on a bus
+ */
+typedef struct {
+    uint16_t address;                       /**< 7-bit or 10-bit address */
+    bool is_10bit_addressing;
+    uint32_t timeout_ticks;                 /**< hpm_i2c_bus_tick() calls a transaction may take, 0 for no limit */
+} hpm_i2c_device_t;
+
+/**
+ * @brief Transaction segment
+ */
+typedef struct {
+    uint8_t *buf;
+    uint16_t len;                           /**< bytes, or the buffer size with HPM_I2C_SEG_LEN_FROM_PREV */
+    uint8_t len_extra;                      /**< bytes added to the read length with HPM_I2C_SEG_LEN_FROM_PREV */
+    uint8_t flags;                          /**< HPM_I2C_SEG_* */
+} hpm_i2c_seg_t;
+
+struct hpm_i2c_trans;
+
+/**
+ * @brief Transaction completion callback, called from the I2C interrupt or hpm_i2c_bus_tick()
+ */
+typedef void (*hpm_i2c_trans_callback_t)(struct hpm_i2c_trans *trans, void *cb_context);
+
+/**
+ * @brief Transaction
+ *
+ * The first segment needs HPM_I2C_SEG_START and the last one HPM_I2C_SEG_STOP.
+ * The transaction and its buffers must stay valid until it has completed.
+ */
+typedef struct hpm_i2c_trans {
+    struct hpm_i2c_trans *next;             /**< bus queue link */
+    const hpm_i2c_device_t *device;
+    hpm_i2c_seg_t seg[HPM_I2C_TRANS_MAX_SEGMENTS];
+    uint8_t seg_count;
+    uint16_t last_len;                      /**< bytes moved by the last segment run */
+    hpm_i2c_trans_callback_t callback;
+    void *cb_context;
+    volatile hpm_stat_t status;             /**< status_i2c_trans_busy while queued or running, then the result */
+} hpm_i2c_trans_t;
+
+/**
+ * @brief Bus statistics
+ */
+typedef struct {
+    uint32_t transfers;                     /**< transactions completed */
+    uint32_t errors;                        /**< transactions ended by NACK, arbitration loss or bad length */
+    uint32_t timeouts;                      /**< transactions aborted by the device timeout */
+    uint32_t max_queued;                    /**< longest queue seen */
+} hpm_i2c_bus_stat_t;
+
+/**
+ * @brief Bus, runs the queued transactions of the devices on one I2C master
+ */
+typedef struct {
+    I2C_Type *ptr;
+    hpm_i2c_trans_t *head;                  /**< running transaction */
+    hpm_i2c_trans_t *tail;                  /**< last queued transaction */
+    uint32_t queued;
+    uint8_t seg_index;                      /**< running segment */
+    uint16_t seg_len;                       /**< bytes of the running segment */
+    uint16_t pos;                           /**< bytes moved in the running segment */
+    uint8_t last_byte;                      /**< last byte read, for HPM_I2C_SEG_LEN_FROM_PREV */
+    hpm_stat_t stopping;                    /**< result held while a STOP is sent after an error */
+    uint32_t ticks_left;
+    hpm_i2c_bus_stat_t stat;
+} hpm_i2c_bus_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize a bus
+ *
+ * @param [out] bus bus
+ * @param [in] ptr I2C base address, initialized by i2c_init_master()
+ */
+void hpm_i2c_bus_init(hpm_i2c_bus_t *bus, I2C_Type *ptr);
+
+/**
+ * @brief Set up a write transaction
+ *
+ * @param [out] trans transaction
+ * @param [in] device device
+ * @param [in] buf data to write
+ * @param [in] size bytes to write, up to I2C_SOC_TRANSFER_COUNT_MAX
+ */
+void hpm_i2c_trans_write(hpm_i2c_trans_t *trans, const hpm_i2c_device_t *device, uint8_t *buf, uint32_t size);
+
+/**
+ * @brief Set up a read transaction
+ *
+ * @param [out] trans transaction
+ * @param [in] device device
+ * @param [out] buf read data
+ * @param [in] size bytes to read, up to I2C_SOC_TRANSFER_COUNT_MAX
+ */
+void hpm_i2c_trans_read(hpm_i2c_trans_t *trans, const hpm_i2c_device_t *device, uint8_t *buf, uint32_t size);
+
+/**
+ * @brief Set up a write then read transaction joined by a repeated START
+ *
+ * @param [out] trans transaction
+ * @param [in] device device
+ * @param [in] wbuf data to write, e.g. a register address
+ * @param [in] wsize bytes to write, up to I2C_SOC_TRANSFER_COUNT_MAX
+ * @param [out] rbuf read data
+ * @param [in] rsize bytes to read, up to I2C_SOC_TRANSFER_COUNT_MAX
+ */
+void hpm_i2c_trans_write_read(hpm_i2c_trans_t *trans, const hpm_i2c_device_t *device,
+                              uint8_t *wbuf, uint32_t wsize, uint8_t *rbuf, uint32_t rsize);
+
+/**
+ * @brief Queue a transaction, it starts at once when the bus is idle
+ *
+ * @param [in] bus bus
+ * @param [in] trans transaction
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] cb_context callback argument
+ *
+ * @retval status_success if the transaction was queued
+ * @retval status_invalid_argument if the segments are not valid
+ * @retval status_i2c_trans_busy if the transaction is already queued
+ */
+hpm_stat_t hpm_i2c_bus_submit(hpm_i2c_bus_t *bus, hpm_i2c_trans_t *trans,
+                              hpm_i2c_trans_callback_t callback, void *cb_context);
+
+/**
+ * @brief Check whether transactions are queued or running
+ *
+ * @param [in] bus bus
+ * @retval true if the bus is busy
+ */
+bool hpm_i2c_bus_is_busy(hpm_i2c_bus_t *bus);
+
+/**
+ * @brief Count the device timeout of the running transaction
+ *
+ * @note a transaction exceeding its timeout is aborted with status_timeout
+ *
+ * @param [in] bus bus
+ */
+void hpm_i2c_bus_tick(hpm_i2c_bus_t *bus);
+
+/**
+ * @brief I2C interrupt handler of the bus
+ *
+ * @param [in] bus bus
+ */
+void hpm_i2c_bus_isr_handler(hpm_i2c_bus_t *bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_COMPONENT_I2C_H */
@@ -35,6 +35,7 @@ typedef struct {
 typedef enum {
     ipc_remote_start_event = 1,
     ipc_remote_rpmsg_event,
+    ipc_remote_queue_event,
     ipc_event_table_len
 } ipc_event_type_t;
 
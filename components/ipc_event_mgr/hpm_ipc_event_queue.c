@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include <string.h>
+#include "hpm_common.h"
+#include "hpm_ipc_event_mgr.h"
+#include "hpm_ipc_event_queue.h"
+
+/* the ring is single producer, posts from task and interrupt context of this core are serialized */
+#ifndef IPC_EVENT_QUEUE_ENTER_CRITICAL
+#include "hpm_soc.h"
+#include "hpm_interrupt.h"
+#define IPC_EVENT_QUEUE_ENTER_CRITICAL()      disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define IPC_EVENT_QUEUE_EXIT_CRITICAL(level)  restore_global_irq((level) & CSR_MSTATUS_MIE_MASK)
+#endif
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+#define IPC_EVENT_QUEUE_RING_MAGIC  (0x51455649UL) /* "IVEQ" */
+#define IPC_EVENT_QUEUE_PAD_TYPE    (0xFFFFU)
+#define IPC_EVENT_QUEUE_FENCE()     __sync_synchronize()
+
+/*
+ * ring header, 32 bytes, shared by both cores
+ * head is written by the producer only, tail by the consumer only,
+ * doorbell_armed is set by the consumer and cleared by the producer.
+ */
+typedef struct {
+    volatile uint32_t magic;
+    volatile uint32_t size;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t doorbell_armed;
+    uint32_t reserved[3];
+} ipc_event_queue_ring_t;
+
+/* event header, followed by the payload padded to 8 bytes */
+typedef struct {
+    uint16_t type;
+    uint16_t size;
+    uint32_t timestamp;
+} ipc_event_queue_event_t;
+
+typedef struct {
+    ipc_queue_event_callback_t callback;
+    void *context;
+} ipc_event_queue_entry_t;
+
+/*****************************************************************************************************************
+ *
+ *  Prototypes
+ *
+ *****************************************************************************************************************/
+static void ipc_event_queue_doorbell_handler(uint16_t event_data, void *context);
+static uint32_t ipc_event_queue_drain(ipc_event_queue_ring_t *ring, uint32_t max_events);
+
+/*****************************************************************************************************************
+ *
+ *  Variables
+ *
+ *****************************************************************************************************************/
+static ipc_event_queue_config_t s_queue_config;
+static ipc_event_queue_entry_t s_queue_table[IPC_EVENT_QUEUE_MAX_TYPES];
+static ipc_event_queue_stat_t s_queue_stat[IPC_EVENT_QUEUE_MAX_TYPES];
+static uint32_t s_queue_doorbell_count;
+static bool s_queue_initialized;
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+static inline uint8_t *ipc_event_queue_ring_data(ipc_event_queue_ring_t *ring)
+{
+    return (uint8_t *)ring + IPC_EVENT_QUEUE_RING_HEADER_SIZE;
+}
+
+static bool ipc_event_queue_ring_size_valid(uint32_t mem_size)
+{
+    uint32_t data_size;
+
+    if (mem_size <= IPC_EVENT_QUEUE_RING_HEADER_SIZE) {
+        return false;
+    }
+    data_size = mem_size - IPC_EVENT_QUEUE_RING_HEADER_SIZE;
+    return (data_size >= 16U) && ((data_size & (data_size - 1U)) == 0U);
+}
+
+void ipc_event_queue_get_default_config(ipc_event_queue_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->dispatch = ipc_event_queue_dispatch_in_isr;
+}
+
+hpm_stat_t ipc_event_queue_init(const ipc_event_queue_config_t *config)
+{
+    ipc_event_queue_ring_t *tx_ring;
+
+    if ((config == NULL) || (config->tx_ring == NULL) || (config->rx_ring == NULL)
+     || !ipc_event_queue_ring_size_valid(config->tx_ring_size) || !ipc_event_queue_ring_size_valid(config->rx_ring_size)
+     || (((uintptr_t)config->tx_ring & 7U) != 0U) || (((uintptr_t)config->rx_ring & 7U) != 0U)
+     || ((config->dispatch == ipc_event_queue_dispatch_in_task) && (config->notify == NULL))) {
+        return status_invalid_argument;
+    }
+
+    s_queue_config = *config;
+    s_queue_doorbell_count = 0;
+    ipc_event_queue_reset_stat();
+
+    /* the remote core ignores the ring until the magic is written */
+    tx_ring = (ipc_event_queue_ring_t *)config->tx_ring;
+    tx_ring->magic = 0;
+    IPC_EVENT_QUEUE_FENCE();
+    tx_ring->size = config->tx_ring_size - IPC_EVENT_QUEUE_RING_HEADER_SIZE;
+    tx_ring->head = 0;
+    tx_ring->tail = 0;
+    tx_ring->doorbell_armed = 1;
+    IPC_EVENT_QUEUE_FENCE();
+    tx_ring->magic = IPC_EVENT_QUEUE_RING_MAGIC;
+
+    s_queue_initialized = true;
+
+    return ipc_register_event(ipc_remote_queue_event, ipc_event_queue_doorbell_handler, NULL);
+}
+
+hpm_stat_t ipc_event_queue_register(uint16_t type, ipc_queue_event_callback_t callback, void *context)
+{
+    if ((type >= IPC_EVENT_QUEUE_MAX_TYPES) || (callback == NULL)) {
+        return status_invalid_argument;
+    }
+    s_queue_table[type].callback = callback;
+    s_queue_table[type].context = context;
+
+    return status_success;
+}
+
+hpm_stat_t ipc_event_queue_post(uint16_t type, const void *payload, uint16_t size)
+{
+    ipc_event_queue_ring_t *ring = (ipc_event_queue_ring_t *)s_queue_config.tx_ring;
+    ipc_event_queue_event_t *event;
+    uint8_t *data;
+    uint32_t needed;
+    uint32_t head;
+    uint32_t offset;
+    uint32_t to_end;
+    uint32_t pad = 0;
+    uint32_t level;
+    bool ring_doorbell = false;
+
+    if ((type >= IPC_EVENT_QUEUE_MAX_TYPES) || ((payload == NULL) && (size != 0U))) {
+        return status_invalid_argument;
+    }
+    if (!s_queue_initialized) {
+        return status_ipc_event_queue_not_ready;
+    }
+    needed = IPC_EVENT_QUEUE_EVENT_SIZE(size);
+    /*
+     * an event wraps by padding to the end of the ring, which only the consumer frees: up to
+     * half the ring, the padding and the event always fit into a drained ring
+     */
+    if (needed > (ring->size / 2U)) {
+        return status_invalid_argument;
+    }
+
+    level = IPC_EVENT_QUEUE_ENTER_CRITICAL();
+
+    head = ring->head;
+    offset = head & (ring->size - 1U);
+    to_end = ring->size - offset;
+    if (to_end < needed) {
+        pad = to_end;
+    }
+    if ((ring->size - (head - ring->tail)) < (pad + needed)) {
+        s_queue_stat[type].dropped++;
+        IPC_EVENT_QUEUE_EXIT_CRITICAL(level);
+        return status_ipc_event_queue_full;
+    }
+
+    data = ipc_event_queue_ring_data(ring);
+    if (pad != 0U) {
+        event = (ipc_event_queue_event_t *)&data[offset];
+        event->type = IPC_EVENT_QUEUE_PAD_TYPE;
+        event->size = (uint16_t)(pad - sizeof(ipc_event_queue_event_t));
+        event->timestamp = 0;
+        offset = 0;
+    }
+    event = (ipc_event_queue_event_t *)&data[offset];
+    event->type = type;
+    event->size = size;
+    event->timestamp = (s_queue_config.timestamp != NULL) ? s_queue_config.timestamp() : 0U;
+    if (size != 0U) {
+        memcpy(&event[1], payload, size);
+    }
+
+    /* publish the event before checking the doorbell, pairs with the fence in the consumer */
+    IPC_EVENT_QUEUE_FENCE();
+    ring->head = head + pad + needed;
+    IPC_EVENT_QUEUE_FENCE();
+    if (ring->doorbell_armed != 0U) {
+        ring->doorbell_armed = 0;
+        ring_doorbell = true;
+        s_queue_doorbell_count++;
+    }
+    s_queue_stat[type].posted++;
+
+    IPC_EVENT_QUEUE_EXIT_CRITICAL(level);
+
+    if (ring_doorbell) {
+        ipc_tigger_event(ipc_remote_queue_event, 0);
+    }
+
+    return status_success;
+}
+
+static void ipc_event_queue_update_latency(ipc_event_queue_stat_t *stat, uint32_t timestamp)
+{
+    uint32_t latency;
+
+    if (s_queue_config.timestamp == NULL) {
+        return;
+    }
+    latency = s_queue_config.timestamp() - timestamp;
+    if ((stat->received == 1U) || (latency < stat->latency_min)) {
+        stat->latency_min = latency;
+    }
+    if (latency > stat->latency_max) {
+        stat->latency_max = latency;
+    }
+    stat->latency_sum += latency;
+}
+
+static uint32_t ipc_event_queue_drain(ipc_event_queue_ring_t *ring, uint32_t max_events)
+{
+    const ipc_event_queue_event_t *event;
+    uint8_t *data = ipc_event_queue_ring_data(ring);
+    uint32_t mask = ring->size - 1U;
+    uint32_t count = 0;
+    uint32_t tail = ring->tail;
+    uint32_t head;
+
+    while (count < max_events) {
+        head = ring->head;
+        if (head == tail) {
+            break;
+        }
+        /* read the event only after head has been observed */
+        IPC_EVENT_QUEUE_FENCE();
+        event = (const ipc_event_queue_event_t *)&data[tail & mask];
+        if (event->type < IPC_EVENT_QUEUE_MAX_TYPES) {
+            s_queue_stat[event->type].received++;
+            ipc_event_queue_update_latency(&s_queue_stat[event->type], event->timestamp);
+            if (s_queue_table[event->type].callback != NULL) {
+                s_queue_table[event->type].callback(event->type, &event[1], event->size,
+                                                    s_queue_table[event->type].context);
+            }
+            count++;
+        }
+        tail += IPC_EVENT_QUEUE_EVENT_SIZE(event->size);
+        /* release the slot only after the callback is done with the payload */
+        IPC_EVENT_QUEUE_FENCE();
+        ring->tail = tail;
+    }
+
+    return count;
+}
+
+uint32_t ipc_event_queue_process(uint32_t max_events)
+{
+    ipc_event_queue_ring_t *ring = (ipc_event_queue_ring_t *)s_queue_config.rx_ring;
+    uint32_t count = 0;
+
+    if (!s_queue_initialized || (ring->magic != IPC_EVENT_QUEUE_RING_MAGIC)) {
+        return 0;
+    }
+    if (ring->size != (s_queue_config.rx_ring_size - IPC_EVENT_QUEUE_RING_HEADER_SIZE)) {
+        return 0;
+    }
+
+    while (count < max_events) {
+        count += ipc_event_queue_drain(ring, max_events - count);
+        if (ring->head != ring->tail) {
+            /* stopped on max_events, the caller comes back for the rest */
+            break;
+        }
+        /* arm the doorbell, then check again for an event posted in between */
+        ring->doorbell_armed = 1;
+        IPC_EVENT_QUEUE_FENCE();
+        if (ring->head == ring->tail) {
+            break;
+        }
+        ring->doorbell_armed = 0;
+    }
+
+    return count;
+}
+
+static void ipc_event_queue_doorbell_handler(uint16_t event_data, void *context)
+{
+    (void)event_data;
+    (void)context;
+
+    if (s_queue_config.dispatch == ipc_event_queue_dispatch_in_task) {
+        s_queue_config.notify(s_queue_config.notify_context);
+    } else {
+        (void)ipc_event_queue_process(UINT32_MAX);
+    }
+}
+
+hpm_stat_t ipc_event_queue_get_stat(uint16_t type, ipc_event_queue_stat_t *stat)
+{
+    if ((type >= IPC_EVENT_QUEUE_MAX_TYPES) || (stat == NULL)) {
+        return status_invalid_argument;
+    }
+    *stat = s_queue_stat[type];
+
+    return status_success;
+}
+
+void ipc_event_queue_reset_stat(void)
+{
+    memset(s_queue_stat, 0, sizeof(s_queue_stat));
+}
+
+uint32_t ipc_event_queue_get_doorbell_count(void)
+{
+    return s_queue_doorbell_count;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_IPC_EVENT_QUEUE_H
+#define HPM_IPC_EVENT_QUEUE_H
+
+#include "hpm_common.h"
+#include "hpm_ipc_event_mgr.h"
+
+/**
+ * @brief IPC event queue
+ *
+ * Events carrying a payload are posted into a lock-free single producer /
+ * single consumer ring in shared memory, one ring per direction. The mailbox
+ * is only used as a doorbell (ipc_remote_queue_event): the consumer arms the
+ * doorbell once its ring is drained and the producer rings it only for the
+ * first event posted after that, so a burst raises one interrupt.
+ *
+ * Both rings must be placed in memory shared and noncacheable for both cores,
+ * e.g. with ATTR_SHARE_MEM. The local tx ring is the remote rx ring and vice
+ * versa.
+ */
+
+#ifndef IPC_EVENT_QUEUE_MAX_TYPES
+#define IPC_EVENT_QUEUE_MAX_TYPES (16U)
+#endif
+
+/* size of the ring header placed at the start of the ring memory */
+#define IPC_EVENT_QUEUE_RING_HEADER_SIZE (32U)
+
+/* ring memory needed for a data area of data_size bytes, data_size must be a power of 2 */
+#define IPC_EVENT_QUEUE_RING_MEM_SIZE(data_size) (IPC_EVENT_QUEUE_RING_HEADER_SIZE + (data_size))
+
+/* events are 8 byte aligned and carry an 8 byte header */
+#define IPC_EVENT_QUEUE_EVENT_SIZE(payload_size) (8U + (((payload_size) + 7U) & ~7U))
+
+/* largest payload of a ring with a data area of data_size bytes, an event takes up to half the data area */
+#define IPC_EVENT_QUEUE_MAX_PAYLOAD(data_size) (((data_size) / 2U) - 8U)
+
+enum {
+    status_ipc_event_queue_full = MAKE_STATUS(status_group_ipc_event_mgr, 0),      /**< No space in the tx ring */
+    status_ipc_event_queue_not_ready = MAKE_STATUS(status_group_ipc_event_mgr, 1), /**< Queue is not initialized */
+};
+
+/**
+ * @brief Type definition of queued event callback function pointer.
+ *
+ * @param [in] event type
+ * @param [in] event payload, only valid during the callback
+ * @param [in] payload size in bytes
+ * @param [in] callback context data
+ */
+typedef void (*ipc_queue_event_callback_t)(uint16_t type, const void *payload, uint16_t size, void *context);
+
+/**
+ * @brief Time stamp source shared by both cores, used for latency counters
+ */
+typedef uint32_t (*ipc_event_queue_timestamp_t)(void);
+
+/**
+ * @brief Called from the doorbell ISR when events are pending in deferred mode
+ */
+typedef void (*ipc_event_queue_notify_t)(void *context);
+
+/**
+ * @brief Context the callbacks are running in
+ */
+typedef enum {
+    ipc_event_queue_dispatch_in_isr = 0,   /**< callbacks run in the mailbox ISR */
+    ipc_event_queue_dispatch_in_task,      /**< ISR calls notify, callbacks run in ipc_event_queue_process() */
+} ipc_event_queue_dispatch_t;
+
+/**
+ * @brief Queue configuration
+ */
+typedef struct {
+    void *tx_ring;                          /**< ring memory for local to remote events */
+    uint32_t tx_ring_size;                  /**< tx ring memory size, see IPC_EVENT_QUEUE_RING_MEM_SIZE */
+    void *rx_ring;                          /**< ring memory for remote to local events */
+    uint32_t rx_ring_size;                  /**< rx ring memory size, see IPC_EVENT_QUEUE_RING_MEM_SIZE */
+    ipc_event_queue_dispatch_t dispatch;    /**< callback context */
+    ipc_event_queue_notify_t notify;        /**< deferred mode wakeup, e.g. give a semaphore */
+    void *notify_context;                   /**< notify context */
+    ipc_event_queue_timestamp_t timestamp;  /**< shared time stamp, NULL disables the latency counters */
+} ipc_event_queue_config_t;
+
+/**
+ * @brief Per event type statistics
+ */
+typedef struct {
+    uint32_t posted;        /**< events posted locally */
+    uint32_t dropped;       /**< events dropped locally because the tx ring was full */
+    uint32_t received;      /**< events dispatched locally */
+    uint32_t latency_min;   /**< minimum post to dispatch latency in time stamp ticks */
+    uint32_t latency_max;   /**< maximum post to dispatch latency in time stamp ticks */
+    uint64_t latency_sum;   /**< sum of latencies, average is latency_sum / received */
+} ipc_event_queue_stat_t;
+
+#ifdef __cplusplus
+
+extern "C" {
+#endif
+
+/**
+ * @brief Get default queue configuration
+ *
+ * @param [out] config queue configuration
+ */
+void ipc_event_queue_get_default_config(ipc_event_queue_config_t *config);
+
+/**
+ * @brief Initialize the event queue
+ *
+ * Initializes the local tx ring and registers the doorbell event, ipc_init()
+ * has to be called before. The rx ring is initialized by the remote core.
+ *
+ * @param [in] config queue configuration
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the configuration is invalid
+ */
+hpm_stat_t ipc_event_queue_init(const ipc_event_queue_config_t *config);
+
+/**
+ * @brief Register queued event callback
+ *
+ * @param [in] event type, less than IPC_EVENT_QUEUE_MAX_TYPES
+ * @param [in] event callback function
+ * @param [in] event callback data
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the parameter is invalid
+ */
+hpm_stat_t ipc_event_queue_register(uint16_t type, ipc_queue_event_callback_t callback, void *context);
+
+/**
+ * @brief Post an event with payload to the remote core
+ *
+ * Safe to be called from task and interrupt context of the local core.
+ *
+ * @param [in] event type, less than IPC_EVENT_QUEUE_MAX_TYPES
+ * @param [in] payload, may be NULL if size is 0
+ * @param [in] payload size in bytes, up to IPC_EVENT_QUEUE_MAX_PAYLOAD() of the tx ring
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameters are invalid or the payload is too large
+ * @retval status_ipc_event_queue_full if the tx ring has no space left
+ * @retval status_ipc_event_queue_not_ready if the queue is not initialized
+ */
+hpm_stat_t ipc_event_queue_post(uint16_t type, const void *payload, uint16_t size);
+
+/**
+ * @brief Dispatch pending events
+ *
+ * Called by the doorbell ISR in ipc_event_queue_dispatch_in_isr mode, by the
+ * application task after notify in ipc_event_queue_dispatch_in_task mode.
+ *
+ * @param [in] maximum number of events to dispatch
+ *
+ * @return number of dispatched events
+ */
+uint32_t ipc_event_queue_process(uint32_t max_events);
+
+/**
+ * @brief Get statistics of an event type
+ *
+ * @param [in] event type
+ * @param [out] statistics
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the parameter is invalid
+ */
+hpm_stat_t ipc_event_queue_get_stat(uint16_t type, ipc_event_queue_stat_t *stat);
+
+/**
+ * @brief Clear statistics of all event types
+ */
+void ipc_event_queue_reset_stat(void);
+
+/**
+ * @brief Number of doorbells raised towards the remote core
+ *
+ * @return doorbell count, compare with the posted events for the coalescing ratio
+ */
+uint32_t ipc_event_queue_get_doorbell_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_IPC_EVENT_QUEUE_H */
@@ -0,0 +1,604 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_jpeg_stream.h"
+#include "hpm_jpeg_stream_sw.h"
+#if HPM_JPEG_STREAM_USE_HW
+#include "hpm_soc.h"
+#include "hpm_jpeg_drv.h"
+#include "hpm_l1c_drv.h"
+#endif
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+#define HPM_JPEG_MARKER_SOF0 (0xC0U)
+#define HPM_JPEG_MARKER_RST0 (0xD0U)
+#define HPM_JPEG_MARKER_RST7 (0xD7U)
+#define HPM_JPEG_MARKER_SOI  (0xD8U)
+#define HPM_JPEG_MARKER_EOI  (0xD9U)
+#define HPM_JPEG_MARKER_SOS  (0xDAU)
+#define HPM_JPEG_MARKER_DRI  (0xDDU)
+
+#define HPM_JPEG_SEGMENT_LENGTH(p) (((uint32_t)(p)[2] << 8) | (p)[3])
+
+/*****************************************************************************************************************
+ *
+ *  Prototypes
+ *
+ *****************************************************************************************************************/
+#if HPM_JPEG_STREAM_USE_HW
+static uint32_t hpm_jpeg_stream_find_segment(const uint8_t *buf, uint32_t size, uint8_t marker);
+static void hpm_jpeg_stream_hw_init(JPEG_Type *ptr, const hpm_jpeg_stream_hw_tables_t *tables);
+static hpm_stat_t hpm_jpeg_stream_hw_wait(JPEG_Type *ptr);
+static hpm_stat_t hpm_jpeg_stream_hw_enc_start(hpm_jpeg_stream_enc_t *enc);
+static hpm_stat_t hpm_jpeg_stream_hw_enc_strip(hpm_jpeg_stream_enc_t *enc, const uint8_t *pixels, uint32_t rows, bool last);
+static hpm_stat_t hpm_jpeg_stream_hw_decode(const hpm_jpeg_stream_dec_config_t *config, hpm_jpeg_stream_dec_info_t *info);
+#endif
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+void hpm_jpeg_stream_get_default_enc_config(hpm_jpeg_stream_enc_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->backend = hpm_jpeg_stream_backend_hw;
+    config->pixel_format = display_pixel_format_rgb565;
+    config->strip_rows = 16;
+    config->quality = 80;
+}
+
+void hpm_jpeg_stream_get_default_dec_config(hpm_jpeg_stream_dec_config_t *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->backend = hpm_jpeg_stream_backend_hw;
+    config->pixel_format = display_pixel_format_rgb565;
+    config->strip_rows = 16;
+}
+
+static bool hpm_jpeg_stream_format_is_supported(display_pixel_format_t format)
+{
+    return (format == display_pixel_format_rgb565) || (format == display_pixel_format_y8);
+}
+
+hpm_stat_t hpm_jpeg_stream_enc_emit(hpm_jpeg_stream_enc_t *enc, const uint8_t *data, uint32_t len)
+{
+    if (len == 0) {
+        return status_success;
+    }
+    if (!enc->config.sink(enc->config.context, data, len)) {
+        return status_jpeg_stream_aborted;
+    }
+    enc->stat.bytes += len;
+    if (len > enc->stat.max_chunk) {
+        enc->stat.max_chunk = len;
+    }
+    return status_success;
+}
+
+hpm_stat_t hpm_jpeg_stream_enc_start(hpm_jpeg_stream_enc_t *enc, const hpm_jpeg_stream_enc_config_t *config)
+{
+    hpm_stat_t stat;
+
+    if ((enc == NULL) || (config == NULL) || (config->sink == NULL) || (config->out_buf == NULL)
+        || (config->out_size == 0) || (config->width == 0) || (config->height == 0) || (config->strip_rows == 0)
+        || !hpm_jpeg_stream_format_is_supported(config->pixel_format)) {
+        return status_invalid_argument;
+    }
+
+    memset(enc, 0, sizeof(*enc));
+    enc->config = *config;
+
+    switch (config->backend) {
+#if HPM_JPEG_STREAM_USE_HW
+    case hpm_jpeg_stream_backend_hw:
+        stat = hpm_jpeg_stream_hw_enc_start(enc);
+        break;
+#endif
+#if HPM_JPEG_STREAM_USE_SW
+    case hpm_jpeg_stream_backend_sw:
+        stat = hpm_jpeg_stream_sw_enc_start(enc);
+        break;
+#endif
+    default:
+        stat = status_jpeg_stream_unsupported;
+        break;
+    }
+
+    enc->started = (stat == status_success);
+    return stat;
+}
+
+hpm_stat_t hpm_jpeg_stream_enc_write(hpm_jpeg_stream_enc_t *enc, const uint8_t *pixels, uint32_t rows)
+{
+    hpm_stat_t stat = status_success;
+
+    if (!enc->started || (pixels == NULL) || (rows == 0) || ((enc->stat.rows + rows) > enc->config.height)) {
+        return status_invalid_argument;
+    }
+
+#if HPM_JPEG_STREAM_USE_SW
+    if (enc->config.backend == hpm_jpeg_stream_backend_sw) {
+        stat = hpm_jpeg_stream_sw_enc_write(enc, pixels, rows);
+        if (stat == status_success) {
+            enc->stat.rows += rows;
+        } else {
+            hpm_jpeg_stream_enc_abort(enc);
+        }
+        return stat;
+    }
+#endif
+
+#if HPM_JPEG_STREAM_USE_HW
+    uint32_t pitch = enc->config.width * display_get_pixel_size_in_byte(enc->config.pixel_format);
+    uint32_t n;
+
+    while ((rows != 0) && (stat == status_success)) {
+        n = MIN(rows, enc->config.strip_rows);
+        /* only the strip ending the image may be short */
+        if ((n < enc->config.strip_rows) && ((enc->stat.rows + n) != enc->config.height)) {
+            return status_invalid_argument;
+        }
+        stat = hpm_jpeg_stream_hw_enc_strip(enc, pixels, n, (enc->stat.rows + n) == enc->config.height);
+        enc->stat.rows += n;
+        pixels += n * pitch;
+        rows -= n;
+    }
+    if (stat != status_success) {
+        hpm_jpeg_stream_enc_abort(enc);
+    }
+#endif
+
+    return stat;
+}
+
+hpm_stat_t hpm_jpeg_stream_enc_finish(hpm_jpeg_stream_enc_t *enc)
+{
+    hpm_stat_t stat = status_success;
+
+    if (!enc->started || (enc->stat.rows != enc->config.height)) {
+        return status_invalid_argument;
+    }
+
+#if HPM_JPEG_STREAM_USE_SW
+    if (enc->config.backend == hpm_jpeg_stream_backend_sw) {
+        stat = hpm_jpeg_stream_sw_enc_finish(enc);
+    }
+#endif
+    /* the hardware backend has sent EOI with the last strip */
+    enc->started = false;
+    return stat;
+}
+
+void hpm_jpeg_stream_enc_abort(hpm_jpeg_stream_enc_t *enc)
+{
+#if HPM_JPEG_STREAM_USE_SW
+    if (enc->sw != NULL) {
+        hpm_jpeg_stream_sw_enc_abort(enc);
+    }
+#endif
+    enc->started = false;
+}
+
+hpm_stat_t hpm_jpeg_stream_decode(const hpm_jpeg_stream_dec_config_t *config, hpm_jpeg_stream_dec_info_t *info)
+{
+    hpm_jpeg_stream_dec_info_t local_info;
+
+    if ((config == NULL) || (config->source == NULL) || (config->strip == NULL) || (config->in_buf == NULL)
+        || (config->in_size < 64U) || (config->strip_buf == NULL) || (config->strip_size == 0)
+        || !hpm_jpeg_stream_format_is_supported(config->pixel_format)) {
+        return status_invalid_argument;
+    }
+    if (info == NULL) {
+        info = &local_info;
+    }
+    memset(info, 0, sizeof(*info));
+
+    switch (config->backend) {
+#if HPM_JPEG_STREAM_USE_HW
+    case hpm_jpeg_stream_backend_hw:
+        return hpm_jpeg_stream_hw_decode(config, info);
+#endif
+#if HPM_JPEG_STREAM_USE_SW
+    case hpm_jpeg_stream_backend_sw:
+        return hpm_jpeg_stream_sw_decode(config, info);
+#endif
+    default:
+        return status_jpeg_stream_unsupported;
+    }
+}
+
+#if HPM_JPEG_STREAM_USE_HW
+/* offset of the first marker segment of a type before SOS, SOS itself can be searched, 0 if not found */
+static uint32_t hpm_jpeg_stream_find_segment(const uint8_t *buf, uint32_t size, uint8_t marker)
+{
+    uint32_t i = 2;
+
+    if ((size < 4) || (buf[0] != 0xFF) || (buf[1] != HPM_JPEG_MARKER_SOI)) {
+        return 0;
+    }
+    while ((i + 4) <= size) {
+        if (buf[i] != 0xFF) {
+            return 0;
+        }
+        if (buf[i + 1] == 0xFF) {
+            i++;
+            continue;
+        }
+        if (buf[i + 1] == marker) {
+            return i;
+        }
+        if (buf[i + 1] == HPM_JPEG_MARKER_SOS) {
+            return 0;
+        }
+        i += 2 + HPM_JPEG_SEGMENT_LENGTH(&buf[i]);
+    }
+    return 0;
+}
+
+static void hpm_jpeg_stream_hw_init(JPEG_Type *ptr, const hpm_jpeg_stream_hw_tables_t *tables)
+{
+    jpeg_init(ptr);
+    jpeg_enable(ptr);
+    jpeg_fill_table(ptr, jpeg_table_huffmin, (uint8_t *)tables->huffmin, 16);
+    jpeg_fill_table(ptr, jpeg_table_huffbase, (uint8_t *)tables->huffbase, 64);
+    jpeg_fill_table(ptr, jpeg_table_huffsymb, (uint8_t *)tables->huffsymb, 336);
+    jpeg_fill_table(ptr, jpeg_table_huffenc, (uint8_t *)tables->huffenc, 384);
+    jpeg_fill_table(ptr, jpeg_table_qmem, (uint8_t *)tables->qtable, 256);
+    jpeg_disable(ptr);
+}
+
+static hpm_stat_t hpm_jpeg_stream_hw_wait(JPEG_Type *ptr)
+{
+    do {
+        if (jpeg_get_status(ptr) & JPEG_EVENT_OUT_DMA_FINISH) {
+            jpeg_clear_status(ptr, JPEG_EVENT_OUT_DMA_FINISH);
+            return status_success;
+        }
+        if (jpeg_get_status(ptr) & JPEG_EVENT_ERROR) {
+            jpeg_clear_status(ptr, JPEG_EVENT_ERROR);
+            return status_jpeg_stream_codec_error;
+        }
+    } while (1);
+}
+
+static void hpm_jpeg_stream_hw_writeback(const void *addr, uint32_t size)
+{
+    uint32_t start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)addr);
+    uint32_t end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)addr + size);
+
+    l1c_dc_writeback(start, end - start);
+}
+
+static void hpm_jpeg_stream_hw_invalidate(const void *addr, uint32_t size)
+{
+    uint32_t start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)addr);
+    uint32_t end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)addr + size);
+
+    l1c_dc_invalidate(start, end - start);
+}
+
+static hpm_stat_t hpm_jpeg_stream_hw_enc_start(hpm_jpeg_stream_enc_t *enc)
+{
+    const hpm_jpeg_stream_enc_config_t *config = &enc->config;
+    uint32_t mcu = HPM_JPEG_STREAM_MCU_SIZE(config->pixel_format);
+    uint32_t interval;
+    uint32_t sof;
+    uint32_t sos;
+    uint8_t size[4];
+    uint8_t dri[6];
+    hpm_stat_t stat;
+
+    if ((config->base == NULL) || (config->tables == NULL) || (config->header == NULL)) {
+        return status_invalid_argument;
+    }
+    if ((config->width % mcu) || (config->height % mcu)) {
+        return status_jpeg_stream_unsupported;
+    }
+    interval = (config->width / mcu) * (config->strip_rows / mcu);
+    if ((config->strip_rows % mcu) || (interval > 0xFFFFU)
+        || (config->out_size < HPM_JPEG_STREAM_HW_ENC_OUT_SIZE(config->width, config->strip_rows, config->pixel_format))) {
+        return status_invalid_argument;
+    }
+
+    sof = hpm_jpeg_stream_find_segment(config->header, config->header_size, HPM_JPEG_MARKER_SOF0);
+    sos = hpm_jpeg_stream_find_segment(config->header, config->header_size, HPM_JPEG_MARKER_SOS);
+    if ((sof == 0) || (sos == 0) || (sof > sos)
+        || (hpm_jpeg_stream_find_segment(config->header, config->header_size, HPM_JPEG_MARKER_DRI) != 0)) {
+        return status_invalid_argument;
+    }
+
+    hpm_jpeg_stream_hw_init((JPEG_Type *)config->base, config->tables);
+
+    /* template up to the SOF0 frame size, the frame size, the rest up to SOS, DRI, SOS */
+    size[0] = config->height >> 8;
+    size[1] = config->height & 0xFF;
+    size[2] = config->width >> 8;
+    size[3] = config->width & 0xFF;
+    dri[0] = 0xFF;
+    dri[1] = HPM_JPEG_MARKER_DRI;
+    dri[2] = 0;
+    dri[3] = 4;
+    dri[4] = interval >> 8;
+    dri[5] = interval & 0xFF;
+
+    stat = hpm_jpeg_stream_enc_emit(enc, config->header, sof + 5);
+    if (stat == status_success) {
+        stat = hpm_jpeg_stream_enc_emit(enc, size, sizeof(size));
+    }
+    if (stat == status_success) {
+        stat = hpm_jpeg_stream_enc_emit(enc, &config->header[sof + 9], sos - (sof + 9));
+    }
+    if (stat == status_success) {
+        stat = hpm_jpeg_stream_enc_emit(enc, dri, sizeof(dri));
+    }
+    if (stat == status_success) {
+        stat = hpm_jpeg_stream_enc_emit(enc, &config->header[sos], config->header_size - sos);
+    }
+    return stat;
+}
+
+static hpm_stat_t hpm_jpeg_stream_hw_enc_strip(hpm_jpeg_stream_enc_t *enc, const uint8_t *pixels, uint32_t rows, bool last)
+{
+    const hpm_jpeg_stream_enc_config_t *config = &enc->config;
+    JPEG_Type *ptr = (JPEG_Type *)config->base;
+    jpeg_job_config_t job = { 0 };
+    uint8_t *out = config->out_buf;
+    uint32_t len;
+    hpm_stat_t stat;
+
+    if (config->pixel_format == display_pixel_format_y8) {
+        job.jpeg_format = JPEG_SUPPORTED_FORMAT_400;
+        job.in_pixel_format = jpeg_pixel_format_y8;
+        job.out_pixel_format = jpeg_pixel_format_y8;
+        job.enable_ycbcr = false;
+    } else {
+        job.jpeg_format = JPEG_SUPPORTED_FORMAT_420;
+        job.in_pixel_format = jpeg_pixel_format_rgb565;
+        job.out_pixel_format = jpeg_pixel_format_yuv422h1p;
+        job.enable_ycbcr = true;
+    }
+    job.width_in_pixel = config->width;
+    job.height_in_pixel = rows;
+    job.in_buffer = core_local_mem_to_sys_address(config->running_core, (uint32_t)pixels);
+    job.out_buffer = core_local_mem_to_sys_address(config->running_core, (uint32_t)out);
+
+    if (l1c_dc_is_enabled()) {
+        hpm_jpeg_stream_hw_writeback(pixels, config->width * rows * display_get_pixel_size_in_byte(config->pixel_format));
+        /* drop dirty lines before the codec writes behind the cache */
+        hpm_jpeg_stream_hw_writeback(out, config->out_size);
+    }
+
+    stat = jpeg_start_encode(ptr, &job);
+    if (stat != status_success) {
+        return status_jpeg_stream_unsupported;
+    }
+    stat = hpm_jpeg_stream_hw_wait(ptr);
+    if (stat != status_success) {
+        return stat;
+    }
+
+    len = jpeg_get_encoded_length(ptr);
+    if (len > config->out_size) {
+        return status_jpeg_stream_overflow;
+    }
+    if (l1c_dc_is_enabled()) {
+        hpm_jpeg_stream_hw_invalidate(out, len);
+    }
+
+    /* each job ends with EOI, strips are joined with RSTn instead */
+    if ((len >= 2) && (out[len - 2] == 0xFF) && (out[len - 1] == HPM_JPEG_MARKER_EOI)) {
+        len -= 2;
+    }
+    if ((len + 2) > config->out_size) {
+        return status_jpeg_stream_overflow;
+    }
+    out[len] = 0xFF;
+    out[len + 1] = last ? HPM_JPEG_MARKER_EOI : (HPM_JPEG_MARKER_RST0 + (enc->restart_index & 7));
+    enc->restart_index++;
+    enc->stat.strips++;
+
+    return hpm_jpeg_stream_enc_emit(enc, out, len + 2);
+}
+
+/* read from the source until fill bytes are buffered */
+static hpm_stat_t hpm_jpeg_stream_hw_read(const hpm_jpeg_stream_dec_config_t *config, hpm_jpeg_stream_dec_info_t *info,
+                                          uint32_t *fill, uint32_t need)
+{
+    uint32_t n;
+
+    if (need > config->in_size) {
+        return status_jpeg_stream_overflow;
+    }
+    while (*fill < need) {
+        n = config->source(config->context, config->in_buf + *fill, config->in_size - *fill);
+        if (n == 0) {
+            return status_jpeg_stream_bad_stream;
+        }
+        *fill += n;
+        info->bytes += n;
+    }
+    return status_success;
+}
+
+static hpm_stat_t hpm_jpeg_stream_hw_decode(const hpm_jpeg_stream_dec_config_t *config, hpm_jpeg_stream_dec_info_t *info)
+{
+    JPEG_Type *ptr = (JPEG_Type *)config->base;
+    uint8_t *buf = config->in_buf;
+    jpeg_job_config_t job = { 0 };
+    uint32_t fill = 0;
+    uint32_t pos = 2;
+    uint32_t scan;
+    uint32_t len;
+    uint32_t interval = 0;
+    uint32_t components = 0;
+    uint8_t sampling = 0;
+    uint8_t marker;
+    uint32_t mcu;
+    uint32_t pitch;
+    uint32_t rows;
+    uint32_t y;
+    bool eoi;
+    hpm_stat_t stat;
+
+    if ((ptr == NULL) || (config->tables == NULL)) {
+        return status_invalid_argument;
+    }
+
+    /* header, segment by segment up to and including SOS */
+    stat = hpm_jpeg_stream_hw_read(config, info, &fill, 2);
+    if (stat != status_success) {
+        return stat;
+    }
+    if ((buf[0] != 0xFF) || (buf[1] != HPM_JPEG_MARKER_SOI)) {
+        return status_jpeg_stream_bad_stream;
+    }
+    while (1) {
+        stat = hpm_jpeg_stream_hw_read(config, info, &fill, pos + 4);
+        if (stat != status_success) {
+            return stat;
+        }
+        if (buf[pos] != 0xFF) {
+            return status_jpeg_stream_bad_stream;
+        }
+        if (buf[pos + 1] == 0xFF) {
+            pos++;
+            continue;
+        }
+        marker = buf[pos + 1];
+        len = HPM_JPEG_SEGMENT_LENGTH(&buf[pos]);
+        stat = hpm_jpeg_stream_hw_read(config, info, &fill, pos + 2 + len);
+        if (stat != status_success) {
+            return stat;
+        }
+        if (marker == HPM_JPEG_MARKER_SOF0) {
+            info->height = ((uint32_t)buf[pos + 5] << 8) | buf[pos + 6];
+            info->width = ((uint32_t)buf[pos + 7] << 8) | buf[pos + 8];
+            components = buf[pos + 9];
+            sampling = buf[pos + 11];
+        } else if ((marker >= 0xC1) && (marker <= 0xCF) && (marker != 0xC4) && (marker != 0xC8) && (marker != 0xCC)) {
+            /* progressive, extended, lossless or arithmetic coding */
+            return status_jpeg_stream_unsupported;
+        } else if (marker == HPM_JPEG_MARKER_DRI) {
+            interval = ((uint32_t)buf[pos + 4] << 8) | buf[pos + 5];
+        }
+        pos += 2 + len;
+        if (marker == HPM_JPEG_MARKER_SOS) {
+            break;
+        }
+    }
+
+    if (components == 1) {
+        job.jpeg_format = JPEG_SUPPORTED_FORMAT_400;
+        job.in_pixel_format = jpeg_pixel_format_y8;
+        job.out_pixel_format = jpeg_pixel_format_y8;
+        job.enable_ycbcr = false;
+        if (config->pixel_format != display_pixel_format_y8) {
+            return status_jpeg_stream_unsupported;
+        }
+    } else if ((components == 3) && (sampling == 0x22)) {
+        job.jpeg_format = JPEG_SUPPORTED_FORMAT_420;
+        job.in_pixel_format = jpeg_pixel_format_yuv422h1p;
+        job.out_pixel_format = jpeg_pixel_format_rgb565;
+        job.enable_ycbcr = true;
+        job.out_byte_order = JPEG_BYTE_ORDER_2301;
+        if (config->pixel_format != display_pixel_format_rgb565) {
+            return status_jpeg_stream_unsupported;
+        }
+    } else {
+        return status_jpeg_stream_unsupported;
+    }
+
+    /* every restart interval has to be whole MCU rows to be decoded as a strip */
+    mcu = HPM_JPEG_STREAM_MCU_SIZE(config->pixel_format);
+    if ((info->width == 0) || (info->height == 0) || (info->width % mcu) || (info->height % mcu)
+        || (interval == 0) || (interval % (info->width / mcu))) {
+        return status_jpeg_stream_unsupported;
+    }
+    info->strip_rows = (interval / (info->width / mcu)) * mcu;
+    pitch = info->width * display_get_pixel_size_in_byte(config->pixel_format);
+    if ((pitch * info->strip_rows) > config->strip_size) {
+        return status_jpeg_stream_overflow;
+    }
+
+    hpm_jpeg_stream_hw_init(ptr, config->tables);
+
+    fill -= pos;
+    memmove(buf, buf + pos, fill);
+    scan = 0;
+    y = 0;
+    while (y < info->height) {
+        /* look for the RSTn or EOI ending the interval, FF00 is a stuffed byte and FFFF fill */
+        while (1) {
+            while ((scan + 1) < fill) {
+                if ((buf[scan] == 0xFF) && (buf[scan + 1] != 0xFF)) {
+                    if (((buf[scan + 1] >= HPM_JPEG_MARKER_RST0) && (buf[scan + 1] <= HPM_JPEG_MARKER_RST7))
+                        || (buf[scan + 1] == HPM_JPEG_MARKER_EOI)) {
+                        break;
+                    }
+                    scan++;
+                }
+                scan++;
+            }
+            if ((scan + 1) < fill) {
+                break;
+            }
+            if (fill == config->in_size) {
+                return status_jpeg_stream_overflow;
+            }
+            stat = hpm_jpeg_stream_hw_read(config, info, &fill, fill + 1);
+            if (stat != status_success) {
+                return stat;
+            }
+        }
+
+        /* the interval is decoded as an image of its own */
+        eoi = (buf[scan + 1] == HPM_JPEG_MARKER_EOI);
+        buf[scan + 1] = HPM_JPEG_MARKER_EOI;
+        rows = MIN(info->strip_rows, info->height - y);
+
+        job.width_in_pixel = info->width;
+        job.height_in_pixel = rows;
+        job.in_buffer = core_local_mem_to_sys_address(config->running_core, (uint32_t)buf);
+        job.out_buffer = core_local_mem_to_sys_address(config->running_core, (uint32_t)config->strip_buf);
+        if (l1c_dc_is_enabled()) {
+            hpm_jpeg_stream_hw_writeback(buf, scan + 2);
+            hpm_jpeg_stream_hw_writeback(config->strip_buf, pitch * rows);
+        }
+        if (jpeg_start_decode(ptr, &job, scan + 2) != status_success) {
+            return status_jpeg_stream_unsupported;
+        }
+        stat = hpm_jpeg_stream_hw_wait(ptr);
+        if (stat != status_success) {
+            return stat;
+        }
+        if (l1c_dc_is_enabled()) {
+            hpm_jpeg_stream_hw_invalidate(config->strip_buf, pitch * rows);
+        }
+
+        if (!config->strip(config->context, config->strip_buf, y, rows)) {
+            return status_jpeg_stream_aborted;
+        }
+        info->strips++;
+        y += rows;
+        if (eoi && (y < info->height)) {
+            return status_jpeg_stream_bad_stream;
+        }
+
+        fill -= scan + 2;
+        memmove(buf, buf + scan + 2, fill);
+        scan = 0;
+    }
+
+    return status_success;
+}
+#endif
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_JPEG_STREAM_H
+#define HPM_JPEG_STREAM_H
+
+#include "hpm_common.h"
+#include "hpm_soc_feature.h"
+#include "hpm_display_common.h"
+
+/**
+ * @brief Strip based JPEG streaming
+ *
+ * Encodes images handed over in bands of rows and decodes images into bands
+ * of rows, the bitstream is passed through a small chunk buffer on both
+ * sides. Neither a complete raw frame nor a complete bitstream is ever held
+ * by the component.
+ *
+ * Hardware backend (JPEG codec):
+ *  - every strip is one restart interval. The encoder codes each strip as a
+ *    separate job and joins the strips with RSTn markers, the DRI segment is
+ *    added to the header. The strip height is a multiple of the MCU height
+ *    (16 rows for color, 8 rows for grayscale), the image height as well.
+ *  - the codec uses the Huffman and quantization tables passed in
+ *    hpm_jpeg_stream_hw_tables_t, the encoder header template has to match
+ *    them. The decoder only handles streams whose restart interval is a
+ *    whole number of MCU rows, e.g. streams written by the encoder, other
+ *    streams return status_jpeg_stream_unsupported.
+ *  - buffers accessed by the codec have to be placed in noncacheable memory
+ *    or be aligned to and sized in multiples of the cache line size.
+ *
+ * Software backend (libjpeg, CONFIG_LIBJPEG): same interface, any baseline
+ * stream and strip height, the output is written through the chunk buffer
+ * as libjpeg produces it.
+ *
+ * Supported pixel formats are display_pixel_format_rgb565 (4:2:0 color
+ * JPEG) and display_pixel_format_y8 (grayscale JPEG).
+ */
+
+/* Set to 0 to build without the JPEG codec backend */
+#ifndef HPM_JPEG_STREAM_USE_HW
+#if defined(HPMSOC_HAS_HPMSDK_JPEG)
+#define HPM_JPEG_STREAM_USE_HW (1)
+#else
+#define HPM_JPEG_STREAM_USE_HW (0)
+#endif
+#endif
+
+/* Set to 1 when libjpeg is linked, done by the build for CONFIG_LIBJPEG */
+#ifndef HPM_JPEG_STREAM_USE_SW
+#define HPM_JPEG_STREAM_USE_SW (0)
+#endif
+
+/* MCU size of the hardware backend for a pixel format */
+#define HPM_JPEG_STREAM_MCU_SIZE(format) (((format) == display_pixel_format_y8) ? 8U : 16U)
+
+/* Bitstream chunk buffer size the hardware encoder needs for a strip */
+#define HPM_JPEG_STREAM_HW_ENC_OUT_SIZE(width, strip_rows, format) \
+    (((format) == display_pixel_format_y8) ? ((width) * (strip_rows)) : ((width) * (strip_rows) * 3U / 2U))
+
+enum {
+    status_jpeg_stream_unsupported = MAKE_STATUS(status_group_jpeg_stream, 0),   /**< Image or stream not supported by the backend */
+    status_jpeg_stream_overflow = MAKE_STATUS(status_group_jpeg_stream, 1),      /**< Data does not fit a buffer */
+    status_jpeg_stream_codec_error = MAKE_STATUS(status_group_jpeg_stream, 2),   /**< Codec reported an error */
+    status_jpeg_stream_bad_stream = MAKE_STATUS(status_group_jpeg_stream, 3),    /**< Malformed bitstream */
+    status_jpeg_stream_aborted = MAKE_STATUS(status_group_jpeg_stream, 4),       /**< Sink or strip callback returned false */
+};
+
+/**
+ * @brief Backend
+ */
+typedef enum {
+    hpm_jpeg_stream_backend_hw = 0,
+    hpm_jpeg_stream_backend_sw,
+} hpm_jpeg_stream_backend_t;
+
+/**
+ * @brief Bitstream sink, returns false to abort
+ */
+typedef bool (*hpm_jpeg_stream_sink_t)(void *context, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Bitstream source, fills buf with up to size bytes, returns the byte count, 0 at the end
+ */
+typedef uint32_t (*hpm_jpeg_stream_source_t)(void *context, uint8_t *buf, uint32_t size);
+
+/**
+ * @brief Decoded strip of rows [y, y + rows), returns false to abort
+ */
+typedef bool (*hpm_jpeg_stream_strip_t)(void *context, const uint8_t *pixels, uint32_t y, uint32_t rows);
+
+/**
+ * @brief Tables of the hardware backend, the layouts jpeg_fill_table() takes
+ */
+typedef struct {
+    const uint32_t *huffmin;        /**< 16 words */
+    const uint16_t *huffbase;       /**< 64 entries */
+    const uint8_t *huffsymb;        /**< 336 entries */
+    const uint16_t *huffenc;        /**< 384 entries */
+    const uint16_t *qtable;         /**< 256 entries, encoder or decoder table */
+} hpm_jpeg_stream_hw_tables_t;
+
+/**
+ * @brief Encoder configuration
+ */
+typedef struct {
+    hpm_jpeg_stream_backend_t backend;
+    display_pixel_format_t pixel_format;        /**< input pixel format */
+    uint16_t width;                             /**< image width */
+    uint16_t height;                            /**< image height */
+    uint16_t strip_rows;                        /**< rows per strip, a multiple of the MCU size for the hardware backend */
+    uint8_t quality;                            /**< software backend quality, 1 - 100 */
+    uint8_t running_core;                       /**< core the buffers are local to */
+    uint8_t *out_buf;                           /**< bitstream chunk buffer */
+    uint32_t out_size;                          /**< see HPM_JPEG_STREAM_HW_ENC_OUT_SIZE for the hardware backend */
+    hpm_jpeg_stream_sink_t sink;                /**< bitstream sink */
+    void *context;                              /**< sink context */
+    void *base;                                 /**< JPEG base address, hardware backend */
+    const hpm_jpeg_stream_hw_tables_t *tables;  /**< hardware backend tables */
+    const uint8_t *header;                      /**< hardware backend header template, SOI up to and including SOS */
+    uint32_t header_size;                       /**< header template size */
+} hpm_jpeg_stream_enc_config_t;
+
+/**
+ * @brief Encoder statistics
+ */
+typedef struct {
+    uint32_t rows;                  /**< rows encoded */
+    uint32_t strips;                /**< strips coded by the hardware */
+    uint32_t bytes;                 /**< bitstream bytes passed to the sink */
+    uint32_t max_chunk;             /**< largest chunk passed to the sink */
+} hpm_jpeg_stream_enc_stat_t;
+
+/**
+ * @brief Encoder
+ */
+typedef struct {
+    hpm_jpeg_stream_enc_config_t config;
+    hpm_jpeg_stream_enc_stat_t stat;
+    uint32_t restart_index;
+    void *sw;                       /**< software backend state */
+    bool started;
+} hpm_jpeg_stream_enc_t;
+
+/**
+ * @brief Decoder configuration
+ */
+typedef struct {
+    hpm_jpeg_stream_backend_t backend;
+    display_pixel_format_t pixel_format;        /**< output pixel format */
+    uint16_t strip_rows;                        /**< rows per strip, software backend, the hardware uses the restart interval */
+    uint8_t running_core;                       /**< core the buffers are local to */
+    uint8_t *in_buf;                            /**< bitstream chunk buffer, holds a restart interval for the hardware backend */
+    uint32_t in_size;                           /**< bitstream chunk buffer size */
+    uint8_t *strip_buf;                         /**< strip buffer */
+    uint32_t strip_size;                        /**< strip buffer size */
+    hpm_jpeg_stream_source_t source;            /**< bitstream source */
+    hpm_jpeg_stream_strip_t strip;              /**< strip callback */
+    void *context;                              /**< source and strip context */
+    void *base;                                 /**< JPEG base address, hardware backend */
+    const hpm_jpeg_stream_hw_tables_t *tables;  /**< hardware backend tables */
+} hpm_jpeg_stream_dec_config_t;
+
+/**
+ * @brief Decoded image information
+ */
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t strip_rows;            /**< rows per strip */
+    uint32_t strips;                /**< strips passed to the strip callback */
+    uint32_t bytes;                 /**< bitstream bytes read from the source */
+} hpm_jpeg_stream_dec_info_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get default encoder configuration, hardware backend, RGB565, 16 row strips
+ *
+ * @param [out] config encoder configuration
+ */
+void hpm_jpeg_stream_get_default_enc_config(hpm_jpeg_stream_enc_config_t *config);
+
+/**
+ * @brief Start encoding an image, the header is passed to the sink
+ *
+ * @param [out] enc encoder
+ * @param [in] config encoder configuration
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the configuration is invalid
+ * @retval status_jpeg_stream_unsupported if the backend can not encode the image
+ * @retval status_jpeg_stream_aborted if the sink returned false
+ */
+hpm_stat_t hpm_jpeg_stream_enc_start(hpm_jpeg_stream_enc_t *enc, const hpm_jpeg_stream_enc_config_t *config);
+
+/**
+ * @brief Encode rows
+ *
+ * The hardware backend takes whole strips, only the last write of an image
+ * may be shorter.
+ *
+ * @param [in] enc encoder
+ * @param [in] pixels rows, packed, width * pixel size bytes per row
+ * @param [in] rows number of rows
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the row count is invalid
+ * @retval status_jpeg_stream_overflow if a coded strip does not fit the chunk buffer
+ * @retval status_jpeg_stream_codec_error if the codec failed
+ * @retval status_jpeg_stream_aborted if the sink returned false
+ */
+hpm_stat_t hpm_jpeg_stream_enc_write(hpm_jpeg_stream_enc_t *enc, const uint8_t *pixels, uint32_t rows);
+
+/**
+ * @brief Finish the image, the rest of the bitstream is passed to the sink
+ *
+ * @param [in] enc encoder
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if not all rows were written
+ * @retval status_jpeg_stream_aborted if the sink returned false
+ */
+hpm_stat_t hpm_jpeg_stream_enc_finish(hpm_jpeg_stream_enc_t *enc);
+
+/**
+ * @brief Drop the image being encoded and release the backend state
+ *
+ * @param [in] enc encoder
+ */
+void hpm_jpeg_stream_enc_abort(hpm_jpeg_stream_enc_t *enc);
+
+/**
+ * @brief Get default decoder configuration, hardware backend, RGB565
+ *
+ * @param [out] config decoder configuration
+ */
+void hpm_jpeg_stream_get_default_dec_config(hpm_jpeg_stream_dec_config_t *config);
+
+/**
+ * @brief Decode an image
+ *
+ * Pulls the bitstream from the source and passes the image to the strip
+ * callback strip by strip, top to bottom.
+ *
+ * @param [in] config decoder configuration
+ * @param [out] info image information, may be NULL
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the configuration is invalid
+ * @retval status_jpeg_stream_unsupported if the backend can not decode the stream
+ * @retval status_jpeg_stream_overflow if a restart interval or a strip does not fit its buffer
+ * @retval status_jpeg_stream_bad_stream if the stream is malformed
+ * @retval status_jpeg_stream_codec_error if the codec failed
+ * @retval status_jpeg_stream_aborted if the strip callback returned false
+ */
+hpm_stat_t hpm_jpeg_stream_decode(const hpm_jpeg_stream_dec_config_t *config, hpm_jpeg_stream_dec_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_JPEG_STREAM_H */
@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "hpm_jpeg_stream.h"
+#include "hpm_jpeg_stream_sw.h"
+#include "jpeglib.h"
+#include "jerror.h"
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+    bool aborted;                   /* error raised by a callback returning false */
+} hpm_jpeg_stream_sw_error_t;
+
+typedef struct {
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_destination_mgr dest;
+    hpm_jpeg_stream_sw_error_t err;
+    hpm_jpeg_stream_enc_t *enc;
+    JSAMPROW row;                   /* RGB888 row for RGB565 input */
+} hpm_jpeg_stream_sw_enc_t;
+
+typedef struct {
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_source_mgr src;
+    hpm_jpeg_stream_sw_error_t err;
+    const hpm_jpeg_stream_dec_config_t *config;
+    hpm_jpeg_stream_dec_info_t *info;
+    JSAMPROW row;                   /* RGB888 row for RGB565 output */
+} hpm_jpeg_stream_sw_dec_t;
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+static void hpm_jpeg_stream_sw_error_exit(j_common_ptr cinfo)
+{
+    hpm_jpeg_stream_sw_error_t *err = (hpm_jpeg_stream_sw_error_t *)cinfo->err;
+
+    longjmp(err->jmp, 1);
+}
+
+static void hpm_jpeg_stream_sw_output_message(j_common_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+static void hpm_jpeg_stream_sw_error_init(hpm_jpeg_stream_sw_error_t *err)
+{
+    jpeg_std_error(&err->pub);
+    err->pub.error_exit = hpm_jpeg_stream_sw_error_exit;
+    err->pub.output_message = hpm_jpeg_stream_sw_output_message;
+    err->aborted = false;
+}
+
+static hpm_stat_t hpm_jpeg_stream_sw_error_status(hpm_jpeg_stream_sw_error_t *err)
+{
+    return err->aborted ? status_jpeg_stream_aborted : status_jpeg_stream_codec_error;
+}
+
+static void hpm_jpeg_stream_sw_abort_callback(j_common_ptr cinfo)
+{
+    hpm_jpeg_stream_sw_error_t *err = (hpm_jpeg_stream_sw_error_t *)cinfo->err;
+
+    err->aborted = true;
+    longjmp(err->jmp, 1);
+}
+
+/*
+ * Destination manager, the chunk buffer is handed to the sink whenever libjpeg fills it
+ */
+static void hpm_jpeg_stream_sw_init_destination(j_compress_ptr cinfo)
+{
+    hpm_jpeg_stream_sw_enc_t *sw = (hpm_jpeg_stream_sw_enc_t *)cinfo;
+
+    sw->dest.next_output_byte = sw->enc->config.out_buf;
+    sw->dest.free_in_buffer = sw->enc->config.out_size;
+}
+
+static boolean hpm_jpeg_stream_sw_empty_output_buffer(j_compress_ptr cinfo)
+{
+    hpm_jpeg_stream_sw_enc_t *sw = (hpm_jpeg_stream_sw_enc_t *)cinfo;
+
+    if (hpm_jpeg_stream_enc_emit(sw->enc, sw->enc->config.out_buf, sw->enc->config.out_size) != status_success) {
+        hpm_jpeg_stream_sw_abort_callback((j_common_ptr)cinfo);
+    }
+    hpm_jpeg_stream_sw_init_destination(cinfo);
+    return TRUE;
+}
+
+static void hpm_jpeg_stream_sw_term_destination(j_compress_ptr cinfo)
+{
+    hpm_jpeg_stream_sw_enc_t *sw = (hpm_jpeg_stream_sw_enc_t *)cinfo;
+
+    if (hpm_jpeg_stream_enc_emit(sw->enc, sw->enc->config.out_buf,
+                                 sw->enc->config.out_size - sw->dest.free_in_buffer) != status_success) {
+        hpm_jpeg_stream_sw_abort_callback((j_common_ptr)cinfo);
+    }
+}
+
+hpm_stat_t hpm_jpeg_stream_sw_enc_start(hpm_jpeg_stream_enc_t *enc)
+{
+    hpm_jpeg_stream_sw_enc_t *sw;
+    const hpm_jpeg_stream_enc_config_t *config = &enc->config;
+    hpm_stat_t stat;
+
+    sw = (hpm_jpeg_stream_sw_enc_t *)malloc(sizeof(hpm_jpeg_stream_sw_enc_t));
+    if (sw == NULL) {
+        return status_jpeg_stream_overflow;
+    }
+    memset(sw, 0, sizeof(*sw));
+    sw->enc = enc;
+    enc->sw = sw;
+
+    hpm_jpeg_stream_sw_error_init(&sw->err);
+    sw->cinfo.err = &sw->err.pub;
+    if (setjmp(sw->err.jmp)) {
+        stat = hpm_jpeg_stream_sw_error_status(&sw->err);
+        hpm_jpeg_stream_sw_enc_abort(enc);
+        return stat;
+    }
+
+    jpeg_create_compress(&sw->cinfo);
+    sw->dest.init_destination = hpm_jpeg_stream_sw_init_destination;
+    sw->dest.empty_output_buffer = hpm_jpeg_stream_sw_empty_output_buffer;
+    sw->dest.term_destination = hpm_jpeg_stream_sw_term_destination;
+    sw->cinfo.dest = &sw->dest;
+
+    sw->cinfo.image_width = config->width;
+    sw->cinfo.image_height = config->height;
+    if (config->pixel_format == display_pixel_format_y8) {
+        sw->cinfo.input_components = 1;
+        sw->cinfo.in_color_space = JCS_GRAYSCALE;
+    } else {
+        sw->cinfo.input_components = 3;
+        sw->cinfo.in_color_space = JCS_RGB;
+    }
+    jpeg_set_defaults(&sw->cinfo);
+    jpeg_set_quality(&sw->cinfo, (config->quality != 0) ? config->quality : 80, TRUE);
+    jpeg_start_compress(&sw->cinfo, TRUE);
+
+    if (config->pixel_format != display_pixel_format_y8) {
+        sw->row = (*sw->cinfo.mem->alloc_sarray)((j_common_ptr)&sw->cinfo, JPOOL_IMAGE, config->width * 3, 1)[0];
+    }
+    return status_success;
+}
+
+hpm_stat_t hpm_jpeg_stream_sw_enc_write(hpm_jpeg_stream_enc_t *enc, const uint8_t *pixels, uint32_t rows)
+{
+    hpm_jpeg_stream_sw_enc_t *sw = (hpm_jpeg_stream_sw_enc_t *)enc->sw;
+    uint32_t width = enc->config.width;
+    uint32_t pitch = width * display_get_pixel_size_in_byte(enc->config.pixel_format);
+    const uint16_t *src;
+    JSAMPROW row;
+    uint16_t c;
+
+    if (setjmp(sw->err.jmp)) {
+        return hpm_jpeg_stream_sw_error_status(&sw->err);
+    }
+
+    for (uint32_t y = 0; y < rows; y++) {
+        if (sw->row == NULL) {
+            row = (JSAMPROW)(pixels + y * pitch);
+        } else {
+            row = sw->row;
+            src = (const uint16_t *)(pixels + y * pitch);
+            for (uint32_t x = 0; x < width; x++) {
+                c = src[x];
+                row[3 * x] = ((c >> 8) & 0xF8) | (c >> 13);
+                row[3 * x + 1] = ((c >> 3) & 0xFC) | ((c >> 9) & 0x03);
+                row[3 * x + 2] = ((c << 3) & 0xF8) | ((c >> 2) & 0x07);
+            }
+        }
+        jpeg_write_scanlines(&sw->cinfo, &row, 1);
+    }
+    return status_success;
+}
+
+hpm_stat_t hpm_jpeg_stream_sw_enc_finish(hpm_jpeg_stream_enc_t *enc)
+{
+    hpm_jpeg_stream_sw_enc_t *sw = (hpm_jpeg_stream_sw_enc_t *)enc->sw;
+    hpm_stat_t stat = status_success;
+
+    if (setjmp(sw->err.jmp)) {
+        stat = hpm_jpeg_stream_sw_error_status(&sw->err);
+    } else {
+        jpeg_finish_compress(&sw->cinfo);
+    }
+    hpm_jpeg_stream_sw_enc_abort(enc);
+    return stat;
+}
+
+void hpm_jpeg_stream_sw_enc_abort(hpm_jpeg_stream_enc_t *enc)
+{
+    hpm_jpeg_stream_sw_enc_t *sw = (hpm_jpeg_stream_sw_enc_t *)enc->sw;
+
+    jpeg_destroy_compress(&sw->cinfo);
+    free(sw);
+    enc->sw = NULL;
+}
+
+/*
+ * Source manager, refills the chunk buffer from the source, a missing end of the stream reads as EOI
+ */
+static void hpm_jpeg_stream_sw_init_source(j_decompress_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+static boolean hpm_jpeg_stream_sw_fill_input_buffer(j_decompress_ptr cinfo)
+{
+    hpm_jpeg_stream_sw_dec_t *sw = (hpm_jpeg_stream_sw_dec_t *)cinfo;
+    const hpm_jpeg_stream_dec_config_t *config = sw->config;
+    uint32_t n;
+
+    n = config->source(config->context, config->in_buf, config->in_size);
+    if (n == 0) {
+        WARNMS(cinfo, JWRN_JPEG_EOF);
+        config->in_buf[0] = 0xFF;
+        config->in_buf[1] = JPEG_EOI;
+        n = 2;
+    } else {
+        sw->info->bytes += n;
+    }
+    sw->src.next_input_byte = config->in_buf;
+    sw->src.bytes_in_buffer = n;
+    return TRUE;
+}
+
+static void hpm_jpeg_stream_sw_skip_input_data(j_decompress_ptr cinfo, long num_bytes)
+{
+    hpm_jpeg_stream_sw_dec_t *sw = (hpm_jpeg_stream_sw_dec_t *)cinfo;
+
+    if (num_bytes <= 0) {
+        return;
+    }
+    while (num_bytes > (long)sw->src.bytes_in_buffer) {
+        num_bytes -= (long)sw->src.bytes_in_buffer;
+        hpm_jpeg_stream_sw_fill_input_buffer(cinfo);
+    }
+    sw->src.next_input_byte += num_bytes;
+    sw->src.bytes_in_buffer -= num_bytes;
+}
+
+static void hpm_jpeg_stream_sw_term_source(j_decompress_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+hpm_stat_t hpm_jpeg_stream_sw_decode(const hpm_jpeg_stream_dec_config_t *config, hpm_jpeg_stream_dec_info_t *info)
+{
+    hpm_jpeg_stream_sw_dec_t *sw;
+    volatile hpm_stat_t stat = status_success;
+    uint32_t strip_rows = (config->strip_rows != 0) ? config->strip_rows : 16;
+    uint32_t pitch;
+    uint32_t y = 0;
+    uint32_t rows = 0;
+    uint8_t *dst;
+    uint16_t *out;
+    JSAMPROW row;
+
+    sw = (hpm_jpeg_stream_sw_dec_t *)malloc(sizeof(hpm_jpeg_stream_sw_dec_t));
+    if (sw == NULL) {
+        return status_jpeg_stream_overflow;
+    }
+    memset(sw, 0, sizeof(*sw));
+    sw->config = config;
+    sw->info = info;
+
+    hpm_jpeg_stream_sw_error_init(&sw->err);
+    sw->cinfo.err = &sw->err.pub;
+    if (setjmp(sw->err.jmp)) {
+        if (stat == status_success) {
+            stat = hpm_jpeg_stream_sw_error_status(&sw->err);
+        }
+        jpeg_destroy_decompress(&sw->cinfo);
+        free(sw);
+        return stat;
+    }
+
+    jpeg_create_decompress(&sw->cinfo);
+    sw->src.init_source = hpm_jpeg_stream_sw_init_source;
+    sw->src.fill_input_buffer = hpm_jpeg_stream_sw_fill_input_buffer;
+    sw->src.skip_input_data = hpm_jpeg_stream_sw_skip_input_data;
+    sw->src.resync_to_restart = jpeg_resync_to_restart;
+    sw->src.term_source = hpm_jpeg_stream_sw_term_source;
+    sw->cinfo.src = &sw->src;
+
+    if (jpeg_read_header(&sw->cinfo, TRUE) != JPEG_HEADER_OK) {
+        stat = status_jpeg_stream_bad_stream;
+        hpm_jpeg_stream_sw_abort_callback((j_common_ptr)&sw->cinfo);
+    }
+    sw->cinfo.out_color_space = (config->pixel_format == display_pixel_format_y8) ? JCS_GRAYSCALE : JCS_RGB;
+    jpeg_start_decompress(&sw->cinfo);
+
+    info->width = sw->cinfo.output_width;
+    info->height = sw->cinfo.output_height;
+    info->strip_rows = strip_rows;
+    pitch = info->width * display_get_pixel_size_in_byte(config->pixel_format);
+    if ((pitch * strip_rows) > config->strip_size) {
+        stat = status_jpeg_stream_overflow;
+        hpm_jpeg_stream_sw_abort_callback((j_common_ptr)&sw->cinfo);
+    }
+    if (config->pixel_format != display_pixel_format_y8) {
+        sw->row = (*sw->cinfo.mem->alloc_sarray)((j_common_ptr)&sw->cinfo, JPOOL_IMAGE, info->width * 3, 1)[0];
+    }
+
+    while (sw->cinfo.output_scanline < sw->cinfo.output_height) {
+        dst = config->strip_buf + rows * pitch;
+        row = (sw->row != NULL) ? sw->row : (JSAMPROW)dst;
+        jpeg_read_scanlines(&sw->cinfo, &row, 1);
+        if (sw->row != NULL) {
+            out = (uint16_t *)dst;
+            for (uint32_t x = 0; x < info->width; x++) {
+                out[x] = ((row[3 * x] & 0xF8) << 8) | ((row[3 * x + 1] & 0xFC) << 3) | (row[3 * x + 2] >> 3);
+            }
+        }
+        rows++;
+        if ((rows == strip_rows) || (sw->cinfo.output_scanline == sw->cinfo.output_height)) {
+            if (!config->strip(config->context, config->strip_buf, y, rows)) {
+                stat = status_jpeg_stream_aborted;
+                hpm_jpeg_stream_sw_abort_callback((j_common_ptr)&sw->cinfo);
+            }
+            info->strips++;
+            y += rows;
+            rows = 0;
+        }
+    }
+
+    jpeg_finish_decompress(&sw->cinfo);
+    jpeg_destroy_decompress(&sw->cinfo);
+    free(sw);
+    return status_success;
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_JPEG_STREAM_SW_H
+#define HPM_JPEG_STREAM_SW_H
+
+#include "hpm_jpeg_stream.h"
+
+/* Backend interface, used by hpm_jpeg_stream.c only */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+hpm_stat_t hpm_jpeg_stream_enc_emit(hpm_jpeg_stream_enc_t *enc, const uint8_t *data, uint32_t len);
+
+#if HPM_JPEG_STREAM_USE_SW
+hpm_stat_t hpm_jpeg_stream_sw_enc_start(hpm_jpeg_stream_enc_t *enc);
+hpm_stat_t hpm_jpeg_stream_sw_enc_write(hpm_jpeg_stream_enc_t *enc, const uint8_t *pixels, uint32_t rows);
+hpm_stat_t hpm_jpeg_stream_sw_enc_finish(hpm_jpeg_stream_enc_t *enc);
+void hpm_jpeg_stream_sw_enc_abort(hpm_jpeg_stream_enc_t *enc);
+hpm_stat_t hpm_jpeg_stream_sw_decode(const hpm_jpeg_stream_dec_config_t *config, hpm_jpeg_stream_dec_info_t *info);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_JPEG_STREAM_SW_H */
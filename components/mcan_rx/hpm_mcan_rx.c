@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_mcan_rx.h"
+
+hpm_stat_t hpm_mcan_rx_queue_init(hpm_mcan_rx_queue_t *queue, mcan_rx_message_t *buf, uint32_t size)
+{
+    if ((queue == NULL) || (buf == NULL) || (size == 0) || ((size & (size - 1U)) != 0)) {
+        return status_invalid_argument;
+    }
+    queue->buf = buf;
+    queue->size = size;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+    return status_success;
+}
+
+mcan_rx_message_t *hpm_mcan_rx_queue_peek(hpm_mcan_rx_queue_t *queue)
+{
+    uint32_t tail = queue->tail;
+
+    if (queue->head == tail) {
+        return NULL;
+    }
+    /* the entry is read after the head that published it */
+    HPM_MCAN_RX_BARRIER();
+    return &queue->buf[tail & (queue->size - 1U)];
+}
+
+void hpm_mcan_rx_queue_pop(hpm_mcan_rx_queue_t *queue)
+{
+    if (queue->head == queue->tail) {
+        return;
+    }
+    /* the entry is done with before the producer may reuse it */
+    HPM_MCAN_RX_BARRIER();
+    queue->tail = queue->tail + 1U;
+}
+
+static void hpm_mcan_rx_queue_push(hpm_mcan_rx_queue_t *queue, const mcan_rx_message_t *frame)
+{
+    uint32_t head = queue->head;
+    const uint32_t *src = (const uint32_t *)frame;
+    uint32_t *dst;
+    uint32_t words;
+
+    if (head - queue->tail >= queue->size) {
+        queue->dropped++;
+        return;
+    }
+    /* header and the data words the DLC covers, not the whole 64-byte buffer */
+    dst = (uint32_t *)&queue->buf[head & (queue->size - 1U)];
+    dst[0] = src[0];
+    dst[1] = src[1];
+    words = (mcan_get_message_size_from_dlc(frame->dlc) + 3U) / 4U;
+    for (uint32_t i = 0; i < words; i++) {
+        dst[2U + i] = src[2U + i];
+    }
+    HPM_MCAN_RX_BARRIER();
+    queue->head = head + 1U;
+}
+
+hpm_stat_t hpm_mcan_rx_dispatcher_init(hpm_mcan_rx_dispatcher_t *dispatcher, MCAN_Type *ptr,
+                                       hpm_mcan_rx_route_t *routes, uint32_t route_count,
+                                       hpm_mcan_rx_queue_t **queues, uint32_t queue_count,
+                                       hpm_mcan_rx_queue_t *default_queue)
+{
+    hpm_mcan_rx_route_t route;
+    uint32_t j;
+
+    if ((dispatcher == NULL) || (ptr == NULL) || ((route_count != 0) && ((routes == NULL) || (queues == NULL)))) {
+        return status_invalid_argument;
+    }
+
+    /* insertion sort, the table is built once and is usually close to sorted */
+    for (uint32_t i = 1; i < route_count; i++) {
+        route = routes[i];
+        j = i;
+        while ((j > 0) && (routes[j - 1U].key > route.key)) {
+            routes[j] = routes[j - 1U];
+            j--;
+        }
+        routes[j] = route;
+    }
+    for (uint32_t i = 0; i < route_count; i++) {
+        if ((routes[i].queue >= queue_count) || (queues[routes[i].queue] == NULL)) {
+            return status_invalid_argument;
+        }
+        if ((i > 0) && (routes[i].key == routes[i - 1U].key)) {
+            return status_invalid_argument;
+        }
+    }
+
+    memset(dispatcher, 0, sizeof(*dispatcher));
+    dispatcher->ptr = ptr;
+    dispatcher->routes = routes;
+    dispatcher->route_count = route_count;
+    dispatcher->queues = queues;
+    dispatcher->queue_count = queue_count;
+    dispatcher->default_queue = default_queue;
+    return status_success;
+}
+
+const hpm_mcan_rx_route_t *hpm_mcan_rx_lookup(const hpm_mcan_rx_dispatcher_t *dispatcher, uint32_t key)
+{
+    const hpm_mcan_rx_route_t *routes = dispatcher->routes;
+    uint32_t lo = 0;
+    uint32_t hi = dispatcher->route_count;
+    uint32_t mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2U;
+        if (routes[mid].key < key) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    if ((lo < dispatcher->route_count) && (routes[lo].key == key)) {
+        return &routes[lo];
+    }
+    return NULL;
+}
+
+uint32_t hpm_mcan_rx_dispatch(hpm_mcan_rx_dispatcher_t *dispatcher, uint32_t fifo_index)
+{
+    const hpm_mcan_rx_route_t *route;
+    const mcan_rx_message_t *frame;
+    uint32_t total = 0;
+    uint32_t count;
+    uint32_t key;
+
+    /* frames that arrive while a burst is routed are picked up by the next one */
+    while (mcan_read_rxfifo_burst(dispatcher->ptr, fifo_index, dispatcher->burst, HPM_MCAN_RX_BURST, &count)
+           == status_success) {
+        dispatcher->stat.bursts++;
+        for (uint32_t i = 0; i < count; i++) {
+            frame = &dispatcher->burst[i];
+            key = frame->use_ext_id ? HPM_MCAN_RX_KEY(frame->ext_id, true) : HPM_MCAN_RX_KEY(frame->std_id, false);
+            route = hpm_mcan_rx_lookup(dispatcher, key);
+            if (route != NULL) {
+                hpm_mcan_rx_queue_push(dispatcher->queues[route->queue], frame);
+            } else {
+                dispatcher->stat.unrouted++;
+                if (dispatcher->default_queue != NULL) {
+                    hpm_mcan_rx_queue_push(dispatcher->default_queue, frame);
+                }
+            }
+        }
+        total += count;
+    }
+    dispatcher->stat.frames += total;
+    return total;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_MCAN_RX_H
+#define HPM_MCAN_RX_H
+
+#include "hpm_common.h"
+#include "hpm_mcan_drv.h"
+
+/**
+ * @brief MCAN receive dispatch
+ *
+ * The dispatcher drains an RX FIFO in bursts from the MCAN interrupt and
+ * routes every frame by its identifier to one of several single producer,
+ * single consumer queues, e.g. one per application task. Routes are kept in
+ * a table sorted by key and searched by bisection, so hundreds of accepted
+ * identifiers cost a handful of compares per frame once the hardware filter
+ * elements run out: the hardware filters are then set to accept everything
+ * into the FIFO and the table does the filtering.
+ */
+
+/* Frames read from the FIFO per burst */
+#ifndef HPM_MCAN_RX_BURST
+#define HPM_MCAN_RX_BURST (8U)
+#endif
+
+/* Orders the frame stores before the index update that publishes them */
+#ifndef HPM_MCAN_RX_BARRIER
+#define HPM_MCAN_RX_BARRIER() __asm volatile("fence rw, rw" ::: "memory")
+#endif
+
+/* Set in a key for an extended identifier */
+#define HPM_MCAN_RX_KEY_EXT (1UL << 31)
+
+/* Route key of an identifier */
+#define HPM_MCAN_RX_KEY(id, is_ext) ((uint32_t)(id) | ((is_ext) ? HPM_MCAN_RX_KEY_EXT : 0U))
+
+/**
+ * @brief Frame queue, one producer and one consumer without locking
+ */
+typedef struct {
+    mcan_rx_message_t *buf;
+    uint32_t size;                  /**< entries, a power of 2 */
+    volatile uint32_t head;         /**< free running, written by the producer */
+    volatile uint32_t tail;         /**< free running, written by the consumer */
+    uint32_t dropped;               /**< frames lost because the queue was full */
+} hpm_mcan_rx_queue_t;
+
+/**
+ * @brief Route of an identifier to a queue
+ */
+typedef struct {
+    uint32_t key;                   /**< HPM_MCAN_RX_KEY() */
+    uint32_t queue;                 /**< index into the dispatcher queues */
+} hpm_mcan_rx_route_t;
+
+/**
+ * @brief Dispatcher statistics
+ */
+typedef struct {
+    uint32_t frames;                /**< frames read from the FIFO */
+    uint32_t bursts;                /**< FIFO reads */
+    uint32_t unrouted;              /**< frames without a route */
+} hpm_mcan_rx_stat_t;
+
+/**
+ * @brief Dispatcher
+ */
+typedef struct {
+    MCAN_Type *ptr;
+    const hpm_mcan_rx_route_t *routes;
+    uint32_t route_count;
+    hpm_mcan_rx_queue_t **queues;
+    uint32_t queue_count;
+    hpm_mcan_rx_queue_t *default_queue;     /**< frames without a route, NULL to drop them */
+    mcan_rx_message_t burst[HPM_MCAN_RX_BURST];
+    hpm_mcan_rx_stat_t stat;
+} hpm_mcan_rx_dispatcher_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize a queue
+ *
+ * @param [out] queue queue
+ * @param [in] buf entries
+ * @param [in] size number of entries, a power of 2
+ * @retval status_invalid_argument if size is not a power of 2
+ */
+hpm_stat_t hpm_mcan_rx_queue_init(hpm_mcan_rx_queue_t *queue, mcan_rx_message_t *buf, uint32_t size);
+
+/**
+ * @brief Number of frames in a queue
+ *
+ * @param [in] queue queue
+ * @retval frames ready to be read
+ */
+static inline uint32_t hpm_mcan_rx_queue_count(const hpm_mcan_rx_queue_t *queue)
+{
+    return queue->head - queue->tail;
+}
+
+/**
+ * @brief Get the oldest frame without copying it, consumer side
+ *
+ * @param [in] queue queue
+ * @retval frame, valid until hpm_mcan_rx_queue_pop(), or NULL if the queue is empty
+ */
+mcan_rx_message_t *hpm_mcan_rx_queue_peek(hpm_mcan_rx_queue_t *queue);
+
+/**
+ * @brief Drop the oldest frame after it has been used, consumer side
+ *
+ * @param [in] queue queue
+ */
+void hpm_mcan_rx_queue_pop(hpm_mcan_rx_queue_t *queue);
+
+/**
+ * @brief Initialize a dispatcher
+ *
+ * @param [out] dispatcher dispatcher
+ * @param [in] ptr MCAN base
+ * @param [in,out] routes routes, sorted in place by key
+ * @param [in] route_count number of routes
+ * @param [in] queues queues the routes point to
+ * @param [in] queue_count number of queues
+ * @param [in] default_queue queue of frames without a route, NULL to drop them
+ * @retval status_invalid_argument if a key is duplicated or a route points outside queues
+ */
+hpm_stat_t hpm_mcan_rx_dispatcher_init(hpm_mcan_rx_dispatcher_t *dispatcher, MCAN_Type *ptr,
+                                       hpm_mcan_rx_route_t *routes, uint32_t route_count,
+                                       hpm_mcan_rx_queue_t **queues, uint32_t queue_count,
+                                       hpm_mcan_rx_queue_t *default_queue);
+
+/**
+ * @brief Find the route of a key
+ *
+ * @param [in] dispatcher dispatcher
+ * @param [in] key HPM_MCAN_RX_KEY()
+ * @retval route, or NULL if there is none
+ */
+const hpm_mcan_rx_route_t *hpm_mcan_rx_lookup(const hpm_mcan_rx_dispatcher_t *dispatcher, uint32_t key);
+
+/**
+ * @brief Drain an RX FIFO and route its frames, called from the MCAN interrupt
+ *
+ * @param [in] dispatcher dispatcher
+ * @param [in] fifo_index RXFIFO index, 0 - RXFIFO0, 1 - RXFIFO1
+ * @retval number of frames read
+ */
+uint32_t hpm_mcan_rx_dispatch(hpm_mcan_rx_dispatcher_t *dispatcher, uint32_t fifo_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_MCAN_RX_H */
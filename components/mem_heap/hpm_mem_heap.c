@@ -0,0 +1,534 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_mem_heap.h"
+#include "hpm_soc.h"
+#include "hpm_interrupt.h"
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+#ifndef HPM_MEM_HEAP_ENTER_CRITICAL
+#define HPM_MEM_HEAP_ENTER_CRITICAL()       disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define HPM_MEM_HEAP_EXIT_CRITICAL(level)   restore_global_irq((level) & CSR_MSTATUS_MIE_MASK)
+#endif
+
+#define TLSF_ALIGN_SIZE         (8U)
+#define TLSF_SL_LOG2            (4U)
+#define TLSF_SL_COUNT           (1U << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT           (TLSF_SL_LOG2 + 3U)     /* 3 = log2(TLSF_ALIGN_SIZE) */
+#define TLSF_FL_MAX             (30U)
+#define TLSF_FL_COUNT           (TLSF_FL_MAX - TLSF_FL_SHIFT + 1U)
+#define TLSF_SMALL_BLOCK_SIZE   (1U << TLSF_FL_SHIFT)   /* below this, the second level is linear */
+#define TLSF_BLOCK_SIZE_MAX     ((1UL << TLSF_FL_MAX) - TLSF_ALIGN_SIZE)
+
+#define TLSF_BLOCK_FREE         (1U)
+#define TLSF_BLOCK_PREV_FREE    (2U)
+#define TLSF_BLOCK_FLAGS        (TLSF_BLOCK_FREE | TLSF_BLOCK_PREV_FREE)
+
+/*
+ * Block header. size is the payload size with the flags in the low bits,
+ * the free list links are only valid while the block is free and overlap
+ * the payload otherwise.
+ */
+typedef struct tlsf_block {
+    struct tlsf_block *prev_phys;
+    size_t size;
+    struct tlsf_block *next_free;
+    struct tlsf_block *prev_free;
+} tlsf_block_t;
+
+#define TLSF_BLOCK_OVERHEAD     (offsetof(tlsf_block_t, next_free))
+#define TLSF_BLOCK_SIZE_MIN     (sizeof(tlsf_block_t) - TLSF_BLOCK_OVERHEAD)
+
+typedef struct {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_COUNT];
+    tlsf_block_t *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+} tlsf_control_t;
+
+typedef struct {
+    tlsf_control_t *control;
+    uintptr_t start;
+    uintptr_t end;
+    uint32_t used_size;
+    hpm_mem_heap_stat_t stat;
+} hpm_mem_region_t;
+
+/*****************************************************************************************************************
+ *
+ *  Prototypes
+ *
+ *****************************************************************************************************************/
+static void *tlsf_malloc(tlsf_control_t *control, size_t size, size_t alignment, uint32_t *block_size);
+static uint32_t tlsf_free(tlsf_control_t *control, void *ptr);
+static uint32_t tlsf_largest_free(const tlsf_control_t *control);
+
+/*****************************************************************************************************************
+ *
+ *  Variables
+ *
+ *****************************************************************************************************************/
+static hpm_mem_region_t s_mem_regions[HPM_MEM_HEAP_MAX_REGIONS];
+static uint32_t s_mem_region_count;
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+static inline uint32_t tlsf_fls(uint32_t value)
+{
+    return 31U - (uint32_t)__builtin_clz(value);
+}
+
+static inline uint32_t tlsf_ffs(uint32_t value)
+{
+    return (uint32_t)__builtin_ctz(value);
+}
+
+static inline size_t tlsf_align_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1U) & ~(alignment - 1U);
+}
+
+static inline size_t tlsf_block_size(const tlsf_block_t *block)
+{
+    return block->size & ~(size_t)TLSF_BLOCK_FLAGS;
+}
+
+static inline void tlsf_block_set_size(tlsf_block_t *block, size_t size)
+{
+    block->size = size | (block->size & TLSF_BLOCK_FLAGS);
+}
+
+static inline void *tlsf_block_to_ptr(const tlsf_block_t *block)
+{
+    return (uint8_t *)block + TLSF_BLOCK_OVERHEAD;
+}
+
+static inline tlsf_block_t *tlsf_block_from_ptr(const void *ptr)
+{
+    return (tlsf_block_t *)((uint8_t *)ptr - TLSF_BLOCK_OVERHEAD);
+}
+
+static inline tlsf_block_t *tlsf_block_next(const tlsf_block_t *block)
+{
+    return (tlsf_block_t *)((uint8_t *)tlsf_block_to_ptr(block) + tlsf_block_size(block));
+}
+
+/* mark the block free and tell its physical successor */
+static inline void tlsf_block_mark_free(tlsf_block_t *block)
+{
+    tlsf_block_t *next = tlsf_block_next(block);
+
+    next->prev_phys = block;
+    next->size |= TLSF_BLOCK_PREV_FREE;
+    block->size |= TLSF_BLOCK_FREE;
+}
+
+static inline void tlsf_block_mark_used(tlsf_block_t *block)
+{
+    tlsf_block_next(block)->size &= ~(size_t)TLSF_BLOCK_PREV_FREE;
+    block->size &= ~(size_t)TLSF_BLOCK_FREE;
+}
+
+static void tlsf_mapping_insert(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    uint32_t f;
+
+    if (size < TLSF_SMALL_BLOCK_SIZE) {
+        *fl = 0;
+        *sl = (uint32_t)size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_COUNT);
+    } else {
+        f = tlsf_fls((uint32_t)size);
+        *sl = ((uint32_t)size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - (TLSF_FL_SHIFT - 1U);
+    }
+}
+
+/* round up to the next list so that any block found there is big enough */
+static void tlsf_mapping_search(size_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size >= TLSF_SMALL_BLOCK_SIZE) {
+        size += (1UL << (tlsf_fls((uint32_t)size) - TLSF_SL_LOG2)) - 1U;
+    }
+    tlsf_mapping_insert(size, fl, sl);
+}
+
+static tlsf_block_t *tlsf_find_suitable(tlsf_control_t *control, uint32_t *fl, uint32_t *sl)
+{
+    uint32_t sl_map;
+    uint32_t fl_map;
+
+    if (*fl >= TLSF_FL_COUNT) {
+        return NULL;
+    }
+    sl_map = control->sl_bitmap[*fl] & (~0UL << *sl);
+    if (sl_map == 0U) {
+        fl_map = control->fl_bitmap & (~0UL << (*fl + 1U));
+        if (fl_map == 0U) {
+            return NULL;
+        }
+        *fl = tlsf_ffs(fl_map);
+        sl_map = control->sl_bitmap[*fl];
+    }
+    *sl = tlsf_ffs(sl_map);
+
+    return control->blocks[*fl][*sl];
+}
+
+static void tlsf_insert_free(tlsf_control_t *control, tlsf_block_t *block)
+{
+    uint32_t fl;
+    uint32_t sl;
+
+    tlsf_mapping_insert(tlsf_block_size(block), &fl, &sl);
+    block->prev_free = NULL;
+    block->next_free = control->blocks[fl][sl];
+    if (block->next_free != NULL) {
+        block->next_free->prev_free = block;
+    }
+    control->blocks[fl][sl] = block;
+    control->fl_bitmap |= 1UL << fl;
+    control->sl_bitmap[fl] |= 1UL << sl;
+}
+
+static void tlsf_remove_free(tlsf_control_t *control, tlsf_block_t *block)
+{
+    uint32_t fl;
+    uint32_t sl;
+
+    tlsf_mapping_insert(tlsf_block_size(block), &fl, &sl);
+    if (block->next_free != NULL) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if (block->prev_free != NULL) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        control->blocks[fl][sl] = block->next_free;
+        if (block->next_free == NULL) {
+            control->sl_bitmap[fl] &= ~(1UL << sl);
+            if (control->sl_bitmap[fl] == 0U) {
+                control->fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+/* split size bytes off the front of a free block and return the remaining block to the free lists */
+static void tlsf_block_trim(tlsf_control_t *control, tlsf_block_t *block, size_t size)
+{
+    tlsf_block_t *rest;
+    size_t rest_size;
+
+    if (tlsf_block_size(block) < (size + sizeof(tlsf_block_t))) {
+        return;
+    }
+    rest_size = tlsf_block_size(block) - size - TLSF_BLOCK_OVERHEAD;
+    tlsf_block_set_size(block, size);
+    rest = tlsf_block_next(block);
+    rest->size = rest_size | TLSF_BLOCK_PREV_FREE;
+    rest->prev_phys = block;
+    tlsf_block_mark_free(rest);
+    tlsf_insert_free(control, rest);
+}
+
+static tlsf_control_t *tlsf_create(uintptr_t start, uintptr_t end, uint32_t *pool_size)
+{
+    tlsf_control_t *control = (tlsf_control_t *)tlsf_align_up(start, TLSF_ALIGN_SIZE);
+    tlsf_block_t *block = (tlsf_block_t *)tlsf_align_up((uintptr_t)&control[1], TLSF_ALIGN_SIZE);
+    tlsf_block_t *sentinel;
+    size_t size;
+
+    if ((uintptr_t)block + 2U * TLSF_BLOCK_OVERHEAD + TLSF_SMALL_BLOCK_SIZE > end) {
+        return NULL;
+    }
+    size = (end - (uintptr_t)block - 2U * TLSF_BLOCK_OVERHEAD) & ~(size_t)(TLSF_ALIGN_SIZE - 1U);
+    if (size > TLSF_BLOCK_SIZE_MAX) {
+        size = TLSF_BLOCK_SIZE_MAX;
+    }
+
+    memset(control, 0, sizeof(*control));
+    block->prev_phys = NULL;
+    block->size = size;
+    sentinel = tlsf_block_next(block);
+    sentinel->size = 0;
+    tlsf_block_mark_free(block);
+    tlsf_insert_free(control, block);
+    *pool_size = (uint32_t)(size + TLSF_BLOCK_OVERHEAD);
+
+    return control;
+}
+
+static void *tlsf_malloc(tlsf_control_t *control, size_t size, size_t alignment, uint32_t *block_size)
+{
+    tlsf_block_t *block;
+    tlsf_block_t *aligned_block;
+    size_t search_size;
+    uintptr_t ptr;
+    uintptr_t aligned;
+    size_t gap;
+    uint32_t fl;
+    uint32_t sl;
+
+    if ((size == 0U) || (size > TLSF_BLOCK_SIZE_MAX)) {
+        return NULL;
+    }
+    size = tlsf_align_up(size, TLSF_ALIGN_SIZE);
+    if (size < TLSF_BLOCK_SIZE_MIN) {
+        size = TLSF_BLOCK_SIZE_MIN;
+    }
+    /* room for the worst case gap in front of an aligned block, the gap becomes a free block */
+    search_size = (alignment > TLSF_ALIGN_SIZE) ? (size + alignment + sizeof(tlsf_block_t)) : size;
+
+    tlsf_mapping_search(search_size, &fl, &sl);
+    block = tlsf_find_suitable(control, &fl, &sl);
+    if (block == NULL) {
+        return NULL;
+    }
+    tlsf_remove_free(control, block);
+
+    if (alignment > TLSF_ALIGN_SIZE) {
+        ptr = (uintptr_t)tlsf_block_to_ptr(block);
+        aligned = tlsf_align_up(ptr, alignment);
+        gap = aligned - ptr;
+        if ((gap != 0U) && (gap < sizeof(tlsf_block_t))) {
+            aligned = tlsf_align_up(ptr + sizeof(tlsf_block_t), alignment);
+            gap = aligned - ptr;
+        }
+        if (gap != 0U) {
+            aligned_block = tlsf_block_from_ptr((void *)aligned);
+            aligned_block->size = (tlsf_block_size(block) - gap) | TLSF_BLOCK_PREV_FREE;
+            aligned_block->prev_phys = block;
+            tlsf_block_next(aligned_block)->prev_phys = aligned_block;
+            tlsf_block_set_size(block, gap - TLSF_BLOCK_OVERHEAD);
+            tlsf_insert_free(control, block);
+            block = aligned_block;
+        }
+    }
+
+    tlsf_block_trim(control, block, size);
+    tlsf_block_mark_used(block);
+    *block_size = (uint32_t)(tlsf_block_size(block) + TLSF_BLOCK_OVERHEAD);
+
+    return tlsf_block_to_ptr(block);
+}
+
+static uint32_t tlsf_free(tlsf_control_t *control, void *ptr)
+{
+    tlsf_block_t *block = tlsf_block_from_ptr(ptr);
+    tlsf_block_t *neighbour;
+    uint32_t released = (uint32_t)(tlsf_block_size(block) + TLSF_BLOCK_OVERHEAD);
+
+    if ((block->size & TLSF_BLOCK_PREV_FREE) != 0U) {
+        neighbour = block->prev_phys;
+        tlsf_remove_free(control, neighbour);
+        tlsf_block_set_size(neighbour, tlsf_block_size(neighbour) + tlsf_block_size(block) + TLSF_BLOCK_OVERHEAD);
+        block = neighbour;
+    }
+    neighbour = tlsf_block_next(block);
+    if ((neighbour->size & TLSF_BLOCK_FREE) != 0U) {
+        tlsf_remove_free(control, neighbour);
+        tlsf_block_set_size(block, tlsf_block_size(block) + tlsf_block_size(neighbour) + TLSF_BLOCK_OVERHEAD);
+    }
+    tlsf_block_mark_free(block);
+    tlsf_insert_free(control, block);
+
+    return released;
+}
+
+static uint32_t tlsf_largest_free(const tlsf_control_t *control)
+{
+    const tlsf_block_t *block;
+    size_t largest = 0;
+    uint32_t fl;
+    uint32_t sl;
+
+    if (control->fl_bitmap == 0U) {
+        return 0;
+    }
+    fl = tlsf_fls(control->fl_bitmap);
+    sl = tlsf_fls(control->sl_bitmap[fl]);
+    for (block = control->blocks[fl][sl]; block != NULL; block = block->next_free) {
+        if (tlsf_block_size(block) > largest) {
+            largest = tlsf_block_size(block);
+        }
+    }
+
+    return (uint32_t)largest;
+}
+
+hpm_stat_t hpm_mem_heap_add_region(const char *name, void *start, uint32_t size, uint32_t caps)
+{
+    hpm_mem_region_t *region;
+    uintptr_t begin = (uintptr_t)start;
+    uintptr_t end = begin + size;
+    uint32_t pool_size = 0;
+    uint32_t level;
+    hpm_stat_t stat = status_success;
+
+    if ((start == NULL) || (end <= begin)) {
+        return status_invalid_argument;
+    }
+
+    level = HPM_MEM_HEAP_ENTER_CRITICAL();
+    for (uint32_t i = 0; i < s_mem_region_count; i++) {
+        if ((begin < s_mem_regions[i].end) && (s_mem_regions[i].start < end)) {
+            stat = status_invalid_argument;
+        }
+    }
+    if ((stat == status_success) && (s_mem_region_count >= HPM_MEM_HEAP_MAX_REGIONS)) {
+        stat = status_fail;
+    }
+    if (stat == status_success) {
+        region = &s_mem_regions[s_mem_region_count];
+        memset(region, 0, sizeof(*region));
+        region->control = tlsf_create(begin, end, &pool_size);
+        if (region->control == NULL) {
+            stat = status_invalid_argument;
+        } else {
+            region->start = begin;
+            region->end = end;
+            region->stat.name = name;
+            region->stat.caps = caps;
+            region->stat.total_size = pool_size;
+            region->stat.min_free_size = pool_size;
+            s_mem_region_count++;
+        }
+    }
+    HPM_MEM_HEAP_EXIT_CRITICAL(level);
+
+    return stat;
+}
+
+void *hpm_aligned_malloc_caps(size_t size, size_t alignment, uint32_t caps)
+{
+    hpm_mem_region_t *region;
+    uint32_t block_size;
+    uint32_t free_size;
+    uint32_t level;
+    void *ptr = NULL;
+
+    if ((alignment & (alignment - 1U)) != 0U) {
+        return NULL;
+    }
+    if ((caps & HPM_MEM_DMA) != 0U) {
+        /* keep other data out of the cache lines of a DMA buffer */
+        if (alignment < HPM_MEM_HEAP_CACHELINE_SIZE) {
+            alignment = HPM_MEM_HEAP_CACHELINE_SIZE;
+        }
+        size = tlsf_align_up(size, HPM_MEM_HEAP_CACHELINE_SIZE);
+    }
+
+    level = HPM_MEM_HEAP_ENTER_CRITICAL();
+    for (uint32_t i = 0; (i < s_mem_region_count) && (ptr == NULL); i++) {
+        region = &s_mem_regions[i];
+        if (((region->stat.caps & caps) != caps)
+         || (((region->stat.caps & HPM_MEM_NONCACHEABLE) != 0U) && ((caps & HPM_MEM_NONCACHEABLE) == 0U))) {
+            continue;
+        }
+        ptr = tlsf_malloc(region->control, size, alignment, &block_size);
+        if (ptr == NULL) {
+            region->stat.failed_count++;
+            continue;
+        }
+        region->used_size += block_size;
+        region->stat.alloc_count++;
+        free_size = region->stat.total_size - region->used_size;
+        if (free_size < region->stat.min_free_size) {
+            region->stat.min_free_size = free_size;
+        }
+    }
+    HPM_MEM_HEAP_EXIT_CRITICAL(level);
+
+    return ptr;
+}
+
+void *hpm_malloc_caps(size_t size, uint32_t caps)
+{
+    return hpm_aligned_malloc_caps(size, TLSF_ALIGN_SIZE, caps);
+}
+
+void *hpm_calloc_caps(size_t count, size_t size, uint32_t caps)
+{
+    void *ptr;
+
+    if ((size != 0U) && (count > (SIZE_MAX / size))) {
+        return NULL;
+    }
+    ptr = hpm_malloc_caps(count * size, caps);
+    if (ptr != NULL) {
+        memset(ptr, 0, count * size);
+    }
+
+    return ptr;
+}
+
+void hpm_free(void *ptr)
+{
+    hpm_mem_region_t *region;
+    uint32_t level;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    level = HPM_MEM_HEAP_ENTER_CRITICAL();
+    for (uint32_t i = 0; i < s_mem_region_count; i++) {
+        region = &s_mem_regions[i];
+        if (((uintptr_t)ptr > region->start) && ((uintptr_t)ptr < region->end)) {
+            region->used_size -= tlsf_free(region->control, ptr);
+            region->stat.free_count++;
+            break;
+        }
+    }
+    HPM_MEM_HEAP_EXIT_CRITICAL(level);
+}
+
+uint32_t hpm_mem_heap_get_region_count(void)
+{
+    return s_mem_region_count;
+}
+
+hpm_stat_t hpm_mem_heap_get_stat(uint32_t index, hpm_mem_heap_stat_t *stat)
+{
+    hpm_mem_region_t *region;
+    uint32_t level;
+
+    if ((index >= s_mem_region_count) || (stat == NULL)) {
+        return status_invalid_argument;
+    }
+
+    region = &s_mem_regions[index];
+    level = HPM_MEM_HEAP_ENTER_CRITICAL();
+    *stat = region->stat;
+    stat->free_size = region->stat.total_size - region->used_size;
+    stat->largest_free = tlsf_largest_free(region->control);
+    HPM_MEM_HEAP_EXIT_CRITICAL(level);
+
+    return status_success;
+}
+
+uint32_t hpm_mem_heap_get_free_size(uint32_t caps)
+{
+    uint32_t free_size = 0;
+    uint32_t level = HPM_MEM_HEAP_ENTER_CRITICAL();
+
+    for (uint32_t i = 0; i < s_mem_region_count; i++) {
+        if (((s_mem_regions[i].stat.caps & caps) == caps)
+         && (((s_mem_regions[i].stat.caps & HPM_MEM_NONCACHEABLE) == 0U) || ((caps & HPM_MEM_NONCACHEABLE) != 0U))) {
+            free_size += s_mem_regions[i].stat.total_size - s_mem_regions[i].used_size;
+        }
+    }
+    HPM_MEM_HEAP_EXIT_CRITICAL(level);
+
+    return free_size;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_MEM_HEAP_H
+#define HPM_MEM_HEAP_H
+
+#include <stddef.h>
+#include "hpm_common.h"
+
+/**
+ * @brief Region aware heap
+ *
+ * Manages several memory regions (DLM, AXI SRAM, SDRAM, noncacheable RAM),
+ * each tagged with capabilities. hpm_malloc_caps() returns memory from the
+ * first region, in the order the regions were added, that has all requested
+ * capabilities and enough free space. Noncacheable regions are only used when
+ * HPM_MEM_NONCACHEABLE is requested.
+ *
+ * Each region is a TLSF (two level segregated fit) heap, allocation and
+ * release are O(1). The TLSF control block is placed at the start of the
+ * region memory.
+ *
+ * hpm_mem_heap_add_default_regions() adds the unused end of the RAM regions
+ * as reported by the SoC linker scripts, DLM first so hot data lands in
+ * zero wait state memory.
+ */
+
+#ifndef HPM_MEM_HEAP_MAX_REGIONS
+#define HPM_MEM_HEAP_MAX_REGIONS (6U)
+#endif
+
+/* HPM_MEM_DMA blocks are aligned to and sized in multiples of this */
+#ifndef HPM_MEM_HEAP_CACHELINE_SIZE
+#define HPM_MEM_HEAP_CACHELINE_SIZE (64U)
+#endif
+
+/* Region capabilities */
+#define HPM_MEM_DEFAULT         (0U)        /**< any region except noncacheable ones */
+#define HPM_MEM_FAST            (1U << 0)   /**< zero wait state core local memory */
+#define HPM_MEM_DMA             (1U << 1)   /**< usable by DMA masters without address translation */
+#define HPM_MEM_NONCACHEABLE    (1U << 2)   /**< not cached by the L1 data cache */
+#define HPM_MEM_INTERNAL        (1U << 3)   /**< on chip memory */
+#define HPM_MEM_EXTERNAL        (1U << 4)   /**< external memory, e.g. SDRAM */
+
+/**
+ * @brief Region statistics
+ */
+typedef struct {
+    const char *name;           /**< region name */
+    uint32_t caps;              /**< region capabilities */
+    uint32_t total_size;        /**< bytes managed by the heap, block headers included */
+    uint32_t free_size;         /**< bytes currently free */
+    uint32_t min_free_size;     /**< lowest free_size seen */
+    uint32_t largest_free;      /**< largest free block */
+    uint32_t alloc_count;       /**< successful allocations */
+    uint32_t free_count;        /**< releases */
+    uint32_t failed_count;      /**< allocations this region could not serve */
+} hpm_mem_heap_stat_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Add a memory region
+ *
+ * @param [in] name region name, must stay valid
+ * @param [in] start region start
+ * @param [in] size region size in bytes
+ * @param [in] caps region capabilities, HPM_MEM_*
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the region is too small or overlaps a known region
+ * @retval status_fail if HPM_MEM_HEAP_MAX_REGIONS regions are already added
+ */
+hpm_stat_t hpm_mem_heap_add_region(const char *name, void *start, uint32_t size, uint32_t caps);
+
+/**
+ * @brief Add the unused end of the RAM regions reported by the linker script
+ *
+ * Regions the linker script does not describe, or without space left, are
+ * skipped.
+ *
+ * @return number of added regions
+ */
+uint32_t hpm_mem_heap_add_default_regions(void);
+
+/**
+ * @brief Allocate memory with capabilities
+ *
+ * HPM_MEM_DMA blocks are aligned to and sized in multiples of
+ * HPM_MEM_HEAP_CACHELINE_SIZE, so cache maintenance on them never touches
+ * other data.
+ *
+ * @param [in] size size in bytes
+ * @param [in] caps required capabilities, HPM_MEM_*
+ * @return memory block, 8 byte aligned, or NULL
+ */
+void *hpm_malloc_caps(size_t size, uint32_t caps);
+
+/**
+ * @brief Allocate aligned memory with capabilities
+ *
+ * @param [in] size size in bytes
+ * @param [in] alignment alignment, power of 2
+ * @param [in] caps required capabilities, HPM_MEM_*
+ * @return memory block or NULL
+ */
+void *hpm_aligned_malloc_caps(size_t size, size_t alignment, uint32_t caps);
+
+/**
+ * @brief Allocate zeroed memory with capabilities
+ *
+ * @param [in] count number of elements
+ * @param [in] size element size in bytes
+ * @param [in] caps required capabilities, HPM_MEM_*
+ * @return memory block or NULL
+ */
+void *hpm_calloc_caps(size_t count, size_t size, uint32_t caps);
+
+/**
+ * @brief Release memory returned by the hpm_*_caps() functions
+ *
+ * @param [in] ptr memory block, may be NULL
+ */
+void hpm_free(void *ptr);
+
+/**
+ * @brief Number of added regions
+ */
+uint32_t hpm_mem_heap_get_region_count(void);
+
+/**
+ * @brief Get region statistics
+ *
+ * @param [in] index region index, less than hpm_mem_heap_get_region_count()
+ * @param [out] stat statistics
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the parameter is invalid
+ */
+hpm_stat_t hpm_mem_heap_get_stat(uint32_t index, hpm_mem_heap_stat_t *stat);
+
+/**
+ * @brief Free bytes in all regions hpm_malloc_caps() would use for the given capabilities
+ *
+ * @param [in] caps capabilities, HPM_MEM_*
+ * @return free bytes
+ */
+uint32_t hpm_mem_heap_get_free_size(uint32_t caps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_MEM_HEAP_H */
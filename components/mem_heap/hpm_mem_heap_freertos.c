@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+/*
+ * FreeRTOS heap on top of the region aware heap, selected with
+ * CONFIG_FREERTOS_HEAP=hpm_mem_heap instead of heap_1..heap_5.
+ * Kernel objects and task stacks are placed in the fastest region first.
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hpm_mem_heap.h"
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+#error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+void *pvPortMalloc(size_t xWantedSize)
+{
+    void *pvReturn;
+
+    /* the regions are added on first use unless the application added its own */
+    if (hpm_mem_heap_get_region_count() == 0U) {
+        taskENTER_CRITICAL();
+        /* another task may have added them since the check above */
+        if (hpm_mem_heap_get_region_count() == 0U) {
+            (void)hpm_mem_heap_add_default_regions();
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    pvReturn = hpm_malloc_caps(xWantedSize, HPM_MEM_DEFAULT);
+    traceMALLOC(pvReturn, xWantedSize);
+
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+    if (pvReturn == NULL) {
+        extern void vApplicationMallocFailedHook(void);
+        vApplicationMallocFailedHook();
+    }
+#endif
+
+    return pvReturn;
+}
+
+void vPortFree(void *pv)
+{
+    if (pv != NULL) {
+        traceFREE(pv, 0);
+        hpm_free(pv);
+    }
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+    return hpm_mem_heap_get_free_size(HPM_MEM_DEFAULT);
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    hpm_mem_heap_stat_t stat;
+    size_t min_free_size = 0;
+
+    for (uint32_t i = 0; i < hpm_mem_heap_get_region_count(); i++) {
+        if ((hpm_mem_heap_get_stat(i, &stat) == status_success) && ((stat.caps & HPM_MEM_NONCACHEABLE) == 0U)) {
+            min_free_size += stat.min_free_size;
+        }
+    }
+
+    return min_free_size;
+}
+
+void vPortInitialiseBlocks(void)
+{
+    /* This just exists to keep the linker quiet. */
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_mem_heap.h"
+#include "hpm_soc.h"
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+/* ILM and DLM are mapped below the system memory, DMA masters need core_local_mem_to_sys_address() there */
+#define HPM_MEM_HEAP_CORE_LOCAL_END (0x01000000UL)
+
+typedef struct {
+    const char *name;
+    char *start;
+    char *end;
+    uint32_t caps;
+} hpm_mem_heap_default_region_t;
+
+/*
+ * Provided by the SoC linker scripts, weak so a linker script without the
+ * region or another toolchain leaves them at 0.
+ */
+extern char __heap_free_dlm_start__[] __attribute__((weak));
+extern char __heap_free_dlm_end__[] __attribute__((weak));
+extern char __heap_free_axi_sram_start__[] __attribute__((weak));
+extern char __heap_free_axi_sram_end__[] __attribute__((weak));
+extern char __heap_free_sdram_start__[] __attribute__((weak));
+extern char __heap_free_sdram_end__[] __attribute__((weak));
+extern char __heap_free_noncacheable_start__[] __attribute__((weak));
+extern char __heap_free_noncacheable_end__[] __attribute__((weak));
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+uint32_t hpm_mem_heap_add_default_regions(void)
+{
+    /* in allocation priority order, fastest memory first */
+    const hpm_mem_heap_default_region_t regions[] = {
+        { "dlm", __heap_free_dlm_start__, __heap_free_dlm_end__, HPM_MEM_FAST | HPM_MEM_INTERNAL },
+        { "axi_sram", __heap_free_axi_sram_start__, __heap_free_axi_sram_end__, HPM_MEM_DMA | HPM_MEM_INTERNAL },
+        { "sdram", __heap_free_sdram_start__, __heap_free_sdram_end__, HPM_MEM_DMA | HPM_MEM_EXTERNAL },
+        { "noncacheable", __heap_free_noncacheable_start__, __heap_free_noncacheable_end__,
+          HPM_MEM_DMA | HPM_MEM_NONCACHEABLE },
+    };
+    uint32_t caps;
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(regions); i++) {
+        if ((regions[i].start == NULL) || (regions[i].end <= regions[i].start)) {
+            continue;
+        }
+        caps = regions[i].caps;
+        if ((uint32_t)regions[i].start < HPM_MEM_HEAP_CORE_LOCAL_END) {
+            /* e.g. the noncacheable region of a secondary core lives in its DLM */
+            caps = (caps & ~HPM_MEM_DMA) | HPM_MEM_FAST | HPM_MEM_INTERNAL;
+        }
+        if (hpm_mem_heap_add_region(regions[i].name, regions[i].start,
+                                    (uint32_t)(regions[i].end - regions[i].start), caps) == status_success) {
+            count++;
+        }
+    }
+
+    return count;
+}
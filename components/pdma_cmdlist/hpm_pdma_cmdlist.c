@@ -0,0 +1,395 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "hpm_pdma_cmdlist.h"
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+/* overridable, tests/host builds the component without RISC-V CSR access */
+#ifndef HPM_PDMA_CMDLIST_ENTER_CRITICAL
+#include "hpm_interrupt.h"
+#define HPM_PDMA_CMDLIST_ENTER_CRITICAL()       disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define HPM_PDMA_CMDLIST_EXIT_CRITICAL(level)   restore_global_irq((level) & CSR_MSTATUS_MIE_MASK)
+#endif
+
+#define HPM_PDMA_CMDLIST_ERROR_MASK (PDMA_STAT_AXI_0_WRITE_ERR_MASK \
+                                   | PDMA_STAT_AXI_1_READ_ERR_MASK \
+                                   | PDMA_STAT_AXI_0_READ_ERR_MASK)
+/* the value pdma_stop() clears the status with */
+#define HPM_PDMA_CMDLIST_STAT_CLEAR (0x21FU)
+#define HPM_PDMA_CMDLIST_CTRL_IRQ   (PDMA_CTRL_IRQ_EN_MASK | PDMA_CTRL_PDMA_DONE_IRQ_EN_MASK | PDMA_CTRL_AXIERR_IRQ_EN_MASK)
+
+/* CTRL is the last entry, writing it starts the operation */
+#define HPM_PDMA_CMDLIST_REG_CTRL   (HPM_PDMA_CMDLIST_REG_COUNT - 1U)
+
+/*****************************************************************************************************************
+ *
+ *  Prototypes
+ *
+ *****************************************************************************************************************/
+static hpm_stat_t hpm_pdma_cmdlist_check(hpm_pdma_cmdlist_t *list);
+static void hpm_pdma_cmdlist_record(hpm_pdma_cmdlist_t *list, PDMA_Type *image, pdma_op_config_t *op);
+static void hpm_pdma_cmdlist_start_cmd(hpm_pdma_cmdlist_engine_t *engine, const hpm_pdma_cmd_t *cmd);
+static void hpm_pdma_cmdlist_complete(hpm_pdma_cmdlist_engine_t *engine, hpm_stat_t status);
+
+/*****************************************************************************************************************
+ *
+ *  Variables
+ *
+ *****************************************************************************************************************/
+static const uint8_t hpm_pdma_cmdlist_reg_offset[HPM_PDMA_CMDLIST_REG_COUNT] = {
+    offsetof(PDMA_Type, PS[0].CTRL),
+    offsetof(PDMA_Type, PS[0].BUF),
+    offsetof(PDMA_Type, PS[0].PITCH),
+    offsetof(PDMA_Type, PS[0].BKGD),
+    offsetof(PDMA_Type, PS[0].SCALE),
+    offsetof(PDMA_Type, PS[0].OFFSET),
+    offsetof(PDMA_Type, PS[0].CLRKEY_LOW),
+    offsetof(PDMA_Type, PS[0].CLRKEY_HIGH),
+    offsetof(PDMA_Type, PS[0].ORG),
+    offsetof(PDMA_Type, PS[1].CTRL),
+    offsetof(PDMA_Type, PS[1].BUF),
+    offsetof(PDMA_Type, PS[1].PITCH),
+    offsetof(PDMA_Type, PS[1].BKGD),
+    offsetof(PDMA_Type, PS[1].SCALE),
+    offsetof(PDMA_Type, PS[1].OFFSET),
+    offsetof(PDMA_Type, PS[1].CLRKEY_LOW),
+    offsetof(PDMA_Type, PS[1].CLRKEY_HIGH),
+    offsetof(PDMA_Type, PS[1].ORG),
+    offsetof(PDMA_Type, YUV2RGB_COEF0),
+    offsetof(PDMA_Type, YUV2RGB_COEF1),
+    offsetof(PDMA_Type, YUV2RGB_COEF2),
+    offsetof(PDMA_Type, OUT_BUF),
+    offsetof(PDMA_Type, OUT_PITCH),
+    offsetof(PDMA_Type, OUT_LRC),
+    offsetof(PDMA_Type, OUT_PS[0].ULC),
+    offsetof(PDMA_Type, OUT_PS[0].LRC),
+    offsetof(PDMA_Type, OUT_PS[1].ULC),
+    offsetof(PDMA_Type, OUT_PS[1].LRC),
+    offsetof(PDMA_Type, OUT_CTRL),
+    offsetof(PDMA_Type, RGB2YUV_COEF0),
+    offsetof(PDMA_Type, RGB2YUV_COEF1),
+    offsetof(PDMA_Type, RGB2YUV_COEF2),
+    offsetof(PDMA_Type, RGB2YUV_COEF3),
+    offsetof(PDMA_Type, RGB2YUV_COEF4),
+    offsetof(PDMA_Type, CTRL),
+};
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+static inline volatile uint32_t *hpm_pdma_cmdlist_reg(PDMA_Type *ptr, uint32_t index)
+{
+    return (volatile uint32_t *)((uint8_t *)ptr + hpm_pdma_cmdlist_reg_offset[index]);
+}
+
+void hpm_pdma_cmdlist_engine_init(hpm_pdma_cmdlist_engine_t *engine, PDMA_Type *base)
+{
+    memset(engine, 0, sizeof(*engine));
+    engine->base = base;
+    pdma_stop(base);
+}
+
+void hpm_pdma_cmdlist_init(hpm_pdma_cmdlist_t *list, hpm_pdma_cmd_t *cmds, uint32_t capacity)
+{
+    memset(list, 0, sizeof(*list));
+    list->cmds = cmds;
+    list->capacity = capacity;
+    list->status = status_success;
+}
+
+void hpm_pdma_cmdlist_reset(hpm_pdma_cmdlist_t *list)
+{
+    if (list->status != status_pdma_busy) {
+        list->count = 0;
+        list->done = 0;
+    }
+}
+
+static hpm_stat_t hpm_pdma_cmdlist_check(hpm_pdma_cmdlist_t *list)
+{
+    if (list->status == status_pdma_busy) {
+        return status_pdma_busy;
+    }
+    if (list->count >= list->capacity) {
+        return status_fail;
+    }
+    return status_success;
+}
+
+/* render the registers of op on a RAM image with the driver, keep the ones a command programs */
+static void hpm_pdma_cmdlist_record(hpm_pdma_cmdlist_t *list, PDMA_Type *image, pdma_op_config_t *op)
+{
+    hpm_pdma_cmd_t *cmd = &list->cmds[list->count];
+
+    memset(image, 0, sizeof(*image));
+    pdma_config_op(image, op);
+    for (uint32_t i = 0; i < HPM_PDMA_CMDLIST_REG_COUNT; i++) {
+        cmd->reg[i] = *hpm_pdma_cmdlist_reg(image, i);
+    }
+    cmd->reg[HPM_PDMA_CMDLIST_REG_CTRL] &= ~PDMA_CTRL_PDMA_EN_MASK;
+    list->count++;
+}
+
+hpm_stat_t hpm_pdma_cmdlist_fill_color(hpm_pdma_cmdlist_t *list, uint32_t dst, uint32_t dst_width,
+                                       uint32_t width, uint32_t height,
+                                       uint32_t color, uint8_t alpha,
+                                       display_pixel_format_t format)
+{
+    PDMA_Type image;
+    pdma_op_config_t op;
+    hpm_stat_t stat;
+
+    stat = hpm_pdma_cmdlist_check(list);
+    if (stat != status_success) {
+        return stat;
+    }
+    stat = pdma_get_fill_color_config(&image, &op, dst, dst_width, width, height, color, alpha, format);
+    if (stat != status_success) {
+        return stat;
+    }
+    hpm_pdma_cmdlist_record(list, &image, &op);
+    return status_success;
+}
+
+hpm_stat_t hpm_pdma_cmdlist_blit(hpm_pdma_cmdlist_t *list,
+                                 uint32_t dst, uint32_t dst_width,
+                                 uint32_t src, uint32_t src_width,
+                                 uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                 uint8_t alpha,
+                                 display_pixel_format_t format)
+{
+    PDMA_Type image;
+    pdma_op_config_t op;
+    hpm_stat_t stat;
+
+    stat = hpm_pdma_cmdlist_check(list);
+    if (stat != status_success) {
+        return stat;
+    }
+    stat = pdma_get_blit_config(&image, &op, dst, dst_width, src, src_width, x, y, width, height, alpha, format);
+    if (stat != status_success) {
+        return stat;
+    }
+    hpm_pdma_cmdlist_record(list, &image, &op);
+    return status_success;
+}
+
+hpm_stat_t hpm_pdma_cmdlist_scale(hpm_pdma_cmdlist_t *list,
+                                  uint32_t dst, uint32_t dst_width,
+                                  uint32_t src, uint32_t src_width,
+                                  uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                  uint32_t target_width, uint32_t target_height,
+                                  uint8_t alpha,
+                                  display_pixel_format_t format)
+{
+    PDMA_Type image;
+    pdma_op_config_t op;
+    hpm_stat_t stat;
+
+    stat = hpm_pdma_cmdlist_check(list);
+    if (stat != status_success) {
+        return stat;
+    }
+    stat = pdma_get_scale_config(&image, &op, dst, dst_width, src, src_width, x, y, width, height,
+                                 target_width, target_height, alpha, format);
+    if (stat != status_success) {
+        return stat;
+    }
+    hpm_pdma_cmdlist_record(list, &image, &op);
+    return status_success;
+}
+
+hpm_stat_t hpm_pdma_cmdlist_flip_rotate(hpm_pdma_cmdlist_t *list, uint32_t dst, uint32_t dst_width,
+                                        uint32_t src, uint32_t src_width, uint32_t x, uint32_t y,
+                                        uint32_t width, uint32_t height,
+                                        pdma_flip_t flip, pdma_rotate_t rotate, uint8_t alpha,
+                                        display_pixel_format_t format)
+{
+    PDMA_Type image;
+    pdma_op_config_t op;
+    hpm_stat_t stat;
+
+    stat = hpm_pdma_cmdlist_check(list);
+    if (stat != status_success) {
+        return stat;
+    }
+    stat = pdma_get_flip_rotate_config(&image, &op, dst, dst_width, src, src_width, x, y,
+                                       width, height, flip, rotate, alpha, format);
+    if (stat != status_success) {
+        return stat;
+    }
+    hpm_pdma_cmdlist_record(list, &image, &op);
+    return status_success;
+}
+
+hpm_stat_t hpm_pdma_cmdlist_blit_ex(hpm_pdma_cmdlist_t *list,
+                                    display_buf_t *dst,
+                                    display_buf_t *src,
+                                    pdma_blit_option_t *op)
+{
+    PDMA_Type image;
+    pdma_op_config_t op_config;
+    hpm_stat_t stat;
+
+    stat = hpm_pdma_cmdlist_check(list);
+    if (stat != status_success) {
+        return stat;
+    }
+    stat = pdma_get_blit_ex_config(&image, &op_config, dst, src, op);
+    if (stat != status_success) {
+        return stat;
+    }
+    hpm_pdma_cmdlist_record(list, &image, &op_config);
+    return status_success;
+}
+
+/* called with interrupts disabled or from the PDMA ISR, the PDMA is stopped */
+static void hpm_pdma_cmdlist_start_cmd(hpm_pdma_cmdlist_engine_t *engine, const hpm_pdma_cmd_t *cmd)
+{
+    PDMA_Type *base = engine->base;
+    uint32_t writes = 0;
+
+    for (uint32_t i = 0; i < HPM_PDMA_CMDLIST_REG_CTRL; i++) {
+        if (!engine->shadow_valid || (engine->shadow[i] != cmd->reg[i])) {
+            *hpm_pdma_cmdlist_reg(base, i) = cmd->reg[i];
+            engine->shadow[i] = cmd->reg[i];
+            writes++;
+        }
+    }
+    engine->shadow[HPM_PDMA_CMDLIST_REG_CTRL] = cmd->reg[HPM_PDMA_CMDLIST_REG_CTRL];
+    engine->shadow_valid = true;
+    engine->stat.reg_writes += writes + 1U;
+    engine->stat.reg_skipped += HPM_PDMA_CMDLIST_REG_CTRL - writes;
+
+    base->CTRL = cmd->reg[HPM_PDMA_CMDLIST_REG_CTRL] | HPM_PDMA_CMDLIST_CTRL_IRQ | PDMA_CTRL_PDMA_EN_MASK;
+}
+
+/* called with interrupts disabled or from the PDMA ISR */
+static void hpm_pdma_cmdlist_complete(hpm_pdma_cmdlist_engine_t *engine, hpm_stat_t status)
+{
+    hpm_pdma_cmdlist_t *list = engine->head;
+
+    list->done = engine->index;
+    engine->head = list->next;
+    if (engine->head == NULL) {
+        engine->tail = NULL;
+    }
+    list->next = NULL;
+    engine->index = 0;
+    if (status == status_pdma_done) {
+        engine->stat.lists++;
+    } else {
+        engine->stat.errors++;
+    }
+
+    /* keep the PDMA busy before handing the list back */
+    if (engine->head != NULL) {
+        hpm_pdma_cmdlist_start_cmd(engine, &engine->head->cmds[0]);
+    }
+
+    list->status = status;
+    if (list->callback != NULL) {
+        list->callback(list, list->context);
+    }
+}
+
+hpm_stat_t hpm_pdma_cmdlist_submit(hpm_pdma_cmdlist_engine_t *engine, hpm_pdma_cmdlist_t *list,
+                                   hpm_pdma_cmdlist_callback_t callback, void *context)
+{
+    uint32_t level;
+
+    if (list->count == 0) {
+        return status_invalid_argument;
+    }
+
+    level = HPM_PDMA_CMDLIST_ENTER_CRITICAL();
+    if (list->status == status_pdma_busy) {
+        HPM_PDMA_CMDLIST_EXIT_CRITICAL(level);
+        return status_pdma_busy;
+    }
+    list->callback = callback;
+    list->context = context;
+    list->done = 0;
+    list->next = NULL;
+    list->status = status_pdma_busy;
+
+    if (engine->head == NULL) {
+        /* idle since the last run or programmed by someone else, reset and program every register */
+        pdma_stop(engine->base);
+        engine->shadow_valid = false;
+        engine->head = list;
+        engine->tail = list;
+        engine->index = 0;
+        hpm_pdma_cmdlist_start_cmd(engine, &list->cmds[0]);
+    } else {
+        engine->tail->next = list;
+        engine->tail = list;
+    }
+    HPM_PDMA_CMDLIST_EXIT_CRITICAL(level);
+
+    return status_success;
+}
+
+bool hpm_pdma_cmdlist_is_busy(hpm_pdma_cmdlist_engine_t *engine)
+{
+    return engine->head != NULL;
+}
+
+void hpm_pdma_cmdlist_get_stat(hpm_pdma_cmdlist_engine_t *engine, hpm_pdma_cmdlist_stat_t *stat)
+{
+    uint32_t level = HPM_PDMA_CMDLIST_ENTER_CRITICAL();
+    *stat = engine->stat;
+    HPM_PDMA_CMDLIST_EXIT_CRITICAL(level);
+}
+
+void hpm_pdma_cmdlist_isr_handler(hpm_pdma_cmdlist_engine_t *engine)
+{
+    PDMA_Type *base = engine->base;
+    hpm_pdma_cmdlist_t *list = engine->head;
+    uint32_t stat = base->STAT;
+
+    if (list == NULL) {
+        base->STAT = HPM_PDMA_CMDLIST_STAT_CLEAR;
+        return;
+    }
+
+    if (stat & HPM_PDMA_CMDLIST_ERROR_MASK) {
+        pdma_stop(base);
+        engine->shadow_valid = false;
+        hpm_pdma_cmdlist_complete(engine, status_pdma_error);
+        return;
+    }
+    if ((stat & PDMA_STAT_PDMA_DONE_MASK) == 0) {
+        return;
+    }
+
+    /*
+     * Stop without the software reset. The blocking driver resets in pdma_init() before it
+     * programs every register, the engine does the same when it programs the full set, on
+     * submit and after an error. Between the commands of a run the PDMA has finished cleanly,
+     * clearing EN and the status is enough to start it again, and the registers the next
+     * command does not change must keep their content for the shadow to stay valid.
+     */
+    base->CTRL = engine->shadow[HPM_PDMA_CMDLIST_REG_CTRL];
+    base->STAT = HPM_PDMA_CMDLIST_STAT_CLEAR;
+    engine->stat.cmds++;
+    engine->index++;
+
+    if (engine->index < list->count) {
+        hpm_pdma_cmdlist_start_cmd(engine, &list->cmds[engine->index]);
+    } else {
+        hpm_pdma_cmdlist_complete(engine, status_pdma_done);
+    }
+}
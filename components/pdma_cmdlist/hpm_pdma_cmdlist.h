@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_PDMA_CMDLIST_H
+#define HPM_PDMA_CMDLIST_H
+
+#include "hpm_common.h"
+#include "hpm_soc.h"
+#include "hpm_pdma_drv.h"
+
+/**
+ * @brief PDMA command list
+ *
+ * Fill, blit, scale and flip/rotate operations are recorded into a command
+ * list and executed back to back from the PDMA interrupt, the CPU is only
+ * involved between two operations. Several lists can be queued on one PDMA,
+ * each completes through its own callback.
+ *
+ * Recording validates the parameters and renders the complete register image
+ * of the operation with the pdma_get_*_config() driver functions, so the
+ * interrupt handler only copies registers. It keeps a copy of the registers
+ * it has written and skips the ones an operation does not change, e.g. the
+ * color space coefficients, pitches and the fill color of a row of blits.
+ *
+ * Buffers are accessed by the PDMA: sources must be written back from the
+ * data cache before the list is submitted, destinations must be invalidated
+ * after completion, unless they are placed in noncacheable memory.
+ *
+ * The PDMA interrupt is owned by the application, which forwards it to
+ * hpm_pdma_cmdlist_isr_handler():
+ *
+ *     SDK_DECLARE_EXT_ISR_M(IRQn_PDMA_D0, pdma_isr)
+ *     void pdma_isr(void)
+ *     {
+ *         hpm_pdma_cmdlist_isr_handler(&engine);
+ *     }
+ */
+
+/* Registers programmed by a command */
+#define HPM_PDMA_CMDLIST_REG_COUNT (35U)
+
+/**
+ * @brief Command, the rendered registers of one operation
+ */
+typedef struct {
+    uint32_t reg[HPM_PDMA_CMDLIST_REG_COUNT];
+} hpm_pdma_cmd_t;
+
+struct hpm_pdma_cmdlist;
+
+/**
+ * @brief List completion callback, called from the PDMA interrupt
+ *
+ * @param [in] list completed list, list->status holds the result
+ * @param [in] context callback context
+ */
+typedef void (*hpm_pdma_cmdlist_callback_t)(struct hpm_pdma_cmdlist *list, void *context);
+
+/**
+ * @brief Command list
+ */
+typedef struct hpm_pdma_cmdlist {
+    struct hpm_pdma_cmdlist *next;          /**< queue link, used by the engine */
+    hpm_pdma_cmd_t *cmds;                   /**< command memory */
+    uint32_t capacity;                      /**< number of commands cmds can hold */
+    uint32_t count;                         /**< number of recorded commands */
+    uint32_t done;                          /**< commands executed by the last run */
+    hpm_pdma_cmdlist_callback_t callback;   /**< completion callback, may be NULL */
+    void *context;                          /**< callback context */
+    volatile hpm_stat_t status;             /**< status_pdma_busy while queued, then status_pdma_done or status_pdma_error */
+} hpm_pdma_cmdlist_t;
+
+/**
+ * @brief Engine statistics
+ */
+typedef struct {
+    uint32_t lists;             /**< lists completed */
+    uint32_t cmds;              /**< commands executed */
+    uint32_t errors;            /**< lists aborted by an AXI error */
+    uint32_t reg_writes;        /**< registers written */
+    uint32_t reg_skipped;       /**< register writes skipped as unchanged */
+} hpm_pdma_cmdlist_stat_t;
+
+/**
+ * @brief Engine, one per PDMA instance
+ */
+typedef struct {
+    PDMA_Type *base;                        /**< PDMA base address */
+    hpm_pdma_cmdlist_t *head;               /**< running list */
+    hpm_pdma_cmdlist_t *tail;               /**< last queued list */
+    uint32_t index;                         /**< running command of head */
+    bool shadow_valid;                      /**< shadow matches the registers */
+    uint32_t shadow[HPM_PDMA_CMDLIST_REG_COUNT]; /**< last written register values */
+    hpm_pdma_cmdlist_stat_t stat;           /**< statistics */
+} hpm_pdma_cmdlist_engine_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize an engine
+ *
+ * Stops the PDMA. The PDMA interrupt has to be enabled in the interrupt
+ * controller by the application.
+ *
+ * @param [out] engine engine
+ * @param [in] base PDMA base address
+ */
+void hpm_pdma_cmdlist_engine_init(hpm_pdma_cmdlist_engine_t *engine, PDMA_Type *base);
+
+/**
+ * @brief Initialize an empty command list
+ *
+ * @param [out] list command list
+ * @param [in] cmds command memory
+ * @param [in] capacity number of commands cmds can hold
+ */
+void hpm_pdma_cmdlist_init(hpm_pdma_cmdlist_t *list, hpm_pdma_cmd_t *cmds, uint32_t capacity);
+
+/**
+ * @brief Remove all commands, the list must not be queued
+ *
+ * @param [in] list command list
+ */
+void hpm_pdma_cmdlist_reset(hpm_pdma_cmdlist_t *list);
+
+/**
+ * @brief Record a fill, parameters are the same as pdma_fill_color()
+ *
+ * @retval status_success if the command was recorded
+ * @retval status_invalid_argument if any parameter is invalid
+ * @retval status_fail if the list is full
+ * @retval status_pdma_busy if the list is queued
+ */
+hpm_stat_t hpm_pdma_cmdlist_fill_color(hpm_pdma_cmdlist_t *list, uint32_t dst, uint32_t dst_width,
+                                       uint32_t width, uint32_t height,
+                                       uint32_t color, uint8_t alpha,
+                                       display_pixel_format_t format);
+
+/**
+ * @brief Record a blit, parameters are the same as pdma_blit()
+ *
+ * @retval see hpm_pdma_cmdlist_fill_color()
+ */
+hpm_stat_t hpm_pdma_cmdlist_blit(hpm_pdma_cmdlist_t *list,
+                                 uint32_t dst, uint32_t dst_width,
+                                 uint32_t src, uint32_t src_width,
+                                 uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                 uint8_t alpha,
+                                 display_pixel_format_t format);
+
+/**
+ * @brief Record a scaled blit, parameters are the same as pdma_scale()
+ *
+ * @retval see hpm_pdma_cmdlist_fill_color()
+ */
+hpm_stat_t hpm_pdma_cmdlist_scale(hpm_pdma_cmdlist_t *list,
+                                  uint32_t dst, uint32_t dst_width,
+                                  uint32_t src, uint32_t src_width,
+                                  uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                  uint32_t target_width, uint32_t target_height,
+                                  uint8_t alpha,
+                                  display_pixel_format_t format);
+
+/**
+ * @brief Record a flipped and/or rotated blit, parameters are the same as pdma_flip_rotate()
+ *
+ * @retval see hpm_pdma_cmdlist_fill_color()
+ */
+hpm_stat_t hpm_pdma_cmdlist_flip_rotate(hpm_pdma_cmdlist_t *list, uint32_t dst, uint32_t dst_width,
+                                        uint32_t src, uint32_t src_width, uint32_t x, uint32_t y,
+                                        uint32_t width, uint32_t height,
+                                        pdma_flip_t flip, pdma_rotate_t rotate, uint8_t alpha,
+                                        display_pixel_format_t format);
+
+/**
+ * @brief Record a blit by option, parameters are the same as pdma_blit_ex()
+ *
+ * @retval see hpm_pdma_cmdlist_fill_color()
+ */
+hpm_stat_t hpm_pdma_cmdlist_blit_ex(hpm_pdma_cmdlist_t *list,
+                                    display_buf_t *dst,
+                                    display_buf_t *src,
+                                    pdma_blit_option_t *op);
+
+/**
+ * @brief Queue a command list for execution
+ *
+ * Safe to be called from task and interrupt context. The list starts right
+ * away if the PDMA is idle, otherwise after the lists queued before it. The
+ * list and its buffers must stay valid until completion.
+ *
+ * @param [in] engine engine
+ * @param [in] list command list
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] context callback context
+ *
+ * @retval status_success if the list was queued
+ * @retval status_invalid_argument if the list is empty
+ * @retval status_pdma_busy if the list is already queued
+ */
+hpm_stat_t hpm_pdma_cmdlist_submit(hpm_pdma_cmdlist_engine_t *engine, hpm_pdma_cmdlist_t *list,
+                                   hpm_pdma_cmdlist_callback_t callback, void *context);
+
+/**
+ * @brief Check whether lists are queued or running
+ *
+ * @param [in] engine engine
+ * @return true if the PDMA is executing a list
+ */
+bool hpm_pdma_cmdlist_is_busy(hpm_pdma_cmdlist_engine_t *engine);
+
+/**
+ * @brief Get engine statistics
+ *
+ * @param [in] engine engine
+ * @param [out] stat statistics
+ */
+void hpm_pdma_cmdlist_get_stat(hpm_pdma_cmdlist_engine_t *engine, hpm_pdma_cmdlist_stat_t *stat);
+
+/**
+ * @brief PDMA interrupt handler, call from the PDMA ISR
+ *
+ * Completes the running command and starts the next one, or the first
+ * command of the next queued list.
+ *
+ * @param [in] engine engine
+ */
+void hpm_pdma_cmdlist_isr_handler(hpm_pdma_cmdlist_engine_t *engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_PDMA_CMDLIST_H */
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_pixel_pipe.h"
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+/* YUV to RGB coefficients, Q14 */
+#define HPM_PIXEL_PIPE_COEF_SHIFT (14)
+#define HPM_PIXEL_PIPE_COEF_ROUND (1 << (HPM_PIXEL_PIPE_COEF_SHIFT - 1))
+
+/* RGB565 spread over a word as 00000gggggg00000rrrrr000000bbbbb, leaves headroom above every channel */
+#define HPM_PIXEL_PIPE_565_MASK (0x07E0F81FUL)
+
+typedef struct {
+    int32_t y_scale;
+    int32_t y_offset;
+    int32_t rv;
+    int32_t gu;
+    int32_t gv;
+    int32_t bu;
+} hpm_pixel_pipe_coef_t;
+
+/*****************************************************************************************************************
+ *
+ *  Variables
+ *
+ *****************************************************************************************************************/
+static const hpm_pixel_pipe_coef_t hpm_pixel_pipe_coef_full = {
+    .y_scale = 16384, .y_offset = 0, .rv = 22970, .gu = 5638, .gv = 11700, .bu = 29032,
+};
+
+static const hpm_pixel_pipe_coef_t hpm_pixel_pipe_coef_video = {
+    .y_scale = 19077, .y_offset = 16, .rv = 26149, .gu = 6419, .gv = 13320, .bu = 33050,
+};
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+static inline uint32_t hpm_pixel_pipe_clamp(int32_t v)
+{
+    if ((uint32_t)v <= 255U) {
+        return (uint32_t)v;
+    }
+    return (v < 0) ? 0U : 255U;
+}
+
+static inline uint32_t hpm_pixel_pipe_to_565(uint32_t r, uint32_t g, uint32_t b)
+{
+    return ((r & 0xF8U) << 8) | ((g & 0xFCU) << 3) | (b >> 3);
+}
+
+static inline uint32_t hpm_pixel_pipe_565_expand(uint32_t p)
+{
+    return (p | (p << 16)) & HPM_PIXEL_PIPE_565_MASK;
+}
+
+static inline uint32_t hpm_pixel_pipe_565_compress(uint32_t p)
+{
+    return (p | (p >> 16)) & 0xFFFFU;
+}
+
+/* all three channels of expanded RGB565 pixels in one multiply, w in [0, 32] */
+static inline uint32_t hpm_pixel_pipe_565_lerp(uint32_t a, uint32_t b, uint32_t w)
+{
+    return ((a * (32U - w) + b * w) >> 5) & HPM_PIXEL_PIPE_565_MASK;
+}
+
+/* ARGB8888 as the channel pairs A/G and R/B, w in [0, 256] */
+static inline uint32_t hpm_pixel_pipe_8888_lerp(uint32_t a, uint32_t b, uint32_t w)
+{
+    uint32_t rb = (((a & 0x00FF00FFUL) * (256U - w) + (b & 0x00FF00FFUL) * w) >> 8) & 0x00FF00FFUL;
+    uint32_t ag = (((a >> 8) & 0x00FF00FFUL) * (256U - w) + ((b >> 8) & 0x00FF00FFUL) * w) & 0xFF00FF00UL;
+
+    return ag | rb;
+}
+
+static bool hpm_pixel_pipe_image_is_valid(const hpm_pixel_image_t *img)
+{
+    return (img != NULL) && (img->buf != NULL) && (img->width != 0) && (img->height != 0)
+        && (((uintptr_t)img->buf & 3U) == 0) && ((img->stride & 3U) == 0)
+        && (img->stride >= ((img->width * display_get_pixel_size_in_bit(img->format) + 7U) / 8U));
+}
+
+static bool hpm_pixel_pipe_is_rgb(display_pixel_format_t format)
+{
+    return (format == display_pixel_format_rgb565) || (format == display_pixel_format_argb8888);
+}
+
+static bool hpm_pixel_pipe_is_scalable(display_pixel_format_t format)
+{
+    return hpm_pixel_pipe_is_rgb(format) || (format == display_pixel_format_y8);
+}
+
+/* convert a pixel pair sharing chroma, writes one word for RGB565 and two for ARGB8888 */
+static inline uint32_t *hpm_pixel_pipe_yuv_pair(const hpm_pixel_pipe_coef_t *coef, bool rgb565, uint32_t *out,
+                                                int32_t y0, int32_t y1, int32_t u, int32_t v)
+{
+    int32_t rd, gd, bd;
+    uint32_t r0, g0, b0, r1, g1, b1;
+
+    u -= 128;
+    v -= 128;
+    rd = coef->rv * v + HPM_PIXEL_PIPE_COEF_ROUND;
+    gd = HPM_PIXEL_PIPE_COEF_ROUND - coef->gu * u - coef->gv * v;
+    bd = coef->bu * u + HPM_PIXEL_PIPE_COEF_ROUND;
+    y0 = coef->y_scale * (y0 - coef->y_offset);
+    y1 = coef->y_scale * (y1 - coef->y_offset);
+
+    r0 = hpm_pixel_pipe_clamp((y0 + rd) >> HPM_PIXEL_PIPE_COEF_SHIFT);
+    g0 = hpm_pixel_pipe_clamp((y0 + gd) >> HPM_PIXEL_PIPE_COEF_SHIFT);
+    b0 = hpm_pixel_pipe_clamp((y0 + bd) >> HPM_PIXEL_PIPE_COEF_SHIFT);
+    r1 = hpm_pixel_pipe_clamp((y1 + rd) >> HPM_PIXEL_PIPE_COEF_SHIFT);
+    g1 = hpm_pixel_pipe_clamp((y1 + gd) >> HPM_PIXEL_PIPE_COEF_SHIFT);
+    b1 = hpm_pixel_pipe_clamp((y1 + bd) >> HPM_PIXEL_PIPE_COEF_SHIFT);
+
+    if (rgb565) {
+        *out++ = hpm_pixel_pipe_to_565(r0, g0, b0) | (hpm_pixel_pipe_to_565(r1, g1, b1) << 16);
+    } else {
+        *out++ = 0xFF000000UL | (r0 << 16) | (g0 << 8) | b0;
+        *out++ = 0xFF000000UL | (r1 << 16) | (g1 << 8) | b1;
+    }
+    return out;
+}
+
+hpm_stat_t hpm_pixel_pipe_yuv422_to_rgb(const hpm_pixel_image_t *src, const hpm_pixel_image_t *dst)
+{
+    const hpm_pixel_pipe_coef_t *coef;
+    const uint32_t *s;
+    uint32_t *d;
+    uint32_t w;
+    bool rgb565;
+
+    if (!hpm_pixel_pipe_image_is_valid(src) || !hpm_pixel_pipe_image_is_valid(dst)
+        || ((src->format != display_pixel_format_yuv422) && (src->format != display_pixel_format_ycbcr422))
+        || !hpm_pixel_pipe_is_rgb(dst->format) || (src->width & 1U)
+        || (src->width != dst->width) || (src->height != dst->height)) {
+        return status_invalid_argument;
+    }
+
+    coef = (src->format == display_pixel_format_yuv422) ? &hpm_pixel_pipe_coef_full : &hpm_pixel_pipe_coef_video;
+    rgb565 = (dst->format == display_pixel_format_rgb565);
+
+    for (uint32_t y = 0; y < src->height; y++) {
+        s = (const uint32_t *)((const uint8_t *)src->buf + y * src->stride);
+        d = (uint32_t *)((uint8_t *)dst->buf + y * dst->stride);
+        for (uint32_t x = 0; x < src->width; x += 2) {
+            /* Y0 U Y1 V in one word */
+            w = *s++;
+            d = hpm_pixel_pipe_yuv_pair(coef, rgb565, d, w & 0xFF, (w >> 16) & 0xFF, (w >> 8) & 0xFF, w >> 24);
+        }
+    }
+    return status_success;
+}
+
+hpm_stat_t hpm_pixel_pipe_yuv420p_to_rgb(const hpm_pixel_yuv420p_t *src, const hpm_pixel_image_t *dst)
+{
+    const uint8_t *py;
+    const uint8_t *pu;
+    const uint8_t *pv;
+    uint32_t *d;
+    bool rgb565;
+
+    if ((src == NULL) || (src->y == NULL) || (src->u == NULL) || (src->v == NULL)
+        || (src->width & 1U) || (src->height & 1U) || (src->y_stride < src->width) || (src->uv_stride < (src->width / 2))
+        || !hpm_pixel_pipe_image_is_valid(dst) || !hpm_pixel_pipe_is_rgb(dst->format)
+        || (src->width != dst->width) || (src->height != dst->height)) {
+        return status_invalid_argument;
+    }
+
+    rgb565 = (dst->format == display_pixel_format_rgb565);
+
+    for (uint32_t y = 0; y < src->height; y++) {
+        py = src->y + y * src->y_stride;
+        pu = src->u + (y / 2) * src->uv_stride;
+        pv = src->v + (y / 2) * src->uv_stride;
+        d = (uint32_t *)((uint8_t *)dst->buf + y * dst->stride);
+        for (uint32_t x = 0; x < src->width; x += 2) {
+            d = hpm_pixel_pipe_yuv_pair(&hpm_pixel_pipe_coef_full, rgb565, d, py[0], py[1], *pu++, *pv++);
+            py += 2;
+        }
+    }
+    return status_success;
+}
+
+/* source position of the first destination pixel and the step, Q16, pixel centers aligned */
+static void hpm_pixel_pipe_scale_step(uint32_t src_size, uint32_t dst_size, int32_t *start, int32_t *step)
+{
+    *step = (int32_t)(((uint64_t)src_size << 16) / dst_size);
+    *start = *step / 2 - 0x8000;
+}
+
+static inline uint32_t hpm_pixel_pipe_scale_pos(int32_t pos, uint32_t size, uint32_t *i0, uint32_t *i1)
+{
+    if (pos <= 0) {
+        *i0 = 0;
+        *i1 = 0;
+        return 0;
+    }
+    *i0 = (uint32_t)pos >> 16;
+    if (*i0 >= (size - 1)) {
+        *i0 = size - 1;
+        *i1 = size - 1;
+        return 0;
+    }
+    *i1 = *i0 + 1;
+    return (uint32_t)pos & 0xFFFFU;
+}
+
+static void hpm_pixel_pipe_scale_bilinear(const hpm_pixel_image_t *src, const hpm_pixel_image_t *dst)
+{
+    const uint8_t *s0;
+    const uint8_t *s1;
+    uint8_t *d;
+    int32_t x_start, x_step, y_pos, y_step;
+    int32_t x_pos;
+    uint32_t y0, y1, x0, x1;
+    uint32_t fy, fx;
+    uint32_t top, bottom;
+
+    hpm_pixel_pipe_scale_step(src->width, dst->width, &x_start, &x_step);
+    hpm_pixel_pipe_scale_step(src->height, dst->height, &y_pos, &y_step);
+
+    for (uint32_t dy = 0; dy < dst->height; dy++, y_pos += y_step) {
+        fy = hpm_pixel_pipe_scale_pos(y_pos, src->height, &y0, &y1);
+        s0 = (const uint8_t *)src->buf + y0 * src->stride;
+        s1 = (const uint8_t *)src->buf + y1 * src->stride;
+        d = (uint8_t *)dst->buf + dy * dst->stride;
+        x_pos = x_start;
+
+        switch (src->format) {
+        case display_pixel_format_rgb565:
+            fy >>= 11;
+            for (uint32_t dx = 0; dx < dst->width; dx++, x_pos += x_step) {
+                fx = hpm_pixel_pipe_scale_pos(x_pos, src->width, &x0, &x1) >> 11;
+                top = hpm_pixel_pipe_565_lerp(hpm_pixel_pipe_565_expand(((const uint16_t *)s0)[x0]),
+                                              hpm_pixel_pipe_565_expand(((const uint16_t *)s0)[x1]), fx);
+                bottom = hpm_pixel_pipe_565_lerp(hpm_pixel_pipe_565_expand(((const uint16_t *)s1)[x0]),
+                                                 hpm_pixel_pipe_565_expand(((const uint16_t *)s1)[x1]), fx);
+                ((uint16_t *)d)[dx] = hpm_pixel_pipe_565_compress(hpm_pixel_pipe_565_lerp(top, bottom, fy));
+            }
+            break;
+        case display_pixel_format_argb8888:
+            fy >>= 8;
+            for (uint32_t dx = 0; dx < dst->width; dx++, x_pos += x_step) {
+                fx = hpm_pixel_pipe_scale_pos(x_pos, src->width, &x0, &x1) >> 8;
+                top = hpm_pixel_pipe_8888_lerp(((const uint32_t *)s0)[x0], ((const uint32_t *)s0)[x1], fx);
+                bottom = hpm_pixel_pipe_8888_lerp(((const uint32_t *)s1)[x0], ((const uint32_t *)s1)[x1], fx);
+                ((uint32_t *)d)[dx] = hpm_pixel_pipe_8888_lerp(top, bottom, fy);
+            }
+            break;
+        default:
+            fy >>= 8;
+            for (uint32_t dx = 0; dx < dst->width; dx++, x_pos += x_step) {
+                fx = hpm_pixel_pipe_scale_pos(x_pos, src->width, &x0, &x1) >> 8;
+                top = (s0[x0] * (256U - fx) + s0[x1] * fx) >> 8;
+                bottom = (s1[x0] * (256U - fx) + s1[x1] * fx) >> 8;
+                d[dx] = (top * (256U - fy) + bottom * fy) >> 8;
+            }
+            break;
+        }
+    }
+}
+
+static void hpm_pixel_pipe_scale_area(const hpm_pixel_image_t *src, const hpm_pixel_image_t *dst)
+{
+    const uint8_t *s;
+    uint8_t *d;
+    uint32_t y0, y1, x0, x1;
+    uint32_t sum[4];
+    uint32_t count, p;
+
+    for (uint32_t dy = 0; dy < dst->height; dy++) {
+        y0 = dy * src->height / dst->height;
+        y1 = (dy + 1) * src->height / dst->height;
+        d = (uint8_t *)dst->buf + dy * dst->stride;
+        for (uint32_t dx = 0; dx < dst->width; dx++) {
+            x0 = dx * src->width / dst->width;
+            x1 = (dx + 1) * src->width / dst->width;
+            count = (y1 - y0) * (x1 - x0);
+            memset(sum, 0, sizeof(sum));
+            for (uint32_t y = y0; y < y1; y++) {
+                s = (const uint8_t *)src->buf + y * src->stride;
+                for (uint32_t x = x0; x < x1; x++) {
+                    switch (src->format) {
+                    case display_pixel_format_rgb565:
+                        p = ((const uint16_t *)s)[x];
+                        sum[0] += p & 0x1FU;
+                        sum[1] += (p >> 5) & 0x3FU;
+                        sum[2] += p >> 11;
+                        break;
+                    case display_pixel_format_argb8888:
+                        p = ((const uint32_t *)s)[x];
+                        sum[0] += p & 0xFFU;
+                        sum[1] += (p >> 8) & 0xFFU;
+                        sum[2] += (p >> 16) & 0xFFU;
+                        sum[3] += p >> 24;
+                        break;
+                    default:
+                        sum[0] += s[x];
+                        break;
+                    }
+                }
+            }
+            for (uint32_t i = 0; i < 4; i++) {
+                sum[i] = (sum[i] + count / 2) / count;
+            }
+            switch (src->format) {
+            case display_pixel_format_rgb565:
+                ((uint16_t *)d)[dx] = (sum[2] << 11) | (sum[1] << 5) | sum[0];
+                break;
+            case display_pixel_format_argb8888:
+                ((uint32_t *)d)[dx] = (sum[3] << 24) | (sum[2] << 16) | (sum[1] << 8) | sum[0];
+                break;
+            default:
+                d[dx] = sum[0];
+                break;
+            }
+        }
+    }
+}
+
+hpm_stat_t hpm_pixel_pipe_scale(const hpm_pixel_image_t *src, const hpm_pixel_image_t *dst, hpm_pixel_scale_t filter)
+{
+    if (!hpm_pixel_pipe_image_is_valid(src) || !hpm_pixel_pipe_image_is_valid(dst)
+        || !hpm_pixel_pipe_is_scalable(src->format) || (src->format != dst->format)) {
+        return status_invalid_argument;
+    }
+
+    switch (filter) {
+    case hpm_pixel_scale_bilinear:
+        hpm_pixel_pipe_scale_bilinear(src, dst);
+        break;
+    case hpm_pixel_scale_area:
+        if ((dst->width > src->width) || (dst->height > src->height)) {
+            return status_invalid_argument;
+        }
+        hpm_pixel_pipe_scale_area(src, dst);
+        break;
+    default:
+        return status_invalid_argument;
+    }
+    return status_success;
+}
+
+/* copy n pixels to a destination line, walking the source by step bytes */
+static void hpm_pixel_pipe_gather(uint8_t *d, const uint8_t *s, int32_t step, uint32_t n, uint32_t pixel_size)
+{
+    switch (pixel_size) {
+    case 4:
+        for (uint32_t i = 0; i < n; i++, s += step) {
+            ((uint32_t *)d)[i] = *(const uint32_t *)s;
+        }
+        break;
+    case 2:
+        for (uint32_t i = 0; i < n; i++, s += step) {
+            ((uint16_t *)d)[i] = *(const uint16_t *)s;
+        }
+        break;
+    default:
+        for (uint32_t i = 0; i < n; i++, s += step) {
+            d[i] = *s;
+        }
+        break;
+    }
+}
+
+hpm_stat_t hpm_pixel_pipe_rotate(const hpm_pixel_image_t *src, const hpm_pixel_image_t *dst, hpm_pixel_rotate_t rotate)
+{
+    const uint8_t *s;
+    uint8_t *d;
+    uint32_t pixel_size;
+    uint32_t n;
+    uint32_t tile_end;
+    int32_t step;
+
+    if (!hpm_pixel_pipe_image_is_valid(src) || !hpm_pixel_pipe_image_is_valid(dst)
+        || !hpm_pixel_pipe_is_scalable(src->format) || (src->format != dst->format) || (rotate > hpm_pixel_rotate_270)) {
+        return status_invalid_argument;
+    }
+    if ((rotate == hpm_pixel_rotate_90) || (rotate == hpm_pixel_rotate_270)) {
+        if ((dst->width != src->height) || (dst->height != src->width)) {
+            return status_invalid_argument;
+        }
+    } else if ((dst->width != src->width) || (dst->height != src->height)) {
+        return status_invalid_argument;
+    }
+
+    pixel_size = display_get_pixel_size_in_byte(src->format);
+
+    if (rotate == hpm_pixel_rotate_0) {
+        for (uint32_t y = 0; y < src->height; y++) {
+            memcpy((uint8_t *)dst->buf + y * dst->stride, (const uint8_t *)src->buf + y * src->stride,
+                   src->width * pixel_size);
+        }
+        return status_success;
+    }
+    if (rotate == hpm_pixel_rotate_180) {
+        /* lines are read and written sequentially, no tiling needed */
+        for (uint32_t y = 0; y < src->height; y++) {
+            s = (const uint8_t *)src->buf + (src->height - 1 - y) * src->stride + (src->width - 1) * pixel_size;
+            d = (uint8_t *)dst->buf + y * dst->stride;
+            hpm_pixel_pipe_gather(d, s, -(int32_t)pixel_size, src->width, pixel_size);
+        }
+        return status_success;
+    }
+
+    /*
+     * 90:  dst(x, y) = src(y, H - 1 - x), a destination line walks a source column upwards
+     * 270: dst(x, y) = src(W - 1 - y, x), a destination line walks a source column downwards
+     */
+    step = (rotate == hpm_pixel_rotate_90) ? -(int32_t)src->stride : (int32_t)src->stride;
+    for (uint32_t ty = 0; ty < dst->height; ty += HPM_PIXEL_PIPE_TILE) {
+        tile_end = MIN(ty + HPM_PIXEL_PIPE_TILE, dst->height);
+        for (uint32_t tx = 0; tx < dst->width; tx += HPM_PIXEL_PIPE_TILE) {
+            n = MIN(HPM_PIXEL_PIPE_TILE, dst->width - tx);
+            for (uint32_t y = ty; y < tile_end; y++) {
+                if (rotate == hpm_pixel_rotate_90) {
+                    s = (const uint8_t *)src->buf + (src->height - 1 - tx) * src->stride + y * pixel_size;
+                } else {
+                    s = (const uint8_t *)src->buf + tx * src->stride + (src->width - 1 - y) * pixel_size;
+                }
+                d = (uint8_t *)dst->buf + y * dst->stride + tx * pixel_size;
+                hpm_pixel_pipe_gather(d, s, step, n, pixel_size);
+            }
+        }
+    }
+    return status_success;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_PIXEL_PIPE_H
+#define HPM_PIXEL_PIPE_H
+
+#include "hpm_common.h"
+#include "hpm_display_common.h"
+
+/**
+ * @brief Software pixel pipeline
+ *
+ * CPU fallback for the camera to display path when the PDMA is busy or not
+ * present: YUV to RGB conversion, downscaling and rotation.
+ *
+ * Formats are given as display_pixel_format_t:
+ *  - display_pixel_format_yuv422: packed Y0 U0 Y1 V0, full range BT.601 (JFIF)
+ *  - display_pixel_format_ycbcr422: packed Y0 Cb0 Y1 Cr0, video range BT.601
+ *  - display_pixel_format_rgb565, display_pixel_format_argb8888 and
+ *    display_pixel_format_y8 in the layout the LCDC and PDMA use
+ * Planar YUV 4:2:0 (I420) input is described by hpm_pixel_yuv420p_t.
+ *
+ * The kernels read and write whole words and work on two RGB565 pixels or
+ * the channel pairs of an ARGB8888 pixel per operation, so buffers and line
+ * strides have to be word aligned. Rotation walks the image in tiles of
+ * HPM_PIXEL_PIPE_TILE x HPM_PIXEL_PIPE_TILE pixels to keep both the source
+ * and the destination lines in the data cache.
+ */
+
+/* Tile size of the rotation, in pixels */
+#ifndef HPM_PIXEL_PIPE_TILE
+#define HPM_PIXEL_PIPE_TILE (16U)
+#endif
+
+/**
+ * @brief Image
+ */
+typedef struct {
+    void *buf;                      /**< first pixel, word aligned */
+    uint32_t width;                 /**< width in pixels */
+    uint32_t height;                /**< height in lines */
+    uint32_t stride;                /**< bytes per line, a multiple of 4 */
+    display_pixel_format_t format;  /**< pixel format */
+} hpm_pixel_image_t;
+
+/**
+ * @brief Planar YUV 4:2:0 image, full range BT.601, chroma planes of half width and height
+ */
+typedef struct {
+    const uint8_t *y;
+    const uint8_t *u;
+    const uint8_t *v;
+    uint32_t width;                 /**< width in pixels, even */
+    uint32_t height;                /**< height in lines, even */
+    uint32_t y_stride;              /**< bytes per luma line */
+    uint32_t uv_stride;             /**< bytes per chroma line */
+} hpm_pixel_yuv420p_t;
+
+/**
+ * @brief Scaling filter
+ */
+typedef enum {
+    hpm_pixel_scale_bilinear = 0,   /**< bilinear, any ratio */
+    hpm_pixel_scale_area,           /**< average of the covered source pixels, downscaling only */
+} hpm_pixel_scale_t;
+
+/**
+ * @brief Clockwise rotation
+ */
+typedef enum {
+    hpm_pixel_rotate_0 = 0,
+    hpm_pixel_rotate_90,
+    hpm_pixel_rotate_180,
+    hpm_pixel_rotate_270,
+} hpm_pixel_rotate_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Convert packed YUV 4:2:2 to RGB
+ *
+ * @param [in] src source, display_pixel_format_yuv422 or display_pixel_format_ycbcr422, even width
+ * @param [in] dst destination, display_pixel_format_rgb565 or display_pixel_format_argb8888, same size as src
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the images are not supported
+ */
+hpm_stat_t hpm_pixel_pipe_yuv422_to_rgb(const hpm_pixel_image_t *src, const hpm_pixel_image_t *dst);
+
+/**
+ * @brief Convert planar YUV 4:2:0 to RGB
+ *
+ * @param [in] src source
+ * @param [in] dst destination, display_pixel_format_rgb565 or display_pixel_format_argb8888, same size as src
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the images are not supported
+ */
+hpm_stat_t hpm_pixel_pipe_yuv420p_to_rgb(const hpm_pixel_yuv420p_t *src, const hpm_pixel_image_t *dst);
+
+/**
+ * @brief Scale an image
+ *
+ * @param [in] src source, display_pixel_format_rgb565, display_pixel_format_argb8888 or display_pixel_format_y8
+ * @param [in] dst destination, same format as src
+ * @param [in] filter scaling filter
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the images are not supported, or area scaling would enlarge
+ */
+hpm_stat_t hpm_pixel_pipe_scale(const hpm_pixel_image_t *src, const hpm_pixel_image_t *dst, hpm_pixel_scale_t filter);
+
+/**
+ * @brief Rotate an image
+ *
+ * @param [in] src source, display_pixel_format_rgb565, display_pixel_format_argb8888 or display_pixel_format_y8
+ * @param [in] dst destination, same format as src, width and height swapped for 90 and 270 degrees
+ * @param [in] rotate rotation
+ *
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if the images are not supported
+ */
+hpm_stat_t hpm_pixel_pipe_rotate(const hpm_pixel_image_t *src, const hpm_pixel_image_t *dst, hpm_pixel_rotate_t rotate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_PIXEL_PIPE_H */
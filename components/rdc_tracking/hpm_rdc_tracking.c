@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <math.h>
+#include "hpm_rdc_tracking.h"
+
+/* Smallest channel amplitude the normalization accepts */
+#ifndef HPM_RDC_TRACKING_MIN_AMPLITUDE
+#define HPM_RDC_TRACKING_MIN_AMPLITUDE (1L << 14)
+#endif
+
+#define HPM_RDC_TRACKING_2PI (6.28318530718f)
+#define HPM_RDC_TRACKING_ONE (1L << 28)      /* normalized amplitude */
+
+/* sin(k * pi / 256), Q30 */
+static const int32_t hpm_rdc_tracking_sin_table[129] = {
+    0, 13176464, 26350943, 39521455, 52686014, 65842639,
+    78989349, 92124163, 105245103, 118350194, 131437462, 144504935,
+    157550647, 170572633, 183568930, 196537583, 209476638, 222384147,
+    235258165, 248096755, 260897982, 273659918, 286380643, 299058239,
+    311690799, 324276419, 336813204, 349299266, 361732726, 374111709,
+    386434353, 398698801, 410903207, 423045732, 435124548, 447137835,
+    459083786, 470960600, 482766489, 494499676, 506158392, 517740883,
+    529245404, 540670223, 552013618, 563273883, 574449320, 585538248,
+    596538995, 607449906, 618269338, 628995660, 639627258, 650162530,
+    660599890, 670937767, 681174602, 691308855, 701339000, 711263525,
+    721080937, 730789757, 740388522, 749875788, 759250125, 768510122,
+    777654384, 786681534, 795590213, 804379079, 813046808, 821592095,
+    830013654, 838310216, 846480531, 854523370, 862437520, 870221790,
+    877875009, 885396022, 892783698, 900036924, 907154608, 914135678,
+    920979082, 927683790, 934248793, 940673101, 946955747, 953095785,
+    959092290, 964944360, 970651112, 976211688, 981625251, 986890984,
+    992008094, 996975812, 1001793390, 1006460100, 1010975242, 1015338134,
+    1019548121, 1023604567, 1027506862, 1031254418, 1034846671, 1038283080,
+    1041563127, 1044686319, 1047652185, 1050460278, 1053110176, 1055601479,
+    1057933813, 1060106826, 1062120190, 1063973603, 1065666786, 1067199483,
+    1068571464, 1069782521, 1070832474, 1071721163, 1072448455, 1073014240,
+    1073418433, 1073660973, 1073741824,
+};
+
+/* sine of an angle of 2^32 per turn, Q30, from the quarter wave table */
+static int32_t hpm_rdc_tracking_sin(uint32_t angle)
+{
+    uint32_t x = angle & 0x3FFFFFFFUL;
+    uint32_t idx;
+    int32_t v;
+
+    if ((angle & 0x40000000UL) != 0) {
+        x = 0x40000000UL - x;
+    }
+    idx = x >> 23;
+    v = hpm_rdc_tracking_sin_table[idx];
+    if (idx < 128U) {
+        v += (int32_t)(((int64_t)(hpm_rdc_tracking_sin_table[idx + 1U] - v) * (int32_t)(x & 0x7FFFFFUL)) >> 23);
+    }
+    return ((angle & 0x80000000UL) != 0) ? -v : v;
+}
+
+static inline int32_t hpm_rdc_tracking_clamp(int64_t v, int32_t limit)
+{
+    if (v > limit) {
+        return limit;
+    }
+    if (v < -limit) {
+        return -limit;
+    }
+    return (int32_t)v;
+}
+
+/* v / 2^shift rounded to nearest, a plain shift rounds down and biases the calibration low */
+static inline int32_t hpm_rdc_tracking_shift_round(int32_t v, uint8_t shift)
+{
+    return (shift == 0U) ? v : (int32_t)(((int64_t)v + (1LL << (shift - 1U))) >> shift);
+}
+
+static void hpm_rdc_tracking_set_gain(hpm_rdc_tracking_t *tracking)
+{
+    for (uint8_t ch = 0; ch < 2U; ch++) {
+        if (tracking->amplitude[ch] < HPM_RDC_TRACKING_MIN_AMPLITUDE) {
+            tracking->amplitude[ch] = HPM_RDC_TRACKING_MIN_AMPLITUDE;
+        }
+        tracking->gain[ch] = (int32_t)((1LL << 44) / tracking->amplitude[ch]);
+    }
+}
+
+hpm_stat_t hpm_rdc_tracking_init(hpm_rdc_tracking_t *tracking, const hpm_rdc_tracking_config_t *config)
+{
+    float wn, kp, ki, step;
+
+    if ((config->sample_freq == 0) || (config->bandwidth_hz <= 0.0f) || (config->damping <= 0.0f)
+        || (config->cal_shift > 30U)) {
+        return status_invalid_argument;
+    }
+    /* discrete type II loop, gains per sample */
+    wn = HPM_RDC_TRACKING_2PI * config->bandwidth_hz / (float)config->sample_freq;
+    kp = 2.0f * config->damping * wn;
+    ki = wn * wn;
+    if ((kp >= 1.0f) || (ki >= 1.0f)) {
+        return status_invalid_argument;
+    }
+
+    memset(tracking, 0, sizeof(*tracking));
+    /* error in rad Q28 to phase in 2^64 per turn */
+    tracking->kp = (int64_t)(kp * (68719476736.0f / HPM_RDC_TRACKING_2PI));
+    tracking->ki = (int64_t)(ki * (68719476736.0f / HPM_RDC_TRACKING_2PI));
+    tracking->offset[0] = config->offset_i;
+    tracking->offset[1] = config->offset_q;
+    tracking->amplitude[0] = config->amplitude;
+    tracking->amplitude[1] = config->amplitude;
+    tracking->cal_shift = config->cal_shift;
+    step = config->cal_min_speed_hz / (float)config->sample_freq * 4294967296.0f;
+    tracking->cal_min_step = (step >= 2147483648.0f) ? 0x80000000UL : (uint32_t)step;
+    tracking->sample_freq = (float)config->sample_freq;
+    tracking->signal_lost = true;
+    return status_success;
+}
+
+static void hpm_rdc_tracking_seed(hpm_rdc_tracking_t *tracking, int32_t sin_in, int32_t cos_in)
+{
+    float x = (float)(cos_in - tracking->offset[1]);
+    float y = (float)(sin_in - tracking->offset[0]);
+    float amplitude = sqrtf(x * x + y * y);
+
+    if (tracking->amplitude[0] == 0) {
+        if (amplitude < (float)HPM_RDC_TRACKING_MIN_AMPLITUDE) {
+            return;
+        }
+        tracking->amplitude[0] = (int32_t)amplitude;
+        tracking->amplitude[1] = (int32_t)amplitude;
+    }
+    hpm_rdc_tracking_set_gain(tracking);
+    /* atan2f() returns up to pi, a half turn of 2^31 does not fit int32_t, wrap it through int64_t */
+    tracking->theta = (uint64_t)(uint32_t)(int64_t)(atan2f(y, x) / HPM_RDC_TRACKING_2PI * 4294967296.0f) << 32;
+    tracking->omega = 0;
+    tracking->seeded = true;
+}
+
+void hpm_rdc_tracking_update(hpm_rdc_tracking_t *tracking, int32_t sin_in, int32_t cos_in)
+{
+    int32_t in[2];
+    int32_t ref[2];
+    int32_t n[2];
+    int32_t err, r;
+    int64_t mag;
+    uint32_t angle;
+    int32_t step;
+
+    if (!tracking->seeded) {
+        hpm_rdc_tracking_seed(tracking, sin_in, cos_in);
+        if (!tracking->seeded) {
+            return;
+        }
+    }
+
+    in[0] = sin_in;
+    in[1] = cos_in;
+    /* predict this sample, then correct the prediction by the error */
+    tracking->theta += (uint64_t)tracking->omega;
+    angle = (uint32_t)(tracking->theta >> 32);
+    ref[0] = hpm_rdc_tracking_sin(angle);
+    ref[1] = hpm_rdc_tracking_sin(angle + 0x40000000UL);
+
+    for (uint8_t ch = 0; ch < 2U; ch++) {
+        n[ch] = hpm_rdc_tracking_clamp(((int64_t)(in[ch] - tracking->offset[ch]) * tracking->gain[ch]) >> 16,
+                                       4 * HPM_RDC_TRACKING_ONE);
+    }
+    mag = (int64_t)n[0] * n[0] + (int64_t)n[1] * n[1];
+    tracking->signal_lost = (mag < (1LL << 54)) || (mag > (1LL << 58));
+
+    /* sin(theta - estimate) = sin * cos(estimate) - cos * sin(estimate) */
+    err = hpm_rdc_tracking_clamp(((int64_t)n[0] * ref[1] - (int64_t)n[1] * ref[0]) >> 30, HPM_RDC_TRACKING_ONE);
+    tracking->omega += err * tracking->ki;
+    tracking->theta += (uint64_t)(err * tracking->kp);
+
+    if ((tracking->cal_shift == 0) || tracking->signal_lost) {
+        return;
+    }
+    step = (int32_t)(tracking->omega >> 32);
+    if ((uint32_t)((step < 0) ? -step : step) <= tracking->cal_min_step) {
+        return;
+    }
+    /* move offset and amplitude towards the residual of the predicted input */
+    for (uint8_t ch = 0; ch < 2U; ch++) {
+        r = in[ch] - tracking->offset[ch] - (int32_t)(((int64_t)tracking->amplitude[ch] * ref[ch]) >> 30);
+        tracking->offset[ch] += hpm_rdc_tracking_shift_round(r, tracking->cal_shift);
+        /* the reference squared averages to one half */
+        tracking->amplitude[ch] += hpm_rdc_tracking_shift_round((int32_t)(((int64_t)r * ref[ch]) >> 30),
+                                                                tracking->cal_shift - 1U);
+    }
+    if (++tracking->gain_count >= HPM_RDC_TRACKING_GAIN_UPDATE) {
+        tracking->gain_count = 0;
+        hpm_rdc_tracking_set_gain(tracking);
+    }
+}
+
+float hpm_rdc_tracking_get_theta(hpm_rdc_tracking_t *tracking)
+{
+    return (float)hpm_rdc_tracking_get_angle(tracking) * (HPM_RDC_TRACKING_2PI / 4294967296.0f);
+}
+
+float hpm_rdc_tracking_get_speed(hpm_rdc_tracking_t *tracking)
+{
+    return (float)hpm_rdc_tracking_get_velocity(tracking) * (HPM_RDC_TRACKING_2PI / 4294967296.0f)
+           * tracking->sample_freq;
+}
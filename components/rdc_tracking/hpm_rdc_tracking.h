@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_RDC_TRACKING_H
+#define HPM_RDC_TRACKING_H
+
+#include "hpm_common.h"
+#include "hpm_rdc_drv.h"
+
+/**
+ * @brief Resolver tracking observer
+ *
+ * A type II phase locked loop turns the demodulated sine and cosine of the
+ * RDC accumulators into angle and velocity without an arctangent per sample.
+ * The loop runs in fixed point: the angle is a 64-bit phase where a full turn
+ * wraps the counter, sine and cosine of the estimate come from a quarter wave
+ * table, and the only multiplications are 32x32 to 64 bit. Call
+ * hpm_rdc_tracking_update() once per accumulator result, e.g. from the
+ * current loop interrupt.
+ *
+ * Channel offsets and amplitudes are tracked while the rotor turns faster
+ * than a configured speed: the observer compares each input with the value
+ * the estimated angle predicts and moves the offset and amplitude towards the
+ * residual. At standstill they are not observable and are held.
+ *
+ * The first sample seeds the angle, and the amplitude if not configured, with
+ * one floating point arctangent so the loop starts locked.
+ */
+
+/* Samples between two refreshes of the amplitude normalization */
+#ifndef HPM_RDC_TRACKING_GAIN_UPDATE
+#define HPM_RDC_TRACKING_GAIN_UPDATE (256U)
+#endif
+
+/**
+ * @brief Observer configuration
+ */
+typedef struct {
+    uint32_t sample_freq;           /**< Hz, rate of hpm_rdc_tracking_update() */
+    float bandwidth_hz;             /**< loop natural frequency */
+    float damping;                  /**< loop damping, e.g. 0.707 */
+    int32_t offset_i;               /**< initial channel offsets */
+    int32_t offset_q;
+    int32_t amplitude;              /**< initial channel amplitude, 0 to measure it from the first sample */
+    uint8_t cal_shift;              /**< calibration step 2^-cal_shift, 0 to hold offsets and amplitudes */
+    float cal_min_speed_hz;         /**< turns per second above which calibration runs */
+} hpm_rdc_tracking_config_t;
+
+/**
+ * @brief Observer state
+ */
+typedef struct {
+    uint64_t theta;                 /**< angle, 2^64 per turn */
+    int64_t omega;                  /**< velocity, 2^64 per turn per sample */
+    int64_t kp;                     /**< loop gains for a Q28 error in rad */
+    int64_t ki;
+    int32_t offset[2];              /**< sine, cosine channel */
+    int32_t amplitude[2];
+    int32_t gain[2];                /**< 2^44 / amplitude */
+    uint32_t cal_min_step;          /**< velocity above which calibration runs, 2^32 per turn per sample */
+    uint16_t gain_count;
+    uint8_t cal_shift;
+    bool seeded;
+    bool signal_lost;               /**< normalized magnitude outside 0.5 to 2 on the last sample */
+    float sample_freq;
+} hpm_rdc_tracking_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize an observer
+ *
+ * @param [out] tracking observer
+ * @param [in] config configuration
+ * @retval status_invalid_argument if the bandwidth is out of range for the sample rate
+ */
+hpm_stat_t hpm_rdc_tracking_init(hpm_rdc_tracking_t *tracking, const hpm_rdc_tracking_config_t *config);
+
+/**
+ * @brief Run the observer on one sample
+ *
+ * @param [in] tracking observer
+ * @param [in] sin_in sine channel accumulator
+ * @param [in] cos_in cosine channel accumulator
+ */
+void hpm_rdc_tracking_update(hpm_rdc_tracking_t *tracking, int32_t sin_in, int32_t cos_in);
+
+/**
+ * @brief Run the observer on the current RDC accumulators
+ *
+ * @param [in] tracking observer
+ * @param [in] ptr RDC base address, the I channel carries the sine
+ */
+static inline void hpm_rdc_tracking_update_from_rdc(hpm_rdc_tracking_t *tracking, RDC_Type *ptr)
+{
+    hpm_rdc_tracking_update(tracking, (int32_t)rdc_get_acc_avl(ptr, rdc_acc_chn_i),
+                            (int32_t)rdc_get_acc_avl(ptr, rdc_acc_chn_q));
+}
+
+/**
+ * @brief Get the angle
+ *
+ * @param [in] tracking observer
+ * @retval angle, 2^32 per turn
+ */
+static inline uint32_t hpm_rdc_tracking_get_angle(hpm_rdc_tracking_t *tracking)
+{
+    return (uint32_t)(tracking->theta >> 32);
+}
+
+/**
+ * @brief Get the velocity
+ *
+ * @param [in] tracking observer
+ * @retval velocity, 2^32 per turn per sample
+ */
+static inline int32_t hpm_rdc_tracking_get_velocity(hpm_rdc_tracking_t *tracking)
+{
+    return (int32_t)(tracking->omega >> 32);
+}
+
+/**
+ * @brief Get the angle in rad, e.g. for the get_theta callback of the hpm_mcl_v2 encoder
+ *
+ * @param [in] tracking observer
+ * @retval angle, 0 to 2 pi
+ */
+float hpm_rdc_tracking_get_theta(hpm_rdc_tracking_t *tracking);
+
+/**
+ * @brief Get the velocity in rad/s, e.g. for the process_by_user callback of the hpm_mcl_v2 encoder
+ *
+ * @param [in] tracking observer
+ * @retval velocity
+ */
+float hpm_rdc_tracking_get_speed(hpm_rdc_tracking_t *tracking);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_RDC_TRACKING_H */
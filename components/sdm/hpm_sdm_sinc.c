@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_sdm_sinc.h"
+
+hpm_stat_t hpm_sdm_sinc_init(hpm_sdm_sinc_t *f, uint8_t order, uint16_t ratio)
+{
+    uint64_t gain = 1;
+
+    if ((order == 0) || (order > HPM_SDM_SINC_MAX_ORDER) || (ratio < 2U)) {
+        return status_invalid_argument;
+    }
+    for (uint8_t i = 0; i < order; i++) {
+        gain *= ratio;
+    }
+    if (gain > (1ULL << 31)) {
+        return status_invalid_argument;
+    }
+    memset(f, 0, sizeof(*f));
+    f->order = order;
+    f->ratio = ratio;
+    f->offset = (uint32_t)(gain / 2U);
+    return status_success;
+}
+
+/*
+ * Called with a constant order so that every order gets its own loop with
+ * the state in registers and no per bit branch on the order.
+ */
+static inline ATTR_ALWAYS_INLINE uint32_t hpm_sdm_sinc_run(hpm_sdm_sinc_t *f, const uint8_t *bits, uint32_t bit_count,
+                                                           int32_t *out, const uint32_t order)
+{
+    uint32_t integ[HPM_SDM_SINC_MAX_ORDER];
+    uint32_t ratio = f->ratio;
+    uint32_t phase = f->phase;
+    uint32_t n = 0;
+    uint32_t x, y, t;
+
+    for (uint32_t s = 0; s < order; s++) {
+        integ[s] = f->integ[s];
+    }
+    for (uint32_t i = 0; i < bit_count; i++) {
+        x = (bits[i >> 3] >> (7U - (i & 7U))) & 1U;
+        integ[0] += x;
+        for (uint32_t s = 1; s < order; s++) {
+            integ[s] += integ[s - 1U];
+        }
+        if (++phase < ratio) {
+            continue;
+        }
+        phase = 0;
+        y = integ[order - 1U];
+        for (uint32_t s = 0; s < order; s++) {
+            t = y;
+            y -= f->comb[s];
+            f->comb[s] = t;
+        }
+        out[n++] = (int32_t)(y - f->offset);
+    }
+    for (uint32_t s = 0; s < order; s++) {
+        f->integ[s] = integ[s];
+    }
+    f->phase = phase;
+    return n;
+}
+
+uint32_t hpm_sdm_sinc_process(hpm_sdm_sinc_t *f, const uint8_t *bits, uint32_t bit_count, int32_t *out)
+{
+    switch (f->order) {
+    case 1:
+        return hpm_sdm_sinc_run(f, bits, bit_count, out, 1U);
+    case 2:
+        return hpm_sdm_sinc_run(f, bits, bit_count, out, 2U);
+    case 3:
+        return hpm_sdm_sinc_run(f, bits, bit_count, out, 3U);
+    case 4:
+        return hpm_sdm_sinc_run(f, bits, bit_count, out, 4U);
+    default:
+        return hpm_sdm_sinc_run(f, bits, bit_count, out, 5U);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef HPM_SDM_SINC_H
+#define HPM_SDM_SINC_H
+
+#include "hpm_common.h"
+
+/**
+ * @brief Software sinc decimator
+ *
+ * Demodulates a raw sigma-delta bitstream, e.g. captured by SPI or by the
+ * SDM in a mode the hardware filter does not cover, such as sinc4 and sinc5.
+ * The bits are packed MSB first. Integrators and combs wrap modulo 2^32,
+ * which is exact as long as ratio ^ order fits, so no saturation is needed.
+ * An output is ratio ^ order times the mean of the last bits, centered on
+ * zero: all ones give +ratio ^ order / 2 and all zeros -ratio ^ order / 2.
+ */
+
+#define HPM_SDM_SINC_MAX_ORDER (5U)
+
+/**
+ * @brief Sinc decimator
+ */
+typedef struct {
+    uint32_t integ[HPM_SDM_SINC_MAX_ORDER];
+    uint32_t comb[HPM_SDM_SINC_MAX_ORDER];
+    uint32_t offset;                /**< ratio ^ order / 2 */
+    uint16_t ratio;
+    uint16_t phase;
+    uint8_t order;
+} hpm_sdm_sinc_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize a sinc decimator
+ *
+ * @param [out] f decimator
+ * @param [in] order 1 - HPM_SDM_SINC_MAX_ORDER
+ * @param [in] ratio decimation ratio, ratio ^ order not above 2^31
+ * @retval status_invalid_argument if the order or the ratio is out of range
+ */
+hpm_stat_t hpm_sdm_sinc_init(hpm_sdm_sinc_t *f, uint8_t order, uint16_t ratio);
+
+/**
+ * @brief Decimate a bitstream
+ *
+ * @param [in,out] f decimator
+ * @param [in] bits bitstream, MSB first
+ * @param [in] bit_count number of bits
+ * @param [out] out bit_count / ratio outputs, one more at most
+ * @retval number of outputs
+ */
+uint32_t hpm_sdm_sinc_process(hpm_sdm_sinc_t *f, const uint8_t *bits, uint32_t bit_count, int32_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_SDM_SINC_H */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_sdm_stream.h"
+#include "hpm_csr_drv.h"
+
+#define HPM_SDM_STREAM_CMP_EVENTS (SDM_CH_SCST_HZ_MASK | SDM_CH_SCST_MF_MASK | SDM_CH_SCST_CMPH_MASK | SDM_CH_SCST_CMPL_MASK)
+#define HPM_SDM_STREAM_ERRORS (SDM_CH_SDST_DOV_ERR_MASK | SDM_CH_SDST_DSAT_ERR_MASK)
+
+hpm_stat_t hpm_sdm_stream_init(hpm_sdm_stream_t *stream, const hpm_sdm_stream_config_t *config)
+{
+    if ((config->ptr == NULL) || (config->ch_mask == 0) || ((config->ch_mask >> HPM_SDM_STREAM_CHANNELS) != 0)
+        || (config->block_len == 0) || (config->block_count < 2U) || (config->block_count > HPM_SDM_STREAM_MAX_BLOCKS)
+        || ((config->block_count & (config->block_count - 1U)) != 0)) {
+        return status_invalid_argument;
+    }
+    for (uint8_t ch = 0; ch < HPM_SDM_STREAM_CHANNELS; ch++) {
+        if (((config->ch_mask & (1U << ch)) != 0) && (config->buf[ch] == NULL)) {
+            return status_invalid_argument;
+        }
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->ptr = config->ptr;
+    stream->ch_mask = config->ch_mask;
+    stream->block_count = config->block_count;
+    stream->block_len = config->block_len;
+    for (uint8_t ch = 0; ch < HPM_SDM_STREAM_CHANNELS; ch++) {
+        stream->ch[ch].buf = config->buf[ch];
+    }
+    stream->get_timestamp = config->get_timestamp;
+    stream->event_callback = config->event_callback;
+    stream->cb_context = config->cb_context;
+    return status_success;
+}
+
+static void hpm_sdm_stream_drain(hpm_sdm_stream_t *stream, uint8_t ch, uint32_t timestamp)
+{
+    hpm_sdm_stream_channel_t *c = &stream->ch[ch];
+    uint32_t index;
+    uint32_t want;
+    uint32_t n;
+    int32_t scratch[16];
+
+    while (true) {
+        if (c->head - c->tail >= stream->block_count) {
+            /* ring full: empty the FIFO anyway so that it keeps running */
+            while ((n = sdm_read_fifo_data(stream->ptr, ch, scratch, ARRAY_SIZE(scratch))) != 0) {
+                c->dropped += n;
+            }
+            return;
+        }
+        index = c->head & (stream->block_count - 1U);
+        if (c->fill == 0) {
+            c->timestamp[index] = timestamp;
+        }
+        want = stream->block_len - c->fill;
+        n = sdm_read_fifo_data(stream->ptr, ch, &c->buf[index * stream->block_len + c->fill], want);
+        c->fill += n;
+        if (c->fill == stream->block_len) {
+            c->fill = 0;
+            c->head = c->head + 1U;
+        }
+        if (n < want) {
+            return;
+        }
+    }
+}
+
+void hpm_sdm_stream_isr_handler(hpm_sdm_stream_t *stream)
+{
+    SDM_Type *ptr = stream->ptr;
+    uint32_t timestamp = (stream->get_timestamp != NULL) ? stream->get_timestamp() : read_csr(CSR_MCYCLE);
+    uint32_t status;
+
+    for (uint8_t ch = 0; ch < HPM_SDM_STREAM_CHANNELS; ch++) {
+        if ((stream->ch_mask & (1U << ch)) == 0) {
+            continue;
+        }
+        /* comparator events first, they are the latency critical part */
+        status = ptr->CH[ch].SCST & HPM_SDM_STREAM_CMP_EVENTS;
+        if (status != 0) {
+            ptr->CH[ch].SCST = status;
+            stream->ch[ch].events++;
+            if (stream->event_callback != NULL) {
+                stream->event_callback(stream, ch, status, stream->cb_context);
+            }
+        }
+        status = ptr->CH[ch].SDST & HPM_SDM_STREAM_ERRORS;
+        if (status != 0) {
+            ptr->CH[ch].SDST = status;
+            stream->ch[ch].errors++;
+        }
+        hpm_sdm_stream_drain(stream, ch, timestamp);
+    }
+}
+
+const hpm_sdm_stream_block_t *hpm_sdm_stream_get_block(hpm_sdm_stream_t *stream, uint8_t ch)
+{
+    hpm_sdm_stream_channel_t *c = &stream->ch[ch];
+    uint32_t tail = c->tail;
+    uint32_t index;
+
+    if (c->head == tail) {
+        return NULL;
+    }
+    index = tail & (stream->block_count - 1U);
+    c->block.samples = &c->buf[index * stream->block_len];
+    c->block.count = stream->block_len;
+    c->block.timestamp = c->timestamp[index];
+    c->block.index = tail;
+    return &c->block;
+}
+
+void hpm_sdm_stream_release(hpm_sdm_stream_t *stream, uint8_t ch)
+{
+    hpm_sdm_stream_channel_t *c = &stream->ch[ch];
+
+    if (c->head != c->tail) {
+        c->tail = c->tail + 1U;
+    }
+}
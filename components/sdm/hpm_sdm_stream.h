@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef HPM_SDM_STREAM_H
+#define HPM_SDM_STREAM_H
+
+#include "hpm_sdm_drv.h"
+
+/**
+ * @brief Multi-channel SDM streaming
+ *
+ * The SDM interrupt drains the filter FIFO of every streamed channel into a
+ * ring of fixed size blocks per channel, so the FIFO threshold interrupt
+ * rather than a per-sample read paces the CPU. Each block carries the
+ * timestamp of the drain that read its first sample. A task takes complete
+ * blocks with hpm_sdm_stream_get_block() and hands them back with
+ * hpm_sdm_stream_release(); samples that find the ring full are dropped and
+ * counted. The same interrupt reports comparator events, e.g. overcurrent,
+ * to a hook before any sample is stored.
+ *
+ * The filters run in 32-bit output mode with the FIFO threshold interrupt
+ * enabled, and the comparator interrupts of interest are enabled by the
+ * caller with the driver API.
+ */
+
+#define HPM_SDM_STREAM_CHANNELS (4U)
+
+#ifndef HPM_SDM_STREAM_MAX_BLOCKS
+#define HPM_SDM_STREAM_MAX_BLOCKS (8U)
+#endif
+
+struct hpm_sdm_stream;
+
+/**
+ * @brief Comparator event hook, called from the SDM interrupt
+ *
+ * @param event sdm_comparator_event_t flags
+ */
+typedef void (*hpm_sdm_stream_event_cb_t)(struct hpm_sdm_stream *stream, uint8_t ch, uint32_t event, void *cb_context);
+
+/**
+ * @brief Timestamp source, e.g. a free running timer counter
+ */
+typedef uint32_t (*hpm_sdm_stream_timestamp_t)(void);
+
+/**
+ * @brief Stream configuration
+ */
+typedef struct {
+    SDM_Type *ptr;
+    uint8_t ch_mask;                /**< bit n streams channel n */
+    uint16_t block_len;             /**< samples per block */
+    uint8_t block_count;            /**< blocks per channel, a power of 2 up to HPM_SDM_STREAM_MAX_BLOCKS */
+    int32_t *buf[HPM_SDM_STREAM_CHANNELS];  /**< block_count * block_len samples per streamed channel */
+    hpm_sdm_stream_timestamp_t get_timestamp;   /**< NULL for the low word of the core cycle counter */
+    hpm_sdm_stream_event_cb_t event_callback;   /**< NULL to ignore comparator events */
+    void *cb_context;
+} hpm_sdm_stream_config_t;
+
+/**
+ * @brief Block of samples of one channel
+ */
+typedef struct {
+    const int32_t *samples;
+    uint32_t count;
+    uint32_t timestamp;             /**< drain that read the first sample */
+    uint32_t index;                 /**< number of the block since start */
+} hpm_sdm_stream_block_t;
+
+/**
+ * @brief Channel ring
+ */
+typedef struct {
+    int32_t *buf;
+    volatile uint32_t head;         /**< blocks completed, free running */
+    volatile uint32_t tail;         /**< blocks released, free running */
+    uint32_t fill;                  /**< samples in the block being written */
+    uint32_t timestamp[HPM_SDM_STREAM_MAX_BLOCKS];
+    hpm_sdm_stream_block_t block;
+    uint32_t dropped;               /**< samples lost because the ring was full */
+    uint32_t errors;                /**< FIFO overflows and CIC saturations */
+    uint32_t events;                /**< comparator events */
+} hpm_sdm_stream_channel_t;
+
+/**
+ * @brief Stream
+ */
+typedef struct hpm_sdm_stream {
+    SDM_Type *ptr;
+    uint8_t ch_mask;
+    uint8_t block_count;
+    uint16_t block_len;
+    hpm_sdm_stream_channel_t ch[HPM_SDM_STREAM_CHANNELS];
+    hpm_sdm_stream_timestamp_t get_timestamp;
+    hpm_sdm_stream_event_cb_t event_callback;
+    void *cb_context;
+} hpm_sdm_stream_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize a stream
+ *
+ * @note The module and the channels are configured and enabled by the caller.
+ *
+ * @param [out] stream stream
+ * @param [in] config configuration
+ * @retval status_invalid_argument if a channel has no buffer or the block layout is out of range
+ */
+hpm_stat_t hpm_sdm_stream_init(hpm_sdm_stream_t *stream, const hpm_sdm_stream_config_t *config);
+
+/**
+ * @brief Drain the FIFOs and dispatch comparator events, call this function in SDM isr
+ *
+ * @param [in] stream stream
+ */
+void hpm_sdm_stream_isr_handler(hpm_sdm_stream_t *stream);
+
+/**
+ * @brief Get the oldest complete block of a channel
+ *
+ * @param [in] stream stream
+ * @param [in] ch channel index
+ * @retval block, valid until hpm_sdm_stream_release(), or NULL if none is complete
+ */
+const hpm_sdm_stream_block_t *hpm_sdm_stream_get_block(hpm_sdm_stream_t *stream, uint8_t ch);
+
+/**
+ * @brief Hand the oldest block of a channel back to the ring
+ *
+ * @param [in] stream stream
+ * @param [in] ch channel index
+ */
+void hpm_sdm_stream_release(hpm_sdm_stream_t *stream, uint8_t ch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_SDM_STREAM_H */
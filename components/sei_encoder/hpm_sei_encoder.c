@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_sei_encoder.h"
+
+#define HPM_SEI_ENCODER_INSTR_SLOTS (ARRAY_SIZE(((SEI_Type *)0)->INSTR))
+
+static hpm_stat_t hpm_sei_encoder_latch_init(SEI_Type *ptr, uint8_t ctrl, uint8_t latch_idx,
+                                             const hpm_sei_encoder_latch_t *latch, uint8_t instr_count,
+                                             uint8_t instr_base, uint32_t src_clk_freq)
+{
+    sei_state_transition_config_t tran;
+    sei_state_transition_latch_config_t latch_config;
+    uint32_t delay = (uint32_t)(((uint64_t)latch->delay_ns * src_clk_freq) / 1000000000UL);
+
+    if (delay > 0xFFFFU) {
+        return status_invalid_argument;
+    }
+    for (uint8_t i = 0; i < 4U; i++) {
+        tran = latch->tran[i];
+        if (!tran.disable_instr_ptr_check) {
+            if (tran.instr_ptr_value >= instr_count) {
+                return status_invalid_argument;
+            }
+            tran.instr_ptr_value += instr_base;
+        }
+        sei_state_transition_config_init(ptr, ctrl, latch_idx, SEI_CTRL_LATCH_TRAN_0_1 + i, &tran);
+    }
+    latch_config.enable = true;
+    latch_config.output_select = latch->output_select;
+    latch_config.delay = (uint16_t)delay;
+    sei_state_transition_latch_config_init(ptr, ctrl, latch_idx, &latch_config);
+    return status_success;
+}
+
+/* a JUMP may only go through the engine pointers set up here, they move with instr_base */
+static bool hpm_sei_encoder_program_valid(const hpm_sei_encoder_protocol_t *protocol)
+{
+    uint32_t opr;
+
+    for (uint8_t i = 0; i < protocol->instr_count; i++) {
+        if (SEI_INSTR_OP_GET(protocol->instr[i]) == SEI_INSTR_OP_JUMP) {
+            opr = SEI_INSTR_OPR_GET(protocol->instr[i]);
+            if ((opr != SEI_JUMP_INIT_INSTR_IDX) && (opr != SEI_JUMP_WDG_INSTR_IDX)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+hpm_stat_t hpm_sei_encoder_init(hpm_sei_encoder_t *encoder, SEI_Type *ptr, uint8_t ctrl,
+                                const hpm_sei_encoder_protocol_t *protocol, const hpm_sei_encoder_config_t *config)
+{
+    sei_tranceiver_config_t tranceiver_config = {0};
+    sei_data_format_config_t format;
+    sei_sample_config_t sample_config = {0};
+    sei_update_config_t update_config = {0};
+    sei_engine_config_t engine_config = {0};
+    sei_trigger_input_config_t trigger_config = {0};
+    uint8_t base = config->instr_base;
+    uint16_t point;
+    hpm_stat_t stat;
+
+    if ((protocol->instr_count == 0) || (((uint32_t)base + protocol->instr_count) > HPM_SEI_ENCODER_INSTR_SLOTS)
+        || (protocol->wdg_instr_idx >= protocol->instr_count) || (protocol->pos_bits == 0)
+        || (((uint32_t)protocol->pos_lsb + protocol->pos_bits) > 32U) || !hpm_sei_encoder_program_valid(protocol)) {
+        return status_invalid_argument;
+    }
+
+    sei_set_engine_enable(ptr, ctrl, false);
+
+    /* transceiver */
+    tranceiver_config.mode = protocol->mode;
+    tranceiver_config.src_clk_freq = config->src_clk_freq;
+    tranceiver_config.synchronous_master_config = protocol->synchronous_master_config;
+    tranceiver_config.asynchronous_config = protocol->asynchronous_config;
+    if (config->baudrate != 0) {
+        tranceiver_config.synchronous_master_config.baudrate = config->baudrate;
+        tranceiver_config.asynchronous_config.baudrate = config->baudrate;
+    }
+    stat = sei_tranceiver_config_init(ptr, ctrl, &tranceiver_config);
+    if (stat != status_success) {
+        return stat;
+    }
+    if (protocol->mode == sei_synchronous_master_mode) {
+        point = sei_get_xcvr_ck0_point(ptr, ctrl);
+        sei_set_xcvr_rx_point(ptr, ctrl, point);
+        sei_set_xcvr_tx_point(ptr, ctrl, protocol->tx_at_ck1 ? sei_get_xcvr_ck1_point(ptr, ctrl) : point);
+    }
+
+    /* command and data registers */
+    if (protocol->cmd_format != NULL) {
+        format = *protocol->cmd_format;
+        sei_cmd_data_format_config_init(ptr, SEI_SELECT_CMD, ctrl, &format);
+        sei_set_command_value(ptr, ctrl, protocol->cmd_value);
+        sei_set_trig_input_command_value(ptr, ctrl, sei_trig_in_period, protocol->cmd_value);
+    }
+    for (uint8_t i = 0; i < protocol->data_reg_count; i++) {
+        format = protocol->data_regs[i].format;
+        sei_cmd_data_format_config_init(ptr, SEI_SELECT_DATA, protocol->data_regs[i].idx, &format);
+        sei_set_data_value(ptr, protocol->data_regs[i].idx, protocol->data_regs[i].init_value);
+    }
+
+    /* the program is already encoded */
+    for (uint8_t i = 0; i < protocol->instr_count; i++) {
+        ptr->INSTR[base + i] = protocol->instr[i];
+    }
+
+    /* latches */
+    stat = hpm_sei_encoder_latch_init(ptr, ctrl, SEI_LATCH_0, &protocol->sample_latch, protocol->instr_count,
+                                      base, config->src_clk_freq);
+    if (stat != status_success) {
+        return stat;
+    }
+    stat = hpm_sei_encoder_latch_init(ptr, ctrl, SEI_LATCH_1, &protocol->update_latch, protocol->instr_count,
+                                      base, config->src_clk_freq);
+    if (stat != status_success) {
+        return stat;
+    }
+    sample_config.latch_select = SEI_LATCH_0;
+    sei_sample_config_init(ptr, ctrl, &sample_config);
+    update_config.pos_data_idx = protocol->pos_data_idx;
+    update_config.pos_data_use_rx = true;
+    update_config.data_register_select = 1UL << protocol->pos_data_idx;
+    if (protocol->rev_data_idx != SEI_DAT_0) {
+        update_config.rev_data_idx = protocol->rev_data_idx;
+        update_config.rev_data_use_rx = true;
+        update_config.data_register_select |= 1UL << protocol->rev_data_idx;
+    }
+    update_config.update_on_err = false;
+    update_config.latch_select = SEI_LATCH_1;
+    sei_update_config_init(ptr, ctrl, &update_config);
+
+    if (config->irq_mask != 0) {
+        sei_set_irq_enable(ptr, ctrl, config->irq_mask, true);
+    }
+
+    memset(encoder, 0, sizeof(*encoder));
+    encoder->ptr = ptr;
+    encoder->ctrl = ctrl;
+    encoder->protocol = protocol;
+    encoder->seen_update_time = sei_get_latch_time(ptr, ctrl, SEI_LATCH_1);
+
+    /* engine */
+    engine_config.arming_mode = sei_arming_wait_trigger;
+    engine_config.init_instr_idx = base;
+    engine_config.wdg_enable = protocol->wdg_enable;
+    engine_config.wdg_action = sei_wdg_exec_exception_instr;
+    engine_config.wdg_instr_idx = base + protocol->wdg_instr_idx;
+    engine_config.wdg_time = protocol->wdg_time;
+    sei_engine_config_init(ptr, ctrl, &engine_config);
+    sei_set_engine_enable(ptr, ctrl, true);
+
+    if (config->trig_period_us != 0) {
+        trigger_config.trig_period_enable = true;
+        trigger_config.trig_period_arming_mode = sei_arming_direct_exec;
+        trigger_config.trig_period_time = (uint32_t)(((uint64_t)config->trig_period_us * config->src_clk_freq) / 1000000UL);
+        sei_trigger_input_config_init(ptr, ctrl, &trigger_config);
+    }
+    return status_success;
+}
+
+hpm_stat_t hpm_sei_encoder_get_position(hpm_sei_encoder_t *encoder, hpm_sei_encoder_position_t *position)
+{
+    const hpm_sei_encoder_protocol_t *protocol = encoder->protocol;
+    SEI_Type *ptr = encoder->ptr;
+    uint32_t sample_time = sei_get_latch_time(ptr, encoder->ctrl, SEI_LATCH_0);
+    uint32_t update_time = sei_get_latch_time(ptr, encoder->ctrl, SEI_LATCH_1);
+    uint32_t pos, rev, sts;
+
+    /*
+     * A new frame is complete when its update latch follows its sample latch.
+     * The data registers only change between the two, so unchanged latch
+     * times around the reads mean the reads belong to that frame.
+     */
+    if ((update_time != encoder->seen_update_time) && ((int32_t)(update_time - sample_time) > 0)) {
+        pos = sei_get_data_value(ptr, protocol->pos_data_idx);
+        rev = (protocol->rev_data_idx != SEI_DAT_0) ? sei_get_data_value(ptr, protocol->rev_data_idx) : 0;
+        sts = ptr->CTRL[encoder->ctrl].POS.UPD_STS;
+        if ((sei_get_latch_time(ptr, encoder->ctrl, SEI_LATCH_0) == sample_time)
+            && (sei_get_latch_time(ptr, encoder->ctrl, SEI_LATCH_1) == update_time)) {
+            encoder->seen_update_time = update_time;
+            encoder->rx_error = SEI_CTRL_POS_UPD_STS_UPD_ERR_GET(sts) != 0;
+            if (encoder->rx_error) {
+                encoder->rx_errors++;
+            } else {
+                encoder->last.pos = (pos >> protocol->pos_lsb)
+                                  & (uint32_t)((1ULL << protocol->pos_bits) - 1U);
+                encoder->last.rev = rev;
+                encoder->last.sample_time = sample_time;
+                encoder->last.update_time = update_time;
+                encoder->valid = true;
+            }
+        }
+    }
+
+    if (!encoder->valid) {
+        return status_sei_encoder_no_data;
+    }
+    *position = encoder->last;
+    return encoder->rx_error ? status_sei_encoder_rx_error : status_success;
+}
+
+hpm_stat_t hpm_sei_encoder_get_theta(hpm_sei_encoder_t *encoder, float *theta)
+{
+    hpm_sei_encoder_position_t position;
+    hpm_stat_t stat = hpm_sei_encoder_get_position(encoder, &position);
+
+    if (stat != status_success) {
+        return stat;
+    }
+    *theta = (float)position.pos * (6.28318530718f / (float)(1ULL << encoder->protocol->pos_bits));
+    return stat;
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_SEI_ENCODER_H
+#define HPM_SEI_ENCODER_H
+
+#include "hpm_common.h"
+#include "hpm_sei_drv.h"
+
+/**
+ * @brief SEI absolute encoder protocols
+ *
+ * A protocol is a const description of everything an SEI engine needs to talk
+ * to one kind of encoder: the transceiver mode, the data register formats,
+ * the instruction program, the sample and update latch state machines and
+ * the registers that carry position and revolution. The program is stored as
+ * encoded INSTR words built with HPM_SEI_ENCODER_INSTR(), so the tables are
+ * resolved by the compiler and hpm_sei_encoder_init() only copies them into
+ * the SEI. Once running, the engine requests the position on its trigger,
+ * checks the CRC and hands position, revolution and the latch timestamps to
+ * the motor system without the CPU. The CPU reads the same frame from the
+ * data registers; the two latch times tell it whether a frame is complete or
+ * still on the wire, so a read never mixes two frames and never waits.
+ *
+ * Instruction pointers in a protocol count from the first instruction of its
+ * program, which is placed at any free INSTR slot. A JUMP does not hold an
+ * instruction index but selects an engine pointer: SEI_JUMP_INIT_INSTR_IDX
+ * and SEI_JUMP_WDG_INSTR_IDX follow the program wherever it is placed, the
+ * command table pointers are not set up and rejected. The data registers are
+ * shared by all engines of an SEI, so engines running protocols that use the
+ * same data registers must sit on different SEI instances.
+ */
+
+enum {
+    status_sei_encoder_rx_error = MAKE_STATUS(status_group_sei_encoder, 0),  /**< Last frame failed its checks */
+    status_sei_encoder_no_data = MAKE_STATUS(status_group_sei_encoder, 1),   /**< No frame completed yet */
+};
+
+/* Operand as sei_set_instr() stores it: a length is stored minus one, all are clamped to 0x1F */
+#define HPM_SEI_ENCODER_INSTR_OPR(op, opr) \
+    ((((op) == SEI_INSTR_OP_HALT) || ((op) == SEI_INSTR_OP_JUMP) || ((opr) == 0U)) \
+     ? (((opr) > 0x1FU) ? 0x1FU : (uint32_t)(opr)) \
+     : (((opr) > 0x20U) ? 0x1FU : (uint32_t)(opr) - 1U))
+
+/* Encoded instruction, same arguments as sei_set_instr() */
+#define HPM_SEI_ENCODER_INSTR(op, ck, crc, data, opr) \
+    (SEI_INSTR_OP_SET(op) | SEI_INSTR_CK_SET(ck) | SEI_INSTR_CRC_SET(crc) | SEI_INSTR_DAT_SET(data) \
+     | SEI_INSTR_OPR_SET(HPM_SEI_ENCODER_INSTR_OPR(op, opr)))
+
+/**
+ * @brief Data register of a protocol
+ */
+typedef struct {
+    uint8_t idx;                            /**< SEI_DAT_n */
+    uint32_t init_value;                    /**< e.g. the request sent to the encoder */
+    sei_data_format_config_t format;
+} hpm_sei_encoder_data_reg_t;
+
+/**
+ * @brief Latch state machine of a protocol
+ */
+typedef struct {
+    sei_state_transition_config_t tran[4];  /**< SEI_CTRL_LATCH_TRAN_0_1 to SEI_CTRL_LATCH_TRAN_3_0 */
+    uint8_t output_select;                  /**< transition that latches */
+    uint16_t delay_ns;
+} hpm_sei_encoder_latch_t;
+
+/**
+ * @brief Protocol description
+ */
+typedef struct {
+    const char *name;
+    sei_tranceiver_mode_t mode;
+    sei_tranceiver_synchronous_master_config_t synchronous_master_config;
+    sei_tranceiver_asynchronous_config_t asynchronous_config;
+    bool tx_at_ck1;                         /**< synchronous master: drive data at clock point 1 */
+    const sei_data_format_config_t *cmd_format; /**< NULL if the program sends no command */
+    uint32_t cmd_value;
+    const hpm_sei_encoder_data_reg_t *data_regs;
+    uint8_t data_reg_count;
+    const uint32_t *instr;
+    uint8_t instr_count;
+    hpm_sei_encoder_latch_t sample_latch;   /**< runs on SEI_LATCH_0, stamps the request */
+    hpm_sei_encoder_latch_t update_latch;   /**< runs on SEI_LATCH_1, after the last checked bit */
+    uint8_t pos_data_idx;
+    uint8_t rev_data_idx;                   /**< SEI_DAT_0 for single turn encoders */
+    uint8_t pos_lsb;                        /**< bit of the position register holding the position LSB */
+    uint8_t pos_bits;                       /**< single turn resolution */
+    bool wdg_enable;
+    uint8_t wdg_instr_idx;
+    uint16_t wdg_time;                      /**< bits */
+} hpm_sei_encoder_protocol_t;
+
+/**
+ * @brief Engine configuration
+ */
+typedef struct {
+    uint8_t instr_base;                     /**< INSTR slot of the first instruction */
+    uint32_t src_clk_freq;                  /**< SEI clock */
+    uint32_t baudrate;                      /**< 0 for the protocol default */
+    uint32_t trig_period_us;                /**< period trigger, 0 to leave triggering to the caller */
+    uint32_t irq_mask;                      /**< sei_irq_event_t flags to enable */
+} hpm_sei_encoder_config_t;
+
+/**
+ * @brief Position of one frame
+ */
+typedef struct {
+    uint32_t pos;                           /**< single turn count, 0 to 2^pos_bits - 1 */
+    uint32_t rev;
+    uint32_t sample_time;                   /**< latch time of the request */
+    uint32_t update_time;                   /**< latch time of the last checked bit */
+} hpm_sei_encoder_position_t;
+
+/**
+ * @brief Encoder on one SEI engine
+ */
+typedef struct {
+    SEI_Type *ptr;
+    uint8_t ctrl;
+    const hpm_sei_encoder_protocol_t *protocol;
+    uint32_t seen_update_time;              /**< update latch time of the newest frame read */
+    hpm_sei_encoder_position_t last;        /**< newest good frame */
+    bool valid;
+    bool rx_error;                          /**< the newest frame failed its checks */
+    uint32_t rx_errors;
+} hpm_sei_encoder_t;
+
+/* Tables transcribed from the SEI master samples */
+extern const hpm_sei_encoder_protocol_t hpm_sei_encoder_tamagawa;  /**< 2.5 Mbaud, 24 bit ST and MT, Data ID 3 */
+extern const hpm_sei_encoder_protocol_t hpm_sei_encoder_nikon;     /**< 2.5 Mbaud, 20 bit ST and MT, CDF0 */
+extern const hpm_sei_encoder_protocol_t hpm_sei_encoder_bissc;     /**< 1 MHz, 12 bit MT, 12 bit ST */
+extern const hpm_sei_encoder_protocol_t hpm_sei_encoder_endat;     /**< 1 MHz, EnDat 2.2 mode 0x07, 25 bit ST */
+
+/*
+ * Define the get_theta callback of an hpm_mcl_v2 encoder for an encoder
+ * object, in a file that includes the hpm_mcl_v2 headers:
+ *
+ *     static hpm_sei_encoder_t sei_encoder;
+ *     HPM_SEI_ENCODER_MCL_GET_THETA(sei_get_theta, sei_encoder)
+ *     ...
+ *     motor0.cfg.encoder.callback.get_theta = sei_get_theta;
+ *
+ * A frame that failed its checks, or no frame yet, is reported as
+ * mcl_encoder_get_theta_error and leaves theta untouched.
+ */
+#define HPM_SEI_ENCODER_MCL_GET_THETA(fn, encoder) \
+    static hpm_mcl_stat_t fn(float *theta) \
+    { \
+        return (hpm_sei_encoder_get_theta(&(encoder), theta) == status_success) ? mcl_success \
+                                                                                 : mcl_encoder_get_theta_error; \
+    }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Configure an SEI engine for a protocol and start it
+ *
+ * @note The pins and the motor system timestamp are set up by the caller.
+ *
+ * @param [out] encoder encoder
+ * @param [in] ptr SEI base address
+ * @param [in] ctrl SEI engine index
+ * @param [in] protocol protocol description
+ * @param [in] config engine configuration
+ * @retval status_invalid_argument if the program does not fit, jumps to a command table or a latch delay is out of range
+ */
+hpm_stat_t hpm_sei_encoder_init(hpm_sei_encoder_t *encoder, SEI_Type *ptr, uint8_t ctrl,
+                                const hpm_sei_encoder_protocol_t *protocol, const hpm_sei_encoder_config_t *config);
+
+/**
+ * @brief Get the position of the newest complete frame
+ *
+ * @note Never waits for the engine: while a frame is on the wire, the previous
+ * one is returned. Safe to call from any context that owns the encoder.
+ *
+ * @param [in] encoder encoder
+ * @param [out] position position and latch times
+ * @retval status_sei_encoder_rx_error if the newest frame failed its checks, the previous good one is returned
+ * @retval status_sei_encoder_no_data if no good frame has completed yet
+ */
+hpm_stat_t hpm_sei_encoder_get_position(hpm_sei_encoder_t *encoder, hpm_sei_encoder_position_t *position);
+
+/**
+ * @brief Get the single turn angle of the newest complete frame
+ *
+ * @param [in] encoder encoder
+ * @param [out] theta rad, 0 to 2 pi, only written on success
+ * @retval status_success if the newest frame passed its checks
+ * @retval status_sei_encoder_rx_error if the newest frame failed its checks
+ * @retval status_sei_encoder_no_data if no good frame has completed yet
+ */
+hpm_stat_t hpm_sei_encoder_get_theta(hpm_sei_encoder_t *encoder, float *theta);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_SEI_ENCODER_H */
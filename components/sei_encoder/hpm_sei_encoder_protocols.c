@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_sei_encoder.h"
+
+#define BIT_RANGE(first, last) \
+    .first_bit = (first), .last_bit = (last), \
+    .max_bit = ((first) > (last)) ? (first) : (last), .min_bit = ((first) > (last)) ? (last) : (first)
+
+#define DATA_FORMAT(order, len, first, last) \
+    { .mode = sei_data_mode, .bit_order = (order), .word_len = (len), BIT_RANGE(first, last) }
+
+#define CHECK_FORMAT(order, len, first, last, gold) \
+    { .mode = sei_check_mode, .bit_order = (order), .word_len = (len), BIT_RANGE(first, last), .gold_value = (gold) }
+
+#define CRC_FORMAT(order, len, first, last, invert, poly) \
+    { .mode = sei_crc_mode, .bit_order = (order), .word_len = (len), .crc_invert = (invert), .crc_len = (len), \
+      BIT_RANGE(first, last), .crc_poly = (poly) }
+
+#define TRAN_ANY { .disable_instr_ptr_check = true, .disable_clk_check = true, .disable_txd_check = true, \
+                   .disable_rxd_check = true, .disable_timeout_check = true }
+
+#define TRAN_INSTR(cond, idx) { .instr_ptr_cfg = (cond), .instr_ptr_value = (idx), .disable_clk_check = true, \
+                                .disable_txd_check = true, .disable_rxd_check = true, .disable_timeout_check = true }
+
+#define TRAN_CLK(cond) { .disable_instr_ptr_check = true, .clk_cfg = (cond), .disable_txd_check = true, \
+                         .disable_rxd_check = true, .disable_timeout_check = true }
+
+#define TRAN_CLK_INSTR(clk_cond, cond, idx) { .instr_ptr_cfg = (cond), .instr_ptr_value = (idx), .clk_cfg = (clk_cond), \
+                                              .disable_txd_check = true, .disable_rxd_check = true, \
+                                              .disable_timeout_check = true }
+
+#define LSB sei_bit_lsb_first
+#define MSB sei_bit_msb_first
+#define FALL_LEAVE sei_state_tran_condition_fall_leave
+#define RISE_ENTRY sei_state_tran_condition_rise_entry
+#define HIGH_MATCH sei_state_tran_condition_high_match
+
+/*
+ * Tamagawa: send CF with Data ID 3, receive CF, SF, ABS, ENID, ABM, ALMC and
+ * the CRC, one asynchronous 8 bit word each except the 24 bit ABS and ABM.
+ */
+static const hpm_sei_encoder_data_reg_t tamagawa_data[] = {
+    { SEI_DAT_2, 0x1A, DATA_FORMAT(LSB, 8, 0, 7) },     /* CF sent */
+    { SEI_DAT_3, 0, DATA_FORMAT(LSB, 8, 0, 7) },        /* CF */
+    { SEI_DAT_4, 0, DATA_FORMAT(LSB, 8, 0, 7) },        /* SF */
+    { SEI_DAT_5, 0, DATA_FORMAT(LSB, 24, 0, 23) },      /* ABS0 - ABS2 */
+    { SEI_DAT_6, 0, DATA_FORMAT(LSB, 8, 0, 7) },        /* ENID */
+    { SEI_DAT_7, 0, DATA_FORMAT(LSB, 24, 0, 23) },      /* ABM0 - ABM2 */
+    { SEI_DAT_8, 0, DATA_FORMAT(LSB, 8, 0, 7) },        /* ALMC */
+    { SEI_DAT_9, 0, CRC_FORMAT(LSB, 8, 0, 7, false, 0x01) },
+};
+
+static const uint32_t tamagawa_instr[] = {
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_SEND, 0, SEI_DAT_0, SEI_DAT_2, 8),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_3, 8),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_4, 8),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_5, 24),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_6, 8),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_7, 24),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_8, 8),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_0, SEI_DAT_9, 8),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_HALT, 0, SEI_DAT_0, SEI_DAT_0, 0),
+};
+
+const hpm_sei_encoder_protocol_t hpm_sei_encoder_tamagawa = {
+    .name = "tamagawa",
+    .mode = sei_asynchronous_mode,
+    .asynchronous_config = {
+        .data_len = 8,
+        .data_idle_state = sei_idle_high_state,
+        .baudrate = 2500000,
+    },
+    .data_regs = tamagawa_data,
+    .data_reg_count = ARRAY_SIZE(tamagawa_data),
+    .instr = tamagawa_instr,
+    .instr_count = ARRAY_SIZE(tamagawa_instr),
+    .sample_latch = {
+        .tran = { TRAN_INSTR(FALL_LEAVE, 0), TRAN_ANY, TRAN_ANY, TRAN_ANY },
+        .output_select = SEI_CTRL_LATCH_TRAN_0_1,
+        .delay_ns = 480,
+    },
+    .update_latch = {
+        .tran = { TRAN_INSTR(FALL_LEAVE, ARRAY_SIZE(tamagawa_instr) - 2U), TRAN_ANY, TRAN_ANY, TRAN_ANY },
+        .output_select = SEI_CTRL_LATCH_TRAN_0_1,
+    },
+    .pos_data_idx = SEI_DAT_5,
+    .rev_data_idx = SEI_DAT_7,
+    .pos_bits = 24,
+    .wdg_enable = true,
+    .wdg_instr_idx = ARRAY_SIZE(tamagawa_instr) - 1U,
+    .wdg_time = 1000,
+};
+
+/*
+ * Nikon: send sink code, CDF0 and its CRC, receive IF (checked against the
+ * expected EAX and CC), ST, MT and the CRC as 16 bit asynchronous words.
+ */
+static const hpm_sei_encoder_data_reg_t nikon_data[] = {
+    { SEI_DAT_2, 0x0002, DATA_FORMAT(LSB, 3, 0, 2) },   /* sink code */
+    { SEI_DAT_3, 0, DATA_FORMAT(LSB, 10, 0, 9) },       /* CDF0 */
+    { SEI_DAT_4, 0, CHECK_FORMAT(LSB, 6, 0, 5, 0x04) }, /* IF.EAX */
+    { SEI_DAT_5, 0, CHECK_FORMAT(LSB, 6, 0, 5, 0x00) }, /* IF.CC */
+    { SEI_DAT_6, 0, DATA_FORMAT(LSB, 4, 0, 3) },        /* IF.ES */
+    { SEI_DAT_7, 0, DATA_FORMAT(LSB, 20, 0, 19) },      /* ST */
+    { SEI_DAT_8, 0, DATA_FORMAT(LSB, 20, 0, 19) },      /* MT */
+    { SEI_DAT_9, 0, CRC_FORMAT(LSB, 8, 0, 7, false, BIT0_MASK | BIT2_MASK | BIT3_MASK | BIT4_MASK) },
+};
+
+static const uint32_t nikon_instr[] = {
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_SEND, 0, SEI_DAT_0, SEI_DAT_2, 3),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_SEND, 0, SEI_DAT_9, SEI_DAT_3, 10),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_SEND, 0, SEI_DAT_0, SEI_DAT_9, 3),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_4, 6),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_5, 6),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_6, 4),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_7, 20),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_9, SEI_DAT_8, 20),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV_WDG, 0, SEI_DAT_0, SEI_DAT_9, 8),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_HALT, 0, SEI_DAT_0, SEI_DAT_0, 0),
+};
+
+const hpm_sei_encoder_protocol_t hpm_sei_encoder_nikon = {
+    .name = "nikon",
+    .mode = sei_asynchronous_mode,
+    .asynchronous_config = {
+        .data_len = 16,
+        .data_idle_state = sei_idle_high_state,
+        .baudrate = 2500000,
+    },
+    .data_regs = nikon_data,
+    .data_reg_count = ARRAY_SIZE(nikon_data),
+    .instr = nikon_instr,
+    .instr_count = ARRAY_SIZE(nikon_instr),
+    .sample_latch = {
+        .tran = { TRAN_INSTR(FALL_LEAVE, 1), TRAN_ANY, TRAN_ANY, TRAN_ANY },
+        .output_select = SEI_CTRL_LATCH_TRAN_0_1,
+        .delay_ns = 2000,
+    },
+    .update_latch = {
+        .tran = { TRAN_INSTR(FALL_LEAVE, ARRAY_SIZE(nikon_instr) - 2U), TRAN_ANY, TRAN_ANY, TRAN_ANY },
+        .output_select = SEI_CTRL_LATCH_TRAN_0_1,
+    },
+    .pos_data_idx = SEI_DAT_7,
+    .rev_data_idx = SEI_DAT_8,
+    .pos_bits = 20,
+    .wdg_enable = true,
+    .wdg_instr_idx = ARRAY_SIZE(nikon_instr) - 1U,
+    .wdg_time = 1000,
+};
+
+/*
+ * BiSS-C: wait for ACK and START, skip CDS, receive MT, ST and the error and
+ * warning bits under the inverted CRC6, then wait out the timeout.
+ */
+static const hpm_sei_encoder_data_reg_t bissc_data[] = {
+    { SEI_DAT_2, 0, DATA_FORMAT(MSB, 12, 11, 0) },      /* MT */
+    { SEI_DAT_3, 0, DATA_FORMAT(MSB, 12, 31, 20) },     /* ST, left aligned */
+    { SEI_DAT_4, 0, DATA_FORMAT(MSB, 2, 1, 0) },        /* error, warning */
+    { SEI_DAT_5, 0, CRC_FORMAT(MSB, 6, 5, 0, true, 0x03) },
+};
+
+static const uint32_t bissc_instr[] = {
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_WAIT, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_30, 1),  /* ACK */
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_WAIT, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_31, 1),  /* START */
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_0, 1),   /* CDS */
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_5, SEI_DAT_2, 12),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_5, SEI_DAT_3, 12),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_5, SEI_DAT_4, 2),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_5, 6),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_HIGH, SEI_DAT_0, SEI_DAT_30, 0),       /* timeout */
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_WAIT, SEI_INSTR_M_CK_HIGH, SEI_DAT_0, SEI_DAT_31, 0),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_HALT, SEI_INSTR_M_CK_LOW, SEI_DAT_0, SEI_DAT_0, 0),
+};
+
+const hpm_sei_encoder_protocol_t hpm_sei_encoder_bissc = {
+    .name = "bissc",
+    .mode = sei_synchronous_master_mode,
+    .synchronous_master_config = {
+        .data_idle_state = sei_idle_high_state,
+        .clock_idle_state = sei_idle_high_state,
+        .baudrate = 1000000,
+    },
+    .tx_at_ck1 = true,
+    .data_regs = bissc_data,
+    .data_reg_count = ARRAY_SIZE(bissc_data),
+    .instr = bissc_instr,
+    .instr_count = ARRAY_SIZE(bissc_instr),
+    .sample_latch = {
+        .tran = { TRAN_CLK(FALL_LEAVE), TRAN_CLK(RISE_ENTRY), TRAN_ANY,
+                  TRAN_INSTR(FALL_LEAVE, ARRAY_SIZE(bissc_instr) - 2U) },
+        .output_select = SEI_CTRL_LATCH_TRAN_1_2,
+    },
+    .update_latch = {
+        .tran = { TRAN_INSTR(FALL_LEAVE, 6), TRAN_ANY, TRAN_ANY, TRAN_ANY },
+        .output_select = SEI_CTRL_LATCH_TRAN_0_1,
+    },
+    .pos_data_idx = SEI_DAT_3,
+    .rev_data_idx = SEI_DAT_2,
+    .pos_lsb = 20,
+    .pos_bits = 12,
+};
+
+/*
+ * EnDat 2.2: send the mode command from the command register, wait for the
+ * start bit, receive the error bit and the position under the CRC5.
+ */
+static const sei_data_format_config_t endat_cmd = DATA_FORMAT(MSB, 6, 5, 0);
+
+static const hpm_sei_encoder_data_reg_t endat_data[] = {
+    { SEI_DAT_2, 0, DATA_FORMAT(LSB, 1, 0, 0) },        /* error */
+    { SEI_DAT_3, 0, DATA_FORMAT(LSB, 25, 0, 24) },      /* ST */
+    { SEI_DAT_4, 0, CRC_FORMAT(MSB, 5, 4, 0, false, 0x0B) },
+};
+
+static const uint32_t endat_instr[] = {
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_0, 1),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_0, 1),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_SEND, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_1, 6),   /* mode command */
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_0, 1),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_0, 1),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_WAIT, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_30, 1),  /* start 0 */
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_WAIT, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_31, 1),  /* start 1 */
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_4, SEI_DAT_2, 1),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_4, SEI_DAT_3, 25),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_RECV, SEI_INSTR_M_CK_FALL_RISE, SEI_DAT_0, SEI_DAT_4, 5),
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_WAIT, SEI_INSTR_M_CK_HIGH, SEI_DAT_0, SEI_DAT_30, 0),       /* timeout */
+    HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_HALT, SEI_INSTR_M_CK_LOW, SEI_DAT_0, SEI_DAT_0, 0),
+};
+
+const hpm_sei_encoder_protocol_t hpm_sei_encoder_endat = {
+    .name = "endat",
+    .mode = sei_synchronous_master_mode,
+    .synchronous_master_config = {
+        .data_idle_state = sei_idle_low_state,
+        .clock_idle_state = sei_idle_high_state,
+        .baudrate = 1000000,
+    },
+    .cmd_format = &endat_cmd,
+    .cmd_value = 0x07,
+    .data_regs = endat_data,
+    .data_reg_count = ARRAY_SIZE(endat_data),
+    .instr = endat_instr,
+    .instr_count = ARRAY_SIZE(endat_instr),
+    .sample_latch = {
+        .tran = { TRAN_CLK_INSTR(FALL_LEAVE, HIGH_MATCH, 0), TRAN_ANY, TRAN_ANY,
+                  TRAN_INSTR(FALL_LEAVE, ARRAY_SIZE(endat_instr) - 2U) },
+        .output_select = SEI_CTRL_LATCH_TRAN_0_1,
+    },
+    .update_latch = {
+        .tran = { TRAN_INSTR(FALL_LEAVE, ARRAY_SIZE(endat_instr) - 3U), TRAN_ANY, TRAN_ANY,
+                  TRAN_INSTR(FALL_LEAVE, ARRAY_SIZE(endat_instr) - 2U) },
+        .output_select = SEI_CTRL_LATCH_TRAN_0_1,
+    },
+    .pos_data_idx = SEI_DAT_3,
+    .rev_data_idx = SEI_DAT_0,
+    .pos_bits = 25,
+};
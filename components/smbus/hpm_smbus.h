@@ -17,6 +17,27 @@ extern "C"
 {
 #endif
 
+/**
+ * @brief Continue a SMbus PEC over more message bytes
+ *
+ * @param [in] crc PEC of the bytes before, 0 at the start of a message
+ * @param [in] data message bytes
+ * @param [in] len number of bytes
+ * @retval PEC including data
+ */
+uint8_t hpm_smbus_pec_update(uint8_t crc, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief SMbus PEC of a message
+ *
+ * @details CRC-8 (x^8 + x^2 + x + 1) of all message bytes including the addresses with read/write bit
+ *
+ * @param [in] data message bytes
+ * @param [in] len number of bytes
+ * @retval PEC
+ */
+uint8_t hpm_smbus_pec_crc8(const uint8_t *data, uint32_t len);
+
 /**
  * @brief SMbus master write data
  *
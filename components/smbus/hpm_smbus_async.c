@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include "hpm_smbus_async.h"
+
+static void hpm_smbus_async_done(hpm_i2c_trans_t *trans, void *cb_context)
+{
+    hpm_smbus_xfer_t *xfer = (hpm_smbus_xfer_t *)cb_context;
+    hpm_stat_t stat = trans->status;
+    uint32_t len;
+
+    if ((stat == status_success) && xfer->read) {
+        /* PEC covers addr + w, command, addr + r, [count,] data */
+        len = xfer->block ? (4U + xfer->frame[3]) : (3U + xfer->size);
+        if (hpm_smbus_pec_crc8(xfer->frame, len) != xfer->frame[len]) {
+            stat = status_fail;
+        } else if (xfer->block) {
+            xfer->size = xfer->frame[3];
+            memcpy(xfer->data, &xfer->frame[4], xfer->size);
+        } else {
+            memcpy(xfer->data, &xfer->frame[3], xfer->size);
+        }
+    }
+    xfer->status = stat;
+    if (xfer->callback != NULL) {
+        xfer->callback(xfer, xfer->cb_context);
+    }
+}
+
+static hpm_stat_t hpm_smbus_async_submit(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer,
+                                         hpm_smbus_xfer_callback_t callback, void *cb_context)
+{
+    hpm_stat_t stat;
+
+    xfer->callback = callback;
+    xfer->cb_context = cb_context;
+    xfer->status = status_i2c_trans_busy;
+    stat = hpm_i2c_bus_submit(bus, &xfer->trans, hpm_smbus_async_done, xfer);
+    if (stat != status_success) {
+        xfer->status = stat;
+    }
+    return stat;
+}
+
+static void hpm_smbus_async_setup(hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device, uint8_t command,
+                                  uint8_t *data, uint32_t size, bool read, bool block)
+{
+    memset(&xfer->trans, 0, sizeof(xfer->trans));
+    xfer->trans.device = device;
+    xfer->data = data;
+    xfer->size = size;
+    xfer->read = read;
+    xfer->block = block;
+    /* addr + rw bit */
+    xfer->frame[0] = device->address << 1;
+    xfer->frame[1] = command;
+    if (read) {
+        xfer->frame[2] = (device->address << 1) | 0x01;
+        /* write the command code, then read after a repeated start */
+        xfer->trans.seg[0].buf = &xfer->frame[1];
+        xfer->trans.seg[0].len = 1;
+        xfer->trans.seg[0].flags = HPM_I2C_SEG_WRITE | HPM_I2C_SEG_START;
+    }
+}
+
+hpm_stat_t hpm_smbus_async_write_in_command(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device,
+                                            uint8_t command, const uint8_t *data, uint32_t size,
+                                            hpm_smbus_xfer_callback_t callback, void *cb_context)
+{
+    if ((size == 0) || (size > HPM_SMBUS_BLOCK_MAX + 1U)) {
+        return status_invalid_argument;
+    }
+    if (xfer->status == status_i2c_trans_busy) {
+        return status_i2c_trans_busy;
+    }
+    hpm_smbus_async_setup(xfer, device, command, NULL, size, false, false);
+    memcpy(&xfer->frame[2], data, size);
+    xfer->frame[size + 2] = hpm_smbus_pec_crc8(xfer->frame, size + 2);
+    xfer->trans.seg[0].buf = &xfer->frame[1];
+    xfer->trans.seg[0].len = size + 2;
+    xfer->trans.seg[0].flags = HPM_I2C_SEG_WRITE | HPM_I2C_SEG_START | HPM_I2C_SEG_STOP;
+    xfer->trans.seg_count = 1;
+    return hpm_smbus_async_submit(bus, xfer, callback, cb_context);
+}
+
+hpm_stat_t hpm_smbus_async_read_in_command(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device,
+                                           uint8_t command, uint8_t *data, uint32_t size,
+                                           hpm_smbus_xfer_callback_t callback, void *cb_context)
+{
+    if ((size == 0) || (size > HPM_SMBUS_BLOCK_MAX + 1U)) {
+        return status_invalid_argument;
+    }
+    if (xfer->status == status_i2c_trans_busy) {
+        return status_i2c_trans_busy;
+    }
+    hpm_smbus_async_setup(xfer, device, command, data, size, true, false);
+    /* data and pec */
+    xfer->trans.seg[1].buf = &xfer->frame[3];
+    xfer->trans.seg[1].len = size + 1;
+    xfer->trans.seg[1].flags = HPM_I2C_SEG_READ | HPM_I2C_SEG_START | HPM_I2C_SEG_STOP;
+    xfer->trans.seg_count = 2;
+    return hpm_smbus_async_submit(bus, xfer, callback, cb_context);
+}
+
+hpm_stat_t hpm_smbus_async_write_block_in_command(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device,
+                                                  uint8_t command, const uint8_t *data, uint32_t size,
+                                                  hpm_smbus_xfer_callback_t callback, void *cb_context)
+{
+    if ((size == 0) || (size > HPM_SMBUS_BLOCK_MAX)) {
+        return status_invalid_argument;
+    }
+    if (xfer->status == status_i2c_trans_busy) {
+        return status_i2c_trans_busy;
+    }
+    hpm_smbus_async_setup(xfer, device, command, NULL, size, false, true);
+    xfer->frame[2] = size;
+    memcpy(&xfer->frame[3], data, size);
+    xfer->frame[size + 3] = hpm_smbus_pec_crc8(xfer->frame, size + 3);
+    xfer->trans.seg[0].buf = &xfer->frame[1];
+    xfer->trans.seg[0].len = size + 3;
+    xfer->trans.seg[0].flags = HPM_I2C_SEG_WRITE | HPM_I2C_SEG_START | HPM_I2C_SEG_STOP;
+    xfer->trans.seg_count = 1;
+    return hpm_smbus_async_submit(bus, xfer, callback, cb_context);
+}
+
+hpm_stat_t hpm_smbus_async_read_block_in_command(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device,
+                                                 uint8_t command, uint8_t *data, uint32_t capacity,
+                                                 hpm_smbus_xfer_callback_t callback, void *cb_context)
+{
+    if (capacity == 0) {
+        return status_invalid_argument;
+    }
+    if (xfer->status == status_i2c_trans_busy) {
+        return status_i2c_trans_busy;
+    }
+    if (capacity > HPM_SMBUS_BLOCK_MAX) {
+        capacity = HPM_SMBUS_BLOCK_MAX;
+    }
+    hpm_smbus_async_setup(xfer, device, command, data, 0, true, true);
+    /* block count */
+    xfer->trans.seg[1].buf = &xfer->frame[3];
+    xfer->trans.seg[1].len = 1;
+    xfer->trans.seg[1].flags = HPM_I2C_SEG_READ | HPM_I2C_SEG_START;
+    /* count bytes of data and pec */
+    xfer->trans.seg[2].buf = &xfer->frame[4];
+    xfer->trans.seg[2].len = capacity + 1;
+    xfer->trans.seg[2].len_extra = 1;
+    xfer->trans.seg[2].flags = HPM_I2C_SEG_READ | HPM_I2C_SEG_LEN_FROM_PREV | HPM_I2C_SEG_STOP;
+    xfer->trans.seg_count = 3;
+    return hpm_smbus_async_submit(bus, xfer, callback, cb_context);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_SMBUS_ASYNC_H
+#define HPM_SMBUS_ASYNC_H
+
+#include "hpm_smbus.h"
+#include "hpm_i2c.h"
+
+/**
+ * @brief SMbus master commands queued on an I2C bus
+ *
+ * Each command runs as one I2C transaction of the hpm_i2c bus, the PEC is
+ * appended on write and checked on read. The completion callback runs from
+ * the I2C interrupt with the result in xfer->status: status_success, an I2C
+ * error, status_timeout or status_fail for a PEC mismatch.
+ */
+
+/* Largest block of a block read or write, 32 for SMbus 2.0, up to 255 for SMbus 3.x */
+#ifndef HPM_SMBUS_BLOCK_MAX
+#define HPM_SMBUS_BLOCK_MAX (32U)
+#endif
+
+struct hpm_smbus_xfer;
+
+/**
+ * @brief Command completion callback
+ */
+typedef void (*hpm_smbus_xfer_callback_t)(struct hpm_smbus_xfer *xfer, void *cb_context);
+
+/**
+ * @brief Command, zero initialized before the first use and kept valid until it has completed
+ */
+typedef struct hpm_smbus_xfer {
+    hpm_i2c_trans_t trans;
+    /* addr + w, command, addr + r, count, data, pec */
+    uint8_t frame[HPM_SMBUS_BLOCK_MAX + 5U];
+    uint8_t *data;                          /**< caller data */
+    uint32_t size;                          /**< bytes, for a block read the bytes received */
+    bool read;
+    bool block;
+    hpm_smbus_xfer_callback_t callback;
+    void *cb_context;
+    volatile hpm_stat_t status;             /**< status_i2c_trans_busy until completed, then the result */
+} hpm_smbus_xfer_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Queue a write of bytes after a command code, e.g. write byte or write word
+ *
+ * @param [in] bus I2C bus
+ * @param [out] xfer command
+ * @param [in] device SMbus device
+ * @param [in] command command code
+ * @param [in] data bytes to write, copied
+ * @param [in] size number of bytes, up to HPM_SMBUS_BLOCK_MAX + 1
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] cb_context callback argument
+ * @retval status_success if the command was queued
+ */
+hpm_stat_t hpm_smbus_async_write_in_command(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device,
+                                            uint8_t command, const uint8_t *data, uint32_t size,
+                                            hpm_smbus_xfer_callback_t callback, void *cb_context);
+
+/**
+ * @brief Queue a read of bytes after a command code, e.g. read byte or read word
+ *
+ * @param [in] bus I2C bus
+ * @param [out] xfer command
+ * @param [in] device SMbus device
+ * @param [in] command command code
+ * @param [out] data read bytes, written on success
+ * @param [in] size number of bytes, up to HPM_SMBUS_BLOCK_MAX + 1
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] cb_context callback argument
+ * @retval status_success if the command was queued
+ */
+hpm_stat_t hpm_smbus_async_read_in_command(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device,
+                                           uint8_t command, uint8_t *data, uint32_t size,
+                                           hpm_smbus_xfer_callback_t callback, void *cb_context);
+
+/**
+ * @brief Queue a block write
+ *
+ * @param [in] bus I2C bus
+ * @param [out] xfer command
+ * @param [in] device SMbus device
+ * @param [in] command command code
+ * @param [in] data block, copied
+ * @param [in] size block size, 1 to HPM_SMBUS_BLOCK_MAX
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] cb_context callback argument
+ * @retval status_success if the command was queued
+ */
+hpm_stat_t hpm_smbus_async_write_block_in_command(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device,
+                                                  uint8_t command, const uint8_t *data, uint32_t size,
+                                                  hpm_smbus_xfer_callback_t callback, void *cb_context);
+
+/**
+ * @brief Queue a block read, the device sends the block size first
+ *
+ * @param [in] bus I2C bus
+ * @param [out] xfer command, xfer->size holds the block size on success
+ * @param [in] device SMbus device
+ * @param [in] command command code
+ * @param [out] data block, written on success
+ * @param [in] capacity size of data, blocks larger than this end with status_i2c_invalid_data
+ * @param [in] callback completion callback, may be NULL
+ * @param [in] cb_context callback argument
+ * @retval status_success if the command was queued
+ */
+hpm_stat_t hpm_smbus_async_read_block_in_command(hpm_i2c_bus_t *bus, hpm_smbus_xfer_t *xfer, const hpm_i2c_device_t *device,
+                                                 uint8_t command, uint8_t *data, uint32_t capacity,
+                                                 hpm_smbus_xfer_callback_t callback, void *cb_context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_SMBUS_ASYNC_H */
@@ -5,8 +5,44 @@
  *
  */
 
+#include <string.h>
 #include "hpm_spi.h"
 
+/* transactions are queued from tasks and interrupts and completed from the DMA interrupt */
+#ifndef HPM_SPI_BUS_ENTER_CRITICAL
+#include "hpm_interrupt.h"
+#define HPM_SPI_BUS_ENTER_CRITICAL()     disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define HPM_SPI_BUS_EXIT_CRITICAL(level) restore_global_irq((level) & CSR_MSTATUS_MIE_MASK)
+#endif
+
+/*
+ * Write back the transmit buffer and invalidate the receive buffer before the DMA owns them.
+ * Off target, where the host tests build this file, there is no cache to maintain
+ */
+static void hpm_spi_dma_buff_sync(uint8_t *tx_buff, uint32_t tx_size, uint8_t *rx_buff, uint32_t rx_size)
+{
+#if defined(__riscv)
+    if (!l1c_dc_is_enabled()) {
+        return;
+    }
+    if ((tx_buff != NULL) && (tx_size != 0)) {
+        uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)tx_buff);
+        uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)tx_buff + tx_size);
+        l1c_dc_writeback(aligned_start, aligned_end - aligned_start);
+    }
+    if ((rx_buff != NULL) && (rx_size != 0)) {
+        uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)rx_buff);
+        uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)rx_buff + rx_size);
+        l1c_dc_invalidate(aligned_start, aligned_end - aligned_start);
+    }
+#else
+    (void)tx_buff;
+    (void)tx_size;
+    (void)rx_buff;
+    (void)rx_size;
+#endif
+}
+
 static hpm_stat_t hpm_spi_tx_trigger_dma(DMA_Type *dma_ptr, uint8_t ch_num, SPI_Type *spi_ptr, uint32_t src, uint8_t data_width, uint32_t size)
 {
     dma_handshake_config_t config;
@@ -40,47 +76,37 @@ static hpm_stat_t hpm_spi_rx_trigger_dma(DMA_Type *dma_ptr, uint8_t ch_num, SPI_
 }
 
 
-void hpm_spi_prepare_dma_tx_descriptors(spi_context_t *context, spi_control_config_t *config, uint32_t trans_count,
-                                    uint32_t *spi_transctrl, dma_linked_descriptor_t *tx_dma_descriptors)
+/* written to SPI CMD by the chain to start the next chunk */
+static uint8_t dummy_cmd = 0xff;
+/* a dummy dma transfer starts the chain */
+static uint32_t dummy_data1 = 0xff, dummy_data2 = 0xff;
+
+static uint32_t hpm_spi_chain_transctrl_mode(spi_control_config_t *config, bool tx)
 {
-    SPI_Type *ptr = context->ptr;
-    uint32_t dma_transfer_size[trans_count];
-    uint32_t tx_count = context->tx_count;
-    uint32_t per_trans_size = context->per_trans_max;
-    uint32_t dma_ch = context->dma_context.tx_dma_ch;
-    uint8_t *tx_buff = context->tx_buff;
-    dma_channel_config_t dma_ch_config;
+    uint8_t trans_mode;
 
-    static uint8_t dummy_cmd = 0xff;
+    if (tx) {
+        trans_mode = (config->common_config.trans_mode == spi_trans_write_read_together) ?
+                     spi_trans_write_read_together : spi_trans_write_only;
+    } else {
+        trans_mode = spi_trans_read_only;
+    }
+    return SPI_TRANSCTRL_TRANSMODE_SET(trans_mode) | SPI_TRANSCTRL_DUALQUAD_SET(config->common_config.data_phase_fmt);
+}
 
-    uint32_t temp32;
-    uint32_t tx_buff_index = 0;
+/*
+ * Build the SPI CTRL, SPI CMD and SPI DATA descriptors of trans_count chunks, the data
+ * descriptors are completed by hpm_spi_patch_dma_descriptors()
+ */
+static void hpm_spi_build_dma_descriptors(spi_context_t *context, uint32_t trans_count, uint32_t *spi_transctrl,
+                                          dma_linked_descriptor_t *descriptors, uint8_t *buff, bool tx)
+{
+    SPI_Type *ptr = context->ptr;
+    uint32_t dma_ch = tx ? context->dma_context.tx_dma_ch : context->dma_context.rx_dma_ch;
+    dma_channel_config_t dma_ch_config;
 
     dma_default_channel_config(context->dma_context.dma_ptr, &dma_ch_config);
     for (uint32_t i = 0; i < trans_count; i++) {
-        if (tx_count > per_trans_size) {
-            temp32 = per_trans_size;
-            tx_count -= per_trans_size;
-        } else {
-            temp32 = tx_count;
-        }
-
-        *(spi_transctrl + i) = SPI_TRANSCTRL_TRANSMODE_SET(config->common_config.trans_mode == spi_trans_write_read_together ?
-                                                           spi_trans_write_read_together : spi_trans_write_only)
-                                | SPI_TRANSCTRL_DUALQUAD_SET(config->common_config.data_phase_fmt)
-                                | SPI_TRANSCTRL_WRTRANCNT_SET(temp32 - 1)
-                                | SPI_TRANSCTRL_RDTRANCNT_SET(temp32 - 1);
-
-        if (i == 0) {
-            /* Set the count of data transferred by dma to be one more than that of spi */
-            /* when dma transfer finished, there are data in SPI fifo, dma should not execute the dma descriptor which changes SPI CTRL register */
-            temp32 = temp32 + 1;
-        }
-        if (i == trans_count - 1) {
-            temp32 = temp32 - 1;
-        }
-        dma_transfer_size[i] = temp32;
-
         /* SPI CTRL */
         dma_ch_config.size_in_byte = 4;
         dma_ch_config.src_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(spi_transctrl + i));
@@ -92,8 +118,8 @@ void hpm_spi_prepare_dma_tx_descriptors(spi_context_t *context, spi_control_conf
         dma_ch_config.dst_mode = DMA_HANDSHAKE_MODE_NORMAL;
         dma_ch_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
         dma_ch_config.dst_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
-        dma_ch_config.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(tx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 1));
-        dma_config_linked_descriptor(context->dma_context.dma_ptr, tx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS, dma_ch, &dma_ch_config);
+        dma_ch_config.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 1));
+        dma_config_linked_descriptor(context->dma_context.dma_ptr, descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS, dma_ch, &dma_ch_config);
 
         /* SPI CMD */
         dma_ch_config.size_in_byte = 1;
@@ -106,112 +132,96 @@ void hpm_spi_prepare_dma_tx_descriptors(spi_context_t *context, spi_control_conf
         dma_ch_config.dst_mode = DMA_HANDSHAKE_MODE_NORMAL;
         dma_ch_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
         dma_ch_config.dst_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
-        dma_ch_config.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(tx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 2));
-        dma_config_linked_descriptor(context->dma_context.dma_ptr, tx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 1, dma_ch, &dma_ch_config);
+        dma_ch_config.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 2));
+        dma_config_linked_descriptor(context->dma_context.dma_ptr, descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 1, dma_ch, &dma_ch_config);
 
         /* SPI DATA */
-        dma_ch_config.size_in_byte = dma_transfer_size[i] << context->dma_context.data_width;
-        dma_ch_config.src_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(tx_buff + tx_buff_index));
-        dma_ch_config.dst_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&ptr->DATA);
+        dma_ch_config.size_in_byte = context->per_trans_max << context->dma_context.data_width;
+        if (tx) {
+            dma_ch_config.src_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)buff);
+            dma_ch_config.dst_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&ptr->DATA);
+            dma_ch_config.src_mode = DMA_HANDSHAKE_MODE_NORMAL;
+            dma_ch_config.dst_mode = DMA_HANDSHAKE_MODE_HANDSHAKE;
+            dma_ch_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_INCREMENT;
+            dma_ch_config.dst_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
+        } else {
+            dma_ch_config.src_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&ptr->DATA);
+            dma_ch_config.dst_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)buff);
+            dma_ch_config.src_mode = DMA_HANDSHAKE_MODE_HANDSHAKE;
+            dma_ch_config.dst_mode = DMA_HANDSHAKE_MODE_NORMAL;
+            dma_ch_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
+            dma_ch_config.dst_addr_ctrl = DMA_ADDRESS_CONTROL_INCREMENT;
+        }
         dma_ch_config.src_width = context->dma_context.data_width;
         dma_ch_config.dst_width = context->dma_context.data_width;
         dma_ch_config.src_burst_size = DMA_NUM_TRANSFER_PER_BURST_1T;
-        dma_ch_config.src_mode = DMA_HANDSHAKE_MODE_NORMAL;
-        dma_ch_config.dst_mode = DMA_HANDSHAKE_MODE_HANDSHAKE;
-        dma_ch_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_INCREMENT;
-        dma_ch_config.dst_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
-        if (i == trans_count - 1) {
-            dma_ch_config.linked_ptr = 0;
-        } else {
-            dma_ch_config.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(tx_dma_descriptors + (i + 1) * SPI_DMA_DESC_COUNT_PER_TRANS));
-        }
-        dma_config_linked_descriptor(context->dma_context.dma_ptr, tx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 2, dma_ch, &dma_ch_config);
-
-        tx_buff_index += temp32 * context->data_len_in_byte;
+        dma_ch_config.linked_ptr = 0;
+        dma_config_linked_descriptor(context->dma_context.dma_ptr, descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 2, dma_ch, &dma_ch_config);
     }
 }
 
-void hpm_prepare_dma_rx_descriptors(spi_context_t *context, spi_control_config_t *config, uint32_t trans_count,
-                                    uint32_t *spi_transctrl, dma_linked_descriptor_t *rx_dma_descriptors)
+/*
+ * Set the SPI CTRL values, the data sizes, buffer addresses and chain links of a transfer of
+ * count data in trans_count chunks, the descriptors have been built for at least trans_count chunks
+ */
+static void hpm_spi_patch_dma_descriptors(spi_context_t *context, uint32_t transctrl_mode, uint32_t count, uint32_t trans_count,
+                                          uint32_t *spi_transctrl, dma_linked_descriptor_t *descriptors, uint8_t *buff, bool tx)
 {
-    SPI_Type *ptr = context->ptr;
-    uint32_t dma_transfer_size[trans_count];
-    uint32_t rx_count = context->rx_count;
-    uint32_t per_trans_size = context->per_trans_max;
-    uint32_t dma_ch = context->dma_context.rx_dma_ch;
-    uint8_t *rx_buff = context->rx_buff;
-    dma_channel_config_t dma_ch_config;
+    dma_linked_descriptor_t *data;
+    uint32_t size;
+    uint32_t addr;
+    uint32_t buff_index = 0;
 
-    static uint8_t dummy_cmd = 0xff;
+    for (uint32_t i = 0; i < trans_count; i++) {
+        size = MIN(count, context->per_trans_max);
+        count -= size;
+        spi_transctrl[i] = transctrl_mode | SPI_TRANSCTRL_WRTRANCNT_SET(size - 1) | SPI_TRANSCTRL_RDTRANCNT_SET(size - 1);
 
-    uint32_t temp32;
-    uint32_t rx_buff_index = 0;
+        if (tx) {
+            /* Set the count of data transferred by dma to be one more than that of spi */
+            /* when dma transfer finished, there are data in SPI fifo, dma should not execute the dma descriptor which changes SPI CTRL register */
+            if (i == 0) {
+                size = size + 1;
+            }
+            if (i == trans_count - 1) {
+                size = size - 1;
+            }
+        }
 
-    dma_default_channel_config(context->dma_context.dma_ptr, &dma_ch_config);
-    for (uint32_t i = 0; i < trans_count; i++) {
-        if (rx_count > per_trans_size) {
-            temp32 = per_trans_size;
-            rx_count -= per_trans_size;
+        data = descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 2;
+        addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(buff + buff_index));
+        data->trans_size = size;
+        if (tx) {
+            data->src_addr = addr;
         } else {
-            temp32 = rx_count;
+            data->dst_addr = addr;
         }
-
-        *(spi_transctrl + i) = SPI_TRANSCTRL_TRANSMODE_SET(spi_trans_read_only) |
-                                SPI_TRANSCTRL_DUALQUAD_SET(config->common_config.data_phase_fmt) |
-                                SPI_TRANSCTRL_WRTRANCNT_SET(temp32 - 1) |
-                                SPI_TRANSCTRL_RDTRANCNT_SET(temp32 - 1);
-        dma_transfer_size[i] = temp32;
-
-        /* SPI CTRL */
-        dma_ch_config.size_in_byte = 4;
-        dma_ch_config.src_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(spi_transctrl + i));
-        dma_ch_config.dst_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&ptr->TRANSCTRL);
-        dma_ch_config.src_width = DMA_TRANSFER_WIDTH_WORD;
-        dma_ch_config.dst_width = DMA_TRANSFER_WIDTH_WORD;
-        dma_ch_config.src_burst_size = DMA_NUM_TRANSFER_PER_BURST_1T;
-        dma_ch_config.src_mode = DMA_HANDSHAKE_MODE_NORMAL;
-        dma_ch_config.dst_mode = DMA_HANDSHAKE_MODE_NORMAL;
-        dma_ch_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
-        dma_ch_config.dst_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
-        dma_ch_config.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(rx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 1));
-        dma_config_linked_descriptor(context->dma_context.dma_ptr, rx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS, dma_ch, &dma_ch_config);
-
-        /* SPI CMD */
-        dma_ch_config.size_in_byte = 1;
-        dma_ch_config.src_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&dummy_cmd);
-        dma_ch_config.dst_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&ptr->CMD);
-        dma_ch_config.src_width = DMA_TRANSFER_WIDTH_BYTE;
-        dma_ch_config.dst_width = DMA_TRANSFER_WIDTH_BYTE;
-        dma_ch_config.src_burst_size = DMA_NUM_TRANSFER_PER_BURST_1T;
-        dma_ch_config.src_mode = DMA_HANDSHAKE_MODE_NORMAL;
-        dma_ch_config.dst_mode = DMA_HANDSHAKE_MODE_NORMAL;
-        dma_ch_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
-        dma_ch_config.dst_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
-        dma_ch_config.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(rx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 2));
-        dma_config_linked_descriptor(context->dma_context.dma_ptr, rx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 1, dma_ch, &dma_ch_config);
-
-        /* SPI DATA */
-        dma_ch_config.size_in_byte = dma_transfer_size[i] << context->dma_context.data_width;
-        dma_ch_config.src_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&ptr->DATA);
-        dma_ch_config.dst_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(rx_buff + rx_buff_index));
-        dma_ch_config.src_width = context->dma_context.data_width;
-        dma_ch_config.dst_width = context->dma_context.data_width;
-        dma_ch_config.src_burst_size = DMA_NUM_TRANSFER_PER_BURST_1T;
-        dma_ch_config.src_mode = DMA_HANDSHAKE_MODE_HANDSHAKE;
-        dma_ch_config.dst_mode = DMA_HANDSHAKE_MODE_NORMAL;
-        dma_ch_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
-        dma_ch_config.dst_addr_ctrl = DMA_ADDRESS_CONTROL_INCREMENT;
         if (i == trans_count - 1) {
-            dma_ch_config.linked_ptr = 0;
+            data->linked_ptr = 0;
         } else {
-            dma_ch_config.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(rx_dma_descriptors + (i + 1) * SPI_DMA_DESC_COUNT_PER_TRANS));
+            data->linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(descriptors + (i + 1) * SPI_DMA_DESC_COUNT_PER_TRANS));
         }
-        dma_config_linked_descriptor(context->dma_context.dma_ptr, rx_dma_descriptors + i * SPI_DMA_DESC_COUNT_PER_TRANS + 2, dma_ch, &dma_ch_config);
 
-        rx_buff_index += temp32 * context->data_len_in_byte;
+        buff_index += size * context->data_len_in_byte;
     }
 }
 
+void hpm_spi_prepare_dma_tx_descriptors(spi_context_t *context, spi_control_config_t *config, uint32_t trans_count,
+                                    uint32_t *spi_transctrl, dma_linked_descriptor_t *tx_dma_descriptors)
+{
+    hpm_spi_build_dma_descriptors(context, trans_count, spi_transctrl, tx_dma_descriptors, context->tx_buff, true);
+    hpm_spi_patch_dma_descriptors(context, hpm_spi_chain_transctrl_mode(config, true), context->tx_count, trans_count,
+                                  spi_transctrl, tx_dma_descriptors, context->tx_buff, true);
+}
+
+void hpm_prepare_dma_rx_descriptors(spi_context_t *context, spi_control_config_t *config, uint32_t trans_count,
+                                    uint32_t *spi_transctrl, dma_linked_descriptor_t *rx_dma_descriptors)
+{
+    hpm_spi_build_dma_descriptors(context, trans_count, spi_transctrl, rx_dma_descriptors, context->rx_buff, false);
+    hpm_spi_patch_dma_descriptors(context, hpm_spi_chain_transctrl_mode(config, false), context->rx_count, trans_count,
+                                  spi_transctrl, rx_dma_descriptors, context->rx_buff, false);
+}
+
 static uint32_t hpm_spi_get_trans_count(spi_context_t *context, spi_control_config_t *config)
 {
     uint32_t total_trans_count, per_trans_count, trans_count;
@@ -252,9 +262,6 @@ static hpm_stat_t spi_setup_trans_with_dma_chain(spi_context_t *context, spi_con
     uint32_t trans_count;
     dma_channel_config_t dma_ch_config = {0};
 
-    /* use a dummy dma transfer to start SPI trans dma chain */
-    static uint32_t dummy_data1 = 0xff, dummy_data2 = 0xff;
-
     trans_count = hpm_spi_get_trans_count(context, config);
 
     /* active spi cs pin */
@@ -375,22 +382,7 @@ hpm_stat_t hpm_spi_setup_dma_transfer(spi_context_t *context, spi_control_config
 
     hpm_stat_t stat = status_success;
 
-    if (l1c_dc_is_enabled()) {
-        /* cache writeback for tx buff */
-        if (context->tx_buff != NULL && context->tx_size != 0) {
-            uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)context->tx_buff);
-            uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)context->tx_buff + context->tx_size);
-            uint32_t aligned_size = aligned_end - aligned_start;
-            l1c_dc_writeback(aligned_start, aligned_size);
-        }
-        /* cache invalidate for receive buff */
-        if (context->rx_buff != NULL && context->rx_size != 0) {
-            uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)context->rx_buff);
-            uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)context->rx_buff + context->rx_size);
-            uint32_t aligned_size = aligned_end - aligned_start;
-            l1c_dc_invalidate(aligned_start, aligned_size);
-        }
-    }
+    hpm_spi_dma_buff_sync(context->tx_buff, context->tx_size, context->rx_buff, context->rx_size);
 
     if ((context->rx_count > context->per_trans_max) || (context->tx_count > context->per_trans_max)) {
         /* multiple SPI transmissions with chained DMA */
@@ -411,6 +403,284 @@ hpm_stat_t hpm_spi_setup_dma_transfer(spi_context_t *context, spi_control_config
     return stat;
 }
 
+static bool hpm_spi_trans_mode_is_tx(uint8_t trans_mode)
+{
+    return (trans_mode == spi_trans_write_only) || (trans_mode == spi_trans_dummy_write)
+        || (trans_mode == spi_trans_write_read_together);
+}
+
+hpm_stat_t hpm_spi_trans_prepare(hpm_spi_trans_t *trans, spi_context_t *context, spi_control_config_t *config,
+                                 dma_linked_descriptor_t *descriptors, uint32_t *spi_transctrl, uint32_t max_chunks)
+{
+    uint8_t trans_mode;
+    uint8_t *buff;
+    bool tx;
+
+    if ((trans == NULL) || (context == NULL) || (config == NULL) || (descriptors == NULL) || (spi_transctrl == NULL)
+        || (max_chunks == 0) || (context->per_trans_max == 0) || (context->write_cs == NULL)) {
+        return status_invalid_argument;
+    }
+    trans_mode = config->common_config.trans_mode;
+    if ((trans_mode != spi_trans_read_only) && (trans_mode != spi_trans_dummy_read) && !hpm_spi_trans_mode_is_tx(trans_mode)) {
+        return status_invalid_argument;
+    }
+    tx = hpm_spi_trans_mode_is_tx(trans_mode);
+    buff = tx ? context->tx_buff : context->rx_buff;
+    if (buff == NULL) {
+        return status_invalid_argument;
+    }
+
+    memset(trans, 0, sizeof(*trans));
+    trans->context = context;
+    trans->config = *config;
+    trans->cmd = context->cmd;
+    trans->addr = context->addr;
+    trans->descriptors = descriptors;
+    trans->spi_transctrl = spi_transctrl;
+    trans->max_chunks = max_chunks;
+    trans->chain_dma_ch = tx ? context->dma_context.tx_dma_ch : context->dma_context.rx_dma_ch;
+    trans->status = status_success;
+
+    hpm_spi_build_dma_descriptors(context, max_chunks, spi_transctrl, descriptors, buff, tx);
+
+    /* the chain is started by a dummy transfer linked to the data descriptor of the first chunk */
+    dma_default_channel_config(context->dma_context.dma_ptr, &trans->chain_start);
+    trans->chain_start.src_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&dummy_data1);
+    trans->chain_start.dst_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)&dummy_data2);
+    trans->chain_start.src_burst_size = DMA_NUM_TRANSFER_PER_BURST_1T;
+    trans->chain_start.src_width = DMA_TRANSFER_WIDTH_WORD;
+    trans->chain_start.dst_width = DMA_TRANSFER_WIDTH_WORD;
+    trans->chain_start.size_in_byte = 4;
+    trans->chain_start.linked_ptr = core_local_mem_to_sys_address(context->running_core, (uint32_t)(descriptors + SPI_DMA_DESC_COUNT_PER_TRANS - 1));
+
+    if (trans_mode == spi_trans_write_read_together) {
+        /* spi tx use chained dma descriptor, spi rx use unchained dma */
+        dma_default_channel_config(context->dma_context.dma_ptr, &trans->rx_config);
+        trans->rx_config.src_addr = (uint32_t)&context->ptr->DATA;
+        trans->rx_config.src_addr_ctrl = DMA_ADDRESS_CONTROL_FIXED;
+        trans->rx_config.src_mode = DMA_HANDSHAKE_MODE_HANDSHAKE;
+        trans->rx_config.src_width = context->dma_context.data_width;
+        trans->rx_config.dst_width = context->dma_context.data_width;
+        /*  In DMA handshake case, source burst size must be 1 transfer, that is 0. */
+        trans->rx_config.src_burst_size = 0;
+    }
+
+    return hpm_spi_trans_rearm(trans, context->tx_buff, context->rx_buff, tx ? context->tx_count : context->rx_count);
+}
+
+hpm_stat_t hpm_spi_trans_rearm(hpm_spi_trans_t *trans, uint8_t *tx_buff, uint8_t *rx_buff, uint32_t count)
+{
+    spi_context_t *context = trans->context;
+    uint8_t trans_mode = trans->config.common_config.trans_mode;
+    bool tx = hpm_spi_trans_mode_is_tx(trans_mode);
+    uint32_t chunks;
+
+    if (trans->status == status_spi_trans_busy) {
+        return status_spi_trans_busy;
+    }
+    chunks = (count + context->per_trans_max - 1) / context->per_trans_max;
+    if ((count == 0) || (chunks > trans->max_chunks)
+        || (tx && (tx_buff == NULL)) || ((trans_mode != spi_trans_write_only) && (trans_mode != spi_trans_dummy_write) && (rx_buff == NULL))) {
+        return status_invalid_argument;
+    }
+
+    hpm_spi_patch_dma_descriptors(context, hpm_spi_chain_transctrl_mode(&trans->config, tx), count, chunks,
+                                  trans->spi_transctrl, trans->descriptors, tx ? tx_buff : rx_buff, tx);
+    if (trans_mode == spi_trans_write_read_together) {
+        trans->rx_config.dst_addr = core_local_mem_to_sys_address(context->running_core, (uint32_t)rx_buff);
+        trans->rx_config.size_in_byte = count << context->dma_context.data_width;
+    }
+
+    trans->tx_buff = tx_buff;
+    trans->rx_buff = rx_buff;
+    trans->count = count;
+    trans->chunks = chunks;
+    return status_success;
+}
+
+static hpm_stat_t hpm_spi_trans_start(hpm_spi_trans_t *trans)
+{
+    spi_context_t *context = trans->context;
+    spi_dma_context_t *dma_context = &context->dma_context;
+    uint8_t trans_mode = trans->config.common_config.trans_mode;
+    uint32_t first = MIN(trans->count, context->per_trans_max);
+    hpm_stat_t stat;
+
+    context->write_cs(context->cs_pin, SPI_CS_ACTIVE);
+
+    /* config SPI for first dma transmission */
+    stat = spi_setup_dma_transfer(context->ptr, &trans->config, &trans->cmd, &trans->addr, first, first);
+    if (stat != status_success) {
+        return stat;
+    }
+
+    if (trans_mode == spi_trans_write_read_together) {
+        dmamux_config(dma_context->dmamux_ptr, dma_context->rx_dmamux_ch, dma_context->rx_req, true);
+        stat = dma_setup_channel(dma_context->dma_ptr, dma_context->rx_dma_ch, &trans->rx_config, true);
+        if (stat != status_success) {
+            return stat;
+        }
+    }
+    if (hpm_spi_trans_mode_is_tx(trans_mode)) {
+        dmamux_config(dma_context->dmamux_ptr, dma_context->tx_dmamux_ch, dma_context->tx_req, true);
+    } else {
+        dmamux_config(dma_context->dmamux_ptr, dma_context->rx_dmamux_ch, dma_context->rx_req, true);
+    }
+
+    return dma_setup_channel(dma_context->dma_ptr, trans->chain_dma_ch, &trans->chain_start, true);
+}
+
+void hpm_spi_bus_init(hpm_spi_bus_t *bus, SPI_Type *ptr)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->ptr = ptr;
+}
+
+/* Release the running transaction and start the next one, before the callback so the bus does not idle */
+static void hpm_spi_bus_complete(hpm_spi_bus_t *bus, hpm_stat_t stat)
+{
+    hpm_spi_trans_t *trans;
+    hpm_spi_trans_t *next;
+    uint32_t level;
+
+    do {
+        level = HPM_SPI_BUS_ENTER_CRITICAL();
+        trans = bus->head;
+        next = trans->next;
+        bus->head = next;
+        if (next == NULL) {
+            bus->tail = NULL;
+        }
+        bus->queued--;
+        HPM_SPI_BUS_EXIT_CRITICAL(level);
+
+        trans->context->write_cs(trans->context->cs_pin, !SPI_CS_ACTIVE);
+        trans->next = NULL;
+        if (stat == status_success) {
+            bus->stat.transfers++;
+        } else {
+            bus->stat.errors++;
+        }
+        trans->status = stat;
+
+        stat = (next != NULL) ? hpm_spi_trans_start(next) : status_success;
+        if (trans->callback != NULL) {
+            trans->callback(trans, trans->cb_context);
+        }
+    } while ((next != NULL) && (stat != status_success));
+}
+
+hpm_stat_t hpm_spi_bus_submit(hpm_spi_bus_t *bus, hpm_spi_trans_t *trans,
+                              hpm_spi_trans_callback_t callback, void *cb_context)
+{
+    hpm_stat_t stat;
+    uint32_t level;
+    uint32_t size;
+    bool start;
+
+    if ((trans == NULL) || (trans->context == NULL) || (trans->context->ptr != bus->ptr) || (trans->count == 0)) {
+        return status_invalid_argument;
+    }
+    if (trans->status == status_spi_trans_busy) {
+        return status_spi_trans_busy;
+    }
+    /* the buffers belong to the DMA from here, the start in the interrupt only programs registers */
+    size = trans->count * trans->context->data_len_in_byte;
+    hpm_spi_dma_buff_sync(trans->tx_buff, (trans->tx_buff != NULL) ? size : 0, trans->rx_buff, (trans->rx_buff != NULL) ? size : 0);
+
+    level = HPM_SPI_BUS_ENTER_CRITICAL();
+    if (trans->status == status_spi_trans_busy) {
+        HPM_SPI_BUS_EXIT_CRITICAL(level);
+        return status_spi_trans_busy;
+    }
+    trans->status = status_spi_trans_busy;
+    trans->callback = callback;
+    trans->cb_context = cb_context;
+    trans->next = NULL;
+    start = (bus->head == NULL);
+    if (start) {
+        bus->head = trans;
+    } else {
+        bus->tail->next = trans;
+    }
+    bus->tail = trans;
+    bus->queued++;
+    if (bus->queued > bus->stat.max_queued) {
+        bus->stat.max_queued = bus->queued;
+    }
+    HPM_SPI_BUS_EXIT_CRITICAL(level);
+
+    if (start) {
+        stat = hpm_spi_trans_start(trans);
+        if (stat != status_success) {
+            hpm_spi_bus_complete(bus, stat);
+        }
+    }
+    return status_success;
+}
+
+bool hpm_spi_bus_is_busy(hpm_spi_bus_t *bus)
+{
+    return bus->head != NULL;
+}
+
+void hpm_spi_bus_dma_isr_handler(hpm_spi_bus_t *bus)
+{
+    hpm_spi_trans_t *trans = bus->head;
+    spi_dma_context_t *dma_context;
+    bool rx_unchained;
+    uint32_t status;
+
+    if (trans == NULL) {
+        return;
+    }
+    dma_context = &trans->context->dma_context;
+    rx_unchained = (trans->config.common_config.trans_mode == spi_trans_write_read_together);
+
+    status = dma_check_transfer_status(dma_context->dma_ptr, trans->chain_dma_ch);
+    if (rx_unchained) {
+        status |= dma_check_transfer_status(dma_context->dma_ptr, dma_context->rx_dma_ch);
+    }
+    if (status & (DMA_CHANNEL_STATUS_ERROR | DMA_CHANNEL_STATUS_ABORT)) {
+        dma_abort_channel(dma_context->dma_ptr, (1UL << trans->chain_dma_ch) | (rx_unchained ? (1UL << dma_context->rx_dma_ch) : 0));
+        hpm_spi_bus_complete(bus, status_spi_trans_dma_error);
+        return;
+    }
+
+    /* every descriptor completes, the transaction is done once its channels have stopped */
+    if (dma_channel_is_enable(dma_context->dma_ptr, trans->chain_dma_ch)
+        || (rx_unchained && dma_channel_is_enable(dma_context->dma_ptr, dma_context->rx_dma_ch))) {
+        return;
+    }
+    /*
+     * the last data are still shifted out when the transmit chain ends: the end interrupt
+     * of the SPI completes the transaction then, set again if the SPI ended meanwhile
+     */
+    spi_clear_interrupt_status(bus->ptr, spi_end_int);
+    if (spi_is_active(bus->ptr)) {
+        bus->end_pending = true;
+        spi_enable_interrupt(bus->ptr, spi_end_int);
+        return;
+    }
+    hpm_spi_bus_complete(bus, status_success);
+}
+
+void hpm_spi_bus_spi_isr_handler(hpm_spi_bus_t *bus)
+{
+    /* chunk ends set the status too, only the end awaited by hpm_spi_bus_dma_isr_handler() completes */
+    if (!bus->end_pending || ((spi_get_interrupt_status(bus->ptr) & spi_end_int) == 0U)) {
+        return;
+    }
+    spi_clear_interrupt_status(bus->ptr, spi_end_int);
+    /* a short last chunk is queued behind the one that just ended */
+    if (spi_is_active(bus->ptr)) {
+        return;
+    }
+    bus->end_pending = false;
+    spi_disable_interrupt(bus->ptr, spi_end_int);
+    hpm_spi_bus_complete(bus, status_success);
+}
+
 /* Using GPIO as SPI CS pin */
 /* When SPI trans completed, GPIO cs pin should be released manually */
 hpm_stat_t hpm_spi_release_gpio_cs(spi_context_t *context)
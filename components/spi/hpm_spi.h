@@ -26,6 +26,11 @@
 /* Every transaction can be delineated by 3 dma descriptions: SPI control, SPI cmd, SPI data */
 #define SPI_DMA_DESC_COUNT_PER_TRANS    (3U)
 
+enum {
+    status_spi_trans_busy = MAKE_STATUS(status_group_spi, 0),       /**< Transaction is queued or running */
+    status_spi_trans_dma_error = MAKE_STATUS(status_group_spi, 1),  /**< DMA reported an error */
+};
+
 typedef struct {
     DMA_Type *dma_ptr;
     DMAMUX_Type *dmamux_ptr;
@@ -58,6 +63,63 @@ typedef struct {
     dma_linked_descriptor_t *dma_linked_descriptor;
 } spi_context_t;
 
+struct hpm_spi_trans;
+
+/**
+ * @brief Prepared transaction completion callback, called from the DMA interrupt
+ */
+typedef void (*hpm_spi_trans_callback_t)(struct hpm_spi_trans *trans, void *cb_context);
+
+/**
+ * @brief Prepared transaction
+ *
+ * The DMA descriptors of a transaction are built once by hpm_spi_trans_prepare()
+ * and only their buffer addresses and lengths are patched by hpm_spi_trans_rearm().
+ * The descriptors are 8-byte aligned, placed in noncacheable memory and hold
+ * SPI_DMA_DESC_COUNT_PER_TRANS entries per chunk of up to per_trans_max data.
+ */
+typedef struct hpm_spi_trans {
+    struct hpm_spi_trans *next;             /**< bus queue link */
+    spi_context_t *context;                 /**< device, SPI, GPIO CS and DMA channels */
+    spi_control_config_t config;            /**< control config */
+    uint8_t cmd;                            /**< command, may be changed between transfers */
+    uint32_t addr;                          /**< address, may be changed between transfers */
+    dma_linked_descriptor_t *descriptors;   /**< descriptor memory */
+    uint32_t *spi_transctrl;                /**< TRANSCTRL values, one per chunk */
+    uint32_t max_chunks;                    /**< chunks the descriptors were built for */
+    uint32_t chunks;                        /**< chunks of the armed transfer */
+    uint32_t count;                         /**< data count of the armed transfer */
+    uint8_t *tx_buff;
+    uint8_t *rx_buff;
+    uint8_t chain_dma_ch;                   /**< channel running the descriptor chain */
+    dma_channel_config_t chain_start;       /**< chain start transfer */
+    dma_channel_config_t rx_config;         /**< receive channel, write and read together */
+    hpm_spi_trans_callback_t callback;
+    void *cb_context;
+    volatile hpm_stat_t status;             /**< status_spi_trans_busy while queued or running, then the result */
+} hpm_spi_trans_t;
+
+/**
+ * @brief Bus statistics
+ */
+typedef struct {
+    uint32_t transfers;                     /**< transactions completed */
+    uint32_t errors;                        /**< transactions ended by a DMA error */
+    uint32_t max_queued;                    /**< longest queue seen */
+} hpm_spi_bus_stat_t;
+
+/**
+ * @brief Bus, runs the prepared transactions of several devices on one SPI back to back
+ */
+typedef struct {
+    SPI_Type *ptr;
+    hpm_spi_trans_t *head;                  /**< running transaction */
+    hpm_spi_trans_t *tail;                  /**< last queued transaction */
+    uint32_t queued;
+    volatile bool end_pending;              /**< DMA done, waiting for the SPI end interrupt */
+    hpm_spi_bus_stat_t stat;
+} hpm_spi_bus_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -74,6 +136,100 @@ extern "C" {
  */
 hpm_stat_t hpm_spi_setup_dma_transfer(spi_context_t *context, spi_control_config_t *config);
 
+/**
+ * @brief Build the DMA descriptors of a transaction
+ *
+ * Supports spi_trans_write_only, spi_trans_read_only, spi_trans_dummy_write,
+ * spi_trans_dummy_read and spi_trans_write_read_together in master mode. The
+ * descriptors, cmd, addr and buffers are taken from the context, a GPIO CS
+ * (context->write_cs) is required.
+ *
+ * @param[out] trans transaction
+ * @param[in] context device context
+ * @param[in] config control config
+ * @param[in] descriptors descriptor memory, SPI_DMA_DESC_COUNT_PER_TRANS * max_chunks entries
+ * @param[in] spi_transctrl TRANSCTRL memory, max_chunks words, noncacheable
+ * @param[in] max_chunks largest number of per_trans_max chunks the transaction is rearmed with
+ * @retval status_success if the transaction was prepared
+ * @retval status_invalid_argument if the transfer mode or sizes are not supported
+ */
+hpm_stat_t hpm_spi_trans_prepare(hpm_spi_trans_t *trans, spi_context_t *context, spi_control_config_t *config,
+                                 dma_linked_descriptor_t *descriptors, uint32_t *spi_transctrl, uint32_t max_chunks);
+
+/**
+ * @brief Point a prepared transaction at new buffers and count
+ *
+ * Only the buffer addresses, lengths and chain links are patched.
+ *
+ * @param[in] trans transaction, not queued
+ * @param[in] tx_buff transmit buffer, NULL for read only
+ * @param[in] rx_buff receive buffer, NULL for write only
+ * @param[in] count data count
+ * @retval status_success if the transaction was rearmed
+ * @retval status_invalid_argument if count needs more chunks than prepared
+ * @retval status_spi_trans_busy if the transaction is queued
+ */
+hpm_stat_t hpm_spi_trans_rearm(hpm_spi_trans_t *trans, uint8_t *tx_buff, uint8_t *rx_buff, uint32_t count);
+
+/**
+ * @brief Initialize a bus
+ *
+ * Transactions complete in the DMA interrupt, which the application forwards
+ * to hpm_spi_bus_dma_isr_handler(), or, when the SPI is still shifting out the
+ * last data, in the SPI interrupt, forwarded to hpm_spi_bus_spi_isr_handler().
+ * Neither handler waits for the SPI: the next transaction is started from them
+ * with a fixed number of register writes, the chip select change in between
+ * goes through the GPIO callback of the device.
+ *
+ * @param[out] bus bus
+ * @param[in] ptr SPI base address
+ */
+void hpm_spi_bus_init(hpm_spi_bus_t *bus, SPI_Type *ptr);
+
+/**
+ * @brief Queue a prepared transaction
+ *
+ * The transaction starts right away if the bus is idle, otherwise when the
+ * transactions queued before it have completed. Its chip select is asserted
+ * when it starts and released when it completes. The cache maintenance of its
+ * buffers is done here, the buffers must not be touched until it completes.
+ *
+ * @param[in] bus bus
+ * @param[in] trans transaction prepared for a device on this SPI
+ * @param[in] callback completion callback, may be NULL
+ * @param[in] cb_context callback context
+ * @retval status_success if the transaction was queued
+ * @retval status_invalid_argument if the transaction does not belong to the bus
+ * @retval status_spi_trans_busy if the transaction is already queued
+ */
+hpm_stat_t hpm_spi_bus_submit(hpm_spi_bus_t *bus, hpm_spi_trans_t *trans,
+                              hpm_spi_trans_callback_t callback, void *cb_context);
+
+/**
+ * @brief Check whether transactions are queued or running
+ *
+ * @param[in] bus bus
+ * @return true if the bus is busy
+ */
+bool hpm_spi_bus_is_busy(hpm_spi_bus_t *bus);
+
+/**
+ * @brief DMA interrupt handler of a bus, call from the ISR of the DMA the bus transactions use
+ *
+ * @param[in] bus bus
+ */
+void hpm_spi_bus_dma_isr_handler(hpm_spi_bus_t *bus);
+
+/**
+ * @brief SPI interrupt handler of a bus, call from the ISR of the SPI
+ *
+ * Only acts on the end interrupt hpm_spi_bus_dma_isr_handler() enables when the
+ * DMA is done before the SPI, other SPI interrupts are left to the application.
+ *
+ * @param[in] bus bus
+ */
+void hpm_spi_bus_spi_isr_handler(hpm_spi_bus_t *bus);
+
 /*
  * SPI release gpio pin if gpio use for SPI CS function
  */
@@ -320,4 +320,308 @@ uart_lin_stat_t hpm_uart_lin_slave_receive_data(uart_lin_slave_config_t *config)
     }
 
     return uart_lin_success;
-}
\ No newline at end of file
+}
+
+#define HPM_UART_LIN_NO_FRAME (0xFFU)
+
+enum {
+    uart_lin_master_idle = 0,
+    uart_lin_master_break,      /* break control set */
+    uart_lin_master_delimiter,  /* break delimiter */
+    uart_lin_master_frame,      /* header sent, reading back */
+    uart_lin_master_done,       /* frame judged, waiting for the slot end */
+};
+
+uart_lin_stat_t hpm_uart_lin_master_sched_init(uart_lin_master_t *master, uart_lin_master_sched_config_t *config)
+{
+    uart_lin_frame_t *frame;
+    uart_lin_frame_t *assoc;
+
+    if ((config->ptr == NULL) || (config->frames == NULL) || (config->frame_count == 0)
+        || (config->frame_count >= HPM_UART_LIN_NO_FRAME) || (config->baudrate == 0) || (config->baudrate > 20000U)) {
+        return uart_lin_invalid_argument;
+    }
+    for (uint8_t i = 0; i < config->frame_count; i++) {
+        frame = &config->frames[i];
+        if ((frame->id > 0x3FU) || (frame->length == 0) || (frame->length > 8U)
+            || (frame->type > uart_lin_frame_event_triggered)) {
+            return uart_lin_invalid_argument;
+        }
+        if ((frame->type == uart_lin_frame_sporadic) || (frame->type == uart_lin_frame_event_triggered)) {
+            if ((frame->assoc == NULL) || (frame->assoc_count == 0)) {
+                return uart_lin_invalid_argument;
+            }
+            for (uint8_t j = 0; j < frame->assoc_count; j++) {
+                if (frame->assoc[j] >= config->frame_count) {
+                    return uart_lin_invalid_argument;
+                }
+                assoc = &config->frames[frame->assoc[j]];
+                /* sporadic frames carry master responses, event triggered frames slave responses of their length */
+                if ((frame->type == uart_lin_frame_sporadic) && (assoc->type != uart_lin_frame_publish)) {
+                    return uart_lin_invalid_argument;
+                }
+                if ((frame->type == uart_lin_frame_event_triggered)
+                    && ((assoc->type != uart_lin_frame_subscribe) || (assoc->length != frame->length))) {
+                    return uart_lin_invalid_argument;
+                }
+            }
+        }
+    }
+
+    memset(master, 0, sizeof(*master));
+    master->ptr = config->ptr;
+    master->break_us = (HPM_UART_LIN_BREAK_LENGTH * 1000000U + config->baudrate - 1U) / config->baudrate;
+    master->delimiter_us = (1000000U + config->baudrate - 1U) / config->baudrate;
+    master->frames = config->frames;
+    master->frame_count = config->frame_count;
+    master->callback = config->callback;
+    master->cb_context = config->cb_context;
+    master->state = uart_lin_master_idle;
+    master->slot_frame = HPM_UART_LIN_NO_FRAME;
+    master->bus_frame = HPM_UART_LIN_NO_FRAME;
+    return uart_lin_success;
+}
+
+void hpm_uart_lin_master_set_schedule(uart_lin_master_t *master, const uart_lin_schedule_t *table)
+{
+    master->next_table = table;
+}
+
+static void hpm_uart_lin_master_report(uart_lin_master_t *master, uint8_t index, uart_lin_stat_t stat)
+{
+    uart_lin_frame_stat_t *s = &master->frames[index].stat;
+
+    switch (stat) {
+    case uart_lin_success:
+        s->ok++;
+        break;
+    case uart_lin_timeout:
+        s->no_response++;
+        break;
+    case uart_lin_checksum_error:
+        s->checksum_error++;
+        break;
+    case uart_lin_bit_error:
+        s->bit_error++;
+        break;
+    case uart_lin_collision:
+        s->collision++;
+        break;
+    default:
+        s->frame_error++;
+        break;
+    }
+    if (master->callback != NULL) {
+        master->callback(master, index, stat, master->cb_context);
+    }
+}
+
+/* judge the frame on the bus, complete is false when its slot has ended first */
+static void hpm_uart_lin_master_judge(uart_lin_master_t *master, bool complete)
+{
+    uart_lin_frame_t *frame = &master->frames[master->bus_frame];
+    uart_lin_frame_t *assoc;
+    uint8_t length = frame->length;
+    uart_lin_stat_t stat;
+    uint8_t index = master->bus_frame;
+
+    uart_disable_irq(master->ptr, uart_intr_rx_data_avail_or_timeout);
+    master->state = uart_lin_master_done;
+
+    if ((master->index < 2U) || master->header_error) {
+        stat = uart_lin_frame_error;
+    } else if (frame->type == uart_lin_frame_publish) {
+        if (!complete) {
+            stat = uart_lin_frame_error;
+        } else if (master->echo_error) {
+            stat = uart_lin_bit_error;
+        } else {
+            stat = uart_lin_success;
+        }
+    } else if (master->index == 2U) {
+        /* nobody answered, a normal outcome of an event triggered frame */
+        stat = uart_lin_timeout;
+    } else if (!complete) {
+        stat = uart_lin_frame_error;
+    } else if (!hpm_uart_lin_check_checksum(master->buf[1], &master->buf[2], length, frame->enhance_checksum,
+                                            master->buf[length + 2U])) {
+        stat = uart_lin_checksum_error;
+    } else {
+        stat = uart_lin_success;
+    }
+
+    if (frame->type == uart_lin_frame_event_triggered) {
+        if ((master->index > 2U) && !master->header_error
+            && ((stat == uart_lin_checksum_error) || (stat == uart_lin_frame_error))) {
+            /* overlapping responses of several slaves */
+            stat = uart_lin_collision;
+            if (frame->collision_table != NULL) {
+                master->collision_table = frame->collision_table;
+            }
+        } else if (stat == uart_lin_success) {
+            /*
+             * The first data byte is the PID of the associated frame that answered, the
+             * success is reported and counted on that frame only.
+             */
+            stat = uart_lin_frame_error;
+            for (uint8_t j = 0; j < frame->assoc_count; j++) {
+                assoc = &master->frames[frame->assoc[j]];
+                if (hpm_uart_lin_calculate_protected_id(assoc->id) == master->buf[2]) {
+                    memcpy(assoc->data, &master->buf[2], length);
+                    assoc->updated = true;
+                    index = frame->assoc[j];
+                    stat = uart_lin_success;
+                    break;
+                }
+            }
+        }
+    } else if ((frame->type == uart_lin_frame_subscribe) && (stat == uart_lin_success)) {
+        memcpy(frame->data, &master->buf[2], length);
+        frame->updated = true;
+    }
+    hpm_uart_lin_master_report(master, index, stat);
+}
+
+/* pick the slot to run at a slot boundary */
+static const uart_lin_slot_t *hpm_uart_lin_master_next_slot(uart_lin_master_t *master)
+{
+    const uart_lin_schedule_t *requested = master->next_table;
+    const uart_lin_schedule_t *base = (master->resume_table != NULL) ? master->resume_table : master->table;
+
+    if (requested != base) {
+        master->table = requested;
+        master->slot = 0;
+        master->resume_table = NULL;
+    } else if ((master->collision_table != NULL) && (master->resume_table == NULL)) {
+        /* run the collision table once, then continue after the event triggered slot */
+        master->resume_table = master->table;
+        master->resume_slot = master->slot;
+        master->table = master->collision_table;
+        master->slot = 0;
+    }
+    master->collision_table = NULL;
+
+    if ((master->table == NULL) || (master->table->count == 0)) {
+        return NULL;
+    }
+    if (master->slot >= master->table->count) {
+        master->slot = 0;
+        if (master->resume_table != NULL) {
+            master->table = master->resume_table;
+            master->resume_table = NULL;
+            if (master->resume_slot < master->table->count) {
+                master->slot = master->resume_slot;
+            }
+        }
+    }
+    return &master->table->slots[master->slot++];
+}
+
+static uint32_t hpm_uart_lin_master_start_slot(uart_lin_master_t *master)
+{
+    const uart_lin_slot_t *slot;
+    uart_lin_frame_t *frame;
+    uint32_t header_us = master->break_us + master->delimiter_us;
+
+    if (master->state == uart_lin_master_frame) {
+        hpm_uart_lin_master_judge(master, false);
+    }
+    slot = hpm_uart_lin_master_next_slot(master);
+    if (slot == NULL) {
+        master->state = uart_lin_master_idle;
+        return 0;
+    }
+
+    master->slot_frame = slot->frame;
+    master->bus_frame = slot->frame;
+    frame = &master->frames[slot->frame];
+    if (frame->type == uart_lin_frame_sporadic) {
+        master->bus_frame = HPM_UART_LIN_NO_FRAME;
+        for (uint8_t j = 0; j < frame->assoc_count; j++) {
+            if (master->frames[frame->assoc[j]].updated) {
+                master->bus_frame = frame->assoc[j];
+                break;
+            }
+        }
+        if (master->bus_frame == HPM_UART_LIN_NO_FRAME) {
+            /* no update, the slot stays silent */
+            master->state = uart_lin_master_done;
+            return (slot->slot_us != 0) ? slot->slot_us : 1U;
+        }
+    }
+
+    master->ptr->LCR |= UART_LCR_BC_MASK;
+    master->state = uart_lin_master_break;
+    master->slot_left_us = (slot->slot_us > header_us) ? (slot->slot_us - header_us) : 1U;
+    return master->break_us;
+}
+
+static void hpm_uart_lin_master_send_header(uart_lin_master_t *master)
+{
+    uart_lin_frame_t *frame = &master->frames[master->bus_frame];
+    uint8_t length = frame->length;
+    uint8_t count = 2;
+
+    /* drop the break character read back */
+    uart_clear_rx_fifo(master->ptr);
+
+    master->buf[0] = 0x55;
+    master->buf[1] = hpm_uart_lin_calculate_protected_id(frame->id);
+    master->expect = length + 3U;
+    master->index = 0;
+    master->header_error = false;
+    master->echo_error = false;
+    if (frame->type == uart_lin_frame_publish) {
+        memcpy(&master->buf[2], frame->data, length);
+        master->buf[length + 2U] = hpm_uart_lin_calculate_checksum(master->buf[1], &master->buf[2], length,
+                                                                   frame->enhance_checksum);
+        frame->updated = false;
+        count = master->expect;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        uart_write_byte(master->ptr, master->buf[i]);
+    }
+    master->state = uart_lin_master_frame;
+    uart_enable_irq(master->ptr, uart_intr_rx_data_avail_or_timeout);
+}
+
+uint32_t hpm_uart_lin_master_timer_handler(uart_lin_master_t *master)
+{
+    switch (master->state) {
+    case uart_lin_master_break:
+        master->ptr->LCR &= ~UART_LCR_BC_MASK;
+        master->state = uart_lin_master_delimiter;
+        return master->delimiter_us;
+    case uart_lin_master_delimiter:
+        hpm_uart_lin_master_send_header(master);
+        return master->slot_left_us;
+    default:
+        return hpm_uart_lin_master_start_slot(master);
+    }
+}
+
+void hpm_uart_lin_master_uart_isr_handler(uart_lin_master_t *master)
+{
+    uint8_t c;
+    bool sent;
+
+    while (uart_check_status(master->ptr, uart_stat_data_ready)) {
+        c = uart_read_byte(master->ptr);
+        if ((master->state != uart_lin_master_frame) || (master->index >= master->expect)) {
+            continue;
+        }
+        sent = (master->index < 2U) || (master->frames[master->bus_frame].type == uart_lin_frame_publish);
+        if (!sent) {
+            master->buf[master->index] = c;
+        } else if (c != master->buf[master->index]) {
+            if (master->index < 2U) {
+                master->header_error = true;
+            } else {
+                master->echo_error = true;
+            }
+        }
+        if (++master->index == master->expect) {
+            hpm_uart_lin_master_judge(master, true);
+        }
+    }
+}
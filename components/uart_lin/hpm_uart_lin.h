@@ -44,6 +44,8 @@ typedef enum {
     uart_lin_id_parity_error = 4,
     uart_lin_checksum_error = 5,
     uart_lin_frame_error = 6, /*<! data count error */
+    uart_lin_bit_error = 7, /*<! byte read back differs from the byte sent */
+    uart_lin_collision = 8, /*<! several slaves answered an event triggered frame */
 } uart_lin_stat_t;
 
 typedef struct {
@@ -59,6 +61,103 @@ typedef struct {
     uart_lin_data_t data;
 } uart_lin_slave_config_t;
 
+/*
+ * Schedule table master
+ *
+ * The master runs a LIN 2.x schedule table without blocking. The application
+ * calls hpm_uart_lin_master_timer_handler() from a one-shot timer interrupt and
+ * re-arms the timer with the returned delay, and forwards the UART interrupt
+ * to hpm_uart_lin_master_uart_isr_handler(). Within a slot the timer generates
+ * the break with the UART break control and writes sync, PID and, for frames
+ * the master publishes, the response into the TX FIFO; the UART interrupt
+ * collects the bytes read back from the bus. A frame is judged when its
+ * response is complete or when its slot ends.
+ *
+ * Both handlers must not preempt each other, e.g. they run at the same
+ * interrupt priority. The UART FIFOs are enabled and hold a whole frame.
+ */
+
+typedef enum {
+    uart_lin_frame_publish = 0,         /*<! unconditional, the master sends the response */
+    uart_lin_frame_subscribe = 1,       /*<! unconditional, a slave sends the response */
+    uart_lin_frame_sporadic = 2,        /*<! sends the first associated frame with an update */
+    uart_lin_frame_event_triggered = 3, /*<! associated slave frames answer on change */
+} uart_lin_frame_type_t;
+
+typedef struct {
+    uint32_t ok;                        /*<! event triggered: counted on the associated frame that answered */
+    uint32_t no_response;
+    uint32_t checksum_error;
+    uint32_t frame_error;               /*<! sync or PID not read back, or a partial response */
+    uint32_t bit_error;
+    uint32_t collision;
+} uart_lin_frame_stat_t;
+
+struct uart_lin_schedule;
+
+typedef struct {
+    uint8_t id;
+    uint8_t type;                       /*<! uart_lin_frame_type_t */
+    uint8_t length;                     /*<! 1 - 8, for event triggered frames including the PID byte */
+    bool enhance_checksum;
+    uint8_t data[8];
+    volatile bool updated;              /*<! publish: set by the application to send a sporadic frame,
+                                             subscribe: set by the master on new data */
+    const uint8_t *assoc;               /*<! sporadic and event triggered: associated frame indices */
+    uint8_t assoc_count;
+    const struct uart_lin_schedule *collision_table;    /*<! event triggered: run once on a collision */
+    uart_lin_frame_stat_t stat;
+} uart_lin_frame_t;
+
+typedef struct {
+    uint8_t frame;                      /*<! index into the master frames */
+    uint32_t slot_us;                   /*<! slot length, longer than the frame */
+} uart_lin_slot_t;
+
+typedef struct uart_lin_schedule {
+    const uart_lin_slot_t *slots;
+    uint8_t count;
+} uart_lin_schedule_t;
+
+struct uart_lin_master;
+
+/* called from the interrupt handlers when a frame on the bus has been judged */
+typedef void (*uart_lin_frame_callback_t)(struct uart_lin_master *master, uint8_t frame, uart_lin_stat_t stat, void *cb_context);
+
+typedef struct {
+    UART_Type *ptr;
+    uint32_t baudrate;
+    uart_lin_frame_t *frames;
+    uint8_t frame_count;
+    uart_lin_frame_callback_t callback;
+    void *cb_context;
+} uart_lin_master_sched_config_t;
+
+typedef struct uart_lin_master {
+    UART_Type *ptr;
+    uint32_t break_us;
+    uint32_t delimiter_us;
+    uart_lin_frame_t *frames;
+    uint8_t frame_count;
+    const uart_lin_schedule_t *volatile next_table;   /*<! table requested by the application */
+    const uart_lin_schedule_t *table;   /*<! running table */
+    const uart_lin_schedule_t *resume_table;    /*<! table left for a collision table */
+    const uart_lin_schedule_t *collision_table; /*<! collision table to run from the next slot */
+    uint8_t slot;                       /*<! slot of the running table to start next */
+    uint8_t resume_slot;
+    uint8_t state;
+    uint8_t slot_frame;                 /*<! frame of the running slot */
+    uint8_t bus_frame;                  /*<! frame on the bus, differs for sporadic frames */
+    uint8_t expect;                     /*<! bytes to read back: sync, PID, response and checksum */
+    uint8_t index;
+    bool header_error;
+    bool echo_error;
+    uint8_t buf[11];                    /*<! bytes sent, or sync and PID followed by the bytes received */
+    uint32_t slot_left_us;
+    uart_lin_frame_callback_t callback;
+    void *cb_context;
+} uart_lin_master_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -153,6 +252,44 @@ uart_lin_stat_t hpm_uart_lin_slave_receive_data(uart_lin_slave_config_t *config)
  */
 void hpm_uart_lin_send_wakeup(UART_Type *ptr, uart_lin_master_pin_ctrl_t *pin_ctrl);
 
+/**
+ * @brief initialize a schedule table master
+ *
+ * @note the UART is configured by the caller with the LIN baudrate, 8N1 and FIFOs enabled
+ *
+ * @param [out] master uart_lin_master_t
+ * @param [in] config uart_lin_master_sched_config_t
+ *
+ * @return uart_lin_stat_t uart_lin_invalid_argument if a frame or an association is invalid
+ */
+uart_lin_stat_t hpm_uart_lin_master_sched_init(uart_lin_master_t *master, uart_lin_master_sched_config_t *config);
+
+/**
+ * @brief select the schedule table, the switch happens at the next slot boundary
+ *
+ * @param [in] master uart_lin_master_t
+ * @param [in] table uart_lin_schedule_t, NULL to stop after the running slot
+ */
+void hpm_uart_lin_master_set_schedule(uart_lin_master_t *master, const uart_lin_schedule_t *table);
+
+/**
+ * @brief advance the schedule, call this function in a one-shot timer isr
+ *
+ * @note call it once to start a table and re-arm the timer with the return value
+ *
+ * @param [in] master uart_lin_master_t
+ *
+ * @return microseconds until the next call, 0 if the master has stopped
+ */
+uint32_t hpm_uart_lin_master_timer_handler(uart_lin_master_t *master);
+
+/**
+ * @brief collect the bytes read back from the bus, call this function in uart isr
+ *
+ * @param [in] master uart_lin_master_t
+ */
+void hpm_uart_lin_master_uart_isr_handler(uart_lin_master_t *master);
+
 #ifdef __cplusplus
 }
 #endif
@@ -163,6 +163,10 @@ enum {
     status_group_dma_manager,
     status_group_spi_nor_flash,
     status_group_touch,
+    status_group_ipc_event_mgr,
+    status_group_fft_service,
+    status_group_jpeg_stream,
+    status_group_sei_encoder,
 };
 
 /* @brief Common status code definitions */
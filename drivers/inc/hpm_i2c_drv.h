@@ -362,7 +362,7 @@ static inline void i2c_enable_auto_ack(I2C_Type *ptr)
  */
 static inline void i2c_enable_10bit_address_mode(I2C_Type *ptr, bool enable)
 {
-    ptr->SETUP |= I2C_SETUP_ADDRESSING_SET(enable);
+    ptr->SETUP = (ptr->SETUP & ~I2C_SETUP_ADDRESSING_MASK) | I2C_SETUP_ADDRESSING_SET(enable);
 }
 
 /**
@@ -1667,6 +1667,23 @@ hpm_stat_t mcan_read_rxbuf(MCAN_Type *ptr, uint32_t index, mcan_rx_message_t *rx
  */
 hpm_stat_t mcan_read_rxfifo(MCAN_Type *ptr, uint32_t fifo_index, mcan_rx_message_t *rx_frame);
 
+/**
+ * @brief Read all pending messages from CAN RXFIFO in one pass
+ *
+ * @note The FIFO status and element size are read once and the elements are acknowledged
+ *       with a single write after the last one has been copied
+ *
+ * @param [in] ptr MCAN base
+ * @param [in] fifo_index RXFIFO index, 0 - RXFIFO0, 1 - RXFIFO1
+ * @param [out] rx_frames Buffer to hold up to max_count RX frames
+ * @param [in] max_count Number of frames rx_frames can hold
+ * @param [out] count Number of frames read
+ * @retval status_success if at least one frame was read
+ * @retval status_mcan_rxfifo_empty if the FIFO is empty
+ */
+hpm_stat_t mcan_read_rxfifo_burst(MCAN_Type *ptr, uint32_t fifo_index, mcan_rx_message_t *rx_frames,
+                                  uint32_t max_count, uint32_t *count);
+
 /**
  * @brief Read TX Event from CAN TX EVENT FIFO
  * @param [in] ptr MCAN base
@@ -165,6 +165,19 @@ typedef struct pdma_blit_option {
     } scale;
 } pdma_blit_option_t;
 
+/**
+ * @brief Complete configuration of one PDMA operation
+ *
+ * Filled by the pdma_get_*_config() functions, programmed by pdma_config_op().
+ */
+typedef struct pdma_op_config {
+    pdma_config_t config;                           /**< control config */
+    pdma_plane_config_t plane_src;                  /**< source plane config */
+    pdma_plane_config_t plane_dst;                  /**< destination plane config */
+    display_yuv2rgb_coef_t yuv2rgb_coef;            /**< YUV2RGB coefficients */
+    pdma_output_config_t output;                    /**< output config */
+} pdma_op_config_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -257,6 +270,103 @@ void pdma_init(PDMA_Type *ptr, pdma_config_t *config);
  */
 hpm_stat_t pdma_check_status(PDMA_Type *ptr, uint32_t *status);
 
+/**
+ * @brief PDMA program a complete operation
+ *
+ * Same register writes as pdma_fill_color() and friends do before starting
+ * the PDMA, the PDMA is not started.
+ *
+ * @param [in] ptr PDMA base address
+ * @param [in] op operation configuration
+ */
+void pdma_config_op(PDMA_Type *ptr, pdma_op_config_t *op);
+
+/**
+ * @brief PDMA get fill color operation configuration
+ *
+ * Parameters are the same as pdma_fill_color()
+ *
+ * @param [in] ptr PDMA base address
+ * @param [out] op operation configuration
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameter is invalid
+ */
+hpm_stat_t pdma_get_fill_color_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                      uint32_t dst, uint32_t dst_width,
+                                      uint32_t width, uint32_t height,
+                                      uint32_t color, uint8_t alpha,
+                                      display_pixel_format_t format);
+
+/**
+ * @brief PDMA get flip rotate operation configuration
+ *
+ * Parameters are the same as pdma_flip_rotate()
+ *
+ * @param [in] ptr PDMA base address
+ * @param [out] op operation configuration
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameter is invalid
+ */
+hpm_stat_t pdma_get_flip_rotate_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                       uint32_t dst, uint32_t dst_width,
+                                       uint32_t src, uint32_t src_width, uint32_t x, uint32_t y,
+                                       uint32_t width, uint32_t height,
+                                       pdma_flip_t flip, pdma_rotate_t rotate, uint8_t alpha,
+                                       display_pixel_format_t format);
+
+/**
+ * @brief PDMA get blit operation configuration
+ *
+ * Parameters are the same as pdma_blit()
+ *
+ * @param [in] ptr PDMA base address
+ * @param [out] op operation configuration
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameter is invalid
+ */
+hpm_stat_t pdma_get_blit_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                uint32_t dst, uint32_t dst_width,
+                                uint32_t src, uint32_t src_width,
+                                uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                uint8_t alpha,
+                                display_pixel_format_t format);
+
+/**
+ * @brief PDMA get scale operation configuration
+ *
+ * Parameters are the same as pdma_scale()
+ *
+ * @param [in] ptr PDMA base address
+ * @param [out] op operation configuration
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameter is invalid
+ */
+hpm_stat_t pdma_get_scale_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                 uint32_t dst, uint32_t dst_width,
+                                 uint32_t src, uint32_t src_width,
+                                 uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                 uint32_t target_width, uint32_t target_height,
+                                 uint8_t alpha,
+                                 display_pixel_format_t format);
+
+/**
+ * @brief PDMA get blit by option operation configuration
+ *
+ * Parameters are the same as pdma_blit_ex()
+ *
+ * @param [in] ptr PDMA base address
+ * @param [out] op operation configuration
+ * @param [in] dst target buff
+ * @param [in] src source buff
+ * @param [in] blit_op option of blit
+ * @retval status_success if no error occurred
+ * @retval status_invalid_argument if any parameter is invalid
+ */
+hpm_stat_t pdma_get_blit_ex_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                   display_buf_t *dst,
+                                   display_buf_t *src,
+                                   pdma_blit_option_t *blit_op);
+
 /**
  * @brief PDMA fill color
  *
@@ -463,6 +463,19 @@ hpm_stat_t sdm_receive_one_filter_data(SDM_Type *ptr, uint8_t ch_index, bool usi
  */
 hpm_stat_t sdm_receive_filter_data(SDM_Type *ptr, uint8_t ch_index, bool using_fifo, int8_t *data, uint32_t count, uint8_t data_len_in_bytes);
 
+/**
+ * @brief sdm read the filter data already in fifo without waiting
+ *
+ * @note the fifo fill level is read once and the data is read in one pass, 32bit output mode
+ *
+ * @param ptr SDM base address
+ * @param ch_index channel index
+ * @param data data buff
+ * @param max_count data count the buff can hold
+ * @retval uint32_t data count read
+ */
+uint32_t sdm_read_fifo_data(SDM_Type *ptr, uint8_t ch_index, int32_t *data, uint32_t max_count);
+
 /**
  * @}
  */
@@ -581,14 +581,19 @@ uint32_t enet_prepare_tx_desc(ENET_Type *ptr, enet_tx_desc_t **parent_tx_desc_li
                 dma_tx_desc->tdes0_bm.ic   = config->enable_ioc;
                 size = frame_length - (buf_count - 1) * tx_buff_size;
                 dma_tx_desc->tdes1_bm.tbs1 = (size & ENET_DMATxDesc_TBS1);
+            }
 
-                /* set own bit of the Tx descriptor status: gives the buffer back to Ethernet DMA */
+            /* every segment goes to the Ethernet DMA, the first one after the others */
+            if (i != 0) {
                 dma_tx_desc->tdes0_bm.own = 1;
-                ptr->DMA_TX_POLL_DEMAND = 1;
             }
 
             dma_tx_desc = (enet_tx_desc_t *)(dma_tx_desc->tdes3_bm.next_desc);
         }
+
+        /* set own bit of the first Tx descriptor: the DMA never sees a partial frame */
+        tx_desc_list_cur->tdes0_bm.own = 1;
+        ptr->DMA_TX_POLL_DEMAND = 1;
     }
 
     tx_desc_list_cur = dma_tx_desc;
@@ -655,14 +660,19 @@ uint32_t enet_prepare_transmission_descriptors(ENET_Type *ptr, enet_tx_desc_t **
                 dma_tx_desc->tdes0_bm.ls = 1;
                 size = frame_length - (buf_count - 1) * tx_buff_size;
                 dma_tx_desc->tdes1_bm.tbs1 = (size & ENET_DMATxDesc_TBS1);
+            }
 
-                /* set own bit of the Tx descriptor status: gives the buffer back to Ethernet DMA */
+            /* every segment goes to the Ethernet DMA, the first one after the others */
+            if (i != 0) {
                 dma_tx_desc->tdes0_bm.own = 1;
-                ptr->DMA_TX_POLL_DEMAND = 1;
             }
 
             dma_tx_desc = (enet_tx_desc_t *)(dma_tx_desc->tdes3_bm.next_desc);
         }
+
+        /* set own bit of the first Tx descriptor: the DMA never sees a partial frame */
+        tx_desc_list_cur->tdes0_bm.own = 1;
+        ptr->DMA_TX_POLL_DEMAND = 1;
     }
 
     tx_desc_list_cur = dma_tx_desc;
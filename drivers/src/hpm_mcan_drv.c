@@ -1555,6 +1555,78 @@ hpm_stat_t mcan_read_rxfifo(MCAN_Type *ptr, uint32_t fifo_index, mcan_rx_message
     return status;
 }
 
+hpm_stat_t mcan_read_rxfifo_burst(MCAN_Type *ptr, uint32_t fifo_index, mcan_rx_message_t *rx_frames,
+                                  uint32_t max_count, uint32_t *count)
+{
+    hpm_stat_t status = status_invalid_argument;
+
+    do {
+        if ((ptr == NULL) || (rx_frames == NULL) || (count == NULL) || (max_count == 0U)) {
+            break;
+        }
+        *count = 0;
+
+        /* FIFO state and geometry are read once for the whole burst */
+        uint32_t base_addr;
+        uint32_t elem_index;
+        uint32_t elem_size;
+        uint32_t fill_level;
+        uint32_t fifo_size;
+        if (fifo_index == 0) {
+            uint32_t rxf0s = ptr->RXF0S;
+            fill_level = MCAN_RXF0S_F0FL_GET(rxf0s);
+            elem_index = MCAN_RXF0S_F0GI_GET(rxf0s);
+            base_addr = mcan_get_rxfifo0_base(ptr);
+            elem_size = mcan_get_data_field_size(MCAN_RXESC_F0DS_GET(ptr->RXESC));
+            fifo_size = MCAN_RXF0C_F0S_GET(ptr->RXF0C);
+        } else {
+            uint32_t rxf1s = ptr->RXF1S;
+            fill_level = MCAN_RXF1S_F1FL_GET(rxf1s);
+            elem_index = MCAN_RXF1S_F1GI_GET(rxf1s);
+            base_addr = mcan_get_rxfifo1_base(ptr);
+            elem_size = mcan_get_data_field_size(MCAN_RXESC_F1DS_GET(ptr->RXESC));
+            fifo_size = MCAN_RXF1C_F1S_GET(ptr->RXF1C);
+        }
+        if (fill_level == 0) {
+            status = status_mcan_rxfifo_empty;
+            break;
+        }
+        elem_size += MCAN_MESSAGE_HEADER_SIZE_IN_BYTES;
+
+        uint32_t read_count = MIN(fill_level, max_count);
+        uint32_t last_index = elem_index;
+        for (uint32_t n = 0; n < read_count; n++) {
+            uint32_t *msg_hdr = (uint32_t *) (base_addr + elem_size * elem_index);
+            uint32_t *msg_data = msg_hdr + 2;
+            mcan_rx_message_t *rx_frame = &rx_frames[n];
+            uint32_t *rx_frame_u32 = (uint32_t *) rx_frame;
+            rx_frame_u32[0] = msg_hdr[0];
+            rx_frame_u32[1] = msg_hdr[1];
+            uint8_t msg_size_words = (mcan_get_message_size_from_dlc(rx_frame->dlc) + 3) / 4;
+            for (uint32_t i = 0; i < msg_size_words; i++) {
+                rx_frame->data_32[i] = msg_data[i];
+            }
+            last_index = elem_index;
+            if (++elem_index >= fifo_size) {
+                elem_index = 0;
+            }
+        }
+
+        /* acknowledging the last element read releases all elements before it */
+        if (fifo_index == 0) {
+            ptr->RXF0A = last_index;
+        } else {
+            ptr->RXF1A = last_index;
+        }
+        *count = read_count;
+
+        status = status_success;
+
+    } while (false);
+
+    return status;
+}
+
 hpm_stat_t mcan_read_tx_evt_fifo(MCAN_Type *ptr, mcan_tx_event_fifo_elem_t *tx_evt)
 {
     hpm_stat_t status = status_invalid_argument;
@@ -439,86 +439,99 @@ hpm_stat_t pdma_check_status(PDMA_Type *ptr, uint32_t *status)
     return status_pdma_idle;
 }
 
-hpm_stat_t pdma_fill_color(PDMA_Type *ptr, uint32_t dst, uint32_t dst_width,
-                           uint32_t width, uint32_t height,
-                           uint32_t color, uint8_t alpha,
-                           display_pixel_format_t format,
-                           bool wait, uint32_t *status)
+void pdma_config_op(PDMA_Type *ptr, pdma_op_config_t *op)
 {
-    pdma_config_t config;
-    pdma_plane_config_t plane_src;
-    pdma_plane_config_t plane_dst;
-    display_yuv2rgb_coef_t yuv2rgb_coef;
-    pdma_output_config_t output;
+    pdma_init(ptr, &op->config);
+    pdma_config_planes(ptr, &op->plane_src, &op->plane_dst, &op->yuv2rgb_coef);
+    pdma_config_output(ptr, &op->output);
+}
+
+static hpm_stat_t pdma_run_op(PDMA_Type *ptr, pdma_op_config_t *op, bool wait, uint32_t *status)
+{
+    pdma_config_op(ptr, op);
+    pdma_start(ptr);
+    if (wait) {
+        hpm_stat_t stat;
+        do {
+            stat = pdma_check_status(ptr, status);
+        } while ((stat != status_pdma_done) && (stat != status_pdma_error));
+        pdma_stop(ptr);
+        return stat;
+    }
+    return status_success;
+}
 
+hpm_stat_t pdma_get_fill_color_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                      uint32_t dst, uint32_t dst_width,
+                                      uint32_t width, uint32_t height,
+                                      uint32_t color, uint8_t alpha,
+                                      display_pixel_format_t format)
+{
     if (((display_pixel_format_is_yuv_format(format)) && (width & 1))
         || !(width > 8 || height > 8)) {
         return status_invalid_argument;
     }
 
-    pdma_get_default_config(ptr, &config, format);
-    pdma_get_default_plane_config(ptr, &plane_src, format);
-    pdma_get_default_plane_config(ptr, &plane_dst, format);
-    pdma_get_default_yuv2rgb_coef_config(ptr, &yuv2rgb_coef, format);
-    pdma_get_default_output_config(ptr, &output, format);
+    pdma_get_default_config(ptr, &op->config, format);
+    pdma_get_default_plane_config(ptr, &op->plane_src, format);
+    pdma_get_default_plane_config(ptr, &op->plane_dst, format);
+    pdma_get_default_yuv2rgb_coef_config(ptr, &op->yuv2rgb_coef, format);
+    pdma_get_default_output_config(ptr, &op->output, format);
 
-    config.enable_plane = pdma_plane_both;
+    op->config.enable_plane = pdma_plane_both;
     if (width <= 16) {
-        config.block_size = pdma_blocksize_8x8;
+        op->config.block_size = pdma_blocksize_8x8;
     } else {
-        config.block_size = pdma_blocksize_16x16;
+        op->config.block_size = pdma_blocksize_16x16;
     }
-    pdma_init(ptr, &config);
 
-    plane_src.buffer = dst;
-    plane_src.width = 1;
-    plane_src.height = 1;
-    plane_src.background = 0;
+    op->plane_src.buffer = dst;
+    op->plane_src.width = 1;
+    op->plane_src.height = 1;
+    op->plane_src.background = 0;
 
-    plane_dst.buffer = dst;
-    plane_dst.width = 1;
-    plane_dst.height = 1;
-    plane_dst.background = (alpha << 24) | (color & ~(0xFF << 24));
-    pdma_config_planes(ptr, &plane_src, &plane_dst, &yuv2rgb_coef);
+    op->plane_dst.buffer = dst;
+    op->plane_dst.width = 1;
+    op->plane_dst.height = 1;
+    op->plane_dst.background = (alpha << 24) | (color & ~(0xFF << 24));
 
-    output.buffer = dst;
-    output.plane[pdma_plane_dst].x = 0;
-    output.plane[pdma_plane_dst].y = 0;
-    output.plane[pdma_plane_dst].width = width;
-    output.plane[pdma_plane_dst].height = height;
-    output.pitch = display_get_pitch_length_in_byte(format, dst_width);
+    op->output.buffer = dst;
+    op->output.plane[pdma_plane_dst].x = 0;
+    op->output.plane[pdma_plane_dst].y = 0;
+    op->output.plane[pdma_plane_dst].width = width;
+    op->output.plane[pdma_plane_dst].height = height;
+    op->output.pitch = display_get_pitch_length_in_byte(format, dst_width);
 
-    output.alphablend.mode = display_alphablend_mode_clear;
+    op->output.alphablend.mode = display_alphablend_mode_clear;
 
-    output.width = width;
-    output.height = height;
+    op->output.width = width;
+    op->output.height = height;
+    return status_success;
+}
 
-    pdma_config_output(ptr, &output);
-    pdma_start(ptr);
-    if (wait) {
-        hpm_stat_t stat;
-        do {
-            stat = pdma_check_status(ptr, status);
-        } while ((stat != status_pdma_done) && (stat != status_pdma_error));
-        pdma_stop(ptr);
+hpm_stat_t pdma_fill_color(PDMA_Type *ptr, uint32_t dst, uint32_t dst_width,
+                           uint32_t width, uint32_t height,
+                           uint32_t color, uint8_t alpha,
+                           display_pixel_format_t format,
+                           bool wait, uint32_t *status)
+{
+    pdma_op_config_t op;
+    hpm_stat_t stat;
+
+    stat = pdma_get_fill_color_config(ptr, &op, dst, dst_width, width, height, color, alpha, format);
+    if (stat != status_success) {
         return stat;
     }
-    return status_success;
+    return pdma_run_op(ptr, &op, wait, status);
 }
 
-hpm_stat_t pdma_flip_rotate(PDMA_Type *ptr, uint32_t dst, uint32_t dst_width,
-                    uint32_t src, uint32_t src_width, uint32_t x, uint32_t y,
-                    uint32_t width, uint32_t height,
-                    pdma_flip_t flip, pdma_rotate_t rotate, uint8_t alpha,
-                    display_pixel_format_t format,
-                    bool wait, uint32_t *status)
+hpm_stat_t pdma_get_flip_rotate_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                       uint32_t dst, uint32_t dst_width,
+                                       uint32_t src, uint32_t src_width, uint32_t x, uint32_t y,
+                                       uint32_t width, uint32_t height,
+                                       pdma_flip_t flip, pdma_rotate_t rotate, uint8_t alpha,
+                                       display_pixel_format_t format)
 {
-    pdma_config_t config;
-    pdma_plane_config_t plane_src;
-    pdma_plane_config_t plane_dst;
-    display_yuv2rgb_coef_t yuv2rgb_coef;
-    pdma_output_config_t output;
-
     if ((width + x > dst_width)
         /* YUV422 requires width to be 2-pixel aligned */
         || ((display_pixel_format_is_yuv_format(format)) && (width & 1))
@@ -526,85 +539,83 @@ hpm_stat_t pdma_flip_rotate(PDMA_Type *ptr, uint32_t dst, uint32_t dst_width,
         return status_invalid_argument;
     }
 
-    pdma_get_default_config(ptr, &config, format);
-    pdma_get_default_plane_config(ptr, &plane_src, format);
-    pdma_get_default_plane_config(ptr, &plane_dst, format);
-    pdma_get_default_yuv2rgb_coef_config(ptr, &yuv2rgb_coef, format);
-    pdma_get_default_output_config(ptr, &output, format);
+    pdma_get_default_config(ptr, &op->config, format);
+    pdma_get_default_plane_config(ptr, &op->plane_src, format);
+    pdma_get_default_plane_config(ptr, &op->plane_dst, format);
+    pdma_get_default_yuv2rgb_coef_config(ptr, &op->yuv2rgb_coef, format);
+    pdma_get_default_output_config(ptr, &op->output, format);
 
-    config.enable_plane = pdma_plane_both;
+    op->config.enable_plane = pdma_plane_both;
     if (width <= 16) {
-        config.block_size = pdma_blocksize_8x8;
+        op->config.block_size = pdma_blocksize_8x8;
     } else {
-        config.block_size = pdma_blocksize_16x16;
+        op->config.block_size = pdma_blocksize_16x16;
     }
-    pdma_init(ptr, &config);
 
-    plane_src.buffer = src;
-    plane_src.height = height;
-    plane_src.width = width;
-    plane_src.pitch = display_get_pitch_length_in_byte(format, src_width);
-    plane_src.flip = flip;
-    plane_src.rotate = rotate;
+    op->plane_src.buffer = src;
+    op->plane_src.height = height;
+    op->plane_src.width = width;
+    op->plane_src.pitch = display_get_pitch_length_in_byte(format, src_width);
+    op->plane_src.flip = flip;
+    op->plane_src.rotate = rotate;
 
-    plane_dst.buffer = src;
-    plane_dst.height = 1;
-    plane_dst.width = 1;
-    plane_dst.pitch = display_get_pitch_length_in_byte(format, dst_width);
-    plane_dst.flip = pdma_flip_none;
-    plane_dst.rotate = pdma_rotate_0_degree;
-    pdma_config_planes(ptr, &plane_src, &plane_dst, &yuv2rgb_coef);
+    op->plane_dst.buffer = src;
+    op->plane_dst.height = 1;
+    op->plane_dst.width = 1;
+    op->plane_dst.pitch = display_get_pitch_length_in_byte(format, dst_width);
+    op->plane_dst.flip = pdma_flip_none;
+    op->plane_dst.rotate = pdma_rotate_0_degree;
 
-    output.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
+    op->output.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
 
-    output.alphablend.src_alpha = alpha;
-    output.alphablend.src_alpha_op = display_alpha_op_override;
-    output.alphablend.mode = display_alphablend_mode_src_over;
+    op->output.alphablend.src_alpha = alpha;
+    op->output.alphablend.src_alpha_op = display_alpha_op_override;
+    op->output.alphablend.mode = display_alphablend_mode_src_over;
 
-    output.plane[pdma_plane_src].x = 0;
-    output.plane[pdma_plane_src].y = 0;
-    output.pitch = display_get_pitch_length_in_byte(format, dst_width);
+    op->output.plane[pdma_plane_src].x = 0;
+    op->output.plane[pdma_plane_src].y = 0;
+    op->output.pitch = display_get_pitch_length_in_byte(format, dst_width);
 
     if ((rotate == pdma_rotate_90_degree)
             || (rotate == pdma_rotate_270_degree)) {
-        output.width = height;
-        output.height = width;
-        output.plane[pdma_plane_src].width = height;
-        output.plane[pdma_plane_src].height = width;
+        op->output.width = height;
+        op->output.height = width;
+        op->output.plane[pdma_plane_src].width = height;
+        op->output.plane[pdma_plane_src].height = width;
     } else {
-        output.plane[pdma_plane_src].width = width;
-        output.plane[pdma_plane_src].height = height;
-        output.width = width;
-        output.height = height;
+        op->output.plane[pdma_plane_src].width = width;
+        op->output.plane[pdma_plane_src].height = height;
+        op->output.width = width;
+        op->output.height = height;
     }
+    return status_success;
+}
 
-    pdma_config_output(ptr, &output);
-    pdma_start(ptr);
-    if (wait) {
-        hpm_stat_t stat;
-        do {
-            stat = pdma_check_status(ptr, status);
-        } while ((stat != status_pdma_done) && (stat != status_pdma_error));
-        pdma_stop(ptr);
+hpm_stat_t pdma_flip_rotate(PDMA_Type *ptr, uint32_t dst, uint32_t dst_width,
+                    uint32_t src, uint32_t src_width, uint32_t x, uint32_t y,
+                    uint32_t width, uint32_t height,
+                    pdma_flip_t flip, pdma_rotate_t rotate, uint8_t alpha,
+                    display_pixel_format_t format,
+                    bool wait, uint32_t *status)
+{
+    pdma_op_config_t op;
+    hpm_stat_t stat;
+
+    stat = pdma_get_flip_rotate_config(ptr, &op, dst, dst_width, src, src_width, x, y,
+                                       width, height, flip, rotate, alpha, format);
+    if (stat != status_success) {
         return stat;
     }
-    return status_success;
+    return pdma_run_op(ptr, &op, wait, status);
 }
 
-hpm_stat_t pdma_blit(PDMA_Type *ptr,
-                     uint32_t dst, uint32_t dst_width,
-                     uint32_t src, uint32_t src_width,
-                     uint32_t x, uint32_t y, uint32_t width, uint32_t height,
-                     uint8_t alpha,
-                     display_pixel_format_t format,
-                     bool wait, uint32_t *status)
+hpm_stat_t pdma_get_blit_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                uint32_t dst, uint32_t dst_width,
+                                uint32_t src, uint32_t src_width,
+                                uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                uint8_t alpha,
+                                display_pixel_format_t format)
 {
-    pdma_config_t config;
-    pdma_plane_config_t plane_src;
-    pdma_plane_config_t plane_dst;
-    display_yuv2rgb_coef_t yuv2rgb_coef;
-    pdma_output_config_t output;
-
     if ((width + x > dst_width)
         /* YUV422 requires width to be 2-pixel aligned */
         || ((display_pixel_format_is_yuv_format(format)) && (width & 1))
@@ -612,63 +623,68 @@ hpm_stat_t pdma_blit(PDMA_Type *ptr,
         return status_invalid_argument;
     }
 
-    pdma_get_default_config(ptr, &config, format);
-    pdma_get_default_plane_config(ptr, &plane_src, format);
-    pdma_get_default_plane_config(ptr, &plane_dst, format);
-    pdma_get_default_yuv2rgb_coef_config(ptr, &yuv2rgb_coef, format);
-    pdma_get_default_output_config(ptr, &output, format);
+    pdma_get_default_config(ptr, &op->config, format);
+    pdma_get_default_plane_config(ptr, &op->plane_src, format);
+    pdma_get_default_plane_config(ptr, &op->plane_dst, format);
+    pdma_get_default_yuv2rgb_coef_config(ptr, &op->yuv2rgb_coef, format);
+    pdma_get_default_output_config(ptr, &op->output, format);
 
-    config.enable_plane = pdma_plane_both;
+    op->config.enable_plane = pdma_plane_both;
     if (width <= 16) {
-        config.block_size = pdma_blocksize_8x8;
+        op->config.block_size = pdma_blocksize_8x8;
     } else {
-        config.block_size = pdma_blocksize_16x16;
+        op->config.block_size = pdma_blocksize_16x16;
     }
-    pdma_init(ptr, &config);
 
-    plane_src.buffer = src;
-    plane_src.width = width;
-    plane_src.height = height;
-    plane_src.pitch = display_get_pitch_length_in_byte(format, src_width);
-    plane_src.background = 0x00FFFFFF;
+    op->plane_src.buffer = src;
+    op->plane_src.width = width;
+    op->plane_src.height = height;
+    op->plane_src.pitch = display_get_pitch_length_in_byte(format, src_width);
+    op->plane_src.background = 0x00FFFFFF;
 
-    plane_dst.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
-    plane_dst.width = width;
-    plane_dst.height = height;
-    plane_dst.pitch = display_get_pitch_length_in_byte(format, dst_width);
-    pdma_config_planes(ptr, &plane_src, &plane_dst, &yuv2rgb_coef);
+    op->plane_dst.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
+    op->plane_dst.width = width;
+    op->plane_dst.height = height;
+    op->plane_dst.pitch = display_get_pitch_length_in_byte(format, dst_width);
 
-    output.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
+    op->output.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
 
-    output.plane[pdma_plane_src].x = 0;
-    output.plane[pdma_plane_src].y = 0;
-    output.plane[pdma_plane_src].width = width;
-    output.plane[pdma_plane_src].height = height;
+    op->output.plane[pdma_plane_src].x = 0;
+    op->output.plane[pdma_plane_src].y = 0;
+    op->output.plane[pdma_plane_src].width = width;
+    op->output.plane[pdma_plane_src].height = height;
 
-    output.plane[pdma_plane_dst].x = 0;
-    output.plane[pdma_plane_dst].y = 0;
-    output.plane[pdma_plane_dst].width = width;
-    output.plane[pdma_plane_dst].height = height;
+    op->output.plane[pdma_plane_dst].x = 0;
+    op->output.plane[pdma_plane_dst].y = 0;
+    op->output.plane[pdma_plane_dst].width = width;
+    op->output.plane[pdma_plane_dst].height = height;
 
-    output.alphablend.src_alpha = alpha;
-    output.alphablend.src_alpha_op = display_alpha_op_override;
-    output.alphablend.mode = display_alphablend_mode_src_over;
+    op->output.alphablend.src_alpha = alpha;
+    op->output.alphablend.src_alpha_op = display_alpha_op_override;
+    op->output.alphablend.mode = display_alphablend_mode_src_over;
 
-    output.width = width;
-    output.height = height;
-    output.pitch = display_get_pitch_length_in_byte(format, dst_width);
+    op->output.width = width;
+    op->output.height = height;
+    op->output.pitch = display_get_pitch_length_in_byte(format, dst_width);
+    return status_success;
+}
 
-    pdma_config_output(ptr, &output);
-    pdma_start(ptr);
-    if (wait) {
-        hpm_stat_t stat;
-        do {
-            stat = pdma_check_status(ptr, status);
-        } while ((stat != status_pdma_done) && (stat != status_pdma_error));
-        pdma_stop(ptr);
+hpm_stat_t pdma_blit(PDMA_Type *ptr,
+                     uint32_t dst, uint32_t dst_width,
+                     uint32_t src, uint32_t src_width,
+                     uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                     uint8_t alpha,
+                     display_pixel_format_t format,
+                     bool wait, uint32_t *status)
+{
+    pdma_op_config_t op;
+    hpm_stat_t stat;
+
+    stat = pdma_get_blit_config(ptr, &op, dst, dst_width, src, src_width, x, y, width, height, alpha, format);
+    if (stat != status_success) {
         return stat;
     }
-    return status_success;
+    return pdma_run_op(ptr, &op, wait, status);
 }
 
 static void pdma_calculate_scale(uint32_t t, uint32_t target_t,
@@ -695,24 +711,17 @@ static void pdma_calculate_scale(uint32_t t, uint32_t target_t,
     return;
 }
 
-hpm_stat_t pdma_scale(PDMA_Type *ptr,
-                     uint32_t dst, uint32_t dst_width,
-                     uint32_t src, uint32_t src_width,
-                     uint32_t x, uint32_t y, uint32_t width, uint32_t height,
-                     uint32_t target_width, uint32_t target_height,
-                     uint8_t alpha,
-                     display_pixel_format_t format,
-                     bool wait, uint32_t *status)
+hpm_stat_t pdma_get_scale_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                 uint32_t dst, uint32_t dst_width,
+                                 uint32_t src, uint32_t src_width,
+                                 uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                                 uint32_t target_width, uint32_t target_height,
+                                 uint8_t alpha,
+                                 display_pixel_format_t format)
 {
     uint32_t scale;
     pdma_decimation_t dec;
 
-    pdma_config_t config;
-    pdma_plane_config_t plane_src;
-    pdma_plane_config_t plane_dst;
-    display_yuv2rgb_coef_t yuv2rgb_coef;
-    pdma_output_config_t output;
-
     if ((target_width + x > dst_width)
         /* YUV422 requires width to be 2-pixel aligned */
         || ((display_pixel_format_is_yuv_format(format)) && (width & 1))
@@ -720,75 +729,81 @@ hpm_stat_t pdma_scale(PDMA_Type *ptr,
         return status_invalid_argument;
     }
 
-    pdma_get_default_config(ptr, &config, format);
-    pdma_get_default_plane_config(ptr, &plane_src, format);
-    pdma_get_default_plane_config(ptr, &plane_dst, format);
-    pdma_get_default_yuv2rgb_coef_config(ptr, &yuv2rgb_coef, format);
-    pdma_get_default_output_config(ptr, &output, format);
+    pdma_get_default_config(ptr, &op->config, format);
+    pdma_get_default_plane_config(ptr, &op->plane_src, format);
+    pdma_get_default_plane_config(ptr, &op->plane_dst, format);
+    pdma_get_default_yuv2rgb_coef_config(ptr, &op->yuv2rgb_coef, format);
+    pdma_get_default_output_config(ptr, &op->output, format);
 
-    config.enable_plane = pdma_plane_both;
+    op->config.enable_plane = pdma_plane_both;
     if (width <= 16) {
-        config.block_size = pdma_blocksize_8x8;
+        op->config.block_size = pdma_blocksize_8x8;
     } else {
-        config.block_size = pdma_blocksize_16x16;
+        op->config.block_size = pdma_blocksize_16x16;
     }
-    pdma_init(ptr, &config);
 
-    plane_src.buffer = src;
-    plane_src.width = width;
-    plane_src.height = height;
-    plane_src.pitch = display_get_pitch_length_in_byte(format, src_width);
+    op->plane_src.buffer = src;
+    op->plane_src.width = width;
+    op->plane_src.height = height;
+    op->plane_src.pitch = display_get_pitch_length_in_byte(format, src_width);
 
     pdma_calculate_scale(width, target_width, &dec, &scale);
-    plane_src.x_scale = scale;
-    plane_src.x_dec = dec;
+    op->plane_src.x_scale = scale;
+    op->plane_src.x_dec = dec;
     pdma_calculate_scale(height, target_height, &dec, &scale);
-    plane_src.y_scale = scale;
-    plane_src.y_dec = dec;
-    plane_src.background = 0x00FFFFFF;
+    op->plane_src.y_scale = scale;
+    op->plane_src.y_dec = dec;
+    op->plane_src.background = 0x00FFFFFF;
 
     if (display_pixel_format_is_yuv_format(format)) {
-        plane_src.x_offset = PDMA_YUV_SCALE_DEFAULT_X_OFFSET;
+        op->plane_src.x_offset = PDMA_YUV_SCALE_DEFAULT_X_OFFSET;
     }
 
-    plane_dst.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
-    plane_dst.width = width;
-    plane_dst.height = height;
-    plane_dst.pitch = display_get_pitch_length_in_byte(format, dst_width);
-    pdma_config_planes(ptr, &plane_src, &plane_dst, &yuv2rgb_coef);
+    op->plane_dst.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
+    op->plane_dst.width = width;
+    op->plane_dst.height = height;
+    op->plane_dst.pitch = display_get_pitch_length_in_byte(format, dst_width);
 
-    output.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
+    op->output.buffer = dst + (y * dst_width + x) * display_get_pixel_size_in_byte(format);
 
-    output.plane[pdma_plane_src].x = 0;
-    output.plane[pdma_plane_src].y = 0;
-    output.plane[pdma_plane_src].width = target_width;
-    output.plane[pdma_plane_src].height = target_height;
+    op->output.plane[pdma_plane_src].x = 0;
+    op->output.plane[pdma_plane_src].y = 0;
+    op->output.plane[pdma_plane_src].width = target_width;
+    op->output.plane[pdma_plane_src].height = target_height;
 
-    output.plane[pdma_plane_dst].x = 0;
-    output.plane[pdma_plane_dst].y = 0;
-    output.plane[pdma_plane_dst].width = target_width;
-    output.plane[pdma_plane_dst].height = target_height;
+    op->output.plane[pdma_plane_dst].x = 0;
+    op->output.plane[pdma_plane_dst].y = 0;
+    op->output.plane[pdma_plane_dst].width = target_width;
+    op->output.plane[pdma_plane_dst].height = target_height;
 
-    output.alphablend.src_alpha = alpha;
-    output.alphablend.src_alpha_op = display_alpha_op_override;
-    output.alphablend.mode = display_alphablend_mode_src_over;
+    op->output.alphablend.src_alpha = alpha;
+    op->output.alphablend.src_alpha_op = display_alpha_op_override;
+    op->output.alphablend.mode = display_alphablend_mode_src_over;
 
-    output.width = target_width;
-    output.height = target_height;
-    output.pitch = display_get_pitch_length_in_byte(format, dst_width);
+    op->output.width = target_width;
+    op->output.height = target_height;
+    op->output.pitch = display_get_pitch_length_in_byte(format, dst_width);
+    return status_success;
+}
 
-    pdma_config_output(ptr, &output);
-    pdma_start(ptr);
-    if (wait) {
-        hpm_stat_t stat;
-        do {
-            stat = pdma_check_status(ptr, status);
-        } while ((stat != status_pdma_done) && (stat != status_pdma_error));
-        pdma_stop(ptr);
+hpm_stat_t pdma_scale(PDMA_Type *ptr,
+                     uint32_t dst, uint32_t dst_width,
+                     uint32_t src, uint32_t src_width,
+                     uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                     uint32_t target_width, uint32_t target_height,
+                     uint8_t alpha,
+                     display_pixel_format_t format,
+                     bool wait, uint32_t *status)
+{
+    pdma_op_config_t op;
+    hpm_stat_t stat;
+
+    stat = pdma_get_scale_config(ptr, &op, dst, dst_width, src, src_width, x, y, width, height,
+                                 target_width, target_height, alpha, format);
+    if (stat != status_success) {
         return stat;
     }
-    return status_success;
-
+    return pdma_run_op(ptr, &op, wait, status);
 }
 
 typedef struct pdma_buf2plane_format {
@@ -827,14 +842,13 @@ void pdma_get_default_blit_option(pdma_blit_option_t *op)
     op->translate.y = 0;
 }
 
-hpm_stat_t pdma_blit_ex(PDMA_Type *ptr,
-                     display_buf_t *dst,
-                     display_buf_t *src,
-                     pdma_blit_option_t *op,
-                     bool wait, uint32_t *status)
+hpm_stat_t pdma_get_blit_ex_config(PDMA_Type *ptr, pdma_op_config_t *op,
+                                   display_buf_t *dst,
+                                   display_buf_t *src,
+                                   pdma_blit_option_t *blit_op)
 {
     if ((!dst) || (!src) || (!src->buf) || (!dst->buf) ||
-        (op->scale.x > 4096) || (op->scale.y > 4096) ||
+        (blit_op->scale.x > 4096) || (blit_op->scale.y > 4096) ||
         /* YUV422 requires width to be 2-pixel aligned */
         ((display_pixel_format_is_yuv_format(plane_format_tab[src->format].format)) && (src->width & 1)) ||
         ((display_pixel_format_is_yuv_format(plane_format_tab[dst->format].format)) && (dst->width & 1))) {
@@ -846,81 +860,78 @@ hpm_stat_t pdma_blit_ex(PDMA_Type *ptr,
     uint32_t x_scale;
     uint32_t y_scale;
 
-    pdma_config_t config;
-    pdma_plane_config_t plane_src;
-    pdma_plane_config_t plane_dst;
-    display_yuv2rgb_coef_t yuv2rgb_coef;
-    pdma_output_config_t output;
-
-    pdma_calculate_scale(65536, (uint32_t)(65536 * op->scale.x), &x_dec, &x_scale);
-    pdma_calculate_scale(65536, (uint32_t)(65536 * op->scale.y), &y_dec, &y_scale);
-
-    pdma_get_default_plane_config(ptr, &plane_src, plane_format_tab[src->format].format);
-    pdma_get_default_plane_config(ptr, &plane_dst, plane_format_tab[dst->format].format);
-    pdma_get_default_yuv2rgb_coef_config(ptr, &yuv2rgb_coef, plane_format_tab[src->format].format);
-    pdma_get_default_output_config(ptr, &output, out_format_tab[dst->format].format);
-
-    config.enable_plane = pdma_plane_both;
-    config.block_size = pdma_blocksize_8x8;
-    config.byteorder = out_format_tab[dst->format].byteorder;
-    pdma_init(ptr, &config);
-
-    plane_src.buffer = (uint32_t)src->buf;
-    plane_src.byteorder = plane_format_tab[src->format].byteorder;
-    plane_src.width = src->width;
-    plane_src.height = src->height;
-    plane_src.pitch = src->stride;
-    plane_src.x_scale = x_scale;
-    plane_src.x_dec = x_dec;
-    plane_src.y_scale = y_scale;
-    plane_src.y_dec = y_dec;
-    plane_src.background = 0x00000000; /* alpha must be 0 */
-    plane_src.x_offset = PDMA_YUV_SCALE_DEFAULT_X_OFFSET;
-    plane_src.flip = op->flip;
-    plane_src.rotate = op->rotate;
-
-    plane_dst.buffer = (uint32_t)dst->buf;
-    plane_dst.byteorder = plane_format_tab[dst->format].byteorder;
-    plane_dst.width = dst->width;
-    plane_dst.height = dst->height;
-    plane_dst.pitch = dst->stride;
-    pdma_config_planes(ptr, &plane_src, &plane_dst, &yuv2rgb_coef);
-
-    output.buffer = plane_dst.buffer;
-    output.plane[pdma_plane_src].x = op->translate.x;
-    output.plane[pdma_plane_src].y = op->translate.y;
+    pdma_calculate_scale(65536, (uint32_t)(65536 * blit_op->scale.x), &x_dec, &x_scale);
+    pdma_calculate_scale(65536, (uint32_t)(65536 * blit_op->scale.y), &y_dec, &y_scale);
+
+    pdma_get_default_plane_config(ptr, &op->plane_src, plane_format_tab[src->format].format);
+    pdma_get_default_plane_config(ptr, &op->plane_dst, plane_format_tab[dst->format].format);
+    pdma_get_default_yuv2rgb_coef_config(ptr, &op->yuv2rgb_coef, plane_format_tab[src->format].format);
+    pdma_get_default_output_config(ptr, &op->output, out_format_tab[dst->format].format);
+
+    op->config.enable_plane = pdma_plane_both;
+    op->config.block_size = pdma_blocksize_8x8;
+    op->config.byteorder = out_format_tab[dst->format].byteorder;
+
+    op->plane_src.buffer = (uint32_t)src->buf;
+    op->plane_src.byteorder = plane_format_tab[src->format].byteorder;
+    op->plane_src.width = src->width;
+    op->plane_src.height = src->height;
+    op->plane_src.pitch = src->stride;
+    op->plane_src.x_scale = x_scale;
+    op->plane_src.x_dec = x_dec;
+    op->plane_src.y_scale = y_scale;
+    op->plane_src.y_dec = y_dec;
+    op->plane_src.background = 0x00000000; /* alpha must be 0 */
+    op->plane_src.x_offset = PDMA_YUV_SCALE_DEFAULT_X_OFFSET;
+    op->plane_src.flip = blit_op->flip;
+    op->plane_src.rotate = blit_op->rotate;
+
+    op->plane_dst.buffer = (uint32_t)dst->buf;
+    op->plane_dst.byteorder = plane_format_tab[dst->format].byteorder;
+    op->plane_dst.width = dst->width;
+    op->plane_dst.height = dst->height;
+    op->plane_dst.pitch = dst->stride;
+
+    op->output.buffer = op->plane_dst.buffer;
+    op->output.plane[pdma_plane_src].x = blit_op->translate.x;
+    op->output.plane[pdma_plane_src].y = blit_op->translate.y;
 
     /*
      * aligned to lower right of dst window and non-overlapping area is filled by background of src.
      * so alpha that background of src must be 0.
      */
-    output.plane[pdma_plane_src].width = dst->width - op->translate.x;
-    output.plane[pdma_plane_src].height = dst->height - op->translate.y;
-
-    output.plane[pdma_plane_dst].x = 0;
-    output.plane[pdma_plane_dst].y = 0;
-    output.plane[pdma_plane_dst].width = plane_dst.width;
-    output.plane[pdma_plane_dst].height = plane_dst.height;
-
-    output.alphablend.src_alpha = src->alpha.val;
-    output.alphablend.src_alpha_op = src->alpha.op;
-    output.alphablend.dst_alpha = dst->alpha.val;
-    output.alphablend.dst_alpha_op = dst->alpha.op;
-    output.alphablend.mode = op->blend;
+    op->output.plane[pdma_plane_src].width = dst->width - blit_op->translate.x;
+    op->output.plane[pdma_plane_src].height = dst->height - blit_op->translate.y;
+
+    op->output.plane[pdma_plane_dst].x = 0;
+    op->output.plane[pdma_plane_dst].y = 0;
+    op->output.plane[pdma_plane_dst].width = op->plane_dst.width;
+    op->output.plane[pdma_plane_dst].height = op->plane_dst.height;
+
+    op->output.alphablend.src_alpha = src->alpha.val;
+    op->output.alphablend.src_alpha_op = src->alpha.op;
+    op->output.alphablend.dst_alpha = dst->alpha.val;
+    op->output.alphablend.dst_alpha_op = dst->alpha.op;
+    op->output.alphablend.mode = blit_op->blend;
+
+    op->output.width = op->plane_dst.width;
+    op->output.height = op->plane_dst.height;
+    op->output.pitch = op->plane_dst.pitch;
+    return status_success;
+}
 
-    output.width = plane_dst.width;
-    output.height = plane_dst.height;
-    output.pitch = plane_dst.pitch;
+hpm_stat_t pdma_blit_ex(PDMA_Type *ptr,
+                     display_buf_t *dst,
+                     display_buf_t *src,
+                     pdma_blit_option_t *op,
+                     bool wait, uint32_t *status)
+{
+    pdma_op_config_t op_config;
+    hpm_stat_t stat;
 
-    pdma_config_output(ptr, &output);
-    pdma_start(ptr);
-    if (wait) {
-        hpm_stat_t stat;
-        do {
-            stat = pdma_check_status(ptr, status);
-        } while ((stat != status_pdma_done) && (stat != status_pdma_error));
-        pdma_stop(ptr);
+    stat = pdma_get_blit_ex_config(ptr, &op_config, dst, src, op);
+    if (stat != status_success) {
         return stat;
     }
-    return status_success;
-}
\ No newline at end of file
+    return pdma_run_op(ptr, &op_config, wait, status);
+}
@@ -186,3 +186,15 @@ hpm_stat_t sdm_receive_filter_data(SDM_Type *ptr, uint8_t ch_index, bool using_f
     return status_success;
 }
 
+uint32_t sdm_read_fifo_data(SDM_Type *ptr, uint8_t ch_index, int32_t *data, uint32_t max_count)
+{
+    uint32_t count = SDM_CH_SDST_FILL_GET(ptr->CH[ch_index].SDST);
+
+    if (count > max_count) {
+        count = max_count;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        data[i] = (int32_t)ptr->CH[ch_index].SDFIFO;
+    }
+    return count;
+}
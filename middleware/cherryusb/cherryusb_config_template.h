@@ -55,6 +55,11 @@
 #define CONFIG_USBDEV_MSC_MAX_BUFSIZE 512
 #endif
 
+/* Block buffers of CONFIG_USBDEV_MSC_MAX_BUFSIZE, 2 or more overlap media access with bulk transfers */
+#ifndef CONFIG_USBDEV_MSC_BUF_COUNT
+#define CONFIG_USBDEV_MSC_BUF_COUNT 1
+#endif
+
 #ifndef CONFIG_USBDEV_MSC_MANUFACTURER_STRING
 #define CONFIG_USBDEV_MSC_MANUFACTURER_STRING ""
 #endif
@@ -69,6 +74,9 @@
 
 // #define CONFIG_USBDEV_MSC_THREAD
 
+/* Media reads complete through usbd_msc_sector_read_done() */
+// #define CONFIG_USBDEV_MSC_ASYNC_READ
+
 #ifndef CONFIG_USBDEV_MSC_PRIO
 #define CONFIG_USBDEV_MSC_PRIO 4
 #endif
@@ -77,6 +85,30 @@
 #define CONFIG_USBDEV_MSC_STACKSIZE 2048
 #endif
 
+/* CDC ACM stream layer, usbd_cdc_acm_stream.c */
+#ifndef CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM
+#define CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM 2
+#endif
+
+#ifndef CONFIG_USBDEV_CDC_ACM_STREAM_MAX_XFER
+#define CONFIG_USBDEV_CDC_ACM_STREAM_MAX_XFER 16384
+#endif
+
+/* defaults to masking interrupts on RISC-V SoCs and to usb_osal_enter_critical_section() elsewhere */
+// #define CONFIG_USBDEV_CDC_ACM_STREAM_ENTER_CRITICAL()
+// #define CONFIG_USBDEV_CDC_ACM_STREAM_EXIT_CRITICAL(flags)
+
+/* Video stream engine, usbd_video_stream.c */
+#ifndef CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM
+#define CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM 1
+#endif
+
+/* defaults to masking interrupts on RISC-V SoCs and to usb_osal_enter_critical_section() elsewhere */
+// #define CONFIG_USBDEV_VIDEO_STREAM_ENTER_CRITICAL()
+// #define CONFIG_USBDEV_VIDEO_STREAM_EXIT_CRITICAL(flags)
+/* write back payload headers when frames are in cacheable memory */
+// #define CONFIG_USBDEV_VIDEO_STREAM_DCACHE_CLEAN(addr, size)
+
 #ifndef CONFIG_USBDEV_RNDIS_RESP_BUFFER_SIZE
 #define CONFIG_USBDEV_RNDIS_RESP_BUFFER_SIZE 156
 #endif
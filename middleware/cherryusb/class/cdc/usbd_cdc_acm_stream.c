@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2024, HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "usbd_core.h"
+#include "usbd_cdc_acm_stream.h"
+
+/*
+ * The endpoint callbacks run in the USB interrupt, the application side
+ * masks them while it checks and starts transfers. With the RISC-V SoC
+ * headers pulled in by usb_config.h interrupts are masked directly, which
+ * works with and without an OS.
+ */
+#ifndef CONFIG_USBDEV_CDC_ACM_STREAM_ENTER_CRITICAL
+#ifdef CSR_MSTATUS_MIE_MASK
+#define CONFIG_USBDEV_CDC_ACM_STREAM_ENTER_CRITICAL()      disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define CONFIG_USBDEV_CDC_ACM_STREAM_EXIT_CRITICAL(flags)  restore_global_irq((flags) & CSR_MSTATUS_MIE_MASK)
+#else
+#include "usb_osal.h"
+#define CONFIG_USBDEV_CDC_ACM_STREAM_ENTER_CRITICAL()      usb_osal_enter_critical_section()
+#define CONFIG_USBDEV_CDC_ACM_STREAM_EXIT_CRITICAL(flags)  usb_osal_leave_critical_section(flags)
+#endif
+#endif
+
+static struct usbd_cdc_acm_stream *g_usbd_cdc_acm_stream[CONFIG_USBDEV_MAX_BUS][CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM];
+
+static struct usbd_cdc_acm_stream *usbd_cdc_acm_stream_find(uint8_t busid, uint8_t ep)
+{
+    struct usbd_cdc_acm_stream *stream;
+
+    for (uint8_t i = 0; i < CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM; i++) {
+        stream = g_usbd_cdc_acm_stream[busid][i];
+        if ((stream != NULL) && ((stream->out_ep.ep_addr == ep) || (stream->in_ep.ep_addr == ep))) {
+            return stream;
+        }
+    }
+
+    return NULL;
+}
+
+static bool usbd_cdc_acm_stream_rx_arm(struct usbd_cdc_acm_stream *stream)
+{
+    uint8_t *buffer;
+    uint32_t size;
+
+    if (chry_ringbuffer_get_free(&stream->rx_rb) < stream->ep_mps) {
+        return false;
+    }
+
+    buffer = chry_ringbuffer_linear_write_setup(&stream->rx_rb, &size);
+    if (size < stream->ep_mps) {
+        /* a short packet left the write pointer close to the end of the pool */
+        buffer = stream->rx_bounce;
+        size = stream->ep_mps;
+        stream->rx_bounce_used = true;
+    } else {
+        size = MIN(size, CONFIG_USBDEV_CDC_ACM_STREAM_MAX_XFER);
+        size -= size % stream->ep_mps;
+        stream->rx_bounce_used = false;
+    }
+
+    stream->rx_busy = true;
+    usbd_ep_start_read(stream->busid, stream->out_ep.ep_addr, buffer, size);
+    return true;
+}
+
+static bool usbd_cdc_acm_stream_tx_next(struct usbd_cdc_acm_stream *stream, bool zlp)
+{
+    uint8_t *buffer;
+    uint32_t size;
+
+    buffer = chry_ringbuffer_linear_read_setup(&stream->tx_rb, &size);
+    if (size == 0) {
+        if (!zlp) {
+            return false;
+        }
+        stream->tx_len = 0;
+        stream->tx_busy = true;
+        usbd_ep_start_write(stream->busid, stream->in_ep.ep_addr, NULL, 0);
+        return true;
+    }
+
+    if (size > CONFIG_USBDEV_CDC_ACM_STREAM_MAX_XFER) {
+        size = CONFIG_USBDEV_CDC_ACM_STREAM_MAX_XFER - (CONFIG_USBDEV_CDC_ACM_STREAM_MAX_XFER % stream->ep_mps);
+    }
+
+    stream->tx_len = size;
+    stream->tx_busy = true;
+    usbd_ep_start_write(stream->busid, stream->in_ep.ep_addr, buffer, size);
+    return true;
+}
+
+static void usbd_cdc_acm_stream_bulk_out(uint8_t busid, uint8_t ep, uint32_t nbytes)
+{
+    struct usbd_cdc_acm_stream *stream = usbd_cdc_acm_stream_find(busid, ep);
+
+    if (stream == NULL) {
+        return;
+    }
+
+    stream->rx_busy = false;
+    if (!stream->active) {
+        /* the transfer was still armed when the stream was stopped */
+        chry_ringbuffer_reset(&stream->rx_rb);
+        return;
+    }
+
+    if (stream->rx_bounce_used) {
+        chry_ringbuffer_write(&stream->rx_rb, stream->rx_bounce, nbytes);
+    } else {
+        chry_ringbuffer_linear_write_done(&stream->rx_rb, nbytes);
+    }
+    stream->rx_bytes += nbytes;
+
+    /* re-arm before the callback, it may read and re-arm itself */
+    if (!usbd_cdc_acm_stream_rx_arm(stream)) {
+        stream->rx_pause_count++;
+        if (stream->cb) {
+            stream->cb(stream, USBD_CDC_ACM_STREAM_EVENT_RX_PAUSE);
+        }
+    }
+
+    if ((nbytes != 0) && stream->cb) {
+        stream->cb(stream, USBD_CDC_ACM_STREAM_EVENT_RX);
+    }
+}
+
+static void usbd_cdc_acm_stream_bulk_in(uint8_t busid, uint8_t ep, uint32_t nbytes)
+{
+    struct usbd_cdc_acm_stream *stream = usbd_cdc_acm_stream_find(busid, ep);
+    uint32_t len;
+
+    (void)nbytes;
+
+    if (stream == NULL) {
+        return;
+    }
+
+    len = stream->tx_len;
+    stream->tx_busy = false;
+    if (!stream->active) {
+        /* the transfer was still on the bus when the stream was stopped */
+        chry_ringbuffer_reset(&stream->tx_rb);
+        return;
+    }
+    if (len != 0) {
+        chry_ringbuffer_linear_read_done(&stream->tx_rb, len);
+        stream->tx_bytes += len;
+    }
+
+    /* a transfer of whole packets needs a ZLP unless more data follows */
+    if (!usbd_cdc_acm_stream_tx_next(stream, (len != 0) && ((len % stream->ep_mps) == 0))) {
+        if (stream->cb) {
+            stream->cb(stream, USBD_CDC_ACM_STREAM_EVENT_TX_EMPTY);
+        }
+    }
+
+    if ((len != 0) && stream->cb) {
+        stream->cb(stream, USBD_CDC_ACM_STREAM_EVENT_TX_SPACE);
+    }
+}
+
+int usbd_cdc_acm_stream_init(uint8_t busid, struct usbd_cdc_acm_stream *stream,
+                             uint8_t out_ep, uint8_t in_ep, uint16_t ep_mps,
+                             void *rx_pool, uint32_t rx_size,
+                             void *tx_pool, uint32_t tx_size,
+                             usbd_cdc_acm_stream_cb_t cb)
+{
+    uint8_t slot = CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM;
+    void *user_data;
+
+    if ((stream == NULL) || (ep_mps == 0) || (ep_mps > CONFIG_USBDEV_CDC_ACM_STREAM_MAX_MPS) || (rx_size < (2u * ep_mps))) {
+        return -USB_ERR_INVAL;
+    }
+
+    for (uint8_t i = 0; i < CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM; i++) {
+        if ((g_usbd_cdc_acm_stream[busid][i] == NULL) || (g_usbd_cdc_acm_stream[busid][i] == stream)) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot == CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM) {
+        return -USB_ERR_NOMEM;
+    }
+
+    user_data = stream->user_data;
+    memset(stream, 0, sizeof(struct usbd_cdc_acm_stream));
+    stream->user_data = user_data;
+    if ((chry_ringbuffer_init(&stream->rx_rb, rx_pool, rx_size) != 0) ||
+        (chry_ringbuffer_init(&stream->tx_rb, tx_pool, tx_size) != 0)) {
+        return -USB_ERR_INVAL;
+    }
+
+    stream->busid = busid;
+    stream->ep_mps = ep_mps;
+    stream->cb = cb;
+    stream->out_ep.ep_addr = out_ep;
+    stream->out_ep.ep_cb = usbd_cdc_acm_stream_bulk_out;
+    stream->in_ep.ep_addr = in_ep;
+    stream->in_ep.ep_cb = usbd_cdc_acm_stream_bulk_in;
+
+    g_usbd_cdc_acm_stream[busid][slot] = stream;
+    usbd_add_endpoint(busid, &stream->out_ep);
+    usbd_add_endpoint(busid, &stream->in_ep);
+
+    return 0;
+}
+
+void usbd_cdc_acm_stream_start(struct usbd_cdc_acm_stream *stream)
+{
+    size_t flags;
+
+    flags = CONFIG_USBDEV_CDC_ACM_STREAM_ENTER_CRITICAL();
+    /* transfers still armed at stop() never completed, the bus reset before the configuration flushed them */
+    if (stream->rx_busy) {
+        stream->rx_busy = false;
+        chry_ringbuffer_reset(&stream->rx_rb);
+    }
+    if (stream->tx_busy) {
+        stream->tx_busy = false;
+        chry_ringbuffer_reset(&stream->tx_rb);
+    }
+    stream->active = true;
+    if (!usbd_cdc_acm_stream_rx_arm(stream)) {
+        stream->rx_pause_count++;
+    }
+    usbd_cdc_acm_stream_tx_next(stream, false);
+    CONFIG_USBDEV_CDC_ACM_STREAM_EXIT_CRITICAL(flags);
+}
+
+void usbd_cdc_acm_stream_stop(struct usbd_cdc_acm_stream *stream)
+{
+    size_t flags;
+
+    flags = CONFIG_USBDEV_CDC_ACM_STREAM_ENTER_CRITICAL();
+    stream->active = false;
+    /* a ring with a transfer still armed is dropped by the completion callback instead */
+    if (!stream->rx_busy) {
+        chry_ringbuffer_reset(&stream->rx_rb);
+    }
+    if (!stream->tx_busy) {
+        chry_ringbuffer_reset(&stream->tx_rb);
+    }
+    CONFIG_USBDEV_CDC_ACM_STREAM_EXIT_CRITICAL(flags);
+}
+
+uint32_t usbd_cdc_acm_stream_write(struct usbd_cdc_acm_stream *stream, const void *data, uint32_t len)
+{
+    uint32_t written;
+    size_t flags;
+
+    written = chry_ringbuffer_write(&stream->tx_rb, (void *)data, len);
+
+    flags = CONFIG_USBDEV_CDC_ACM_STREAM_ENTER_CRITICAL();
+    if (stream->active && !stream->tx_busy) {
+        usbd_cdc_acm_stream_tx_next(stream, false);
+    }
+    CONFIG_USBDEV_CDC_ACM_STREAM_EXIT_CRITICAL(flags);
+
+    return written;
+}
+
+uint32_t usbd_cdc_acm_stream_read(struct usbd_cdc_acm_stream *stream, void *data, uint32_t len)
+{
+    uint32_t read;
+    size_t flags;
+
+    read = chry_ringbuffer_read(&stream->rx_rb, data, len);
+
+    if (read != 0) {
+        flags = CONFIG_USBDEV_CDC_ACM_STREAM_ENTER_CRITICAL();
+        if (stream->active && !stream->rx_busy) {
+            usbd_cdc_acm_stream_rx_arm(stream);
+        }
+        CONFIG_USBDEV_CDC_ACM_STREAM_EXIT_CRITICAL(flags);
+    }
+
+    return read;
+}
+
+uint32_t usbd_cdc_acm_stream_get_rx_used(struct usbd_cdc_acm_stream *stream)
+{
+    return chry_ringbuffer_get_used(&stream->rx_rb);
+}
+
+uint32_t usbd_cdc_acm_stream_get_tx_free(struct usbd_cdc_acm_stream *stream)
+{
+    return chry_ringbuffer_get_free(&stream->tx_rb);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024, HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef USBD_CDC_ACM_STREAM_H
+#define USBD_CDC_ACM_STREAM_H
+
+#include "usbd_core.h"
+#include "chry_ringbuffer.h"
+
+/*
+ * Streaming layer for the CDC ACM data interface.
+ *
+ * The bulk OUT endpoint always has a transfer armed straight into the rx ring
+ * buffer while there is room for a max size packet. When the ring is full the
+ * endpoint is left idle, so the host is NAKed until the application reads.
+ * Data written to the tx ring buffer is sent in transfers as large as the
+ * linear part of the ring allows, writes issued while a transfer is on the
+ * bus are coalesced into the next one, and a ZLP ends a transfer that is a
+ * multiple of the max packet size when no more data follows.
+ *
+ * Both ring buffer pools and the stream itself are accessed by the USB DMA,
+ * place them in USB_NOCACHE_RAM_SECTION. The rx pool must be at least two max
+ * size packets, both pool sizes must be powers of 2.
+ */
+
+#ifndef CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM
+#define CONFIG_USBDEV_CDC_ACM_STREAM_MAX_NUM 2
+#endif
+
+#ifndef CONFIG_USBDEV_CDC_ACM_STREAM_MAX_MPS
+#define CONFIG_USBDEV_CDC_ACM_STREAM_MAX_MPS 512
+#endif
+
+/* Upper bound of a single bulk transfer */
+#ifndef CONFIG_USBDEV_CDC_ACM_STREAM_MAX_XFER
+#define CONFIG_USBDEV_CDC_ACM_STREAM_MAX_XFER 16384
+#endif
+
+#define USBD_CDC_ACM_STREAM_EVENT_RX       (1U << 0) /* data added to the rx ring buffer */
+#define USBD_CDC_ACM_STREAM_EVENT_RX_PAUSE (1U << 1) /* rx ring buffer full, host NAKed until data is read */
+#define USBD_CDC_ACM_STREAM_EVENT_TX_SPACE (1U << 2) /* tx ring buffer space released */
+#define USBD_CDC_ACM_STREAM_EVENT_TX_EMPTY (1U << 3) /* all tx data sent */
+
+struct usbd_cdc_acm_stream;
+
+/* Called from the USB interrupt with one USBD_CDC_ACM_STREAM_EVENT_* */
+typedef void (*usbd_cdc_acm_stream_cb_t)(struct usbd_cdc_acm_stream *stream, uint32_t event);
+
+struct usbd_cdc_acm_stream {
+    uint8_t busid;
+    uint16_t ep_mps;
+    struct usbd_endpoint out_ep;
+    struct usbd_endpoint in_ep;
+    chry_ringbuffer_t rx_rb;
+    chry_ringbuffer_t tx_rb;
+    usbd_cdc_acm_stream_cb_t cb;
+    void *user_data;
+
+    volatile bool active;
+    volatile bool rx_busy;
+    volatile bool tx_busy;
+    bool rx_bounce_used;
+    uint32_t tx_len;
+
+    uint32_t rx_bytes;
+    uint32_t tx_bytes;
+    uint32_t rx_pause_count;
+
+    /* receives one packet when the linear end of the rx ring is smaller than a packet */
+    USB_MEM_ALIGNX uint8_t rx_bounce[CONFIG_USBDEV_CDC_ACM_STREAM_MAX_MPS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bind the bulk endpoints to the ring buffers, call before usbd_initialize(), user_data is kept */
+int usbd_cdc_acm_stream_init(uint8_t busid, struct usbd_cdc_acm_stream *stream,
+                             uint8_t out_ep, uint8_t in_ep, uint16_t ep_mps,
+                             void *rx_pool, uint32_t rx_size,
+                             void *tx_pool, uint32_t tx_size,
+                             usbd_cdc_acm_stream_cb_t cb);
+
+/* Call on USBD_EVENT_CONFIGURED */
+void usbd_cdc_acm_stream_start(struct usbd_cdc_acm_stream *stream);
+/*
+ * Call on USBD_EVENT_RESET and USBD_EVENT_DISCONNECTED, drops buffered data.
+ * A ring with a transfer still armed is dropped once that transfer ends.
+ */
+void usbd_cdc_acm_stream_stop(struct usbd_cdc_acm_stream *stream);
+
+/* Queue data for the host, returns the number of bytes accepted */
+uint32_t usbd_cdc_acm_stream_write(struct usbd_cdc_acm_stream *stream, const void *data, uint32_t len);
+/* Take received data, returns the number of bytes copied */
+uint32_t usbd_cdc_acm_stream_read(struct usbd_cdc_acm_stream *stream, void *data, uint32_t len);
+
+uint32_t usbd_cdc_acm_stream_get_rx_used(struct usbd_cdc_acm_stream *stream);
+uint32_t usbd_cdc_acm_stream_get_tx_free(struct usbd_cdc_acm_stream *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USBD_CDC_ACM_STREAM_H */
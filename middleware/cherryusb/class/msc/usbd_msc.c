@@ -26,6 +26,32 @@ enum Stage {
     MSC_WAIT_CSW = 4, /* Command Status Wrapper */
 };
 
+#if defined(CONFIG_USBDEV_MSC_THREAD)
+/* Thread events, besides MSC_DATA_OUT and MSC_DATA_IN which start a transfer */
+#define MSC_EVENT_DATA_IN_CPLT 0x10
+#define MSC_EVENT_READ_CPLT    0x11
+#define MSC_EVENT_QUEUE_DEPTH  4
+#endif
+
+#ifndef CONFIG_USBDEV_MSC_BUF_COUNT
+#define CONFIG_USBDEV_MSC_BUF_COUNT 1
+#endif
+
+#if (CONFIG_USBDEV_MSC_BUF_COUNT < 1) || (CONFIG_USBDEV_MSC_BUF_COUNT > 255)
+#error "CONFIG_USBDEV_MSC_BUF_COUNT must be between 1 and 255"
+#endif
+
+#if (CONFIG_USBDEV_MSC_MAX_BUFSIZE % CONFIG_USB_ALIGN_SIZE) != 0
+#error "CONFIG_USBDEV_MSC_MAX_BUFSIZE must be a multiple of CONFIG_USB_ALIGN_SIZE"
+#endif
+
+/* Block buffer state */
+enum msc_buf_state {
+    MSC_BUF_FREE = 0,  /* unused */
+    MSC_BUF_BUSY = 1,  /* owned by the media or by the bulk endpoint */
+    MSC_BUF_READY = 2, /* holds data waiting for the other side */
+};
+
 /* Device data structure */
 USB_NOCACHE_RAM_SECTION struct usbd_msc_priv {
     /* state of the bulk-only state machine */
@@ -39,17 +65,38 @@ USB_NOCACHE_RAM_SECTION struct usbd_msc_priv {
     uint8_t ASC;  /* Additional Sense Code */
     uint8_t ASQ;  /* Additional Sense Qualifier */
     uint8_t max_lun;
-    uint32_t start_sector;
-    uint32_t nsectors;
+    uint32_t start_sector;  /* next sector to read from / write to the media */
+    uint32_t nsectors;      /* sectors not yet sent to the host / written to the media */
+    uint32_t queue_sectors; /* sectors not yet queued to the media (read) / endpoint (write) */
+    uint32_t chunk_size;    /* bytes per block buffer, whole sectors */
     uint32_t scsi_blk_size[CONFIG_USBDEV_MSC_MAX_LUN];
     uint32_t scsi_blk_nbr[CONFIG_USBDEV_MSC_MAX_LUN];
 
-    USB_MEM_ALIGNX uint8_t block_buffer[CONFIG_USBDEV_MSC_MAX_BUFSIZE];
+    /*
+     * Block buffer ring. fill_idx is the next buffer handed to the first
+     * stage (media for reads, OUT endpoint for writes), xfer_idx the next
+     * buffer the second stage consumes, so a media access overlaps with the
+     * bulk transfer of the previous buffer.
+     */
+    uint8_t fill_idx;
+    uint8_t xfer_idx;
+    uint8_t ep_idx;
+    uint8_t media_idx;
+    bool ep_busy;
+    bool media_busy;
+    bool failed;
+    uint8_t buf_state[CONFIG_USBDEV_MSC_BUF_COUNT];
+    uint32_t buf_len[CONFIG_USBDEV_MSC_BUF_COUNT];
+
+    USB_MEM_ALIGNX uint8_t block_buffer[CONFIG_USBDEV_MSC_BUF_COUNT][CONFIG_USBDEV_MSC_MAX_BUFSIZE];
 
 #if defined(CONFIG_USBDEV_MSC_THREAD)
     usb_osal_mq_t usbd_msc_mq;
     usb_osal_thread_t usbd_msc_thread;
     uint32_t nbytes;
+#if defined(CONFIG_USBDEV_MSC_ASYNC_READ)
+    int media_result;
+#endif
 #endif
 } g_usbd_msc[CONFIG_USBDEV_MAX_BUS];
 
@@ -66,6 +113,8 @@ static void usbd_msc_reset(uint8_t busid)
 {
     g_usbd_msc[busid].stage = MSC_READ_CBW;
     g_usbd_msc[busid].readonly = false;
+    g_usbd_msc[busid].ep_busy = false;
+    g_usbd_msc[busid].media_busy = false;
 }
 
 static int msc_storage_class_interface_request_handler(uint8_t busid, struct usb_setup_packet *setup, uint8_t **data, uint32_t *len)
@@ -97,7 +146,7 @@ void msc_storage_notify_handler(uint8_t busid, uint8_t event, void *arg)
     switch (event) {
         case USBD_EVENT_INIT:
 #ifdef CONFIG_USBDEV_MSC_THREAD
-            g_usbd_msc[busid].usbd_msc_mq = usb_osal_mq_create(1);
+            g_usbd_msc[busid].usbd_msc_mq = usb_osal_mq_create(MSC_EVENT_QUEUE_DEPTH);
             if (g_usbd_msc[busid].usbd_msc_mq == NULL) {
                 USB_LOG_ERR("No memory to alloc for g_usbd_msc[busid].usbd_msc_mq\r\n");
             }
@@ -170,6 +219,8 @@ static void usbd_msc_send_info(uint8_t busid, uint8_t *buffer, uint8_t size)
 
 static bool SCSI_processWrite(uint8_t busid, uint32_t nbytes);
 static bool SCSI_processRead(uint8_t busid);
+static void usbd_msc_pipe_init(uint8_t busid);
+static void usbd_msc_start_next_out(uint8_t busid);
 
 /**
 * @brief  SCSI_SetSenseData
@@ -522,6 +573,7 @@ static bool SCSI_read10(uint8_t busid, uint8_t **data, uint32_t *len)
         return false;
     }
     g_usbd_msc[busid].stage = MSC_DATA_IN;
+    usbd_msc_pipe_init(busid);
 #ifdef CONFIG_USBDEV_MSC_THREAD
     usb_osal_mq_send(g_usbd_msc[busid].usbd_msc_mq, MSC_DATA_IN);
     return true;
@@ -554,6 +606,7 @@ static bool SCSI_read12(uint8_t busid, uint8_t **data, uint32_t *len)
         return false;
     }
     g_usbd_msc[busid].stage = MSC_DATA_IN;
+    usbd_msc_pipe_init(busid);
 #ifdef CONFIG_USBDEV_MSC_THREAD
     usb_osal_mq_send(g_usbd_msc[busid].usbd_msc_mq, MSC_DATA_IN);
     return true;
@@ -586,8 +639,8 @@ static bool SCSI_write10(uint8_t busid, uint8_t **data, uint32_t *len)
         return false;
     }
     g_usbd_msc[busid].stage = MSC_DATA_OUT;
-    data_len = MIN(data_len, CONFIG_USBDEV_MSC_MAX_BUFSIZE);
-    usbd_ep_start_read(busid, mass_ep_data[busid][MSD_OUT_EP_IDX].ep_addr, g_usbd_msc[busid].block_buffer, data_len);
+    usbd_msc_pipe_init(busid);
+    usbd_msc_start_next_out(busid);
     return true;
 }
 
@@ -615,8 +668,8 @@ static bool SCSI_write12(uint8_t busid, uint8_t **data, uint32_t *len)
         return false;
     }
     g_usbd_msc[busid].stage = MSC_DATA_OUT;
-    data_len = MIN(data_len, CONFIG_USBDEV_MSC_MAX_BUFSIZE);
-    usbd_ep_start_read(busid, mass_ep_data[busid][MSD_OUT_EP_IDX].ep_addr, g_usbd_msc[busid].block_buffer, data_len);
+    usbd_msc_pipe_init(busid);
+    usbd_msc_start_next_out(busid);
     return true;
 }
 /* do not use verify to reduce code size */
@@ -666,51 +719,220 @@ static bool SCSI_verify10(uint8_t busid, uint8_t **data, uint32_t *len)
 }
 #endif
 
+static void usbd_msc_pipe_init(uint8_t busid)
+{
+    uint32_t blk_size = g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN];
+
+    g_usbd_msc[busid].queue_sectors = g_usbd_msc[busid].nsectors;
+    g_usbd_msc[busid].chunk_size = (CONFIG_USBDEV_MSC_MAX_BUFSIZE / blk_size) * blk_size;
+    g_usbd_msc[busid].fill_idx = 0;
+    g_usbd_msc[busid].xfer_idx = 0;
+    g_usbd_msc[busid].ep_idx = 0;
+    g_usbd_msc[busid].media_idx = 0;
+    g_usbd_msc[busid].ep_busy = false;
+    g_usbd_msc[busid].media_busy = false;
+    g_usbd_msc[busid].failed = false;
+    memset(g_usbd_msc[busid].buf_state, MSC_BUF_FREE, sizeof(g_usbd_msc[busid].buf_state));
+}
+
+static uint8_t usbd_msc_next_buf(uint8_t idx)
+{
+    return (uint8_t)((idx + 1u) % CONFIG_USBDEV_MSC_BUF_COUNT);
+}
+
+/* Called when a data stage step fails, the CSW has to wait for a bulk transfer still on the bus */
+static void usbd_msc_data_failed(uint8_t busid)
+{
+    if (g_usbd_msc[busid].ep_busy) {
+        g_usbd_msc[busid].failed = true;
+    } else {
+        usbd_msc_send_csw(busid, CSW_STATUS_CMD_FAILED);
+    }
+}
+
+static void usbd_msc_start_next_in(uint8_t busid)
+{
+    uint8_t idx = g_usbd_msc[busid].xfer_idx;
+
+    if (g_usbd_msc[busid].ep_busy || (g_usbd_msc[busid].buf_state[idx] != MSC_BUF_READY)) {
+        return;
+    }
+
+    g_usbd_msc[busid].buf_state[idx] = MSC_BUF_BUSY;
+    g_usbd_msc[busid].ep_busy = true;
+    usbd_ep_start_write(busid, mass_ep_data[busid][MSD_IN_EP_IDX].ep_addr, g_usbd_msc[busid].block_buffer[idx], g_usbd_msc[busid].buf_len[idx]);
+}
+
+/* Fill free buffers from the media, each filled buffer is queued on the IN endpoint before the next media read */
 static bool SCSI_processRead(uint8_t busid)
 {
     uint32_t transfer_len;
+    uint32_t sector;
+    uint8_t idx;
+
+    while (1) {
+        usbd_msc_start_next_in(busid);
+
+        idx = g_usbd_msc[busid].fill_idx;
+        if ((g_usbd_msc[busid].queue_sectors == 0) || g_usbd_msc[busid].media_busy || (g_usbd_msc[busid].buf_state[idx] != MSC_BUF_FREE)) {
+            return true;
+        }
 
-    USB_LOG_DBG("read lba:%d\r\n", g_usbd_msc[busid].start_sector);
+        USB_LOG_DBG("read lba:%d\r\n", g_usbd_msc[busid].start_sector);
 
-    transfer_len = MIN(g_usbd_msc[busid].nsectors * g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN], CONFIG_USBDEV_MSC_MAX_BUFSIZE);
+        transfer_len = MIN(g_usbd_msc[busid].queue_sectors * g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN], g_usbd_msc[busid].chunk_size);
+        sector = g_usbd_msc[busid].start_sector;
 
-    if (usbd_msc_sector_read(busid, g_usbd_msc[busid].cbw.bLUN, g_usbd_msc[busid].start_sector, g_usbd_msc[busid].block_buffer, transfer_len) != 0) {
+        g_usbd_msc[busid].buf_state[idx] = MSC_BUF_BUSY;
+        g_usbd_msc[busid].buf_len[idx] = transfer_len;
+        g_usbd_msc[busid].start_sector += (transfer_len / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
+        g_usbd_msc[busid].queue_sectors -= (transfer_len / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
+        g_usbd_msc[busid].fill_idx = usbd_msc_next_buf(idx);
+
+#ifdef CONFIG_USBDEV_MSC_ASYNC_READ
+        g_usbd_msc[busid].media_idx = idx;
+        g_usbd_msc[busid].media_busy = true;
+        if (usbd_msc_sector_read_async(busid, g_usbd_msc[busid].cbw.bLUN, sector, g_usbd_msc[busid].block_buffer[idx], transfer_len) != 0) {
+            g_usbd_msc[busid].media_busy = false;
+            SCSI_SetSenseData(busid, SCSI_KCQHE_UREINRESERVEDAREA);
+            return false;
+        }
+#else
+        if (usbd_msc_sector_read(busid, g_usbd_msc[busid].cbw.bLUN, sector, g_usbd_msc[busid].block_buffer[idx], transfer_len) != 0) {
+            SCSI_SetSenseData(busid, SCSI_KCQHE_UREINRESERVEDAREA);
+            return false;
+        }
+        g_usbd_msc[busid].buf_state[idx] = MSC_BUF_READY;
+#endif
+    }
+}
+
+#ifdef CONFIG_USBDEV_MSC_ASYNC_READ
+static bool usbd_msc_read_media_done(uint8_t busid, int result)
+{
+    /* stale completion, e.g. after a bus reset */
+    if ((g_usbd_msc[busid].stage != MSC_DATA_IN) || !g_usbd_msc[busid].media_busy) {
+        return true;
+    }
+
+    g_usbd_msc[busid].media_busy = false;
+    if (result != 0) {
         SCSI_SetSenseData(busid, SCSI_KCQHE_UREINRESERVEDAREA);
         return false;
     }
+    g_usbd_msc[busid].buf_state[g_usbd_msc[busid].media_idx] = MSC_BUF_READY;
+
+    return SCSI_processRead(busid);
+}
+#endif
 
-    g_usbd_msc[busid].start_sector += (transfer_len / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
+static bool usbd_msc_read_in_done(uint8_t busid)
+{
+    uint8_t idx = g_usbd_msc[busid].xfer_idx;
+    uint32_t transfer_len = g_usbd_msc[busid].buf_len[idx];
+
+    g_usbd_msc[busid].ep_busy = false;
+    g_usbd_msc[busid].buf_state[idx] = MSC_BUF_FREE;
+    g_usbd_msc[busid].xfer_idx = usbd_msc_next_buf(idx);
     g_usbd_msc[busid].nsectors -= (transfer_len / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
     g_usbd_msc[busid].csw.dDataResidue -= transfer_len;
 
+    if (g_usbd_msc[busid].failed) {
+        usbd_msc_send_csw(busid, CSW_STATUS_CMD_FAILED);
+        return true;
+    }
+
     if (g_usbd_msc[busid].nsectors == 0) {
-        g_usbd_msc[busid].stage = MSC_SEND_CSW;
+        usbd_msc_send_csw(busid, CSW_STATUS_CMD_PASSED);
+        return true;
     }
 
-    usbd_ep_start_write(busid, mass_ep_data[busid][MSD_IN_EP_IDX].ep_addr, g_usbd_msc[busid].block_buffer, transfer_len);
+    return SCSI_processRead(busid);
+}
 
-    return true;
+static void usbd_msc_start_next_out(uint8_t busid)
+{
+    uint32_t data_len;
+    uint8_t idx = g_usbd_msc[busid].fill_idx;
+
+    if (g_usbd_msc[busid].ep_busy || (g_usbd_msc[busid].queue_sectors == 0) || (g_usbd_msc[busid].buf_state[idx] != MSC_BUF_FREE)) {
+        return;
+    }
+
+    data_len = MIN(g_usbd_msc[busid].queue_sectors * g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN], g_usbd_msc[busid].chunk_size);
+
+    g_usbd_msc[busid].buf_state[idx] = MSC_BUF_BUSY;
+    g_usbd_msc[busid].buf_len[idx] = data_len;
+    g_usbd_msc[busid].queue_sectors -= (data_len / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
+    g_usbd_msc[busid].ep_idx = idx;
+    g_usbd_msc[busid].ep_busy = true;
+    g_usbd_msc[busid].fill_idx = usbd_msc_next_buf(idx);
+    usbd_ep_start_read(busid, mass_ep_data[busid][MSD_OUT_EP_IDX].ep_addr, g_usbd_msc[busid].block_buffer[idx], data_len);
+}
+
+/*
+ * A media write failed, the data stage ends early: bulk-OUT is stalled so the host stops
+ * sending, and the CSW reports the sectors not written as residue (BOT 6.7.3, case Ho > Do).
+ * An OUT transfer queued ahead of the write cannot be withdrawn from the controller, so the
+ * stall and the CSW wait for its completion, the CBW read is then the only one on the endpoint.
+ */
+static void usbd_msc_write_failed(uint8_t busid)
+{
+    g_usbd_msc[busid].csw.dDataResidue = g_usbd_msc[busid].nsectors * g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN];
+    if (g_usbd_msc[busid].ep_busy) {
+        g_usbd_msc[busid].failed = true;
+        return;
+    }
+    /* all data received, a stall would hit the next CBW */
+    if (g_usbd_msc[busid].queue_sectors != 0) {
+        usbd_ep_set_stall(busid, mass_ep_data[busid][MSD_OUT_EP_IDX].ep_addr);
+    }
+    usbd_msc_send_csw(busid, CSW_STATUS_CMD_FAILED);
 }
 
+/* The next OUT transfer is queued before the received buffers are written to the media */
 static bool SCSI_processWrite(uint8_t busid, uint32_t nbytes)
 {
-    uint32_t data_len = 0;
-    USB_LOG_DBG("write lba:%d\r\n", g_usbd_msc[busid].start_sector);
+    uint8_t idx = g_usbd_msc[busid].ep_idx;
+
+    g_usbd_msc[busid].ep_busy = false;
 
-    if (usbd_msc_sector_write(busid, g_usbd_msc[busid].cbw.bLUN, g_usbd_msc[busid].start_sector, g_usbd_msc[busid].block_buffer, nbytes) != 0) {
-        SCSI_SetSenseData(busid, SCSI_KCQHE_WRITEFAULT);
+    if (g_usbd_msc[busid].failed) {
+        /* data received after a failed media write is dropped */
+        usbd_msc_write_failed(busid);
+        return true;
+    }
+    g_usbd_msc[busid].csw.dDataResidue -= nbytes;
+
+    if (nbytes != g_usbd_msc[busid].buf_len[idx]) {
+        SCSI_SetSenseData(busid, SCSI_KCQIR_INVALIDCOMMAND);
         return false;
     }
+    g_usbd_msc[busid].buf_state[idx] = MSC_BUF_READY;
 
-    g_usbd_msc[busid].start_sector += (nbytes / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
-    g_usbd_msc[busid].nsectors -= (nbytes / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
-    g_usbd_msc[busid].csw.dDataResidue -= nbytes;
+    usbd_msc_start_next_out(busid);
+
+    while (g_usbd_msc[busid].buf_state[g_usbd_msc[busid].xfer_idx] == MSC_BUF_READY) {
+        idx = g_usbd_msc[busid].xfer_idx;
+
+        USB_LOG_DBG("write lba:%d\r\n", g_usbd_msc[busid].start_sector);
+
+        if (usbd_msc_sector_write(busid, g_usbd_msc[busid].cbw.bLUN, g_usbd_msc[busid].start_sector, g_usbd_msc[busid].block_buffer[idx], g_usbd_msc[busid].buf_len[idx]) != 0) {
+            SCSI_SetSenseData(busid, SCSI_KCQHE_WRITEFAULT);
+            usbd_msc_write_failed(busid);
+            return true;
+        }
+
+        g_usbd_msc[busid].start_sector += (g_usbd_msc[busid].buf_len[idx] / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
+        g_usbd_msc[busid].nsectors -= (g_usbd_msc[busid].buf_len[idx] / g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN]);
+        g_usbd_msc[busid].buf_state[idx] = MSC_BUF_FREE;
+        g_usbd_msc[busid].xfer_idx = usbd_msc_next_buf(idx);
+
+        usbd_msc_start_next_out(busid);
+    }
 
     if (g_usbd_msc[busid].nsectors == 0) {
         usbd_msc_send_csw(busid, CSW_STATUS_CMD_PASSED);
-    } else {
-        data_len = MIN(g_usbd_msc[busid].nsectors * g_usbd_msc[busid].scsi_blk_size[g_usbd_msc[busid].cbw.bLUN], CONFIG_USBDEV_MSC_MAX_BUFSIZE);
-        usbd_ep_start_read(busid, mass_ep_data[busid][MSD_OUT_EP_IDX].ep_addr, g_usbd_msc[busid].block_buffer, data_len);
     }
 
     return true;
@@ -718,7 +940,7 @@ static bool SCSI_processWrite(uint8_t busid, uint32_t nbytes)
 
 static bool SCSI_CBWDecode(uint8_t busid, uint32_t nbytes)
 {
-    uint8_t *buf2send = g_usbd_msc[busid].block_buffer;
+    uint8_t *buf2send = g_usbd_msc[busid].block_buffer[0];
     uint32_t len2send = 0;
     bool ret = false;
 
@@ -820,7 +1042,7 @@ void mass_storage_bulk_out(uint8_t busid, uint8_t ep, uint32_t nbytes)
                     usb_osal_mq_send(g_usbd_msc[busid].usbd_msc_mq, MSC_DATA_OUT);
 #else
                     if (SCSI_processWrite(busid, nbytes) == false) {
-                        usbd_msc_send_csw(busid, CSW_STATUS_CMD_FAILED); /* send fail status to host,and the host will retry*/
+                        usbd_msc_data_failed(busid); /* send fail status to host,and the host will retry*/
                     }
 #endif
                     break;
@@ -841,10 +1063,10 @@ void mass_storage_bulk_in(uint8_t busid, uint8_t ep, uint32_t nbytes)
                 case SCSI_CMD_READ10:
                 case SCSI_CMD_READ12:
 #ifdef CONFIG_USBDEV_MSC_THREAD
-                    usb_osal_mq_send(g_usbd_msc[busid].usbd_msc_mq, MSC_DATA_IN);
+                    usb_osal_mq_send(g_usbd_msc[busid].usbd_msc_mq, MSC_EVENT_DATA_IN_CPLT);
 #else
-                    if (SCSI_processRead(busid) == false) {
-                        usbd_msc_send_csw(busid, CSW_STATUS_CMD_FAILED); /* send fail status to host,and the host will retry*/
+                    if (usbd_msc_read_in_done(busid) == false) {
+                        usbd_msc_data_failed(busid); /* send fail status to host,and the host will retry*/
                         return;
                     }
 #endif
@@ -885,12 +1107,22 @@ static void usbdev_msc_thread(void *argument)
         USB_LOG_DBG("%d\r\n", event);
         if (event == MSC_DATA_OUT) {
             if (SCSI_processWrite(busid, g_usbd_msc[busid].nbytes) == false) {
-                usbd_msc_send_csw(busid, CSW_STATUS_CMD_FAILED); /* send fail status to host,and the host will retry*/
+                usbd_msc_data_failed(busid); /* send fail status to host,and the host will retry*/
             }
         } else if (event == MSC_DATA_IN) {
             if (SCSI_processRead(busid) == false) {
-                usbd_msc_send_csw(busid, CSW_STATUS_CMD_FAILED); /* send fail status to host,and the host will retry*/
+                usbd_msc_data_failed(busid); /* send fail status to host,and the host will retry*/
+            }
+        } else if (event == MSC_EVENT_DATA_IN_CPLT) {
+            if (usbd_msc_read_in_done(busid) == false) {
+                usbd_msc_data_failed(busid);
+            }
+#ifdef CONFIG_USBDEV_MSC_ASYNC_READ
+        } else if (event == MSC_EVENT_READ_CPLT) {
+            if (usbd_msc_read_media_done(busid, g_usbd_msc[busid].media_result) == false) {
+                usbd_msc_data_failed(busid);
             }
+#endif
         } else {
         }
     }
@@ -936,3 +1168,17 @@ bool usbd_msc_set_popup(uint8_t busid)
 {
     return g_usbd_msc[busid].popup;
 }
+
+#ifdef CONFIG_USBDEV_MSC_ASYNC_READ
+void usbd_msc_sector_read_done(uint8_t busid, int result)
+{
+#ifdef CONFIG_USBDEV_MSC_THREAD
+    g_usbd_msc[busid].media_result = result;
+    usb_osal_mq_send(g_usbd_msc[busid].usbd_msc_mq, MSC_EVENT_READ_CPLT);
+#else
+    if (usbd_msc_read_media_done(busid, result) == false) {
+        usbd_msc_data_failed(busid);
+    }
+#endif
+}
+#endif
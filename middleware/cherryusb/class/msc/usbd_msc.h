@@ -22,6 +22,19 @@ void usbd_msc_get_cap(uint8_t busid, uint8_t lun, uint32_t *block_num, uint32_t
 int usbd_msc_sector_read(uint8_t busid, uint8_t lun, uint32_t sector, uint8_t *buffer, uint32_t length);
 int usbd_msc_sector_write(uint8_t busid, uint8_t lun, uint32_t sector, uint8_t *buffer, uint32_t length);
 
+#ifdef CONFIG_USBDEV_MSC_ASYNC_READ
+/*
+ * Start a media read instead of usbd_msc_sector_read(), return 0 if started.
+ * At most one read is outstanding, report its end with usbd_msc_sector_read_done().
+ */
+int usbd_msc_sector_read_async(uint8_t busid, uint8_t lun, uint32_t sector, uint8_t *buffer, uint32_t length);
+/*
+ * Report the end of usbd_msc_sector_read_async(), result 0 on success.
+ * Without CONFIG_USBDEV_MSC_THREAD this must not preempt the USB interrupt.
+ */
+void usbd_msc_sector_read_done(uint8_t busid, int result);
+#endif
+
 void usbd_msc_set_readonly(uint8_t busid, bool readonly);
 bool usbd_msc_set_popup(uint8_t busid);
 
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2024, HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "usbd_core.h"
+#include "usbd_video_stream.h"
+
+/*
+ * The endpoint callback runs in the USB interrupt, the application side
+ * masks it while it queues frames. Global interrupts are masked directly
+ * when usb_config.h pulled in the RISC-V SoC headers.
+ */
+#ifndef CONFIG_USBDEV_VIDEO_STREAM_ENTER_CRITICAL
+#ifdef CSR_MSTATUS_MIE_MASK
+#define CONFIG_USBDEV_VIDEO_STREAM_ENTER_CRITICAL()     disable_global_irq(CSR_MSTATUS_MIE_MASK)
+#define CONFIG_USBDEV_VIDEO_STREAM_EXIT_CRITICAL(flags) restore_global_irq((flags) & CSR_MSTATUS_MIE_MASK)
+#else
+#include "usb_osal.h"
+#define CONFIG_USBDEV_VIDEO_STREAM_ENTER_CRITICAL()     usb_osal_enter_critical_section()
+#define CONFIG_USBDEV_VIDEO_STREAM_EXIT_CRITICAL(flags) usb_osal_leave_critical_section(flags)
+#endif
+#endif
+
+/* Make header writes visible to the USB DMA when frames live in cacheable memory */
+#ifndef CONFIG_USBDEV_VIDEO_STREAM_DCACHE_CLEAN
+#define CONFIG_USBDEV_VIDEO_STREAM_DCACHE_CLEAN(addr, size)
+#endif
+
+#ifndef CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM
+#define CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM 1
+#endif
+
+static struct usbd_video_stream *g_usbd_video_stream[CONFIG_USBDEV_MAX_BUS][CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM];
+
+static struct usbd_video_stream *usbd_video_stream_find(uint8_t busid, uint8_t ep)
+{
+    for (uint8_t i = 0; i < CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM; i++) {
+        if ((g_usbd_video_stream[busid][i] != NULL) && (g_usbd_video_stream[busid][i]->in_ep.ep_addr == ep)) {
+            return g_usbd_video_stream[busid][i];
+        }
+    }
+
+    return NULL;
+}
+
+static void usbd_video_stream_send_payload(struct usbd_video_stream *stream)
+{
+    struct usbd_video_stream_frame *frame = &stream->frame[0];
+    uint8_t *header;
+    uint32_t len;
+
+    len = MIN(frame->len - stream->offset, stream->payload_size - USBD_VIDEO_STREAM_HEADER_SIZE);
+    header = frame->buf + stream->offset - USBD_VIDEO_STREAM_HEADER_SIZE;
+
+    if (stream->offset != 0) {
+        /* tail of the previous payload, already on the host */
+        memcpy(stream->saved, header, USBD_VIDEO_STREAM_HEADER_SIZE);
+        stream->saved_ptr = header;
+    } else {
+        stream->saved_ptr = NULL;
+    }
+
+    header[0] = USBD_VIDEO_STREAM_HEADER_SIZE;
+    header[1] = USBD_VIDEO_STREAM_BFH_EOH | stream->fid;
+    if ((stream->offset + len) == frame->len) {
+        header[1] |= USBD_VIDEO_STREAM_BFH_EOF;
+    }
+    CONFIG_USBDEV_VIDEO_STREAM_DCACHE_CLEAN(header, USBD_VIDEO_STREAM_HEADER_SIZE);
+
+    stream->xfer_len = len;
+    stream->busy = true;
+    usbd_ep_start_write(stream->busid, stream->in_ep.ep_addr, header, len + USBD_VIDEO_STREAM_HEADER_SIZE);
+}
+
+static void usbd_video_stream_restore(struct usbd_video_stream *stream)
+{
+    if (stream->saved_ptr != NULL) {
+        memcpy(stream->saved_ptr, stream->saved, USBD_VIDEO_STREAM_HEADER_SIZE);
+        CONFIG_USBDEV_VIDEO_STREAM_DCACHE_CLEAN(stream->saved_ptr, USBD_VIDEO_STREAM_HEADER_SIZE);
+        stream->saved_ptr = NULL;
+    }
+}
+
+/* hand back the frame of the last payload after stop, the transfer is over */
+static void usbd_video_stream_release_sending(struct usbd_video_stream *stream)
+{
+    uint8_t *frame = stream->frame[0].buf;
+
+    usbd_video_stream_restore(stream);
+    stream->frame[0].buf = NULL;
+    stream->frame[0].len = 0;
+    stream->offset = 0;
+    if (frame != NULL) {
+        stream->dropped++;
+        if (stream->cb) {
+            stream->cb(stream, frame, false);
+        }
+    }
+}
+
+static void usbd_video_stream_in(uint8_t busid, uint8_t ep, uint32_t nbytes)
+{
+    struct usbd_video_stream *stream = usbd_video_stream_find(busid, ep);
+    uint8_t *done;
+
+    (void)nbytes;
+
+    if ((stream == NULL) || !stream->busy) {
+        return;
+    }
+
+    stream->busy = false;
+    if (!stream->active) {
+        usbd_video_stream_release_sending(stream);
+        return;
+    }
+    usbd_video_stream_restore(stream);
+    stream->offset += stream->xfer_len;
+    stream->payloads++;
+    stream->bytes += stream->xfer_len + USBD_VIDEO_STREAM_HEADER_SIZE;
+
+    if (stream->offset == stream->frame[0].len) {
+        done = stream->frame[0].buf;
+        stream->frame[0] = stream->frame[1];
+        stream->frame[1].buf = NULL;
+        stream->frame[1].len = 0;
+        stream->offset = 0;
+        stream->fid ^= USBD_VIDEO_STREAM_BFH_FID;
+        stream->frames++;
+        if (stream->cb) {
+            stream->cb(stream, done, true);
+        }
+    }
+
+    if (stream->frame[0].buf != NULL) {
+        usbd_video_stream_send_payload(stream);
+    }
+}
+
+int usbd_video_stream_init(uint8_t busid, struct usbd_video_stream *stream, uint8_t in_ep,
+                           uint32_t payload_size, usbd_video_stream_cb_t cb)
+{
+    uint8_t slot = CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM;
+
+    if ((stream == NULL) || (payload_size <= USBD_VIDEO_STREAM_HEADER_SIZE)) {
+        return -USB_ERR_INVAL;
+    }
+
+    for (uint8_t i = 0; i < CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM; i++) {
+        if ((g_usbd_video_stream[busid][i] == NULL) || (g_usbd_video_stream[busid][i] == stream)) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot == CONFIG_USBDEV_VIDEO_STREAM_MAX_NUM) {
+        return -USB_ERR_NOMEM;
+    }
+
+    memset(stream, 0, sizeof(struct usbd_video_stream));
+    stream->busid = busid;
+    stream->payload_size = payload_size;
+    stream->cb = cb;
+    stream->in_ep.ep_addr = in_ep;
+    stream->in_ep.ep_cb = usbd_video_stream_in;
+
+    g_usbd_video_stream[busid][slot] = stream;
+    usbd_add_endpoint(busid, &stream->in_ep);
+
+    return 0;
+}
+
+void usbd_video_stream_start(struct usbd_video_stream *stream)
+{
+    size_t flags;
+
+    flags = CONFIG_USBDEV_VIDEO_STREAM_ENTER_CRITICAL();
+    if (stream->busy) {
+        /* the last payload before stop never completed: the endpoint was closed and opened again since */
+        stream->busy = false;
+        usbd_video_stream_release_sending(stream);
+    }
+    stream->offset = 0;
+    stream->saved_ptr = NULL;
+    stream->active = true;
+    CONFIG_USBDEV_VIDEO_STREAM_EXIT_CRITICAL(flags);
+}
+
+void usbd_video_stream_stop(struct usbd_video_stream *stream)
+{
+    struct usbd_video_stream_frame frame[2];
+    size_t flags;
+
+    flags = CONFIG_USBDEV_VIDEO_STREAM_ENTER_CRITICAL();
+    stream->active = false;
+    memcpy(frame, stream->frame, sizeof(frame));
+    if (stream->busy) {
+        /* the DCD still reads the payload and its header, the frame goes back when the transfer completes */
+        frame[0].buf = NULL;
+        stream->frame[1].buf = NULL;
+        stream->frame[1].len = 0;
+    } else {
+        memset(stream->frame, 0, sizeof(stream->frame));
+        stream->offset = 0;
+    }
+    CONFIG_USBDEV_VIDEO_STREAM_EXIT_CRITICAL(flags);
+
+    for (uint8_t i = 0; i < 2; i++) {
+        if (frame[i].buf != NULL) {
+            stream->dropped++;
+            if (stream->cb) {
+                stream->cb(stream, frame[i].buf, false);
+            }
+        }
+    }
+}
+
+int usbd_video_stream_submit(struct usbd_video_stream *stream, uint8_t *frame, uint32_t len)
+{
+    size_t flags;
+    int ret = 0;
+
+    if ((frame == NULL) || (len == 0)) {
+        return -USB_ERR_INVAL;
+    }
+
+    flags = CONFIG_USBDEV_VIDEO_STREAM_ENTER_CRITICAL();
+    if (!stream->active) {
+        ret = -USB_ERR_NOTCONN;
+    } else if (stream->frame[0].buf == NULL) {
+        stream->frame[0].buf = frame;
+        stream->frame[0].len = len;
+        stream->offset = 0;
+        usbd_video_stream_send_payload(stream);
+    } else if (stream->frame[1].buf == NULL) {
+        stream->frame[1].buf = frame;
+        stream->frame[1].len = len;
+    } else {
+        ret = -USB_ERR_BUSY;
+    }
+    CONFIG_USBDEV_VIDEO_STREAM_EXIT_CRITICAL(flags);
+
+    return ret;
+}
+
+void usbd_video_stream_get_stat(struct usbd_video_stream *stream, uint32_t now_ms, struct usbd_video_stream_stat *stat)
+{
+    uint32_t elapsed = now_ms - stream->last_ms;
+    size_t flags;
+
+    flags = CONFIG_USBDEV_VIDEO_STREAM_ENTER_CRITICAL();
+    stat->frames = stream->frames;
+    stat->dropped = stream->dropped;
+    stat->payloads = stream->payloads;
+    stat->bytes = stream->bytes;
+    CONFIG_USBDEV_VIDEO_STREAM_EXIT_CRITICAL(flags);
+
+    if (elapsed != 0) {
+        stat->fps_x100 = (uint32_t)(((uint64_t)(stat->frames - stream->last_frames) * 100000u) / elapsed);
+        stat->bytes_per_sec = (uint32_t)(((stat->bytes - stream->last_bytes) * 1000u) / elapsed);
+    } else {
+        stat->fps_x100 = 0;
+        stat->bytes_per_sec = 0;
+    }
+
+    stream->last_ms = now_ms;
+    stream->last_frames = stat->frames;
+    stream->last_bytes = stat->bytes;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024, HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef USBD_VIDEO_STREAM_H
+#define USBD_VIDEO_STREAM_H
+
+#include "usbd_core.h"
+#include "usbd_video.h"
+
+/*
+ * UVC payload streaming engine.
+ *
+ * Frames are sent straight from the buffer handed to usbd_video_stream_submit(),
+ * one payload per transfer. The 2 byte payload header is written just in front
+ * of each payload's data: into the headroom before the frame for the first
+ * payload, over the already sent tail of the previous payload for the others.
+ * The overwritten bytes are restored once the payload is sent, so the frame is
+ * unchanged when it is handed back.
+ *
+ * Frames must be preceded by USBD_VIDEO_STREAM_HEADROOM bytes the engine may
+ * use, and must be visible to the USB DMA (noncacheable, or written back by
+ * the producer; header writes go through CONFIG_USBDEV_VIDEO_STREAM_DCACHE_CLEAN).
+ * Payloads start at arbitrary byte offsets, the DCD must accept that.
+ */
+
+#define USBD_VIDEO_STREAM_HEADER_SIZE 2
+#define USBD_VIDEO_STREAM_HEADROOM    USBD_VIDEO_STREAM_HEADER_SIZE
+
+/* Bit field header */
+#define USBD_VIDEO_STREAM_BFH_FID (1U << 0)
+#define USBD_VIDEO_STREAM_BFH_EOF (1U << 1)
+#define USBD_VIDEO_STREAM_BFH_EOH (1U << 7)
+
+struct usbd_video_stream;
+
+/*
+ * Called when a frame was sent (sent true), from the USB interrupt, or dropped
+ * by usbd_video_stream_stop() (sent false). A frame whose payload is on the bus
+ * at stop goes back once that transfer completed, or from the next
+ * usbd_video_stream_start() when the DCD dropped the transfer with the endpoint.
+ */
+typedef void (*usbd_video_stream_cb_t)(struct usbd_video_stream *stream, uint8_t *frame, bool sent);
+
+struct usbd_video_stream_frame {
+    uint8_t *buf;
+    uint32_t len;
+};
+
+struct usbd_video_stream_stat {
+    uint32_t frames;          /* frames sent */
+    uint32_t dropped;         /* frames released unsent */
+    uint32_t payloads;        /* payload transfers */
+    uint64_t bytes;           /* bytes sent, headers included */
+    uint32_t fps_x100;        /* frames per second * 100 since the previous call */
+    uint32_t bytes_per_sec;   /* bandwidth since the previous call */
+};
+
+struct usbd_video_stream {
+    uint8_t busid;
+    struct usbd_endpoint in_ep;
+    uint32_t payload_size;
+    usbd_video_stream_cb_t cb;
+    void *user_data;
+
+    /* frame on the bus and the one queued behind it */
+    struct usbd_video_stream_frame frame[2];
+    uint32_t offset;
+    uint32_t xfer_len;
+    uint8_t *saved_ptr;
+    uint8_t saved[USBD_VIDEO_STREAM_HEADER_SIZE];
+    uint8_t fid;
+    volatile bool active;
+    volatile bool busy;
+
+    uint32_t frames;
+    uint32_t dropped;
+    uint32_t payloads;
+    uint64_t bytes;
+    uint32_t last_ms;
+    uint32_t last_frames;
+    uint64_t last_bytes;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* payload_size is dwMaxPayloadTransferSize, call before usbd_initialize() */
+int usbd_video_stream_init(uint8_t busid, struct usbd_video_stream *stream, uint8_t in_ep,
+                           uint32_t payload_size, usbd_video_stream_cb_t cb);
+
+/* Call from usbd_video_open() / usbd_video_close(), start once the IN endpoint is open again */
+void usbd_video_stream_start(struct usbd_video_stream *stream);
+void usbd_video_stream_stop(struct usbd_video_stream *stream);
+
+/*
+ * Queue a frame, at most one frame waits behind the one being sent.
+ * Returns 0, -USB_ERR_BUSY if both slots are taken, -USB_ERR_NOTCONN if stopped.
+ */
+int usbd_video_stream_submit(struct usbd_video_stream *stream, uint8_t *frame, uint32_t len);
+
+/* Counters, rates are computed over the time since the previous call */
+void usbd_video_stream_get_stat(struct usbd_video_stream *stream, uint32_t now_ms, struct usbd_video_stream_stat *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USBD_VIDEO_STREAM_H */
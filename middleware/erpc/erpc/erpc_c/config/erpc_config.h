@@ -41,6 +41,9 @@
 #define ERPC_NESTED_CALLS_DISABLED (0U) //!< No nested calls support.
 #define ERPC_NESTED_CALLS_ENABLED (1U)  //!< Nested calls support.
 
+#define ERPC_CLIENT_REQUEST_REUSE_DISABLED (0U) //!< Every request is created through the factories.
+#define ERPC_CLIENT_REQUEST_REUSE_ENABLED (1U)  //!< Codec of the last request is reused.
+
 #define ERPC_NESTED_CALLS_DETECTION_DISABLED (0U) //!< Nested calls detection disabled.
 #define ERPC_NESTED_CALLS_DETECTION_ENABLED (1U)  //!< Nested calls detection enabled.
 
@@ -119,6 +122,20 @@
 //! Default value is set to 2.
 //#define ERPC_DEFAULT_BUFFERS_COUNT (2U)
 
+//! @def ERPC_POOL_BUFFERS_COUNT
+//!
+//! Uncomment to change the count of buffers held by the lock-free pool message buffer factory
+//! (erpc_mbf_pool_init()). Default value is ERPC_DEFAULT_BUFFERS_COUNT.
+//#define ERPC_POOL_BUFFERS_COUNT (4U)
+
+//! @def ERPC_CLIENT_REQUEST_REUSE
+//!
+//! Default set to ERPC_CLIENT_REQUEST_REUSE_DISABLED. Uncomment to let the client manager keep the codec
+//! of the last released request and hand it to the next one, so a call does not go through the codec
+//! factory. Message buffers still come from and go back to the buffer factory on every call, which
+//! keeps the option usable with the RPMsg zero copy buffer factory.
+//#define ERPC_CLIENT_REQUEST_REUSE (ERPC_CLIENT_REQUEST_REUSE_ENABLED)
+
 //! @def ERPC_NOEXCEPT
 //!
 //! @brief Disable/enable noexcept support.
@@ -17,6 +17,7 @@
 #include <new>
 #endif
 #include <cassert>
+#include <cstring>
 
 using namespace erpc;
 
@@ -26,6 +27,96 @@ using namespace erpc;
 
 const uint32_t BasicCodec::kBasicCodecVersion = 1UL;
 
+/*!
+ * @brief Apply the endianness conversion to every element of an array in place.
+ *
+ * With the default endianness header the conversion macros are empty and the loops are
+ * optimized away.
+ */
+static void convertArray(uint8_t *data, uint32_t elementSize, uint32_t count, bool toWire)
+{
+    uint32_t i;
+
+    switch (elementSize)
+    {
+        case sizeof(uint16_t):
+            for (i = 0; i < count; i++)
+            {
+                uint16_t v;
+                (void)memcpy(&v, &data[i * sizeof(v)], sizeof(v));
+                if (toWire)
+                {
+                    ERPC_WRITE_AGNOSTIC_16(v);
+                }
+                else
+                {
+                    ERPC_READ_AGNOSTIC_16(v);
+                }
+                (void)memcpy(&data[i * sizeof(v)], &v, sizeof(v));
+            }
+            break;
+        case sizeof(uint32_t):
+            for (i = 0; i < count; i++)
+            {
+                uint32_t v;
+                (void)memcpy(&v, &data[i * sizeof(v)], sizeof(v));
+                if (toWire)
+                {
+                    ERPC_WRITE_AGNOSTIC_32(v);
+                }
+                else
+                {
+                    ERPC_READ_AGNOSTIC_32(v);
+                }
+                (void)memcpy(&data[i * sizeof(v)], &v, sizeof(v));
+            }
+            break;
+        case sizeof(uint64_t):
+            for (i = 0; i < count; i++)
+            {
+                uint64_t v;
+                (void)memcpy(&v, &data[i * sizeof(v)], sizeof(v));
+                if (toWire)
+                {
+                    ERPC_WRITE_AGNOSTIC_64(v);
+                }
+                else
+                {
+                    ERPC_READ_AGNOSTIC_64(v);
+                }
+                (void)memcpy(&data[i * sizeof(v)], &v, sizeof(v));
+            }
+            break;
+        default:
+            // Single bytes need no conversion.
+            break;
+    }
+}
+
+/*!
+ * @brief Return array length in bytes, 0 for invalid element size or overflow.
+ */
+static uint32_t arrayLength(uint32_t elementSize, uint32_t count, erpc_status_t *status)
+{
+    uint32_t length = 0;
+
+    if ((elementSize != 1U) && (elementSize != 2U) && (elementSize != 4U) && (elementSize != 8U))
+    {
+        *status = kErpcStatus_InvalidArgument;
+    }
+    else if (count > (UINT32_MAX / elementSize))
+    {
+        *status = kErpcStatus_BufferOverrun;
+    }
+    else
+    {
+        length = elementSize * count;
+        *status = kErpcStatus_Success;
+    }
+
+    return length;
+}
+
 void BasicCodec::startWriteMessage(message_type_t type, uint32_t service, uint32_t request, uint32_t sequence)
 {
     uint32_t header =
@@ -155,6 +246,32 @@ void BasicCodec::startWriteUnion(int32_t discriminator)
     write(discriminator);
 }
 
+void BasicCodec::writeArray(const void *value, uint32_t elementSize, uint32_t count)
+{
+    erpc_status_t err;
+    uint32_t length = arrayLength(elementSize, count, &err);
+
+    if (err != kErpcStatus_Success)
+    {
+        updateStatus(err);
+    }
+    else if (isStatusOk())
+    {
+        uint8_t *pos = m_cursor.get();
+
+        m_status = m_cursor.write(value, length);
+        if (isStatusOk())
+        {
+            convertArray(pos, elementSize, count, true);
+        }
+    }
+}
+
+void BasicCodec::writeStruct(const void *value, uint32_t size)
+{
+    writeData(value, size);
+}
+
 void BasicCodec::writeNullFlag(bool isNull)
 {
     write(static_cast<uint8_t>(isNull ? kIsNull : kNotNull));
@@ -423,6 +540,30 @@ void BasicCodec::readCallback(funPtr callbacks1, funPtr *callback2)
     *callback2 = callbacks1;
 }
 
+void BasicCodec::readArray(void *value, uint32_t elementSize, uint32_t count)
+{
+    erpc_status_t err;
+    uint32_t length = arrayLength(elementSize, count, &err);
+
+    if (err != kErpcStatus_Success)
+    {
+        updateStatus(err);
+    }
+    else if (isStatusOk())
+    {
+        m_status = m_cursor.read(value, length);
+        if (isStatusOk())
+        {
+            convertArray(static_cast<uint8_t *>(value), elementSize, count, false);
+        }
+    }
+}
+
+void BasicCodec::readStruct(void *value, uint32_t size)
+{
+    readData(value, size);
+}
+
 ERPC_MANUALLY_CONSTRUCTED_ARRAY_STATIC(BasicCodec, s_basicCodecManual, ERPC_CODEC_COUNT);
 
 Codec *BasicCodecFactory::create(void)
@@ -206,6 +206,28 @@ public:
      * @param[out] callback2 Callback which ID should be serialized.
      */
     virtual void writeCallback(funPtr callback1, funPtr callback2) override;
+
+    /*!
+     * @brief Prototype for write array of scalars in one step.
+     *
+     * The elements are copied into the buffer at once and byte swapped in place only when
+     * the endianness header requires it.
+     *
+     * @param[in] value Pointer to first element.
+     * @param[in] elementSize Size of one element in bytes, 1, 2, 4 or 8.
+     * @param[in] count Number of elements.
+     */
+    virtual void writeArray(const void *value, uint32_t elementSize, uint32_t count) override;
+
+    /*!
+     * @brief Prototype for write plain structure in one step.
+     *
+     * The structure is copied into the buffer as it is, with one bounds check.
+     *
+     * @param[in] value Pointer to the structure.
+     * @param[in] size Size of the structure in bytes.
+     */
+    virtual void writeStruct(const void *value, uint32_t size) override;
     //@}
 
     //! @name Decoding
@@ -367,6 +389,23 @@ public:
      * @param[out] callback2 Callback which is deserialized.
      */
     virtual void readCallback(funPtr callbacks1, funPtr *callback2) override;
+
+    /*!
+     * @brief Prototype for read array of scalars in one step.
+     *
+     * @param[out] value Pointer to first element.
+     * @param[in] elementSize Size of one element in bytes, 1, 2, 4 or 8.
+     * @param[in] count Number of elements.
+     */
+    virtual void readArray(void *value, uint32_t elementSize, uint32_t count) override;
+
+    /*!
+     * @brief Prototype for read plain structure in one step.
+     *
+     * @param[out] value Pointer to the structure.
+     * @param[in] size Size of the structure in bytes.
+     */
+    virtual void readStruct(void *value, uint32_t size) override;
     //@}
 };
 
@@ -184,9 +184,19 @@ void ClientManager::verifyReply(RequestContext &request)
 
 Codec *ClientManager::createBufferAndCodec(void)
 {
-    Codec *codec = m_codecFactory->create();
+    Codec *codec;
     MessageBuffer message;
 
+#if ERPC_CLIENT_REQUEST_REUSE
+    // Take the codec of the last released request.
+    codec = __atomic_exchange_n(&m_cachedCodec, (Codec *)NULL, __ATOMIC_ACQUIRE);
+    if (codec == NULL)
+    {
+        codec = m_codecFactory->create();
+    }
+#else
+    codec = m_codecFactory->create();
+#endif
     if (codec != NULL)
     {
         message = m_messageFactory->create();
@@ -207,10 +217,20 @@ Codec *ClientManager::createBufferAndCodec(void)
 
 void ClientManager::releaseRequest(RequestContext &request)
 {
-    if (request.getCodec() != NULL)
+    Codec *codec = request.getCodec();
+
+    if (codec != NULL)
+    {
+        // The buffer always goes back to its factory, e.g. to RPMsg.
+        m_messageFactory->dispose(codec->getBuffer());
+#if ERPC_CLIENT_REQUEST_REUSE
+        // Keep the codec for the next request, dispose of the one cached before if any.
+        codec = __atomic_exchange_n(&m_cachedCodec, codec, __ATOMIC_RELEASE);
+#endif
+    }
+    if (codec != NULL)
     {
-        m_messageFactory->dispose(request.getCodec()->getBuffer());
-        m_codecFactory->dispose(request.getCodec());
+        m_codecFactory->dispose(codec);
     }
 }
 
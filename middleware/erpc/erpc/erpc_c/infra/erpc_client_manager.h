@@ -63,6 +63,9 @@ public:
     : ClientServerCommon()
     , m_sequence(0)
     , m_errorHandler(NULL)
+#if ERPC_CLIENT_REQUEST_REUSE
+    , m_cachedCodec(NULL)
+#endif
 #if ERPC_NESTED_CALLS
     , m_server(NULL)
     , m_serverThreadId(NULL)
@@ -132,6 +135,9 @@ public:
 protected:
     uint32_t m_sequence;                    //!< Sequence number.
     client_error_handler_t m_errorHandler;  //!< Pointer to function error handler.
+#if ERPC_CLIENT_REQUEST_REUSE
+    Codec *m_cachedCodec; //!< Codec of the last released request.
+#endif
 #if ERPC_NESTED_CALLS
     Server *m_server;                     //!< Server used for nested calls.
     Thread::thread_id_t m_serverThreadId; //!< Thread in which server run function is called.
@@ -274,6 +274,62 @@ public:
      * @param[out] callback2 Callback which ID should be serialized.
      */
     virtual void writeCallback(funPtr callback1, funPtr callback2) = 0;
+
+    /*!
+     * @brief Prototype for write array of scalars in one step.
+     *
+     * Produces the same stream as calling write() for every element. This default writes element
+     * by element, codecs override it to copy the array with a single bounds check.
+     *
+     * @param[in] value Pointer to first element.
+     * @param[in] elementSize Size of one element in bytes, 1, 2, 4 or 8.
+     * @param[in] count Number of elements.
+     */
+    virtual void writeArray(const void *value, uint32_t elementSize, uint32_t count)
+    {
+        const uint8_t *data = (const uint8_t *)value;
+        uint16_t v16;
+        uint32_t v32;
+        uint64_t v64;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            switch (elementSize)
+            {
+                case sizeof(uint8_t):
+                    write(data[i]);
+                    break;
+                case sizeof(uint16_t):
+                    (void)memcpy(&v16, &data[i * sizeof(v16)], sizeof(v16));
+                    write(v16);
+                    break;
+                case sizeof(uint32_t):
+                    (void)memcpy(&v32, &data[i * sizeof(v32)], sizeof(v32));
+                    write(v32);
+                    break;
+                case sizeof(uint64_t):
+                    (void)memcpy(&v64, &data[i * sizeof(v64)], sizeof(v64));
+                    write(v64);
+                    break;
+                default:
+                    updateStatus(kErpcStatus_InvalidArgument);
+                    return;
+            }
+        }
+    }
+
+    /*!
+     * @brief Prototype for write plain structure in one step.
+     *
+     * The structure has to hold scalar members only, without padding, in the byte order of the
+     * peer. The stream is then the same as writing the members one by one with an endianness
+     * header that converts nothing, the default. This default writes byte by byte, codecs
+     * override it to copy the structure with a single bounds check.
+     *
+     * @param[in] value Pointer to the structure.
+     * @param[in] size Size of the structure in bytes.
+     */
+    virtual void writeStruct(const void *value, uint32_t size) { writeArray(value, sizeof(uint8_t), size); }
     //@}
 
     //! @name Decoding
@@ -427,6 +483,59 @@ public:
      */
     virtual void readCallback(funPtr callbacks1, funPtr *callback2) = 0;
 
+    /*!
+     * @brief Prototype for read array of scalars in one step.
+     *
+     * Consumes the same stream as calling read() for every element. This default reads element
+     * by element, codecs override it to copy the array with a single bounds check.
+     *
+     * @param[out] value Pointer to first element.
+     * @param[in] elementSize Size of one element in bytes, 1, 2, 4 or 8.
+     * @param[in] count Number of elements.
+     */
+    virtual void readArray(void *value, uint32_t elementSize, uint32_t count)
+    {
+        uint8_t *data = (uint8_t *)value;
+        uint16_t v16;
+        uint32_t v32;
+        uint64_t v64;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            switch (elementSize)
+            {
+                case sizeof(uint8_t):
+                    read(&data[i]);
+                    break;
+                case sizeof(uint16_t):
+                    read(&v16);
+                    (void)memcpy(&data[i * sizeof(v16)], &v16, sizeof(v16));
+                    break;
+                case sizeof(uint32_t):
+                    read(&v32);
+                    (void)memcpy(&data[i * sizeof(v32)], &v32, sizeof(v32));
+                    break;
+                case sizeof(uint64_t):
+                    read(&v64);
+                    (void)memcpy(&data[i * sizeof(v64)], &v64, sizeof(v64));
+                    break;
+                default:
+                    updateStatus(kErpcStatus_InvalidArgument);
+                    return;
+            }
+        }
+    }
+
+    /*!
+     * @brief Prototype for read plain structure in one step.
+     *
+     * Counterpart of writeStruct(), with the same requirements on the structure.
+     *
+     * @param[out] value Pointer to the structure.
+     * @param[in] size Size of the structure in bytes.
+     */
+    virtual void readStruct(void *value, uint32_t size) { readArray(value, sizeof(uint8_t), size); }
+
 protected:
     MessageBuffer m_buffer;         /*!< Message buffer object */
     MessageBuffer::Cursor m_cursor; /*!< Copy data to message buffers. */
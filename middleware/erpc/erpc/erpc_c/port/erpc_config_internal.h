@@ -122,6 +122,17 @@
     #define ERPC_DEFAULT_BUFFERS_COUNT (2U)
 #endif
 
+// Set default pool buffers count.
+#if !defined(ERPC_POOL_BUFFERS_COUNT)
+    //! @brief Count of buffers allocated by the pool message buffer factory.
+    #define ERPC_POOL_BUFFERS_COUNT (ERPC_DEFAULT_BUFFERS_COUNT)
+#endif
+
+// Disable/enable client request reuse.
+#if !defined(ERPC_CLIENT_REQUEST_REUSE)
+    #define ERPC_CLIENT_REQUEST_REUSE (0U)
+#endif
+
 // Disable/enable noexcept.
 #if !defined(ERPC_NOEXCEPT)
     #if ERPC_HAS_POSIX
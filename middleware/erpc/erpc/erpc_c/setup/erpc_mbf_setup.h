@@ -25,6 +25,15 @@
 //! @brief Opaque MessageBufferFactory object type.
 typedef struct ErpcMessageBufferFactory *erpc_mbf_t;
 
+//! @brief Usage counters of the pool MessageBufferFactory.
+typedef struct erpc_mbf_pool_stats
+{
+    uint32_t count;  //!< Buffers in the pool.
+    uint32_t inUse;  //!< Buffers currently taken.
+    uint32_t peak;   //!< Maximum of buffers taken at the same time.
+    uint32_t failed; //!< Allocations failed because the pool was empty.
+} erpc_mbf_pool_stats_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 // API
 ////////////////////////////////////////////////////////////////////////////////
@@ -46,6 +55,22 @@ erpc_mbf_t erpc_mbf_static_init(void);
  */
 erpc_mbf_t erpc_mbf_dynamic_init(void);
 
+/*!
+ * @brief Create MessageBuffer factory which is using a lock-free pool of static buffers.
+ *
+ * The pool holds ERPC_POOL_BUFFERS_COUNT buffers of ERPC_DEFAULT_BUFFER_SIZE bytes. Allocation and
+ * release do not take any lock and never touch the heap.
+ */
+erpc_mbf_t erpc_mbf_pool_init(void);
+
+/*!
+ * @brief Get usage counters of the pool MessageBuffer factory.
+ *
+ * @param[in] mbf Factory returned by erpc_mbf_pool_init().
+ * @param[out] stats Usage counters.
+ */
+void erpc_mbf_pool_get_stats(erpc_mbf_t mbf, erpc_mbf_pool_stats_t *stats);
+
 /*!
  * @brief Create MessageBuffer factory which is using RPMSG LITE zero copy buffers.
  *
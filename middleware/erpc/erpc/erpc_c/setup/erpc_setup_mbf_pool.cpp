@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ * All rights reserved.
+ *
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "erpc_config_internal.h"
+#include "erpc_manually_constructed.hpp"
+#include "erpc_mbf_setup.h"
+#include "erpc_message_buffer.hpp"
+
+using namespace erpc;
+
+#define ERPC_POOL_BUFFER_SIZE_UINT64 ((ERPC_DEFAULT_BUFFER_SIZE + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+
+//! Index marking the end of the free list.
+#define ERPC_POOL_INDEX_NONE (0xffffU)
+
+#if ERPC_POOL_BUFFERS_COUNT >= ERPC_POOL_INDEX_NONE
+#error "ERPC_POOL_BUFFERS_COUNT is too big"
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+ * @brief Lock-free pool message buffer factory.
+ *
+ * Fixed size buffers are kept in a free list (Treiber stack). The list head packs the index of the
+ * first free buffer with a modification tag, so create() and dispose() are a single compare and swap
+ * each and may be called from any thread or interrupt without a semaphore.
+ */
+class PoolMessageBufferFactory : public MessageBufferFactory
+{
+public:
+    /*!
+     * @brief Constructor.
+     */
+    PoolMessageBufferFactory(void)
+    : m_head(0)
+    , m_inUse(0)
+    , m_peak(0)
+    , m_failed(0)
+    {
+        for (uint16_t idx = 0; idx < ERPC_POOL_BUFFERS_COUNT; idx++)
+        {
+            m_next[idx] = ((idx + 1U) < ERPC_POOL_BUFFERS_COUNT) ? (uint16_t)(idx + 1U) : ERPC_POOL_INDEX_NONE;
+        }
+    }
+
+    /*!
+     * @brief PoolMessageBufferFactory destructor
+     */
+    virtual ~PoolMessageBufferFactory(void) {}
+
+    /*!
+     * @brief This function takes a buffer from the pool.
+     *
+     * @return MessageBuffer New MessageBuffer, its data pointer is NULL when the pool is empty.
+     */
+    virtual MessageBuffer create(void)
+    {
+        uint32_t head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+        uint32_t next;
+        uint16_t idx;
+
+        do
+        {
+            idx = (uint16_t)(head & 0xffffU);
+            if (idx == ERPC_POOL_INDEX_NONE)
+            {
+                (void)__atomic_fetch_add(&m_failed, 1U, __ATOMIC_RELAXED);
+                return MessageBuffer();
+            }
+            next = (head & 0xffff0000U) + 0x10000U + m_next[idx];
+        } while (!__atomic_compare_exchange_n(&m_head, &head, next, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+        uint32_t inUse = __atomic_add_fetch(&m_inUse, 1U, __ATOMIC_RELAXED);
+        uint32_t peak = __atomic_load_n(&m_peak, __ATOMIC_RELAXED);
+        while ((inUse > peak) &&
+               !__atomic_compare_exchange_n(&m_peak, &peak, inUse, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+        }
+
+        return MessageBuffer(reinterpret_cast<uint8_t *>(m_buffers[idx]), ERPC_DEFAULT_BUFFER_SIZE);
+    }
+
+    /*!
+     * @brief This function returns a buffer to the pool.
+     *
+     * @param[in] buf MessageBuffer to dispose.
+     */
+    virtual void dispose(MessageBuffer *buf)
+    {
+        erpc_assert(buf != NULL);
+        uint8_t *tmp = buf->get();
+        if (tmp != NULL)
+        {
+            uint8_t *first = reinterpret_cast<uint8_t *>(m_buffers[0]);
+            uint32_t offset = (uint32_t)(tmp - first);
+            uint16_t idx = (uint16_t)(offset / sizeof(m_buffers[0]));
+
+            erpc_assert((tmp >= first) && (idx < ERPC_POOL_BUFFERS_COUNT) && ((offset % sizeof(m_buffers[0])) == 0U));
+
+            uint32_t head = __atomic_load_n(&m_head, __ATOMIC_RELAXED);
+            uint32_t next;
+            do
+            {
+                m_next[idx] = (uint16_t)(head & 0xffffU);
+                next = (head & 0xffff0000U) + 0x10000U + idx;
+            } while (!__atomic_compare_exchange_n(&m_head, &head, next, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+            (void)__atomic_sub_fetch(&m_inUse, 1U, __ATOMIC_RELAXED);
+        }
+    }
+
+    /*!
+     * @brief This function returns the usage counters of the pool.
+     *
+     * @param[out] stats Usage counters.
+     */
+    void getStats(erpc_mbf_pool_stats_t *stats)
+    {
+        stats->count = ERPC_POOL_BUFFERS_COUNT;
+        stats->inUse = __atomic_load_n(&m_inUse, __ATOMIC_RELAXED);
+        stats->peak = __atomic_load_n(&m_peak, __ATOMIC_RELAXED);
+        stats->failed = __atomic_load_n(&m_failed, __ATOMIC_RELAXED);
+    }
+
+protected:
+    uint32_t m_head;                                 //!< Tag (bits 31..16) and index (bits 15..0) of first free buffer.
+    uint32_t m_inUse;                                //!< Buffers currently taken.
+    uint32_t m_peak;                                 //!< Maximum of m_inUse.
+    uint32_t m_failed;                               //!< create() calls on an empty pool.
+    uint16_t m_next[ERPC_POOL_BUFFERS_COUNT];        //!< Free list links.
+    uint64_t m_buffers[ERPC_POOL_BUFFERS_COUNT][ERPC_POOL_BUFFER_SIZE_UINT64]; //!< Pool buffers.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+////////////////////////////////////////////////////////////////////////////////
+
+ERPC_MANUALLY_CONSTRUCTED(PoolMessageBufferFactory, s_msgFactory);
+
+erpc_mbf_t erpc_mbf_pool_init(void)
+{
+    s_msgFactory.construct();
+    return reinterpret_cast<erpc_mbf_t>(s_msgFactory.get());
+}
+
+void erpc_mbf_pool_get_stats(erpc_mbf_t mbf, erpc_mbf_pool_stats_t *stats)
+{
+    erpc_assert((mbf != NULL) && (stats != NULL));
+    reinterpret_cast<PoolMessageBufferFactory *>(mbf)->getStats(stats);
+}
@@ -70,5 +70,9 @@ erpc_status_t InterThreadBufferTransport::send(MessageBuffer *message)
 
     m_state->m_mutex.unlock();
 
+    // The peer copies from the sender's buffer, which may be disposed of as soon as send returns.
+    m_peer->m_outSem.get();
+    m_peer->m_outSem.put();
+
     return kErpcStatus_Success;
 }
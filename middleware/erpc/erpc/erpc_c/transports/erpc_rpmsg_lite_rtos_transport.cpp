@@ -257,6 +257,10 @@ erpc_status_t RPMsgRTOSTransport::receive(MessageBuffer *message)
     uint32_t length = 0;
     int32_t ret_val;
 
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    /* The reply we are waiting for may depend on a message still held in the tx batch */
+    (void)rpmsg_lite_flush_tx(s_rpmsg);
+#endif
     ret_val = rpmsg_queue_recv_nocopy(s_rpmsg, m_rpmsg_queue, &m_dst_addr, &buf, &length, RL_BLOCK);
     erpc_assert(buf != NULL);
     message->set((uint8_t *)buf, length);
@@ -274,7 +278,11 @@ erpc_status_t RPMsgRTOSTransport::send(MessageBuffer *message)
     int32_t ret_val;
 
     message->set(NULL, 0);
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    ret_val = rpmsg_lite_send_nocopy_batched(s_rpmsg, m_rpmsg_ept, m_dst_addr, buf, used);
+#else
     ret_val = rpmsg_lite_send_nocopy(s_rpmsg, m_rpmsg_ept, m_dst_addr, buf, used);
+#endif
     if (ret_val == RL_SUCCESS)
     {
         status = kErpcStatus_Success;
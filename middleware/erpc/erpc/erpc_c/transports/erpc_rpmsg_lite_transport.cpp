@@ -212,6 +212,10 @@ erpc_status_t RPMsgTransport::init(uint32_t src_addr, uint32_t dst_addr, void *b
 
 erpc_status_t RPMsgTransport::receive(MessageBuffer *message)
 {
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    /* The reply we are waiting for may depend on a message still held in the tx batch */
+    (void)rpmsg_lite_flush_tx(s_rpmsg);
+#endif
     while (!m_messageQueue.get(message))
     {
     }
@@ -221,8 +225,13 @@ erpc_status_t RPMsgTransport::receive(MessageBuffer *message)
 
 erpc_status_t RPMsgTransport::send(MessageBuffer *message)
 {
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    int32_t ret_val =
+        rpmsg_lite_send_nocopy_batched(s_rpmsg, m_rpmsg_ept, m_dst_addr, (char *)message->get(), message->getUsed());
+#else
     int32_t ret_val =
         rpmsg_lite_send_nocopy(s_rpmsg, m_rpmsg_ept, m_dst_addr, (char *)message->get(), message->getUsed());
+#endif
     message->set(NULL, 0);
 
     return (ret_val != RL_SUCCESS) ? kErpcStatus_SendFailed : kErpcStatus_Success;
@@ -55,6 +55,9 @@ void platform_notify(uint32_t vector_id);
 /* platform low-level time-delay (busy loop) */
 void platform_time_delay(uint32_t num_msec);
 
+/* platform free running time stamp in us */
+uint64_t platform_time_get_us(void);
+
 /* platform memory functions */
 void platform_map_mem_region(uint32_t vrt_addr, uint32_t phy_addr, uint32_t size, uint32_t flags);
 void platform_cache_all_flush_invalidate(void);
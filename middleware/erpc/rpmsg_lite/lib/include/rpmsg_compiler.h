@@ -111,7 +111,12 @@
 /* GNUC */
 #elif defined(__GNUC__)
 
+#if defined(__riscv)
 #define MEM_BARRIER() __asm("fence rw, rw");
+#else
+/* host builds, tests/host */
+#define MEM_BARRIER() __sync_synchronize()
+#endif
 
 #ifndef RL_PACKED_BEGIN
 #define RL_PACKED_BEGIN
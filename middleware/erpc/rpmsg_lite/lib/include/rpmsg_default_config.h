@@ -169,6 +169,37 @@
 #define RL_ALLOW_CONSUMED_BUFFERS_NOTIFICATION (0)
 #endif
 
+//! @def RL_ALLOW_TX_BATCHING
+//!
+//! When enabled rpmsg_lite_send_nocopy_batched() queues several tx buffers
+//! into the virtqueue and notifies the other side once per batch, either
+//! when the configured buffer count is reached, when the configured time
+//! threshold elapsed or when rpmsg_lite_flush_tx() is called. The receive
+//! callback also suppresses notifications from the other side while it is
+//! draining the receive virtqueue.
+//! The default value is 0 (one notification per message).
+#ifndef RL_ALLOW_TX_BATCHING
+#define RL_ALLOW_TX_BATCHING (0)
+#endif
+
+//! @def RL_TX_BATCH_DEFAULT_COUNT
+//!
+//! Number of tx buffers queued before the other side is notified, used
+//! until rpmsg_lite_set_tx_batch() is called.
+//! The default value is 1U (notify on every message).
+#ifndef RL_TX_BATCH_DEFAULT_COUNT
+#define RL_TX_BATCH_DEFAULT_COUNT (1U)
+#endif
+
+//! @def RL_TX_BATCH_DEFAULT_TIMEOUT_US
+//!
+//! Maximum time in us a queued tx buffer waits for the batch to fill up,
+//! used until rpmsg_lite_set_tx_batch() is called.
+//! The default value is 0U (no time threshold).
+#ifndef RL_TX_BATCH_DEFAULT_TIMEOUT_US
+#define RL_TX_BATCH_DEFAULT_TIMEOUT_US (0U)
+#endif
+
 //! @def RL_HANG
 //!
 //! Default implementation of hang assert function
@@ -115,6 +115,19 @@ struct rpmsg_lite_ept_static_context
     struct llist node;              /*!< memory for linked list node structure */
 };
 
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+/*!
+ * Batching statistics, messages per notification is tx_msgs / tx_kicks
+ */
+struct rpmsg_lite_batch_stats
+{
+    uint32_t tx_msgs;          /*!< messages sent through the batched path */
+    uint32_t tx_kicks;         /*!< notifications raised towards the other side */
+    uint32_t rx_msgs;          /*!< messages received */
+    uint32_t rx_notifications; /*!< receive callbacks invoked by notifications of the other side */
+};
+#endif
+
 /*!
  * Structure describing the local instance
  * of RPMSG lite communication stack and
@@ -143,6 +156,13 @@ struct rpmsg_lite_instance
     struct vq_static_context vq_ctxt[2];
 #endif
     uint32_t link_id; /*!< linkID of this rpmsg_lite instance */
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    uint32_t tx_batch_count;      /*!< notify the other side after this many queued tx buffers */
+    uint32_t tx_batch_timeout_us; /*!< notify the other side when the oldest queued buffer is older, 0 disables */
+    uint32_t tx_batch_pending;    /*!< tx buffers queued since the last notification */
+    uint64_t tx_batch_first_us;   /*!< time stamp of the oldest queued tx buffer */
+    struct rpmsg_lite_batch_stats batch_stats; /*!< batching statistics */
+#endif
 };
 
 /*******************************************************************************
@@ -368,6 +388,79 @@ int32_t rpmsg_lite_send_nocopy(struct rpmsg_lite_instance *rpmsg_lite_dev,
                                uint32_t dst,
                                void *data,
                                uint32_t size);
+
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+/*!
+ * @brief Configures the notification coalescing of the batched tx path.
+ *
+ * The other side is notified once max_count buffers have been queued by
+ * rpmsg_lite_send_nocopy_batched() or once the oldest queued buffer waited
+ * for more than timeout_us (checked on every batched send and on
+ * rpmsg_lite_poll_tx_batch()), whichever comes first.
+ *
+ * @param rpmsg_lite_dev    RPMsg-Lite instance
+ * @param max_count         Buffers per notification, clamped to the tx virtqueue size
+ * @param timeout_us        Maximum time a queued buffer may wait, 0 disables the time threshold
+ *
+ * @return Status of function execution, RL_SUCCESS on success.
+ */
+int32_t rpmsg_lite_set_tx_batch(struct rpmsg_lite_instance *rpmsg_lite_dev, uint32_t max_count, uint32_t timeout_us);
+
+/*!
+ * @brief Queues a message in tx buffer allocated by rpmsg_lite_alloc_tx_buffer()
+ * without necessarily notifying the other side.
+ *
+ * Same buffer ownership rules as for rpmsg_lite_send_nocopy() apply. The
+ * message becomes visible to the other side when the batch is flushed, see
+ * rpmsg_lite_set_tx_batch(). Buffers already queued are flushed by
+ * rpmsg_lite_alloc_tx_buffer() when the tx virtqueue runs out of buffers.
+ *
+ * @param rpmsg_lite_dev    RPMsg-Lite instance
+ * @param[in] ept           Sender endpoint pointer
+ * @param[in] dst           Destination address
+ * @param[in] data          TX buffer with message filled
+ * @param[in] size          Length of payload
+ *
+ * @return 0 on success and an appropriate error value on failure.
+ *
+ * @see rpmsg_lite_flush_tx
+ */
+int32_t rpmsg_lite_send_nocopy_batched(struct rpmsg_lite_instance *rpmsg_lite_dev,
+                                       struct rpmsg_lite_endpoint *ept,
+                                       uint32_t dst,
+                                       void *data,
+                                       uint32_t size);
+
+/*!
+ * @brief Notifies the other side about all queued tx buffers.
+ *
+ * @param rpmsg_lite_dev    RPMsg-Lite instance
+ *
+ * @return Status of function execution, RL_SUCCESS on success.
+ */
+int32_t rpmsg_lite_flush_tx(struct rpmsg_lite_instance *rpmsg_lite_dev);
+
+/*!
+ * @brief Flushes the queued tx buffers if the batch time threshold elapsed.
+ *
+ * Intended to be called periodically, e.g. from an idle loop or a timer.
+ *
+ * @param rpmsg_lite_dev    RPMsg-Lite instance
+ *
+ * @return RL_TRUE if a notification was raised, RL_FALSE otherwise.
+ */
+uint32_t rpmsg_lite_poll_tx_batch(struct rpmsg_lite_instance *rpmsg_lite_dev);
+
+/*!
+ * @brief Returns the batching statistics.
+ *
+ * @param rpmsg_lite_dev    RPMsg-Lite instance
+ * @param[out] stats        Statistics
+ *
+ * @return Status of function execution, RL_SUCCESS on success.
+ */
+int32_t rpmsg_lite_get_batch_stats(struct rpmsg_lite_instance *rpmsg_lite_dev, struct rpmsg_lite_batch_stats *stats);
+#endif /* RL_ALLOW_TX_BATCHING */
 #endif /* RL_API_HAS_ZEROCOPY */
 
 //! @}
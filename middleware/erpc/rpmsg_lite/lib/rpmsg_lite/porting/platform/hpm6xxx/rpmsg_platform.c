@@ -74,6 +74,27 @@ void platform_time_delay(uint32_t num_msec)
     clock_cpu_delay_ms(num_msec);
 }
 
+/**
+ * platform_time_get_us
+ *
+ * @return Free running time stamp in us based on the core cycle counter,
+ *         0 while the core clock frequency is unknown.
+ */
+uint64_t platform_time_get_us(void)
+{
+    uint32_t ticks_per_us;
+
+    if (hpm_core_clock == 0U) {
+        clock_update_core_clock();
+    }
+    ticks_per_us = (hpm_core_clock + 1000000UL - 1U) / 1000000UL;
+    if (ticks_per_us == 0U) {
+        return 0U;
+    }
+
+    return hpm_csr_get_core_cycle() / ticks_per_us;
+}
+
 /**
  * platform_in_isr
  *
@@ -138,6 +138,68 @@ static struct llist *rpmsg_lite_get_endpoint_from_addr(struct rpmsg_lite_instanc
   "mmm" #    # #mmmmm #mmmmm #mmmm" #    #  "mmm" #   "m "mmm#"
 ****************************************************************/
 
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+/*!
+ * @brief
+ * Asks the other side not to notify about buffers it puts into the virtqueue.
+ * The flag lives in the used ring header and is only written by the receiver
+ * of the virtqueue, the sender checks it in virtqueue_kick().
+ *
+ * @param rvq  Receive virtqueue
+ *
+ */
+static void rpmsg_lite_suppress_notify(struct virtqueue *rvq)
+{
+    rvq->vq_ring.used->flags |= (uint16_t)VRING_USED_F_NO_NOTIFY;
+    env_mb();
+}
+
+/*!
+ * @brief
+ * Re-enables notifications from the other side and re-checks the virtqueue,
+ * a buffer queued between the last empty read and the flag update would be
+ * lost otherwise. Notifications stay suppressed if a buffer is returned.
+ *
+ * @param rpmsg_lite_dev    RPMsg-Lite instance
+ * @param len               Size of received buffer
+ * @param idx               Index of buffer
+ *
+ * @return  Pointer to received buffer or RL_NULL
+ *
+ */
+static void *rpmsg_lite_resume_notify(struct rpmsg_lite_instance *rpmsg_lite_dev, uint32_t *len, uint16_t *idx)
+{
+    void *buffer;
+
+    rpmsg_lite_dev->rvq->vq_ring.used->flags &= ~(uint16_t)VRING_USED_F_NO_NOTIFY;
+    env_mb();
+    buffer = rpmsg_lite_dev->vq_ops->vq_rx(rpmsg_lite_dev->rvq, len, idx);
+    if (buffer != RL_NULL)
+    {
+        rpmsg_lite_suppress_notify(rpmsg_lite_dev->rvq);
+    }
+    return buffer;
+}
+
+/*!
+ * @brief
+ * Notifies the other side about all queued tx buffers, must be called with
+ * the instance lock held.
+ *
+ * @param rpmsg_lite_dev    RPMsg-Lite instance
+ *
+ */
+static void rpmsg_lite_kick_tx_batch(struct rpmsg_lite_instance *rpmsg_lite_dev)
+{
+    if (rpmsg_lite_dev->tx_batch_pending > 0U)
+    {
+        virtqueue_kick(rpmsg_lite_dev->tvq);
+        rpmsg_lite_dev->tx_batch_pending = 0U;
+        rpmsg_lite_dev->batch_stats.tx_kicks++;
+    }
+}
+#endif /* RL_ALLOW_TX_BATCHING */
+
 /*!
  * @brief
  * Called when remote side calls virtqueue_kick()
@@ -167,11 +229,27 @@ static void rpmsg_lite_rx_callback(struct virtqueue *vq)
     env_lock_mutex(rpmsg_lite_dev->lock);
 #endif
 
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    rpmsg_lite_dev->batch_stats.rx_notifications++;
+    /* The other side does not need to kick while this callback drains the queue */
+    rpmsg_lite_suppress_notify(rpmsg_lite_dev->rvq);
+#endif
+
     /* Process the received data from remote node */
     rpmsg_msg = (struct rpmsg_std_msg *)rpmsg_lite_dev->vq_ops->vq_rx(rpmsg_lite_dev->rvq, &len, &idx);
 
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    if (rpmsg_msg == RL_NULL)
+    {
+        rpmsg_msg = (struct rpmsg_std_msg *)rpmsg_lite_resume_notify(rpmsg_lite_dev, &len, &idx);
+    }
+#endif
+
     while (rpmsg_msg != RL_NULL)
     {
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+        rpmsg_lite_dev->batch_stats.rx_msgs++;
+#endif
         node = rpmsg_lite_get_endpoint_from_addr(rpmsg_lite_dev, rpmsg_msg->hdr.dst);
 
         cb_ret = RL_RELEASE;
@@ -193,6 +271,12 @@ static void rpmsg_lite_rx_callback(struct virtqueue *vq)
 #endif
         }
         rpmsg_msg = (struct rpmsg_std_msg *)rpmsg_lite_dev->vq_ops->vq_rx(rpmsg_lite_dev->rvq, &len, &idx);
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+        if (rpmsg_msg == RL_NULL)
+        {
+            rpmsg_msg = (struct rpmsg_std_msg *)rpmsg_lite_resume_notify(rpmsg_lite_dev, &len, &idx);
+        }
+#endif
 #if defined(RL_ALLOW_CONSUMED_BUFFERS_NOTIFICATION) && (RL_ALLOW_CONSUMED_BUFFERS_NOTIFICATION == 1)
         if ((rpmsg_msg == RL_NULL) && (rx_freed == RL_TRUE))
         {
@@ -738,6 +822,13 @@ void *rpmsg_lite_alloc_tx_buffer(struct rpmsg_lite_instance *rpmsg_lite_dev, uin
     env_lock_mutex(rpmsg_lite_dev->lock);
     /* Get rpmsg buffer for sending message. */
     buffer = rpmsg_lite_dev->vq_ops->vq_tx_alloc(rpmsg_lite_dev->tvq, size, &idx);
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    if (buffer == RL_NULL)
+    {
+        /* The other side can only return buffers it has been notified about */
+        rpmsg_lite_kick_tx_batch(rpmsg_lite_dev);
+    }
+#endif
     env_unlock_mutex(rpmsg_lite_dev->lock);
 
     if ((buffer == RL_NULL) && (timeout == RL_FALSE))
@@ -832,6 +923,150 @@ int32_t rpmsg_lite_send_nocopy(struct rpmsg_lite_instance *rpmsg_lite_dev,
     return RL_SUCCESS;
 }
 
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+int32_t rpmsg_lite_set_tx_batch(struct rpmsg_lite_instance *rpmsg_lite_dev, uint32_t max_count, uint32_t timeout_us)
+{
+    if ((rpmsg_lite_dev == RL_NULL) || (max_count == 0U))
+    {
+        return RL_ERR_PARAM;
+    }
+
+    env_lock_mutex(rpmsg_lite_dev->lock);
+    if ((rpmsg_lite_dev->tvq != RL_NULL) && (max_count > rpmsg_lite_dev->tvq->vq_nentries))
+    {
+        max_count = rpmsg_lite_dev->tvq->vq_nentries;
+    }
+    rpmsg_lite_dev->tx_batch_count      = max_count;
+    rpmsg_lite_dev->tx_batch_timeout_us = timeout_us;
+    if (rpmsg_lite_dev->tx_batch_pending >= max_count)
+    {
+        rpmsg_lite_kick_tx_batch(rpmsg_lite_dev);
+    }
+    env_unlock_mutex(rpmsg_lite_dev->lock);
+
+    return RL_SUCCESS;
+}
+
+int32_t rpmsg_lite_send_nocopy_batched(struct rpmsg_lite_instance *rpmsg_lite_dev,
+                                       struct rpmsg_lite_endpoint *ept,
+                                       uint32_t dst,
+                                       void *data,
+                                       uint32_t size)
+{
+    struct rpmsg_std_msg *rpmsg_msg;
+    uint64_t now_us = 0U;
+
+    if ((rpmsg_lite_dev == RL_NULL) || (ept == RL_NULL) || (data == RL_NULL))
+    {
+        return RL_ERR_PARAM;
+    }
+
+#if defined(RL_ALLOW_CUSTOM_SHMEM_CONFIG) && (RL_ALLOW_CUSTOM_SHMEM_CONFIG == 1)
+    if (size > (uint32_t)RL_BUFFER_PAYLOAD_SIZE(rpmsg_lite_dev->link_id))
+#else
+    if (size > (uint32_t)RL_BUFFER_PAYLOAD_SIZE)
+#endif /* defined(RL_ALLOW_CUSTOM_SHMEM_CONFIG) && (RL_ALLOW_CUSTOM_SHMEM_CONFIG == 1) */
+    {
+        return RL_ERR_BUFF_SIZE;
+    }
+
+    if (rpmsg_lite_dev->link_state != RL_TRUE)
+    {
+        return RL_NOT_READY;
+    }
+
+    rpmsg_msg = RPMSG_STD_MSG_FROM_BUF(data);
+
+    /* Initialize RPMSG header. */
+    rpmsg_msg->hdr.dst   = dst;
+    rpmsg_msg->hdr.src   = ept->addr;
+    rpmsg_msg->hdr.len   = (uint16_t)size;
+    rpmsg_msg->hdr.flags = (uint16_t)(RL_NO_FLAGS & 0xFFFFU);
+
+    if (rpmsg_lite_dev->tx_batch_timeout_us != 0U)
+    {
+        now_us = platform_time_get_us();
+    }
+
+    env_lock_mutex(rpmsg_lite_dev->lock);
+    /*
+     * Enqueue buffer on virtqueue. The ring index is published right away, so
+     * a peer that is already draining the queue picks the buffer up; only the
+     * notification waits for the kick.
+     */
+    rpmsg_lite_dev->vq_ops->vq_tx(
+        rpmsg_lite_dev->tvq, (void *)rpmsg_msg,
+        (uint32_t)virtqueue_get_buffer_length(rpmsg_lite_dev->tvq, rpmsg_msg->hdr.reserved.idx),
+        rpmsg_msg->hdr.reserved.idx);
+    if (rpmsg_lite_dev->tx_batch_pending == 0U)
+    {
+        rpmsg_lite_dev->tx_batch_first_us = now_us;
+    }
+    rpmsg_lite_dev->tx_batch_pending++;
+    rpmsg_lite_dev->batch_stats.tx_msgs++;
+
+    if ((rpmsg_lite_dev->tx_batch_pending >= rpmsg_lite_dev->tx_batch_count) ||
+        ((rpmsg_lite_dev->tx_batch_timeout_us != 0U) &&
+         ((now_us - rpmsg_lite_dev->tx_batch_first_us) >= rpmsg_lite_dev->tx_batch_timeout_us)))
+    {
+        rpmsg_lite_kick_tx_batch(rpmsg_lite_dev);
+    }
+    env_unlock_mutex(rpmsg_lite_dev->lock);
+
+    return RL_SUCCESS;
+}
+
+int32_t rpmsg_lite_flush_tx(struct rpmsg_lite_instance *rpmsg_lite_dev)
+{
+    if (rpmsg_lite_dev == RL_NULL)
+    {
+        return RL_ERR_PARAM;
+    }
+
+    env_lock_mutex(rpmsg_lite_dev->lock);
+    rpmsg_lite_kick_tx_batch(rpmsg_lite_dev);
+    env_unlock_mutex(rpmsg_lite_dev->lock);
+
+    return RL_SUCCESS;
+}
+
+uint32_t rpmsg_lite_poll_tx_batch(struct rpmsg_lite_instance *rpmsg_lite_dev)
+{
+    uint32_t kicked = RL_FALSE;
+
+    if ((rpmsg_lite_dev == RL_NULL) || (rpmsg_lite_dev->tx_batch_pending == 0U))
+    {
+        return RL_FALSE;
+    }
+
+    env_lock_mutex(rpmsg_lite_dev->lock);
+    if ((rpmsg_lite_dev->tx_batch_pending > 0U) &&
+        ((rpmsg_lite_dev->tx_batch_timeout_us == 0U) ||
+         ((platform_time_get_us() - rpmsg_lite_dev->tx_batch_first_us) >= rpmsg_lite_dev->tx_batch_timeout_us)))
+    {
+        rpmsg_lite_kick_tx_batch(rpmsg_lite_dev);
+        kicked = RL_TRUE;
+    }
+    env_unlock_mutex(rpmsg_lite_dev->lock);
+
+    return kicked;
+}
+
+int32_t rpmsg_lite_get_batch_stats(struct rpmsg_lite_instance *rpmsg_lite_dev, struct rpmsg_lite_batch_stats *stats)
+{
+    if ((rpmsg_lite_dev == RL_NULL) || (stats == RL_NULL))
+    {
+        return RL_ERR_PARAM;
+    }
+
+    env_lock_mutex(rpmsg_lite_dev->lock);
+    *stats = rpmsg_lite_dev->batch_stats;
+    env_unlock_mutex(rpmsg_lite_dev->lock);
+
+    return RL_SUCCESS;
+}
+#endif /* RL_ALLOW_TX_BATCHING */
+
 /******************************************
 
  mmmmm  m    m          mm   mmmmm  mmmmm
@@ -996,6 +1231,10 @@ struct rpmsg_lite_instance *rpmsg_lite_master_init(void *shmem_addr,
     }
 
     rpmsg_lite_dev->link_id = link_id;
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    rpmsg_lite_dev->tx_batch_count      = RL_TX_BATCH_DEFAULT_COUNT;
+    rpmsg_lite_dev->tx_batch_timeout_us = RL_TX_BATCH_DEFAULT_TIMEOUT_US;
+#endif
 
     /*
      * Since device is RPMSG Remote so we need to manage the
@@ -1275,6 +1514,10 @@ struct rpmsg_lite_instance *rpmsg_lite_remote_init(void *shmem_addr, uint32_t li
     }
 
     rpmsg_lite_dev->link_id = link_id;
+#if defined(RL_ALLOW_TX_BATCHING) && (RL_ALLOW_TX_BATCHING == 1)
+    rpmsg_lite_dev->tx_batch_count      = RL_TX_BATCH_DEFAULT_COUNT;
+    rpmsg_lite_dev->tx_batch_timeout_us = RL_TX_BATCH_DEFAULT_TIMEOUT_US;
+#endif
 
     vq_names[0]            = "tx_vq"; /* swapped in case of remote */
     vq_names[1]            = "rx_vq";
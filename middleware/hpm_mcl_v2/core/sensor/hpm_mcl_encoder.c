@@ -8,6 +8,114 @@
 #include "hpm_mcl_encoder.h"
 #include "hpm_mcl_physical.h"
 
+/**
+ * @brief Precompute the observer gains and scales
+ *
+ * The error dynamics of a predictor-corrector observer with position,
+ * speed and acceleration states have a triple pole at z = 1 - q when
+ * l1 = 1 - (1 - q)^3, l2 = 3q^2 - 1.5q^3 and l3 = q^3.
+ *
+ * @param encoder @ref mcl_encoder_t
+ * @return hpm_mcl_stat_t
+ */
+static hpm_mcl_stat_t hpm_mcl_encoder_observer_init(mcl_encoder_t *encoder)
+{
+    mcl_encoder_cal_speed_observer_function_t *observer = &encoder->cal_speed.observer_method;
+    mcl_encoer_cfg_t *cfg = encoder->cfg;
+    float ts = cfg->period_call_time_s;
+    float period_tick = ts * (*encoder->mcu_clock_tick);
+    float timeout_tick = cfg->timeout_s * (*encoder->mcu_clock_tick);
+    float q, p;
+
+    MCL_ASSERT((cfg->precision != 0) && (period_tick >= 2.0f) && (cfg->cal_speed_observer_cfg.bandwidth_hz > 0), mcl_invalid_argument);
+    q = 1.0f - expf(-2.0f * MCL_PI * cfg->cal_speed_observer_cfg.bandwidth_hz * ts);
+    MCL_ASSERT(q < 0.5f, mcl_invalid_argument);
+    p = 1.0f - q;
+    observer->gain[0] = (uint32_t)((1.0f - p * p * p) * 4294967296.0f);
+    observer->gain[1] = (uint32_t)((3.0f * q * q - 1.5f * q * q * q) * 4294967296.0f);
+    observer->gain[2] = (uint32_t)(q * q * q * 4294967296.0f);
+    observer->count_phase = UINT64_MAX / cfg->precision;
+    observer->inv_period_tick = (uint32_t)(4294967296.0f / period_tick);
+    observer->timeout_tick = (timeout_tick >= 4294967040.0f) ? UINT32_MAX : (uint32_t)timeout_tick;
+    observer->speed_scale = 2.0f * MCL_PI / 4294967296.0f / ts;
+    observer->valid = false;
+
+    return mcl_success;
+}
+
+/**
+ * @brief Run the observer on the newest encoder count
+ *
+ * A count change measures the angle of its edge at a known time, the
+ * residual is taken against the estimate moved back to that time. Without
+ * a count change the angle is only known to lie within the count, the
+ * estimate is corrected when it leaves the count.
+ *
+ * @param observer @ref mcl_encoder_cal_speed_observer_function_t
+ * @param tick_deta Difference in the number of cycles between two calls
+ * @param count encoder count
+ * @param edge_age_tick ticks since the edge that set the count
+ * @return mechanical angle, rad
+ */
+static float hpm_mcl_encoder_observer_update(mcl_encoder_cal_speed_observer_function_t *observer,
+                                             uint32_t tick_deta, uint32_t count, uint32_t edge_age_tick)
+{
+    uint64_t low = (uint64_t)count * observer->count_phase;
+    uint64_t measure;
+    uint64_t age;
+    int64_t deta;
+    int32_t err;
+
+    if (!observer->valid) {
+        observer->theta = low + (observer->count_phase >> 1);
+        observer->omega = 0;
+        observer->alpha = 0;
+        observer->idle_tick = 0;
+        observer->count_last = count;
+        observer->reverse = false;
+        observer->valid = true;
+        return (float)(uint32_t)(observer->theta >> 32) * (2.0f * MCL_PI / 4294967296.0f);
+    }
+
+    observer->theta += (uint64_t)(observer->omega + (observer->alpha >> 1));
+    observer->omega += observer->alpha;
+
+    if (count != observer->count_last) {
+        /* the count was entered at its lower edge moving forward, at its upper edge moving backward */
+        observer->reverse = (int64_t)(low - (uint64_t)observer->count_last * observer->count_phase) < 0;
+        measure = observer->reverse ? (low + observer->count_phase) : low;
+        /* the edge is younger than one call, speed in 2^32 per turn per call times the age in calls Q32 */
+        age = (uint64_t)edge_age_tick * observer->inv_period_tick;
+        if (age > 0x100000000ULL) {
+            age = 0x100000000ULL;
+        }
+        measure += (uint64_t)((int64_t)(int32_t)(observer->omega >> 32) * (int64_t)age);
+        observer->count_last = count;
+        observer->idle_tick = 0;
+    } else {
+        measure = observer->theta;
+        deta = (int64_t)(measure - low);
+        if (deta < 0) {
+            measure = low;
+        } else if ((uint64_t)deta > observer->count_phase) {
+            measure = low + observer->count_phase;
+        }
+        if (observer->idle_tick < observer->timeout_tick) {
+            observer->idle_tick += tick_deta;
+        } else {
+            observer->omega = 0;
+            observer->alpha = 0;
+        }
+    }
+
+    err = (int32_t)((int64_t)(measure - observer->theta) >> 32);
+    observer->theta += (uint64_t)((int64_t)err * observer->gain[0]);
+    observer->omega += (int64_t)err * observer->gain[1];
+    observer->alpha += (int64_t)err * observer->gain[2];
+
+    return (float)(uint32_t)(observer->theta >> 32) * (2.0f * MCL_PI / 4294967296.0f);
+}
+
 hpm_mcl_stat_t hpm_mcl_encoder_init(mcl_encoder_t *encoder, mcl_cfg_t *mcl_cfg, mcl_encoer_cfg_t *encoder_cfg, mcl_filter_iir_df1_t *iir)
 {
     MCL_ASSERT(encoder != NULL, mcl_invalid_pointer);
@@ -25,14 +133,18 @@ hpm_mcl_stat_t hpm_mcl_encoder_init(mcl_encoder_t *encoder, mcl_cfg_t *mcl_cfg,
     MCL_ASSERT((encoder_cfg->callback.init != NULL), mcl_invalid_pointer);
     MCL_ASSERT((encoder_cfg->callback.get_theta != NULL), mcl_invalid_pointer);
     MCL_ASSERT((encoder_cfg->speed_cal_method != encoder_method_user) || (encoder_cfg->callback.process_by_user != NULL), mcl_invalid_argument);
+    MCL_ASSERT((encoder_cfg->speed_cal_method != encoder_method_observer) || (encoder_cfg->callback.get_edge != NULL), mcl_invalid_argument);
     /**
      * @brief null function initialisation
      *
      */
     memset(encoder->cal_speed.memory, 0, MCL_ENCODER_CAL_STRUCT_MAX_MEMMORY * sizeof(uint32_t));
     encoder->mcu_clock_tick = &mcl_cfg->physical.time.mcu_clock_tick;
-    encoder->cal_speed.pll_method.cfg = (mcl_encoder_cal_speed_pll_cfg_t *)&encoder_cfg->cal_speed_pll_cfg;
-    encoder->cal_speed.pll_method.period_call_time_s = (float *)&encoder_cfg->period_call_time_s;
+    /* the running data of all methods share one union */
+    if (encoder_cfg->speed_cal_method == encoder_method_pll) {
+        encoder->cal_speed.pll_method.cfg = (mcl_encoder_cal_speed_pll_cfg_t *)&encoder_cfg->cal_speed_pll_cfg;
+        encoder->cal_speed.pll_method.period_call_time_s = (float *)&encoder_cfg->period_call_time_s;
+    }
     encoder->iirfilter = iir;
     encoder->current_loop_ts = &mcl_cfg->physical.time.current_loop_ts;
     encoder->pole_num = &mcl_cfg->physical.motor.pole_num;
@@ -41,6 +153,9 @@ hpm_mcl_stat_t hpm_mcl_encoder_init(mcl_encoder_t *encoder, mcl_cfg_t *mcl_cfg,
      *
      */
     encoder->cfg = encoder_cfg;
+    if (encoder_cfg->speed_cal_method == encoder_method_observer) {
+        MCL_ASSERT(hpm_mcl_encoder_observer_init(encoder) == mcl_success, mcl_invalid_argument);
+    }
     encoder->phase = &mcl_cfg->physical.motor.hall;
     encoder->result.speed = 0;
     encoder->result.theta = 0;
@@ -101,13 +216,21 @@ hpm_mcl_stat_t hpm_mcl_encoder_process(mcl_encoder_t *encoder, uint32_t tick_det
     float theta_forecast;
     float theta_integrator;
     float theta_deta;
+    uint32_t count;
+    uint32_t edge_age_tick;
     hpm_mcl_stat_t status;
 
     MCL_ASSERT_OPT(encoder != NULL, mcl_invalid_pointer);
     MCL_ASSERT(tick_deta != 0, mcl_invalid_argument);
     MCL_ASSERT((encoder->status == encoder_status_run), mcl_encoder_not_ready);
-    MCL_ASSERT_EXEC_CODE_AND_RETURN(encoder->cfg->callback.get_theta(&theta) == mcl_success,
-        encoder->status = encoder_status_fail, mcl_encoder_get_theta_error);
+    if (encoder->cfg->speed_cal_method == encoder_method_observer) {
+        MCL_ASSERT_EXEC_CODE_AND_RETURN(encoder->cfg->callback.get_edge(&count, &edge_age_tick) == mcl_success,
+            encoder->status = encoder_status_fail, mcl_encoder_get_edge_error);
+        theta = hpm_mcl_encoder_observer_update(&encoder->cal_speed.observer_method, tick_deta, count, edge_age_tick);
+    } else {
+        MCL_ASSERT_EXEC_CODE_AND_RETURN(encoder->cfg->callback.get_theta(&theta) == mcl_success,
+            encoder->status = encoder_status_fail, mcl_encoder_get_theta_error);
+    }
     if (encoder->force_set_theta.enable) {
         theta = encoder->force_set_theta.value;
     } else {
@@ -134,7 +257,7 @@ hpm_mcl_stat_t hpm_mcl_encoder_process(mcl_encoder_t *encoder, uint32_t tick_det
         encoder->cal_speed.m_method.theta_last = theta;
         break;
     case encoder_method_t:
-        ts = tick_deta / (*encoder->mcu_clock_tick);
+        ts = (float)tick_deta / (*encoder->mcu_clock_tick);
         theta_deta = MCL_ANGLE_MOD_X((-MCL_PI), MCL_PI, (theta - encoder->cal_speed.t_method.theta_last));
         encoder->cal_speed.t_method.ts_sigma += ts;
         if (MCL_FLOAT_IS_ZERO(theta_deta)) {
@@ -151,7 +274,7 @@ hpm_mcl_stat_t hpm_mcl_encoder_process(mcl_encoder_t *encoder, uint32_t tick_det
         encoder->cal_speed.t_method.speed_last = speed;
         break;
     case encoder_method_m_t:
-        ts = tick_deta / (*encoder->mcu_clock_tick);
+        ts = (float)tick_deta / (*encoder->mcu_clock_tick);
         theta_deta = MCL_ANGLE_MOD_X((-MCL_PI), MCL_PI, (theta - encoder->cal_speed.m_t_method.theta_last));
         encoder->cal_speed.m_t_method.ts_sigma += ts;
         encoder->cal_speed.m_t_method.theta_sigma += theta_deta;
@@ -179,21 +302,28 @@ hpm_mcl_stat_t hpm_mcl_encoder_process(mcl_encoder_t *encoder, uint32_t tick_det
         theta_integrator = MCL_ANGLE_MOD_X(0, 2 * MCL_PI, theta_integrator);
         encoder->cal_speed.pll_method.theta_last = theta_integrator;
         break;
+    case encoder_method_observer:
+        speed = (float)(int32_t)(encoder->cal_speed.observer_method.omega >> 32) * encoder->cal_speed.observer_method.speed_scale;
+        break;
     default:
         return mcl_invalid_argument;
     }
     /**
-     * @brief iir filter
+     * @brief iir filter, the observer output is already filtered
      *
      */
-    speed = hpm_mcl_filter_iir_df1(encoder->iirfilter, speed);
+    if (encoder->cfg->speed_cal_method != encoder_method_observer) {
+        speed = hpm_mcl_filter_iir_df1(encoder->iirfilter, speed);
+    }
     theta = MCL_ANGLE_MOD_X(0, 2 * MCL_PI, theta * (*encoder->pole_num));
     theta_forecast = MCL_ANGLE_MOD_X(0, 2 * MCL_PI, theta + speed * (*encoder->current_loop_ts) * (*encoder->pole_num));
 
     encoder->result.theta = theta;
     encoder->result.speed = speed;
     encoder->result.theta_forecast = theta_forecast;
-    encoder->cal_speed.m_t_method.speed_filter_last = encoder->result.speed;
+    if (encoder->cfg->speed_cal_method == encoder_method_m_t) {
+        encoder->cal_speed.m_t_method.speed_filter_last = encoder->result.speed;
+    }
     return mcl_success;
 }
 
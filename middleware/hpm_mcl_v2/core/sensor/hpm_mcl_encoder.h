@@ -16,6 +16,7 @@ enum {
     mcl_encoder_get_theta_error = MAKE_STATUS(mcl_group_encoder, 3),
     mcl_encoder_not_ready = MAKE_STATUS(mcl_group_encoder, 4),
     mcl_encoder_get_uvw_error = MAKE_STATUS(mcl_group_encoder, 5),
+    mcl_encoder_get_edge_error = MAKE_STATUS(mcl_group_encoder, 6),
 };
 
 typedef enum {
@@ -35,6 +36,7 @@ typedef enum {
     encoder_method_m_t,
     encoder_method_pll,
     encoder_method_user,
+    encoder_method_observer,    /**< position, speed and acceleration observer driven by edge timestamps */
 } mcl_encoder_cal_speed_function_t;
 
 
@@ -61,13 +63,14 @@ typedef struct  mcl_encoder_callback {
     _FUNC_OPTIONAL_ hpm_mcl_stat_t (*get_absolute_theta)(float *theta);
     _FUNC_OPTIONAL_ hpm_mcl_stat_t (*get_uvw_level)(mcl_encoder_uvw_level_t *level);
     _FUNC_OPTIONAL_ hpm_mcl_stat_t (*process_by_user)(float theta, float *speed, float *theta_forecast);
+    _FUNC_OPTIONAL_ hpm_mcl_stat_t (*get_edge)(uint32_t *count, uint32_t *edge_age_tick);   /**< count, 0 to precision - 1, and mcu ticks since the edge that set it */
 } mcl_encoder_callback_t;
 
 /**
  * @brief Maximum memory required for computational speed, word
  *
  */
-#define MCL_ENCODER_CAL_STRUCT_MAX_MEMMORY  (16)
+#define MCL_ENCODER_CAL_STRUCT_MAX_MEMMORY  (20)
 typedef struct {
     float theta_last;
     float speed_last;
@@ -108,6 +111,37 @@ typedef struct {
     float theta_last;
 } mcl_encoder_cal_speed_pll_function_t;
 
+/**
+ * @brief observer configuration
+ *
+ */
+typedef struct {
+    float bandwidth_hz;     /**< The three observer poles are placed at this frequency, keep it below the count rate at the lowest speed that needs a smooth speed */
+} mcl_encoder_cal_speed_observer_cfg_t;
+
+/**
+ * @brief Running data for the observer method of calculating speed
+ *
+ * The mechanical angle runs in fixed point, a full turn wraps the counter.
+ * Speed and acceleration are per call of the handler function.
+ * The gains and scales are computed at initialisation.
+ *
+ */
+typedef struct {
+    uint64_t theta;         /**< 2^64 per turn */
+    int64_t omega;          /**< 2^64 per turn per call */
+    int64_t alpha;          /**< 2^64 per turn per call^2 */
+    uint64_t count_phase;   /**< angle of one count, 2^64 / precision */
+    uint32_t gain[3];       /**< angle, speed and acceleration gains, Q32 */
+    uint32_t inv_period_tick;   /**< calls per tick, Q32 */
+    uint32_t idle_tick;     /**< ticks since the last count change */
+    uint32_t timeout_tick;
+    uint32_t count_last;
+    float speed_scale;      /**< omega >> 32 to rad/s */
+    bool reverse;           /**< the last count change was backward */
+    bool valid;
+} mcl_encoder_cal_speed_observer_function_t;
+
 /**
  * @brief Encoder Configuration
  *
@@ -117,6 +151,7 @@ typedef struct {
     uint64_t communication_interval_us; /**< The communication interval of the communicating encoder ensures that an angle reading can be completed within the interval. Optical encoders can be read at any time, given as zero. */
     mcl_encoder_cal_speed_function_t speed_cal_method;
     mcl_encoder_cal_speed_pll_cfg_t cal_speed_pll_cfg;
+    mcl_encoder_cal_speed_observer_cfg_t cal_speed_observer_cfg;
     float timeout_s;                  /**< Timeout time, after this time angle is not updated, the speed will be cleared to zero. */
     float speed_abs_switch_m_t;     /**< Use the m_t method to set the validity, the speed is greater than the set speed, use the m method, the speed is less than the set speed t use the t method to calculate the speed. */
     uint32_t precision;     /**< Sensor accuracy, various encoders converted to number of lines. The maximum number of angular changes that can occur per revolution of the motor. */
@@ -135,6 +170,7 @@ typedef struct {
         mcl_encoder_cal_speed_m_function_t m_method;
         mcl_encoder_cal_speed_m_t_function_t m_t_method;
         mcl_encoder_cal_speed_pll_function_t pll_method;
+        mcl_encoder_cal_speed_observer_function_t observer_method;
         uint32_t memory[MCL_ENCODER_CAL_STRUCT_MAX_MEMMORY];
     } cal_speed;
     mcl_filter_iir_df1_t *iirfilter;
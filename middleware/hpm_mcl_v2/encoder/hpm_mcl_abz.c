@@ -50,3 +50,20 @@ hpm_mcl_stat_t hpm_mcl_abz_get_abs_theta(void *qei_base, uint32_t phase_count, f
 
     return mcl_success;
 }
+
+hpm_mcl_stat_t hpm_mcl_abz_get_edge(void *qei_base, uint32_t phase_count, uint32_t *count, uint32_t *edge_age_tick)
+{
+    MCL_ASSERT_OPT((count != NULL) && (edge_age_tick != NULL), mcl_invalid_pointer);
+#ifdef HPMSOC_HAS_HPMSDK_QEIV2
+    /* phase and speed counter from the same read event */
+    qeiv2_load_counter_to_read_registers((QEIV2_Type *)qei_base);
+    *count = QEIV2_COUNT_PH_PHCNT_GET(qeiv2_get_count_on_read_event((QEIV2_Type *)qei_base, qeiv2_counter_type_phase)) % phase_count;
+    *edge_age_tick = QEIV2_COUNT_SPD_SPDCNT_GET(qeiv2_get_count_on_read_event((QEIV2_Type *)qei_base, qeiv2_counter_type_speed));
+
+    return mcl_success;
+#else
+    (void)qei_base;
+    (void)phase_count;
+    return mcl_in_development;
+#endif
+}
@@ -36,6 +36,20 @@ hpm_mcl_stat_t hpm_mcl_abz_get_theta(void *qei_base, uint32_t phase_count, float
  */
 hpm_mcl_stat_t hpm_mcl_abz_get_abs_theta(void *qei_base, uint32_t phase_count, float deta_theta, float theta0, float *theta);
 
+/**
+ * @brief Get the count of the abz encoder and the age of the edge that set it, for the observer method of the encoder
+ *
+ * @note The age is counted by the QEIV2 speed counter in QEI clock cycles, the get_edge callback converts it
+ * if the QEI clock differs from the mcu clock of the encoder.
+ *
+ * @param qei_base qei peripheral base address
+ * @param phase_count Number of pulses per revolution
+ * @param count count, 0 to phase_count - 1
+ * @param edge_age_tick cycles since the last phase edge
+ * @return hpm_mcl_stat_t
+ */
+hpm_mcl_stat_t hpm_mcl_abz_get_edge(void *qei_base, uint32_t phase_count, uint32_t *count, uint32_t *edge_age_tick);
+
 #ifdef __cplusplus
 }
 #endif
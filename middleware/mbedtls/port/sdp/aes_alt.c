@@ -522,6 +522,10 @@ static void aes_gen_tables( void )
 #define AES_FT3(idx) FT3[idx]
 
 #endif /* MBEDTLS_AES_FEWER_TABLES */
+#if defined(CONFIG_MBEDTLS_USE_HPM_SDP)
+static void hpm_sdp_aes_release_key(const mbedtls_aes_context *ctx);
+#endif
+
 static void sdp_api_init(void)
 {
     rom_sdp_init();
@@ -540,6 +544,10 @@ void mbedtls_aes_free( mbedtls_aes_context *ctx )
     if( ctx == NULL )
         return;
 
+#if defined(CONFIG_MBEDTLS_USE_HPM_SDP)
+    hpm_sdp_aes_release_key( ctx );
+#endif
+
     mbedtls_platform_zeroize( ctx, sizeof( mbedtls_aes_context ) );
 }
 
@@ -705,8 +713,8 @@ int mbedtls_aes_setkey_dec_sw( mbedtls_aes_context *ctx, const unsigned char *ke
 #endif
     ctx->rk = RK = ctx->buf;
 
-    /* Also checks keybits */
-    if( ( ret = mbedtls_aes_setkey_enc( &cty, key, keybits ) ) != 0 )
+    /* Also checks keybits, the port keeps only the raw key in an encryption key schedule */
+    if( ( ret = mbedtls_aes_setkey_enc_sw( &cty, key, keybits ) ) != 0 )
         goto exit;
 
     ctx->nr = cty.nr;
@@ -1822,19 +1830,184 @@ int mbedtls_aes_crypt_ctr( mbedtls_aes_context *ctx,
  *          HPM SDP AES
  */
 #if defined(CONFIG_MBEDTLS_USE_HPM_SDP)
-#if defined(MBEDTLS_AES_SETKEY_ENC_ALT)
+
 /*
- * AES key schedule (encryption)
+ * SDP key RAM slots used as key cache. A slot holds one 256-bit key or one
+ * 128-bit key, 256-bit key slot n covers the 128-bit key slots 2n and 2n + 1.
  */
-int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
+#ifndef HPM_SDP_AES_KEY_SLOT_COUNT
+#define HPM_SDP_AES_KEY_SLOT_COUNT (8U)
+#endif
+
+#if (HPM_SDP_AES_KEY_SLOT_COUNT == 0U) || (HPM_SDP_AES_KEY_SLOT_COUNT > 8U)
+#error "HPM_SDP_AES_KEY_SLOT_COUNT must be 1 to 8"
+#endif
+
+/* noncacheable buffer for data the SDP can not access in place, multiple of the cache line size */
+#ifndef HPM_SDP_AES_BOUNCE_SIZE
+#define HPM_SDP_AES_BOUNCE_SIZE (512U)
+#endif
+
+/* below this size copying through the bounce buffer is cheaper than the cache maintenance */
+#ifndef HPM_SDP_AES_IN_PLACE_MIN_SIZE
+#define HPM_SDP_AES_IN_PLACE_MIN_SIZE (256U)
+#endif
+
+typedef struct {
+    const mbedtls_aes_context *owner;
+    uint32_t tag;
+} hpm_sdp_aes_key_slot_t;
+
+static hpm_sdp_aes_key_slot_t s_aes_key_slots[HPM_SDP_AES_KEY_SLOT_COUNT];
+static uint32_t s_aes_key_tag;
+static uint8_t s_aes_key_victim;
+static mbedtls_hpm_sdp_aes_stat_t s_aes_stat;
+static ATTR_PLACE_AT_NONCACHEABLE_WITH_ALIGNMENT(HPM_L1C_CACHELINE_SIZE) uint8_t s_aes_bounce[HPM_SDP_AES_BOUNCE_SIZE];
+
+static inline sdp_aes_ctx_t *hpm_sdp_aes_hw_ctx(void)
 {
-    uint32_t *RK;
+    return (sdp_aes_ctx_t *) core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) &s_aes_ctx);
+}
+
+static inline uint8_t *hpm_sdp_aes_sys_addr(const void *addr)
+{
+    return (uint8_t *) core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) addr);
+}
+
+static int hpm_sdp_aes_lock(void)
+{
+#if defined(MBEDTLS_THREADING_C)
+    return mbedtls_mutex_lock(&mbedtls_threading_hwcrypto_hashcrypt_mutex);
+#else
+    return 0;
+#endif
+}
 
+static int hpm_sdp_aes_unlock(int ret)
+{
+#if defined(MBEDTLS_THREADING_C)
+    int unlock_ret = mbedtls_mutex_unlock(&mbedtls_threading_hwcrypto_hashcrypt_mutex);
+    return (ret != 0) ? ret : unlock_ret;
+#else
+    return ret;
+#endif
+}
+
+/* give the context a key tag no slot is tagged with */
+static int hpm_sdp_aes_renew_key_tag(mbedtls_aes_context *ctx)
+{
+    int ret = hpm_sdp_aes_lock();
+
+    if (ret == 0) {
+        if (++s_aes_key_tag == 0U) {
+            s_aes_key_tag = 1U;
+        }
+        ctx->key_tag = s_aes_key_tag;
+    }
+    return hpm_sdp_aes_unlock(ret);
+}
+
+static void hpm_sdp_aes_release_key(const mbedtls_aes_context *ctx)
+{
+    if ((ctx->key_tag == 0U) || (hpm_sdp_aes_lock() != 0)) {
+        return;
+    }
+    if ((ctx->key_slot < HPM_SDP_AES_KEY_SLOT_COUNT) && (s_aes_key_slots[ctx->key_slot].owner == ctx)) {
+        s_aes_key_slots[ctx->key_slot].owner = NULL;
+        s_aes_key_slots[ctx->key_slot].tag = 0U;
+    }
+    (void) hpm_sdp_aes_unlock(0);
+}
+
+/*
+ * Point the SDP context at the key of ctx, the key RAM is programmed only if
+ * the slot of ctx was taken over by another key since. Called with the lock held.
+ */
+static int hpm_sdp_aes_load_key(mbedtls_aes_context *ctx, sdp_aes_ctx_t *aes_ctx)
+{
+    sdp_aes_key_bits_t key_bits;
+    uint8_t slot = ctx->key_slot;
+
+    switch (ctx->nr) {
+    case 10:
+        key_bits = sdp_aes_keybits_128;
+        break;
+    case 14:
+        key_bits = sdp_aes_keybits_256;
+        break;
+    default:
+        return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+    }
+
+    if ((slot < HPM_SDP_AES_KEY_SLOT_COUNT) && (s_aes_key_slots[slot].owner == ctx)) {
+        if ((ctx->key_tag != 0U) && (s_aes_key_slots[slot].tag == ctx->key_tag)) {
+            aes_ctx->crypto_algo = sdp_crypto_alg_aes;
+            aes_ctx->key_bits = key_bits;
+            aes_ctx->key_idx = slot * 2U;
+            s_aes_stat.key_hits++;
+            return 0;
+        }
+        /* the key changed, reuse the slot */
+    } else {
+        for (slot = 0; slot < HPM_SDP_AES_KEY_SLOT_COUNT; slot++) {
+            if (s_aes_key_slots[slot].owner == NULL) {
+                break;
+            }
+        }
+        if (slot == HPM_SDP_AES_KEY_SLOT_COUNT) {
+            slot = s_aes_key_victim;
+            s_aes_key_victim = (uint8_t) ((s_aes_key_victim + 1U) % HPM_SDP_AES_KEY_SLOT_COUNT);
+        }
+    }
+
+    if (status_success != sdp_aes_set_key(HPM_SDP, aes_ctx, (const uint8_t *) ctx->rk, key_bits,
+                                          (key_bits == sdp_aes_keybits_256) ? slot : (slot * 2U))) {
+        s_aes_key_slots[slot].owner = NULL;
+        return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+    }
+    s_aes_key_slots[slot].owner = ctx;
+    s_aes_key_slots[slot].tag = ctx->key_tag;
+    ctx->key_slot = slot;
+    s_aes_stat.key_loads++;
+
+    return 0;
+}
+
+int mbedtls_hpm_sdp_aes_begin(mbedtls_aes_context *ctx, sdp_aes_ctx_t **aes_ctx)
+{
+    int ret = hpm_sdp_aes_lock();
+
+    if (ret == 0) {
+        *aes_ctx = hpm_sdp_aes_hw_ctx();
+        ret = hpm_sdp_aes_load_key(ctx, *aes_ctx);
+        if (ret != 0) {
+            (void) hpm_sdp_aes_unlock(ret);
+        }
+    }
+    return ret;
+}
+
+int mbedtls_hpm_sdp_aes_end(int ret)
+{
+    s_aes_stat.hw_calls++;
+    return hpm_sdp_aes_unlock(ret);
+}
+
+void mbedtls_hpm_sdp_aes_get_stat(mbedtls_hpm_sdp_aes_stat_t *stat)
+{
+    *stat = s_aes_stat;
+}
+
+void mbedtls_hpm_sdp_aes_reset_stat(void)
+{
+    memset(&s_aes_stat, 0, sizeof(s_aes_stat));
+}
+
+static int hpm_sdp_aes_set_key_schedule(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
+{
     AES_VALIDATE_RET( ctx != NULL );
     AES_VALIDATE_RET( key != NULL );
 
-    ctx->rk = RK = ctx->buf;
-    (void)memcpy(RK, (const uint32_t *)(uintptr_t)key, keybits / 8U);
     /* Set keysize in bytes.*/
     switch (keybits)
     {
@@ -1850,8 +2023,43 @@ int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key, u
         default:
             return (MBEDTLS_ERR_AES_INVALID_KEY_LENGTH);
     }
-    return (0);
+    /* the SDP expands the key itself, only the raw key is kept */
+    ctx->rk = ctx->buf;
+    (void)memcpy(ctx->rk, (const uint32_t *)(uintptr_t)key, keybits / 8U);
+
+    return hpm_sdp_aes_renew_key_tag(ctx);
+}
+
+#if defined(MBEDTLS_AES192_ALT_SW)
+/*
+ * The SDP has no AES-192, such keys get the software key schedule and every
+ * operation with them runs in software. nr tells the two apart.
+ */
+#define HPM_SDP_AES_IS_SW(ctx) ((ctx)->nr == 12)
+
+static int hpm_sdp_aes_set_key_sw(mbedtls_aes_context *ctx, const unsigned char *key, int mode)
+{
+    hpm_sdp_aes_release_key(ctx);
+    ctx->key_tag = 0U;
+    return (mode == MBEDTLS_AES_ENCRYPT) ? mbedtls_aes_setkey_enc_sw(ctx, key, 192)
+                                         : mbedtls_aes_setkey_dec_sw(ctx, key, 192);
+}
+#else
+#define HPM_SDP_AES_IS_SW(ctx) (false)
+#endif
 
+#if defined(MBEDTLS_AES_SETKEY_ENC_ALT)
+/*
+ * AES key schedule (encryption)
+ */
+int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
+{
+#if defined(MBEDTLS_AES192_ALT_SW)
+    if (keybits == 192U) {
+        return hpm_sdp_aes_set_key_sw(ctx, key, MBEDTLS_AES_ENCRYPT);
+    }
+#endif
+    return hpm_sdp_aes_set_key_schedule(ctx, key, keybits);
 }
 #endif /* MBEDTLS_AES_SETKEY_ENC_ALT */
 
@@ -1861,74 +2069,53 @@ int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key, u
  */
 int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
 {
-    uint32_t *RK;
+#if defined(MBEDTLS_AES192_ALT_SW)
+    if (keybits == 192U) {
+        return hpm_sdp_aes_set_key_sw(ctx, key, MBEDTLS_AES_DECRYPT);
+    }
+#endif
+    return hpm_sdp_aes_set_key_schedule(ctx, key, keybits);
+}
+#endif /* MBEDTLS_AES_SETKEY_DEC_ALT */
 
-    AES_VALIDATE_RET( ctx != NULL );
-    AES_VALIDATE_RET( key != NULL );
+#if defined(MBEDTLS_AES_SETKEY_ENC_ALT) || defined(MBEDTLS_AES_SETKEY_DEC_ALT)
+static int hpm_sdp_aes_crypt_block(mbedtls_aes_context *ctx, sdp_aes_op_t op,
+                                   const unsigned char input[16], unsigned char output[16])
+{
+    sdp_aes_ctx_t *aes_ctx;
+    uint8_t *block;
+    int ret;
 
-    ctx->rk = RK = ctx->buf;
-    (void)memcpy(RK, (const uint32_t *)(uintptr_t)key, keybits / 8U);
-    /* Set keysize in bytes.*/
-    switch (keybits)
-    {
-        case 128:
-            ctx->nr = 10;
-            break;
-        case 192:
-            ctx->nr = 12;
-            break;
-        case 256:
-            ctx->nr = 14;
-            break;
-        default:
-            return (MBEDTLS_ERR_AES_INVALID_KEY_LENGTH);
+#if defined(MBEDTLS_AES192_ALT_SW)
+    if (HPM_SDP_AES_IS_SW(ctx)) {
+        return (op == sdp_aes_op_encrypt) ? mbedtls_internal_aes_encrypt_sw(ctx, input, output)
+                                          : mbedtls_internal_aes_decrypt_sw(ctx, input, output);
+    }
+#endif
+    ret = mbedtls_hpm_sdp_aes_begin(ctx, &aes_ctx);
+    if (ret != 0) {
+        return ret;
+    }
+    /* the SDP context is noncacheable, its spare buffer holds the block */
+    block = (uint8_t *) s_aes_ctx.buf0;
+    memcpy(block, input, 16);
+    if (status_success == sdp_aes_crypt_ecb(HPM_SDP, aes_ctx, op, 16, hpm_sdp_aes_sys_addr(block),
+                                            hpm_sdp_aes_sys_addr(block))) {
+        memcpy(output, block, 16);
+    } else {
+        ret = MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
     }
-    return (0);
+    return mbedtls_hpm_sdp_aes_end(ret);
 }
-#endif /* MBEDTLS_AES_SETKEY_DEC_ALT */
+#endif
 
 #if defined(MBEDTLS_AES_SETKEY_ENC_ALT)
-
 /*
  * AES-ECB block encryption
  */
 int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx, const unsigned char input[16], unsigned char output[16])
 {
-    static uint8_t ATTR_PLACE_AT_NONCACHEABLE local_tmp[32];
-#if defined(MBEDTLS_THREADING_C)
-    int ret;
-    if ((ret = mbedtls_mutex_lock(&mbedtls_threading_hwcrypto_hashcrypt_mutex)) != 0)
-        return (ret);
-#endif
-    sdp_crypto_key_bits_t key_size;
-    switch (ctx->nr)
-    {
-        case 10:
-            key_size = sdp_aes_keybits_128;
-            break;
-        case 14:
-            key_size = sdp_aes_keybits_256;
-            break;
-        default:
-            return (MBEDTLS_ERR_AES_INVALID_KEY_LENGTH);
-    }
-
-    uint32_t key_tmp = core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) ctx->rk);
-    uint8_t *p_sys_local = (uint8_t *) core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) local_tmp);
-
-    sdp_aes_ctx_t *p_sys_sdp_ctx = (sdp_aes_ctx_t *) core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) &s_aes_ctx);
-    memcpy(p_sys_local, (uint8_t *)key_tmp, key_size == sdp_aes_keybits_128 ? 16 : 32);
-
-    hpm_stat_t status = rom_sdp_aes_set_key(p_sys_sdp_ctx, (const uint8_t *)p_sys_local, key_size, 0);
-
-    memcpy(p_sys_local, input, 16);
-    status = rom_sdp_aes_crypt_ecb(p_sys_sdp_ctx, sdp_aes_op_encrypt, 16, p_sys_local, p_sys_local);
-    memcpy(output, p_sys_local, 16);
-#if defined(MBEDTLS_THREADING_C)
-    if ((ret = mbedtls_mutex_unlock(&mbedtls_threading_hwcrypto_hashcrypt_mutex)) != 0)
-        return (ret);
-#endif
-    return (status_success == status) ? 0 : MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+    return hpm_sdp_aes_crypt_block(ctx, sdp_aes_op_encrypt, input, output);
 }
 #endif /* MBEDTLS_AES_SETKEY_ENC_ALT */
 
@@ -1938,45 +2125,93 @@ int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx, const unsigned char i
  */
 int mbedtls_internal_aes_decrypt(mbedtls_aes_context *ctx, const unsigned char input[16], unsigned char output[16])
 {
-    static uint8_t ATTR_PLACE_AT_NONCACHEABLE local_tmp[16];
-#if defined(MBEDTLS_THREADING_C)
-    int ret;
-    if ((ret = mbedtls_mutex_lock(&mbedtls_threading_hwcrypto_hashcrypt_mutex)) != 0)
-        return (ret);
-#endif
-    sdp_crypto_key_bits_t key_size;
-    switch (ctx->nr)
-    {
-        case 10:
-            key_size = sdp_aes_keybits_128;
-            break;
-        case 14:
-            key_size = sdp_aes_keybits_256;
-            break;
-        default:
-            return (MBEDTLS_ERR_AES_INVALID_KEY_LENGTH);
+    return hpm_sdp_aes_crypt_block(ctx, sdp_aes_op_decrypt, input, output);
+}
+#endif /* MBEDTLS_AES_SETKEY_DEC_ALT */
+
+#if defined(MBEDTLS_CIPHER_MODE_CBC)
+
+#if defined(MBEDTLS_AES_CRYPT_CBC_ALT)
+/*
+ * The SDP accesses the buffers directly if they are large enough and the
+ * cache maintenance can not touch data next to them, otherwise the data is
+ * copied through the noncacheable bounce buffer. There is no software path
+ * for them: the context keeps only the raw key for the SDP, and copying a
+ * block costs far less than a table based software AES of it.
+ */
+static bool hpm_sdp_aes_can_use_in_place(const unsigned char *input, const unsigned char *output, size_t length)
+{
+    uint32_t align = l1c_dc_is_enabled() ? HPM_L1C_CACHELINE_SIZE : sizeof(uint32_t);
+
+    return (length >= HPM_SDP_AES_IN_PLACE_MIN_SIZE)
+        && ((((uint32_t) input | (uint32_t) output | (uint32_t) length) & (align - 1U)) == 0U);
+}
+
+static int hpm_sdp_aes_crypt_cbc_chunk(sdp_aes_ctx_t *aes_ctx, sdp_aes_op_t op, uint32_t length,
+                                       const unsigned char iv[16], const unsigned char *input,
+                                       unsigned char *output, bool in_place)
+{
+    uint8_t *src;
+    uint8_t *dst;
+
+    if (in_place) {
+        src = hpm_sdp_aes_sys_addr(input);
+        dst = hpm_sdp_aes_sys_addr(output);
+        if (l1c_dc_is_enabled()) {
+            l1c_dc_writeback((uint32_t) src, length);
+            l1c_dc_invalidate((uint32_t) dst, length);
+        }
+    } else {
+        src = hpm_sdp_aes_sys_addr(s_aes_bounce);
+        dst = src;
+        memcpy(s_aes_bounce, input, length);
+        s_aes_stat.bounce_blocks++;
     }
 
-    uint32_t key_tmp = core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) ctx->rk);
-    uint8_t *p_sys_local = (uint8_t *) core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) local_tmp);
+    if (status_success != sdp_aes_crypt_cbc(HPM_SDP, aes_ctx, op, length, iv, src, dst)) {
+        return MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+    }
 
-    sdp_aes_ctx_t *p_sys_sdp_ctx = (sdp_aes_ctx_t *) core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) &s_aes_ctx);
-    memcpy(p_sys_local, (uint8_t *)key_tmp, key_size == sdp_aes_keybits_128 ? 16 : 32);
-    hpm_stat_t status = rom_sdp_aes_set_key(p_sys_sdp_ctx, (const uint8_t *)key_tmp, key_size, 0);
+    if (!in_place) {
+        memcpy(output, s_aes_bounce, length);
+    } else if (l1c_dc_is_enabled()) {
+        /* drop lines fetched speculatively during the transfer */
+        l1c_dc_invalidate((uint32_t) dst, length);
+    }
+    return 0;
+}
 
-    memcpy(p_sys_local, input, 16);
-    status = rom_sdp_aes_crypt_ecb(p_sys_sdp_ctx, sdp_aes_op_decrypt, 16, p_sys_local, p_sys_local);
-    memcpy(output, p_sys_local, 16);
-#if defined(MBEDTLS_THREADING_C)
-    if ((ret = mbedtls_mutex_unlock(&mbedtls_threading_hwcrypto_hashcrypt_mutex)) != 0)
-        return (ret);
-#endif
-    return (status_success == status) ? 0 : MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+#if defined(MBEDTLS_AES192_ALT_SW)
+/* AES-CBC of keys the SDP does not take, block by block */
+static int hpm_sdp_aes_crypt_cbc_sw(mbedtls_aes_context *ctx, int mode, size_t length, unsigned char iv[16],
+                                    const unsigned char *input, unsigned char *output)
+{
+    unsigned char temp[16];
+    int ret = 0;
+
+    while ((ret == 0) && (length > 0U)) {
+        if (mode == MBEDTLS_AES_DECRYPT) {
+            memcpy(temp, input, 16);
+            ret = mbedtls_aes_crypt_ecb(ctx, mode, input, output);
+            for (int i = 0; i < 16; i++) {
+                output[i] = (unsigned char) (output[i] ^ iv[i]);
+            }
+            memcpy(iv, temp, 16);
+        } else {
+            for (int i = 0; i < 16; i++) {
+                output[i] = (unsigned char) (input[i] ^ iv[i]);
+            }
+            ret = mbedtls_aes_crypt_ecb(ctx, mode, output, output);
+            memcpy(iv, output, 16);
+        }
+        input += 16;
+        output += 16;
+        length -= 16U;
+    }
+    return ret;
 }
-#endif /* MBEDTLS_AES_SETKEY_DEC_ALT */
-#if defined(MBEDTLS_CIPHER_MODE_CBC)
+#endif
 
-#if defined(MBEDTLS_AES_CRYPT_CBC_ALT)
 /*
  * AES-CBC buffer encryption/decryption
  */
@@ -1987,10 +2222,12 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
                           const unsigned char *input,
                           unsigned char *output)
 {
-    static uint8_t ATTR_PLACE_AT_NONCACHEABLE local_iv[16];
-    uint8_t *local_tmp = malloc(HPM_L1C_CACHELINE_SIZE + length);
-    assert((uint32_t)local_tmp > 0);
-    sdp_aes_ctx_t *p_sys_sdp_ctx = (sdp_aes_ctx_t *) core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) &s_aes_ctx);
+    sdp_aes_ctx_t *aes_ctx;
+    sdp_aes_op_t op = (mode == MBEDTLS_AES_ENCRYPT) ? sdp_aes_op_encrypt : sdp_aes_op_decrypt;
+    unsigned char next_iv[16];
+    bool in_place;
+    size_t chunk;
+    int ret;
 
     AES_VALIDATE_RET( ctx != NULL );
     AES_VALIDATE_RET( mode == MBEDTLS_AES_ENCRYPT ||
@@ -2001,91 +2238,157 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
 
     if (length % 16)
         return (MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH);
-
-#if defined(MBEDTLS_THREADING_C)
-    int ret;
-    if ((ret = mbedtls_mutex_lock(&mbedtls_threading_hwcrypto_hashcrypt_mutex)) != 0)
-        return (ret);
+    if (length == 0U)
+        return 0;
+#if defined(MBEDTLS_AES192_ALT_SW)
+    if (HPM_SDP_AES_IS_SW(ctx))
+        return hpm_sdp_aes_crypt_cbc_sw(ctx, mode, length, iv, input, output);
 #endif
 
-    sdp_crypto_key_bits_t key_size;
-    switch (ctx->nr)
-    {
-        case 10:
-            key_size = sdp_aes_keybits_128;
-            break;
-        case 14:
-            key_size = sdp_aes_keybits_256;
-            break;
-        default:
-            return (MBEDTLS_ERR_AES_INVALID_KEY_LENGTH);
-    }
+    ret = mbedtls_hpm_sdp_aes_begin(ctx, &aes_ctx);
+    if (ret != 0)
+        return ret;
 
-    uint32_t key_tmp = core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) ctx->rk);
-    uint8_t *p_sys_local = (uint8_t *) core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t) local_tmp);
-    p_sys_local = (uint8_t *)HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)p_sys_local + HPM_L1C_CACHELINE_SIZE);
-
-    hpm_stat_t status;
-    size_t key_len = (key_size == sdp_aes_keybits_128 ? 16 : 32);
-    memcpy(p_sys_local, (uint8_t *)key_tmp, key_len);
-    if (l1c_dc_is_enabled()) {
-        uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)p_sys_local);
-        uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)p_sys_local + key_len);
-        uint32_t aligned_size = aligned_end - aligned_start;
-        l1c_dc_flush((uint32_t)aligned_start, aligned_size);
+    in_place = hpm_sdp_aes_can_use_in_place(input, output, length);
+    while ((ret == 0) && (length > 0U)) {
+        chunk = in_place ? length : MIN(length, HPM_SDP_AES_BOUNCE_SIZE);
+        if (op == sdp_aes_op_decrypt) {
+            /* the last cipher text block is the next IV, save it before output overwrites it */
+            memcpy(next_iv, &input[chunk - 16U], 16);
+        }
+        ret = hpm_sdp_aes_crypt_cbc_chunk(aes_ctx, op, chunk, iv, input, output, in_place);
+        if (ret == 0) {
+            memcpy(iv, (op == sdp_aes_op_decrypt) ? next_iv : &output[chunk - 16U], 16);
+        }
+        input += chunk;
+        output += chunk;
+        length -= chunk;
     }
-    status = rom_sdp_aes_set_key(p_sys_sdp_ctx, (const uint8_t *)p_sys_local, key_size, 0);
-
-    memcpy(p_sys_local, (uint8_t *)input, length);
-    if (l1c_dc_is_enabled()) {
-        uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)p_sys_local);
-        uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)p_sys_local + length);
-        uint32_t aligned_size = aligned_end - aligned_start;
-        l1c_dc_flush((uint32_t)aligned_start, aligned_size);
+    mbedtls_platform_zeroize(next_iv, sizeof(next_iv));
+
+    return mbedtls_hpm_sdp_aes_end(ret);
+}
+#endif /* defined(MBEDTLS_AES_CRYPT_CBC_ALT) */
+#endif /* MBEDTLS_CIPHER_MODE_CBC */
+
+#if defined(MBEDTLS_CIPHER_MODE_CTR)
+
+#if defined(MBEDTLS_AES_CRYPT_CTR_ALT)
+/* counter blocks encrypted by one SDP operation */
+#define HPM_SDP_AES_CTR_BLOCKS (HPM_SDP_AES_BOUNCE_SIZE / 16U)
+
+static void hpm_sdp_aes_ctr_increment(unsigned char counter[16])
+{
+    for (int i = 15; i >= 0; i--) {
+        if (++counter[i] != 0U) {
+            break;
+        }
     }
+}
+
+/*
+ * AES-CTR buffer encryption/decryption
+ */
+int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx,
+                          size_t length,
+                          size_t *nc_off,
+                          unsigned char nonce_counter[16],
+                          unsigned char stream_block[16],
+                          const unsigned char *input,
+                          unsigned char *output)
+{
+    sdp_aes_ctx_t *aes_ctx;
+    unsigned char counter[16];
+    size_t n;
+    size_t blocks;
+    size_t chunk;
+    size_t i;
+    int ret;
 
-    memcpy(local_iv, iv, 16);
+    AES_VALIDATE_RET( ctx != NULL );
+    AES_VALIDATE_RET( nc_off != NULL );
+    AES_VALIDATE_RET( nonce_counter != NULL );
+    AES_VALIDATE_RET( stream_block != NULL );
+    AES_VALIDATE_RET( input != NULL );
+    AES_VALIDATE_RET( output != NULL );
 
-    if (mode == MBEDTLS_AES_DECRYPT)
-    {
-        status = rom_sdp_aes_crypt_cbc(p_sys_sdp_ctx, sdp_aes_op_decrypt, length, local_iv, p_sys_local, p_sys_local);
-        if (status_success == status)
-        {
-            if (l1c_dc_is_enabled()) {
-                uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)p_sys_local);
-                uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)p_sys_local + length);
-                uint32_t aligned_size = aligned_end - aligned_start;
-                l1c_dc_invalidate((uint32_t)p_sys_local, aligned_size);
+    n = *nc_off;
+    if (n > 0x0F)
+        return (MBEDTLS_ERR_AES_BAD_INPUT_DATA);
+
+    if (HPM_SDP_AES_IS_SW(ctx)) {
+        /* one block of key stream at a time */
+        while (length-- > 0U) {
+            if (n == 0U) {
+                ret = mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, nonce_counter, stream_block);
+                if (ret != 0)
+                    return ret;
+                hpm_sdp_aes_ctr_increment(nonce_counter);
             }
-            memcpy(output, p_sys_local, length);
-            memcpy(iv, local_iv, 16);
+            *output++ = (unsigned char) (*input++ ^ stream_block[n]);
+            n = (n + 1U) & 0x0F;
         }
+        *nc_off = n;
+        return 0;
     }
-    else
-    {
-        status = rom_sdp_aes_crypt_cbc(p_sys_sdp_ctx, sdp_aes_op_encrypt, length, local_iv, p_sys_local, p_sys_local);
-        if (status_success == status)
-        {
-            if (l1c_dc_is_enabled()) {
-                uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)p_sys_local);
-                uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)p_sys_local + length);
-                uint32_t aligned_size = aligned_end - aligned_start;
-                l1c_dc_invalidate((uint32_t)p_sys_local, aligned_size);
-            }
-            memcpy(output, p_sys_local, length);
-            memcpy(iv, local_iv, 16);
+
+    /* use up the key stream left over by the previous call */
+    while ((n != 0U) && (length > 0U)) {
+        *output++ = (unsigned char) (*input++ ^ stream_block[n]);
+        n = (n + 1U) & 0x0F;
+        length--;
+    }
+    if (length == 0U) {
+        *nc_off = n;
+        return 0;
+    }
+
+    ret = mbedtls_hpm_sdp_aes_begin(ctx, &aes_ctx);
+    if (ret != 0)
+        return ret;
+
+    /*
+     * The counter blocks of a chunk are laid out in the bounce buffer and
+     * encrypted by one ECB operation, the key stream is applied by the CPU.
+     */
+    memcpy(counter, nonce_counter, 16);
+    while ((ret == 0) && (length > 0U)) {
+        blocks = MIN((length + 15U) / 16U, HPM_SDP_AES_CTR_BLOCKS);
+        for (i = 0; i < blocks; i++) {
+            memcpy(&s_aes_bounce[i * 16U], counter, 16);
+            hpm_sdp_aes_ctr_increment(counter);
+        }
+        if (status_success != sdp_aes_crypt_ecb(HPM_SDP, aes_ctx, sdp_aes_op_encrypt, blocks * 16U,
+                                                hpm_sdp_aes_sys_addr(s_aes_bounce),
+                                                hpm_sdp_aes_sys_addr(s_aes_bounce))) {
+            ret = MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+            break;
+        }
+        chunk = MIN(length, blocks * 16U);
+        for (i = 0; i < chunk; i++) {
+            output[i] = (unsigned char) (input[i] ^ s_aes_bounce[i]);
         }
+        if ((chunk & 0x0FU) != 0U) {
+            /* partial last block, its key stream is kept for the next call */
+            memcpy(stream_block, &s_aes_bounce[chunk & ~((size_t) 0x0F)], 16);
+            n = chunk & 0x0FU;
+        }
+        input += chunk;
+        output += chunk;
+        length -= chunk;
     }
 
-#if defined(MBEDTLS_THREADING_C)
-    if ((ret = mbedtls_mutex_unlock(&mbedtls_threading_hwcrypto_hashcrypt_mutex)) != 0)
-        return (ret);
-#endif
-    free(local_tmp);
-    return (status_success == status) ? 0 : MBEDTLS_ERR_AES_HW_ACCEL_FAILED;
+    if (ret == 0) {
+        memcpy(nonce_counter, counter, 16);
+        *nc_off = n;
+    }
+    mbedtls_platform_zeroize(s_aes_bounce, sizeof(s_aes_bounce));
+    mbedtls_platform_zeroize(counter, sizeof(counter));
+
+    return mbedtls_hpm_sdp_aes_end(ret);
 }
-#endif /* defined(MBEDTLS_AES_CRYPT_CBC_ALT) */
-#endif /* MBEDTLS_CIPHER_MODE_CBC */
+#endif /* MBEDTLS_AES_CRYPT_CTR_ALT */
+#endif /* MBEDTLS_CIPHER_MODE_CTR */
 
 #endif /* !CONFIG_MBEDTLS_USE_HPM_SDP */
 
@@ -78,7 +78,56 @@ typedef struct mbedtls_aes_context {
                             <li>Simplifying key expansion in the 256-bit
                                 case by generating an extra round key.
                                 </li></ul> */
+    uint32_t key_tag;  /*!< Identifies the key in the SDP key slot cache,
+                            renewed by every setkey, 0 if not cached. */
+    uint8_t key_slot;  /*!< SDP key slot holding the key, valid only if
+                            the slot is still tagged with key_tag. */
 } mbedtls_aes_context;
+
+/**
+ * \brief SDP AES usage counters, e.g. for checking the key cache hit rate.
+ */
+typedef struct mbedtls_hpm_sdp_aes_stat {
+    uint32_t key_loads;     /*!< Keys programmed into the SDP key RAM. */
+    uint32_t key_hits;      /*!< Operations that found their key already loaded. */
+    uint32_t hw_calls;      /*!< Buffer operations handed to the SDP. */
+    uint32_t bounce_blocks; /*!< Operations or chunks copied through the bounce buffer. */
+} mbedtls_hpm_sdp_aes_stat_t;
+
+/**
+ * \brief          Get the SDP AES usage counters.
+ *
+ * \param stat     The counters to fill.
+ */
+void mbedtls_hpm_sdp_aes_get_stat(mbedtls_hpm_sdp_aes_stat_t *stat);
+
+/**
+ * \brief          Clear the SDP AES usage counters.
+ */
+void mbedtls_hpm_sdp_aes_reset_stat(void);
+
+/**
+ * \brief          Take the SDP for an AES operation with the key of ctx.
+ *
+ *                 Used by the other SDP based modules. The key is programmed
+ *                 into the SDP key RAM only if it is not cached there yet.
+ *                 On success mbedtls_hpm_sdp_aes_end() must follow.
+ *
+ * \param ctx      The AES context, holding a 128-bit or 256-bit key.
+ * \param aes_ctx  The SDP AES context to use for the operation.
+ *
+ * \return         \c 0 on success, an \c MBEDTLS_ERR_AES_XXX code otherwise.
+ */
+int mbedtls_hpm_sdp_aes_begin(mbedtls_aes_context *ctx, sdp_aes_ctx_t **aes_ctx);
+
+/**
+ * \brief          Release the SDP taken by mbedtls_hpm_sdp_aes_begin().
+ *
+ * \param ret      The result of the operation.
+ *
+ * \return         \p ret, or the error of releasing the lock.
+ */
+int mbedtls_hpm_sdp_aes_end(int ret);
 #endif /* defined(MBEDTLS_AES_ALT) */
 #if defined(MBEDTLS_CIPHER_MODE_XTS)
 /**
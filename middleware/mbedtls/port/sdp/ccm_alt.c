@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_CCM_C) && defined(MBEDTLS_CCM_CRYPT_ALT) && !defined(MBEDTLS_CCM_ALT)
+#include <string.h>
+#include "mbedtls/ccm.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform_util.h"
+#include "hpm_soc.h"
+
+#if !defined(MBEDTLS_AES_ALT) || !defined(CONFIG_MBEDTLS_USE_HPM_SDP)
+#error "MBEDTLS_CCM_CRYPT_ALT requires the SDP based MBEDTLS_AES_ALT"
+#endif
+
+#define CCM_VALIDATE_RET( cond ) \
+    MBEDTLS_INTERNAL_VALIDATE_RET( cond, MBEDTLS_ERR_CCM_BAD_INPUT )
+
+#define CCM_ENCRYPT 0
+#define CCM_DECRYPT 1
+
+/*
+ * Software CCM on top of the block cipher of the context, used for what the
+ * SDP CCM does not cover: other block ciphers and CCM* without tag. AES
+ * blocks still go through the SDP with the cached key.
+ */
+#define UPDATE_CBC_MAC                                                      \
+    for( i = 0; i < 16; i++ )                                               \
+        y[i] ^= b[i];                                                       \
+                                                                            \
+    if( ( ret = mbedtls_cipher_update( &ctx->cipher_ctx, y, 16, y, &olen ) ) != 0 ) \
+        return( ret );
+
+#define CTR_CRYPT( dst, src, len  )                                     \
+    do                                                                  \
+    {                                                                   \
+        if( ( ret = mbedtls_cipher_update( &ctx->cipher_ctx, ctr,       \
+                                           16, b, &olen ) ) != 0 )      \
+        {                                                               \
+            return( ret );                                              \
+        }                                                               \
+                                                                        \
+        for( i = 0; i < (len); i++ )                                    \
+            (dst)[i] = (src)[i] ^ b[i];                                 \
+    } while( 0 )
+
+static int ccm_auth_crypt_sw( mbedtls_ccm_context *ctx, int mode, size_t length,
+                              const unsigned char *iv, size_t iv_len,
+                              const unsigned char *add, size_t add_len,
+                              const unsigned char *input, unsigned char *output,
+                              unsigned char *tag, size_t tag_len )
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    unsigned char i;
+    unsigned char q;
+    size_t len_left, olen;
+    unsigned char b[16];
+    unsigned char y[16];
+    unsigned char ctr[16];
+    const unsigned char *src;
+    unsigned char *dst;
+
+    q = 16 - 1 - (unsigned char) iv_len;
+
+    /* First block B_0: flags, nonce, length */
+    b[0] = 0;
+    b[0] |= ( add_len > 0 ) << 6;
+    b[0] |= ( ( tag_len - 2 ) / 2 ) << 3;
+    b[0] |= q - 1;
+
+    memcpy( b + 1, iv, iv_len );
+
+    for( i = 0, len_left = length; i < q; i++, len_left >>= 8 )
+        b[15-i] = (unsigned char)( len_left & 0xFF );
+
+    /* Start CBC-MAC with first block */
+    memset( y, 0, 16 );
+    UPDATE_CBC_MAC;
+
+    /* Additional data: add_len, add, 0 padding to a block boundary */
+    if( add_len > 0 )
+    {
+        size_t use_len;
+        len_left = add_len;
+        src = add;
+
+        memset( b, 0, 16 );
+        b[0] = (unsigned char)( ( add_len >> 8 ) & 0xFF );
+        b[1] = (unsigned char)( ( add_len      ) & 0xFF );
+
+        use_len = len_left < 16 - 2 ? len_left : 16 - 2;
+        memcpy( b + 2, src, use_len );
+        len_left -= use_len;
+        src += use_len;
+
+        UPDATE_CBC_MAC;
+
+        while( len_left > 0 )
+        {
+            use_len = len_left > 16 ? 16 : len_left;
+
+            memset( b, 0, 16 );
+            memcpy( b, src, use_len );
+            UPDATE_CBC_MAC;
+
+            len_left -= use_len;
+            src += use_len;
+        }
+    }
+
+    /* Counter block: flags, nonce, counter starting at 1 */
+    ctr[0] = q - 1;
+    memcpy( ctr + 1, iv, iv_len );
+    memset( ctr + 1 + iv_len, 0, q );
+    ctr[15] = 1;
+
+    len_left = length;
+    src = input;
+    dst = output;
+
+    while( len_left > 0 )
+    {
+        size_t use_len = len_left > 16 ? 16 : len_left;
+
+        if( mode == CCM_ENCRYPT )
+        {
+            memset( b, 0, 16 );
+            memcpy( b, src, use_len );
+            UPDATE_CBC_MAC;
+        }
+
+        CTR_CRYPT( dst, src, use_len );
+
+        if( mode == CCM_DECRYPT )
+        {
+            memset( b, 0, 16 );
+            memcpy( b, dst, use_len );
+            UPDATE_CBC_MAC;
+        }
+
+        dst += use_len;
+        src += use_len;
+        len_left -= use_len;
+
+        for( i = 0; i < q; i++ )
+            if( ++ctr[15-i] != 0 )
+                break;
+    }
+
+    /* Authentication: reset counter and crypt/mask internal tag */
+    for( i = 0; i < q; i++ )
+        ctr[15-i] = 0;
+
+    CTR_CRYPT( y, y, 16 );
+    memcpy( tag, y, tag_len );
+
+    return( 0 );
+}
+
+/*
+ * The SDP handles AES-128 and AES-256 with a tag, in one call for the whole
+ * message. Returns NULL if the software implementation has to be used.
+ */
+static mbedtls_aes_context *ccm_hpm_sdp_aes_ctx( mbedtls_ccm_context *ctx, size_t tag_len )
+{
+    mbedtls_cipher_type_t type = mbedtls_cipher_get_type( &ctx->cipher_ctx );
+
+    if( ( tag_len == 0 ) ||
+        ( ( type != MBEDTLS_CIPHER_AES_128_ECB ) && ( type != MBEDTLS_CIPHER_AES_256_ECB ) ) )
+        return( NULL );
+
+    return( (mbedtls_aes_context *) ctx->cipher_ctx.cipher_ctx );
+}
+
+static int ccm_check_params( size_t length, size_t iv_len, size_t add_len, size_t tag_len )
+{
+    unsigned char q;
+
+    /*
+     * SP800-38C A.1, loosened for CCM* (IEEE 802.15.4),
+     * a < 2^16 - 2^8 as in the software implementation
+     */
+    if( tag_len == 2 || tag_len > 16 || tag_len % 2 != 0 )
+        return( MBEDTLS_ERR_CCM_BAD_INPUT );
+
+    if( iv_len < 7 || iv_len > 13 )
+        return( MBEDTLS_ERR_CCM_BAD_INPUT );
+
+    if( add_len >= 0xFF00 )
+        return( MBEDTLS_ERR_CCM_BAD_INPUT );
+
+    q = 16 - 1 - (unsigned char) iv_len;
+    if( ( q < sizeof( length ) ) && ( ( length >> ( 8 * q ) ) != 0 ) )
+        return( MBEDTLS_ERR_CCM_BAD_INPUT );
+
+    return( 0 );
+}
+
+/*
+ * Authenticated encryption
+ */
+int mbedtls_ccm_star_encrypt_and_tag( mbedtls_ccm_context *ctx, size_t length,
+                         const unsigned char *iv, size_t iv_len,
+                         const unsigned char *add, size_t add_len,
+                         const unsigned char *input, unsigned char *output,
+                         unsigned char *tag, size_t tag_len )
+{
+    mbedtls_aes_context *aes;
+    sdp_aes_ctx_t *aes_ctx;
+    unsigned char empty;
+    int ret;
+
+    CCM_VALIDATE_RET( ctx != NULL );
+    CCM_VALIDATE_RET( iv != NULL );
+    CCM_VALIDATE_RET( add_len == 0 || add != NULL );
+    CCM_VALIDATE_RET( length == 0 || input != NULL );
+    CCM_VALIDATE_RET( length == 0 || output != NULL );
+    CCM_VALIDATE_RET( tag_len == 0 || tag != NULL );
+
+    if( ( ret = ccm_check_params( length, iv_len, add_len, tag_len ) ) != 0 )
+        return( ret );
+
+    aes = ccm_hpm_sdp_aes_ctx( ctx, tag_len );
+    if( aes == NULL )
+        return( ccm_auth_crypt_sw( ctx, CCM_ENCRYPT, length, iv, iv_len,
+                                   add, add_len, input, output, tag, tag_len ) );
+
+    if( ( ret = mbedtls_hpm_sdp_aes_begin( aes, &aes_ctx ) ) != 0 )
+        return( MBEDTLS_ERR_CCM_HW_ACCEL_FAILED );
+
+    /* the driver rejects NULL buffers even for an empty message */
+    if( length == 0 )
+    {
+        input = &empty;
+        output = &empty;
+    }
+    if( status_success != sdp_aes_ccm_generate_encrypt( HPM_SDP, aes_ctx, length, iv, iv_len,
+                                                        add, add_len, input, output, tag, tag_len ) )
+    {
+        ret = MBEDTLS_ERR_CCM_HW_ACCEL_FAILED;
+    }
+
+    return( mbedtls_hpm_sdp_aes_end( ret ) );
+}
+
+int mbedtls_ccm_encrypt_and_tag( mbedtls_ccm_context *ctx, size_t length,
+                         const unsigned char *iv, size_t iv_len,
+                         const unsigned char *add, size_t add_len,
+                         const unsigned char *input, unsigned char *output,
+                         unsigned char *tag, size_t tag_len )
+{
+    CCM_VALIDATE_RET( ctx != NULL );
+    CCM_VALIDATE_RET( iv != NULL );
+    CCM_VALIDATE_RET( add_len == 0 || add != NULL );
+    CCM_VALIDATE_RET( length == 0 || input != NULL );
+    CCM_VALIDATE_RET( length == 0 || output != NULL );
+    CCM_VALIDATE_RET( tag_len == 0 || tag != NULL );
+    if( tag_len == 0 )
+        return( MBEDTLS_ERR_CCM_BAD_INPUT );
+
+    return( mbedtls_ccm_star_encrypt_and_tag( ctx, length, iv, iv_len, add,
+                add_len, input, output, tag, tag_len ) );
+}
+
+/*
+ * Authenticated decryption
+ */
+int mbedtls_ccm_star_auth_decrypt( mbedtls_ccm_context *ctx, size_t length,
+                      const unsigned char *iv, size_t iv_len,
+                      const unsigned char *add, size_t add_len,
+                      const unsigned char *input, unsigned char *output,
+                      const unsigned char *tag, size_t tag_len )
+{
+    mbedtls_aes_context *aes;
+    sdp_aes_ctx_t *aes_ctx;
+    unsigned char check_tag[16];
+    unsigned char empty;
+    hpm_stat_t status;
+    unsigned char i;
+    int diff;
+    int ret;
+
+    CCM_VALIDATE_RET( ctx != NULL );
+    CCM_VALIDATE_RET( iv != NULL );
+    CCM_VALIDATE_RET( add_len == 0 || add != NULL );
+    CCM_VALIDATE_RET( length == 0 || input != NULL );
+    CCM_VALIDATE_RET( length == 0 || output != NULL );
+    CCM_VALIDATE_RET( tag_len == 0 || tag != NULL );
+
+    if( ( ret = ccm_check_params( length, iv_len, add_len, tag_len ) ) != 0 )
+        return( ret );
+
+    aes = ccm_hpm_sdp_aes_ctx( ctx, tag_len );
+    if( aes == NULL )
+    {
+        if( ( ret = ccm_auth_crypt_sw( ctx, CCM_DECRYPT, length, iv, iv_len,
+                                       add, add_len, input, output, check_tag, tag_len ) ) != 0 )
+            return( ret );
+
+        /* Check tag in "constant-time" */
+        for( diff = 0, i = 0; i < tag_len; i++ )
+            diff |= tag[i] ^ check_tag[i];
+
+        ret = ( diff != 0 ) ? MBEDTLS_ERR_CCM_AUTH_FAILED : 0;
+    }
+    else
+    {
+        if( ( ret = mbedtls_hpm_sdp_aes_begin( aes, &aes_ctx ) ) != 0 )
+            return( MBEDTLS_ERR_CCM_HW_ACCEL_FAILED );
+
+        if( length == 0 )
+        {
+            input = &empty;
+            output = &empty;
+        }
+        /* the driver compares the tag in constant time */
+        status = sdp_aes_ccm_decrypt_verify( HPM_SDP, aes_ctx, length, iv, iv_len,
+                                             add, add_len, input, output, tag, tag_len );
+        if( status == status_sdp_error_invalid_mac )
+            ret = MBEDTLS_ERR_CCM_AUTH_FAILED;
+        else if( status != status_success )
+            ret = MBEDTLS_ERR_CCM_HW_ACCEL_FAILED;
+
+        ret = mbedtls_hpm_sdp_aes_end( ret );
+    }
+
+    if( ret == MBEDTLS_ERR_CCM_AUTH_FAILED )
+        mbedtls_platform_zeroize( output, length );
+
+    return( ret );
+}
+
+int mbedtls_ccm_auth_decrypt( mbedtls_ccm_context *ctx, size_t length,
+                      const unsigned char *iv, size_t iv_len,
+                      const unsigned char *add, size_t add_len,
+                      const unsigned char *input, unsigned char *output,
+                      const unsigned char *tag, size_t tag_len )
+{
+    CCM_VALIDATE_RET( ctx != NULL );
+    CCM_VALIDATE_RET( iv != NULL );
+    CCM_VALIDATE_RET( add_len == 0 || add != NULL );
+    CCM_VALIDATE_RET( length == 0 || input != NULL );
+    CCM_VALIDATE_RET( length == 0 || output != NULL );
+    CCM_VALIDATE_RET( tag_len == 0 || tag != NULL );
+
+    if( tag_len == 0 )
+        return( MBEDTLS_ERR_CCM_BAD_INPUT );
+
+    return( mbedtls_ccm_star_auth_decrypt( ctx, length, iv, iv_len, add,
+                add_len, input, output, tag, tag_len ) );
+}
+
+#endif /* MBEDTLS_CCM_C && MBEDTLS_CCM_CRYPT_ALT && !MBEDTLS_CCM_ALT */
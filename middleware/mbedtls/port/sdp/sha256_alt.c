@@ -74,7 +74,7 @@ void mbedtls_sha256_init(mbedtls_sha256_context *ctx)
     sdp_hash_ctx_t *p_sys_sdp_ctx = (sdp_hash_ctx_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)&s_hash_ctx);
     memset(ctx, 0, sizeof(mbedtls_sha256_context));
     hpm_sdp_api_init();
-    (void)rom_sdp_hash_init(p_sys_sdp_ctx, sdp_hash_alg_sha256);
+    (void)sdp_hash_init(HPM_SDP, p_sys_sdp_ctx, sdp_hash_alg_sha256);
 }
 
 void mbedtls_sha256_free(mbedtls_sha256_context *ctx)
@@ -115,7 +115,7 @@ int mbedtls_sha256_starts_ret(mbedtls_sha256_context *ctx, int is224)
     else
     {
         sdp_hash_ctx_t *p_sys_sdp_ctx = (sdp_hash_ctx_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)&s_hash_ctx);
-        ret = rom_sdp_hash_init(p_sys_sdp_ctx, sdp_hash_alg_sha256);
+        ret = sdp_hash_init(HPM_SDP, p_sys_sdp_ctx, sdp_hash_alg_sha256);
         if (ret != status_success)
         {
             return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
@@ -142,7 +142,7 @@ int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx, const unsigned
 
     sdp_hash_ctx_t *p_sys_sdp_ctx = (sdp_hash_ctx_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)&s_hash_ctx);
     memcpy(local, data, 64);
-    ret = rom_sdp_hash_update(p_sys_sdp_ctx, local, 64);
+    ret = sdp_hash_update(HPM_SDP, p_sys_sdp_ctx, local, 64);
     if (ret != status_success)
     {
         return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
@@ -152,11 +152,25 @@ int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx, const unsigned
 
 /*
  * SHA-256 process buffer
+ *
+ * The whole buffer is handed to the SDP streaming hash in one call, the SDP
+ * reads the full blocks in place and keeps the partial block in its context.
+ * Buffers it can not read in place are copied through a noncacheable buffer.
  */
+#ifndef HPM_SDP_SHA256_BOUNCE_SIZE
+#define HPM_SDP_SHA256_BOUNCE_SIZE (256U)
+#endif
+
+/* below this size copying is cheaper than the cache maintenance */
+#ifndef HPM_SDP_SHA256_IN_PLACE_MIN_SIZE
+#define HPM_SDP_SHA256_IN_PLACE_MIN_SIZE (256U)
+#endif
+
 int mbedtls_sha256_update_ret(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen)
 {
-    static uint8_t ATTR_PLACE_AT_NONCACHEABLE local[64];
-    hpm_stat_t ret = status_fail;
+    static uint8_t ATTR_PLACE_AT_NONCACHEABLE_WITH_ALIGNMENT(4) local[HPM_SDP_SHA256_BOUNCE_SIZE];
+    sdp_hash_ctx_t *p_sys_sdp_ctx = (sdp_hash_ctx_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)&s_hash_ctx);
+    hpm_stat_t ret = status_success;
     if (ctx->is224)
     {
 #ifdef MBEDTLS_HPM_SHA224_ALT_SW
@@ -166,31 +180,33 @@ int mbedtls_sha256_update_ret(mbedtls_sha256_context *ctx, const unsigned char *
 #endif
     }
 
-    for (uint32_t i = 0; i < ilen; i += 64)
+    if ((ilen >= HPM_SDP_SHA256_IN_PLACE_MIN_SIZE) && (((uint32_t)input & 3U) == 0U))
     {
-        size_t len = ilen - i > 64 ? 64 : ilen - i;
-        if (len < 64)
+        uint8_t *p_sys_input = (uint8_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)input);
+        if (l1c_dc_is_enabled())
         {
-            sdp_hash_ctx_t *p_sys_sdp_ctx = (sdp_hash_ctx_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)&s_hash_ctx);
-            memcpy(local, input + i, len);
-            ret = rom_sdp_hash_update(p_sys_sdp_ctx, local, len);
-            if (ret != status_success)
-            {
-                return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
-            }
-
-            return 0;
+            /* write back only, the buffer is not modified */
+            uint32_t aligned_start = HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)p_sys_input);
+            uint32_t aligned_end = HPM_L1C_CACHELINE_ALIGN_UP((uint32_t)p_sys_input + ilen);
+            l1c_dc_writeback(aligned_start, aligned_end - aligned_start);
         }
-        else
+        ret = sdp_hash_update(HPM_SDP, p_sys_sdp_ctx, p_sys_input, ilen);
+    }
+    else
+    {
+        uint8_t *p_sys_local = (uint8_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)local);
+        while ((ret == status_success) && (ilen > 0U))
         {
-            ret = mbedtls_internal_sha256_process(ctx, input + i);
-            if (ret != status_success)
-            {
-                return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
-            }
+            size_t len = MIN(ilen, sizeof(local));
+            /* the CPU fills the buffer through its own address, only the SDP uses the system address */
+            memcpy(local, input, len);
+            ret = sdp_hash_update(HPM_SDP, p_sys_sdp_ctx, p_sys_local, len);
+            input += len;
+            ilen -= len;
         }
     }
-    return 0;
+
+    return (ret == status_success) ? 0 : MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
 }
 
 /*
@@ -210,12 +226,12 @@ int mbedtls_sha256_finish_ret(mbedtls_sha256_context *ctx, unsigned char output[
     }
     sdp_hash_ctx_t *p_sys_sdp_ctx = (sdp_hash_ctx_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)&s_hash_ctx);
     uint8_t *pout = (uint8_t *)core_local_mem_to_sys_address(BOARD_RUNNING_CORE, (uint32_t)local);
-    ret = rom_sdp_hash_finish(p_sys_sdp_ctx, pout);
+    ret = sdp_hash_finish(HPM_SDP, p_sys_sdp_ctx, pout);
     if (ret != status_success)
     {
         return MBEDTLS_ERR_SHA256_HW_ACCEL_FAILED;
     }
-    memcpy(output, pout, 32);
+    memcpy(output, local, 32);
     return 0;
 }
 
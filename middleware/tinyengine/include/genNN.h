@@ -32,6 +32,7 @@ static float lr __attribute__((unused)) = 0.0008;   // To suppress warning
 static float blr __attribute__((unused)) = 0.0004;  // To suppress warning
 
 void setupBuffer();
+void setupProfile(void);
 void invoke(float* labels);
 void invoke_inf();
 void getResult(uint8_t* P, uint8_t* NP);
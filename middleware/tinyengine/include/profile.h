@@ -15,54 +15,201 @@
  *
  * Target ISA:  ARMv7E-M
  * -------------------------------------------------------------------- */
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Target ISA:  RISCV D45 / host
+ *
+ */
 
-#include "stm32f7xx_hal.h"
+#ifndef TINYENGINE_INCLUDE_PROFILE_H_
+#define TINYENGINE_INCLUDE_PROFILE_H_
+
+#include <stdint.h>
 #include <stdio.h>
-#include <string.h>
-static UART_HandleTypeDef UART;
-#define RUNS 1
-static int profile_i;
-static int start, end;
-static char buf[100];
-
-void printLog(const char *s) {
-	static int is_initialized = 0;
-	if (!is_initialized) {
-		UART.Instance = USART1;
-		UART.Init.BaudRate = 115200;
-		UART.Init.WordLength = UART_WORDLENGTH_8B;
-		UART.Init.StopBits = UART_STOPBITS_1;
-		UART.Init.Parity = UART_PARITY_NONE;
-		UART.Init.Mode = UART_MODE_TX_RX;
-		UART.Init.HwFlowCtl = UART_HWCONTROL_NONE;
-		UART.Init.OverSampling = UART_OVERSAMPLING_16;
-		UART.Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
-		UART.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
-		if (HAL_UART_Init(&UART) != HAL_OK) {
-			//Error handling
-		}
-		is_initialized = 1;
-	}
-	HAL_UART_Transmit(&UART, (uint8_t*) s, strlen(s), 10);
+
+/*
+ * Layer level profiler
+ *
+ * Usage:
+ *  - build with TINYENGINE_PROFILE=1 (CONFIG_TINYENGINE_PROFILE in CMake)
+ *  - call tinyengine_profile_init() once with the activation arena and the
+ *    scratch(sbuf) buffer used by the generated model
+ *  - wrap every layer call in the generated invoke() with
+ *    TINYENGINE_PROFILE_LAYER(layer_index, kernel_name, (kernel args))
+ *  - dump the trace with tinyengine_profile_dump()
+ *
+ * Without TINYENGINE_PROFILE the wrapper expands to the plain kernel call.
+ */
+
+#ifndef TINYENGINE_PROFILE_MAX_RECORDS
+#define TINYENGINE_PROFILE_MAX_RECORDS (128U)
+#endif
+
+/* fill pattern used for scratch and arena high-water detection */
+#ifndef TINYENGINE_PROFILE_FILL_PATTERN
+#define TINYENGINE_PROFILE_FILL_PATTERN (0xA5U)
+#endif
+
+#define TINYENGINE_PROFILE_TRACE_MAGIC   (0x46505445UL) /* "ETPF" little endian */
+#define TINYENGINE_PROFILE_TRACE_VERSION (1U)
+
+/*
+ * Kernels of int_forward_op and fp_requantize_op which can be profiled,
+ * the generated depthwise fpreq kernels are included as well.
+ */
+#define TINYENGINE_PROFILE_KERNEL_LIST(X) \
+	X(add) \
+	X(avg_pooling) \
+	X(concat_ch) \
+	X(convolve_1x1_s8) \
+	X(convolve_1x1_s8_SRAM) \
+	X(convolve_1x1_s8_ch8) \
+	X(convolve_1x1_s8_ch16) \
+	X(convolve_1x1_s8_ch24) \
+	X(convolve_1x1_s8_ch48) \
+	X(convolve_1x1_s8_kbuf) \
+	X(convolve_1x1_s8_oddch) \
+	X(convolve_1x1_s8_skip_pad) \
+	X(convolve_s8_kernel2x3_inputch3_stride2_pad1) \
+	X(convolve_s8_kernel3_inputch3_stride2_pad1) \
+	X(convolve_s8_kernel3_stride1_pad1) \
+	X(convolve_s8_kernel3x2_inputch3_stride2_pad1) \
+	X(convolve_u8_kernel3_stride1_pad1) \
+	X(convolve_u8_kernel3_inputch3_stride2_pad1) \
+	X(element_mult_nx1) \
+	X(fully_connected_fp) \
+	X(mat_mul_fp) \
+	X(max_pooling) \
+	X(patchpadding_convolve_s8_kernel3_inputch3_stride2) \
+	X(patchpadding_depthwise_kernel3x3_stride1_inplace_CHW) \
+	X(patchpadding_depthwise_kernel3x3_stride2_inplace_CHW) \
+	X(patchpadding_kbuf_convolve_s8_kernel3_inputch3_stride2) \
+	X(statble_softmax_inplace) \
+	X(upsample_byte) \
+	X(upsample_byte_bilinear) \
+	X(add_fpreq) \
+	X(add_fpreq_mask) \
+	X(add_fpreq_bitmask) \
+	X(convolve_1x1_s8_fpreq) \
+	X(convolve_1x1_s8_ch8_fpreq) \
+	X(convolve_1x1_s8_ch16_fpreq) \
+	X(convolve_1x1_s8_ch24_fpreq) \
+	X(convolve_1x1_s8_ch48_fpreq) \
+	X(convolve_1x1_s8_fpreq_mask) \
+	X(convolve_1x1_s8_fpreq_bitmask) \
+	X(convolve_1x1_s8_fpreq_mask_partialCH) \
+	X(convolve_1x1_s8_fpreq_bitmask_partialCH) \
+	X(convolve_s8_kernel3_inputch3_stride2_pad1_fpreq) \
+	X(depthwise_kernel3x3_stride1_inplace_CHW_fpreq) \
+	X(depthwise_kernel3x3_stride1_inplace_CHW_fpreq_mask) \
+	X(depthwise_kernel3x3_stride1_inplace_CHW_fpreq_bitmask) \
+	X(depthwise_kernel3x3_stride2_inplace_CHW_fpreq) \
+	X(depthwise_kernel3x3_stride2_inplace_CHW_fpreq_mask) \
+	X(depthwise_kernel3x3_stride2_inplace_CHW_fpreq_bitmask)
+
+#define TINYENGINE_PROFILE_ID(kernel) TINYENGINE_PROFILE_ID_##kernel
+#define TINYENGINE_PROFILE_ENUM_ENTRY(kernel) TINYENGINE_PROFILE_ID(kernel),
+
+typedef enum {
+	TINYENGINE_PROFILE_KERNEL_LIST(TINYENGINE_PROFILE_ENUM_ENTRY)
+	TINYENGINE_PROFILE_ID_MAX,
+} tinyengine_profile_kernel_id_t;
+
+/* cycle counter hook, returns a free running 64-bit counter */
+typedef uint64_t (*tinyengine_profile_counter_t)(void);
+
+/* trace sink, returns the number of bytes consumed */
+typedef uint32_t (*tinyengine_profile_write_t)(void *ctx, const void *data, uint32_t size);
+
+/* one record per layer invocation, 16 bytes, little endian */
+typedef struct __attribute__((packed)) {
+	uint16_t layer;
+	uint8_t kernel_id;
+	uint8_t reserved;
+	uint32_t cycles;
+	uint32_t scratch_bytes;     /* sbuf bytes touched by this layer */
+	uint32_t arena_peak_bytes;  /* activation arena high-water after this layer */
+} tinyengine_profile_record_t;
+
+/* trace header, followed by record_count records */
+typedef struct __attribute__((packed)) {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t record_size;
+	uint32_t record_count;
+	uint32_t dropped;
+	uint64_t counter_freq;
+	uint32_t arena_size;
+	uint32_t scratch_size;
+} tinyengine_profile_trace_header_t;
+
+/* per kernel aggregate */
+typedef struct {
+	uint32_t calls;
+	uint64_t total_cycles;
+	uint32_t max_cycles;
+	uint32_t max_scratch_bytes;
+} tinyengine_profile_kernel_stat_t;
+
+typedef struct {
+	void *arena;
+	uint32_t arena_size;
+	void *scratch;
+	uint32_t scratch_size;
+	tinyengine_profile_counter_t counter;   /* NULL: default counter */
+	uint64_t counter_freq;                  /* counter ticks per second, 0: default */
+} tinyengine_profile_config_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* mcycle on RISC-V, CLOCK_MONOTONIC in ns on host */
+uint64_t tinyengine_profile_default_counter(void);
+
+void tinyengine_profile_get_default_config(tinyengine_profile_config_t *config);
+void tinyengine_profile_init(const tinyengine_profile_config_t *config);
+/* clears timings, records and the scratch peak, the arena high-water lasts until the next init */
+void tinyengine_profile_reset(void);
+
+uint64_t tinyengine_profile_begin(void);
+void tinyengine_profile_end(uint16_t layer, tinyengine_profile_kernel_id_t kernel_id, uint64_t start);
+
+const char *tinyengine_profile_kernel_name(tinyengine_profile_kernel_id_t kernel_id);
+const tinyengine_profile_kernel_stat_t *tinyengine_profile_get_kernel_stat(tinyengine_profile_kernel_id_t kernel_id);
+uint32_t tinyengine_profile_get_records(const tinyengine_profile_record_t **records);
+uint32_t tinyengine_profile_get_arena_peak(void);
+uint32_t tinyengine_profile_get_scratch_peak(void);
+
+/* binary trace: header followed by all records */
+uint32_t tinyengine_profile_dump(tinyengine_profile_write_t write, void *ctx);
+/* human readable per kernel summary through printf */
+void tinyengine_profile_print_summary(void);
+
+#ifdef __cplusplus
 }
+#endif
+
+#if defined(TINYENGINE_PROFILE) && TINYENGINE_PROFILE
+#define TINYENGINE_PROFILE_LAYER(layer, kernel, args) \
+	do { \
+		uint64_t __te_prof_start = tinyengine_profile_begin(); \
+		kernel args; \
+		tinyengine_profile_end((layer), TINYENGINE_PROFILE_ID(kernel), __te_prof_start); \
+	} while (0)
+#else
+#define TINYENGINE_PROFILE_LAYER(layer, kernel, args) \
+	do { \
+		(void) (layer); \
+		kernel args; \
+	} while (0)
+#endif
 
-void recieveChar(char *s) {
-	static int is_initialized = 0;
-	if (!is_initialized) {
-		UART.Instance = USART1;
-		UART.Init.BaudRate = 115200;
-		UART.Init.WordLength = UART_WORDLENGTH_8B;
-		UART.Init.StopBits = UART_STOPBITS_1;
-		UART.Init.Parity = UART_PARITY_NONE;
-		UART.Init.Mode = UART_MODE_TX_RX;
-		UART.Init.HwFlowCtl = UART_HWCONTROL_NONE;
-		UART.Init.OverSampling = UART_OVERSAMPLING_16;
-		UART.Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
-		UART.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
-		if (HAL_UART_Init(&UART) != HAL_OK) {
-			//Error handling
-		}
-		is_initialized = 1;
-	}
-	HAL_UART_Receive(&UART, (uint8_t*) s, 1, 10);
+static inline void printLog(const char *s)
+{
+	printf("%s", s);
 }
+
+#endif /* TINYENGINE_INCLUDE_PROFILE_H_ */
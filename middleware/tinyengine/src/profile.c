@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Target ISA:  RISCV D45 / host
+ *
+ */
+
+#include <string.h>
+#include "profile.h"
+
+#if defined(TINYENGINE_PROFILE) && TINYENGINE_PROFILE
+
+#if defined(__riscv)
+#include "hpm_csr_drv.h"
+#include "hpm_clock_drv.h"
+#else
+#include <time.h>
+#endif
+
+#define TINYENGINE_PROFILE_NAME_ENTRY(kernel) #kernel,
+
+static const char *const s_kernel_names[TINYENGINE_PROFILE_ID_MAX] = {
+	TINYENGINE_PROFILE_KERNEL_LIST(TINYENGINE_PROFILE_NAME_ENTRY)
+};
+
+static struct {
+	tinyengine_profile_config_t config;
+	tinyengine_profile_record_t records[TINYENGINE_PROFILE_MAX_RECORDS];
+	tinyengine_profile_kernel_stat_t stats[TINYENGINE_PROFILE_ID_MAX];
+	uint32_t record_count;
+	uint32_t dropped;
+	uint32_t arena_peak;
+	uint32_t scratch_peak;
+} s_profile;
+
+uint64_t tinyengine_profile_default_counter(void)
+{
+#if defined(__riscv)
+	return hpm_csr_get_core_mcycle();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+#endif
+}
+
+static uint64_t tinyengine_profile_default_counter_freq(void)
+{
+#if defined(__riscv)
+	return clock_get_frequency(clock_cpu0);
+#else
+	return 1000000000ULL;
+#endif
+}
+
+/* number of bytes from the start of buf up to the last byte not holding the fill pattern */
+static uint32_t tinyengine_profile_used_bytes(const uint8_t *buf, uint32_t size)
+{
+	while (size > 0U) {
+		if (buf[size - 1U] != TINYENGINE_PROFILE_FILL_PATTERN) {
+			break;
+		}
+		size--;
+	}
+	return size;
+}
+
+void tinyengine_profile_get_default_config(tinyengine_profile_config_t *config)
+{
+	memset(config, 0, sizeof(*config));
+	config->counter = tinyengine_profile_default_counter;
+	config->counter_freq = tinyengine_profile_default_counter_freq();
+}
+
+void tinyengine_profile_init(const tinyengine_profile_config_t *config)
+{
+	s_profile.config = *config;
+	if (s_profile.config.counter == NULL) {
+		s_profile.config.counter = tinyengine_profile_default_counter;
+	}
+	if (s_profile.config.counter_freq == 0U) {
+		s_profile.config.counter_freq = tinyengine_profile_default_counter_freq();
+	}
+	/*
+	 * the arena is painted only once, so call this before the input tensor is
+	 * written, the high-water found later covers the input as well
+	 */
+	if ((s_profile.config.arena != NULL) && (s_profile.config.arena_size > 0U)) {
+		memset(s_profile.config.arena, TINYENGINE_PROFILE_FILL_PATTERN, s_profile.config.arena_size);
+	}
+	s_profile.arena_peak = 0;
+	tinyengine_profile_reset();
+}
+
+void tinyengine_profile_reset(void)
+{
+	memset(s_profile.records, 0, sizeof(s_profile.records));
+	memset(s_profile.stats, 0, sizeof(s_profile.stats));
+	s_profile.record_count = 0;
+	s_profile.dropped = 0;
+	/* the arena is not repainted, its peak stays valid */
+	s_profile.scratch_peak = 0;
+}
+
+uint64_t tinyengine_profile_begin(void)
+{
+	/* paint outside of the measured window */
+	if ((s_profile.config.scratch != NULL) && (s_profile.config.scratch_size > 0U)) {
+		memset(s_profile.config.scratch, TINYENGINE_PROFILE_FILL_PATTERN, s_profile.config.scratch_size);
+	}
+	return s_profile.config.counter();
+}
+
+void tinyengine_profile_end(uint16_t layer, tinyengine_profile_kernel_id_t kernel_id, uint64_t start)
+{
+	uint64_t delta = s_profile.config.counter() - start;
+	uint32_t cycles = (delta > UINT32_MAX) ? UINT32_MAX : (uint32_t) delta;
+	uint32_t scratch_bytes = 0;
+	tinyengine_profile_kernel_stat_t *stat;
+	tinyengine_profile_record_t *record;
+
+	if (s_profile.config.scratch != NULL) {
+		scratch_bytes = tinyengine_profile_used_bytes((const uint8_t *) s_profile.config.scratch,
+						s_profile.config.scratch_size);
+	}
+	if (s_profile.config.arena != NULL) {
+		/* only the tail above the current peak has to be scanned */
+		const uint8_t *arena = (const uint8_t *) s_profile.config.arena;
+		uint32_t used = tinyengine_profile_used_bytes(&arena[s_profile.arena_peak],
+						s_profile.config.arena_size - s_profile.arena_peak);
+		s_profile.arena_peak += used;
+	}
+	if (scratch_bytes > s_profile.scratch_peak) {
+		s_profile.scratch_peak = scratch_bytes;
+	}
+
+	if ((uint32_t) kernel_id < (uint32_t) TINYENGINE_PROFILE_ID_MAX) {
+		stat = &s_profile.stats[kernel_id];
+		stat->calls++;
+		stat->total_cycles += cycles;
+		if (cycles > stat->max_cycles) {
+			stat->max_cycles = cycles;
+		}
+		if (scratch_bytes > stat->max_scratch_bytes) {
+			stat->max_scratch_bytes = scratch_bytes;
+		}
+	}
+
+	if (s_profile.record_count >= TINYENGINE_PROFILE_MAX_RECORDS) {
+		s_profile.dropped++;
+		return;
+	}
+	record = &s_profile.records[s_profile.record_count++];
+	record->layer = layer;
+	record->kernel_id = (uint8_t) kernel_id;
+	record->reserved = 0;
+	record->cycles = cycles;
+	record->scratch_bytes = scratch_bytes;
+	record->arena_peak_bytes = s_profile.arena_peak;
+}
+
+const char *tinyengine_profile_kernel_name(tinyengine_profile_kernel_id_t kernel_id)
+{
+	if ((uint32_t) kernel_id >= (uint32_t) TINYENGINE_PROFILE_ID_MAX) {
+		return "unknown";
+	}
+	return s_kernel_names[kernel_id];
+}
+
+const tinyengine_profile_kernel_stat_t *tinyengine_profile_get_kernel_stat(tinyengine_profile_kernel_id_t kernel_id)
+{
+	if ((uint32_t) kernel_id >= (uint32_t) TINYENGINE_PROFILE_ID_MAX) {
+		return NULL;
+	}
+	return &s_profile.stats[kernel_id];
+}
+
+uint32_t tinyengine_profile_get_records(const tinyengine_profile_record_t **records)
+{
+	*records = s_profile.records;
+	return s_profile.record_count;
+}
+
+uint32_t tinyengine_profile_get_arena_peak(void)
+{
+	return s_profile.arena_peak;
+}
+
+uint32_t tinyengine_profile_get_scratch_peak(void)
+{
+	return s_profile.scratch_peak;
+}
+
+uint32_t tinyengine_profile_dump(tinyengine_profile_write_t write, void *ctx)
+{
+	tinyengine_profile_trace_header_t header;
+	uint32_t written;
+
+	header.magic = TINYENGINE_PROFILE_TRACE_MAGIC;
+	header.version = TINYENGINE_PROFILE_TRACE_VERSION;
+	header.record_size = sizeof(tinyengine_profile_record_t);
+	header.record_count = s_profile.record_count;
+	header.dropped = s_profile.dropped;
+	header.counter_freq = s_profile.config.counter_freq;
+	header.arena_size = s_profile.config.arena_size;
+	header.scratch_size = s_profile.config.scratch_size;
+
+	written = write(ctx, &header, sizeof(header));
+	if (written != sizeof(header)) {
+		return written;
+	}
+	written += write(ctx, s_profile.records, s_profile.record_count * sizeof(tinyengine_profile_record_t));
+	return written;
+}
+
+void tinyengine_profile_print_summary(void)
+{
+	uint64_t total = 0;
+	uint32_t i;
+
+	for (i = 0; i < (uint32_t) TINYENGINE_PROFILE_ID_MAX; i++) {
+		total += s_profile.stats[i].total_cycles;
+	}
+	printf("%-56s %6s %12s %10s %6s %8s\n", "kernel", "calls", "cycles", "max", "%", "scratch");
+	for (i = 0; i < (uint32_t) TINYENGINE_PROFILE_ID_MAX; i++) {
+		const tinyengine_profile_kernel_stat_t *stat = &s_profile.stats[i];
+		if (stat->calls == 0U) {
+			continue;
+		}
+		printf("%-56s %6u %12llu %10u %6.2f %8u\n", s_kernel_names[i], (unsigned int) stat->calls,
+				(unsigned long long) stat->total_cycles, (unsigned int) stat->max_cycles,
+				(total > 0U) ? (double) stat->total_cycles * 100.0 / (double) total : 0.0,
+				(unsigned int) stat->max_scratch_bytes);
+	}
+	printf("total cycles: %llu, arena peak: %u/%u bytes, scratch peak: %u/%u bytes, dropped records: %u\n",
+			(unsigned long long) total, (unsigned int) s_profile.arena_peak, (unsigned int) s_profile.config.arena_size,
+			(unsigned int) s_profile.scratch_peak, (unsigned int) s_profile.config.scratch_size,
+			(unsigned int) s_profile.dropped);
+}
+
+#endif /* TINYENGINE_PROFILE */
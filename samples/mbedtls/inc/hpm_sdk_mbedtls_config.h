@@ -45,8 +45,14 @@
 #define MBEDTLS_AES_ENCRYPT_ALT
 #define MBEDTLS_AES_DECRYPT_ALT
 #define MBEDTLS_AES_CRYPT_CBC_ALT
+#define MBEDTLS_AES_CRYPT_CTR_ALT
 #define MBEDTLS_AES192_ALT_SW
 
+/******************************************************************************/
+/*************************** CCM **********************************************/
+/******************************************************************************/
+#define MBEDTLS_CCM_CRYPT_ALT
+
 /******************************************************************************/
 /*************************** SHA1 *********************************************/
 /******************************************************************************/
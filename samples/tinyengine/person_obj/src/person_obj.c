@@ -15,6 +15,7 @@
 #include "hpm_pdma_drv.h"
 #include "genNN.h"
 #include "detectionUtility.h"
+#include "profile.h"
 
 #define IMAGE_PUT_RGB565_PIXEL(image, x, y, v) \
 ({ \
@@ -263,6 +264,10 @@ int main(void)
         }
     }
 
+#if defined(TINYENGINE_PROFILE) && TINYENGINE_PROFILE
+    setupProfile();
+#endif
+
     while (1) {
         start_time();
         camera_img_resize(160, 128, buffer_cam, img_ai);
@@ -270,8 +275,14 @@ int main(void)
         for (int x = 0; x < (IMAGE_HEIGHT * IMAGE_WIDTH); x++) {
             buffer_inf[x] = buffer_cam[x];
         }
+#if defined(TINYENGINE_PROFILE) && TINYENGINE_PROFILE
+        tinyengine_profile_reset();
+#endif
         invoke(NULL);
         run_times = get_end_time();
+#if defined(TINYENGINE_PROFILE) && TINYENGINE_PROFILE
+        tinyengine_profile_print_summary();
+#endif
         det_post_procesing(cnt, boxes, 0.15);
         printf("Get: class 0: %d\n", cnt[0]);
         image_draw_square(cnt[0], boxes[0]);
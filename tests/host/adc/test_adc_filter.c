@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_adc_filter.h"
+
+/*
+ * ADC decimation stages against direct references. The CIC output of order N
+ * and ratio R is the convolution with N boxcars of R taps, every R-th sample,
+ * divided by R^N: power of two ratios must match it bit exact, other ratios
+ * within one LSB, and a DC input must come out at its own level for every
+ * order and ratio the init accepts. The average and the FIR are checked
+ * against sums and a Q15 convolution. Inputs are fed in uneven pieces and in
+ * place to cover the state carried between calls, a long full scale run
+ * covers the integrator wrap. Also reports ns per input sample on the host
+ * and what it is in channels * ksps per percent of a CPU.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_SAMPLES       (8192U)
+#define TEST_BENCH_SAMPLES (1U << 20)
+#define TEST_INPUT_BITS    (12U)
+#define TEST_MAX_TAPS      (HPM_ADC_CIC_MAX_ORDER * 256U)
+#define TEST_FIR_TAPS      (32U)
+
+static int32_t s_in[TEST_BENCH_SAMPLES];
+static int32_t s_out[TEST_BENCH_SAMPLES];
+static int32_t s_piece_out[TEST_SAMPLES];
+static int64_t s_taps[TEST_MAX_TAPS];
+static int64_t s_tmp[TEST_MAX_TAPS];
+static int16_t s_coef[TEST_FIR_TAPS];
+static int32_t s_history[2U * TEST_FIR_TAPS];
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/* signed samples of TEST_INPUT_BITS bits */
+static void make_input(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        s_in[i] = (int32_t)(rnd() % (1U << TEST_INPUT_BITS)) - (1 << (TEST_INPUT_BITS - 1U));
+    }
+}
+
+/* impulse response of order boxcars of ratio taps, returns the length */
+static uint32_t make_taps(uint8_t order, uint16_t ratio)
+{
+    uint32_t len = 1;
+
+    s_taps[0] = 1;
+    for (uint8_t o = 0; o < order; o++) {
+        memset(s_tmp, 0, sizeof(s_tmp));
+        for (uint32_t i = 0; i < len; i++) {
+            for (uint32_t j = 0; j < ratio; j++) {
+                s_tmp[i + j] += s_taps[i];
+            }
+        }
+        len += ratio - 1U;
+        memcpy(s_taps, s_tmp, len * sizeof(int64_t));
+    }
+    return len;
+}
+
+/* floor division, the stages shift right */
+static int64_t floor_div(int64_t a, int64_t b)
+{
+    return (a >= 0) ? (a / b) : -((-a + b - 1) / b);
+}
+
+/* whole block, then uneven pieces in place, both must give the same outputs */
+static uint32_t cic_run(hpm_adc_cic_t *f, uint8_t order, uint16_t ratio, uint32_t count)
+{
+    uint32_t n;
+    uint32_t m = 0;
+    uint32_t piece;
+
+    (void)hpm_adc_cic_init(f, order, ratio, TEST_INPUT_BITS);
+    n = hpm_adc_cic_process(f, s_in, count, s_out);
+    (void)hpm_adc_cic_init(f, order, ratio, TEST_INPUT_BITS);
+    for (uint32_t i = 0; i < count; i += piece) {
+        piece = 1U + rnd() % (3U * ratio);
+        piece = MIN(piece, count - i);
+        memcpy(s_piece_out + m, &s_in[i], piece * sizeof(int32_t));
+        m += hpm_adc_cic_process(f, s_piece_out + m, piece, s_piece_out + m);
+    }
+    return ((m == n) && (memcmp(s_out, s_piece_out, n * sizeof(int32_t)) == 0)) ? n : 0U;
+}
+
+static int test_cic(void)
+{
+    static const uint16_t ratios[] = { 2, 3, 4, 5, 7, 8, 10, 12, 16, 25, 32, 50, 64, 100, 128, 250, 256 };
+    hpm_adc_cic_t f;
+    uint32_t configs = 0;
+    uint32_t inexact = 0;
+    uint32_t len;
+    uint32_t n;
+    int64_t gain;
+    int64_t acc;
+    int64_t expect;
+    int32_t dc;
+
+    CHECK(hpm_adc_cic_init(&f, 0, 16, TEST_INPUT_BITS) == status_invalid_argument);
+    CHECK(hpm_adc_cic_init(&f, HPM_ADC_CIC_MAX_ORDER + 1U, 16, TEST_INPUT_BITS) == status_invalid_argument);
+    CHECK(hpm_adc_cic_init(&f, 1, 1, TEST_INPUT_BITS) == status_invalid_argument);
+    /* 16 + 4 * 5 bits of integrator for ratio 17 */
+    CHECK(hpm_adc_cic_init(&f, 4, 17, 16) == status_invalid_argument);
+    CHECK(hpm_adc_cic_init(&f, 4, 16, 15) == status_success);
+
+    for (uint8_t order = 1; order <= HPM_ADC_CIC_MAX_ORDER; order++) {
+        for (uint32_t r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++) {
+            uint16_t ratio = ratios[r];
+            bool pow2 = (ratio & (ratio - 1U)) == 0U;
+
+            if (hpm_adc_cic_init(&f, order, ratio, TEST_INPUT_BITS) != status_success) {
+                continue;
+            }
+            configs++;
+            CHECK((f.gain == 0U) == pow2);
+            gain = 1;
+            for (uint8_t o = 0; o < order; o++) {
+                gain *= ratio;
+            }
+
+            /* DC at both ends of the range comes out at its level once the response has settled */
+            for (uint32_t d = 0; d < 2U; d++) {
+                dc = d ? (1 << (TEST_INPUT_BITS - 1U)) - 1 : -(1 << (TEST_INPUT_BITS - 1U));
+                for (uint32_t i = 0; i < (order + 2U) * ratio; i++) {
+                    s_in[i] = dc;
+                }
+                (void)hpm_adc_cic_init(&f, order, ratio, TEST_INPUT_BITS);
+                n = hpm_adc_cic_process(&f, s_in, (order + 2U) * ratio, s_out);
+                CHECK(n == order + 2U);
+                if ((s_out[n - 1U] != dc) && (s_out[n - 1U] != dc - 1)) {
+                    printf("order %u ratio %u: DC %d gives %d\n", order, ratio, dc, s_out[n - 1U]);
+                    return 1;
+                }
+            }
+
+            /* random input against the convolution, in pieces and in place */
+            len = make_taps(order, ratio);
+            make_input(TEST_SAMPLES);
+            n = cic_run(&f, order, ratio, TEST_SAMPLES);
+            CHECK(n == TEST_SAMPLES / ratio);
+            for (uint32_t k = 0; k < n; k++) {
+                uint32_t last = (k + 1U) * ratio - 1U;
+
+                acc = 0;
+                for (uint32_t j = 0; (j < len) && (j <= last); j++) {
+                    acc += s_taps[j] * s_in[last - j];
+                }
+                expect = floor_div(acc, gain);
+                if (s_out[k] != expect) {
+                    inexact++;
+                }
+                if ((pow2 && (s_out[k] != expect)) || (s_out[k] > expect) || (s_out[k] < expect - 1)) {
+                    printf("order %u ratio %u output %u: %d, expected %lld\n", order, ratio, k, s_out[k], (long long)expect);
+                    return 1;
+                }
+            }
+        }
+    }
+    CHECK(configs > 40U);
+
+    /* full scale for 2^24 samples: the integrators wrap many times */
+    CHECK(hpm_adc_cic_init(&f, 3, 1000, 1) == status_success);
+    for (uint32_t i = 0; i < TEST_BENCH_SAMPLES; i++) {
+        s_in[i] = 1;
+    }
+    for (uint32_t i = 0; i < 16U; i++) {
+        n = hpm_adc_cic_process(&f, s_in, TEST_BENCH_SAMPLES, s_out);
+        CHECK((n >= TEST_BENCH_SAMPLES / 1000U) && (s_out[n - 1U] >= 0) && (s_out[n - 1U] <= 1));
+    }
+    CHECK(hpm_adc_cic_init(&f, 3, 64, TEST_INPUT_BITS + 1U) == status_success);
+    for (uint32_t i = 0; i < TEST_BENCH_SAMPLES; i++) {
+        s_in[i] = (1 << TEST_INPUT_BITS) - 1;
+    }
+    for (uint32_t i = 0; i < 16U; i++) {
+        n = hpm_adc_cic_process(&f, s_in, TEST_BENCH_SAMPLES, s_out);
+        CHECK((n == TEST_BENCH_SAMPLES / 64U) && (s_out[n - 1U] == (1 << TEST_INPUT_BITS) - 1));
+    }
+    printf("cic order 1 - %u, %u configurations: DC gain 1, power of two ratios bit exact, "
+           "%u outputs of other ratios one LSB low\n", HPM_ADC_CIC_MAX_ORDER, configs, inexact);
+    return 0;
+}
+
+static int test_avg(void)
+{
+    hpm_adc_avg_t f;
+    uint32_t n;
+    int64_t sum;
+
+    CHECK(hpm_adc_avg_init(&f, 0, 0) == status_invalid_argument);
+    CHECK(hpm_adc_avg_init(&f, 40000, 0) == status_invalid_argument);
+    make_input(TEST_SAMPLES);
+    for (uint16_t ratio = 1; ratio <= 64U; ratio++) {
+        for (uint8_t shift = 0; shift <= 6U; shift += 3U) {
+            CHECK(hpm_adc_avg_init(&f, ratio, shift) == status_success);
+            n = 0;
+            for (uint32_t i = 0, piece; i < TEST_SAMPLES; i += piece) {
+                piece = 1U + rnd() % 100U;
+                piece = MIN(piece, TEST_SAMPLES - i);
+                n += hpm_adc_avg_process(&f, &s_in[i], piece, &s_out[n]);
+            }
+            CHECK(n == TEST_SAMPLES / ratio);
+            for (uint32_t k = 0; k < n; k++) {
+                sum = 0;
+                for (uint32_t j = 0; j < ratio; j++) {
+                    sum += s_in[k * ratio + j];
+                }
+                CHECK(s_out[k] == (int32_t)(sum >> shift));
+            }
+        }
+    }
+    printf("avg ratio 1 - 64: outputs match the sums\n");
+    return 0;
+}
+
+static int test_fir(void)
+{
+    hpm_adc_fir_t f;
+    uint32_t n;
+    int64_t acc;
+
+    CHECK(hpm_adc_fir_init(&f, NULL, TEST_FIR_TAPS, 1, s_history) == status_invalid_argument);
+    CHECK(hpm_adc_fir_init(&f, s_coef, TEST_FIR_TAPS, 0, s_history) == status_invalid_argument);
+    for (uint32_t k = 0; k < TEST_FIR_TAPS; k++) {
+        s_coef[k] = (int16_t)((int32_t)(rnd() % 65536U) - 32768);
+    }
+    make_input(TEST_SAMPLES);
+    for (uint16_t ratio = 1; ratio <= 4U; ratio++) {
+        for (uint16_t taps = 1; taps <= TEST_FIR_TAPS; taps += 7U) {
+            CHECK(hpm_adc_fir_init(&f, s_coef, taps, ratio, s_history) == status_success);
+            memcpy(s_piece_out, s_in, TEST_SAMPLES * sizeof(int32_t));
+            n = 0;
+            for (uint32_t i = 0, piece; i < TEST_SAMPLES; i += piece) {
+                piece = 1U + rnd() % 50U;
+                piece = MIN(piece, TEST_SAMPLES - i);
+                n += hpm_adc_fir_process(&f, &s_piece_out[i], piece, &s_piece_out[n]);
+            }
+            CHECK(n == TEST_SAMPLES / ratio);
+            for (uint32_t k = 0; k < n; k++) {
+                uint32_t last = (k + 1U) * ratio - 1U;
+
+                acc = 0;
+                for (uint32_t j = 0; (j < taps) && (j <= last); j++) {
+                    acc += (int64_t)s_coef[j] * s_in[last - j];
+                }
+                CHECK(s_piece_out[k] == (int32_t)((acc + (1 << 14)) >> 15));
+            }
+        }
+    }
+    printf("fir 1 - %u taps, ratio 1 - 4: outputs match the Q15 convolution, in place\n", TEST_FIR_TAPS);
+    return 0;
+}
+
+/* ns per input sample of a chain, avg and fir ratio 0 are skipped like hpm_adc_stream does */
+static double bench(hpm_adc_avg_t *avg, hpm_adc_cic_t *cic, hpm_adc_fir_t *fir)
+{
+    const uint32_t block = 1024U;
+    uint64_t start;
+    uint32_t count;
+
+    make_input(TEST_BENCH_SAMPLES);
+    start = now_ns();
+    for (uint32_t i = 0; i < TEST_BENCH_SAMPLES; i += block) {
+        count = block;
+        if (avg != NULL) {
+            count = hpm_adc_avg_process(avg, &s_in[i], count, &s_in[i]);
+        }
+        if (cic != NULL) {
+            count = hpm_adc_cic_process(cic, &s_in[i], count, &s_in[i]);
+        }
+        if (fir != NULL) {
+            count = hpm_adc_fir_process(fir, &s_in[i], count, &s_in[i]);
+        }
+        s_out[i / block] = count;
+    }
+    return (double)(now_ns() - start) / TEST_BENCH_SAMPLES;
+}
+
+static void report(const char *name, double ns)
+{
+    /* one channel at k ksps takes k * ns / 10^4 percent of a CPU */
+    printf("%-38s %6.2f ns/sample, %8.0f channels * ksps per CPU %%\n", name, ns, 1e4 / ns);
+}
+
+int main(void)
+{
+    hpm_adc_avg_t avg;
+    hpm_adc_cic_t cic;
+    hpm_adc_fir_t fir;
+
+    if ((test_avg() != 0) || (test_cic() != 0) || (test_fir() != 0)) {
+        return 1;
+    }
+
+    (void)hpm_adc_cic_init(&cic, 3, 16, TEST_INPUT_BITS);
+    report("cic order 3 ratio 16", bench(NULL, &cic, NULL));
+    (void)hpm_adc_cic_init(&cic, 3, 10, TEST_INPUT_BITS);
+    report("cic order 3 ratio 10", bench(NULL, &cic, NULL));
+    (void)hpm_adc_avg_init(&avg, 4, 0);
+    (void)hpm_adc_cic_init(&cic, 3, 10, TEST_INPUT_BITS + 2U);
+    (void)hpm_adc_fir_init(&fir, s_coef, TEST_FIR_TAPS, 2, s_history);
+    report("avg 4, cic order 3 ratio 10, fir 32/2", bench(&avg, &cic, &fir));
+    return 0;
+}
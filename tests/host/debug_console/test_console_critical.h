@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef TEST_CONSOLE_CRITICAL_H
+#define TEST_CONSOLE_CRITICAL_H
+
+#include <stdint.h>
+
+/*
+ * Forced into hpm_debug_console_buffered.c by the test target: the critical
+ * sections go through test_console_buffered.c, which keeps the simulated
+ * interrupt enable and times how long each one keeps interrupts off.
+ */
+uint32_t test_console_enter_critical(void);
+void test_console_exit_critical(uint32_t level);
+
+#define CONSOLE_BUFFERED_ENTER_CRITICAL()          test_console_enter_critical()
+#define CONSOLE_BUFFERED_EXIT_CRITICAL(level)      test_console_exit_critical(level)
+#define CONSOLE_BUFFERED_IRQ_WAS_ENABLED(level)    ((level) != 0U)
+
+#endif /* TEST_CONSOLE_CRITICAL_H */
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim_dma.h"
+
+/*
+ * DMA driver against sim/hpm_host_sim_dma.c: register accesses to start a
+ * copy, to check its status, a three segment scatter by linked descriptors
+ * against three separate starts, abort, and a handshake channel feeding a
+ * peripheral register block at the pace of its request.
+ */
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_SEGMENT_SIZE (64U)
+#define TEST_FIFO_WORDS   (32U)
+
+static hpm_host_sim_dma_t s_dma;
+static ATTR_ALIGN(8) uint8_t s_src[3 * TEST_SEGMENT_SIZE];
+static ATTR_ALIGN(8) uint8_t s_dst[3][TEST_SEGMENT_SIZE];
+static ATTR_ALIGN(8) dma_linked_descriptor_t s_desc[2];
+static uint32_t s_words[TEST_FIFO_WORDS];
+static uint32_t s_fifo[TEST_FIFO_WORDS];
+static uint32_t s_fifo_level;
+static uint32_t s_requests;
+
+/* peripheral with a TX register at offset 0 */
+static void fifo_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                      hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    (void)block;
+    (void)old;
+    if ((access == hpm_host_sim_write) && (offset == 0U) && (s_fifo_level < TEST_FIFO_WORDS)) {
+        s_fifo[s_fifo_level++] = *value;
+    }
+}
+
+/* the peripheral asks for a word every other check */
+static bool fifo_request(void *context)
+{
+    (void)context;
+    return (s_requests++ & 1U) == 0U;
+}
+
+static bool never_request(void *context)
+{
+    (void)context;
+    return false;
+}
+
+static uint32_t dma_writes(void)
+{
+    return s_dma.block->writes;
+}
+
+int main(void)
+{
+    DMA_Type *dma;
+    hpm_host_sim_block_t *block;
+    hpm_host_sim_block_t *fifo;
+    dma_channel_config_t config;
+    dma_handshake_config_t handshake;
+    uint32_t start_writes;
+    uint32_t separate_writes;
+    uint32_t runs;
+
+    CHECK(hpm_host_sim_dma_init(&s_dma));
+    dma = hpm_host_sim_dma_base(&s_dma);
+    block = s_dma.block;
+    for (uint32_t i = 0; i < sizeof(s_src); i++) {
+        s_src[i] = (uint8_t)(i * 7U + 1U);
+    }
+
+    /* memcpy: setup cost, the copy, the status check */
+    CHECK(dma_start_memcpy(dma, 0, (uint32_t)s_dst[0], (uint32_t)s_src, TEST_SEGMENT_SIZE, 16) == status_success);
+    printf("dma_start_memcpy: %u reads, %u writes\n", block->reads, block->writes);
+    CHECK(block->reads == 0U);
+    CHECK(block->writes == 6U);
+    CHECK(dma_check_transfer_status(dma, 0) == DMA_CHANNEL_STATUS_ONGOING);
+    CHECK(hpm_host_sim_dma_run(&s_dma, 0) == TEST_SEGMENT_SIZE / 4U);
+    CHECK(memcmp(s_dst[0], s_src, TEST_SEGMENT_SIZE) == 0);
+    hpm_host_sim_block_reset_stat(block);
+    CHECK(dma_check_transfer_status(dma, 0) == DMA_CHANNEL_STATUS_TC);
+    printf("dma_check_transfer_status at TC: %u reads, %u writes\n", block->reads, block->writes);
+    CHECK((block->reads == 1U) && (block->writes == 1U));
+    CHECK(!dma_channel_is_enable(dma, 0));
+
+    /* scatter to three buffers: one start with two linked descriptors */
+    memset(s_dst, 0, sizeof(s_dst));
+    dma_default_channel_config(dma, &config);
+    config.src_width = DMA_TRANSFER_WIDTH_WORD;
+    config.dst_width = DMA_TRANSFER_WIDTH_WORD;
+    config.size_in_byte = TEST_SEGMENT_SIZE;
+    for (uint32_t i = 0; i < 2U; i++) {
+        config.src_addr = (uint32_t)&s_src[(i + 1U) * TEST_SEGMENT_SIZE];
+        config.dst_addr = (uint32_t)s_dst[i + 1U];
+        config.linked_ptr = (i == 0U) ? (uint32_t)&s_desc[1] : 0U;
+        CHECK(dma_config_linked_descriptor(dma, &s_desc[i], 1, &config) == status_success);
+    }
+    config.src_addr = (uint32_t)s_src;
+    config.dst_addr = (uint32_t)s_dst[0];
+    config.linked_ptr = (uint32_t)&s_desc[0];
+    hpm_host_sim_block_reset_stat(block);
+    CHECK(dma_setup_channel(dma, 1, &config, true) == status_success);
+    CHECK(hpm_host_sim_dma_run(&s_dma, 0) == 3U * TEST_SEGMENT_SIZE / 4U);
+    CHECK(s_dma.descriptors == 2U);
+    CHECK(memcmp(s_dst, s_src, sizeof(s_src)) == 0);
+    CHECK(dma_check_transfer_status(dma, 1) == DMA_CHANNEL_STATUS_TC);
+    start_writes = dma_writes();
+
+    /* the same scatter as three separate starts, each waited for */
+    hpm_host_sim_block_reset_stat(block);
+    for (uint32_t i = 0; i < 3U; i++) {
+        CHECK(dma_start_memcpy(dma, 1, (uint32_t)s_dst[i], (uint32_t)&s_src[i * TEST_SEGMENT_SIZE], TEST_SEGMENT_SIZE, 16) == status_success);
+        hpm_host_sim_dma_run(&s_dma, 0);
+        CHECK(dma_check_transfer_status(dma, 1) == DMA_CHANNEL_STATUS_TC);
+    }
+    separate_writes = dma_writes();
+    printf("scatter of 3 segments: %u writes chained, %u writes started one by one\n",
+           start_writes, separate_writes);
+    CHECK(start_writes == 6U + 1U);
+    CHECK(separate_writes == 3U * (6U + 1U));
+
+    /* abort a channel that waits for its request */
+    hpm_host_sim_dma_set_request(&s_dma, 3, never_request, NULL);
+    dma_default_handshake_config(dma, &handshake);
+    handshake.ch_index = 3;
+    handshake.src = (uint32_t)s_words;
+    handshake.dst = (uint32_t)s_dst[0];
+    handshake.dst_fixed = true;
+    handshake.data_width = DMA_TRANSFER_WIDTH_WORD;
+    handshake.size_in_byte = sizeof(s_words);
+    CHECK(dma_setup_handshake(dma, &handshake, true) == status_success);
+    CHECK(hpm_host_sim_dma_run(&s_dma, 0) == 0U);
+    CHECK(dma_channel_is_enable(dma, 3));
+    dma_abort_channel(dma, 1UL << 3);
+    CHECK(!dma_channel_is_enable(dma, 3));
+    CHECK(dma_check_transfer_status(dma, 3) == DMA_CHANNEL_STATUS_ABORT);
+
+    /* handshake to a peripheral register: bus writes by the DMA, none by the CPU */
+    fifo = hpm_host_sim_block_create(4096, fifo_hook, NULL);
+    CHECK(fifo != NULL);
+    for (uint32_t i = 0; i < TEST_FIFO_WORDS; i++) {
+        s_words[i] = 0xA5000000UL | i;
+    }
+    hpm_host_sim_dma_set_request(&s_dma, 2, fifo_request, NULL);
+    handshake.ch_index = 2;
+    handshake.dst = (uint32_t)(uintptr_t)fifo->base;
+    CHECK(dma_setup_handshake(dma, &handshake, true) == status_success);
+    CHECK(!hpm_host_sim_dma_irq(&s_dma));
+    for (runs = 0; dma_channel_is_enable(dma, 2) && (runs < 4U * TEST_FIFO_WORDS); runs++) {
+        hpm_host_sim_dma_run(&s_dma, 0);
+    }
+    printf("handshake: %u words in %u request rounds, peripheral %u CPU writes, %u DMA writes\n",
+           s_fifo_level, runs, fifo->writes, fifo->bus_writes);
+    CHECK(s_fifo_level == TEST_FIFO_WORDS);
+    CHECK(memcmp(s_fifo, s_words, sizeof(s_words)) == 0);
+    CHECK(fifo->writes == 0U);
+    CHECK(fifo->bus_writes == TEST_FIFO_WORDS);
+    CHECK(runs == TEST_FIFO_WORDS);
+    CHECK(hpm_host_sim_dma_irq(&s_dma));
+    CHECK(dma_check_transfer_status(dma, 2) == DMA_CHANNEL_STATUS_TC);
+    CHECK(!hpm_host_sim_dma_irq(&s_dma));
+
+    hpm_host_sim_block_destroy(fifo);
+    hpm_host_sim_dma_deinit(&s_dma);
+    return 0;
+}
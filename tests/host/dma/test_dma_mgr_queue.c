@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim_dma.h"
+#include "hpm_dma_mgr.h"
+
+/*
+ * dma_mgr interrupt dispatch and transfer queue against the DMA model: the
+ * DMA controller, DMAMUX and PLIC are mapped at their HPM6750 addresses, the
+ * test moves the DMA one unit at a time and serves the interrupt whenever the
+ * model raises it, as the core would between any two bus cycles.
+ * Dispatch: pending TC status of one channel at every index, of several and
+ * of a masked one, the callbacks must run once each, lowest channel first,
+ * and the register accesses of the handler are reported against the scan of
+ * all channels it replaced.
+ * Queue: transfers of random size submitted behind a busy channel must
+ * complete once each, in submission order, with their data, as one chain of
+ * linked descriptors; a callback submitting its transfer again keeps the
+ * channel streaming. Abort and error complete the active chain with their
+ * status and the waiting transfers still run. Reports transfers per chain
+ * and interrupts per transfer.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_XFERS        (32U)
+#define TEST_XFER_MAX     (48U)
+#define TEST_STREAM_XFERS (1000U)
+#define TEST_STREAM_DEPTH (4U)
+
+static hpm_host_sim_dma_t s_dma;
+static hpm_host_sim_block_t *s_dmamux;
+static hpm_host_sim_block_t *s_plic;
+static dma_resource_t s_resource[DMA_SOC_CHANNEL_NUM];
+static dma_mgr_queue_t s_queue;
+static ATTR_ALIGN(8) dma_mgr_xfer_t s_xfer[TEST_XFERS];
+static uint8_t s_src[TEST_XFERS][TEST_XFER_MAX];
+static uint8_t s_dst[TEST_XFERS][TEST_XFER_MAX];
+static uint32_t s_seed = 1;
+
+static uint32_t s_called[DMA_SOC_CHANNEL_NUM * 2U];
+static uint32_t s_called_count;
+static uint32_t s_done[TEST_STREAM_XFERS];
+static hpm_stat_t s_done_status[TEST_STREAM_XFERS];
+static uint32_t s_done_count;
+static uint32_t s_early;
+static uint32_t s_resubmit;
+static uint32_t s_isr_count;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static void chn_tc_cb(DMA_Type *base, uint32_t channel, void *cb_data_ptr)
+{
+    (void)base;
+    (void)cb_data_ptr;
+    if (s_called_count < ARRAY_SIZE(s_called)) {
+        s_called[s_called_count++] = channel;
+    }
+}
+
+static void xfer_cb(const dma_resource_t *resource, dma_mgr_xfer_t *xfer, hpm_stat_t status)
+{
+    uint32_t i = (uint32_t)(xfer - s_xfer);
+
+    (void)resource;
+    /* the data has to be there when the transfer is reported */
+    if ((status == status_success) && (memcmp(s_dst[i], s_src[i], xfer->size_in_byte) != 0)) {
+        s_early++;
+    }
+    if (s_done_count < TEST_STREAM_XFERS) {
+        s_done[s_done_count] = i;
+        s_done_status[s_done_count] = status;
+        s_done_count++;
+    }
+    if (s_resubmit != 0U) {
+        s_resubmit--;
+        (void)dma_mgr_queue_submit(&s_queue, xfer);
+    }
+}
+
+/* move the DMA a unit at a time, the interrupt is taken as soon as the model raises it */
+static void pump(void)
+{
+    bool busy;
+
+    do {
+        busy = hpm_host_sim_dma_run(&s_dma, 1) != 0U;
+        if (hpm_host_sim_dma_irq(&s_dma)) {
+            dma_mgr_isr_handler(HPM_HDMA, 0);
+            s_isr_count++;
+            busy = true;
+        }
+    } while (busy);
+}
+
+static void set_tc_status(uint32_t channels)
+{
+    uint32_t status = 0;
+
+    for (uint8_t ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+        if ((channels & (1UL << ch)) != 0U) {
+            status |= DMA_CHANNEL_IRQ_STATUS_TC(ch);
+        }
+    }
+    hpm_host_sim_poke(s_dma.block, offsetof(DMA_Type, INTSTATUS), status);
+}
+
+static int test_dispatch(void)
+{
+    const uint32_t several = (1UL << 1) | (1UL << 4) | (1UL << (DMA_SOC_CHANNEL_NUM - 1U));
+    uint32_t one_reads;
+    uint32_t one_writes;
+    uint32_t all_accesses;
+
+    for (uint8_t ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+        CHECK(dma_mgr_install_chn_tc_callback(&s_resource[ch], chn_tc_cb, NULL) == status_success);
+        CHECK(dma_mgr_enable_chn_irq(&s_resource[ch], DMA_MGR_INTERRUPT_MASK_TC) == status_success);
+    }
+
+    /* one channel: the aggregated status once, the mask of that channel only */
+    for (uint8_t ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+        s_called_count = 0;
+        set_tc_status(1UL << ch);
+        hpm_host_sim_block_reset_stat(s_dma.block);
+        dma_mgr_isr_handler(HPM_HDMA, 0);
+        CHECK((s_called_count == 1U) && (s_called[0] == ch));
+        CHECK(hpm_host_sim_peek(s_dma.block, offsetof(DMA_Type, INTSTATUS)) == 0U);
+        if (ch == 0U) {
+            one_reads = s_dma.block->reads;
+            one_writes = s_dma.block->writes;
+        }
+        CHECK((s_dma.block->reads == one_reads) && (s_dma.block->writes == one_writes));
+    }
+    CHECK((one_reads == 2U) && (one_writes == 1U));
+
+    s_called_count = 0;
+    set_tc_status(several);
+    dma_mgr_isr_handler(HPM_HDMA, 0);
+    CHECK((s_called_count == 3U) && (s_called[0] == 1U) && (s_called[1] == 4U)
+          && (s_called[2] == DMA_SOC_CHANNEL_NUM - 1U));
+
+    /* a masked channel is acknowledged without its callback */
+    CHECK(dma_mgr_disable_chn_irq(&s_resource[4], DMA_MGR_INTERRUPT_MASK_TC) == status_success);
+    s_called_count = 0;
+    set_tc_status(several);
+    dma_mgr_isr_handler(HPM_HDMA, 0);
+    CHECK((s_called_count == 2U) && (s_called[0] == 1U) && (s_called[1] == DMA_SOC_CHANNEL_NUM - 1U));
+    CHECK(hpm_host_sim_peek(s_dma.block, offsetof(DMA_Type, INTSTATUS)) == 0U);
+    CHECK(dma_mgr_enable_chn_irq(&s_resource[4], DMA_MGR_INTERRUPT_MASK_TC) == status_success);
+
+    s_called_count = 0;
+    set_tc_status((1UL << DMA_SOC_CHANNEL_NUM) - 1U);
+    hpm_host_sim_block_reset_stat(s_dma.block);
+    dma_mgr_isr_handler(HPM_HDMA, 0);
+    all_accesses = s_dma.block->reads + s_dma.block->writes;
+    CHECK(s_called_count == DMA_SOC_CHANNEL_NUM);
+
+    for (uint8_t ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+        CHECK(dma_mgr_install_chn_tc_callback(&s_resource[ch], NULL, NULL) == status_success);
+        CHECK(dma_mgr_disable_chn_irq(&s_resource[ch], DMA_MGR_INTERRUPT_MASK_TC) == status_success);
+    }
+    /* the scan of every channel read its mask and status and cleared the status */
+    printf("dispatch: %u register accesses for one pending channel, %u for all %u, the scan took %u\n",
+           (unsigned int)(one_reads + one_writes), (unsigned int)all_accesses,
+           (unsigned int)DMA_SOC_CHANNEL_NUM, (unsigned int)(3U * DMA_SOC_CHANNEL_NUM));
+    return 0;
+}
+
+static void prepare(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        memset(&s_xfer[i], 0, sizeof(s_xfer[i]));
+        s_xfer[i].src_addr = core_local_mem_to_sys_address(HPM_CORE0, (uint32_t)s_src[i]);
+        s_xfer[i].dst_addr = core_local_mem_to_sys_address(HPM_CORE0, (uint32_t)s_dst[i]);
+        s_xfer[i].size_in_byte = 1U + (rnd() % TEST_XFER_MAX);
+        s_xfer[i].callback = xfer_cb;
+        for (uint32_t j = 0; j < TEST_XFER_MAX; j++) {
+            s_src[i][j] = (uint8_t)rnd();
+        }
+    }
+    memset(s_dst, 0, sizeof(s_dst));
+    s_done_count = 0;
+}
+
+static int check_data(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK(memcmp(s_dst[i], s_src[i], s_xfer[i].size_in_byte) == 0);
+        CHECK((s_xfer[i].size_in_byte == TEST_XFER_MAX) || (s_dst[i][s_xfer[i].size_in_byte] == 0U));
+    }
+    return 0;
+}
+
+static int test_queue_order(void)
+{
+    uint32_t descriptors;
+
+    prepare(TEST_XFERS);
+    s_queue.chains = 0;
+    descriptors = s_dma.descriptors;
+    s_isr_count = 0;
+    for (uint32_t i = 0; i < TEST_XFERS; i++) {
+        CHECK(dma_mgr_queue_submit(&s_queue, &s_xfer[i]) == status_success);
+    }
+    CHECK(!dma_mgr_queue_is_idle(&s_queue));
+    pump();
+    CHECK(dma_mgr_queue_is_idle(&s_queue));
+    CHECK((s_done_count == TEST_XFERS) && (s_early == 0U));
+    for (uint32_t i = 0; i < TEST_XFERS; i++) {
+        CHECK((s_done[i] == i) && (s_done_status[i] == status_success));
+    }
+    CHECK(check_data(TEST_XFERS) == 0);
+    /* the first one started alone, the others waited for it as one chain */
+    CHECK(s_queue.chains == 2U);
+    CHECK(s_dma.descriptors - descriptors == TEST_XFERS - 2U);
+    /* the last descriptor of a chain may unmask the TC status the others left, one early interrupt */
+    CHECK(s_isr_count <= 2U * s_queue.chains);
+    printf("queue: %u transfers submitted at once, %u chains, %u interrupts\n",
+           (unsigned int)TEST_XFERS, (unsigned int)s_queue.chains, (unsigned int)s_isr_count);
+    return 0;
+}
+
+static int test_queue_stream(void)
+{
+    uint32_t chains = s_queue.chains;
+
+    prepare(TEST_STREAM_DEPTH);
+    s_isr_count = 0;
+    s_resubmit = TEST_STREAM_XFERS - TEST_STREAM_DEPTH;
+    for (uint32_t i = 0; i < TEST_STREAM_DEPTH; i++) {
+        CHECK(dma_mgr_queue_submit(&s_queue, &s_xfer[i]) == status_success);
+    }
+    pump();
+    CHECK(dma_mgr_queue_is_idle(&s_queue) && (s_resubmit == 0U));
+    CHECK((s_done_count == TEST_STREAM_XFERS) && (s_early == 0U));
+    for (uint32_t i = 0; i < TEST_STREAM_XFERS; i++) {
+        CHECK((s_done[i] == (i % TEST_STREAM_DEPTH)) && (s_done_status[i] == status_success));
+    }
+    CHECK(check_data(TEST_STREAM_DEPTH) == 0);
+    chains = s_queue.chains - chains;
+    printf("stream: %u transfers kept %u deep by the callbacks, %.2f transfers per chain, "
+           "%.2f interrupts per transfer\n",
+           (unsigned int)TEST_STREAM_XFERS, (unsigned int)TEST_STREAM_DEPTH, (double)TEST_STREAM_XFERS / chains,
+           (double)s_isr_count / TEST_STREAM_XFERS);
+    return 0;
+}
+
+/* the hardware stops the channel and reports a bus error */
+static void inject_error(void)
+{
+    uint32_t ch = s_queue.resource.channel;
+    uint32_t ctrl = offsetof(DMA_Type, CHCTRL) + ch * sizeof(((DMA_Type *)0)->CHCTRL[0]);
+
+    hpm_host_sim_poke(s_dma.block, ctrl, hpm_host_sim_peek(s_dma.block, ctrl) & ~DMA_CHCTRL_CTRL_ENABLE_MASK);
+    hpm_host_sim_poke(s_dma.block, offsetof(DMA_Type, CHEN), hpm_host_sim_peek(s_dma.block, offsetof(DMA_Type, CHEN)) & ~(1UL << ch));
+    hpm_host_sim_poke(s_dma.block, offsetof(DMA_Type, INTSTATUS), DMA_CHANNEL_IRQ_STATUS_ERROR(ch));
+}
+
+static int test_queue_abort_error(void)
+{
+    /* abort of a single transfer, the waiting ones follow as a chain */
+    prepare(3);
+    for (uint32_t i = 0; i < 3U; i++) {
+        CHECK(dma_mgr_queue_submit(&s_queue, &s_xfer[i]) == status_success);
+    }
+    CHECK(hpm_host_sim_dma_run(&s_dma, 1) == 1U);
+    CHECK(dma_mgr_abort_chn_transfer(&s_queue.resource) == status_success);
+    pump();
+    CHECK(dma_mgr_queue_is_idle(&s_queue) && (s_done_count == 3U));
+    CHECK((s_done[0] == 0U) && (s_done_status[0] == status_dma_mgr_xfer_abort));
+    CHECK((s_done[1] == 1U) && (s_done_status[1] == status_success));
+    CHECK((s_done[2] == 2U) && (s_done_status[2] == status_success));
+    CHECK((memcmp(s_dst[1], s_src[1], s_xfer[1].size_in_byte) == 0)
+          && (memcmp(s_dst[2], s_src[2], s_xfer[2].size_in_byte) == 0));
+
+    /* abort in the middle of a chain completes all of it */
+    prepare(4);
+    for (uint32_t i = 0; i < 4U; i++) {
+        CHECK(dma_mgr_queue_submit(&s_queue, &s_xfer[i]) == status_success);
+    }
+    while (s_done_count == 0U) {
+        (void)hpm_host_sim_dma_run(&s_dma, 1);
+        if (hpm_host_sim_dma_irq(&s_dma)) {
+            dma_mgr_isr_handler(HPM_HDMA, 0);
+        }
+    }
+    CHECK(hpm_host_sim_dma_run(&s_dma, s_xfer[1].size_in_byte + 1U) == s_xfer[1].size_in_byte + 1U);
+    CHECK(dma_mgr_abort_chn_transfer(&s_queue.resource) == status_success);
+    pump();
+    CHECK(dma_mgr_queue_is_idle(&s_queue) && (s_done_count == 4U));
+    for (uint32_t i = 1; i < 4U; i++) {
+        CHECK((s_done[i] == i) && (s_done_status[i] == status_dma_mgr_xfer_abort));
+    }
+    CHECK(memcmp(s_dst[1], s_src[1], s_xfer[1].size_in_byte) == 0);
+
+    /* error */
+    prepare(2);
+    for (uint32_t i = 0; i < 2U; i++) {
+        CHECK(dma_mgr_queue_submit(&s_queue, &s_xfer[i]) == status_success);
+    }
+    CHECK(hpm_host_sim_dma_run(&s_dma, 1) == 1U);
+    inject_error();
+    pump();
+    CHECK(dma_mgr_queue_is_idle(&s_queue) && (s_done_count == 2U));
+    CHECK((s_done[0] == 0U) && (s_done_status[0] == status_dma_mgr_xfer_error));
+    CHECK((s_done[1] == 1U) && (s_done_status[1] == status_success));
+    return 0;
+}
+
+int main(void)
+{
+    dma_mgr_chn_conf_t config;
+
+    CHECK(hpm_host_sim_dma_init_at(&s_dma, HPM_HDMA_BASE));
+    s_dmamux = hpm_host_sim_block_create_at(HPM_DMAMUX_BASE, sizeof(DMAMUX_Type), NULL, NULL);
+    s_plic = hpm_host_sim_block_create_at(HPM_PLIC_BASE, sizeof(PLIC_Type), NULL, NULL);
+    CHECK((s_dmamux != NULL) && (s_plic != NULL));
+
+    dma_mgr_init();
+    for (uint8_t ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+        CHECK(dma_mgr_request_resource(&s_resource[ch]) == status_success);
+        CHECK((s_resource[ch].base == HPM_HDMA) && (s_resource[ch].channel == ch));
+    }
+    if (test_dispatch() != 0) {
+        return 1;
+    }
+
+    dma_mgr_get_default_chn_config(&config);
+    CHECK(dma_mgr_queue_init(&s_resource[2], &s_queue, &config, HPM_CORE0) == status_success);
+    CHECK(dma_mgr_enable_dma_irq_with_priority(&s_resource[2], 1) == status_success);
+    CHECK(dma_mgr_queue_submit(&s_queue, NULL) == status_invalid_argument);
+    if ((test_queue_order() != 0) || (test_queue_stream() != 0) || (test_queue_abort_error() != 0)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim_enet.h"
+
+/*
+ * ENET driver against sim/hpm_host_sim_enet.c: register accesses of
+ * enet_controller_init(), per transmitted frame with one and with several TX
+ * descriptors, per received frame including the descriptor release and
+ * enet_rx_resume(), and the recovery when the RX descriptors ran out. The
+ * descriptors live in RAM, so per frame only the poll demand and status
+ * registers are touched.
+ */
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_TX_BUFF_COUNT (4U)
+#define TEST_TX_BUFF_SIZE  (512U)
+#define TEST_RX_BUFF_COUNT (4U)
+#define TEST_RX_BUFF_SIZE  (1536U)
+#define TEST_FRAMES        (16U)
+#define TEST_FRAME_SIZE    (1000U)
+
+static hpm_host_sim_enet_t s_enet;
+static ATTR_ALIGN(ENET_SOC_DESC_ADDR_ALIGNMENT) enet_tx_desc_t s_tx_desc[TEST_TX_BUFF_COUNT];
+static ATTR_ALIGN(ENET_SOC_DESC_ADDR_ALIGNMENT) enet_rx_desc_t s_rx_desc[TEST_RX_BUFF_COUNT];
+static ATTR_ALIGN(ENET_SOC_BUFF_ADDR_ALIGNMENT) uint8_t s_tx_buff[TEST_TX_BUFF_COUNT][TEST_TX_BUFF_SIZE];
+static ATTR_ALIGN(ENET_SOC_BUFF_ADDR_ALIGNMENT) uint8_t s_rx_buff[TEST_RX_BUFF_COUNT][TEST_RX_BUFF_SIZE];
+static enet_desc_t s_desc;
+static uint8_t s_frame[TEST_FRAME_SIZE];
+static uint8_t s_wire[TEST_FRAME_SIZE];
+static uint32_t s_wire_length;
+static uint32_t s_wire_frames;
+
+static void enet_wire(void *context, const uint8_t *frame, uint32_t length)
+{
+    (void)context;
+    s_wire_length = MIN(length, (uint32_t)sizeof(s_wire));
+    memcpy(s_wire, frame, s_wire_length);
+    s_wire_frames++;
+}
+
+static void make_frame(uint32_t n, uint32_t length)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        s_frame[i] = (uint8_t)(n * 31U + i);
+    }
+}
+
+/* copy the frame into the buffers of the descriptors it will take, then hand them to the DMA */
+static hpm_stat_t send_frame(ENET_Type *enet, uint32_t length)
+{
+    enet_tx_desc_t *desc = s_desc.tx_desc_list_cur;
+    uint32_t done = 0;
+    uint32_t chunk;
+
+    while (done < length) {
+        if (desc->tdes0_bm.own != 0U) {
+            return status_fail;
+        }
+        chunk = MIN(length - done, TEST_TX_BUFF_SIZE);
+        memcpy((void *)(uintptr_t)desc->tdes2_bm.buffer1, &s_frame[done], chunk);
+        done += chunk;
+        desc = (enet_tx_desc_t *)(uintptr_t)desc->tdes3_bm.next_desc;
+    }
+    return (enet_prepare_transmission_descriptors(enet, &s_desc.tx_desc_list_cur, (uint16_t)length, TEST_TX_BUFF_SIZE) == ENET_SUCCESS)
+        ? status_success : status_fail;
+}
+
+/* take a received frame and give its descriptors back, as the lwIP port does */
+static uint32_t receive_frame(ENET_Type *enet, uint8_t *data)
+{
+    enet_frame_t frame;
+    enet_rx_desc_t *desc;
+
+    frame = enet_get_received_frame_interrupt(&s_desc.rx_desc_list_cur, &s_desc.rx_frame_info, TEST_RX_BUFF_COUNT);
+    if (frame.length == 0U) {
+        return 0;
+    }
+    memcpy(data, (const void *)(uintptr_t)frame.buffer, frame.length);
+    desc = frame.rx_desc;
+    for (uint32_t i = 0; i < s_desc.rx_frame_info.seg_count; i++) {
+        desc->rdes0_bm.own = 1;
+        desc = (enet_rx_desc_t *)(uintptr_t)desc->rdes3_bm.next_desc;
+    }
+    s_desc.rx_frame_info.seg_count = 0;
+    enet_rx_resume(enet);
+    return frame.length;
+}
+
+int main(void)
+{
+    ENET_Type *enet;
+    hpm_host_sim_block_t *block;
+    enet_mac_config_t mac_config;
+    enet_int_config_t int_config;
+    uint8_t data[TEST_FRAME_SIZE];
+    uint32_t dropped;
+
+    CHECK(hpm_host_sim_enet_init(&s_enet, enet_wire, NULL));
+    enet = hpm_host_sim_enet_base(&s_enet);
+    block = s_enet.block;
+
+    s_desc.tx_desc_list_head = s_tx_desc;
+    s_desc.rx_desc_list_head = s_rx_desc;
+    s_desc.tx_buff_cfg.buffer = (uint32_t)s_tx_buff;
+    s_desc.tx_buff_cfg.count = TEST_TX_BUFF_COUNT;
+    s_desc.tx_buff_cfg.size = TEST_TX_BUFF_SIZE;
+    s_desc.rx_buff_cfg.buffer = (uint32_t)s_rx_buff;
+    s_desc.rx_buff_cfg.count = TEST_RX_BUFF_COUNT;
+    s_desc.rx_buff_cfg.size = TEST_RX_BUFF_SIZE;
+    enet_get_default_tx_control_config(enet, &s_desc.tx_control_config);
+    memset(&mac_config, 0, sizeof(mac_config));
+    mac_config.mac_addr_high[0] = 0x0605;
+    mac_config.mac_addr_low[0] = 0x04030201;
+    mac_config.valid_max_count = 1;
+    mac_config.dma_pbl = enet_pbl_32;
+    mac_config.sarc = enet_sarc_replace_mac0;
+    memset(&int_config, 0, sizeof(int_config));
+    int_config.int_enable = enet_normal_int_sum_en | enet_receive_int_en;
+    int_config.mmc_intr_mask_rx = 0x03ffffff;
+    int_config.mmc_intr_mask_tx = 0x03ffffff;
+
+    CHECK(enet_controller_init(enet, enet_inf_rmii, &s_desc, &mac_config, &int_config) == status_success);
+    printf("enet_controller_init: %u reads, %u writes\n", block->reads, block->writes);
+    CHECK(s_enet.tx_desc == (uint32_t)s_tx_desc);
+    CHECK(s_enet.rx_desc == (uint32_t)s_rx_desc);
+
+    /* TX: one descriptor for a short frame, two for a long one, one register write each */
+    for (uint32_t length = 60; length <= TEST_FRAME_SIZE; length += TEST_FRAME_SIZE - 60U) {
+        hpm_host_sim_block_reset_stat(block);
+        s_enet.tx_descriptors = 0;
+        s_wire_frames = 0;
+        for (uint32_t n = 0; n < TEST_FRAMES; n++) {
+            make_frame(n, length);
+            CHECK(send_frame(enet, length) == status_success);
+            CHECK((s_wire_length == length) && (memcmp(s_wire, s_frame, length) == 0));
+        }
+        printf("TX %u byte frames: %u descriptors, %.2f reads, %.2f writes per frame\n", length,
+               s_enet.tx_descriptors / TEST_FRAMES, (double)block->reads / TEST_FRAMES, (double)block->writes / TEST_FRAMES);
+        CHECK(s_wire_frames == TEST_FRAMES);
+        CHECK(s_enet.tx_descriptors == TEST_FRAMES * ((length + TEST_TX_BUFF_SIZE - 1U) / TEST_TX_BUFF_SIZE));
+        CHECK((block->reads == 0U) && (block->writes == TEST_FRAMES));
+    }
+
+    /* RX: frame, descriptor release and resume check */
+    hpm_host_sim_block_reset_stat(block);
+    for (uint32_t n = 0; n < TEST_FRAMES; n++) {
+        make_frame(n, TEST_FRAME_SIZE);
+        CHECK(hpm_host_sim_enet_receive(&s_enet, s_frame, TEST_FRAME_SIZE));
+        CHECK(receive_frame(enet, data) == TEST_FRAME_SIZE);
+        CHECK(memcmp(data, s_frame, TEST_FRAME_SIZE) == 0);
+    }
+    printf("RX %u byte frames: %.2f reads, %.2f writes per frame\n", TEST_FRAME_SIZE,
+           (double)block->reads / TEST_FRAMES, (double)block->writes / TEST_FRAMES);
+    CHECK((block->reads == TEST_FRAMES) && (block->writes == 0U));
+
+    /* the descriptors run out: frames are dropped until the resume after the release */
+    for (uint32_t n = 0; n < TEST_RX_BUFF_COUNT + 2U; n++) {
+        make_frame(n, TEST_FRAME_SIZE);
+        hpm_host_sim_enet_receive(&s_enet, s_frame, TEST_FRAME_SIZE);
+    }
+    dropped = s_enet.rx_dropped;
+    CHECK(dropped == 2U);
+    CHECK((hpm_host_sim_peek(block, offsetof(ENET_Type, DMA_STATUS)) & ENET_DMA_STATUS_RU_MASK) != 0U);
+    hpm_host_sim_block_reset_stat(block);
+    for (uint32_t n = 0; n < TEST_RX_BUFF_COUNT; n++) {
+        CHECK(receive_frame(enet, data) == TEST_FRAME_SIZE);
+    }
+    printf("RX after running out of descriptors: %u frames dropped, %u reads, %u writes to resume\n",
+           dropped, block->reads, block->writes);
+    CHECK((block->reads == TEST_RX_BUFF_COUNT) && (block->writes == 2U));
+    make_frame(99, 60);
+    CHECK(hpm_host_sim_enet_receive(&s_enet, s_frame, 60));
+    CHECK(receive_frame(enet, data) == 60U);
+    CHECK(memcmp(data, s_frame, 60) == 0);
+
+    hpm_host_sim_enet_deinit(&s_enet);
+    return 0;
+}
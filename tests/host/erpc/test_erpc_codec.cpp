@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "erpc_basic_codec.hpp"
+
+using namespace erpc;
+
+/*
+ * BasicCodec fast paths against the per-element stream erpcgen emits: a 5x5
+ * int32 matrix written element by element (the generated matrix multiply
+ * shims) and with writeArray(), a plain structure written member by member
+ * and with writeStruct(). The streams have to be the same byte for byte and
+ * read back through either path. Also reports the time per matrix and per
+ * structure on the host, through Codec pointers as the shims call them.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_MATRIX_SIZE (5U)
+#define TEST_BENCH_RUNS  (1000000U)
+
+typedef int32_t test_matrix_t[TEST_MATRIX_SIZE][TEST_MATRIX_SIZE];
+
+/* scalar members only, no padding: memory layout is the stream layout */
+typedef struct {
+    uint32_t id;
+    int16_t x;
+    int16_t y;
+    float value;
+    uint8_t flags[4];
+    uint64_t timestamp;
+} test_sample_t;
+
+static uint8_t s_storage[2][256];
+static BasicCodec s_basic[2];
+static test_matrix_t s_matrix;
+static test_matrix_t s_back;
+static test_sample_t s_sample;
+static test_sample_t s_sample_back;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void rewind_for_write(Codec *codec)
+{
+    codec->getBuffer()->setUsed(0);
+    codec->reset();
+}
+
+/* what erpcgen emits for a Matrix argument */
+static void write_matrix_elements(Codec *codec, test_matrix_t matrix)
+{
+    for (uint32_t arrayCount0 = 0U; arrayCount0 < TEST_MATRIX_SIZE; ++arrayCount0) {
+        for (uint32_t arrayCount1 = 0U; arrayCount1 < TEST_MATRIX_SIZE; ++arrayCount1) {
+            codec->write(matrix[arrayCount0][arrayCount1]);
+        }
+    }
+}
+
+static void read_matrix_elements(Codec *codec, test_matrix_t matrix)
+{
+    for (uint32_t arrayCount0 = 0U; arrayCount0 < TEST_MATRIX_SIZE; ++arrayCount0) {
+        for (uint32_t arrayCount1 = 0U; arrayCount1 < TEST_MATRIX_SIZE; ++arrayCount1) {
+            codec->read(&matrix[arrayCount0][arrayCount1]);
+        }
+    }
+}
+
+/* what erpcgen emits for a struct argument */
+static void write_sample_members(Codec *codec, const test_sample_t *data)
+{
+    codec->write(data->id);
+    codec->write(data->x);
+    codec->write(data->y);
+    codec->write(data->value);
+    for (uint32_t arrayCount0 = 0U; arrayCount0 < 4U; ++arrayCount0) {
+        codec->write(data->flags[arrayCount0]);
+    }
+    codec->write(data->timestamp);
+}
+
+static void read_sample_members(Codec *codec, test_sample_t *data)
+{
+    codec->read(&data->id);
+    codec->read(&data->x);
+    codec->read(&data->y);
+    codec->read(&data->value);
+    for (uint32_t arrayCount0 = 0U; arrayCount0 < 4U; ++arrayCount0) {
+        codec->read(&data->flags[arrayCount0]);
+    }
+    codec->read(&data->timestamp);
+}
+
+int main(void)
+{
+    /* through pointers the compiler cannot see through, as in the shims */
+    Codec *volatile codec_ptr[2] = { &s_basic[0], &s_basic[1] };
+    Codec *element = codec_ptr[0];
+    Codec *bulk = codec_ptr[1];
+    double start;
+    double t_elements;
+    double t_array;
+    double t_members;
+    double t_struct;
+
+    for (uint32_t i = 0; i < 2U; i++) {
+        MessageBuffer buffer(s_storage[i], sizeof(s_storage[i]));
+        codec_ptr[i]->setBuffer(buffer);
+    }
+    for (uint32_t i = 0; i < TEST_MATRIX_SIZE; i++) {
+        for (uint32_t j = 0; j < TEST_MATRIX_SIZE; j++) {
+            s_matrix[i][j] = (int32_t)(i * 0x01010101U + j * 0x10203U) * ((j & 1U) ? -1 : 1);
+        }
+    }
+    s_sample.id = 0x12345678U;
+    s_sample.x = -1234;
+    s_sample.y = 4321;
+    s_sample.value = 3.25f;
+    memcpy(s_sample.flags, "\x01\x80\x7f\xff", sizeof(s_sample.flags));
+    s_sample.timestamp = 0x0102030405060708ULL;
+
+    /* same stream, read back through the other path */
+    write_matrix_elements(element, s_matrix);
+    bulk->writeArray(s_matrix, sizeof(s_matrix[0][0]), TEST_MATRIX_SIZE * TEST_MATRIX_SIZE);
+    CHECK(element->isStatusOk() && bulk->isStatusOk());
+    CHECK(element->getBuffer()->getUsed() == sizeof(s_matrix));
+    CHECK(bulk->getBuffer()->getUsed() == sizeof(s_matrix));
+    CHECK(memcmp(s_storage[0], s_storage[1], sizeof(s_matrix)) == 0);
+    element->reset();
+    bulk->reset();
+    bulk->readArray(s_back, sizeof(s_back[0][0]), TEST_MATRIX_SIZE * TEST_MATRIX_SIZE);
+    CHECK(bulk->isStatusOk() && (memcmp(s_back, s_matrix, sizeof(s_matrix)) == 0));
+    memset(s_back, 0, sizeof(s_back));
+    read_matrix_elements(element, s_back);
+    CHECK(element->isStatusOk() && (memcmp(s_back, s_matrix, sizeof(s_matrix)) == 0));
+
+    rewind_for_write(element);
+    rewind_for_write(bulk);
+    write_sample_members(element, &s_sample);
+    bulk->writeStruct(&s_sample, sizeof(s_sample));
+    CHECK(element->isStatusOk() && bulk->isStatusOk());
+    CHECK(element->getBuffer()->getUsed() == sizeof(s_sample));
+    CHECK(memcmp(s_storage[0], s_storage[1], sizeof(s_sample)) == 0);
+    element->reset();
+    bulk->reset();
+    bulk->readStruct(&s_sample_back, sizeof(s_sample_back));
+    CHECK(bulk->isStatusOk() && (memcmp(&s_sample_back, &s_sample, sizeof(s_sample)) == 0));
+    memset(&s_sample_back, 0, sizeof(s_sample_back));
+    read_sample_members(element, &s_sample_back);
+    CHECK(element->isStatusOk() && (memcmp(&s_sample_back, &s_sample, sizeof(s_sample)) == 0));
+
+    /* one bounds check: an array that does not fit writes nothing and fails */
+    rewind_for_write(bulk);
+    bulk->writeArray(s_storage[0], sizeof(uint32_t), (sizeof(s_storage[0]) / sizeof(uint32_t)) + 1U);
+    CHECK(bulk->getStatus() == kErpcStatus_BufferOverrun);
+    CHECK(bulk->getBuffer()->getUsed() == 0U);
+    rewind_for_write(bulk);
+    bulk->writeArray(s_matrix, 3U, 1U);
+    CHECK(bulk->getStatus() == kErpcStatus_InvalidArgument);
+    /* reading past the written data fails */
+    rewind_for_write(bulk);
+    bulk->writeStruct(&s_sample, sizeof(s_sample) - 1U);
+    bulk->reset();
+    bulk->readStruct(&s_sample_back, sizeof(s_sample_back));
+    CHECK(bulk->getStatus() == kErpcStatus_Fail);
+
+    /* time per matrix and per structure, write then read back */
+    start = now_ns();
+    for (uint32_t n = 0; n < TEST_BENCH_RUNS; n++) {
+        rewind_for_write(element);
+        write_matrix_elements(element, s_matrix);
+        element->reset();
+        read_matrix_elements(element, s_back);
+    }
+    t_elements = (now_ns() - start) / TEST_BENCH_RUNS;
+    start = now_ns();
+    for (uint32_t n = 0; n < TEST_BENCH_RUNS; n++) {
+        rewind_for_write(bulk);
+        bulk->writeArray(s_matrix, sizeof(s_matrix[0][0]), TEST_MATRIX_SIZE * TEST_MATRIX_SIZE);
+        bulk->reset();
+        bulk->readArray(s_back, sizeof(s_back[0][0]), TEST_MATRIX_SIZE * TEST_MATRIX_SIZE);
+    }
+    t_array = (now_ns() - start) / TEST_BENCH_RUNS;
+    start = now_ns();
+    for (uint32_t n = 0; n < TEST_BENCH_RUNS; n++) {
+        rewind_for_write(element);
+        write_sample_members(element, &s_sample);
+        element->reset();
+        read_sample_members(element, &s_sample_back);
+    }
+    t_members = (now_ns() - start) / TEST_BENCH_RUNS;
+    start = now_ns();
+    for (uint32_t n = 0; n < TEST_BENCH_RUNS; n++) {
+        rewind_for_write(bulk);
+        bulk->writeStruct(&s_sample, sizeof(s_sample));
+        bulk->reset();
+        bulk->readStruct(&s_sample_back, sizeof(s_sample_back));
+    }
+    t_struct = (now_ns() - start) / TEST_BENCH_RUNS;
+    CHECK(element->isStatusOk() && bulk->isStatusOk());
+
+    printf("5x5 int32 matrix, write and read: %7.1f ns per element, %7.1f ns writeArray/readArray\n",
+           t_elements, t_array);
+    printf("%2u byte structure, write and read: %7.1f ns per member,  %7.1f ns writeStruct/readStruct\n",
+           (unsigned int)sizeof(test_sample_t), t_members, t_struct);
+    return 0;
+}
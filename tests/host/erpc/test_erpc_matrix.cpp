@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "erpc_client_setup.h"
+#include "erpc_server_setup.h"
+#include "erpc_mbf_setup.h"
+#include "erpc_threading.h"
+#include "erpc_inter_thread_buffer_transport.hpp"
+#include "erpc_tcp_transport.hpp"
+#include "erpc_matrix_multiply.h"
+#include "erpc_matrix_multiply_server.h"
+
+using namespace erpc;
+
+/*
+ * The matrix multiply sample, shims as erpcgen generates them, between a
+ * client and a server thread on the host, over the inter-thread buffer
+ * transport or TCP on the loopback. Built per message buffer factory and
+ * client option (TEST_MBF_POOL, ERPC_CLIENT_REQUEST_REUSE, the allocation
+ * policy), reports calls per second and heap allocations per call once the
+ * first calls are done. malloc is wrapped at link time, erpc_port_stdlib.cpp
+ * routes new and delete to it. The client stubs are built as
+ * erpcMatrixMultiply_client() and erpcSwitchLightLed_client().
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_WARMUP_CALLS (100U)
+#define TEST_CALLS        (20000U)
+
+extern "C" void *__real_malloc(size_t size);
+extern "C" {
+void erpcMatrixMultiply_client(Matrix matrix1, Matrix matrix2, Matrix result_matrix);
+void erpcSwitchLightLed_client(void);
+}
+
+static uint32_t s_allocations;
+static erpc_server_t s_server;
+static erpc_status_t s_client_error = kErpcStatus_Success;
+static Matrix s_matrix1;
+static Matrix s_matrix2;
+static Matrix s_result;
+
+extern "C" void *__wrap_malloc(size_t size)
+{
+    __atomic_fetch_add(&s_allocations, 1U, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* server side implementation */
+void erpcMatrixMultiply(Matrix matrix1, Matrix matrix2, Matrix result_matrix)
+{
+    for (int32_t i = 0; i < matrix_size; i++) {
+        for (int32_t j = 0; j < matrix_size; j++) {
+            result_matrix[i][j] = 0;
+            for (int32_t k = 0; k < matrix_size; k++) {
+                result_matrix[i][j] += matrix1[i][k] * matrix2[k][j];
+            }
+        }
+    }
+}
+
+/* the last call, ends erpc_server_run() */
+void erpcSwitchLightLed(void)
+{
+    erpc_server_stop(s_server);
+}
+
+static void client_error_handler(erpc_status_t err, uint32_t functionID)
+{
+    (void)functionID;
+    s_client_error = err;
+}
+
+static void server_thread(void *arg)
+{
+    (void)arg;
+    erpc_server_run(s_server);
+}
+
+static bool check_result(void)
+{
+    Matrix expected;
+
+    erpcMatrixMultiply(s_matrix1, s_matrix2, expected);
+    return memcmp(expected, s_result, sizeof(expected)) == 0;
+}
+
+int main(void)
+{
+    static Thread s_server_thread(server_thread, 0, 0, "erpc server");
+    erpc_transport_t client_transport;
+    erpc_transport_t server_transport;
+    erpc_mbf_t client_mbf;
+    erpc_mbf_t server_mbf;
+    erpc_client_t client;
+    uint32_t allocations;
+    uint32_t expected;
+    double start;
+    double elapsed;
+
+#if defined(TEST_TRANSPORT_TCP)
+    /* a port per process, ctest may run the variants in parallel */
+    uint16_t port = (uint16_t)(20000U + ((uint32_t)getpid() % 20000U));
+    TCPTransport *server_tcp = new TCPTransport("localhost", port, true);
+    TCPTransport *client_tcp = new TCPTransport("localhost", port, false);
+    uint32_t tries = 0;
+
+    CHECK(server_tcp->open() == kErpcStatus_Success);
+    while (client_tcp->open() != kErpcStatus_Success) {
+        CHECK(++tries < 100U);
+        Thread::sleep(10000);
+    }
+    server_transport = reinterpret_cast<erpc_transport_t>(server_tcp);
+    client_transport = reinterpret_cast<erpc_transport_t>(client_tcp);
+#else
+    InterThreadBufferTransport *server_thread_transport = new InterThreadBufferTransport();
+    InterThreadBufferTransport *client_thread_transport = new InterThreadBufferTransport();
+
+    server_thread_transport->linkWithPeer(client_thread_transport);
+    server_transport = reinterpret_cast<erpc_transport_t>(server_thread_transport);
+    client_transport = reinterpret_cast<erpc_transport_t>(client_thread_transport);
+#endif
+
+#if defined(TEST_MBF_POOL)
+    /* one pool shared by both sides */
+    client_mbf = erpc_mbf_pool_init();
+    server_mbf = client_mbf;
+#else
+    client_mbf = erpc_mbf_dynamic_init();
+    server_mbf = client_mbf;
+#endif
+
+    s_server = erpc_server_init(server_transport, server_mbf);
+    CHECK(s_server != NULL);
+    erpc_add_service_to_server(s_server, create_MatrixMultiplyService_service());
+    client = erpc_client_init(client_transport, client_mbf);
+    CHECK(client != NULL);
+    erpc_client_set_error_handler(client, client_error_handler);
+    s_server_thread.start(NULL);
+
+    for (int32_t i = 0; i < matrix_size; i++) {
+        for (int32_t j = 0; j < matrix_size; j++) {
+            s_matrix1[i][j] = i * matrix_size + j;
+            s_matrix2[i][j] = (j - i) * 3;
+        }
+    }
+    for (uint32_t n = 0; n < TEST_WARMUP_CALLS; n++) {
+        erpcMatrixMultiply_client(s_matrix1, s_matrix2, s_result);
+    }
+    CHECK(s_client_error == kErpcStatus_Success);
+    CHECK(check_result());
+
+    allocations = __atomic_load_n(&s_allocations, __ATOMIC_RELAXED);
+    start = now_ns();
+    for (uint32_t n = 0; n < TEST_CALLS; n++) {
+        s_matrix1[0][0] = (int32_t)n;
+        erpcMatrixMultiply_client(s_matrix1, s_matrix2, s_result);
+    }
+    elapsed = now_ns() - start;
+    allocations = __atomic_load_n(&s_allocations, __ATOMIC_RELAXED) - allocations;
+    CHECK(s_client_error == kErpcStatus_Success);
+    CHECK(check_result());
+
+#if defined(TEST_MBF_POOL)
+    erpc_mbf_pool_stats_t stats;
+
+    erpc_mbf_pool_get_stats(client_mbf, &stats);
+    printf("pool: %u buffers, peak %u in use, %u failed\n",
+           (unsigned int)stats.count, (unsigned int)stats.peak, (unsigned int)stats.failed);
+    CHECK(stats.failed == 0U);
+#endif
+    printf("%s, %s factory, request reuse %s, %s allocation: %.0f calls/s, %.2f heap allocations per call\n",
+#if defined(TEST_TRANSPORT_TCP)
+           "TCP",
+#else
+           "inter-thread",
+#endif
+#if defined(TEST_MBF_POOL)
+           "pool",
+#else
+           "dynamic",
+#endif
+           ERPC_CLIENT_REQUEST_REUSE ? "on" : "off",
+           (ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_STATIC) ? "static" : "dynamic",
+           TEST_CALLS * 1e9 / elapsed, (double)allocations / TEST_CALLS);
+
+    /* a buffer per side from the dynamic factory, a codec per side unless the client reuses its own */
+    expected = 0;
+#if !defined(TEST_MBF_POOL)
+    expected += 2U;
+#endif
+#if ERPC_ALLOCATION_POLICY == ERPC_ALLOCATION_POLICY_DYNAMIC
+    expected += ERPC_CLIENT_REQUEST_REUSE ? 1U : 2U;
+#endif
+    /* the server may have taken its buffer and codec for the next request or not yet */
+    CHECK((allocations + 2U >= expected * TEST_CALLS) && (allocations <= expected * TEST_CALLS + 2U));
+
+    erpcSwitchLightLed_client();
+    return 0;
+}
@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_fft_service.h"
+
+/*
+ * The FFT service built without the FFA, the software backend against a
+ * double precision DFT and direct FIR: float and q31 FFT and IFFT for 8 to
+ * 1024 points with the scaling of hpm_fft_service.h, q31 FIR bit exact
+ * against a 64-bit accumulation, float FIR and the mixed formats. Then the
+ * request queue: submit, notify per batch, process, callbacks and counters.
+ * Also reports the time per transform and per FIR output on the host.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_MAX_POINTS    (1024U)
+#define TEST_FIR_SAMPLES   (1024U)
+#define TEST_FIR_TAPS      (64U)
+#define TEST_BENCH_RUNS    (2000U)
+#define TEST_PI            (3.14159265358979323846)
+
+static uint64_t s_work[(HPM_FFT_SERVICE_FFT_WORK_SIZE(TEST_MAX_POINTS) + 7U) / 8U];
+static float s_in_f[2U * TEST_MAX_POINTS];
+static float s_out_f[2U * TEST_MAX_POINTS];
+static int32_t s_in_q[2U * TEST_MAX_POINTS];
+static int32_t s_out_q[2U * TEST_MAX_POINTS];
+static double s_ref[2U * TEST_MAX_POINTS];
+static float s_coef_f[TEST_FIR_TAPS];
+static int32_t s_coef_q[TEST_FIR_TAPS];
+static uint32_t s_seed = 1;
+static uint32_t s_notified;
+static uint32_t s_callbacks;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed;
+}
+
+/* uniform in [-amplitude, amplitude) */
+static double rnd_value(double amplitude)
+{
+    return ((double)(rnd() >> 8) / 8388608.0 - 1.0) * amplitude;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void dft(const double *in, double *out, uint32_t n, bool inverse)
+{
+    double sign = inverse ? 1.0 : -1.0;
+
+    for (uint32_t k = 0; k < n; k++) {
+        double re = 0.0;
+        double im = 0.0;
+        for (uint32_t t = 0; t < n; t++) {
+            double angle = sign * 2.0 * TEST_PI * (double)((uint64_t)k * t % n) / (double)n;
+            re += in[2U * t] * cos(angle) - in[2U * t + 1U] * sin(angle);
+            im += in[2U * t] * sin(angle) + in[2U * t + 1U] * cos(angle);
+        }
+        out[2U * k] = re;
+        out[2U * k + 1U] = im;
+    }
+}
+
+/* signal to error ratio in dB of count values against the reference times scale */
+static double snr_db(const double *ref, double scale, const float *out_f, const int32_t *out_q, uint32_t count)
+{
+    double signal = 0.0;
+    double error = 0.0;
+    double value;
+
+    for (uint32_t i = 0; i < count; i++) {
+        value = (out_f != NULL) ? (double)out_f[i] : (double)out_q[i] / 2147483648.0;
+        signal += ref[i] * scale * ref[i] * scale;
+        error += (value - ref[i] * scale) * (value - ref[i] * scale);
+    }
+    return 10.0 * log10(signal / ((error > 0.0) ? error : 1e-300));
+}
+
+static hpm_stat_t plan_init(hpm_fft_plan_t *plan, hpm_fft_op_t op, hpm_fft_format_t in, hpm_fft_format_t out,
+                            uint32_t num_points)
+{
+    hpm_fft_plan_config_t config;
+
+    hpm_fft_plan_get_default_config(&config);
+    config.op = op;
+    config.in_format = in;
+    config.out_format = out;
+    config.num_points = num_points;
+    config.work = s_work;
+    config.work_size = sizeof(s_work);
+    if (op == hpm_fft_op_fir) {
+        config.coef_taps = TEST_FIR_TAPS;
+        config.coeff = (in == hpm_fft_format_float) ? (const void *)s_coef_f : (const void *)s_coef_q;
+    }
+    return hpm_fft_plan_init(plan, &config);
+}
+
+static int check_plans(void)
+{
+    hpm_fft_plan_config_t config;
+    hpm_fft_plan_t plan;
+
+    hpm_fft_plan_get_default_config(&config);
+    config.num_points = 64;
+    config.work = s_work;
+    config.work_size = sizeof(s_work);
+    CHECK(hpm_fft_plan_init(&plan, &config) == status_success);
+    /* no FFA off-target: auto selects software, the FFA backend is refused */
+    CHECK(plan.backend == hpm_fft_backend_software);
+    config.backend = hpm_fft_backend_ffa;
+    CHECK(hpm_fft_plan_init(&plan, &config) == status_fft_service_unsupported);
+    config.backend = hpm_fft_backend_software;
+    config.num_points = 48;
+    CHECK(hpm_fft_plan_init(&plan, &config) == status_invalid_argument);
+    config.num_points = 64;
+    config.work_size = HPM_FFT_SERVICE_FFT_WORK_SIZE(64U) - 1U;
+    CHECK(hpm_fft_plan_init(&plan, &config) == status_invalid_argument);
+    config.work_size = sizeof(s_work);
+    config.work = (uint8_t *)s_work + 4;
+    CHECK(hpm_fft_plan_init(&plan, &config) == status_invalid_argument);
+    config.work = s_work;
+    config.op = hpm_fft_op_fir;
+    config.coeff = s_coef_f;
+    config.coef_taps = 65;
+    CHECK(hpm_fft_plan_init(&plan, &config) == status_invalid_argument);
+    config.coef_taps = 64;
+    CHECK(hpm_fft_plan_init(&plan, &config) == status_success);
+    return 0;
+}
+
+static int check_fft(uint32_t n)
+{
+    hpm_fft_plan_t plan;
+    double in[2U * TEST_MAX_POINTS];
+    double snr_f;
+    double snr_q;
+    double snr_qi;
+    double err = 0.0;
+
+    /* inputs in [-0.5, 0.5) so the q31 conversions do not saturate */
+    for (uint32_t i = 0; i < 2U * n; i++) {
+        in[i] = rnd_value(0.5);
+        s_in_f[i] = (float)in[i];
+        s_in_q[i] = (int32_t)(in[i] * 2147483648.0);
+        in[i] = (double)s_in_f[i];
+    }
+    dft(in, s_ref, n, false);
+
+    /* float forward FFT is not scaled */
+    CHECK(plan_init(&plan, hpm_fft_op_fft, hpm_fft_format_float, hpm_fft_format_float, n) == status_success);
+    hpm_fft_sw_execute(&plan, s_in_f, s_out_f);
+    snr_f = snr_db(s_ref, 1.0, s_out_f, NULL, 2U * n);
+
+    /* q31 results are scaled by 1/N, as the FFA produces them */
+    CHECK(plan_init(&plan, hpm_fft_op_fft, hpm_fft_format_q31, hpm_fft_format_q31, n) == status_success);
+    hpm_fft_sw_execute(&plan, s_in_q, s_out_q);
+    snr_q = snr_db(s_ref, 1.0 / n, NULL, s_out_q, 2U * n);
+
+    /* q31 in, float out is not scaled either, in place */
+    CHECK(plan_init(&plan, hpm_fft_op_fft, hpm_fft_format_q31, hpm_fft_format_float, n) == status_success);
+    memcpy(s_out_f, s_in_q, 2U * n * sizeof(int32_t));
+    hpm_fft_sw_execute(&plan, s_out_f, s_out_f);
+    CHECK(snr_db(s_ref, 1.0, s_out_f, NULL, 2U * n) > 100.0);
+
+    /* float IFFT is scaled by 1/N and takes the spectrum back, in place */
+    CHECK(plan_init(&plan, hpm_fft_op_fft, hpm_fft_format_float, hpm_fft_format_float, n) == status_success);
+    hpm_fft_sw_execute(&plan, s_in_f, s_out_f);
+    CHECK(plan_init(&plan, hpm_fft_op_ifft, hpm_fft_format_float, hpm_fft_format_float, n) == status_success);
+    hpm_fft_sw_execute(&plan, s_out_f, s_out_f);
+    for (uint32_t i = 0; i < 2U * n; i++) {
+        err = fmax(err, fabs((double)s_out_f[i] - in[i]));
+    }
+    CHECK(err < 1e-5);
+
+    /* q31 IFFT of the DFT / N gives the input / N */
+    for (uint32_t i = 0; i < 2U * n; i++) {
+        s_in_q[i] = (int32_t)(s_ref[i] / n * 2147483648.0);
+    }
+    CHECK(plan_init(&plan, hpm_fft_op_ifft, hpm_fft_format_q31, hpm_fft_format_q31, n) == status_success);
+    hpm_fft_sw_execute(&plan, s_in_q, s_out_q);
+    snr_qi = snr_db(in, 1.0 / n, NULL, s_out_q, 2U * n);
+
+    printf("%4u points: float FFT %6.1f dB, q31 FFT %6.1f dB, q31 IFFT %6.1f dB, float round trip %.1e\n",
+           (unsigned int)n, snr_f, snr_q, snr_qi, err);
+    CHECK(snr_f > 130.0);
+    CHECK(snr_q > 130.0);
+    CHECK(snr_qi > 110.0);
+    return 0;
+}
+
+static int check_fir(void)
+{
+    hpm_fft_plan_t plan;
+    uint32_t outputs = TEST_FIR_SAMPLES - TEST_FIR_TAPS + 1U;
+    double in[TEST_FIR_SAMPLES];
+    double ref;
+    int64_t acc;
+    double snr;
+
+    /* a windowed sinc low pass, sum of the taps below 1 */
+    for (uint32_t k = 0; k < TEST_FIR_TAPS; k++) {
+        double x = (double)k - (TEST_FIR_TAPS - 1U) / 2.0;
+        double h = ((x == 0.0) ? 0.25 : sin(0.25 * TEST_PI * x) / (TEST_PI * x))
+                 * (0.54 - 0.46 * cos(2.0 * TEST_PI * k / (TEST_FIR_TAPS - 1U)));
+        s_coef_f[k] = (float)h;
+        s_coef_q[k] = (int32_t)(h * 2147483648.0);
+    }
+    for (uint32_t i = 0; i < TEST_FIR_SAMPLES; i++) {
+        in[i] = rnd_value(0.9);
+        s_in_f[i] = (float)in[i];
+        s_in_q[i] = (int32_t)(in[i] * 2147483648.0);
+    }
+
+    /* q31 is bit exact: 64-bit accumulation shifted down */
+    CHECK(plan_init(&plan, hpm_fft_op_fir, hpm_fft_format_q31, hpm_fft_format_q31, TEST_FIR_SAMPLES) == status_success);
+    hpm_fft_sw_execute(&plan, s_in_q, s_out_q);
+    for (uint32_t i = 0; i < outputs; i++) {
+        acc = 0;
+        for (uint32_t k = 0; k < TEST_FIR_TAPS; k++) {
+            acc += (int64_t)s_coef_q[k] * s_in_q[i + TEST_FIR_TAPS - 1U - k];
+        }
+        CHECK(s_out_q[i] == (int32_t)(acc >> 31));
+    }
+
+    for (uint32_t i = 0; i < outputs; i++) {
+        ref = 0.0;
+        for (uint32_t k = 0; k < TEST_FIR_TAPS; k++) {
+            ref += (double)s_coef_f[k] * (double)s_in_f[i + TEST_FIR_TAPS - 1U - k];
+        }
+        s_ref[i] = ref;
+    }
+    CHECK(plan_init(&plan, hpm_fft_op_fir, hpm_fft_format_float, hpm_fft_format_float, TEST_FIR_SAMPLES) == status_success);
+    hpm_fft_sw_execute(&plan, s_in_f, s_out_f);
+    snr = snr_db(s_ref, 1.0, s_out_f, NULL, outputs);
+    CHECK(snr > 110.0);
+    /* float in, q31 out and q31 in, float out */
+    CHECK(plan_init(&plan, hpm_fft_op_fir, hpm_fft_format_float, hpm_fft_format_q31, TEST_FIR_SAMPLES) == status_success);
+    hpm_fft_sw_execute(&plan, s_in_f, s_out_q);
+    CHECK(snr_db(s_ref, 1.0, NULL, s_out_q, outputs) > 110.0);
+    CHECK(plan_init(&plan, hpm_fft_op_fir, hpm_fft_format_q31, hpm_fft_format_float, TEST_FIR_SAMPLES) == status_success);
+    hpm_fft_sw_execute(&plan, s_in_q, s_out_f);
+    CHECK(snr_db(s_ref, 1.0, s_out_f, NULL, outputs) > 110.0);
+    printf("FIR %u taps over %u samples: q31 bit exact, float %.1f dB\n",
+           (unsigned int)TEST_FIR_TAPS, (unsigned int)TEST_FIR_SAMPLES, snr);
+    return 0;
+}
+
+static void service_notify(void *context)
+{
+    (void)context;
+    s_notified++;
+}
+
+static void request_done(hpm_fft_request_t *request)
+{
+    (void)request;
+    s_callbacks++;
+}
+
+static int check_service(void)
+{
+    hpm_fft_service_config_t config;
+    hpm_fft_service_stat_t stat;
+    hpm_fft_plan_t plan;
+    hpm_fft_plan_t ffa_plan;
+    hpm_fft_request_t requests[4];
+
+    memset(requests, 0, sizeof(requests));
+    CHECK(plan_init(&plan, hpm_fft_op_fft, hpm_fft_format_q31, hpm_fft_format_q31, 64U) == status_success);
+    for (uint32_t i = 0; i < 4U; i++) {
+        requests[i].plan = &plan;
+        requests[i].src = s_in_q;
+        requests[i].dst = &s_out_q[i * 128U];
+        requests[i].callback = request_done;
+    }
+    CHECK(hpm_fft_service_submit(&requests[0]) == status_fft_service_not_ready);
+
+    hpm_fft_service_get_default_config(&config);
+    config.notify = service_notify;
+    CHECK(hpm_fft_service_init(&config) == status_success);
+    for (uint32_t i = 0; i < 4U; i++) {
+        CHECK(hpm_fft_service_submit(&requests[i]) == status_success);
+        CHECK(!hpm_fft_request_is_done(&requests[i]));
+    }
+    CHECK(hpm_fft_service_submit(&requests[1]) == status_fft_service_busy);
+    /* one wakeup for the batch */
+    CHECK(s_notified == 1U);
+    CHECK(hpm_fft_service_process(2U) == 2U);
+    CHECK(hpm_fft_request_is_done(&requests[1]) && !hpm_fft_request_is_done(&requests[2]));
+    CHECK(hpm_fft_service_process(10U) == 2U);
+    CHECK(hpm_fft_service_process(10U) == 0U);
+    CHECK(s_callbacks == 4U);
+    for (uint32_t i = 0; i < 4U; i++) {
+        CHECK(requests[i].status == status_success);
+        CHECK(memcmp(&s_out_q[i * 128U], s_out_q, 128U * sizeof(int32_t)) == 0);
+    }
+    /* the queue was empty again, the next request wakes the worker */
+    CHECK(hpm_fft_service_submit(&requests[0]) == status_success);
+    CHECK(s_notified == 2U);
+    CHECK(hpm_fft_service_process(1U) == 1U);
+
+    /* a plan for the FFA can not be made off-target, one is refused at submit as well */
+    ffa_plan = plan;
+    ffa_plan.backend = hpm_fft_backend_ffa;
+    requests[1].plan = &ffa_plan;
+    CHECK(hpm_fft_service_submit(&requests[1]) == status_fft_service_unsupported);
+    requests[1].src = NULL;
+    CHECK(hpm_fft_service_submit(&requests[1]) == status_invalid_argument);
+
+    hpm_fft_service_get_stat(&stat);
+    CHECK((stat.sw_requests == 5U) && (stat.ffa_requests == 0U) && (stat.failed == 0U) && (stat.max_pending == 4U));
+    printf("service: %u requests in software, %u wakeups, max %u pending\n", (unsigned int)stat.sw_requests,
+           (unsigned int)s_notified, (unsigned int)stat.max_pending);
+    hpm_fft_service_reset_stat();
+    hpm_fft_service_get_stat(&stat);
+    CHECK((stat.sw_requests == 0U) && (stat.max_pending == 0U));
+    return 0;
+}
+
+static int bench(void)
+{
+    hpm_fft_plan_t plan;
+    double start;
+    double t_float;
+    double t_q31;
+
+    for (uint32_t n = 64U; n <= TEST_MAX_POINTS; n *= 4U) {
+        CHECK(plan_init(&plan, hpm_fft_op_fft, hpm_fft_format_float, hpm_fft_format_float, n) == status_success);
+        start = now_ns();
+        for (uint32_t r = 0; r < TEST_BENCH_RUNS; r++) {
+            hpm_fft_sw_execute(&plan, s_in_f, s_out_f);
+        }
+        t_float = (now_ns() - start) / TEST_BENCH_RUNS;
+        CHECK(plan_init(&plan, hpm_fft_op_fft, hpm_fft_format_q31, hpm_fft_format_q31, n) == status_success);
+        start = now_ns();
+        for (uint32_t r = 0; r < TEST_BENCH_RUNS; r++) {
+            hpm_fft_sw_execute(&plan, s_in_q, s_out_q);
+        }
+        t_q31 = (now_ns() - start) / TEST_BENCH_RUNS;
+        printf("%4u point FFT: float %8.0f ns, q31 %8.0f ns (with conversions)\n", (unsigned int)n, t_float, t_q31);
+    }
+    CHECK(plan_init(&plan, hpm_fft_op_fir, hpm_fft_format_q31, hpm_fft_format_q31, TEST_FIR_SAMPLES) == status_success);
+    start = now_ns();
+    for (uint32_t r = 0; r < TEST_BENCH_RUNS / 10U; r++) {
+        hpm_fft_sw_execute(&plan, s_in_q, s_out_q);
+    }
+    t_q31 = (now_ns() - start) / (TEST_BENCH_RUNS / 10U) / (TEST_FIR_SAMPLES - TEST_FIR_TAPS + 1U);
+    CHECK(plan_init(&plan, hpm_fft_op_fir, hpm_fft_format_float, hpm_fft_format_float, TEST_FIR_SAMPLES) == status_success);
+    start = now_ns();
+    for (uint32_t r = 0; r < TEST_BENCH_RUNS / 10U; r++) {
+        hpm_fft_sw_execute(&plan, s_in_f, s_out_f);
+    }
+    t_float = (now_ns() - start) / (TEST_BENCH_RUNS / 10U) / (TEST_FIR_SAMPLES - TEST_FIR_TAPS + 1U);
+    printf("%u tap FIR: float %.1f ns, q31 %.1f ns per output\n", (unsigned int)TEST_FIR_TAPS, t_float, t_q31);
+    return 0;
+}
+
+int main(void)
+{
+    CHECK(check_plans() == 0);
+    for (uint32_t n = 8U; n <= TEST_MAX_POINTS; n *= 2U) {
+        CHECK(check_fft(n) == 0);
+    }
+    CHECK(check_fir() == 0);
+    CHECK(check_service() == 0);
+    return bench();
+}
@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim.h"
+#include "hpm_i2c.h"
+#include "hpm_smbus_async.h"
+
+/*
+ * I2C controller model: the bus moves one phase or one byte per step, DATA
+ * pushes to and pops from the FIFO, STATUS shows the latched events (write
+ * one to clear) and the FIFO level, CTRL reads back the bytes left. Reads
+ * are acknowledged by the ACK/NACK command while the byte received interrupt
+ * is enabled, else automatically.
+ *
+ * Targets are register files: the first byte written after the address sets
+ * the register pointer, further bytes are written or read from there on.
+ */
+#define MODEL_TARGETS   (4U)
+
+typedef struct {
+    uint16_t address;
+    bool is_10bit;
+    bool stretch;                   /**< holds SCL low forever after the address */
+    uint8_t regs[256];
+    uint8_t ptr;
+    bool ptr_set;
+} i2c_target_t;
+
+typedef enum {
+    model_idle,
+    model_addr,
+    model_data,
+    model_end,
+} model_phase_t;
+
+typedef struct {
+    hpm_host_sim_block_t *block;
+    i2c_target_t *targets[MODEL_TARGETS];
+    i2c_target_t *selected;
+    model_phase_t phase;
+    uint32_t ctrl;
+    uint32_t left;
+    uint32_t status;
+    uint8_t fifo[I2C_SOC_FIFO_SIZE];
+    uint32_t level;
+    bool wait_ack;
+    bool bus_busy;
+    bool step_on_status;            /**< blocking driver, the bus moves while STATUS is polled */
+    uint32_t divider;               /**< CPU polls per bus step */
+    uint32_t ticks;
+} i2c_model_t;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_READS      (8U)
+#define TEST_REG        (0x10U)
+
+static i2c_model_t s_model;
+static i2c_target_t s_sensor = { .address = 0x50 };
+static i2c_target_t s_smbus = { .address = 0x0B };
+static i2c_target_t s_wide = { .address = 0x2A5, .is_10bit = true };
+static i2c_target_t s_stuck = { .address = 0x21, .stretch = true };
+static uint32_t s_callbacks;
+
+static i2c_target_t *i2c_model_find(i2c_model_t *model, uint32_t address, bool is_10bit)
+{
+    for (uint32_t i = 0; i < MODEL_TARGETS; i++) {
+        if ((model->targets[i] != NULL) && (model->targets[i]->is_10bit == is_10bit)
+            && (model->targets[i]->address == (is_10bit ? address : (address & 0x7FU)))) {
+            return model->targets[i];
+        }
+    }
+    return NULL;
+}
+
+static void i2c_model_step(i2c_model_t *model)
+{
+    i2c_target_t *target = model->selected;
+    bool read = (model->ctrl & I2C_CTRL_DIR_MASK) != 0;
+    uint32_t setup;
+
+    if ((model->divider > 1U) && ((++model->ticks % model->divider) != 0U)) {
+        return;
+    }
+    switch (model->phase) {
+    case model_addr:
+        if (model->ctrl & I2C_CTRL_PHASE_START_MASK) {
+            model->status |= I2C_STATUS_START_MASK;
+            model->bus_busy = true;
+        }
+        if (model->ctrl & I2C_CTRL_PHASE_ADDR_MASK) {
+            setup = hpm_host_sim_peek(model->block, offsetof(I2C_Type, SETUP));
+            target = i2c_model_find(model, I2C_ADDR_ADDR_GET(hpm_host_sim_peek(model->block, offsetof(I2C_Type, ADDR))),
+                                    (setup & I2C_SETUP_ADDRESSING_MASK) != 0);
+            model->selected = target;
+            if (target == NULL) {
+                /* NACK, the transaction ends */
+                model->phase = model_end;
+                break;
+            }
+            model->status |= I2C_STATUS_ADDRHIT_MASK;
+            if (!read) {
+                target->ptr_set = false;
+            }
+        }
+        model->phase = model_data;
+        break;
+    case model_data:
+        if ((model->left == 0) || (target == NULL)) {
+            model->phase = model_end;
+        } else if (target->stretch) {
+            break;
+        } else if (!read) {
+            if (model->level != 0U) {
+                if (target->ptr_set) {
+                    target->regs[target->ptr++] = model->fifo[0];
+                } else {
+                    target->ptr = model->fifo[0];
+                    target->ptr_set = true;
+                }
+                memmove(model->fifo, &model->fifo[1], --model->level);
+                model->left--;
+                model->status |= I2C_STATUS_BYTETRANS_MASK;
+            }
+        } else if (!model->wait_ack && (model->level < I2C_SOC_FIFO_SIZE)) {
+            model->fifo[model->level++] = target->regs[target->ptr++];
+            model->left--;
+            model->status |= I2C_STATUS_BYTERECV_MASK;
+            model->wait_ack = (hpm_host_sim_peek(model->block, offsetof(I2C_Type, INTEN)) & I2C_EVENT_BYTE_RECEIVED) != 0;
+        }
+        break;
+    case model_end:
+        if (model->ctrl & I2C_CTRL_PHASE_STOP_MASK) {
+            model->status |= I2C_STATUS_STOP_MASK;
+            model->bus_busy = false;
+        }
+        model->status |= I2C_STATUS_CMPL_MASK;
+        model->phase = model_idle;
+        break;
+    default:
+        break;
+    }
+}
+
+static uint32_t i2c_model_status(i2c_model_t *model)
+{
+    return model->status
+           | ((model->level == 0U) ? I2C_STATUS_FIFOEMPTY_MASK : 0U)
+           | ((model->level == I2C_SOC_FIFO_SIZE) ? I2C_STATUS_FIFOFULL_MASK : 0U)
+           | (model->bus_busy ? I2C_STATUS_BUSBUSY_MASK : 0U);
+}
+
+static void i2c_model_command(i2c_model_t *model, uint32_t cmd)
+{
+    uint32_t ctrl = hpm_host_sim_peek(model->block, offsetof(I2C_Type, CTRL));
+
+    switch (cmd) {
+    case I2C_CMD_ISSUE_DATA_TRANSMISSION:
+        model->ctrl = ctrl;
+        model->left = 0;
+        if (ctrl & I2C_CTRL_PHASE_DATA_MASK) {
+            model->left = (I2C_CTRL_DATACNT_HIGH_GET(ctrl) << 8U) | I2C_CTRL_DATACNT_GET(ctrl);
+            model->left = (model->left == 0U) ? I2C_SOC_TRANSFER_COUNT_MAX : model->left;
+        }
+        model->wait_ack = false;
+        model->phase = (ctrl & (I2C_CTRL_PHASE_START_MASK | I2C_CTRL_PHASE_ADDR_MASK)) ? model_addr : model_data;
+        break;
+    case I2C_CMD_ACK:
+    case I2C_CMD_NACK:
+        model->wait_ack = false;
+        break;
+    case I2C_CMD_CLEAR_FIFO:
+        model->level = 0;
+        break;
+    case I2C_CMD_RESET:
+        model->phase = model_idle;
+        model->level = 0;
+        model->wait_ack = false;
+        model->bus_busy = false;
+        break;
+    default:
+        break;
+    }
+}
+
+static void i2c_model_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                           hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    i2c_model_t *model = (i2c_model_t *)block->context;
+
+    (void)old;
+    if (access == hpm_host_sim_read) {
+        if (offset == offsetof(I2C_Type, STATUS)) {
+            if (model->step_on_status) {
+                i2c_model_step(model);
+            }
+            *value = i2c_model_status(model);
+        } else if (offset == offsetof(I2C_Type, CTRL)) {
+            *value = (*value & ~(I2C_CTRL_DATACNT_MASK | I2C_CTRL_DATACNT_HIGH_MASK))
+                     | I2C_CTRL_DATACNT_HIGH_SET(model->left >> 8U) | I2C_CTRL_DATACNT_SET(model->left);
+        } else if ((offset == offsetof(I2C_Type, DATA)) && (model->level != 0U)) {
+            *value = model->fifo[0];
+            memmove(model->fifo, &model->fifo[1], --model->level);
+        }
+        return;
+    }
+    if (offset == offsetof(I2C_Type, STATUS)) {
+        model->status &= ~*value;
+    } else if ((offset == offsetof(I2C_Type, DATA)) && (model->level < I2C_SOC_FIFO_SIZE)) {
+        model->fifo[model->level++] = (uint8_t)*value;
+    } else if (offset == offsetof(I2C_Type, CMD)) {
+        i2c_model_command(model, *value);
+    }
+}
+
+/* run the bus from the interrupt until the queue is empty, returns the interrupts taken */
+static uint32_t run_bus(hpm_i2c_bus_t *bus, uint32_t tick_steps)
+{
+    uint32_t irqs = 0;
+
+    for (uint32_t step = 1; (step < 100000U) && hpm_i2c_bus_is_busy(bus); step++) {
+        i2c_model_step(&s_model);
+        if (i2c_model_status(&s_model) & hpm_host_sim_peek(s_model.block, offsetof(I2C_Type, INTEN))) {
+            hpm_i2c_bus_isr_handler(bus);
+            irqs++;
+        }
+        if ((tick_steps != 0U) && ((step % tick_steps) == 0U)) {
+            hpm_i2c_bus_tick(bus);
+        }
+    }
+    return irqs;
+}
+
+static void trans_done(hpm_i2c_trans_t *trans, void *cb_context)
+{
+    (void)trans;
+    (void)cb_context;
+    s_callbacks++;
+}
+
+/* bitwise CRC-8, polynomial x^8 + x^2 + x + 1 */
+static uint8_t pec_reference(const uint8_t *data, uint32_t len)
+{
+    uint8_t crc = 0;
+
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint32_t bit = 0; bit < 8U; bit++) {
+            crc = (crc & 0x80U) ? (uint8_t)((crc << 1) ^ 0x07U) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/* register reads queued on the bus against the same reads through the blocking driver */
+static int test_queue_overhead(hpm_host_sim_block_t *block, I2C_Type *i2c, hpm_i2c_bus_t *bus)
+{
+    static const uint32_t dividers[] = { 1, 16 };
+    const hpm_i2c_device_t sensor = { .address = 0x50, .timeout_ticks = 0 };
+    hpm_i2c_trans_t trans[TEST_READS];
+    uint8_t reg[TEST_READS];
+    uint8_t rx[TEST_READS][2];
+    uint32_t blocking[2];
+    uint32_t queued[2];
+    uint32_t irqs = 0;
+
+    for (uint32_t i = 0; i < sizeof(s_sensor.regs); i++) {
+        s_sensor.regs[i] = (uint8_t)(i * 7U + 3U);
+    }
+
+    for (uint32_t d = 0; d < ARRAY_SIZE(dividers); d++) {
+        s_model.divider = dividers[d];
+        s_model.step_on_status = true;
+        hpm_host_sim_block_reset_stat(block);
+        for (uint32_t i = 0; i < TEST_READS; i++) {
+            reg[i] = (uint8_t)(TEST_REG + 2U * i);
+            CHECK(i2c_master_address_read(i2c, sensor.address, &reg[i], 1, rx[i], 2) == status_success);
+            CHECK((rx[i][0] == s_sensor.regs[reg[i]]) && (rx[i][1] == s_sensor.regs[reg[i] + 1U]));
+        }
+        blocking[d] = (block->reads + block->writes) / TEST_READS;
+        printf("blocking, %2u polls per bus step: %u register accesses per read, %u of them STATUS\n",
+               dividers[d], blocking[d], block->reg_reads[offsetof(I2C_Type, STATUS) / 4U] / TEST_READS);
+
+        s_model.step_on_status = false;
+        memset(rx, 0, sizeof(rx));
+        hpm_host_sim_block_reset_stat(block);
+        for (uint32_t i = 0; i < TEST_READS; i++) {
+            hpm_i2c_trans_write_read(&trans[i], &sensor, &reg[i], 1, rx[i], 2);
+            CHECK(hpm_i2c_bus_submit(bus, &trans[i], trans_done, NULL) == status_success);
+        }
+        CHECK(hpm_i2c_bus_submit(bus, &trans[0], trans_done, NULL) == status_i2c_trans_busy);
+        irqs = run_bus(bus, 0);
+        CHECK(!hpm_i2c_bus_is_busy(bus));
+        for (uint32_t i = 0; i < TEST_READS; i++) {
+            CHECK(trans[i].status == status_success);
+            CHECK((rx[i][0] == s_sensor.regs[reg[i]]) && (rx[i][1] == s_sensor.regs[reg[i] + 1U]));
+        }
+        queued[d] = (block->reads + block->writes) / TEST_READS;
+        printf("queued,   %2u polls per bus step: %u register accesses per read from %u interrupts\n",
+               dividers[d], queued[d], irqs / TEST_READS);
+    }
+    /* the queue only runs on events, the blocking driver spins with the bus */
+    CHECK(queued[1] == queued[0]);
+    CHECK(blocking[1] > blocking[0]);
+    CHECK(queued[1] < blocking[1]);
+    s_model.divider = 1;
+    return 0;
+}
+
+/* SMbus block write and read with PEC, checked against a bitwise CRC */
+static int test_smbus(hpm_i2c_bus_t *bus)
+{
+    const hpm_i2c_device_t battery = { .address = 0x0B, .timeout_ticks = 0 };
+    const uint8_t block_data[5] = { 'H', 'P', 'M', 'i', 'c' };
+    uint8_t frame[16];
+    uint8_t data[HPM_SMBUS_BLOCK_MAX];
+    hpm_smbus_xfer_t xfer;
+
+    memset(&xfer, 0, sizeof(xfer));
+    CHECK(hpm_smbus_async_write_block_in_command(bus, &xfer, &battery, 0x20, block_data, sizeof(block_data),
+                                                 NULL, NULL) == status_success);
+    run_bus(bus, 0);
+    CHECK(xfer.status == status_success);
+    /* addr + w, command, count, data, pec */
+    frame[0] = 0x0B << 1;
+    frame[1] = 0x20;
+    frame[2] = sizeof(block_data);
+    memcpy(&frame[3], block_data, sizeof(block_data));
+    CHECK(memcmp(&s_smbus.regs[0x20], &frame[2], sizeof(block_data) + 1U) == 0);
+    CHECK(s_smbus.regs[0x20 + sizeof(block_data) + 1U] == pec_reference(frame, sizeof(block_data) + 3U));
+
+    /* the device answers with count, data and the pec over addr + w, command, addr + r, count, data */
+    frame[0] = 0x0B << 1;
+    frame[1] = 0x40;
+    frame[2] = (0x0B << 1) | 1U;
+    frame[3] = 3;
+    frame[4] = 0x12;
+    frame[5] = 0x34;
+    frame[6] = 0x56;
+    memcpy(&s_smbus.regs[0x40], &frame[3], 4);
+    s_smbus.regs[0x44] = pec_reference(frame, 7);
+    CHECK(hpm_smbus_async_read_block_in_command(bus, &xfer, &battery, 0x40, data, sizeof(data),
+                                                NULL, NULL) == status_success);
+    run_bus(bus, 0);
+    CHECK(xfer.status == status_success);
+    CHECK((xfer.size == 3U) && (data[0] == 0x12) && (data[1] == 0x34) && (data[2] == 0x56));
+
+    s_smbus.regs[0x44] ^= 0x01U;
+    CHECK(hpm_smbus_async_read_block_in_command(bus, &xfer, &battery, 0x40, data, sizeof(data),
+                                                NULL, NULL) == status_success);
+    run_bus(bus, 0);
+    CHECK(xfer.status == status_fail);
+    printf("smbus: block write and block read PEC match the reference, a corrupted PEC fails\n");
+    return 0;
+}
+
+/* a missing device, a stuck device and a 10-bit device ahead of 7-bit ones */
+static int test_errors(hpm_i2c_bus_t *bus)
+{
+    const hpm_i2c_device_t missing = { .address = 0x33, .timeout_ticks = 0 };
+    const hpm_i2c_device_t stuck = { .address = 0x21, .timeout_ticks = 3 };
+    const hpm_i2c_device_t wide = { .address = 0x2A5, .is_10bit_addressing = true, .timeout_ticks = 0 };
+    const hpm_i2c_device_t sensor = { .address = 0x50, .timeout_ticks = 0 };
+    hpm_i2c_trans_t trans[4];
+    hpm_i2c_bus_stat_t before = bus->stat;
+    uint8_t reg = TEST_REG;
+    uint8_t rx[4][2];
+
+    hpm_i2c_trans_write_read(&trans[0], &missing, &reg, 1, rx[0], 2);
+    hpm_i2c_trans_write_read(&trans[1], &stuck, &reg, 1, rx[1], 2);
+    hpm_i2c_trans_write_read(&trans[2], &wide, &reg, 1, rx[2], 2);
+    hpm_i2c_trans_write_read(&trans[3], &sensor, &reg, 1, rx[3], 2);
+    for (uint32_t i = 0; i < 4U; i++) {
+        CHECK(hpm_i2c_bus_submit(bus, &trans[i], trans_done, NULL) == status_success);
+    }
+    run_bus(bus, 50);
+    CHECK(!hpm_i2c_bus_is_busy(bus));
+    /* the write segment had no STOP, the queue sends one before moving on */
+    CHECK(trans[0].status == status_i2c_no_addr_hit);
+    CHECK(trans[1].status == status_timeout);
+    CHECK(trans[2].status == status_success);
+    CHECK(rx[2][0] == s_wide.regs[TEST_REG]);
+    /* 7-bit addressing is restored after the 10-bit device */
+    CHECK(trans[3].status == status_success);
+    CHECK(rx[3][0] == s_sensor.regs[TEST_REG]);
+    CHECK(!s_model.bus_busy);
+    CHECK(bus->stat.errors == before.errors + 1U);
+    CHECK(bus->stat.timeouts == before.timeouts + 1U);
+    CHECK(bus->stat.transfers == before.transfers + 2U);
+    printf("errors: no address hit, timeout and 10-bit then 7-bit addressing\n");
+    return 0;
+}
+
+int main(void)
+{
+    hpm_host_sim_block_t *block;
+    hpm_i2c_bus_t bus;
+    I2C_Type *i2c;
+
+    block = hpm_host_sim_block_create(sizeof(I2C_Type), i2c_model_hook, &s_model);
+    CHECK(block != NULL);
+    i2c = (I2C_Type *)block->base;
+    s_model.block = block;
+    s_model.divider = 1;
+    s_model.targets[0] = &s_sensor;
+    s_model.targets[1] = &s_smbus;
+    s_model.targets[2] = &s_wide;
+    s_model.targets[3] = &s_stuck;
+    for (uint32_t i = 0; i < sizeof(s_wide.regs); i++) {
+        s_wide.regs[i] = (uint8_t)~i;
+    }
+
+    hpm_i2c_bus_init(&bus, i2c);
+    CHECK(test_queue_overhead(block, i2c, &bus) == 0);
+    CHECK(s_callbacks == 2U * TEST_READS);
+    CHECK(bus.stat.max_queued == TEST_READS);
+    CHECK(test_smbus(&bus) == 0);
+    CHECK(test_errors(&bus) == 0);
+
+    hpm_host_sim_block_destroy(block);
+    return 0;
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_ipc_event_queue.h"
+
+/*
+ * IPC event queue between two threads over one ring: the ring is configured
+ * as both the tx and the rx ring, the main thread posts as the local core and
+ * the other thread drains as the remote one, taking the doorbell the queue
+ * raises through ipc_tigger_event() as its mailbox interrupt. Both threads
+ * yield whenever they wait, so the harness also runs on one CPU.
+ * First, single threaded, an event of the largest payload is posted into the
+ * drained ring at every head offset, which must succeed, and one byte more
+ * must be rejected. Then TEST_EVENTS events of random type and size up to
+ * the largest payload are posted, retried while the ring is full, and each
+ * must arrive once, in order, with its payload. Reports events per second,
+ * doorbells per event and the post to dispatch latency.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_DATA_SIZE   (256U)
+#define TEST_MAX_PAYLOAD IPC_EVENT_QUEUE_MAX_PAYLOAD(TEST_DATA_SIZE)
+#define TEST_EVENTS      (500000U)
+#define TEST_TYPES       (4U)
+
+typedef struct {
+    uint32_t seq;
+    uint16_t type;
+    uint16_t size;
+} test_header_t;
+
+static uint8_t s_ring[IPC_EVENT_QUEUE_RING_MEM_SIZE(TEST_DATA_SIZE)] __attribute__((aligned(8)));
+static ipc_event_callback_t s_doorbell_handler;
+static void *s_doorbell_context;
+static uint32_t s_doorbell;
+static uint32_t s_stop;
+static uint32_t s_seed = 1;
+
+/* written by the remote thread only */
+static uint32_t s_received;
+static uint32_t s_next_seq;
+static uint32_t s_errors;
+
+hpm_stat_t ipc_register_event(ipc_event_type_t type, ipc_event_callback_t callback, void *callback_data)
+{
+    if (type != ipc_remote_queue_event) {
+        return status_invalid_argument;
+    }
+    s_doorbell_handler = callback;
+    s_doorbell_context = callback_data;
+    return status_success;
+}
+
+hpm_stat_t ipc_tigger_event(ipc_event_type_t type, uint16_t event_data)
+{
+    (void)event_data;
+    if (type != ipc_remote_queue_event) {
+        return status_invalid_argument;
+    }
+    __atomic_store_n(&s_doorbell, 1U, __ATOMIC_RELEASE);
+    return status_success;
+}
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t timestamp_us(void)
+{
+    return (uint32_t)(now_ns() / 1000U);
+}
+
+/* payload bytes after the header follow from the sequence number */
+static uint8_t payload_byte(uint32_t seq, uint32_t i)
+{
+    return (uint8_t)(seq * 7U + i);
+}
+
+static void event_cb(uint16_t type, const void *payload, uint16_t size, void *context)
+{
+    const uint8_t *bytes = (const uint8_t *)payload;
+    test_header_t header = { 0 };
+
+    (void)context;
+    if (size >= sizeof(header)) {
+        memcpy(&header, payload, sizeof(header));
+        for (uint32_t i = sizeof(header); i < size; i++) {
+            if (bytes[i] != payload_byte(header.seq, i)) {
+                s_errors++;
+                break;
+            }
+        }
+        if ((header.seq != s_next_seq) || (header.type != type) || (header.size != size)) {
+            s_errors++;
+        }
+    } else if (size != 0U) {
+        s_errors++;
+    }
+    s_next_seq++;
+    __atomic_store_n(&s_received, s_received + 1U, __ATOMIC_RELEASE);
+}
+
+static void *remote_thread(void *arg)
+{
+    (void)arg;
+    while (__atomic_load_n(&s_stop, __ATOMIC_ACQUIRE) == 0U) {
+        if (__atomic_exchange_n(&s_doorbell, 0U, __ATOMIC_ACQ_REL) != 0U) {
+            s_doorbell_handler(0, s_doorbell_context);
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* events below the header size carry no sequence number, they are sent as zero payload */
+static hpm_stat_t post(uint32_t seq, uint16_t type, uint16_t size)
+{
+    static uint8_t payload[TEST_DATA_SIZE];
+    test_header_t header = { seq, type, size };
+
+    if (size < sizeof(header)) {
+        size = 0;
+        header.size = 0;
+    }
+    memcpy(payload, &header, sizeof(header));
+    for (uint32_t i = sizeof(header); i < size; i++) {
+        payload[i] = payload_byte(seq, i);
+    }
+    return ipc_event_queue_post(type, payload, size);
+}
+
+static void wait_received(uint32_t count)
+{
+    while (__atomic_load_n(&s_received, __ATOMIC_ACQUIRE) != count) {
+        sched_yield();
+    }
+}
+
+int main(void)
+{
+    ipc_event_queue_config_t config;
+    ipc_event_queue_stat_t stat;
+    uint32_t posted = 0;
+    uint32_t full = 0;
+    uint32_t doorbells;
+    uint32_t received = 0;
+    uint32_t dropped = 0;
+    uint64_t latency_sum = 0;
+    uint32_t latency_max = 0;
+    uint64_t start;
+    double elapsed;
+    pthread_t remote;
+    hpm_stat_t stat_post;
+
+    ipc_event_queue_get_default_config(&config);
+    config.tx_ring = s_ring;
+    config.tx_ring_size = sizeof(s_ring);
+    config.rx_ring = s_ring;
+    config.rx_ring_size = sizeof(s_ring);
+    config.timestamp = timestamp_us;
+    CHECK(ipc_event_queue_init(&config) == status_success);
+    CHECK(s_doorbell_handler != NULL);
+    for (uint16_t type = 0; type < TEST_TYPES; type++) {
+        CHECK(ipc_event_queue_register(type, event_cb, NULL) == status_success);
+    }
+
+    /* the largest event fits a drained ring wherever the head is, one byte more never does */
+    CHECK(post(0, 0, TEST_MAX_PAYLOAD + 1U) == status_invalid_argument);
+    for (uint32_t offset = 0; offset < TEST_DATA_SIZE; offset += 8U) {
+        CHECK(post(posted++, 0, TEST_MAX_PAYLOAD) == status_success);
+        CHECK(ipc_event_queue_process(UINT32_MAX) == 1U);
+        /* one 8 byte event moves the head on */
+        CHECK(post(posted++, 1, 0) == status_success);
+        CHECK(ipc_event_queue_process(UINT32_MAX) == 1U);
+    }
+    CHECK((s_errors == 0U) && (s_received == posted));
+    ipc_event_queue_reset_stat();
+    doorbells = ipc_event_queue_get_doorbell_count();
+
+    CHECK(pthread_create(&remote, NULL, remote_thread, NULL) == 0);
+    start = now_ns();
+    for (uint32_t n = 0; n < TEST_EVENTS; n++) {
+        uint16_t type = (uint16_t)(rnd() % TEST_TYPES);
+        uint16_t size = (uint16_t)(rnd() % (TEST_MAX_PAYLOAD + 1U));
+
+        while ((stat_post = post(posted, type, size)) == status_ipc_event_queue_full) {
+            /* the remote thread frees the ring as it drains */
+            full++;
+            sched_yield();
+        }
+        if (stat_post != status_success) {
+            __atomic_store_n(&s_stop, 1U, __ATOMIC_RELEASE);
+            pthread_join(remote, NULL);
+            CHECK(stat_post == status_success);
+        }
+        posted++;
+    }
+    wait_received(posted);
+    elapsed = (double)(now_ns() - start);
+    __atomic_store_n(&s_stop, 1U, __ATOMIC_RELEASE);
+    pthread_join(remote, NULL);
+
+    CHECK(s_errors == 0U);
+    doorbells = ipc_event_queue_get_doorbell_count() - doorbells;
+    for (uint16_t type = 0; type < TEST_TYPES; type++) {
+        CHECK(ipc_event_queue_get_stat(type, &stat) == status_success);
+        CHECK(stat.posted == stat.received);
+        received += stat.received;
+        dropped += stat.dropped;
+        latency_sum += stat.latency_sum;
+        latency_max = MAX(latency_max, stat.latency_max);
+    }
+    CHECK((received == TEST_EVENTS) && (dropped == full));
+    CHECK((doorbells >= 1U) && (doorbells <= TEST_EVENTS));
+
+    printf("%u byte ring, payloads 0 - %u bytes: %.0f events/s, %.3f doorbells per event, "
+           "%u posts found the ring full, latency %.1f us mean %u us max\n",
+           (unsigned int)TEST_DATA_SIZE, (unsigned int)TEST_MAX_PAYLOAD, TEST_EVENTS * 1e9 / elapsed,
+           (double)doorbells / TEST_EVENTS, (unsigned int)full, (double)latency_sum / received,
+           (unsigned int)latency_max);
+    return 0;
+}
@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "hpm_jpeg_stream.h"
+
+/*
+ * libjpeg backend of the JPEG stream, built against the libjpeg of the tree.
+ * A synthetic TEST_WIDTH x TEST_HEIGHT image, RGB565 and Y8, is encoded in
+ * bands of 1 - TEST_HEIGHT rows through a TEST_CHUNK byte chunk buffer and
+ * decoded again into strips of the same height. The bitstream must not
+ * depend on the band height, every strip height must decode to the same
+ * image, strips must arrive in order with at most strip_rows rows, and the
+ * image must come back at a minimum PSNR per format. Errors from the sink,
+ * the strip callback, a short strip buffer and a truncated stream must
+ * release everything the backend allocated.
+ * malloc, calloc and free are wrapped at link time: reports per strip height the
+ * peak heap of libjpeg and the backend, the buffers the caller provides and
+ * the encode and decode rate in Mpixel/s (host figures).
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_WIDTH           (320U)
+#define TEST_HEIGHT          (240U)
+#define TEST_CHUNK           (512U)
+#define TEST_QUALITY         (80U)
+#define TEST_MIN_PSNR_RGB565 (28.0)   /* 4:2:0 chroma on the saturated boxes */
+#define TEST_MIN_PSNR_Y8     (40.0)
+#define TEST_RUNS            (5U)
+#define TEST_MAX_JPEG        (TEST_WIDTH * TEST_HEIGHT * 2U)
+
+/* size header in front of every block, keeps the 16 byte alignment of malloc */
+#define HEAP_HEADER (16U)
+
+void *__real_malloc(size_t size);
+void __real_free(void *ptr);
+
+typedef struct {
+    uint32_t rows;
+    uint32_t strips;
+    uint32_t next_y;
+    uint32_t strip_rows;
+    uint32_t abort_at;          /* strip callback returns false for this strip, 0 never */
+    uint32_t errors;
+} test_dec_t;
+
+static const uint32_t s_strip_rows[] = { 1, 8, 16, 32, 64, TEST_HEIGHT };
+
+static uint8_t s_image[TEST_WIDTH * TEST_HEIGHT * 2U];
+static uint8_t s_decoded[TEST_WIDTH * TEST_HEIGHT * 2U];
+static uint8_t s_reference[TEST_WIDTH * TEST_HEIGHT * 2U];
+static uint8_t s_jpeg[TEST_MAX_JPEG];
+static uint8_t s_reference_jpeg[TEST_MAX_JPEG];
+static uint8_t s_chunk[TEST_CHUNK];
+static uint8_t s_strip_buf[TEST_WIDTH * TEST_HEIGHT * 2U];
+static uint32_t s_jpeg_len;
+static uint32_t s_jpeg_pos;
+static uint32_t s_jpeg_end;
+static uint32_t s_sink_limit;
+static uint32_t s_pitch;
+static size_t s_heap_live;
+static size_t s_heap_peak;
+static uint32_t s_seed = 1;
+
+void *__wrap_malloc(size_t size)
+{
+    uint8_t *p = (uint8_t *)__real_malloc(size + HEAP_HEADER);
+
+    if (p == NULL) {
+        return NULL;
+    }
+    memcpy(p, &size, sizeof(size));
+    s_heap_live += size;
+    if (s_heap_live > s_heap_peak) {
+        s_heap_peak = s_heap_live;
+    }
+    return p + HEAP_HEADER;
+}
+
+/* the compiler turns malloc and memset into calloc */
+void *__wrap_calloc(size_t count, size_t size)
+{
+    void *p = __wrap_malloc(count * size);
+
+    if (p != NULL) {
+        memset(p, 0, count * size);
+    }
+    return p;
+}
+
+void __wrap_free(void *ptr)
+{
+    size_t size;
+
+    if (ptr == NULL) {
+        return;
+    }
+    memcpy(&size, (uint8_t *)ptr - HEAP_HEADER, sizeof(size));
+    s_heap_live -= size;
+    __real_free((uint8_t *)ptr - HEAP_HEADER);
+}
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static void heap_reset_peak(void)
+{
+    s_heap_peak = s_heap_live;
+}
+
+/* gradients, a few sharp edged boxes and some noise */
+static void make_image(display_pixel_format_t format)
+{
+    uint16_t *rgb = (uint16_t *)s_image;
+    uint32_t r, g, b;
+    bool box;
+
+    for (uint32_t y = 0; y < TEST_HEIGHT; y++) {
+        for (uint32_t x = 0; x < TEST_WIDTH; x++) {
+            box = (((x / 40U) + (y / 40U)) % 5U) == 0U;
+            r = box ? 230U : (x * 255U / TEST_WIDTH);
+            g = box ? 40U : (y * 255U / TEST_HEIGHT);
+            b = box ? 90U : (((x + y) * 255U) / (TEST_WIDTH + TEST_HEIGHT));
+            r = MIN(255U, r + (rnd() & 7U));
+            if (format == display_pixel_format_y8) {
+                s_image[y * TEST_WIDTH + x] = (uint8_t)((r * 77U + g * 150U + b * 29U) >> 8);
+            } else {
+                rgb[y * TEST_WIDTH + x] = (uint16_t)(((r & 0xF8U) << 8) | ((g & 0xFCU) << 3) | (b >> 3));
+            }
+        }
+    }
+}
+
+/* PSNR over the 8 bit channel values */
+static double psnr(display_pixel_format_t format)
+{
+    double sum = 0;
+    double d;
+    uint32_t n;
+
+    if (format == display_pixel_format_y8) {
+        n = TEST_WIDTH * TEST_HEIGHT;
+        for (uint32_t i = 0; i < n; i++) {
+            d = (double)s_image[i] - (double)s_decoded[i];
+            sum += d * d;
+        }
+    } else {
+        const uint16_t *a = (const uint16_t *)s_image;
+        const uint16_t *b = (const uint16_t *)s_decoded;
+
+        n = TEST_WIDTH * TEST_HEIGHT * 3U;
+        for (uint32_t i = 0; i < TEST_WIDTH * TEST_HEIGHT; i++) {
+            d = (double)((a[i] >> 8) & 0xF8U) - (double)((b[i] >> 8) & 0xF8U);
+            sum += d * d;
+            d = (double)((a[i] >> 3) & 0xFCU) - (double)((b[i] >> 3) & 0xFCU);
+            sum += d * d;
+            d = (double)((a[i] << 3) & 0xF8U) - (double)((b[i] << 3) & 0xF8U);
+            sum += d * d;
+        }
+    }
+    if (sum == 0) {
+        return 99.0;
+    }
+    return 10.0 * log10(255.0 * 255.0 * n / sum);
+}
+
+static bool sink(void *context, const uint8_t *data, uint32_t len)
+{
+    (void)context;
+    if ((s_jpeg_len + len > sizeof(s_jpeg)) || (s_jpeg_len + len > s_sink_limit)) {
+        return false;
+    }
+    memcpy(&s_jpeg[s_jpeg_len], data, len);
+    s_jpeg_len += len;
+    return true;
+}
+
+static uint32_t source(void *context, uint8_t *buf, uint32_t size)
+{
+    uint32_t n = MIN(size, s_jpeg_end - s_jpeg_pos);
+
+    (void)context;
+    memcpy(buf, &s_jpeg[s_jpeg_pos], n);
+    s_jpeg_pos += n;
+    return n;
+}
+
+static bool strip(void *context, const uint8_t *pixels, uint32_t y, uint32_t rows)
+{
+    test_dec_t *dec = (test_dec_t *)context;
+
+    dec->strips++;
+    if ((dec->abort_at != 0U) && (dec->strips == dec->abort_at)) {
+        return false;
+    }
+    if ((y != dec->next_y) || (rows == 0U) || (rows > dec->strip_rows) || (y + rows > TEST_HEIGHT)) {
+        dec->errors++;
+        return true;
+    }
+    /* every strip but the last one is full */
+    if ((rows != dec->strip_rows) && (y + rows != TEST_HEIGHT)) {
+        dec->errors++;
+    }
+    memcpy(&s_decoded[y * s_pitch], pixels, rows * s_pitch);
+    dec->next_y += rows;
+    dec->rows += rows;
+    return true;
+}
+
+static hpm_stat_t encode(display_pixel_format_t format, uint32_t strip_rows)
+{
+    hpm_jpeg_stream_enc_config_t config;
+    hpm_jpeg_stream_enc_t enc;
+    hpm_stat_t stat;
+    uint32_t rows;
+
+    hpm_jpeg_stream_get_default_enc_config(&config);
+    config.backend = hpm_jpeg_stream_backend_sw;
+    config.pixel_format = format;
+    config.width = TEST_WIDTH;
+    config.height = TEST_HEIGHT;
+    config.strip_rows = (uint16_t)strip_rows;
+    config.quality = TEST_QUALITY;
+    config.out_buf = s_chunk;
+    config.out_size = sizeof(s_chunk);
+    config.sink = sink;
+    s_jpeg_len = 0;
+    stat = hpm_jpeg_stream_enc_start(&enc, &config);
+    for (uint32_t y = 0; (y < TEST_HEIGHT) && (stat == status_success); y += rows) {
+        rows = MIN(strip_rows, TEST_HEIGHT - y);
+        stat = hpm_jpeg_stream_enc_write(&enc, &s_image[y * s_pitch], rows);
+    }
+    if (stat == status_success) {
+        stat = hpm_jpeg_stream_enc_finish(&enc);
+    }
+    return stat;
+}
+
+static hpm_stat_t decode(display_pixel_format_t format, uint32_t strip_rows, uint32_t strip_size, uint32_t abort_at,
+                         test_dec_t *dec, hpm_jpeg_stream_dec_info_t *info)
+{
+    hpm_jpeg_stream_dec_config_t config;
+
+    hpm_jpeg_stream_get_default_dec_config(&config);
+    config.backend = hpm_jpeg_stream_backend_sw;
+    config.pixel_format = format;
+    config.strip_rows = (uint16_t)strip_rows;
+    config.in_buf = s_chunk;
+    config.in_size = sizeof(s_chunk);
+    config.strip_buf = s_strip_buf;
+    config.strip_size = strip_size;
+    config.source = source;
+    config.strip = strip;
+    config.context = dec;
+    memset(dec, 0, sizeof(*dec));
+    dec->strip_rows = strip_rows;
+    dec->abort_at = abort_at;
+    s_jpeg_pos = 0;
+    return hpm_jpeg_stream_decode(&config, info);
+}
+
+static int test_errors(display_pixel_format_t format)
+{
+    hpm_jpeg_stream_dec_info_t info;
+    test_dec_t dec;
+    hpm_stat_t stat;
+
+    /* sink full after the header, in the middle and just before EOI */
+    for (uint32_t limit = TEST_CHUNK; limit < s_jpeg_end; limit += s_jpeg_end / 3U) {
+        s_sink_limit = limit;
+        CHECK(encode(format, 16) == status_jpeg_stream_aborted);
+        CHECK(s_heap_live == 0U);
+    }
+    s_sink_limit = UINT32_MAX;
+    CHECK(encode(format, 16) == status_success);
+    CHECK(s_jpeg_len == s_jpeg_end);
+
+    /* strip callback aborts on the first, a middle and the last strip */
+    for (uint32_t abort_at = 1; abort_at <= TEST_HEIGHT / 16U; abort_at += 7U) {
+        CHECK(decode(format, 16, sizeof(s_strip_buf), abort_at, &dec, &info) == status_jpeg_stream_aborted);
+        CHECK(dec.strips == abort_at);
+        CHECK(s_heap_live == 0U);
+    }
+
+    /* a strip buffer one byte short of the strip */
+    CHECK(decode(format, 16, 16U * s_pitch - 1U, 0, &dec, &info) == status_jpeg_stream_overflow);
+    CHECK((dec.strips == 0U) && (s_heap_live == 0U));
+
+    /* truncated stream: the rest reads as EOI, the image is still delivered in full */
+    s_jpeg_end = s_jpeg_len / 2U;
+    stat = decode(format, 16, sizeof(s_strip_buf), 0, &dec, &info);
+    CHECK(stat == status_success);
+    CHECK((dec.errors == 0U) && (dec.rows == TEST_HEIGHT) && (s_heap_live == 0U));
+
+    /* not a JPEG stream */
+    s_jpeg_end = 0;
+    CHECK(decode(format, 16, sizeof(s_strip_buf), 0, &dec, &info) != status_success);
+    CHECK((dec.strips == 0U) && (s_heap_live == 0U));
+    s_jpeg_end = s_jpeg_len;
+    return 0;
+}
+
+static int test_format(display_pixel_format_t format, const char *name, double min_psnr)
+{
+    hpm_jpeg_stream_dec_info_t info;
+    test_dec_t dec;
+    uint64_t start;
+    uint64_t enc_ns;
+    uint64_t dec_ns;
+    size_t enc_peak;
+    size_t dec_peak;
+    uint32_t reference_len = 0;
+    double quality;
+
+    s_pitch = TEST_WIDTH * display_get_pixel_size_in_byte(format);
+    make_image(format);
+    s_sink_limit = UINT32_MAX;
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(s_strip_rows); i++) {
+        uint32_t strip_rows = s_strip_rows[i];
+
+        enc_ns = UINT64_MAX;
+        dec_ns = UINT64_MAX;
+        enc_peak = 0;
+        dec_peak = 0;
+        for (uint32_t run = 0; run < TEST_RUNS; run++) {
+            heap_reset_peak();
+            start = now_ns();
+            CHECK(encode(format, strip_rows) == status_success);
+            enc_ns = MIN(enc_ns, now_ns() - start);
+            CHECK(s_heap_live == 0U);
+            enc_peak = MAX(enc_peak, s_heap_peak);
+
+            memset(s_decoded, 0, sizeof(s_decoded));
+            s_jpeg_end = s_jpeg_len;
+            heap_reset_peak();
+            start = now_ns();
+            CHECK(decode(format, strip_rows, strip_rows * s_pitch, 0, &dec, &info) == status_success);
+            dec_ns = MIN(dec_ns, now_ns() - start);
+            CHECK(s_heap_live == 0U);
+            dec_peak = MAX(dec_peak, s_heap_peak);
+        }
+        CHECK(dec.errors == 0U);
+        CHECK((dec.rows == TEST_HEIGHT) && (dec.strips == (TEST_HEIGHT + strip_rows - 1U) / strip_rows));
+        CHECK((info.width == TEST_WIDTH) && (info.height == TEST_HEIGHT));
+        CHECK((info.strip_rows == strip_rows) && (info.strips == dec.strips) && (info.bytes == s_jpeg_len));
+
+        /* the band height changes neither the stream nor the decoded image */
+        if (i == 0U) {
+            reference_len = s_jpeg_len;
+            memcpy(s_reference_jpeg, s_jpeg, s_jpeg_len);
+            memcpy(s_reference, s_decoded, sizeof(s_decoded));
+            quality = psnr(format);
+            CHECK(quality >= min_psnr);
+            printf("%s %ux%u, quality %u: %u bytes, %.2f bits/pixel, PSNR %.1f dB\n", name,
+                   (unsigned int)TEST_WIDTH, (unsigned int)TEST_HEIGHT, (unsigned int)TEST_QUALITY,
+                   (unsigned int)s_jpeg_len, s_jpeg_len * 8.0 / (TEST_WIDTH * TEST_HEIGHT), quality);
+        } else {
+            CHECK((s_jpeg_len == reference_len) && (memcmp(s_jpeg, s_reference_jpeg, s_jpeg_len) == 0));
+            CHECK(memcmp(s_decoded, s_reference, sizeof(s_decoded)) == 0);
+        }
+
+        printf("  %3u row strips: heap peak encode %6u decode %6u bytes, strip buffer %6u + chunk %u bytes, "
+               "encode %.1f decode %.1f Mpixel/s\n",
+               (unsigned int)strip_rows, (unsigned int)enc_peak, (unsigned int)dec_peak,
+               (unsigned int)(strip_rows * s_pitch), (unsigned int)TEST_CHUNK,
+               TEST_WIDTH * TEST_HEIGHT * 1e3 / enc_ns, TEST_WIDTH * TEST_HEIGHT * 1e3 / dec_ns);
+    }
+
+    /* error paths on the stream of the last run */
+    s_jpeg_end = s_jpeg_len;
+    return test_errors(format);
+}
+
+int main(void)
+{
+    hpm_jpeg_stream_enc_config_t config;
+    hpm_jpeg_stream_enc_t enc;
+
+    /* the hardware backend is not built in */
+    hpm_jpeg_stream_get_default_enc_config(&config);
+    config.width = TEST_WIDTH;
+    config.height = TEST_HEIGHT;
+    config.out_buf = s_chunk;
+    config.out_size = sizeof(s_chunk);
+    config.sink = sink;
+    CHECK(hpm_jpeg_stream_enc_start(&enc, &config) == status_jpeg_stream_unsupported);
+
+    if (test_format(display_pixel_format_rgb565, "RGB565", TEST_MIN_PSNR_RGB565) != 0) {
+        return 1;
+    }
+    if (test_format(display_pixel_format_y8, "Y8", TEST_MIN_PSNR_Y8) != 0) {
+        return 1;
+    }
+    return 0;
+}
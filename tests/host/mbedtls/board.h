@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _HPM_HOST_TEST_BOARD_H
+#define _HPM_HOST_TEST_BOARD_H
+
+/* board.h of the mbedtls sample on the host, the SDP port only needs the core */
+#include "hpm_common.h"
+#include "hpm_soc.h"
+
+#define BOARD_RUNNING_CORE HPM_CORE0
+
+#endif /* _HPM_HOST_TEST_BOARD_H */
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_MBEDTLS_CONFIG_H
+#define HPM_HOST_MBEDTLS_CONFIG_H
+
+/*
+ * mbedtls configuration of the SDP port host test: the SDP block of
+ * samples/mbedtls hpm_sdk_mbedtls_config.h and the modules it plugs into.
+ */
+
+/* SDP port, as in the sample */
+#define MBEDTLS_AES_ALT
+#define MBEDTLS_AES_SETKEY_ENC_ALT
+#define MBEDTLS_AES_SETKEY_DEC_ALT
+#define MBEDTLS_AES_ENCRYPT_ALT
+#define MBEDTLS_AES_DECRYPT_ALT
+#define MBEDTLS_AES_CRYPT_CBC_ALT
+#define MBEDTLS_AES_CRYPT_CTR_ALT
+#define MBEDTLS_AES192_ALT_SW
+
+#define MBEDTLS_CCM_CRYPT_ALT
+
+#define MBEDTLS_SHA1_C
+#define MBEDTLS_SHA1_ALT
+#define MBEDTLS_HPM_SDP_SHA1
+
+#define MBEDTLS_SHA256_C
+#define MBEDTLS_SHA256_ALT
+#define MBEDTLS_HPM_SHA224_ALT_SW
+#define MBEDTLS_HPM_SDP_SHA256
+
+#define MBEDTLS_AES_ROM_TABLES
+
+/* modules on top of the port */
+#define MBEDTLS_AES_C
+#define MBEDTLS_CIPHER_C
+#define MBEDTLS_CIPHER_MODE_CBC
+#define MBEDTLS_CIPHER_MODE_CTR
+#define MBEDTLS_CCM_C
+#define MBEDTLS_MD_C
+
+#include "mbedtls/check_config.h"
+
+#endif /* HPM_HOST_MBEDTLS_CONFIG_H */
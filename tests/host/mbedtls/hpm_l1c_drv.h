@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _HPM_L1_CACHE_H
+#define _HPM_L1_CACHE_H
+
+/*
+ * hpm_l1c_drv.h of HPM6280 on the host, the CSR accesses replaced: the test
+ * turns the D-cache on and off and counts the maintenance calls, calls on
+ * ranges that are not cache line aligned are counted apart.
+ */
+#include "hpm_common.h"
+#include "hpm_soc.h"
+
+#define HPM_L1C_CACHELINE_SIZE (64)
+
+#define HPM_L1C_CACHELINE_ALIGN_DOWN(n) ((uint32_t)(n) & ~(HPM_L1C_CACHELINE_SIZE - 1U))
+#define HPM_L1C_CACHELINE_ALIGN_UP(n)   HPM_L1C_CACHELINE_ALIGN_DOWN((uint32_t)(n) + HPM_L1C_CACHELINE_SIZE - 1U)
+
+typedef struct {
+    bool dc_enabled;
+    uint32_t writebacks;
+    uint32_t invalidates;
+    uint32_t unaligned;
+} hpm_host_l1c_t;
+
+extern hpm_host_l1c_t hpm_host_l1c;
+
+static inline bool l1c_dc_is_enabled(void)
+{
+    return hpm_host_l1c.dc_enabled;
+}
+
+static inline void hpm_host_l1c_check(uint32_t address, uint32_t size)
+{
+    if (((address | size) & (HPM_L1C_CACHELINE_SIZE - 1U)) != 0U) {
+        hpm_host_l1c.unaligned++;
+    }
+}
+
+static inline void l1c_dc_invalidate(uint32_t address, uint32_t size)
+{
+    hpm_host_l1c_check(address, size);
+    hpm_host_l1c.invalidates++;
+}
+
+static inline void l1c_dc_writeback(uint32_t address, uint32_t size)
+{
+    hpm_host_l1c_check(address, size);
+    hpm_host_l1c.writebacks++;
+}
+
+#endif /* _HPM_L1_CACHE_H */
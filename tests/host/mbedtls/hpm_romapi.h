@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_ROMAPI_H
+#define HPM_ROMAPI_H
+
+/*
+ * SDP part of hpm_romapi.h on the host. There is no ROM API table, the ROM
+ * runs the SDP driver on HPM_SDP, so do these against the SDP model.
+ */
+#include "hpm_common.h"
+#include "hpm_soc.h"
+#include "hpm_sdp_drv.h"
+
+static inline void rom_sdp_init(void)
+{
+    (void) sdp_init(HPM_SDP);
+}
+
+static inline void rom_sdp_deinit(void)
+{
+    (void) sdp_deinit(HPM_SDP);
+}
+
+static inline hpm_stat_t rom_sdp_hash_init(sdp_hash_ctx_t *hash_ctx, sdp_hash_alg_t alg)
+{
+    return sdp_hash_init(HPM_SDP, hash_ctx, alg);
+}
+
+static inline hpm_stat_t rom_sdp_hash_update(sdp_hash_ctx_t *hash_ctx, const uint8_t *data, uint32_t length)
+{
+    return sdp_hash_update(HPM_SDP, hash_ctx, data, length);
+}
+
+static inline hpm_stat_t rom_sdp_hash_finish(sdp_hash_ctx_t *hash_ctx, uint8_t *digest)
+{
+    return sdp_hash_finish(HPM_SDP, hash_ctx, digest);
+}
+
+#endif /* HPM_ROMAPI_H */
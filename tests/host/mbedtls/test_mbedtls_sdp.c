@@ -0,0 +1,532 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include "hpm_host_sim_sdp.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/ccm.h"
+#include "mbedtls/md.h"
+#include "mbedtls/sha1.h"
+#include "mbedtls/sha256.h"
+#include "hpm_l1c_drv.h"
+
+/*
+ * mbedtls SDP port against the SDP model at HPM_SDP, the driver runs
+ * unmodified, results are checked against the host libcrypto.
+ * AES: CBC of aligned, unaligned, short and long buffers with the D-cache
+ * on and off must take the SDP in place in one packet where the buffers
+ * allow it and the bounce buffer otherwise, with aligned cache maintenance.
+ * CTR streamed in random pieces must encrypt a chunk of counter blocks per
+ * packet. Key slot cache: contexts taking turns load their key once while
+ * they fit the slots, are evicted beyond that, a new key or mbedtls_aes_free
+ * drops the slot. CCM with the SDP for AES-128 and AES-256 with a tag, the
+ * software fallback for AES-192 and CCM* without tag, tag mismatch.
+ * SHA-1 and SHA-256 one-shot and in random pieces, SHA-224 (software),
+ * HMAC-SHA-256 through mbedtls_md. Reports SDP packets and register
+ * accesses per KiB.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_BUF_SIZE     (8192U)
+#define TEST_KEY_CONTEXTS (10U)
+#define TEST_CTR_BYTES    (6000U)
+#define TEST_BOUNCE_SIZE  (512U)                  /* HPM_SDP_AES_BOUNCE_SIZE */
+#define TEST_CTR_BLOCKS   (TEST_BOUNCE_SIZE / 16U)
+#define TEST_KEY_SLOTS    (8U)                    /* HPM_SDP_AES_KEY_SLOT_COUNT */
+
+hpm_host_l1c_t hpm_host_l1c;
+
+static hpm_host_sim_sdp_t s_sdp;
+static ATTR_ALIGN(64) uint8_t s_src[TEST_BUF_SIZE + 64U];
+static ATTR_ALIGN(64) uint8_t s_dst[TEST_BUF_SIZE + 64U];
+static ATTR_ALIGN(64) uint8_t s_ref[TEST_BUF_SIZE + 64U];
+static mbedtls_aes_context s_aes[TEST_KEY_CONTEXTS];
+static uint8_t s_key[TEST_KEY_CONTEXTS][32];
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1103515245U + 12345U;
+    return s_seed >> 8;
+}
+
+static void fill(uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)rnd();
+    }
+}
+
+static const EVP_CIPHER *ref_aes(const char *mode, uint32_t bits)
+{
+    char name[24];
+
+    snprintf(name, sizeof(name), "aes-%u-%s", (unsigned)bits, mode);
+    return EVP_get_cipherbyname(name);
+}
+
+static void ref_crypt(const EVP_CIPHER *cipher, const uint8_t *key, const uint8_t *iv, bool encrypt,
+                      const uint8_t *in, size_t len, uint8_t *out)
+{
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    int n1 = 0;
+    int n2 = 0;
+
+    EVP_CipherInit_ex(ctx, cipher, NULL, key, iv, encrypt ? 1 : 0);
+    EVP_CIPHER_CTX_set_padding(ctx, 0);
+    EVP_CipherUpdate(ctx, out, &n1, in, (int)len);
+    EVP_CipherFinal_ex(ctx, out + n1, &n2);
+    EVP_CIPHER_CTX_free(ctx);
+}
+
+static void ref_ccm(uint32_t bits, const uint8_t *key, const uint8_t *iv, size_t iv_len, const uint8_t *aad,
+                    size_t aad_len, const uint8_t *in, size_t len, uint8_t *out, uint8_t *tag, size_t tag_len)
+{
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    int n;
+
+    EVP_EncryptInit_ex(ctx, ref_aes("ccm", bits), NULL, NULL, NULL);
+    EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_SET_IVLEN, (int)iv_len, NULL);
+    EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_SET_TAG, (int)tag_len, NULL);
+    EVP_EncryptInit_ex(ctx, NULL, NULL, key, iv);
+    EVP_EncryptUpdate(ctx, NULL, &n, NULL, (int)len);
+    if (aad_len > 0U) {
+        EVP_EncryptUpdate(ctx, NULL, &n, aad, (int)aad_len);
+    }
+    EVP_EncryptUpdate(ctx, out, &n, in, (int)len);
+    EVP_EncryptFinal_ex(ctx, out, &n);
+    EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_CCM_GET_TAG, (int)tag_len, tag);
+    EVP_CIPHER_CTX_free(ctx);
+}
+
+static uint32_t key_words(const mbedtls_aes_context *ctx)
+{
+    return (ctx->nr == 14) ? 8U : 4U;
+}
+
+/* CBC of every length and alignment class, with the D-cache on and off */
+static int test_cbc(void)
+{
+    static const uint32_t lengths[] = { 16, 48, 240, 256, 512, 1024, 4096, TEST_BUF_SIZE };
+    static const uint32_t offsets[] = { 0, 4, 1 };
+    mbedtls_hpm_sdp_aes_stat_t stat;
+    mbedtls_aes_context enc;
+    mbedtls_aes_context dec;
+    uint8_t key[32];
+    uint8_t iv[16];
+    uint8_t iv_enc[16];
+    uint8_t iv_dec[16];
+    uint32_t cases = 0;
+
+    for (uint32_t bits = 128; bits <= 256; bits += 128) {
+        fill(key, sizeof(key));
+        mbedtls_aes_init(&enc);
+        mbedtls_aes_init(&dec);
+        CHECK(mbedtls_aes_setkey_enc(&enc, key, bits) == 0);
+        CHECK(mbedtls_aes_setkey_dec(&dec, key, bits) == 0);
+        for (uint32_t dc = 0; dc < 2U; dc++) {
+            hpm_host_l1c.dc_enabled = (dc != 0U);
+            for (uint32_t l = 0; l < ARRAY_SIZE(lengths); l++) {
+                for (uint32_t o = 0; o < ARRAY_SIZE(offsets); o++) {
+                    uint32_t len = lengths[l];
+                    uint8_t *in = &s_src[offsets[o]];
+                    uint8_t *out = &s_dst[offsets[o]];
+                    uint32_t align = hpm_host_l1c.dc_enabled ? HPM_L1C_CACHELINE_SIZE : 4U;
+                    bool in_place = (len >= 256U) && ((offsets[o] & (align - 1U)) == 0U) && ((len & (align - 1U)) == 0U);
+                    uint32_t packets = in_place ? 1U : (len + TEST_BOUNCE_SIZE - 1U) / TEST_BOUNCE_SIZE;
+                    uint32_t half = (len / 32U) * 16U;
+
+                    fill(in, len);
+                    fill(iv, sizeof(iv));
+                    ref_crypt(ref_aes("cbc", bits), key, iv, true, in, len, s_ref);
+
+                    /* one call, the IV left for the next call */
+                    memcpy(iv_enc, iv, 16);
+                    mbedtls_hpm_sdp_aes_reset_stat();
+                    hpm_host_sim_sdp_reset_stat(&s_sdp);
+                    hpm_host_l1c.unaligned = 0;
+                    CHECK(mbedtls_aes_crypt_cbc(&enc, MBEDTLS_AES_ENCRYPT, len, iv_enc, in, out) == 0);
+                    CHECK(memcmp(out, s_ref, len) == 0);
+                    CHECK(memcmp(iv_enc, &s_ref[len - 16U], 16) == 0);
+                    mbedtls_hpm_sdp_aes_get_stat(&stat);
+                    CHECK(stat.hw_calls == 1U);
+                    CHECK(stat.bounce_blocks == (in_place ? 0U : packets));
+                    CHECK(s_sdp.cipher_packets == packets);
+                    CHECK((s_sdp.errors == 0U) && (hpm_host_l1c.unaligned == 0U));
+
+                    /* decrypt in two calls, the second one in place */
+                    memcpy(iv_dec, iv, 16);
+                    if (half > 0U) {
+                        CHECK(mbedtls_aes_crypt_cbc(&dec, MBEDTLS_AES_DECRYPT, half, iv_dec, out, s_ref) == 0);
+                    }
+                    CHECK(mbedtls_aes_crypt_cbc(&dec, MBEDTLS_AES_DECRYPT, len - half, iv_dec, &out[half], &out[half]) == 0);
+                    if (half > 0U) {
+                        CHECK(memcmp(s_ref, in, half) == 0);
+                    }
+                    CHECK(memcmp(&out[half], &in[half], len - half) == 0);
+                    CHECK(hpm_host_l1c.unaligned == 0U);
+                    cases++;
+                }
+            }
+        }
+        CHECK(mbedtls_aes_crypt_cbc(&enc, MBEDTLS_AES_ENCRYPT, 17, iv, s_src, s_dst) == MBEDTLS_ERR_AES_INVALID_INPUT_LENGTH);
+        mbedtls_aes_free(&enc);
+        mbedtls_aes_free(&dec);
+    }
+    hpm_host_l1c.dc_enabled = true;
+
+    /* figures: aligned 4 KiB in place against a misaligned one through the bounce buffer */
+    for (uint32_t o = 0; o < 2U; o++) {
+        uint32_t len = 4096U;
+
+        fill(key, 16);
+        mbedtls_aes_init(&enc);
+        CHECK(mbedtls_aes_setkey_enc(&enc, key, 128) == 0);
+        CHECK(mbedtls_aes_crypt_cbc(&enc, MBEDTLS_AES_ENCRYPT, 16, iv, s_src, s_dst) == 0);
+        hpm_host_sim_sdp_reset_stat(&s_sdp);
+        CHECK(mbedtls_aes_crypt_cbc(&enc, MBEDTLS_AES_ENCRYPT, len, iv, &s_src[o * 4U], &s_dst[o * 4U]) == 0);
+        printf("CBC 4 KiB %-9s: %u SDP packets, %.1f register writes and %.1f reads per KiB\n",
+               (o == 0U) ? "in place" : "bounced", (unsigned)s_sdp.packets,
+               s_sdp.block->writes / 4.0, s_sdp.block->reads / 4.0);
+        mbedtls_aes_free(&enc);
+    }
+    printf("CBC: %u cases\n", (unsigned)cases);
+    return 0;
+}
+
+/* CTR streamed in random pieces, one packet per chunk of counter blocks */
+static int test_ctr(void)
+{
+    mbedtls_hpm_sdp_aes_stat_t stat;
+    mbedtls_aes_context ctx;
+    uint8_t key[32];
+    uint8_t nonce[16];
+    uint8_t counter[16];
+    uint8_t stream[16];
+    size_t nc_off = 0;
+    uint32_t expected = 0;
+    uint32_t calls = 0;
+    uint32_t pos = 0;
+
+    for (uint32_t bits = 128; bits <= 256; bits += 128) {
+        fill(key, sizeof(key));
+        fill(nonce, sizeof(nonce));
+        nonce[15] = 0xF0U;      /* the counter carries into the upper bytes */
+        fill(s_src, TEST_CTR_BYTES);
+        ref_crypt(ref_aes("ctr", bits), key, nonce, true, s_src, TEST_CTR_BYTES, s_ref);
+
+        mbedtls_aes_init(&ctx);
+        CHECK(mbedtls_aes_setkey_enc(&ctx, key, bits) == 0);
+        memcpy(counter, nonce, 16);
+        nc_off = 0;
+        pos = 0;
+        expected = 0;
+        calls = 0;
+        mbedtls_hpm_sdp_aes_reset_stat();
+        hpm_host_sim_sdp_reset_stat(&s_sdp);
+        while (pos < TEST_CTR_BYTES) {
+            uint32_t len = rnd() % 1200U;
+            len = MIN(len, TEST_CTR_BYTES - pos);
+            uint32_t left = (nc_off == 0U) ? 0U : 16U - (uint32_t)nc_off;
+            uint32_t rest = (len > left) ? len - left : 0U;
+            uint32_t blocks = (rest + 15U) / 16U;
+
+            expected += (blocks + TEST_CTR_BLOCKS - 1U) / TEST_CTR_BLOCKS;
+            calls += (rest > 0U) ? 1U : 0U;
+            CHECK(mbedtls_aes_crypt_ctr(&ctx, len, &nc_off, counter, stream, &s_src[pos], &s_dst[pos]) == 0);
+            pos += len;
+        }
+        CHECK(memcmp(s_dst, s_ref, TEST_CTR_BYTES) == 0);
+        CHECK(s_sdp.cipher_packets == expected);
+        mbedtls_hpm_sdp_aes_get_stat(&stat);
+        CHECK((stat.hw_calls == calls) && (stat.key_loads == 1U) && (stat.key_hits == calls - 1U));
+        CHECK(s_sdp.errors == 0U);
+
+        /* a whole buffer: blocks per packet against the per block driver CTR */
+        hpm_host_sim_sdp_reset_stat(&s_sdp);
+        nc_off = 0;
+        memcpy(counter, nonce, 16);
+        CHECK(mbedtls_aes_crypt_ctr(&ctx, 4096, &nc_off, counter, stream, s_src, s_dst) == 0);
+        CHECK(memcmp(s_dst, s_ref, 4096) == 0);
+        CHECK(s_sdp.cipher_packets == 4096U / TEST_BOUNCE_SIZE);
+        printf("CTR-%u 4 KiB: %u SDP packets (%u blocks each, 256 with sdp_aes_crypt_ctr), %.1f register writes per KiB\n",
+               (unsigned)bits, (unsigned)s_sdp.cipher_packets, (unsigned)TEST_CTR_BLOCKS, s_sdp.block->writes / 4.0);
+        mbedtls_aes_free(&ctx);
+    }
+    return 0;
+}
+
+static int crypt_ecb_check(uint32_t i)
+{
+    uint8_t ref[16];
+    uint8_t out[16];
+    uint32_t bits = (s_aes[i].nr == 14) ? 256U : 128U;
+
+    fill(s_src, 16);
+    ref_crypt(ref_aes("ecb", bits), s_key[i], NULL, true, s_src, 16, ref);
+    CHECK(mbedtls_aes_crypt_ecb(&s_aes[i], MBEDTLS_AES_ENCRYPT, s_src, out) == 0);
+    CHECK(memcmp(out, ref, 16) == 0);
+    return 0;
+}
+
+/* contexts taking turns: loaded once while they fit, evicted beyond, dropped by a new key or free */
+static int test_key_cache(void)
+{
+    mbedtls_hpm_sdp_aes_stat_t stat;
+    uint32_t words = 0;
+    uint32_t n = TEST_KEY_SLOTS - 2U;
+
+    for (uint32_t i = 0; i < TEST_KEY_CONTEXTS; i++) {
+        fill(s_key[i], 32);
+        mbedtls_aes_init(&s_aes[i]);
+        CHECK(mbedtls_aes_setkey_enc(&s_aes[i], s_key[i], ((i % 2U) == 0U) ? 128 : 256) == 0);
+    }
+
+    /* fewer contexts than slots: one load each */
+    mbedtls_hpm_sdp_aes_reset_stat();
+    hpm_host_sim_sdp_reset_stat(&s_sdp);
+    for (uint32_t round = 0; round < 5U; round++) {
+        for (uint32_t i = 0; i < n; i++) {
+            CHECK(crypt_ecb_check(i) == 0);
+        }
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        words += key_words(&s_aes[i]);
+    }
+    mbedtls_hpm_sdp_aes_get_stat(&stat);
+    CHECK((stat.key_loads == n) && (stat.key_hits == 4U * n));
+    CHECK(s_sdp.key_writes == words);
+    printf("key cache, %u contexts: %u loads, %u hits in %u operations\n", (unsigned)n,
+           (unsigned)stat.key_loads, (unsigned)stat.key_hits, (unsigned)(5U * n));
+
+    /* a new key of a cached context reuses its slot, the others stay */
+    fill(s_key[0], 32);
+    CHECK(mbedtls_aes_setkey_enc(&s_aes[0], s_key[0], 128) == 0);
+    mbedtls_hpm_sdp_aes_reset_stat();
+    for (uint32_t i = 0; i < n; i++) {
+        CHECK(crypt_ecb_check(i) == 0);
+    }
+    mbedtls_hpm_sdp_aes_get_stat(&stat);
+    CHECK((stat.key_loads == 1U) && (stat.key_hits == n - 1U));
+
+    /* a freed context gives its slot back, the next context takes it without evicting */
+    mbedtls_aes_free(&s_aes[1]);
+    mbedtls_aes_init(&s_aes[1]);
+    CHECK(mbedtls_aes_setkey_enc(&s_aes[1], s_key[1], 128) == 0);
+    for (uint32_t i = n; i < TEST_KEY_SLOTS + 1U; i++) {
+        CHECK(crypt_ecb_check(i) == 0);
+    }
+    mbedtls_hpm_sdp_aes_reset_stat();
+    for (uint32_t i = 0; i < n; i++) {
+        if (i != 1U) {
+            CHECK(crypt_ecb_check(i) == 0);
+        }
+    }
+    mbedtls_hpm_sdp_aes_get_stat(&stat);
+    CHECK((stat.key_loads == 0U) && (stat.key_hits == n - 1U));
+
+    /* more contexts than slots: evicted keys are loaded again, results stay right */
+    mbedtls_hpm_sdp_aes_reset_stat();
+    hpm_host_sim_sdp_reset_stat(&s_sdp);
+    for (uint32_t round = 0; round < 3U; round++) {
+        for (uint32_t i = 0; i < TEST_KEY_CONTEXTS; i++) {
+            CHECK(crypt_ecb_check(i) == 0);
+        }
+    }
+    mbedtls_hpm_sdp_aes_get_stat(&stat);
+    CHECK(stat.key_loads + stat.key_hits == 3U * TEST_KEY_CONTEXTS);
+    CHECK(stat.key_loads >= 2U * (TEST_KEY_CONTEXTS - TEST_KEY_SLOTS));
+    CHECK(s_sdp.errors == 0U);
+    printf("key cache, %u contexts: %u loads, %u hits in %u operations\n", (unsigned)TEST_KEY_CONTEXTS,
+           (unsigned)stat.key_loads, (unsigned)stat.key_hits, (unsigned)(3U * TEST_KEY_CONTEXTS));
+
+    for (uint32_t i = 0; i < TEST_KEY_CONTEXTS; i++) {
+        mbedtls_aes_free(&s_aes[i]);
+    }
+    return 0;
+}
+
+static int ccm_case(uint32_t bits, size_t len, size_t iv_len, size_t aad_len, size_t tag_len, bool sdp)
+{
+    mbedtls_hpm_sdp_aes_stat_t stat;
+    mbedtls_ccm_context ctx;
+    uint8_t key[32];
+    uint8_t iv[13];
+    uint8_t aad[300];
+    uint8_t tag[16];
+    uint8_t ref_tag[16];
+
+    fill(key, sizeof(key));
+    fill(iv, sizeof(iv));
+    fill(aad, sizeof(aad));
+    fill(s_src, len);
+    ref_ccm(bits, key, iv, iv_len, aad, aad_len, s_src, len, s_ref, ref_tag, tag_len);
+
+    mbedtls_ccm_init(&ctx);
+    CHECK(mbedtls_ccm_setkey(&ctx, MBEDTLS_CIPHER_ID_AES, key, bits) == 0);
+    mbedtls_hpm_sdp_aes_reset_stat();
+    hpm_host_sim_sdp_reset_stat(&s_sdp);
+    CHECK(mbedtls_ccm_encrypt_and_tag(&ctx, len, iv, iv_len, aad, aad_len, s_src, s_dst, tag, tag_len) == 0);
+    CHECK((memcmp(s_dst, s_ref, len) == 0) && (memcmp(tag, ref_tag, tag_len) == 0));
+    mbedtls_hpm_sdp_aes_get_stat(&stat);
+    if (sdp) {
+        /* the whole message in one SDP session */
+        CHECK(stat.hw_calls == 1U);
+    } else {
+        CHECK((stat.hw_calls == 0U) && (s_sdp.packets == 0U));
+    }
+
+    CHECK(mbedtls_ccm_auth_decrypt(&ctx, len, iv, iv_len, aad, aad_len, s_ref, s_dst, tag, tag_len) == 0);
+    CHECK(memcmp(s_dst, s_src, len) == 0);
+    tag[tag_len - 1U] ^= 0x01U;
+    CHECK(mbedtls_ccm_auth_decrypt(&ctx, len, iv, iv_len, aad, aad_len, s_ref, s_dst, tag, tag_len)
+          == MBEDTLS_ERR_CCM_AUTH_FAILED);
+    for (size_t i = 0; i < len; i++) {
+        CHECK(s_dst[i] == 0U);
+    }
+    CHECK(s_sdp.errors == 0U);
+    mbedtls_ccm_free(&ctx);
+    return 0;
+}
+
+static int test_ccm(void)
+{
+    static const size_t lengths[] = { 0, 1, 33, 1000 };
+    static const size_t iv_lens[] = { 7, 12, 13 };
+    static const size_t aad_lens[] = { 0, 20, 300 };
+    static const size_t tag_lens[] = { 4, 8, 16 };
+    mbedtls_hpm_sdp_aes_stat_t stat;
+    mbedtls_ccm_context ctx;
+    uint8_t key[16];
+    uint8_t iv[13];
+    uint8_t ctr[16];
+    uint32_t cases = 0;
+
+    for (uint32_t bits = 128; bits <= 256; bits += 64) {
+        for (uint32_t l = 0; l < ARRAY_SIZE(lengths); l++) {
+            for (uint32_t v = 0; v < ARRAY_SIZE(iv_lens); v++) {
+                for (uint32_t a = 0; a < ARRAY_SIZE(aad_lens); a++) {
+                    for (uint32_t t = 0; t < ARRAY_SIZE(tag_lens); t++) {
+                        /* AES-192 is not in the SDP, software CCM with a software AES */
+                        CHECK(ccm_case(bits, lengths[l], iv_lens[v], aad_lens[a], tag_lens[t], bits != 192U) == 0);
+                        cases++;
+                    }
+                }
+            }
+        }
+    }
+
+    /* CCM* without tag is CTR from counter 1, software CCM with the AES blocks in the SDP */
+    fill(key, sizeof(key));
+    fill(iv, sizeof(iv));
+    fill(s_src, 100);
+    memset(ctr, 0, sizeof(ctr));
+    ctr[0] = (uint8_t)(15U - 13U - 1U);
+    memcpy(&ctr[1], iv, 13);
+    ctr[15] = 1U;
+    ref_crypt(ref_aes("ctr", 128), key, ctr, true, s_src, 100, s_ref);
+    mbedtls_ccm_init(&ctx);
+    CHECK(mbedtls_ccm_setkey(&ctx, MBEDTLS_CIPHER_ID_AES, key, 128) == 0);
+    mbedtls_hpm_sdp_aes_reset_stat();
+    CHECK(mbedtls_ccm_star_encrypt_and_tag(&ctx, 100, iv, 13, NULL, 0, s_src, s_dst, NULL, 0) == 0);
+    CHECK(memcmp(s_dst, s_ref, 100) == 0);
+    mbedtls_hpm_sdp_aes_get_stat(&stat);
+    CHECK((stat.hw_calls > 1U) && (stat.key_loads == 1U));
+    CHECK(mbedtls_ccm_star_auth_decrypt(&ctx, 100, iv, 13, NULL, 0, s_ref, s_dst, NULL, 0) == 0);
+    CHECK(memcmp(s_dst, s_src, 100) == 0);
+    CHECK(mbedtls_ccm_encrypt_and_tag(&ctx, 100, iv, 13, NULL, 0, s_src, s_dst, NULL, 0) == MBEDTLS_ERR_CCM_BAD_INPUT);
+
+    /* figure: SDP packets of a 1 KiB message */
+    hpm_host_sim_sdp_reset_stat(&s_sdp);
+    CHECK(mbedtls_ccm_encrypt_and_tag(&ctx, 1024, iv, 13, NULL, 0, s_src, s_dst, ctr, 16) == 0);
+    printf("CCM 1 KiB: %u SDP packets\n", (unsigned)s_sdp.packets);
+    mbedtls_ccm_free(&ctx);
+    printf("CCM: %u cases\n", (unsigned)cases);
+    return 0;
+}
+
+static int test_sha(void)
+{
+    static const uint32_t lengths[] = { 0, 1, 55, 56, 63, 64, 65, 255, 256, 1000, TEST_BUF_SIZE };
+    const mbedtls_md_info_t *md = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    mbedtls_sha256_context ctx;
+    uint8_t digest[32];
+    uint8_t ref[32];
+    uint8_t key[100];
+    unsigned int ref_len;
+
+    for (uint32_t l = 0; l < ARRAY_SIZE(lengths); l++) {
+        for (uint32_t o = 0; o < 2U; o++) {
+            uint32_t len = lengths[l];
+            uint8_t *in = &s_src[o];
+
+            fill(in, len);
+            EVP_Digest(in, len, ref, NULL, EVP_sha256(), NULL);
+            CHECK(mbedtls_sha256_ret(in, len, digest, 0) == 0);
+            CHECK(memcmp(digest, ref, 32) == 0);
+
+            /* random pieces */
+            mbedtls_sha256_init(&ctx);
+            CHECK(mbedtls_sha256_starts_ret(&ctx, 0) == 0);
+            for (uint32_t pos = 0; pos < len;) {
+                uint32_t piece = rnd() % 700U;
+
+                piece = MIN(piece, len - pos);
+
+                CHECK(mbedtls_sha256_update_ret(&ctx, &in[pos], piece) == 0);
+                pos += piece;
+            }
+            CHECK(mbedtls_sha256_finish_ret(&ctx, digest) == 0);
+            mbedtls_sha256_free(&ctx);
+            if (memcmp(digest, ref, 32) != 0) printf("DBG len %u o %u\n", (unsigned)len, (unsigned)o);
+
+            EVP_Digest(in, len, ref, NULL, EVP_sha224(), NULL);
+            CHECK(mbedtls_sha256_ret(in, len, digest, 1) == 0);
+            CHECK(memcmp(digest, ref, 28) == 0);
+
+            EVP_Digest(in, len, ref, NULL, EVP_sha1(), NULL);
+            CHECK(mbedtls_sha1_ret(in, len, digest) == 0);
+            CHECK(memcmp(digest, ref, 20) == 0);
+        }
+    }
+
+    for (uint32_t k = 16; k <= sizeof(key); k += 42U) {
+        fill(key, k);
+        fill(s_src, 3000);
+        HMAC(EVP_sha256(), key, (int)k, s_src, 3000, ref, &ref_len);
+        CHECK(mbedtls_md_hmac(md, key, k, s_src, 3000, digest) == 0);
+        CHECK((ref_len == 32U) && (memcmp(digest, ref, 32) == 0));
+    }
+    CHECK(s_sdp.errors == 0U);
+
+    hpm_host_sim_sdp_reset_stat(&s_sdp);
+    CHECK(mbedtls_sha256_ret(s_src, TEST_BUF_SIZE, digest, 0) == 0);
+    printf("SHA-256 8 KiB: %u SDP packets, %.1f register writes per KiB\n", (unsigned)s_sdp.hash_packets,
+           s_sdp.block->writes / 8.0);
+    return 0;
+}
+
+int main(void)
+{
+    CHECK(hpm_host_sim_sdp_init_at(&s_sdp, HPM_SDP_BASE));
+    hpm_host_l1c.dc_enabled = true;
+
+    if ((test_cbc() != 0) || (test_ctr() != 0) || (test_key_cache() != 0) || (test_ccm() != 0)
+     || (test_sha() != 0)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim_mcan.h"
+
+/*
+ * MCAN driver against sim/hpm_host_sim_mcan.c with the HPM6280 layout, where
+ * the message RAM is part of the register block, so element copies count as
+ * register accesses as they cost bus cycles on the chip. Measures mcan_init,
+ * blocking transmit per frame, a full TX FIFO, and the RX FIFO drained frame
+ * by frame against mcan_read_rxfifo_burst(), then a FIFO overrun.
+ */
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_TX_FRAMES (32U)
+
+static hpm_host_sim_mcan_t s_mcan;
+static mcan_tx_frame_t s_wire[TEST_TX_FRAMES];
+static uint32_t s_wire_count;
+static mcan_rx_message_t s_rx[64];
+
+static void mcan_wire(void *context, const mcan_tx_frame_t *frame)
+{
+    (void)context;
+    if (s_wire_count < TEST_TX_FRAMES) {
+        s_wire[s_wire_count] = *frame;
+    }
+    s_wire_count++;
+}
+
+static void make_rx_frame(mcan_rx_message_t *frame, uint32_t n)
+{
+    memset(frame, 0, sizeof(*frame));
+    frame->std_id = 0x100U + n;
+    frame->dlc = 8;
+    for (uint32_t i = 0; i < 8U; i++) {
+        frame->data_8[i] = (uint8_t)(n + i);
+    }
+}
+
+static bool rx_frame_ok(const mcan_rx_message_t *frame, uint32_t n)
+{
+    mcan_rx_message_t expected;
+
+    make_rx_frame(&expected, n);
+    return (frame->std_id == expected.std_id) && (frame->dlc == expected.dlc)
+        && (memcmp(frame->data_8, expected.data_8, 8) == 0);
+}
+
+int main(void)
+{
+    MCAN_Type *mcan;
+    hpm_host_sim_block_t *block;
+    mcan_config_t config;
+    mcan_tx_frame_t tx;
+    mcan_rx_message_t rx;
+    uint32_t fifo_size;
+    uint32_t tfqs;
+    uint32_t queued;
+    uint32_t count;
+    uint32_t single_reads;
+    uint32_t single_writes;
+
+    CHECK(hpm_host_sim_mcan_init(&s_mcan, mcan_wire, NULL));
+    mcan = hpm_host_sim_mcan_base(&s_mcan);
+    block = s_mcan.block;
+
+    mcan_get_default_config(mcan, &config);
+    config.baudrate = 500000;
+    CHECK(mcan_init(mcan, &config, 80000000UL) == status_success);
+    printf("mcan_init: %u reads, %u writes, %u of them clearing the message RAM\n",
+           block->reads, block->writes, (uint32_t)(sizeof(mcan->MESSAGE_BUFF) / sizeof(uint32_t)));
+    fifo_size = MCAN_RXF0C_F0S_GET(hpm_host_sim_peek(block, offsetof(MCAN_Type, RXF0C)));
+    tfqs = MCAN_TXBC_TFQS_GET(hpm_host_sim_peek(block, offsetof(MCAN_Type, TXBC)));
+    CHECK((fifo_size >= 8U) && (fifo_size <= ARRAY_SIZE(s_rx)));
+    CHECK(tfqs != 0U);
+
+    /* blocking transmit through the TX FIFO */
+    memset(&tx, 0, sizeof(tx));
+    tx.dlc = 8;
+    hpm_host_sim_block_reset_stat(block);
+    for (uint32_t n = 0; n < TEST_TX_FRAMES; n++) {
+        tx.std_id = 0x200U + n;
+        tx.data_32[0] = n;
+        tx.data_32[1] = ~n;
+        CHECK(mcan_transmit_blocking(mcan, &tx) == status_success);
+    }
+    printf("mcan_transmit_blocking: %.2f reads, %.2f writes per frame\n",
+           (double)block->reads / TEST_TX_FRAMES, (double)block->writes / TEST_TX_FRAMES);
+    CHECK(s_wire_count == TEST_TX_FRAMES);
+    for (uint32_t n = 0; n < TEST_TX_FRAMES; n++) {
+        CHECK((s_wire[n].std_id == 0x200U + n) && (s_wire[n].data_32[0] == n) && (s_wire[n].data_32[1] == ~n));
+    }
+
+    /* the bus is busy: the TX FIFO fills up and reports full */
+    s_mcan.tx_hold = true;
+    s_wire_count = 0;
+    for (queued = 0; mcan_transmit_via_txfifo_nonblocking(mcan, &tx, NULL) == status_success; queued++) {
+        CHECK(queued <= tfqs);
+    }
+    CHECK(queued == tfqs);
+    CHECK(mcan_transmit_via_txfifo_nonblocking(mcan, &tx, NULL) == status_mcan_txfifo_full);
+    CHECK(hpm_host_sim_mcan_release_tx(&s_mcan) == tfqs);
+    CHECK(s_wire_count == tfqs);
+    s_mcan.tx_hold = false;
+    CHECK(mcan_transmit_blocking(mcan, &tx) == status_success);
+
+    /* RX FIFO 0 drained frame by frame */
+    for (uint32_t n = 0; n < fifo_size; n++) {
+        make_rx_frame(&rx, n);
+        CHECK(hpm_host_sim_mcan_receive(&s_mcan, 0, &rx));
+    }
+    hpm_host_sim_block_reset_stat(block);
+    for (uint32_t n = 0; n < fifo_size; n++) {
+        CHECK(mcan_read_rxfifo(mcan, 0, &s_rx[n]) == status_success);
+        CHECK(rx_frame_ok(&s_rx[n], n));
+    }
+    CHECK(mcan_read_rxfifo(mcan, 0, &rx) == status_mcan_rxfifo_empty);
+    single_reads = block->reads;
+    single_writes = block->writes;
+
+    /* the same frames in one burst, the put index has wrapped meanwhile */
+    for (uint32_t n = 0; n < fifo_size; n++) {
+        make_rx_frame(&rx, 100U + n);
+        CHECK(hpm_host_sim_mcan_receive(&s_mcan, 0, &rx));
+    }
+    memset(s_rx, 0, sizeof(s_rx));
+    hpm_host_sim_block_reset_stat(block);
+    CHECK(mcan_read_rxfifo_burst(mcan, 0, s_rx, ARRAY_SIZE(s_rx), &count) == status_success);
+    CHECK(count == fifo_size);
+    for (uint32_t n = 0; n < fifo_size; n++) {
+        CHECK(rx_frame_ok(&s_rx[n], 100U + n));
+    }
+    CHECK(mcan_read_rxfifo_burst(mcan, 0, s_rx, ARRAY_SIZE(s_rx), &count) == status_mcan_rxfifo_empty);
+    printf("RX FIFO of %u frames: mcan_read_rxfifo %.2f reads, %.2f writes per frame, "
+           "mcan_read_rxfifo_burst %.2f reads, %.2f writes per frame\n",
+           fifo_size, (double)single_reads / fifo_size, (double)single_writes / fifo_size,
+           (double)block->reads / fifo_size, (double)block->writes / fifo_size);
+    CHECK(block->reads < single_reads);
+    CHECK(block->writes == 1U);
+    CHECK(single_writes == fifo_size);
+
+    /* one frame more than the FIFO holds is lost and flagged */
+    for (uint32_t n = 0; n <= fifo_size; n++) {
+        make_rx_frame(&rx, n);
+        CHECK(hpm_host_sim_mcan_receive(&s_mcan, 0, &rx) == (n < fifo_size));
+    }
+    CHECK(s_mcan.lost[0] == 1U);
+    CHECK((mcan_get_interrupt_flags(mcan) & MCAN_INT_RXFIFO0_MSG_LOST) != 0U);
+    CHECK(mcan_read_rxfifo_burst(mcan, 0, s_rx, ARRAY_SIZE(s_rx), &count) == status_success);
+    CHECK((count == fifo_size) && rx_frame_ok(&s_rx[fifo_size - 1U], fifo_size - 1U));
+
+    hpm_host_sim_mcan_deinit(&s_mcan);
+    return 0;
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_host_sim_mcan.h"
+#include "hpm_mcan_rx.h"
+
+/*
+ * components/mcan_rx against sim/hpm_host_sim_mcan.c with the HPM6280
+ * layout. Checks the route table set up, the bisection against a linear
+ * search, and frames of random standard and extended identifiers drained
+ * from RX FIFO 0 into four queues and the default queue: per queue order,
+ * header and the data bytes of the DLC, queue overflow and the statistics.
+ *
+ * Then compares, with TEST_ROUTES routes and full FIFOs, the dispatcher to
+ * what the application does without it: mcan_read_rxfifo() per frame and a
+ * linear search of the route table. Figures are register accesses per frame,
+ * which is bus time on the chip, and host ns per frame of the route search.
+ * The drain itself is not timed, a trapped access costs microseconds on the
+ * host and would hide the software.
+ */
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_ROUTES         (300U)
+#define TEST_STD_ROUTES     (200U)
+#define TEST_QUEUES         (4U)
+#define TEST_QUEUE_SIZE     (64U)
+#define TEST_MAX_FIFO       (64U)
+#define TEST_ROUNDS         (100U)
+#define TEST_OVERFLOW_ROUNDS (16U)
+#define TEST_BENCH_ROUNDS   (50U)
+#define TEST_LOOKUPS        (200000U)
+/* one frame in TEST_UNROUTED_RATIO has no route */
+#define TEST_UNROUTED_RATIO (5U)
+
+static hpm_host_sim_mcan_t s_mcan;
+static hpm_mcan_rx_dispatcher_t s_dispatcher;
+static hpm_mcan_rx_route_t s_routes[TEST_ROUTES];
+/* the table in the order it was built, for the linear searches */
+static hpm_mcan_rx_route_t s_linear[TEST_ROUTES];
+static hpm_mcan_rx_queue_t s_queue[TEST_QUEUES];
+static hpm_mcan_rx_queue_t s_default;
+static hpm_mcan_rx_queue_t *s_queues[TEST_QUEUES];
+static mcan_rx_message_t s_queue_buf[TEST_QUEUES][TEST_QUEUE_SIZE];
+static mcan_rx_message_t s_default_buf[TEST_QUEUE_SIZE];
+static mcan_rx_message_t s_sent[TEST_MAX_FIFO];
+static mcan_rx_message_t s_base_buf[TEST_QUEUES + 1U][TEST_QUEUE_SIZE];
+static uint32_t s_base_head[TEST_QUEUES + 1U];
+static volatile uint32_t s_found;
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t frame_key(const mcan_rx_message_t *frame)
+{
+    return frame->use_ext_id ? HPM_MCAN_RX_KEY(frame->ext_id, true) : HPM_MCAN_RX_KEY(frame->std_id, false);
+}
+
+static const hpm_mcan_rx_route_t *linear_lookup(uint32_t key)
+{
+    for (uint32_t i = 0; i < TEST_ROUTES; i++) {
+        if (s_linear[i].key == key) {
+            return &s_linear[i];
+        }
+    }
+    return NULL;
+}
+
+/* unique keys, TEST_STD_ROUTES standard identifiers first, in random order */
+static void make_routes(void)
+{
+    uint32_t key;
+    bool is_ext;
+
+    for (uint32_t i = 0; i < TEST_ROUTES; i++) {
+        is_ext = i >= TEST_STD_ROUTES;
+        do {
+            key = is_ext ? HPM_MCAN_RX_KEY(rnd() & 0x1FFFFFFFU, true) : HPM_MCAN_RX_KEY(rnd() & 0x7FFU, false);
+            s_linear[i].key = key;
+        } while (linear_lookup(key) != &s_linear[i]);
+        s_linear[i].queue = rnd() % TEST_QUEUES;
+    }
+    memcpy(s_routes, s_linear, sizeof(s_routes));
+}
+
+/* a routed identifier, or one without a route every TEST_UNROUTED_RATIO frames */
+static void make_frame(mcan_rx_message_t *frame)
+{
+    const hpm_mcan_rx_route_t *route;
+    uint32_t key;
+
+    memset(frame, 0, sizeof(*frame));
+    if ((rnd() % TEST_UNROUTED_RATIO) != 0U) {
+        key = s_linear[rnd() % TEST_ROUTES].key;
+    } else {
+        do {
+            key = ((rnd() & 1U) != 0U) ? HPM_MCAN_RX_KEY(rnd() & 0x1FFFFFFFU, true) : HPM_MCAN_RX_KEY(rnd() & 0x7FFU, false);
+            route = linear_lookup(key);
+        } while (route != NULL);
+    }
+    if ((key & HPM_MCAN_RX_KEY_EXT) != 0U) {
+        frame->use_ext_id = 1;
+        frame->ext_id = key & ~HPM_MCAN_RX_KEY_EXT;
+    } else {
+        frame->std_id = key;
+    }
+    frame->dlc = rnd() % 9U;
+    for (uint32_t i = 0; i < mcan_get_message_size_from_dlc(frame->dlc); i++) {
+        frame->data_8[i] = (uint8_t)rnd();
+    }
+}
+
+/* identifier, DLC and the data bytes of the DLC, the rest is not copied */
+static bool frame_equal(const mcan_rx_message_t *a, const mcan_rx_message_t *b)
+{
+    return (frame_key(a) == frame_key(b)) && (a->dlc == b->dlc)
+        && (memcmp(a->data_8, b->data_8, mcan_get_message_size_from_dlc(a->dlc)) == 0);
+}
+
+static uint32_t fill_fifo(uint32_t count)
+{
+    for (uint32_t n = 0; n < count; n++) {
+        make_frame(&s_sent[n]);
+        if (!hpm_host_sim_mcan_receive(&s_mcan, 0, &s_sent[n])) {
+            return n;
+        }
+    }
+    return count;
+}
+
+/* the frames of s_sent meant for queue, in order, and nothing else */
+static bool queue_matches(hpm_mcan_rx_queue_t *queue, int32_t index, uint32_t sent)
+{
+    const hpm_mcan_rx_route_t *route;
+    mcan_rx_message_t *frame;
+
+    for (uint32_t n = 0; n < sent; n++) {
+        route = linear_lookup(frame_key(&s_sent[n]));
+        if ((route == NULL) ? (index >= 0) : ((int32_t)route->queue != index)) {
+            continue;
+        }
+        frame = hpm_mcan_rx_queue_peek(queue);
+        if ((frame == NULL) || !frame_equal(frame, &s_sent[n])) {
+            return false;
+        }
+        hpm_mcan_rx_queue_pop(queue);
+    }
+    return hpm_mcan_rx_queue_peek(queue) == NULL;
+}
+
+/* what the dispatcher replaces: a frame per FIFO read and a linear table search */
+static uint32_t baseline_drain(MCAN_Type *mcan)
+{
+    const hpm_mcan_rx_route_t *route;
+    mcan_rx_message_t frame;
+    uint32_t index;
+    uint32_t count = 0;
+
+    while (mcan_read_rxfifo(mcan, 0, &frame) == status_success) {
+        route = linear_lookup(frame_key(&frame));
+        index = (route != NULL) ? route->queue : TEST_QUEUES;
+        s_base_buf[index][s_base_head[index]++ % TEST_QUEUE_SIZE] = frame;
+        count++;
+    }
+    return count;
+}
+
+/* host ns per frame of a route search over frames already read */
+static double time_lookup(bool bisect, const mcan_rx_message_t *frames, uint32_t count)
+{
+    const hpm_mcan_rx_route_t *route;
+    uint64_t start;
+    uint32_t found = 0;
+
+    start = now_ns();
+    for (uint32_t i = 0; i < TEST_LOOKUPS; i++) {
+        route = bisect ? hpm_mcan_rx_lookup(&s_dispatcher, frame_key(&frames[i % count]))
+                       : linear_lookup(frame_key(&frames[i % count]));
+        found += (route != NULL) ? route->queue + 1U : 0U;
+    }
+    s_found = found;
+    return (double)(now_ns() - start) / TEST_LOOKUPS;
+}
+
+int main(void)
+{
+    MCAN_Type *mcan;
+    hpm_host_sim_block_t *block;
+    mcan_config_t config;
+    hpm_mcan_rx_route_t bad[3];
+    const hpm_mcan_rx_route_t *route;
+    uint32_t fifo_size;
+    uint32_t sent;
+    uint32_t frames = 0;
+    uint32_t unrouted = 0;
+    uint32_t expected_drops = 0;
+    uint32_t level;
+    uint32_t key;
+    uint32_t dispatch_reads = 0;
+    uint32_t dispatch_writes = 0;
+    uint32_t base_reads = 0;
+    uint32_t base_writes = 0;
+    uint32_t bench_frames = 0;
+    double linear_ns;
+    double bisect_ns;
+
+    CHECK(hpm_host_sim_mcan_init(&s_mcan, NULL, NULL));
+    mcan = hpm_host_sim_mcan_base(&s_mcan);
+    block = s_mcan.block;
+    mcan_get_default_config(mcan, &config);
+    config.baudrate = 500000;
+    CHECK(mcan_init(mcan, &config, 80000000UL) == status_success);
+    fifo_size = MCAN_RXF0C_F0S_GET(hpm_host_sim_peek(block, offsetof(MCAN_Type, RXF0C)));
+    CHECK((fifo_size >= HPM_MCAN_RX_BURST) && (fifo_size <= TEST_MAX_FIFO));
+    CHECK(MCAN_RXESC_F0DS_GET(hpm_host_sim_peek(block, offsetof(MCAN_Type, RXESC))) == MCAN_DATA_FIELD_SIZE_8BYTES);
+
+    /* queues are a power of 2 */
+    CHECK(hpm_mcan_rx_queue_init(&s_default, s_default_buf, 48) == status_invalid_argument);
+    CHECK(hpm_mcan_rx_queue_init(&s_default, s_default_buf, 0) == status_invalid_argument);
+    CHECK(hpm_mcan_rx_queue_init(&s_default, s_default_buf, TEST_QUEUE_SIZE) == status_success);
+    for (uint32_t q = 0; q < TEST_QUEUES; q++) {
+        CHECK(hpm_mcan_rx_queue_init(&s_queue[q], s_queue_buf[q], TEST_QUEUE_SIZE) == status_success);
+        s_queues[q] = &s_queue[q];
+    }
+    CHECK(hpm_mcan_rx_queue_peek(&s_default) == NULL);
+    hpm_mcan_rx_queue_pop(&s_default);
+    CHECK(hpm_mcan_rx_queue_count(&s_default) == 0U);
+
+    /* duplicate keys and routes to a missing queue are rejected */
+    bad[0] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x123, false), 0 };
+    bad[1] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x123, true), 1 };
+    bad[2] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x123, false), 2 };
+    CHECK(hpm_mcan_rx_dispatcher_init(&s_dispatcher, mcan, bad, 3, s_queues, TEST_QUEUES, NULL)
+          == status_invalid_argument);
+    /* the failed call has sorted the table already */
+    bad[0] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x123, true), 1 };
+    bad[1] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x7FF, false), TEST_QUEUES };
+    bad[2] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x123, false), 0 };
+    CHECK(hpm_mcan_rx_dispatcher_init(&s_dispatcher, mcan, bad, 3, s_queues, TEST_QUEUES, NULL)
+          == status_invalid_argument);
+    bad[0] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x123, true), 1 };
+    bad[1] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x7FF, false), 2 };
+    bad[2] = (hpm_mcan_rx_route_t){ HPM_MCAN_RX_KEY(0x123, false), 0 };
+    CHECK(hpm_mcan_rx_dispatcher_init(&s_dispatcher, mcan, bad, 3, s_queues, TEST_QUEUES, NULL) == status_success);
+    /* standard identifiers sort before extended ones of the same value */
+    CHECK((bad[0].key == 0x123U) && (bad[1].key == 0x7FFU) && (bad[2].key == (0x123U | HPM_MCAN_RX_KEY_EXT))
+          && (bad[0].queue == 0U) && (bad[1].queue == 2U) && (bad[2].queue == 1U));
+
+    /* the bisection finds what a linear search finds */
+    make_routes();
+    CHECK(hpm_mcan_rx_dispatcher_init(&s_dispatcher, mcan, s_routes, TEST_ROUTES, s_queues, TEST_QUEUES, &s_default)
+          == status_success);
+    for (uint32_t i = 1; i < TEST_ROUTES; i++) {
+        CHECK(s_routes[i - 1U].key < s_routes[i].key);
+    }
+    for (uint32_t i = 0; i < TEST_ROUTES; i++) {
+        route = hpm_mcan_rx_lookup(&s_dispatcher, s_linear[i].key);
+        CHECK((route != NULL) && (route->key == s_linear[i].key) && (route->queue == s_linear[i].queue));
+    }
+    for (uint32_t i = 0; i < 10000U; i++) {
+        key = ((rnd() & 1U) != 0U) ? HPM_MCAN_RX_KEY(rnd() & 0x1FFFFFFFU, true) : HPM_MCAN_RX_KEY(rnd() & 0x7FFU, false);
+        route = hpm_mcan_rx_lookup(&s_dispatcher, key);
+        CHECK((route == NULL) == (linear_lookup(key) == NULL));
+    }
+    CHECK(hpm_mcan_rx_lookup(&s_dispatcher, 0xFFFFFFFFU) == NULL);
+
+    /* random fill levels, every frame ends up in its queue in order */
+    CHECK(hpm_mcan_rx_dispatch(&s_dispatcher, 0) == 0U);
+    CHECK(s_dispatcher.stat.bursts == 0U);
+    for (uint32_t r = 0; r < TEST_ROUNDS; r++) {
+        sent = 1U + (rnd() % fifo_size);
+        CHECK(fill_fifo(sent) == sent);
+        CHECK(hpm_mcan_rx_dispatch(&s_dispatcher, 0) == sent);
+        for (uint32_t n = 0; n < sent; n++) {
+            unrouted += (linear_lookup(frame_key(&s_sent[n])) == NULL) ? 1U : 0U;
+        }
+        frames += sent;
+        for (uint32_t q = 0; q < TEST_QUEUES; q++) {
+            CHECK(queue_matches(&s_queue[q], (int32_t)q, sent));
+        }
+        CHECK(queue_matches(&s_default, -1, sent));
+    }
+    CHECK(s_dispatcher.stat.frames == frames);
+    CHECK(s_dispatcher.stat.unrouted == unrouted);
+    CHECK((unrouted != 0U) && (unrouted < frames));
+    CHECK(s_dispatcher.stat.bursts >= (frames + HPM_MCAN_RX_BURST - 1U) / HPM_MCAN_RX_BURST);
+    CHECK(MCAN_RXF0S_F0FL_GET(hpm_host_sim_peek(block, offsetof(MCAN_Type, RXF0S))) == 0U);
+
+    /* a consumer that stops loses the frames beyond its queue, the others go on */
+    level = 0;
+    for (uint32_t r = 0; r < TEST_OVERFLOW_ROUNDS; r++) {
+        sent = fill_fifo(fifo_size);
+        CHECK(sent == fifo_size);
+        CHECK(hpm_mcan_rx_dispatch(&s_dispatcher, 0) == sent);
+        for (uint32_t n = 0; n < sent; n++) {
+            route = linear_lookup(frame_key(&s_sent[n]));
+            if ((route != NULL) && (route->queue == 0U)) {
+                if (level == TEST_QUEUE_SIZE) {
+                    expected_drops++;
+                } else {
+                    level++;
+                }
+            }
+        }
+        CHECK(hpm_mcan_rx_queue_count(&s_queue[0]) == level);
+        for (uint32_t q = 1; q < TEST_QUEUES; q++) {
+            CHECK(queue_matches(&s_queue[q], (int32_t)q, sent));
+        }
+        CHECK(queue_matches(&s_default, -1, sent));
+    }
+    CHECK(s_queue[0].dropped == expected_drops);
+    CHECK(s_queue[0].dropped != 0U);
+    CHECK((s_queue[1].dropped == 0U) && (s_default.dropped == 0U));
+    while (hpm_mcan_rx_queue_peek(&s_queue[0]) != NULL) {
+        hpm_mcan_rx_queue_pop(&s_queue[0]);
+    }
+
+    /* full FIFOs through the dispatcher and through the per frame baseline */
+    for (uint32_t r = 0; r < TEST_BENCH_ROUNDS; r++) {
+        CHECK(fill_fifo(fifo_size) == fifo_size);
+        hpm_host_sim_block_reset_stat(block);
+        CHECK(hpm_mcan_rx_dispatch(&s_dispatcher, 0) == fifo_size);
+        dispatch_reads += block->reads;
+        dispatch_writes += block->writes;
+        for (uint32_t q = 0; q < TEST_QUEUES; q++) {
+            CHECK(queue_matches(&s_queue[q], (int32_t)q, fifo_size));
+        }
+        CHECK(queue_matches(&s_default, -1, fifo_size));
+
+        CHECK(fill_fifo(fifo_size) == fifo_size);
+        hpm_host_sim_block_reset_stat(block);
+        CHECK(baseline_drain(mcan) == fifo_size);
+        base_reads += block->reads;
+        base_writes += block->writes;
+        bench_frames += fifo_size;
+    }
+    /* the searches are timed on the frames of the last FIFO, away from the trapped accesses */
+    linear_ns = time_lookup(false, s_sent, fifo_size);
+    bisect_ns = time_lookup(true, s_sent, fifo_size);
+    printf("%u routes, FIFO of %u frames, burst of %u, per frame:\n", TEST_ROUTES, fifo_size, HPM_MCAN_RX_BURST);
+    printf("  mcan_read_rxfifo + linear search: %.2f reads, %.2f writes, search %.1f ns (%.2f M frames/s)\n",
+           (double)base_reads / bench_frames, (double)base_writes / bench_frames, linear_ns, 1000.0 / linear_ns);
+    printf("  hpm_mcan_rx_dispatch:             %.2f reads, %.2f writes, search %.1f ns (%.2f M frames/s)\n",
+           (double)dispatch_reads / bench_frames, (double)dispatch_writes / bench_frames, bisect_ns, 1000.0 / bisect_ns);
+    CHECK(dispatch_reads + dispatch_writes < base_reads + base_writes);
+    CHECK(dispatch_writes < base_writes);
+
+    hpm_host_sim_mcan_deinit(&s_mcan);
+    return 0;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_mcl_encoder.h"
+
+/*
+ * Speed and angle methods of the hpm_mcl_v2 encoder layer on ground truth
+ * trajectories. The shaft of an ABZ encoder of TEST_PRECISION counts per turn
+ * follows each trajectory, sampled TEST_SUBSTEPS times per handler call; the
+ * time of every count change is interpolated between the samples, so each
+ * call sees the count and the age of its edge as QEIv2 latches them. The
+ * M, T, M-T and PLL methods get the count as angle through get_theta and
+ * their speed through the IIR filter of the bldc_foc sample, the observer
+ * gets count and edge age through get_edge. Per trajectory and method the
+ * speed and electrical angle errors after the settling time are reported,
+ * with the host time per hpm_mcl_encoder_process() call.
+ * Every method must give finite results. The observer must beat every other
+ * method on angle error, and on speed error unless the count rate is below
+ * ten times its bandwidth, where its speed ripples between the edges while
+ * the other methods sit behind a 100 Hz filter. It must stay within half a
+ * count of the true angle at constant speed, follow a reversal with the
+ * right sign and report zero speed once the shaft has stood still for
+ * timeout_s.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_PRECISION      (4000U)
+#define TEST_CALL_FREQ      (20000U)
+#define TEST_MCU_CLOCK      (480000000)
+#define TEST_TICKS          (TEST_MCU_CLOCK / TEST_CALL_FREQ)
+#define TEST_SUBSTEPS       (64U)
+#define TEST_POLE_NUM       (2)
+#define TEST_CALLS          (3U * TEST_CALL_FREQ / 2U)    /* 1.5 s */
+#define TEST_BANDWIDTH_HZ   (200.0f)
+#define TEST_TIMEOUT_S      (0.2f)
+#define TEST_2PI            (6.283185307179586)
+
+typedef struct {
+    const char *name;
+    double (*turns)(double t);
+    double (*speed)(double t);      /* turns/s */
+    double settle_s;                /* errors are taken after this time */
+    bool constant;                  /* constant speed after settle_s */
+    bool few_counts;                /* under ten counts per 1 / TEST_BANDWIDTH_HZ */
+} test_trajectory_t;
+
+typedef struct {
+    const char *name;
+    mcl_encoder_cal_speed_function_t method;
+} test_method_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t edge_age_tick;
+    double turns;
+    double speed;
+} test_sample_t;
+
+typedef struct {
+    double speed_sq;
+    double speed_max;
+    double theta_sq;
+    double theta_max;
+    uint32_t samples;
+    uint32_t wrong_sign;
+    bool finite;
+    uint64_t ns;
+} test_result_t;
+
+static test_sample_t s_samples[TEST_CALLS + 1U];
+static const test_sample_t *s_sample;
+static mcl_cfg_t s_mcl_cfg;
+static mcl_encoer_cfg_t s_encoder_cfg;
+static mcl_encoder_t s_encoder;
+static mcl_filter_iir_df1_cfg_t s_iir_cfg;
+static mcl_filter_iir_df1_matrix_t s_iir_matrix[2];
+static mcl_filter_iir_df1_memory_t s_iir_mem[2];
+static mcl_filter_iir_df1_t s_iir;
+
+/* ground truth, turns and turns/s */
+static double slow_turns(double t)
+{
+    return 0.25 * t;
+}
+
+static double slow_speed(double t)
+{
+    (void)t;
+    return 0.25;
+}
+
+static double fast_turns(double t)
+{
+    return 50.0 * t;
+}
+
+static double fast_speed(double t)
+{
+    (void)t;
+    return 50.0;
+}
+
+/* 0 to 50 turns/s in 0.5 s, then constant */
+static double ramp_turns(double t)
+{
+    return (t < 0.5) ? (50.0 * t * t) : (12.5 + 50.0 * (t - 0.5));
+}
+
+static double ramp_speed(double t)
+{
+    return (t < 0.5) ? (100.0 * t) : 50.0;
+}
+
+/* 200 counts either side at 5 Hz, through zero speed twice per period */
+static double reverse_turns(double t)
+{
+    return 0.05 * sin(TEST_2PI * 5.0 * t);
+}
+
+static double reverse_speed(double t)
+{
+    return 0.05 * TEST_2PI * 5.0 * cos(TEST_2PI * 5.0 * t);
+}
+
+/* 5 turns/s, standing still from 0.75 s */
+static double stop_turns(double t)
+{
+    return (t < 0.75) ? (5.0 * t) : 3.75;
+}
+
+static double stop_speed(double t)
+{
+    return (t < 0.75) ? 5.0 : 0.0;
+}
+
+static const test_trajectory_t s_trajectories[] = {
+    { "slow 0.25 turn/s", slow_turns, slow_speed, 0.5, true, true },
+    { "fast 50 turn/s", fast_turns, fast_speed, 0.5, true, false },
+    { "ramp 100 turn/s2", ramp_turns, ramp_speed, 0.1, false, false },
+    { "reverse 5 Hz", reverse_turns, reverse_speed, 0.5, false, false },
+    { "stop", stop_turns, stop_speed, 0.5, false, false },
+};
+
+static const test_method_t s_methods[] = {
+    { "M", encoder_method_m },
+    { "T", encoder_method_t },
+    { "M-T", encoder_method_m_t },
+    { "PLL", encoder_method_pll },
+    { "observer", encoder_method_observer },
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static int64_t count_at(double turns)
+{
+    return (int64_t)floor(turns * TEST_PRECISION);
+}
+
+static uint32_t count_wrap(int64_t count)
+{
+    return (uint32_t)(((count % (int64_t)TEST_PRECISION) + (int64_t)TEST_PRECISION) % (int64_t)TEST_PRECISION);
+}
+
+/* counts and edge ages the handler sees, the edge time is interpolated between substeps */
+static void generate(const test_trajectory_t *trajectory)
+{
+    double dt = 1.0 / TEST_CALL_FREQ / TEST_SUBSTEPS;
+    double edge_time = -1.0;
+    double turns_last = trajectory->turns(0);
+    int64_t count_last = count_at(turns_last);
+
+    for (uint32_t call = 0; call <= TEST_CALLS; call++) {
+        double t_call = (double)call / TEST_CALL_FREQ;
+        double age;
+
+        for (uint32_t step = 1; (call != 0U) && (step <= TEST_SUBSTEPS); step++) {
+            double t = t_call - 1.0 / TEST_CALL_FREQ + step * dt;
+            double turns = trajectory->turns(t);
+            int64_t count = count_at(turns);
+
+            if (count != count_last) {
+                /* the boundary last crossed */
+                double boundary = (double)((count > count_last) ? count : count_last) / TEST_PRECISION;
+
+                edge_time = t - dt + dt * (boundary - turns_last) / (turns - turns_last);
+                count_last = count;
+            }
+            turns_last = turns;
+        }
+        age = (edge_time < 0) ? 4294967295.0 : (t_call - edge_time) * TEST_MCU_CLOCK;
+        s_samples[call].count = count_wrap(count_last);
+        s_samples[call].edge_age_tick = (age >= 4294967295.0) ? UINT32_MAX : (uint32_t)age;
+        s_samples[call].turns = trajectory->turns(t_call);
+        s_samples[call].speed = trajectory->speed(t_call);
+    }
+}
+
+static hpm_mcl_stat_t encoder_init(void)
+{
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t encoder_start_sample(void)
+{
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t encoder_get_theta(float *theta)
+{
+    *theta = (float)s_sample->count * (MCL_2PI / TEST_PRECISION);
+    return mcl_success;
+}
+
+static hpm_mcl_stat_t encoder_get_edge(uint32_t *count, uint32_t *edge_age_tick)
+{
+    *count = s_sample->count;
+    *edge_age_tick = s_sample->edge_age_tick;
+    return mcl_success;
+}
+
+void mcl_user_delay_us(uint64_t tick)
+{
+    (void)tick;
+}
+
+static double wrap_pi(double angle)
+{
+    return angle - TEST_2PI * floor(angle / TEST_2PI + 0.5);
+}
+
+static hpm_mcl_stat_t run(const test_trajectory_t *trajectory, mcl_encoder_cal_speed_function_t method,
+                          test_result_t *result)
+{
+    float ts = 1.0f / TEST_CALL_FREQ;
+    float wn = 2.0f * MCL_PI * TEST_BANDWIDTH_HZ;
+    hpm_mcl_stat_t stat;
+    uint64_t start;
+
+    memset(result, 0, sizeof(*result));
+    result->finite = true;
+    s_mcl_cfg.physical.time.mcu_clock_tick = TEST_MCU_CLOCK;
+    s_mcl_cfg.physical.time.current_loop_ts = ts;
+    s_mcl_cfg.physical.motor.pole_num = TEST_POLE_NUM;
+
+    memset(&s_encoder_cfg, 0, sizeof(s_encoder_cfg));
+    s_encoder_cfg.disable_start_sample_interrupt = true;
+    s_encoder_cfg.speed_cal_method = method;
+    /* critically damped, natural frequency at the observer bandwidth */
+    s_encoder_cfg.cal_speed_pll_cfg.kp = 2.0f * wn;
+    s_encoder_cfg.cal_speed_pll_cfg.ki = wn * wn * ts;
+    s_encoder_cfg.cal_speed_observer_cfg.bandwidth_hz = TEST_BANDWIDTH_HZ;
+    s_encoder_cfg.timeout_s = TEST_TIMEOUT_S;
+    s_encoder_cfg.speed_abs_switch_m_t = 5;
+    s_encoder_cfg.precision = TEST_PRECISION;
+    s_encoder_cfg.period_call_time_s = ts;
+    s_encoder_cfg.callback.init = encoder_init;
+    s_encoder_cfg.callback.start_sample = encoder_start_sample;
+    s_encoder_cfg.callback.get_theta = encoder_get_theta;
+    s_encoder_cfg.callback.get_edge = encoder_get_edge;
+
+    /* bldc_foc sample: pass 100 Hz, stop 2000 Hz */
+    s_iir_cfg.section = 2;
+    s_iir_cfg.matrix = s_iir_matrix;
+    s_iir_matrix[0] = (mcl_filter_iir_df1_matrix_t){ 1, 2, 1, -1.947404031871316831825424742419272661209f,
+                                                     0.95152023575172306468772376319975592196f,
+                                                     0.001029050970101526990552187612593115773f };
+    s_iir_matrix[1] = (mcl_filter_iir_df1_matrix_t){ 1, 2, 1, -1.88285893096534651114382086234400048852f,
+                                                     0.886838706662149367510039610351668670774f,
+                                                     0.000994943924200649039424337871651005116f };
+    s_iir.cfg = &s_iir_cfg;
+    s_iir.mem = s_iir_mem;
+
+    s_sample = &s_samples[0];
+    stat = hpm_mcl_encoder_init(&s_encoder, &s_mcl_cfg, &s_encoder_cfg, &s_iir);
+    if (stat != mcl_success) {
+        return stat;
+    }
+
+    start = now_ns();
+    for (uint32_t call = 1; call <= TEST_CALLS; call++) {
+        s_sample = &s_samples[call];
+        stat = hpm_mcl_encoder_process(&s_encoder, TEST_TICKS);
+        if (stat != mcl_success) {
+            return stat;
+        }
+        if (!isfinite(s_encoder.result.speed) || !isfinite(s_encoder.result.theta)) {
+            result->finite = false;
+        }
+        if ((double)call / TEST_CALL_FREQ >= trajectory->settle_s) {
+            double speed_err = (double)s_encoder.result.speed - TEST_2PI * s_sample->speed;
+            double theta_err = wrap_pi((double)s_encoder.result.theta - TEST_2PI * TEST_POLE_NUM * s_sample->turns);
+
+            result->speed_sq += speed_err * speed_err;
+            result->speed_max = fmax(result->speed_max, fabs(speed_err));
+            result->theta_sq += theta_err * theta_err;
+            result->theta_max = fmax(result->theta_max, fabs(theta_err));
+            /* a clear direction, beyond one count per 20 calls */
+            if ((fabs(s_sample->speed) * TEST_PRECISION > TEST_CALL_FREQ / 20U)
+                && ((s_encoder.result.speed > 0) != (s_sample->speed > 0))) {
+                result->wrong_sign++;
+            }
+            result->samples++;
+        }
+    }
+    result->ns = now_ns() - start;
+    return mcl_success;
+}
+
+int main(void)
+{
+    test_result_t results[ARRAY_SIZE(s_methods)];
+    double count_rad = TEST_2PI * TEST_POLE_NUM / TEST_PRECISION;
+
+    printf("%u counts/turn, %u calls/s, errors after settling: speed rad/s rms/max, electrical angle count rms/max\n",
+           (unsigned int)TEST_PRECISION, (unsigned int)TEST_CALL_FREQ);
+    for (uint32_t i = 0; i < ARRAY_SIZE(s_trajectories); i++) {
+        const test_trajectory_t *trajectory = &s_trajectories[i];
+        const test_result_t *observer = &results[ARRAY_SIZE(s_methods) - 1U];
+
+        generate(trajectory);
+        printf("%s\n", trajectory->name);
+        for (uint32_t m = 0; m < ARRAY_SIZE(s_methods); m++) {
+            test_result_t *result = &results[m];
+
+            CHECK(run(trajectory, s_methods[m].method, result) == mcl_success);
+            printf("  %-8s speed %9.3f %9.3f  angle %7.3f %7.3f  %5.1f ns/call%s\n", s_methods[m].name,
+                   sqrt(result->speed_sq / result->samples), result->speed_max,
+                   sqrt(result->theta_sq / result->samples) / count_rad, result->theta_max / count_rad,
+                   (double)result->ns / TEST_CALLS, result->finite ? "" : "  not finite");
+            CHECK(result->finite);
+        }
+        for (uint32_t m = 0; m < ARRAY_SIZE(s_methods) - 1U; m++) {
+            CHECK(observer->theta_sq < results[m].theta_sq);
+            /* between sparse edges the observer speed ripples with its bandwidth */
+            CHECK(trajectory->few_counts || (observer->speed_sq < results[m].speed_sq));
+        }
+        if (trajectory->constant) {
+            CHECK(observer->theta_max < 0.5 * count_rad);
+        }
+        CHECK(observer->wrong_sign == 0U);
+        if (trajectory->turns == stop_turns) {
+            /* standing still for longer than timeout_s at the end */
+            CHECK(s_encoder.result.speed == 0.0f);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+/*
+ * What MemMang/heap_4.c takes from FreeRTOS.h, for the host: one thread, no
+ * scheduler to suspend, no critical sections.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+
+#ifndef configTOTAL_HEAP_SIZE
+#define configTOTAL_HEAP_SIZE               (64U * 1024U)
+#endif
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#define configAPPLICATION_ALLOCATED_HEAP    0
+#define configUSE_MALLOC_FAILED_HOOK        0
+#define configASSERT(x)                     assert(x)
+
+#define portBYTE_ALIGNMENT                  8
+#define portBYTE_ALIGNMENT_MASK             (0x0007)
+#define portPOINTER_SIZE_TYPE               uintptr_t
+#define portMAX_DELAY                       ((size_t)-1)
+
+#define PRIVILEGED_FUNCTION
+#define PRIVILEGED_DATA
+#define mtCOVERAGE_TEST_MARKER()
+#define traceMALLOC(pvAddress, uiSize)
+#define traceFREE(pvAddress, uiSize)
+
+typedef struct xHeapStats {
+    size_t xAvailableHeapSpaceInBytes;
+    size_t xSizeOfLargestFreeBlockInBytes;
+    size_t xSizeOfSmallestFreeBlockInBytes;
+    size_t xNumberOfFreeBlocks;
+    size_t xMinimumEverFreeBytesRemaining;
+    size_t xNumberOfSuccessfulAllocations;
+    size_t xNumberOfSuccessfulFrees;
+} HeapStats_t;
+
+void *pvPortMalloc(size_t xSize);
+void vPortFree(void *pv);
+void vPortInitialiseBlocks(void);
+size_t xPortGetFreeHeapSize(void);
+size_t xPortGetMinimumEverFreeHeapSize(void);
+void vPortGetHeapStats(HeapStats_t *pxHeapStats);
+
+#endif /* INC_FREERTOS_H */
@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+/* single threaded host, nothing to suspend */
+#define vTaskSuspendAll()
+#define xTaskResumeAll()        (0)
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#endif /* INC_TASK_H */
@@ -0,0 +1,512 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_mem_heap.h"
+#include "FreeRTOS.h"
+
+/*
+ * Region aware TLSF heap on static arrays standing in for DLM, AXI SRAM and
+ * noncacheable RAM. Checks the region chosen for each capability set, the
+ * HPM_MEM_DMA cache line rule, aligned allocations, calloc, falling through
+ * to the next region and the region statistics. A random run of mixed
+ * capabilities, sizes and alignments fills every block with a pattern and
+ * checks it on release, and all regions must coalesce back to one free
+ * block in the end.
+ *
+ * Then the same random workload runs on a TLSF region and on FreeRTOS
+ * heap_4 of the same size: the load at the first failed allocation when
+ * filling with random releases in between, failed allocations and ns per
+ * malloc and free (mean, 99.9 percentile, max) when churning at 70 % load,
+ * and the free blocks left behind.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_DLM_SIZE       (32U * 1024U)
+#define TEST_AXI_SIZE       (256U * 1024U)
+#define TEST_NC_SIZE        (16U * 1024U)
+#define TEST_BENCH_SIZE     (configTOTAL_HEAP_SIZE)
+#define TEST_RANDOM_OPS     (100000U)
+#define TEST_MAX_LIVE       (512U)
+#define TEST_BENCH_OPS      (200000U)
+#define TEST_BENCH_LOAD     (70U)
+
+typedef struct {
+    uint8_t *ptr;
+    uint32_t size;
+    uint8_t pattern;
+} test_block_t;
+
+typedef struct {
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*release)(void *ptr);
+    void (*report)(void);
+    uint32_t capacity;
+} test_heap_t;
+
+enum {
+    test_region_dlm,
+    test_region_axi,
+    test_region_nc,
+    test_region_bench,
+    test_region_count,
+};
+
+static uint8_t s_dlm[TEST_DLM_SIZE] __attribute__((aligned(8)));
+static uint8_t s_axi[TEST_AXI_SIZE] __attribute__((aligned(8)));
+static uint8_t s_nc[TEST_NC_SIZE] __attribute__((aligned(8)));
+static uint8_t s_bench[TEST_BENCH_SIZE + 8192U] __attribute__((aligned(8)));
+static uint8_t s_small[64] __attribute__((aligned(8)));
+static uint32_t s_initial_largest[test_region_count];
+static test_block_t s_blocks[TEST_MAX_LIVE];
+static uint32_t s_alloc_ns[TEST_BENCH_OPS];
+static uint32_t s_free_ns[TEST_BENCH_OPS];
+static uint32_t s_clock_ns;
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* cost of the now_ns() pair around a timed call, taken off every sample */
+static void measure_clock(void)
+{
+    uint64_t total = 0;
+    uint64_t start;
+
+    for (uint32_t i = 0; i < TEST_BENCH_OPS; i++) {
+        start = now_ns();
+        s_alloc_ns[i] = (uint32_t)(now_ns() - start);
+    }
+    qsort(s_alloc_ns, TEST_BENCH_OPS, sizeof(s_alloc_ns[0]), compare_u32);
+    for (uint32_t i = 0; i < TEST_BENCH_OPS / 2U; i++) {
+        total += s_alloc_ns[i];
+    }
+    s_clock_ns = (uint32_t)(total / (TEST_BENCH_OPS / 2U));
+}
+
+static uint32_t net_ns(uint64_t start)
+{
+    uint32_t ns = (uint32_t)(now_ns() - start);
+
+    return (ns > s_clock_ns) ? ns - s_clock_ns : 0U;
+}
+
+static int region_of(const void *ptr)
+{
+    static const struct {
+        const uint8_t *start;
+        uint32_t size;
+    } regions[] = {
+        { s_dlm, sizeof(s_dlm) }, { s_axi, sizeof(s_axi) }, { s_nc, sizeof(s_nc) }, { s_bench, sizeof(s_bench) },
+    };
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(regions); i++) {
+        if (((const uint8_t *)ptr >= regions[i].start) && ((const uint8_t *)ptr < regions[i].start + regions[i].size)) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static uint32_t region_free(uint32_t index)
+{
+    hpm_mem_heap_stat_t stat;
+
+    hpm_mem_heap_get_stat(index, &stat);
+    return stat.free_size;
+}
+
+/* random size, mostly small blocks */
+static uint32_t random_size(void)
+{
+    uint32_t kind = rnd() % 100U;
+
+    if (kind < 70U) {
+        return 8U + rnd() % 120U;
+    }
+    if (kind < 95U) {
+        return 128U + rnd() % 896U;
+    }
+    return 1024U + rnd() % 3072U;
+}
+
+static void fill_block(test_block_t *block)
+{
+    block->pattern = (uint8_t)rnd();
+    for (uint32_t i = 0; i < block->size; i++) {
+        block->ptr[i] = (uint8_t)(block->pattern + i);
+    }
+}
+
+static bool block_intact(const test_block_t *block)
+{
+    for (uint32_t i = 0; i < block->size; i++) {
+        if (block->ptr[i] != (uint8_t)(block->pattern + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int test_regions(void)
+{
+    hpm_mem_heap_stat_t stat;
+    uint8_t *p;
+    uint8_t *q;
+    uint8_t *held[64];
+    uint32_t held_count = 0;
+    uint32_t free_size;
+    uint32_t failed;
+
+    CHECK(hpm_mem_heap_add_region("dlm", s_dlm, sizeof(s_dlm), HPM_MEM_FAST | HPM_MEM_INTERNAL) == status_success);
+    CHECK(hpm_mem_heap_add_region("axi_sram", s_axi, sizeof(s_axi), HPM_MEM_DMA | HPM_MEM_INTERNAL) == status_success);
+    CHECK(hpm_mem_heap_add_region("noncacheable", s_nc, sizeof(s_nc), HPM_MEM_DMA | HPM_MEM_NONCACHEABLE)
+          == status_success);
+    /* as much usable memory as heap_4 gets: add what the DLM region lost to the TLSF control block */
+    hpm_mem_heap_get_stat(test_region_dlm, &stat);
+    CHECK(hpm_mem_heap_add_region("bench", s_bench, TEST_BENCH_SIZE + (TEST_DLM_SIZE - stat.total_size),
+                                  HPM_MEM_EXTERNAL) == status_success);
+    CHECK(hpm_mem_heap_get_region_count() == test_region_count);
+
+    /* overlapping, too small and missing regions */
+    CHECK(hpm_mem_heap_add_region("overlap", &s_axi[4096], 4096, HPM_MEM_DMA) == status_invalid_argument);
+    CHECK(hpm_mem_heap_add_region("small", s_small, sizeof(s_small), HPM_MEM_DMA) == status_invalid_argument);
+    CHECK(hpm_mem_heap_add_region("null", NULL, 4096, HPM_MEM_DMA) == status_invalid_argument);
+    CHECK(hpm_mem_heap_get_region_count() == test_region_count);
+    CHECK(hpm_mem_heap_get_stat(test_region_count, &stat) == status_invalid_argument);
+
+    for (uint32_t i = 0; i < test_region_count; i++) {
+        CHECK(hpm_mem_heap_get_stat(i, &stat) == status_success);
+        CHECK((stat.free_size == stat.total_size) && (stat.min_free_size == stat.total_size));
+        CHECK((stat.largest_free > 0U) && (stat.largest_free < stat.total_size));
+        s_initial_largest[i] = stat.largest_free;
+    }
+
+    /* the first region with all capabilities, noncacheable only on request */
+    p = hpm_malloc_caps(100, HPM_MEM_DEFAULT);
+    CHECK((region_of(p) == test_region_dlm) && (((uintptr_t)p % 8U) == 0U));
+    hpm_free(p);
+    p = hpm_malloc_caps(100, HPM_MEM_DMA);
+    CHECK((region_of(p) == test_region_axi) && (((uintptr_t)p % HPM_MEM_HEAP_CACHELINE_SIZE) == 0U));
+    hpm_free(p);
+    p = hpm_malloc_caps(100, HPM_MEM_NONCACHEABLE);
+    CHECK(region_of(p) == test_region_nc);
+    hpm_free(p);
+    p = hpm_malloc_caps(100, HPM_MEM_DMA | HPM_MEM_NONCACHEABLE);
+    CHECK((region_of(p) == test_region_nc) && (((uintptr_t)p % HPM_MEM_HEAP_CACHELINE_SIZE) == 0U));
+    hpm_free(p);
+    p = hpm_malloc_caps(100, HPM_MEM_EXTERNAL);
+    CHECK(region_of(p) == test_region_bench);
+    hpm_free(p);
+    CHECK(hpm_malloc_caps(100, HPM_MEM_FAST | HPM_MEM_DMA) == NULL);
+    CHECK(hpm_malloc_caps(0, HPM_MEM_DEFAULT) == NULL);
+
+    /* DMA blocks take whole cache lines, the next block starts on the next line */
+    p = hpm_malloc_caps(1, HPM_MEM_DMA);
+    q = hpm_malloc_caps(1, HPM_MEM_DMA);
+    CHECK((p != NULL) && (q != NULL));
+    CHECK((((uintptr_t)p | (uintptr_t)q) % HPM_MEM_HEAP_CACHELINE_SIZE) == 0U);
+    CHECK(((q > p) ? (uint32_t)(q - p) : (uint32_t)(p - q)) >= HPM_MEM_HEAP_CACHELINE_SIZE);
+    hpm_free(p);
+    hpm_free(q);
+
+    /* aligned allocations */
+    for (uint32_t align = 16; align <= 4096U; align <<= 1) {
+        p = hpm_aligned_malloc_caps(align + 3U, align, HPM_MEM_INTERNAL);
+        CHECK((p != NULL) && (((uintptr_t)p % align) == 0U));
+        memset(p, 0xA5, align + 3U);
+        held[held_count++] = p;
+    }
+    CHECK(hpm_aligned_malloc_caps(100, 24, HPM_MEM_DEFAULT) == NULL);
+    while (held_count > 0U) {
+        hpm_free(held[--held_count]);
+    }
+
+    /* calloc zeroes reused memory and rejects overflowing products */
+    p = hpm_malloc_caps(1000, HPM_MEM_DEFAULT);
+    memset(p, 0xFF, 1000);
+    hpm_free(p);
+    q = hpm_calloc_caps(250, 4, HPM_MEM_DEFAULT);
+    CHECK(q != NULL);
+    for (uint32_t i = 0; i < 1000U; i++) {
+        CHECK(q[i] == 0U);
+    }
+    hpm_free(q);
+    CHECK(hpm_calloc_caps(SIZE_MAX / 2U, 4, HPM_MEM_DEFAULT) == NULL);
+    hpm_free(NULL);
+
+    /* a full DLM falls through to the AXI SRAM and counts the failure */
+    hpm_mem_heap_get_stat(test_region_dlm, &stat);
+    failed = stat.failed_count;
+    while (held_count < ARRAY_SIZE(held)) {
+        p = hpm_malloc_caps(4096, HPM_MEM_INTERNAL);
+        CHECK(p != NULL);
+        held[held_count++] = p;
+        if (region_of(p) != test_region_dlm) {
+            break;
+        }
+    }
+    CHECK(region_of(held[held_count - 1U]) == test_region_axi);
+    hpm_mem_heap_get_stat(test_region_dlm, &stat);
+    CHECK((stat.failed_count == failed + 1U) && (stat.free_size < 4096U + 64U));
+    CHECK(hpm_mem_heap_get_free_size(HPM_MEM_FAST) == stat.free_size);
+    free_size = region_free(test_region_dlm) + region_free(test_region_axi) + region_free(test_region_bench);
+    CHECK(hpm_mem_heap_get_free_size(HPM_MEM_DEFAULT) == free_size);
+    CHECK(hpm_mem_heap_get_free_size(HPM_MEM_NONCACHEABLE) == region_free(test_region_nc));
+    while (held_count > 0U) {
+        hpm_free(held[--held_count]);
+    }
+
+    for (uint32_t i = 0; i < test_region_count; i++) {
+        hpm_mem_heap_get_stat(i, &stat);
+        CHECK((stat.free_size == stat.total_size) && (stat.largest_free == s_initial_largest[i]));
+        CHECK(stat.alloc_count == stat.free_count);
+    }
+    hpm_mem_heap_get_stat(test_region_dlm, &stat);
+    CHECK(stat.min_free_size < 4096U + 64U);
+    return 0;
+}
+
+static int test_random(void)
+{
+    static const uint32_t caps_set[] = {
+        HPM_MEM_DEFAULT, HPM_MEM_FAST, HPM_MEM_DMA, HPM_MEM_NONCACHEABLE, HPM_MEM_INTERNAL,
+    };
+    hpm_mem_heap_stat_t stat;
+    uint32_t live = 0;
+    uint32_t failed = 0;
+
+    for (uint32_t op = 0; op < TEST_RANDOM_OPS; op++) {
+        if ((live == TEST_MAX_LIVE) || ((live > 0U) && ((rnd() % 2U) == 0U))) {
+            uint32_t index = rnd() % live;
+
+            CHECK(block_intact(&s_blocks[index]));
+            hpm_free(s_blocks[index].ptr);
+            s_blocks[index] = s_blocks[--live];
+        } else {
+            uint32_t caps = caps_set[rnd() % ARRAY_SIZE(caps_set)];
+            uint32_t align = (rnd() % 4U == 0U) ? (8U << (rnd() % 8U)) : 0U;
+            test_block_t *block = &s_blocks[live];
+            int region;
+
+            block->size = 1U + rnd() % 3000U;
+            block->ptr = (align == 0U) ? hpm_malloc_caps(block->size, caps)
+                                       : hpm_aligned_malloc_caps(block->size, align, caps);
+            if (block->ptr == NULL) {
+                failed++;
+                continue;
+            }
+            region = region_of(block->ptr);
+            CHECK((region >= 0) && (region_of(&block->ptr[block->size - 1U]) == region));
+            CHECK((align == 0U) || (((uintptr_t)block->ptr % align) == 0U));
+            CHECK((((uintptr_t)block->ptr % 8U) == 0U));
+            switch (caps) {
+            case HPM_MEM_FAST:
+                CHECK(region == test_region_dlm);
+                break;
+            case HPM_MEM_DMA:
+                CHECK(region == test_region_axi);
+                break;
+            case HPM_MEM_NONCACHEABLE:
+                CHECK(region == test_region_nc);
+                break;
+            case HPM_MEM_INTERNAL:
+                CHECK((region == test_region_dlm) || (region == test_region_axi));
+                break;
+            default:
+                CHECK(region != test_region_nc);
+                break;
+            }
+            if ((caps & HPM_MEM_DMA) != 0U) {
+                CHECK(((uintptr_t)block->ptr % HPM_MEM_HEAP_CACHELINE_SIZE) == 0U);
+            }
+            fill_block(block);
+            live++;
+        }
+    }
+    while (live > 0U) {
+        live--;
+        CHECK(block_intact(&s_blocks[live]));
+        hpm_free(s_blocks[live].ptr);
+    }
+    for (uint32_t i = 0; i < test_region_count; i++) {
+        hpm_mem_heap_get_stat(i, &stat);
+        CHECK((stat.free_size == stat.total_size) && (stat.largest_free == s_initial_largest[i]));
+        CHECK(stat.alloc_count == stat.free_count);
+    }
+    printf("random: %u operations, %u allocations failed for lack of memory\n", (unsigned)TEST_RANDOM_OPS,
+           (unsigned)failed);
+    return 0;
+}
+
+static void *tlsf_alloc(size_t size)
+{
+    return hpm_malloc_caps(size, HPM_MEM_EXTERNAL);
+}
+
+static void tlsf_report(void)
+{
+    hpm_mem_heap_stat_t stat;
+
+    hpm_mem_heap_get_stat(test_region_bench, &stat);
+    printf("tlsf   after churn: %u bytes free, largest free block %u\n", (unsigned)stat.free_size,
+           (unsigned)stat.largest_free);
+}
+
+static void heap4_report(void)
+{
+    HeapStats_t stat;
+
+    vPortGetHeapStats(&stat);
+    printf("heap_4 after churn: %u bytes free, largest free block %u, %u free blocks to walk\n",
+           (unsigned)stat.xAvailableHeapSpaceInBytes, (unsigned)stat.xSizeOfLargestFreeBlockInBytes,
+           (unsigned)stat.xNumberOfFreeBlocks);
+}
+
+static void release_all(const test_heap_t *heap, uint32_t *live)
+{
+    while (*live > 0U) {
+        heap->release(s_blocks[--(*live)].ptr);
+    }
+}
+
+static int bench_heap(const test_heap_t *heap)
+{
+    uint32_t live = 0;
+    uint32_t live_bytes = 0;
+    uint32_t allocs = 0;
+    uint32_t frees = 0;
+    uint32_t failed = 0;
+    uint32_t fill_percent;
+    uint64_t alloc_total = 0;
+    uint64_t free_total = 0;
+    uint64_t start;
+
+    /* fill with random releases in between until the first allocation fails */
+    s_seed = 7;
+    while (true) {
+        if ((live > 0U) && ((rnd() % 3U) == 0U)) {
+            uint32_t index = rnd() % live;
+
+            live_bytes -= s_blocks[index].size;
+            heap->release(s_blocks[index].ptr);
+            s_blocks[index] = s_blocks[--live];
+            continue;
+        }
+        CHECK(live < TEST_MAX_LIVE);
+        s_blocks[live].size = random_size();
+        s_blocks[live].ptr = heap->alloc(s_blocks[live].size);
+        if (s_blocks[live].ptr == NULL) {
+            break;
+        }
+        live_bytes += s_blocks[live++].size;
+    }
+    fill_percent = (uint32_t)((uint64_t)live_bytes * 100U / heap->capacity);
+    release_all(heap, &live);
+    live_bytes = 0;
+
+    /* churn at TEST_BENCH_LOAD percent */
+    s_seed = 11;
+    for (uint32_t op = 0; op < TEST_BENCH_OPS; op++) {
+        if ((live_bytes * 100ULL) < ((uint64_t)heap->capacity * TEST_BENCH_LOAD)) {
+            test_block_t *block = &s_blocks[live];
+
+            CHECK(live < TEST_MAX_LIVE);
+            block->size = random_size();
+            start = now_ns();
+            block->ptr = heap->alloc(block->size);
+            s_alloc_ns[allocs] = net_ns(start);
+            alloc_total += s_alloc_ns[allocs++];
+            if (block->ptr == NULL) {
+                failed++;
+                continue;
+            }
+            fill_block(block);
+            live_bytes += block->size;
+            live++;
+        } else {
+            uint32_t index = rnd() % live;
+
+            CHECK(block_intact(&s_blocks[index]));
+            live_bytes -= s_blocks[index].size;
+            start = now_ns();
+            heap->release(s_blocks[index].ptr);
+            s_free_ns[frees] = net_ns(start);
+            free_total += s_free_ns[frees++];
+            s_blocks[index] = s_blocks[--live];
+        }
+    }
+    qsort(s_alloc_ns, allocs, sizeof(s_alloc_ns[0]), compare_u32);
+    qsort(s_free_ns, frees, sizeof(s_free_ns[0]), compare_u32);
+    printf("%-6s %u bytes: first failure at %u %% load; churn at %u %%: %u of %u allocations failed, "
+           "malloc %.0f / %u / %u ns, free %.0f / %u / %u ns (mean / 99.9 %% / max), %u blocks live\n",
+           heap->name, (unsigned)heap->capacity, (unsigned)fill_percent, (unsigned)TEST_BENCH_LOAD, (unsigned)failed,
+           (unsigned)allocs, (double)alloc_total / allocs, (unsigned)s_alloc_ns[allocs * 999U / 1000U],
+           (unsigned)s_alloc_ns[allocs - 1U], (double)free_total / frees, (unsigned)s_free_ns[frees * 999U / 1000U],
+           (unsigned)s_free_ns[frees - 1U], (unsigned)live);
+    heap->report();
+    release_all(heap, &live);
+    return 0;
+}
+
+static int test_bench(void)
+{
+    hpm_mem_heap_stat_t stat;
+    test_heap_t tlsf = { "tlsf", tlsf_alloc, hpm_free, tlsf_report, 0 };
+    test_heap_t heap4 = { "heap_4", pvPortMalloc, vPortFree, heap4_report, 0 };
+
+    hpm_mem_heap_get_stat(test_region_bench, &stat);
+    tlsf.capacity = stat.free_size;
+    vPortFree(pvPortMalloc(8));
+    heap4.capacity = (uint32_t)xPortGetFreeHeapSize();
+    measure_clock();
+    printf("host times below are net of %u ns per clock_gettime() pair\n", (unsigned)s_clock_ns);
+
+    CHECK(bench_heap(&tlsf) == 0);
+    hpm_mem_heap_get_stat(test_region_bench, &stat);
+    CHECK((stat.free_size == stat.total_size) && (stat.largest_free == s_initial_largest[test_region_bench]));
+    CHECK(bench_heap(&heap4) == 0);
+    CHECK(xPortGetFreeHeapSize() == heap4.capacity);
+    return 0;
+}
+
+int main(void)
+{
+    if ((test_regions() != 0) || (test_random() != 0) || (test_bench() != 0)) {
+        return 1;
+    }
+    return 0;
+}
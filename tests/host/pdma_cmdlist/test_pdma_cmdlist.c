@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include "hpm_host_sim.h"
+#include "hpm_pdma_cmdlist.h"
+
+/*
+ * PDMA model: setting EN completes the operation at once, STAT reports done
+ * or the injected error. STAT is write one to clear, SFTRST pulses are counted.
+ */
+typedef struct {
+    uint32_t starts;
+    uint32_t resets;
+    uint32_t inject_error;
+} pdma_model_t;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_FB_WIDTH   (480U)
+#define TEST_FB         (0x40000000UL)
+#define TEST_IMAGE      (0x40100000UL)
+
+static pdma_model_t s_model;
+static hpm_pdma_cmd_t s_cmds_a[8];
+static hpm_pdma_cmd_t s_cmds_b[8];
+static uint32_t s_callbacks;
+
+static void pdma_model_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                            hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    pdma_model_t *model = (pdma_model_t *)block->context;
+
+    if (access != hpm_host_sim_write) {
+        return;
+    }
+    if (offset == offsetof(PDMA_Type, CTRL)) {
+        if ((*value & PDMA_CTRL_PDMA_SFTRST_MASK) && !(old & PDMA_CTRL_PDMA_SFTRST_MASK)) {
+            model->resets++;
+        }
+        if ((*value & PDMA_CTRL_PDMA_EN_MASK) && !(old & PDMA_CTRL_PDMA_EN_MASK)) {
+            model->starts++;
+            *hpm_host_sim_reg(block, offsetof(PDMA_Type, STAT)) |= model->inject_error ?
+                PDMA_STAT_AXI_0_WRITE_ERR_MASK : PDMA_STAT_PDMA_DONE_MASK;
+            model->inject_error = 0;
+        }
+    } else if (offset == offsetof(PDMA_Type, STAT)) {
+        *value = old & ~*value;
+    }
+}
+
+static void list_done(hpm_pdma_cmdlist_t *list, void *context)
+{
+    (void)list;
+    (void)context;
+    s_callbacks++;
+}
+
+/* record a row of tiles: one background fill and count - 1 blits */
+static hpm_stat_t record_row(hpm_pdma_cmdlist_t *list, uint32_t count)
+{
+    hpm_stat_t stat;
+
+    stat = hpm_pdma_cmdlist_fill_color(list, TEST_FB, TEST_FB_WIDTH, 64, 64, 0xFF0000FFUL, 0xFF,
+                                       display_pixel_format_rgb565);
+    for (uint32_t i = 1; (i < count) && (stat == status_success); i++) {
+        stat = hpm_pdma_cmdlist_blit(list, TEST_FB, TEST_FB_WIDTH, TEST_IMAGE, 64,
+                                     i * 64U, 0, 64, 64, 0xFF, display_pixel_format_rgb565);
+    }
+    return stat;
+}
+
+static void run_isr(hpm_pdma_cmdlist_engine_t *engine)
+{
+    /* the model completes every start at once, each call ends one command */
+    for (uint32_t i = 0; (i < 64U) && hpm_pdma_cmdlist_is_busy(engine); i++) {
+        hpm_pdma_cmdlist_isr_handler(engine);
+    }
+}
+
+int main(void)
+{
+    hpm_host_sim_block_t *block;
+    hpm_pdma_cmdlist_engine_t engine;
+    hpm_pdma_cmdlist_t list_a;
+    hpm_pdma_cmdlist_t list_b;
+    hpm_pdma_cmdlist_stat_t stat;
+    PDMA_Type *pdma;
+    uint32_t blocking_writes;
+    uint32_t status;
+
+    block = hpm_host_sim_block_create(sizeof(PDMA_Type), pdma_model_hook, &s_model);
+    CHECK(block != NULL);
+    pdma = (PDMA_Type *)block->base;
+
+    /* blocking driver reference, a blit programs every register and resets before it */
+    CHECK(pdma_blit(pdma, TEST_FB, TEST_FB_WIDTH, TEST_IMAGE, 64, 64, 0, 64, 64, 0xFF,
+                    display_pixel_format_rgb565, true, &status) == status_pdma_done);
+    blocking_writes = block->writes;
+    printf("pdma_blit: %u register writes, %u resets\n", blocking_writes, s_model.resets);
+
+    hpm_pdma_cmdlist_engine_init(&engine, pdma);
+    hpm_pdma_cmdlist_init(&list_a, s_cmds_a, 8);
+    hpm_pdma_cmdlist_init(&list_b, s_cmds_b, 2);
+    CHECK(record_row(&list_a, 6) == status_success);
+    CHECK(record_row(&list_b, 2) == status_success);
+    CHECK(hpm_pdma_cmdlist_blit(&list_b, TEST_FB, TEST_FB_WIDTH, TEST_IMAGE, 64, 0, 0, 64, 64, 0xFF,
+                                display_pixel_format_rgb565) == status_fail);
+
+    /* queue b behind a, the engine runs both from the interrupt */
+    hpm_host_sim_block_reset_stat(block);
+    s_model.resets = 0;
+    s_model.starts = 0;
+    CHECK(hpm_pdma_cmdlist_submit(&engine, &list_a, list_done, NULL) == status_success);
+    CHECK(hpm_pdma_cmdlist_submit(&engine, &list_b, list_done, NULL) == status_success);
+    CHECK(hpm_pdma_cmdlist_submit(&engine, &list_b, list_done, NULL) == status_pdma_busy);
+    /* a queued list is not reset */
+    hpm_pdma_cmdlist_reset(&list_a);
+    CHECK(list_a.count == 6U);
+    run_isr(&engine);
+
+    CHECK(!hpm_pdma_cmdlist_is_busy(&engine));
+    CHECK(s_callbacks == 2U);
+    CHECK((list_a.status == status_pdma_done) && (list_a.done == 6U));
+    CHECK((list_b.status == status_pdma_done) && (list_b.done == 2U));
+    CHECK(s_model.starts == 8U);
+    /* one reset on submit of the idle engine, none between the commands */
+    CHECK(s_model.resets == 1U);
+
+    hpm_pdma_cmdlist_get_stat(&engine, &stat);
+    CHECK((stat.lists == 2U) && (stat.cmds == 8U) && (stat.errors == 0U));
+    CHECK(stat.reg_skipped != 0U);
+    printf("command list: %u register writes for %u commands, %u skipped as unchanged\n",
+           block->writes, stat.cmds, stat.reg_skipped);
+    printf("per command: %u register writes, blocking pdma_blit: %u\n", block->writes / stat.cmds, blocking_writes);
+    CHECK((block->writes / stat.cmds) < blocking_writes);
+
+    /* an AXI error aborts the list, the next run resets and programs every register again */
+    hpm_pdma_cmdlist_reset(&list_a);
+    CHECK(record_row(&list_a, 3) == status_success);
+    s_model.resets = 0;
+    s_model.inject_error = 1;
+    CHECK(hpm_pdma_cmdlist_submit(&engine, &list_a, list_done, NULL) == status_success);
+    run_isr(&engine);
+    CHECK(s_callbacks == 3U);
+    CHECK((list_a.status == status_pdma_error) && (list_a.done == 0U));
+    CHECK(s_model.resets == 2U);
+    hpm_pdma_cmdlist_get_stat(&engine, &stat);
+    CHECK(stat.errors == 1U);
+
+    CHECK(hpm_pdma_cmdlist_submit(&engine, &list_a, list_done, NULL) == status_success);
+    run_isr(&engine);
+    CHECK((list_a.status == status_pdma_done) && (list_a.done == 3U));
+
+    hpm_host_sim_block_destroy(block);
+    return 0;
+}
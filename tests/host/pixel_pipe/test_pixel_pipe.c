@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_pixel_pipe.h"
+
+/*
+ * Reference checks of the software pixel pipeline: color conversion against
+ * the floating point BT.601 equations, scaling and rotation against their
+ * pixel mappings. Also reports the time per pixel of the kernels on the host.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_W          (640U)
+#define TEST_H          (480U)
+#define TEST_ROT_W      (37U)
+#define TEST_ROT_H      (21U)
+#define TEST_BENCH_RUNS (20U)
+
+static uint32_t s_src[TEST_W * TEST_H];
+static uint32_t s_dst[TEST_W * TEST_H];
+static uint32_t s_back[TEST_W * TEST_H];
+static uint8_t s_u[(TEST_W / 2U) * (TEST_H / 2U)];
+static uint8_t s_v[(TEST_W / 2U) * (TEST_H / 2U)];
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed;
+}
+
+static hpm_pixel_image_t image(void *buf, uint32_t width, uint32_t height, display_pixel_format_t format)
+{
+    hpm_pixel_image_t img = {
+        .buf = buf,
+        .width = width,
+        .height = height,
+        .stride = (width * display_get_pixel_size_in_bit(format) / 8U + 3U) & ~3U,
+        .format = format,
+    };
+    return img;
+}
+
+static int32_t clamp8(double v)
+{
+    long r = lround(v);
+    return (r < 0) ? 0 : ((r > 255) ? 255 : (int32_t)r);
+}
+
+static void yuv_ref(bool video, int32_t y, int32_t u, int32_t v, int32_t rgb[3])
+{
+    double yy = video ? 1.164383 * (y - 16) : (double)y;
+    double uu = u - 128;
+    double vv = v - 128;
+
+    if (video) {
+        rgb[0] = clamp8(yy + 1.596027 * vv);
+        rgb[1] = clamp8(yy - 0.391762 * uu - 0.812968 * vv);
+        rgb[2] = clamp8(yy + 2.017232 * uu);
+    } else {
+        rgb[0] = clamp8(yy + 1.402 * vv);
+        rgb[1] = clamp8(yy - 0.344136 * uu - 0.714136 * vv);
+        rgb[2] = clamp8(yy + 1.772 * uu);
+    }
+}
+
+/* largest channel error of a converted pixel, RGB565 compared in its own units */
+static int32_t rgb_error(uint32_t pixel, bool rgb565, const int32_t rgb[3])
+{
+    int32_t got[3];
+    int32_t want[3];
+    int32_t err = 0;
+
+    if (rgb565) {
+        got[0] = (int32_t)(pixel >> 11) & 0x1F;
+        got[1] = (int32_t)(pixel >> 5) & 0x3F;
+        got[2] = (int32_t)pixel & 0x1F;
+        want[0] = rgb[0] >> 3;
+        want[1] = rgb[1] >> 2;
+        want[2] = rgb[2] >> 3;
+    } else {
+        got[0] = (int32_t)(pixel >> 16) & 0xFF;
+        got[1] = (int32_t)(pixel >> 8) & 0xFF;
+        got[2] = (int32_t)pixel & 0xFF;
+        memcpy(want, rgb, sizeof(want));
+    }
+    for (uint32_t i = 0; i < 3; i++) {
+        err = (abs(got[i] - want[i]) > err) ? abs(got[i] - want[i]) : err;
+    }
+    return err;
+}
+
+static uint32_t pixel_at(const hpm_pixel_image_t *img, uint32_t x, uint32_t y)
+{
+    const uint8_t *line = (const uint8_t *)img->buf + y * img->stride;
+
+    switch (display_get_pixel_size_in_byte(img->format)) {
+    case 4:
+        return ((const uint32_t *)line)[x];
+    case 2:
+        return ((const uint16_t *)line)[x];
+    default:
+        return line[x];
+    }
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static int test_yuv422(display_pixel_format_t in, display_pixel_format_t out)
+{
+    hpm_pixel_image_t src = image(s_src, 64, 64, in);
+    hpm_pixel_image_t dst = image(s_dst, 64, 64, out);
+    bool video = (in == display_pixel_format_ycbcr422);
+    bool rgb565 = (out == display_pixel_format_rgb565);
+    int32_t rgb[3];
+    int32_t max_error = 0;
+    uint32_t w;
+
+    for (uint32_t i = 0; i < 64U * 32U; i++) {
+        s_src[i] = rnd();
+    }
+    CHECK(hpm_pixel_pipe_yuv422_to_rgb(&src, &dst) == status_success);
+    for (uint32_t y = 0; y < 64U; y++) {
+        for (uint32_t x = 0; x < 64U; x++) {
+            w = s_src[y * 32U + x / 2U];
+            yuv_ref(video, (x & 1U) ? (w >> 16) & 0xFF : w & 0xFF, (w >> 8) & 0xFF, w >> 24, rgb);
+            w = rgb_error(pixel_at(&dst, x, y), rgb565, rgb);
+            max_error = ((int32_t)w > max_error) ? (int32_t)w : max_error;
+        }
+    }
+    printf("yuv422 %s to %s: max error %d\n", video ? "video range" : "full range", rgb565 ? "rgb565" : "argb8888",
+           max_error);
+    CHECK(max_error <= 1);
+    return 0;
+}
+
+static int test_yuv420p(void)
+{
+    const uint8_t *luma = (const uint8_t *)s_src;
+    hpm_pixel_yuv420p_t src = {
+        .y = luma, .u = s_u, .v = s_v, .width = 64, .height = 64, .y_stride = 64, .uv_stride = 32,
+    };
+    hpm_pixel_image_t dst = image(s_dst, 64, 64, display_pixel_format_argb8888);
+    int32_t rgb[3];
+    int32_t max_error = 0;
+    int32_t err;
+
+    for (uint32_t i = 0; i < 64U * 16U; i++) {
+        s_src[i] = rnd();
+        s_u[i] = (uint8_t)rnd();
+        s_v[i] = (uint8_t)rnd();
+    }
+    CHECK(hpm_pixel_pipe_yuv420p_to_rgb(&src, &dst) == status_success);
+    for (uint32_t y = 0; y < 64U; y++) {
+        for (uint32_t x = 0; x < 64U; x++) {
+            yuv_ref(false, luma[y * 64U + x], s_u[(y / 2U) * 32U + x / 2U], s_v[(y / 2U) * 32U + x / 2U], rgb);
+            err = rgb_error(pixel_at(&dst, x, y), false, rgb);
+            max_error = (err > max_error) ? err : max_error;
+        }
+    }
+    printf("yuv420p to argb8888: max error %d\n", max_error);
+    CHECK(max_error <= 1);
+    src.width = 63;
+    CHECK(hpm_pixel_pipe_yuv420p_to_rgb(&src, &dst) == status_invalid_argument);
+    return 0;
+}
+
+static int test_scale(display_pixel_format_t format)
+{
+    hpm_pixel_image_t src = image(s_src, 48, 32, format);
+    hpm_pixel_image_t dst = image(s_dst, 48, 32, format);
+    uint32_t fill = (format == display_pixel_format_y8) ? 0x5AU : ((format == display_pixel_format_rgb565) ? 0xA5C3U : 0x80402010UL);
+    uint32_t sum;
+
+    /* same size bilinear is a copy */
+    for (uint32_t i = 0; i < src.stride * src.height / 4U; i++) {
+        s_src[i] = rnd();
+    }
+    CHECK(hpm_pixel_pipe_scale(&src, &dst, hpm_pixel_scale_bilinear) == status_success);
+    for (uint32_t y = 0; y < src.height; y++) {
+        for (uint32_t x = 0; x < src.width; x++) {
+            CHECK(pixel_at(&dst, x, y) == pixel_at(&src, x, y));
+        }
+    }
+
+    /* a flat image stays flat at any ratio */
+    for (uint32_t y = 0; y < src.height; y++) {
+        for (uint32_t x = 0; x < src.width; x++) {
+            uint8_t *line = (uint8_t *)src.buf + y * src.stride;
+            switch (display_get_pixel_size_in_byte(format)) {
+            case 4:
+                ((uint32_t *)line)[x] = fill;
+                break;
+            case 2:
+                ((uint16_t *)line)[x] = (uint16_t)fill;
+                break;
+            default:
+                line[x] = (uint8_t)fill;
+                break;
+            }
+        }
+    }
+    dst = image(s_dst, 29, 13, format);
+    CHECK(hpm_pixel_pipe_scale(&src, &dst, hpm_pixel_scale_bilinear) == status_success);
+    for (uint32_t y = 0; y < dst.height; y++) {
+        for (uint32_t x = 0; x < dst.width; x++) {
+            CHECK(pixel_at(&dst, x, y) == fill);
+        }
+    }
+    dst = image(s_dst, 97, 45, format);
+    CHECK(hpm_pixel_pipe_scale(&src, &dst, hpm_pixel_scale_bilinear) == status_success);
+    CHECK((pixel_at(&dst, 0, 0) == fill) && (pixel_at(&dst, 96, 44) == fill));
+    CHECK(hpm_pixel_pipe_scale(&src, &dst, hpm_pixel_scale_area) == status_invalid_argument);
+
+    /* area halving averages 2x2 blocks */
+    if (format == display_pixel_format_y8) {
+        for (uint32_t i = 0; i < src.stride * src.height; i++) {
+            ((uint8_t *)s_src)[i] = (uint8_t)rnd();
+        }
+        dst = image(s_dst, 24, 16, format);
+        CHECK(hpm_pixel_pipe_scale(&src, &dst, hpm_pixel_scale_area) == status_success);
+        for (uint32_t y = 0; y < dst.height; y++) {
+            for (uint32_t x = 0; x < dst.width; x++) {
+                sum = pixel_at(&src, 2 * x, 2 * y) + pixel_at(&src, 2 * x + 1, 2 * y)
+                    + pixel_at(&src, 2 * x, 2 * y + 1) + pixel_at(&src, 2 * x + 1, 2 * y + 1);
+                CHECK(pixel_at(&dst, x, y) == (sum + 2U) / 4U);
+            }
+        }
+    }
+    return 0;
+}
+
+static int test_rotate(display_pixel_format_t format)
+{
+    hpm_pixel_image_t src = image(s_src, TEST_ROT_W, TEST_ROT_H, format);
+    hpm_pixel_image_t dst;
+    hpm_pixel_image_t back;
+    uint32_t w = TEST_ROT_W;
+    uint32_t h = TEST_ROT_H;
+
+    for (uint32_t i = 0; i < src.stride * src.height / 4U; i++) {
+        s_src[i] = rnd();
+    }
+
+    dst = image(s_dst, h, w, format);
+    CHECK(hpm_pixel_pipe_rotate(&src, &dst, hpm_pixel_rotate_90) == status_success);
+    for (uint32_t y = 0; y < dst.height; y++) {
+        for (uint32_t x = 0; x < dst.width; x++) {
+            CHECK(pixel_at(&dst, x, y) == pixel_at(&src, y, h - 1U - x));
+        }
+    }
+    back = image(s_back, w, h, format);
+    CHECK(hpm_pixel_pipe_rotate(&dst, &back, hpm_pixel_rotate_270) == status_success);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            CHECK(pixel_at(&back, x, y) == pixel_at(&src, x, y));
+        }
+    }
+
+    dst = image(s_dst, w, h, format);
+    CHECK(hpm_pixel_pipe_rotate(&src, &dst, hpm_pixel_rotate_180) == status_success);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            CHECK(pixel_at(&dst, x, y) == pixel_at(&src, w - 1U - x, h - 1U - y));
+        }
+    }
+    CHECK(hpm_pixel_pipe_rotate(&src, &dst, hpm_pixel_rotate_90) == status_invalid_argument);
+    return 0;
+}
+
+static void bench(const char *name, hpm_stat_t (*run)(void), uint32_t pixels)
+{
+    double start = now_ns();
+
+    for (uint32_t i = 0; i < TEST_BENCH_RUNS; i++) {
+        (void)run();
+    }
+    printf("%-40s %6.2f ns/pixel\n", name, (now_ns() - start) / TEST_BENCH_RUNS / pixels);
+}
+
+static hpm_stat_t run_yuv422(void)
+{
+    hpm_pixel_image_t src = image(s_src, TEST_W, TEST_H, display_pixel_format_yuv422);
+    hpm_pixel_image_t dst = image(s_dst, TEST_W, TEST_H, display_pixel_format_rgb565);
+    return hpm_pixel_pipe_yuv422_to_rgb(&src, &dst);
+}
+
+static hpm_stat_t run_scale(void)
+{
+    hpm_pixel_image_t src = image(s_src, TEST_W, TEST_H, display_pixel_format_rgb565);
+    hpm_pixel_image_t dst = image(s_dst, TEST_W / 2U, TEST_H / 2U, display_pixel_format_rgb565);
+    return hpm_pixel_pipe_scale(&src, &dst, hpm_pixel_scale_bilinear);
+}
+
+static hpm_stat_t run_rotate(void)
+{
+    hpm_pixel_image_t src = image(s_src, TEST_W, TEST_H, display_pixel_format_rgb565);
+    hpm_pixel_image_t dst = image(s_dst, TEST_H, TEST_W, display_pixel_format_rgb565);
+    return hpm_pixel_pipe_rotate(&src, &dst, hpm_pixel_rotate_90);
+}
+
+int main(void)
+{
+    static const display_pixel_format_t formats[] = {
+        display_pixel_format_y8, display_pixel_format_rgb565, display_pixel_format_argb8888,
+    };
+
+    CHECK(test_yuv422(display_pixel_format_yuv422, display_pixel_format_argb8888) == 0);
+    CHECK(test_yuv422(display_pixel_format_yuv422, display_pixel_format_rgb565) == 0);
+    CHECK(test_yuv422(display_pixel_format_ycbcr422, display_pixel_format_argb8888) == 0);
+    CHECK(test_yuv420p() == 0);
+    for (uint32_t i = 0; i < ARRAY_SIZE(formats); i++) {
+        CHECK(test_scale(formats[i]) == 0);
+        CHECK(test_rotate(formats[i]) == 0);
+    }
+
+    bench("yuv422 to rgb565, 640x480", run_yuv422, TEST_W * TEST_H);
+    bench("bilinear rgb565, 640x480 to 320x240", run_scale, (TEST_W / 2U) * (TEST_H / 2U));
+    bench("rotate 90 rgb565, 640x480", run_rotate, TEST_W * TEST_H);
+    return 0;
+}
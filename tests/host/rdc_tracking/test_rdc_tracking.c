@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "hpm_host_sim.h"
+#include "hpm_rdc_tracking.h"
+
+/*
+ * Synthetic resolver: the accumulators of an RDC block carry sine and cosine
+ * of the rotor angle with unequal amplitudes, offsets and noise, the rotor
+ * ramps up to a constant speed.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_SAMPLE_FREQ    (20000U)
+#define TEST_SPEED_HZ       (50.0)
+#define TEST_RAMP_SAMPLES   (TEST_SAMPLE_FREQ)
+#define TEST_SAMPLES        (3U * TEST_SAMPLE_FREQ)
+#define TEST_AMPLITUDE_I    (1048576.0)
+#define TEST_AMPLITUDE_Q    (943718.0)
+#define TEST_OFFSET_I       (3000.0)
+#define TEST_OFFSET_Q       (-5000.0)
+#define TEST_NOISE          (2048U)
+#define TEST_2PI            (6.283185307179586)
+
+static uint32_t s_seed = 1;
+
+static int32_t noise(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return (int32_t)(s_seed >> 16) % (int32_t)TEST_NOISE - (int32_t)(TEST_NOISE / 2U);
+}
+
+static double angle_error_deg(uint32_t estimate, double turns)
+{
+    uint32_t truth = (uint32_t)(uint64_t)llround(fmod(turns, 1.0) * 4294967296.0);
+
+    return (double)(int32_t)(estimate - truth) * (360.0 / 4294967296.0);
+}
+
+static void set_acc(hpm_host_sim_block_t *block, double turns)
+{
+    double phase = TEST_2PI * turns;
+
+    hpm_host_sim_poke(block, offsetof(RDC_Type, ACC_I),
+                      (uint32_t)(int32_t)lround(TEST_OFFSET_I + TEST_AMPLITUDE_I * sin(phase)) + noise());
+    hpm_host_sim_poke(block, offsetof(RDC_Type, ACC_Q),
+                      (uint32_t)(int32_t)lround(TEST_OFFSET_Q + TEST_AMPLITUDE_Q * cos(phase)) + noise());
+}
+
+int main(void)
+{
+    hpm_rdc_tracking_config_t config = {
+        .sample_freq = TEST_SAMPLE_FREQ,
+        .bandwidth_hz = 200.0f,
+        .damping = 0.707f,
+        .amplitude = 0,
+        .cal_shift = 10,
+        .cal_min_speed_hz = 5.0f,
+    };
+    hpm_rdc_tracking_t tracking;
+    hpm_host_sim_block_t *block;
+    RDC_Type *rdc;
+    double turns = 0.0;
+    double speed = 0.0;
+    double error;
+    double max_error = 0.0;
+    float rad_s;
+
+    CHECK(hpm_rdc_tracking_init(&tracking, &config) == status_success);
+    config.bandwidth_hz = 5000.0f;
+    CHECK(hpm_rdc_tracking_init(&tracking, &config) == status_invalid_argument);
+    config.bandwidth_hz = 200.0f;
+
+    /* seeding at exactly half a turn, atan2f() returns pi */
+    CHECK(hpm_rdc_tracking_init(&tracking, &config) == status_success);
+    hpm_rdc_tracking_update(&tracking, 0, -(int32_t)TEST_AMPLITUDE_I);
+    printf("seed at pi: angle 0x%08x\n", hpm_rdc_tracking_get_angle(&tracking));
+    CHECK(fabs(angle_error_deg(hpm_rdc_tracking_get_angle(&tracking), 0.5)) < 0.01);
+
+    block = hpm_host_sim_block_create(sizeof(RDC_Type), NULL, NULL);
+    CHECK(block != NULL);
+    rdc = (RDC_Type *)block->base;
+
+    CHECK(hpm_rdc_tracking_init(&tracking, &config) == status_success);
+    for (uint32_t i = 0; i < TEST_SAMPLES; i++) {
+        set_acc(block, turns);
+        hpm_rdc_tracking_update_from_rdc(&tracking, rdc);
+        error = fabs(angle_error_deg(hpm_rdc_tracking_get_angle(&tracking), turns));
+        CHECK(!tracking.signal_lost);
+        /* the last second runs at constant speed with settled calibration */
+        if ((i >= (TEST_SAMPLES - TEST_SAMPLE_FREQ)) && (error > max_error)) {
+            max_error = error;
+        }
+        if (i < TEST_RAMP_SAMPLES) {
+            speed = TEST_SPEED_HZ * (double)(i + 1U) / (double)TEST_RAMP_SAMPLES;
+        }
+        turns += speed / (double)TEST_SAMPLE_FREQ;
+    }
+    rad_s = hpm_rdc_tracking_get_speed(&tracking);
+    printf("steady state: max angle error %.4f deg, speed %.2f rad/s (%.2f)\n",
+           max_error, rad_s, TEST_2PI * TEST_SPEED_HZ);
+    printf("calibration: offset %d %d, amplitude %d %d\n",
+           tracking.offset[0], tracking.offset[1], tracking.amplitude[0], tracking.amplitude[1]);
+    CHECK(max_error < 0.05);
+    CHECK(fabs(rad_s - TEST_2PI * TEST_SPEED_HZ) < (0.01 * TEST_2PI * TEST_SPEED_HZ));
+    CHECK(abs(tracking.offset[0] - (int32_t)TEST_OFFSET_I) < 100);
+    CHECK(abs(tracking.offset[1] - (int32_t)TEST_OFFSET_Q) < 100);
+
+    hpm_host_sim_block_destroy(block);
+    return 0;
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef RPMSG_CONFIG_H_
+#define RPMSG_CONFIG_H_
+
+/* RPMsg-Lite options of the host harness, BM environment */
+#define RL_MS_PER_INTERVAL (1)
+#define RL_BUFFER_PAYLOAD_SIZE (496U)
+#define RL_BUFFER_COUNT (64U)
+#define RL_API_HAS_ZEROCOPY (1)
+#define RL_USE_STATIC_API (0)
+#define RL_CLEAR_USED_BUFFERS (0)
+#define RL_USE_MCMGR_IPC_ISR_HANDLER (0)
+#define RL_USE_ENVIRONMENT_CONTEXT (0)
+#define RL_DEBUG_CHECK_BUFFERS (0)
+#define RL_ALLOW_TX_BATCHING (1)
+
+/* fail the test instead of hanging, in Release builds too */
+#include <stdio.h>
+#include <stdlib.h>
+#define RL_ASSERT(x)                                                              \
+    do {                                                                          \
+        if (!(x)) {                                                               \
+            printf("%s:%d: RL_ASSERT failed: %s\n", __FILE__, __LINE__, #x);       \
+            abort();                                                              \
+        }                                                                         \
+    } while (0)
+
+#endif /* RPMSG_CONFIG_H_ */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#ifndef RPMSG_PLATFORM_H_
+#define RPMSG_PLATFORM_H_
+
+#include <stdint.h>
+
+/*
+ * Host platform of the RPMsg-Lite harness: both cores run in one process, one
+ * thread each, the master on link 0 and the remote on link 1 over the same
+ * shared memory. The link only selects the virtual interrupt vectors, so both
+ * instances share one BM environment ISR table. platform_notify() latches the
+ * queue id as a pending event of the other link, as the IPC event of the
+ * hpm6xxx port does, and platform_host_service() runs the pending events of a
+ * link from its thread. The layout macros are the hpm6xxx ones.
+ */
+#ifndef VRING_ALIGN
+#define VRING_ALIGN (0x10U)
+#endif
+
+#ifndef VRING_SIZE
+#define VRING_DESC_SIZE (((RL_BUFFER_COUNT * sizeof(struct vring_desc)) + VRING_ALIGN - 1UL) & ~(VRING_ALIGN - 1UL))
+#define VRING_AVAIL_SIZE                                                                                            \
+    (((sizeof(struct vring_avail) + (RL_BUFFER_COUNT * sizeof(uint16_t)) + sizeof(uint16_t)) + VRING_ALIGN - 1UL) & \
+     ~(VRING_ALIGN - 1UL))
+#define VRING_USED_SIZE                                                                                     \
+    (((sizeof(struct vring_used) + (RL_BUFFER_COUNT * sizeof(struct vring_used_elem)) + sizeof(uint16_t)) + \
+      VRING_ALIGN - 1UL) &                                                                                  \
+     ~(VRING_ALIGN - 1UL))
+#define VRING_SIZE (VRING_DESC_SIZE + VRING_AVAIL_SIZE + VRING_USED_SIZE)
+#endif
+
+#define RL_VRING_OVERHEAD (2UL * VRING_SIZE)
+
+#define RL_GET_VQ_ID(link_id, queue_id) (((queue_id)&0x1U) | (((link_id) << 1U) & 0xFFFFFFFEU))
+#define RL_GET_LINK_ID(id)              (((id)&0xFFFFFFFEU) >> 1U)
+#define RL_GET_Q_ID(id)                 ((id)&0x1U)
+
+#define RL_PLATFORM_HOST_MASTER_LINK_ID (0U)
+#define RL_PLATFORM_HOST_REMOTE_LINK_ID (1U)
+#define RL_PLATFORM_HIGHEST_LINK_ID     (1U)
+
+/* platform interrupt related functions */
+int32_t platform_init_interrupt(uint32_t vector_id, void *isr_data);
+int32_t platform_deinit_interrupt(uint32_t vector_id);
+int32_t platform_interrupt_enable(uint32_t vector_id);
+int32_t platform_interrupt_disable(uint32_t vector_id);
+int32_t platform_in_isr(void);
+void platform_notify(uint32_t vector_id);
+
+/* platform low-level time-delay (busy loop) */
+void platform_time_delay(uint32_t num_msec);
+
+/* platform free running time stamp in us */
+uint64_t platform_time_get_us(void);
+
+/* platform memory functions */
+void platform_map_mem_region(uint32_t vrt_addr, uint32_t phy_addr, uint32_t size, uint32_t flags);
+void platform_cache_all_flush_invalidate(void);
+void platform_cache_disable(void);
+uint32_t platform_vatopa(void *addr);
+void *platform_patova(uint32_t addr);
+
+/* platform init/deinit */
+int32_t platform_init(void);
+int32_t platform_deinit(void);
+
+/* runs the pending events of a link, returns how many ran */
+uint32_t platform_host_service(uint32_t link_id);
+
+#endif /* RPMSG_PLATFORM_H_ */
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+#include <stdint.h>
+#include <time.h>
+
+#include "rpmsg_platform.h"
+#include "rpmsg_env.h"
+
+#define PLATFORM_HOST_LINK_COUNT (RL_PLATFORM_HIGHEST_LINK_ID + 1U)
+
+/* pending queue ids per link, bit per queue, set by the other link */
+static uint32_t s_pending[PLATFORM_HOST_LINK_COUNT];
+/* per link, the events stay pending while it is non-zero */
+static int32_t s_disable_counter[PLATFORM_HOST_LINK_COUNT];
+
+int32_t platform_init_interrupt(uint32_t vector_id, void *isr_data)
+{
+    env_register_isr(vector_id, isr_data);
+
+    return 0;
+}
+
+int32_t platform_deinit_interrupt(uint32_t vector_id)
+{
+    env_unregister_isr(vector_id);
+
+    return 0;
+}
+
+void platform_notify(uint32_t vector_id)
+{
+    uint32_t peer = RL_GET_LINK_ID(vector_id) ^ 1U;
+
+    __atomic_fetch_or(&s_pending[peer], 1U << RL_GET_Q_ID(vector_id), __ATOMIC_SEQ_CST);
+}
+
+uint32_t platform_host_service(uint32_t link_id)
+{
+    uint32_t pending;
+    uint32_t count = 0;
+
+    if ((link_id >= PLATFORM_HOST_LINK_COUNT) || (__atomic_load_n(&s_disable_counter[link_id], __ATOMIC_ACQUIRE) != 0)) {
+        return 0;
+    }
+    pending = __atomic_exchange_n(&s_pending[link_id], 0U, __ATOMIC_SEQ_CST);
+    for (uint32_t q = 0; q < 2U; q++) {
+        if ((pending & (1U << q)) != 0U) {
+            env_isr(RL_GET_VQ_ID(link_id, q));
+            count++;
+        }
+    }
+    return count;
+}
+
+void platform_time_delay(uint32_t num_msec)
+{
+    struct timespec ts = { (time_t)(num_msec / 1000U), (long)(num_msec % 1000U) * 1000000L };
+
+    nanosleep(&ts, NULL);
+}
+
+uint64_t platform_time_get_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000U) + ((uint64_t)ts.tv_nsec / 1000U);
+}
+
+int32_t platform_in_isr(void)
+{
+    return 0;
+}
+
+int32_t platform_interrupt_enable(uint32_t vector_id)
+{
+    RL_ASSERT(0 < s_disable_counter[RL_GET_LINK_ID(vector_id)]);
+    __atomic_fetch_sub(&s_disable_counter[RL_GET_LINK_ID(vector_id)], 1, __ATOMIC_RELEASE);
+    return ((int32_t)vector_id);
+}
+
+int32_t platform_interrupt_disable(uint32_t vector_id)
+{
+    __atomic_fetch_add(&s_disable_counter[RL_GET_LINK_ID(vector_id)], 1, __ATOMIC_ACQUIRE);
+    return ((int32_t)vector_id);
+}
+
+void platform_map_mem_region(uint32_t vrt_addr, uint32_t phy_addr, uint32_t size, uint32_t flags)
+{
+}
+
+void platform_cache_all_flush_invalidate(void)
+{
+}
+
+void platform_cache_disable(void)
+{
+}
+
+/* the shared memory is a static buffer below 4 GiB, the tests are linked without PIE */
+uint32_t platform_vatopa(void *addr)
+{
+    return (uint32_t)(uintptr_t)addr;
+}
+
+void *platform_patova(uint32_t addr)
+{
+    return (void *)(uintptr_t)addr;
+}
+
+int32_t platform_init(void)
+{
+    return 0;
+}
+
+int32_t platform_deinit(void)
+{
+    return 0;
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "rpmsg_lite.h"
+#include "rpmsg_platform.h"
+
+/*
+ * RPMsg-Lite batched tx between two threads, one per core over one shared
+ * memory: the main thread is the master and sends, the other thread is the
+ * remote and receives, serving its interrupts by polling rpmsg_platform_host.c.
+ * Both threads yield whenever they wait, so the harness also runs on one CPU,
+ * where the figures include the thread switches.
+ * Each interrupt the remote takes also costs TEST_IRQ_COST_NS, the entry, IPC
+ * event read and exit of the target. Reports messages per second, mean and
+ * worst latency from rpmsg_lite_send_nocopy_batched() to the receive callback,
+ * and notifications per message against the batch count, then a paced sender
+ * against the batch time threshold.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_MESSAGES      (200000U)
+#define TEST_PACED_MSGS    (4000U)
+#define TEST_PACE_NS       (20000U)
+#define TEST_IRQ_COST_NS   (1000U)
+#define TEST_MASTER_EPT    (30U)
+#define TEST_REMOTE_EPT    (31U)
+/* rpmsg_lite.c: 16 byte header per buffer */
+#define TEST_SHMEM_SIZE    (RL_VRING_OVERHEAD + (2U * RL_BUFFER_COUNT * (RL_BUFFER_PAYLOAD_SIZE + 16U)))
+
+typedef struct {
+    uint32_t seq;
+    uint64_t sent_ns;
+} test_msg_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t timeout_us;
+    uint32_t messages;
+    uint32_t pace_ns;
+} test_run_t;
+
+static uint8_t s_shmem[TEST_SHMEM_SIZE] __attribute__((aligned(64)));
+static struct rpmsg_lite_instance *s_remote;
+static uint32_t s_remote_ready;
+static uint32_t s_stop;
+
+/* written by the remote thread only */
+static uint32_t s_received;
+static uint32_t s_next_seq;
+static uint32_t s_out_of_order;
+static uint32_t s_interrupts;
+static double s_latency_sum;
+static double s_latency_max;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static void spin_ns(uint64_t ns)
+{
+    uint64_t end = now_ns() + ns;
+
+    while (now_ns() < end) {
+    }
+}
+
+static int32_t remote_rx_cb(void *payload, uint32_t payload_len, uint32_t src, void *priv)
+{
+    test_msg_t msg;
+    double latency;
+
+    (void)src;
+    (void)priv;
+    memcpy(&msg, payload, sizeof(msg));
+    latency = (double)(now_ns() - msg.sent_ns);
+    if ((payload_len != sizeof(msg)) || (msg.seq != s_next_seq)) {
+        s_out_of_order++;
+    }
+    s_next_seq = msg.seq + 1U;
+    s_latency_sum += latency;
+    if (latency > s_latency_max) {
+        s_latency_max = latency;
+    }
+    __atomic_store_n(&s_received, s_received + 1U, __ATOMIC_RELEASE);
+    return RL_RELEASE;
+}
+
+static void *remote_thread(void *arg)
+{
+    (void)arg;
+    s_remote = rpmsg_lite_remote_init(s_shmem, RL_PLATFORM_HOST_REMOTE_LINK_ID, RL_NO_FLAGS);
+    if ((s_remote == RL_NULL) || (rpmsg_lite_create_ept(s_remote, TEST_REMOTE_EPT, remote_rx_cb, NULL) == RL_NULL)) {
+        __atomic_store_n(&s_stop, 1U, __ATOMIC_RELEASE);
+        return NULL;
+    }
+    /* the link comes up on the notification of the master */
+    while (__atomic_load_n(&s_stop, __ATOMIC_ACQUIRE) == 0U) {
+        if (platform_host_service(RL_PLATFORM_HOST_REMOTE_LINK_ID) != 0U) {
+            /* serviced interrupts are counted and charged in the loop, the callbacks ran in between */
+            s_interrupts++;
+            spin_ns(TEST_IRQ_COST_NS);
+        } else {
+            sched_yield();
+        }
+        if (rpmsg_lite_is_link_up(s_remote) != 0U) {
+            __atomic_store_n(&s_remote_ready, 1U, __ATOMIC_RELEASE);
+        }
+    }
+    return NULL;
+}
+
+static void wait_received(uint32_t count)
+{
+    while (__atomic_load_n(&s_received, __ATOMIC_ACQUIRE) != count) {
+        sched_yield();
+    }
+}
+
+static int run_batch(struct rpmsg_lite_instance *master, struct rpmsg_lite_endpoint *ept, const test_run_t *run)
+{
+    struct rpmsg_lite_batch_stats before;
+    struct rpmsg_lite_batch_stats after;
+    struct rpmsg_lite_batch_stats remote_before;
+    struct rpmsg_lite_batch_stats remote_after;
+    test_msg_t msg;
+    uint32_t base = __atomic_load_n(&s_received, __ATOMIC_ACQUIRE);
+    uint32_t interrupts = s_interrupts;
+    uint32_t alloc_kicks = 0;
+    uint32_t size;
+    uint64_t start;
+    uint64_t next;
+    double elapsed;
+    double latency_sum = s_latency_sum;
+    void *buffer;
+
+    CHECK(rpmsg_lite_set_tx_batch(master, run->count, run->timeout_us) == RL_SUCCESS);
+    CHECK(rpmsg_lite_get_batch_stats(master, &before) == RL_SUCCESS);
+    CHECK(rpmsg_lite_get_batch_stats(s_remote, &remote_before) == RL_SUCCESS);
+    s_latency_max = 0;
+
+    start = now_ns();
+    next = start;
+    for (uint32_t n = 0; n < run->messages; n++) {
+        if (run->pace_ns != 0U) {
+            /* idle until the next message is due, the time threshold is checked meanwhile, 0 would flush */
+            next += run->pace_ns;
+            while (now_ns() < next) {
+                if (run->timeout_us != 0U) {
+                    (void)rpmsg_lite_poll_tx_batch(master);
+                }
+                sched_yield();
+            }
+        }
+        buffer = rpmsg_lite_alloc_tx_buffer(master, &size, RL_DONT_BLOCK);
+        if (buffer == RL_NULL) {
+            /* the failed allocation kicked the queued buffers */
+            alloc_kicks++;
+        }
+        while (buffer == RL_NULL) {
+            /* all buffers are with the remote, it returns them as it drains */
+            sched_yield();
+            buffer = rpmsg_lite_alloc_tx_buffer(master, &size, RL_DONT_BLOCK);
+        }
+        msg.seq = base + n;
+        msg.sent_ns = now_ns();
+        memcpy(buffer, &msg, sizeof(msg));
+        CHECK(rpmsg_lite_send_nocopy_batched(master, ept, TEST_REMOTE_EPT, buffer, sizeof(msg)) == RL_SUCCESS);
+    }
+    CHECK(rpmsg_lite_flush_tx(master) == RL_SUCCESS);
+    wait_received(base + run->messages);
+    elapsed = (double)(now_ns() - start);
+
+    /* the remote thread is idle now, its counters can be read */
+    CHECK(rpmsg_lite_get_batch_stats(master, &after) == RL_SUCCESS);
+    CHECK(rpmsg_lite_get_batch_stats(s_remote, &remote_after) == RL_SUCCESS);
+    CHECK(s_out_of_order == 0U);
+    CHECK(after.tx_msgs - before.tx_msgs == run->messages);
+    CHECK(remote_after.rx_msgs - remote_before.rx_msgs == run->messages);
+    /* a kick per full batch, per failed allocation and the final flush, taken only while the remote is not draining */
+    CHECK(after.tx_kicks - before.tx_kicks <= run->messages);
+    if (run->timeout_us == 0U) {
+        CHECK(after.tx_kicks - before.tx_kicks <= (run->messages / run->count) + alloc_kicks + 1U);
+    }
+    CHECK(remote_after.rx_notifications - remote_before.rx_notifications <= after.tx_kicks - before.tx_kicks);
+
+    printf("batch %2u, timeout %3u us%s: %9.0f msgs/s, latency %7.1f us mean %8.1f us max, "
+           "%.3f kicks %.3f interrupts per message\n",
+           (unsigned int)run->count, (unsigned int)run->timeout_us, (run->pace_ns != 0U) ? ", paced" : "        ",
+           run->messages * 1e9 / elapsed, (s_latency_sum - latency_sum) / run->messages / 1000.0,
+           s_latency_max / 1000.0, (double)(after.tx_kicks - before.tx_kicks) / run->messages,
+           (double)(s_interrupts - interrupts) / run->messages);
+    return 0;
+}
+
+int main(void)
+{
+    static const test_run_t runs[] = {
+        { 1U, 0U, TEST_MESSAGES, 0U },
+        { 2U, 0U, TEST_MESSAGES, 0U },
+        { 4U, 0U, TEST_MESSAGES, 0U },
+        { 8U, 0U, TEST_MESSAGES, 0U },
+        { 16U, 0U, TEST_MESSAGES, 0U },
+        { 32U, 0U, TEST_MESSAGES, 0U },
+        /* one message per TEST_PACE_NS: the count alone holds messages back, the time threshold bounds that */
+        { 1U, 0U, TEST_PACED_MSGS, TEST_PACE_NS },
+        { 4U, 0U, TEST_PACED_MSGS, TEST_PACE_NS },
+        { 16U, 0U, TEST_PACED_MSGS, TEST_PACE_NS },
+        { 16U, 100U, TEST_PACED_MSGS, TEST_PACE_NS },
+    };
+    struct rpmsg_lite_instance *master;
+    struct rpmsg_lite_endpoint *ept;
+    pthread_t remote;
+
+    master = rpmsg_lite_master_init(s_shmem, sizeof(s_shmem), RL_PLATFORM_HOST_MASTER_LINK_ID, RL_NO_FLAGS);
+    CHECK(master != RL_NULL);
+    ept = rpmsg_lite_create_ept(master, TEST_MASTER_EPT, NULL, NULL);
+    CHECK(ept != RL_NULL);
+    CHECK(pthread_create(&remote, NULL, remote_thread, NULL) == 0);
+    while ((__atomic_load_n(&s_remote_ready, __ATOMIC_ACQUIRE) == 0U) && (__atomic_load_n(&s_stop, __ATOMIC_ACQUIRE) == 0U)) {
+        sched_yield();
+    }
+    CHECK(__atomic_load_n(&s_remote_ready, __ATOMIC_ACQUIRE) != 0U);
+
+    printf("%u byte messages, %u buffers per direction, %u ns per remote interrupt\n",
+           (unsigned int)sizeof(test_msg_t), (unsigned int)RL_BUFFER_COUNT, (unsigned int)TEST_IRQ_COST_NS);
+    for (uint32_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        if (run_batch(master, ept, &runs[i]) != 0) {
+            __atomic_store_n(&s_stop, 1U, __ATOMIC_RELEASE);
+            pthread_join(remote, NULL);
+            return 1;
+        }
+    }
+
+    __atomic_store_n(&s_stop, 1U, __ATOMIC_RELEASE);
+    pthread_join(remote, NULL);
+    CHECK(rpmsg_lite_deinit(s_remote) == RL_SUCCESS);
+    CHECK(rpmsg_lite_deinit(master) == RL_SUCCESS);
+    return 0;
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_sdm_sinc.h"
+
+/*
+ * The sinc decimator against a direct FIR reference: a sinc filter of order N
+ * and ratio R is the convolution of N boxcars of R taps, evaluated at every
+ * R-th bit. Bitstreams are fed in uneven chunks to cover the state carried
+ * between calls. Also reports the decimation throughput on the host.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_BITS       (8192U)
+#define TEST_BENCH_BITS (1U << 20)
+#define TEST_MAX_TAPS   (HPM_SDM_SINC_MAX_ORDER * 256U)
+
+static uint8_t s_bits[TEST_BENCH_BITS / 8U];
+static int32_t s_out[TEST_BENCH_BITS / 2U];
+static int64_t s_taps[TEST_MAX_TAPS];
+static int64_t s_tmp[TEST_MAX_TAPS];
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed;
+}
+
+static uint32_t bit_at(uint32_t i)
+{
+    return (s_bits[i >> 3] >> (7U - (i & 7U))) & 1U;
+}
+
+/* impulse response of order boxcars of ratio taps, returns the length */
+static uint32_t make_taps(uint8_t order, uint16_t ratio)
+{
+    uint32_t len = 1;
+
+    s_taps[0] = 1;
+    for (uint8_t o = 0; o < order; o++) {
+        memset(s_tmp, 0, sizeof(s_tmp));
+        for (uint32_t i = 0; i < len; i++) {
+            for (uint32_t j = 0; j < ratio; j++) {
+                s_tmp[i + j] += s_taps[i];
+            }
+        }
+        len += ratio - 1U;
+        memcpy(s_taps, s_tmp, len * sizeof(int64_t));
+    }
+    return len;
+}
+
+/* random bits, or a first order sigma-delta modulated triangle sweeping 10 % to 90 % ones density */
+static void make_bits(bool modulated)
+{
+    int32_t acc = -32768;
+    int32_t in;
+    uint32_t b;
+
+    memset(s_bits, 0, sizeof(s_bits));
+    for (uint32_t i = 0; i < TEST_BITS; i++) {
+        if (modulated) {
+            /* ones density, Q16 */
+            in = (int32_t)((i % 2048U < 1024U) ? (i % 1024U) : (1023U - i % 1024U)) * 52 + 6554;
+            b = (acc >= 0) ? 1U : 0U;
+            acc += in - (int32_t)b * 65536;
+        } else {
+            b = rnd() >> 31;
+        }
+        s_bits[i >> 3] |= (uint8_t)(b << (7U - (i & 7U)));
+    }
+}
+
+static int check(uint8_t order, uint16_t ratio)
+{
+    hpm_sdm_sinc_t f;
+    uint32_t len = make_taps(order, ratio);
+    uint32_t n = 0;
+    uint32_t pos = 0;
+    uint32_t chunk;
+    uint32_t outputs = 0;
+    uint8_t chunk_bits[64];
+    int64_t offset = 1;
+    int64_t ref;
+    int64_t bit_index;
+
+    for (uint8_t o = 0; o < order; o++) {
+        offset *= ratio;
+    }
+    offset /= 2;
+
+    CHECK(hpm_sdm_sinc_init(&f, order, ratio) == status_success);
+    /* uneven chunks, each copied to a fresh buffer starting at bit 0 */
+    while (pos < TEST_BITS) {
+        chunk = 8U * (1U + rnd() % 7U);
+        chunk = (chunk > (TEST_BITS - pos)) ? (TEST_BITS - pos) : chunk;
+        memcpy(chunk_bits, &s_bits[pos / 8U], chunk / 8U);
+        n = hpm_sdm_sinc_process(&f, chunk_bits, chunk, &s_out[outputs]);
+        CHECK(n <= (chunk / ratio + 1U));
+        outputs += n;
+        pos += chunk;
+    }
+    CHECK(outputs == TEST_BITS / ratio);
+
+    for (uint32_t k = 0; k < outputs; k++) {
+        ref = 0;
+        for (uint32_t j = 0; j < len; j++) {
+            bit_index = (int64_t)(k + 1U) * ratio - 1 - (int64_t)j;
+            if (bit_index >= 0) {
+                ref += s_taps[j] * (int64_t)bit_at((uint32_t)bit_index);
+            }
+        }
+        if ((int64_t)s_out[k] != ref - offset) {
+            printf("order %u ratio %u output %u: %d, expected %lld\n", order, ratio, k, s_out[k],
+                   (long long)(ref - offset));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+int main(void)
+{
+    static const uint16_t ratios[] = { 2, 4, 16, 32, 64, 73 };
+    hpm_sdm_sinc_t f;
+    double start;
+
+    CHECK(hpm_sdm_sinc_init(&f, 0, 16) == status_invalid_argument);
+    CHECK(hpm_sdm_sinc_init(&f, HPM_SDM_SINC_MAX_ORDER + 1U, 16) == status_invalid_argument);
+    CHECK(hpm_sdm_sinc_init(&f, 3, 1) == status_invalid_argument);
+    CHECK(hpm_sdm_sinc_init(&f, 5, 100) == status_invalid_argument);
+    CHECK(hpm_sdm_sinc_init(&f, 5, 73) == status_success);
+
+    for (uint32_t m = 0; m < 2U; m++) {
+        make_bits(m != 0U);
+        for (uint8_t order = 1; order <= HPM_SDM_SINC_MAX_ORDER; order++) {
+            for (uint32_t r = 0; r < ARRAY_SIZE(ratios); r++) {
+                CHECK(check(order, ratios[r]) == 0);
+            }
+        }
+    }
+    printf("sinc1 - sinc%u, ratios 2 - 73: outputs match the FIR reference\n", HPM_SDM_SINC_MAX_ORDER);
+
+    for (uint32_t i = 0; i < sizeof(s_bits); i++) {
+        s_bits[i] = (uint8_t)rnd();
+    }
+    for (uint8_t order = 1; order <= HPM_SDM_SINC_MAX_ORDER; order++) {
+        CHECK(hpm_sdm_sinc_init(&f, order, 64) == status_success);
+        start = now_ns();
+        (void)hpm_sdm_sinc_process(&f, s_bits, TEST_BENCH_BITS, s_out);
+        printf("sinc%u ratio 64: %.2f ns/bit\n", order, (now_ns() - start) / TEST_BENCH_BITS);
+    }
+    return 0;
+}
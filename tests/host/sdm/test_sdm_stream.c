@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_host_sim_sdm.h"
+#include "hpm_sdm_stream.h"
+
+/*
+ * hpm_sdm_stream against sim/hpm_host_sim_sdm.c with the HPM6280 layout.
+ * Random bursts of filter output words per channel, the interrupt handler
+ * after every burst and a consumer that falls behind now and then: blocks
+ * come in order with contiguous samples and the timestamp of the drain of
+ * their first sample, samples lost to a full ring are counted exactly,
+ * comparator events reach the hook before any sample of the drain is stored
+ * and FIFO overflows are counted and cleared.
+ *
+ * Then the per channel cost of the stream against sdm_receive_filter_data(),
+ * which polls one word at a time: register accesses per sample in the model,
+ * and host ns per interrupt, per channel and per sample with 1 to 4
+ * channels, the task taking the blocks included. The host timing runs on a
+ * plain memory copy of the registers with a fixed FIFO level, as a trapped
+ * access costs microseconds and would hide the software.
+ */
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_MASK           (0x0BU)
+#define TEST_BLOCK_LEN      (48U)
+#define TEST_BLOCK_COUNT    (4U)
+#define TEST_ROUNDS         (600U)
+#define TEST_MAX_SEQ        (TEST_ROUNDS * HPM_HOST_SIM_SDM_FIFO_DEPTH)
+#define TEST_THRESHOLD      (8U)
+#define TEST_BENCH_LEN      (64U)
+#define TEST_BENCH_ISRS     (200000U)
+#define TEST_ACCESS_ISRS    (64U)
+/* sample rate per channel the CPU load is given for */
+#define TEST_RATE           (100000U)
+
+uint32_t hpm_host_mcycle;
+
+static hpm_host_sim_sdm_t s_sdm;
+static hpm_sdm_stream_t s_stream;
+static int32_t s_buf[HPM_SDM_STREAM_CHANNELS][TEST_BLOCK_COUNT * TEST_BENCH_LEN];
+/* drain round of every sample pushed */
+static uint32_t s_round[HPM_SDM_STREAM_CHANNELS][TEST_MAX_SEQ];
+static uint32_t s_seq[HPM_SDM_STREAM_CHANNELS];
+static uint32_t s_next[HPM_SDM_STREAM_CHANNELS];
+static uint32_t s_block[HPM_SDM_STREAM_CHANNELS];
+static uint32_t s_time;
+static uint32_t s_event_ch;
+static uint32_t s_event_flags;
+static uint32_t s_event_head;
+static uint32_t s_event_fill;
+static bool s_event_stored;
+static SDM_Type s_image;
+static int32_t s_poll[TEST_BENCH_LEN];
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t get_time(void)
+{
+    return s_time;
+}
+
+static void on_event(hpm_sdm_stream_t *stream, uint8_t ch, uint32_t event, void *cb_context)
+{
+    (void)cb_context;
+    s_event_ch = ch;
+    s_event_flags = event;
+    /* nothing of this drain is stored yet */
+    s_event_stored = (stream->ch[ch].head != s_event_head) || (stream->ch[ch].fill != s_event_fill);
+}
+
+/* sample words carry the channel and their sequence number */
+static int32_t sample_word(uint8_t ch, uint32_t seq)
+{
+    return (int32_t)(((uint32_t)ch << 24) | seq);
+}
+
+static uint32_t push(uint8_t ch, uint32_t count)
+{
+    uint32_t stored = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (hpm_host_sim_sdm_sample(&s_sdm, ch, sample_word(ch, s_seq[ch]))) {
+            s_round[ch][s_seq[ch]++] = s_time;
+            stored++;
+        }
+    }
+    return stored;
+}
+
+/* every complete block: in order, contiguous, stamped with the drain of its first sample */
+static bool consume(uint8_t ch, uint32_t *gap)
+{
+    const hpm_sdm_stream_block_t *block;
+    uint32_t first;
+
+    while ((block = hpm_sdm_stream_get_block(&s_stream, ch)) != NULL) {
+        first = (uint32_t)block->samples[0] & 0xFFFFFFU;
+        if ((block->index != s_block[ch]) || (block->count != TEST_BLOCK_LEN) || (first < s_next[ch])
+         || (block->timestamp != s_round[ch][first])) {
+            return false;
+        }
+        for (uint32_t i = 0; i < block->count; i++) {
+            if (block->samples[i] != sample_word(ch, first + i)) {
+                return false;
+            }
+        }
+        *gap += first - s_next[ch];
+        s_next[ch] = first + block->count;
+        s_block[ch]++;
+        hpm_sdm_stream_release(&s_stream, ch);
+    }
+    return true;
+}
+
+static void stream_config(hpm_sdm_stream_config_t *config, SDM_Type *ptr, uint8_t mask, uint16_t block_len)
+{
+    memset(config, 0, sizeof(*config));
+    config->ptr = ptr;
+    config->ch_mask = mask;
+    config->block_len = block_len;
+    config->block_count = TEST_BLOCK_COUNT;
+    for (uint8_t ch = 0; ch < HPM_SDM_STREAM_CHANNELS; ch++) {
+        config->buf[ch] = s_buf[ch];
+    }
+    config->get_timestamp = get_time;
+}
+
+/* register accesses per sample of the stream with channels streamed, a FIFO threshold interrupt each */
+static double stream_accesses(SDM_Type *sdm, uint8_t channels)
+{
+    hpm_sdm_stream_config_t config;
+    uint32_t accesses = 0;
+
+    stream_config(&config, sdm, (uint8_t)((1U << channels) - 1U), TEST_BLOCK_LEN);
+    hpm_sdm_stream_init(&s_stream, &config);
+    for (uint32_t n = 0; n < TEST_ACCESS_ISRS; n++) {
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            for (uint32_t i = 0; i < TEST_THRESHOLD; i++) {
+                hpm_host_sim_sdm_sample(&s_sdm, ch, 0);
+            }
+        }
+        hpm_host_sim_block_reset_stat(s_sdm.block);
+        hpm_sdm_stream_isr_handler(&s_stream);
+        accesses += s_sdm.block->reads + s_sdm.block->writes;
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            while (hpm_sdm_stream_get_block(&s_stream, ch) != NULL) {
+                hpm_sdm_stream_release(&s_stream, ch);
+            }
+        }
+    }
+    return (double)accesses / (TEST_ACCESS_ISRS * TEST_THRESHOLD * channels);
+}
+
+static uint32_t stream_samples(uint8_t channels)
+{
+    uint32_t samples = 0;
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        samples += s_stream.ch[ch].head * s_stream.block_len + s_stream.ch[ch].fill;
+    }
+    return samples;
+}
+
+/*
+ * host ns per interrupt of the handler with channels streamed and of the task
+ * taking the blocks, registers in plain memory; samples per interrupt in *samples
+ */
+static double stream_ns(uint8_t channels, double *samples)
+{
+    hpm_sdm_stream_config_t config;
+    uint64_t start;
+    uint64_t elapsed;
+
+    memset(&s_image, 0, sizeof(s_image));
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        s_image.CH[ch].SDST = TEST_THRESHOLD << SDM_CH_SDST_FILL_SHIFT;
+    }
+    stream_config(&config, &s_image, (uint8_t)((1U << channels) - 1U), TEST_BENCH_LEN);
+    hpm_sdm_stream_init(&s_stream, &config);
+    start = now_ns();
+    for (uint32_t n = 0; n < TEST_BENCH_ISRS; n++) {
+        hpm_sdm_stream_isr_handler(&s_stream);
+        /* the task keeps up, the ring never fills */
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            while (hpm_sdm_stream_get_block(&s_stream, ch) != NULL) {
+                hpm_sdm_stream_release(&s_stream, ch);
+            }
+        }
+    }
+    elapsed = now_ns() - start;
+    *samples = (double)stream_samples(channels) / TEST_BENCH_ISRS;
+    return (double)elapsed / TEST_BENCH_ISRS;
+}
+
+/* the same with sdm_receive_filter_data() per channel and FIFO threshold, ns per sample */
+static double poll_ns(uint8_t channels)
+{
+    uint64_t start;
+    uint64_t elapsed;
+
+    memset(&s_image, 0, sizeof(s_image));
+    /* STATUS is read only for the driver */
+    *(uint32_t *)&s_image.STATUS = SDM_STATUS_CH0DRY_MASK | SDM_STATUS_CH1DRY_MASK | SDM_STATUS_CH2DRY_MASK | SDM_STATUS_CH3DRY_MASK;
+    start = now_ns();
+    for (uint32_t n = 0; n < TEST_BENCH_ISRS; n++) {
+        for (uint8_t ch = 0; ch < channels; ch++) {
+            sdm_receive_filter_data(&s_image, ch, true, (int8_t *)s_poll, TEST_THRESHOLD, sizeof(int32_t));
+        }
+    }
+    elapsed = now_ns() - start;
+    return (double)elapsed / ((uint64_t)TEST_BENCH_ISRS * TEST_THRESHOLD * channels);
+}
+
+int main(void)
+{
+    SDM_Type *sdm;
+    hpm_host_sim_block_t *block;
+    hpm_sdm_stream_config_t config;
+    const hpm_sdm_stream_block_t *got;
+    uint32_t gap[HPM_SDM_STREAM_CHANNELS] = { 0 };
+    uint32_t count;
+    uint32_t events = 0;
+    uint32_t poll_reads;
+    double stream_acc;
+    double isr_cost;
+    double isr_samples;
+    double sample_cost;
+
+    CHECK(hpm_host_sim_sdm_init(&s_sdm));
+    sdm = hpm_host_sim_sdm_base(&s_sdm);
+    block = s_sdm.block;
+    for (uint8_t ch = 0; ch < HPM_SDM_STREAM_CHANNELS; ch++) {
+        sdm->CH[ch].SDFIFOCTRL = SDM_CH_SDFIFOCTRL_THRSH_SET(TEST_THRESHOLD);
+    }
+
+    /* configuration checks */
+    stream_config(&config, sdm, TEST_MASK, TEST_BLOCK_LEN);
+    config.block_count = 3;
+    CHECK(hpm_sdm_stream_init(&s_stream, &config) == status_invalid_argument);
+    config.block_count = 2U * HPM_SDM_STREAM_MAX_BLOCKS;
+    CHECK(hpm_sdm_stream_init(&s_stream, &config) == status_invalid_argument);
+    config.block_count = TEST_BLOCK_COUNT;
+    config.ch_mask = 0x10U;
+    CHECK(hpm_sdm_stream_init(&s_stream, &config) == status_invalid_argument);
+    config.ch_mask = TEST_MASK;
+    config.buf[3] = NULL;
+    CHECK(hpm_sdm_stream_init(&s_stream, &config) == status_invalid_argument);
+    config.buf[3] = s_buf[3];
+    config.block_len = 0;
+    CHECK(hpm_sdm_stream_init(&s_stream, &config) == status_invalid_argument);
+
+    /* random bursts, a consumer that falls behind now and then, comparator events */
+    stream_config(&config, sdm, TEST_MASK, TEST_BLOCK_LEN);
+    config.event_callback = on_event;
+    CHECK(hpm_sdm_stream_init(&s_stream, &config) == status_success);
+    s_event_ch = HPM_SDM_STREAM_CHANNELS;
+    for (s_time = 0; s_time < TEST_ROUNDS; s_time++) {
+        for (uint8_t ch = 0; ch < HPM_SDM_STREAM_CHANNELS; ch++) {
+            if ((TEST_MASK & (1U << ch)) != 0U) {
+                count = 1U + rnd() % HPM_HOST_SIM_SDM_FIFO_DEPTH;
+                CHECK(push(ch, count) == count);
+            }
+        }
+        if ((rnd() % 16U) == 0U) {
+            s_event_ch = HPM_SDM_STREAM_CHANNELS;
+            s_event_head = s_stream.ch[1].head;
+            s_event_fill = s_stream.ch[1].fill;
+            hpm_host_sim_sdm_event(&s_sdm, 1, SDM_CH_SCST_CMPH_MASK);
+            events++;
+        }
+        hpm_sdm_stream_isr_handler(&s_stream);
+        if (s_event_ch != HPM_SDM_STREAM_CHANNELS) {
+            CHECK((s_event_ch == 1U) && (s_event_flags == SDM_CH_SCST_CMPH_MASK) && !s_event_stored);
+            CHECK(hpm_host_sim_peek(block, offsetof(SDM_Type, CH[1].SCST)) == 0U);
+            s_event_ch = HPM_SDM_STREAM_CHANNELS;
+        }
+        for (uint8_t ch = 0; ch < HPM_SDM_STREAM_CHANNELS; ch++) {
+            CHECK(s_sdm.level[ch] == 0U);
+            /* stalls of a few rounds fill the ring of 4 blocks */
+            if (((TEST_MASK & (1U << ch)) != 0U) && ((rnd() % 8U) == 0U)) {
+                CHECK(consume(ch, &gap[ch]));
+            }
+        }
+    }
+    for (uint8_t ch = 0; ch < HPM_SDM_STREAM_CHANNELS; ch++) {
+        if ((TEST_MASK & (1U << ch)) == 0U) {
+            CHECK((s_sdm.samples[ch] == 0U) && (s_stream.ch[ch].head == 0U));
+            continue;
+        }
+        CHECK(consume(ch, &gap[ch]));
+        /* every sample is in a block, in the block being filled or counted as dropped */
+        CHECK(s_next[ch] + s_stream.ch[ch].fill + s_stream.ch[ch].dropped - gap[ch] == s_seq[ch]);
+        CHECK(gap[ch] <= s_stream.ch[ch].dropped);
+        CHECK(s_stream.ch[ch].errors == 0U);
+        printf("channel %u: %u samples, %u blocks, %u dropped by a full ring\n",
+               ch, s_seq[ch], s_block[ch], s_stream.ch[ch].dropped);
+    }
+    CHECK(gap[0] + gap[1] + gap[3] != 0U);
+    CHECK(s_stream.ch[1].events == events);
+    CHECK((s_stream.ch[0].events == 0U) && (s_stream.ch[3].events == 0U));
+
+    /* a FIFO overflow is counted once and cleared */
+    CHECK(push(0, HPM_HOST_SIM_SDM_FIFO_DEPTH + 1U) == HPM_HOST_SIM_SDM_FIFO_DEPTH);
+    CHECK(s_sdm.lost[0] == 1U);
+    CHECK((sdm_get_status(sdm) & CHN_ERR_MASK(0)) != 0U);
+    hpm_sdm_stream_isr_handler(&s_stream);
+    CHECK(s_stream.ch[0].errors == 1U);
+    CHECK((hpm_host_sim_peek(block, offsetof(SDM_Type, CH[0].SDST)) & SDM_CH_SDST_DOV_ERR_MASK) == 0U);
+    CHECK((sdm_get_status(sdm) & CHN_ERR_MASK(0)) == 0U);
+    hpm_sdm_stream_isr_handler(&s_stream);
+    CHECK(s_stream.ch[0].errors == 1U);
+
+    /* without a timestamp source the blocks carry the core cycle counter */
+    stream_config(&config, sdm, 0x04U, 4);
+    config.get_timestamp = NULL;
+    CHECK(hpm_sdm_stream_init(&s_stream, &config) == status_success);
+    s_seq[2] = 0;
+    hpm_host_mcycle = 0x12345678U;
+    CHECK(push(2, 6) == 6U);
+    hpm_sdm_stream_isr_handler(&s_stream);
+    got = hpm_sdm_stream_get_block(&s_stream, 2);
+    CHECK((got != NULL) && (got->timestamp == 0x12345678U) && (got->samples[3] == sample_word(2, 3)));
+    hpm_sdm_stream_release(&s_stream, 2);
+    CHECK(hpm_sdm_stream_get_block(&s_stream, 2) == NULL);
+    CHECK(s_stream.ch[2].fill == 2U);
+    hpm_sdm_stream_release(&s_stream, 2);
+    CHECK(s_stream.ch[2].tail == 1U);
+
+    /* per sample register accesses: polled words against the FIFO threshold interrupt */
+    CHECK(push(0, TEST_THRESHOLD) == TEST_THRESHOLD);
+    hpm_host_sim_block_reset_stat(block);
+    CHECK(sdm_receive_filter_data(sdm, 0, true, (int8_t *)s_poll, TEST_THRESHOLD, sizeof(int32_t)) == status_success);
+    CHECK(s_poll[TEST_THRESHOLD - 1U] == sample_word(0, s_seq[0] - 1U));
+    poll_reads = block->reads;
+    CHECK(block->writes == 0U);
+    printf("FIFO threshold %u, block of %u samples, per sample:\n", TEST_THRESHOLD, TEST_BENCH_LEN);
+    printf("  sdm_receive_filter_data: %.2f register accesses\n", (double)poll_reads / TEST_THRESHOLD);
+    for (uint8_t channels = 1; channels <= HPM_SDM_STREAM_CHANNELS; channels++) {
+        stream_acc = stream_accesses(sdm, channels);
+        printf("  hpm_sdm_stream, %u of %u channels: %.2f register accesses\n", channels, HPM_SDM_STREAM_CHANNELS, stream_acc);
+        CHECK(stream_acc < (double)poll_reads / TEST_THRESHOLD);
+    }
+
+    /* host CPU per interrupt, per channel and per sample, load at TEST_RATE samples/s per channel */
+    for (uint8_t channels = 1; channels <= HPM_SDM_STREAM_CHANNELS; channels++) {
+        isr_cost = stream_ns(channels, &isr_samples);
+        sample_cost = isr_cost / isr_samples;
+        printf("%u of %u channels: hpm_sdm_stream %.1f ns per interrupt, %.1f ns per channel, %.2f ns per sample, "
+               "%.3f %% CPU at %u ksps each; sdm_receive_filter_data %.2f ns per sample\n",
+               channels, HPM_SDM_STREAM_CHANNELS, isr_cost, isr_cost / channels, sample_cost,
+               sample_cost * channels * TEST_RATE / 1e7, TEST_RATE / 1000U, poll_ns(channels));
+    }
+
+    hpm_host_sim_sdm_deinit(&s_sdm);
+    return 0;
+}
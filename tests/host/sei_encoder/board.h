@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef _HPM_HOST_TEST_BOARD_H
+#define _HPM_HOST_TEST_BOARD_H
+
+/* board.h of the SEI master samples on the host, SEI settings of hpm5300evk */
+#include <stdio.h>
+#include "hpm_common.h"
+#include "hpm_clock_drv.h"
+#include "hpm_soc.h"
+#include "hpm_soc_feature.h"
+#include "hpm_interrupt.h"
+#include "hpm_debug_console.h"
+
+#define BOARD_MOTOR_CLK_NAME clock_mot0
+
+#define BOARD_SEI      HPM_SEI
+#define BOARD_SEI_CTRL SEI_CTRL_1
+#define BOARD_SEI_IRQn IRQn_SEI1
+
+void board_init(void);
+void board_init_sei_pins(SEI_Type *ptr, uint8_t sei_ctrl_idx);
+
+#endif /* _HPM_HOST_TEST_BOARD_H */
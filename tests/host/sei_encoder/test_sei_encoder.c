@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim.h"
+#include "hpm_sei_encoder.h"
+#include "board.h"
+
+/*
+ * Golden register images of the SEI encoder component. The executable links
+ * one SEI master sample, main renamed, and runs it on an SEI simulated at its
+ * HPM5361 address. The samples end with sei_trigger_input_config_init() and
+ * spin, the call returns here instead: the SEI image the sample leaves is the
+ * golden image. hpm_sei_encoder_init() of the protocol transcribed from that
+ * sample, with the same clock, interrupts and trigger period, must leave the
+ * same image on a cleared SEI. Latch transition fields whose check is
+ * disabled, and the watchdog action of an engine without watchdog, are
+ * ignored: the samples leave whatever the previous call set there.
+ * With the program placed at TEST_INSTR_BASE the image must be the golden one
+ * with the program moved and the latch, init and watchdog pointers following
+ * it. A JUMP through the init or watchdog pointer is copied as it is, a jump
+ * to a command table pointer is rejected before any register is written.
+ * HPM_SEI_ENCODER_INSTR() must encode like sei_set_instr() for every op and
+ * the operands 0 to 0x3F. Reports the register writes of sample and component.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_CLK_FREQ    (100000000UL)
+#define TEST_INSTR_BASE  (40U)
+#define TEST_WORDS       (sizeof(SEI_Type) / 4U)
+#define TEST_MAX_INSTR   (32U)
+
+#define REG_INDEX(reg)   ((uint32_t)((uintptr_t)&(reg) - (uintptr_t)HPM_SEI) / 4U)
+
+int sei_sample_main(void);
+hpm_stat_t __real_sei_trigger_input_config_init(SEI_Type *ptr, uint8_t idx, sei_trigger_input_config_t *config);
+
+static hpm_host_sim_block_t *s_sei;
+static jmp_buf s_sample_done;
+static bool s_in_sample;
+static uint32_t s_golden[TEST_WORDS];
+static uint32_t s_image[TEST_WORDS];
+static uint32_t s_expected[TEST_WORDS];
+static uint32_t s_instr[TEST_MAX_INSTR];
+
+void board_init(void)
+{
+}
+
+void board_init_sei_pins(SEI_Type *ptr, uint8_t sei_ctrl_idx)
+{
+    (void)ptr;
+    (void)sei_ctrl_idx;
+}
+
+uint32_t clock_get_frequency(clock_name_t clock_name)
+{
+    (void)clock_name;
+    return TEST_CLK_FREQ;
+}
+
+/* the last call of the samples, they spin after it */
+hpm_stat_t __wrap_sei_trigger_input_config_init(SEI_Type *ptr, uint8_t idx, sei_trigger_input_config_t *config)
+{
+    hpm_stat_t stat = __real_sei_trigger_input_config_init(ptr, idx, config);
+
+    if (s_in_sample) {
+        longjmp(s_sample_done, 1);
+    }
+    return stat;
+}
+
+/* fields of a latch transition that are not checked do not matter */
+static uint32_t tran_significant(uint32_t tran)
+{
+    if (SEI_CTRL_LATCH_TRAN_OV_PTR_GET(tran) != 0U) {
+        tran &= ~(SEI_CTRL_LATCH_TRAN_POINTER_MASK | SEI_CTRL_LATCH_TRAN_CFG_PTR_MASK);
+    }
+    if (SEI_CTRL_LATCH_TRAN_OV_CLK_GET(tran) != 0U) {
+        tran &= ~SEI_CTRL_LATCH_TRAN_CFG_CLK_MASK;
+    }
+    if (SEI_CTRL_LATCH_TRAN_OV_TXD_GET(tran) != 0U) {
+        tran &= ~SEI_CTRL_LATCH_TRAN_CFG_TXD_MASK;
+    }
+    if (SEI_CTRL_LATCH_TRAN_OV_TM_GET(tran) != 0U) {
+        tran &= ~SEI_CTRL_LATCH_TRAN_CFG_TM_MASK;
+    }
+    return tran;
+}
+
+static void snapshot(uint32_t *image)
+{
+    for (uint32_t i = 0; i < TEST_WORDS; i++) {
+        image[i] = hpm_host_sim_peek(s_sei, i * 4U);
+    }
+    for (uint32_t ctrl = 0; ctrl < ARRAY_SIZE(HPM_SEI->CTRL); ctrl++) {
+        uint32_t engine = REG_INDEX(HPM_SEI->CTRL[ctrl].ENGINE.CTRL);
+
+        if (SEI_CTRL_ENGINE_CTRL_WATCH_GET(image[engine]) == 0U) {
+            image[engine] &= ~SEI_CTRL_ENGINE_CTRL_EXCEPT_MASK;
+        }
+        for (uint32_t latch = 0; latch < ARRAY_SIZE(HPM_SEI->CTRL[0].LATCH); latch++) {
+            for (uint32_t tran = 0; tran < 4U; tran++) {
+                uint32_t i = REG_INDEX(HPM_SEI->CTRL[ctrl].LATCH[latch].TRAN[tran]);
+
+                image[i] = tran_significant(image[i]);
+            }
+        }
+    }
+}
+
+static void clear(void)
+{
+    for (uint32_t i = 0; i < TEST_WORDS; i++) {
+        hpm_host_sim_poke(s_sei, i * 4U, 0);
+    }
+    hpm_host_sim_block_reset_stat(s_sei);
+}
+
+static int compare(const uint32_t *expected, const uint32_t *image, const char *what)
+{
+    for (uint32_t i = 0; i < TEST_WORDS; i++) {
+        if (expected[i] != image[i]) {
+            printf("%s: SEI+0x%04x is 0x%08x, expected 0x%08x\n", what, (unsigned int)(i * 4U),
+                   (unsigned int)image[i], (unsigned int)expected[i]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static hpm_stat_t encoder_init(const hpm_sei_encoder_protocol_t *protocol, uint8_t instr_base)
+{
+    static hpm_sei_encoder_t encoder;
+    hpm_sei_encoder_config_t config = {
+        .instr_base = instr_base,
+        .src_clk_freq = TEST_CLK_FREQ,
+        .trig_period_us = 200000,
+        .irq_mask = sei_irq_latch1_event | sei_irq_trx_err_event,
+    };
+
+    clear();
+    return hpm_sei_encoder_init(&encoder, HPM_SEI, BOARD_SEI_CTRL, protocol, &config);
+}
+
+/* the golden image with the program at instr_base */
+static void relocate(uint32_t *image, const uint32_t *golden, uint8_t instr_count, uint8_t instr_base)
+{
+    uint32_t instr = REG_INDEX(HPM_SEI->INSTR[0]);
+    uint32_t ptr_cfg = REG_INDEX(HPM_SEI->CTRL[BOARD_SEI_CTRL].ENGINE.PTR_CFG);
+
+    memcpy(image, golden, sizeof(s_golden));
+    for (uint32_t i = 0; i < instr_count; i++) {
+        image[instr + i] = 0;
+    }
+    for (uint32_t i = 0; i < instr_count; i++) {
+        image[instr + instr_base + i] = golden[instr + i];
+    }
+    for (uint32_t latch = SEI_LATCH_0; latch <= SEI_LATCH_1; latch++) {
+        for (uint32_t tran = 0; tran < 4U; tran++) {
+            uint32_t i = REG_INDEX(HPM_SEI->CTRL[BOARD_SEI_CTRL].LATCH[latch].TRAN[tran]);
+
+            if (SEI_CTRL_LATCH_TRAN_OV_PTR_GET(image[i]) == 0U) {
+                image[i] = (image[i] & ~SEI_CTRL_LATCH_TRAN_POINTER_MASK)
+                         | SEI_CTRL_LATCH_TRAN_POINTER_SET(SEI_CTRL_LATCH_TRAN_POINTER_GET(image[i]) + instr_base);
+            }
+        }
+    }
+    image[ptr_cfg] = (image[ptr_cfg] & ~(SEI_CTRL_ENGINE_PTR_CFG_POINTER_INIT_MASK | SEI_CTRL_ENGINE_PTR_CFG_POINTER_WDOG_MASK))
+                   | SEI_CTRL_ENGINE_PTR_CFG_POINTER_INIT_SET(SEI_CTRL_ENGINE_PTR_CFG_POINTER_INIT_GET(image[ptr_cfg]) + instr_base)
+                   | SEI_CTRL_ENGINE_PTR_CFG_POINTER_WDOG_SET(SEI_CTRL_ENGINE_PTR_CFG_POINTER_WDOG_GET(image[ptr_cfg]) + instr_base);
+}
+
+int main(void)
+{
+    const hpm_sei_encoder_protocol_t *protocol = &TEST_PROTOCOL;
+    hpm_sei_encoder_protocol_t jump_protocol;
+    hpm_host_sim_block_t *plic;
+    hpm_host_sim_block_t *synt;
+    uint32_t sample_writes;
+    uint32_t encoder_writes;
+    uint32_t jump_word;
+    uint32_t rejected[] = { 0x02U, SEI_JUMP_CMD_TABLE_INSTR_IDX0, SEI_JUMP_CMD_TABLE_INSTR_IDX15 };
+
+    s_sei = hpm_host_sim_block_create_at(HPM_SEI_BASE, sizeof(SEI_Type), NULL, NULL);
+    plic = hpm_host_sim_block_create_at(HPM_PLIC_BASE, sizeof(PLIC_Type), NULL, NULL);
+    synt = hpm_host_sim_block_create_at(HPM_SYNT_BASE, sizeof(SYNT_Type), NULL, NULL);
+    CHECK((s_sei != NULL) && (plic != NULL) && (synt != NULL));
+    CHECK((protocol->instr_count + 1U) <= TEST_MAX_INSTR);
+
+    /* golden image */
+    s_in_sample = true;
+    if (setjmp(s_sample_done) == 0) {
+        sei_sample_main();
+        CHECK(false);
+    }
+    s_in_sample = false;
+    sample_writes = s_sei->writes;
+    snapshot(s_golden);
+
+    /* same image from the protocol table */
+    CHECK(encoder_init(protocol, 0) == status_success);
+    encoder_writes = s_sei->writes;
+    snapshot(s_image);
+    CHECK(compare(s_golden, s_image, protocol->name) == 0);
+
+    /* moved program */
+    CHECK(encoder_init(protocol, TEST_INSTR_BASE) == status_success);
+    snapshot(s_image);
+    relocate(s_expected, s_golden, protocol->instr_count, TEST_INSTR_BASE);
+    CHECK(compare(s_expected, s_image, "instr_base") == 0);
+    CHECK(encoder_init(protocol, (uint8_t)(ARRAY_SIZE(HPM_SEI->INSTR) - protocol->instr_count + 1U))
+          == status_invalid_argument);
+
+    /* jumps go through the engine pointers only */
+    jump_protocol = *protocol;
+    memcpy(s_instr, protocol->instr, protocol->instr_count * sizeof(uint32_t));
+    jump_protocol.instr = s_instr;
+    jump_protocol.instr_count = protocol->instr_count + 1U;
+    for (uint32_t opr = SEI_JUMP_INIT_INSTR_IDX; opr <= SEI_JUMP_WDG_INSTR_IDX; opr++) {
+        jump_word = HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_JUMP, 0, SEI_DAT_0, SEI_DAT_0, opr);
+        s_instr[protocol->instr_count] = jump_word;
+        CHECK(encoder_init(&jump_protocol, TEST_INSTR_BASE) == status_success);
+        CHECK(HPM_SEI->INSTR[TEST_INSTR_BASE + protocol->instr_count] == jump_word);
+        CHECK(SEI_CTRL_ENGINE_PTR_CFG_POINTER_INIT_GET(HPM_SEI->CTRL[BOARD_SEI_CTRL].ENGINE.PTR_CFG)
+              == TEST_INSTR_BASE);
+    }
+    for (uint32_t i = 0; i < ARRAY_SIZE(rejected); i++) {
+        s_instr[protocol->instr_count] = HPM_SEI_ENCODER_INSTR(SEI_INSTR_OP_JUMP, 0, SEI_DAT_0, SEI_DAT_0, rejected[i]);
+        CHECK(encoder_init(&jump_protocol, 0) == status_invalid_argument);
+        CHECK(s_sei->writes == 0U);
+    }
+
+    /* operands as sei_set_instr() stores them */
+    for (uint32_t op = SEI_INSTR_OP_HALT; op <= SEI_INSTR_OP_RECV; op++) {
+        for (uint32_t opr = 0; opr <= 0x3FU; opr++) {
+            sei_set_instr(HPM_SEI, 0, (uint8_t)op, 1, SEI_DAT_2, SEI_DAT_3, (uint8_t)opr);
+            CHECK(hpm_host_sim_peek(s_sei, REG_INDEX(HPM_SEI->INSTR[0]) * 4U)
+                  == HPM_SEI_ENCODER_INSTR(op, 1, SEI_DAT_2, SEI_DAT_3, opr));
+        }
+    }
+
+    printf("%s: %u instructions, the sample writes %u SEI registers, the component %u\n", protocol->name,
+           (unsigned int)protocol->instr_count, (unsigned int)sample_writes, (unsigned int)encoder_writes);
+    return 0;
+}
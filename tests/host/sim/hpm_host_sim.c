@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "hpm_host_sim.h"
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "the host register simulation needs Linux on x86_64"
+#endif
+
+/*****************************************************************************************************************
+ *
+ *  Definitions
+ *
+ *****************************************************************************************************************/
+#define HOST_SIM_EFLAGS_TF      (0x100UL)
+#define HOST_SIM_PF_WRITE       (0x2UL)     /* page fault error code, write access */
+
+typedef struct {
+    hpm_host_sim_block_t *block;    /* block of the access being single stepped */
+    uint32_t offset;
+    uint32_t old;
+    bool write;
+} host_sim_pending_t;
+
+/*****************************************************************************************************************
+ *
+ *  Variables
+ *
+ *****************************************************************************************************************/
+static hpm_host_sim_block_t s_blocks[HPM_HOST_SIM_MAX_BLOCKS];
+static host_sim_pending_t s_pending;
+static bool s_handlers_installed;
+
+/*****************************************************************************************************************
+ *
+ *  Codes
+ *
+ *****************************************************************************************************************/
+static void host_sim_protect(hpm_host_sim_block_t *block, bool open)
+{
+    if (mprotect(block->base, block->size, open ? (PROT_READ | PROT_WRITE) : PROT_NONE) != 0) {
+        abort();
+    }
+    block->open = open;
+}
+
+hpm_host_sim_block_t *hpm_host_sim_find(uint32_t addr)
+{
+    for (uint32_t i = 0; i < HPM_HOST_SIM_MAX_BLOCKS; i++) {
+        uintptr_t base = (uintptr_t)s_blocks[i].base;
+        if ((base != 0U) && (addr >= base) && (addr < (base + s_blocks[i].size))) {
+            return &s_blocks[i];
+        }
+    }
+    return NULL;
+}
+
+/* an access to a closed block: open it, let a read hook set the value, single step the instruction */
+static void host_sim_segv_handler(int sig, siginfo_t *info, void *ucontext)
+{
+    ucontext_t *uc = (ucontext_t *)ucontext;
+    hpm_host_sim_block_t *block = NULL;
+    uint32_t offset;
+    uint32_t *reg;
+
+    if ((uintptr_t)info->si_addr <= UINT32_MAX) {
+        block = hpm_host_sim_find((uint32_t)(uintptr_t)info->si_addr);
+    }
+    if ((block == NULL) || block->open) {
+        /* a real fault */
+        signal(sig, SIG_DFL);
+        return;
+    }
+
+    offset = (uint32_t)((uintptr_t)info->si_addr - (uintptr_t)block->base) & ~3U;
+    host_sim_protect(block, true);
+    reg = hpm_host_sim_reg(block, offset);
+
+    s_pending.block = block;
+    s_pending.offset = offset;
+    s_pending.old = *reg;
+    s_pending.write = (uc->uc_mcontext.gregs[REG_ERR] & HOST_SIM_PF_WRITE) != 0;
+    if (!s_pending.write) {
+        block->reads++;
+        block->reg_reads[offset / 4U]++;
+        if (block->hook != NULL) {
+            block->hook(block, offset, hpm_host_sim_read, *reg, reg);
+        }
+    }
+    uc->uc_mcontext.gregs[REG_EFL] |= HOST_SIM_EFLAGS_TF;
+}
+
+/* the access is done: pass a write to the hook and close the block again */
+static void host_sim_trap_handler(int sig, siginfo_t *info, void *ucontext)
+{
+    ucontext_t *uc = (ucontext_t *)ucontext;
+    hpm_host_sim_block_t *block = s_pending.block;
+    uint32_t *reg;
+
+    (void)info;
+    if (block == NULL) {
+        signal(sig, SIG_DFL);
+        return;
+    }
+
+    if (s_pending.write) {
+        reg = hpm_host_sim_reg(block, s_pending.offset);
+        block->writes++;
+        block->reg_writes[s_pending.offset / 4U]++;
+        if (block->hook != NULL) {
+            block->hook(block, s_pending.offset, hpm_host_sim_write, s_pending.old, reg);
+        }
+    }
+    s_pending.block = NULL;
+    host_sim_protect(block, false);
+    uc->uc_mcontext.gregs[REG_EFL] &= ~HOST_SIM_EFLAGS_TF;
+}
+
+static void host_sim_install_handlers(void)
+{
+    struct sigaction sa;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_sigaction = host_sim_segv_handler;
+    sigaction(SIGSEGV, &sa, NULL);
+    sa.sa_sigaction = host_sim_trap_handler;
+    sigaction(SIGTRAP, &sa, NULL);
+    s_handlers_installed = true;
+}
+
+hpm_host_sim_block_t *hpm_host_sim_block_create(size_t size, hpm_host_sim_hook_t hook, void *context)
+{
+    return hpm_host_sim_block_create_at(0, size, hook, context);
+}
+
+hpm_host_sim_block_t *hpm_host_sim_block_create_at(uint32_t addr, size_t size, hpm_host_sim_hook_t hook, void *context)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    hpm_host_sim_block_t *block = NULL;
+    void *base;
+
+    for (uint32_t i = 0; i < HPM_HOST_SIM_MAX_BLOCKS; i++) {
+        if (s_blocks[i].base == NULL) {
+            block = &s_blocks[i];
+            break;
+        }
+    }
+    if (block == NULL) {
+        return NULL;
+    }
+
+    size = (size + page - 1U) & ~(page - 1U);
+    if (addr != 0U) {
+        base = mmap((void *)(uintptr_t)addr, size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        if ((base != MAP_FAILED) && (base != (void *)(uintptr_t)addr)) {
+            /* kernels before 4.17 take the flag as a hint */
+            munmap(base, size);
+            base = MAP_FAILED;
+        }
+    } else {
+        base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    }
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    if (!s_handlers_installed) {
+        host_sim_install_handlers();
+    }
+
+    memset(block, 0, sizeof(*block));
+    block->base = base;
+    block->size = size;
+    block->hook = hook;
+    block->context = context;
+    block->reg_reads = calloc(size / 4U, sizeof(uint32_t));
+    block->reg_writes = calloc(size / 4U, sizeof(uint32_t));
+    if ((block->reg_reads == NULL) || (block->reg_writes == NULL)) {
+        abort();
+    }
+    host_sim_protect(block, false);
+
+    return block;
+}
+
+void hpm_host_sim_block_destroy(hpm_host_sim_block_t *block)
+{
+    munmap(block->base, block->size);
+    free(block->reg_reads);
+    free(block->reg_writes);
+    memset(block, 0, sizeof(*block));
+}
+
+void hpm_host_sim_block_reset_stat(hpm_host_sim_block_t *block)
+{
+    block->reads = 0;
+    block->writes = 0;
+    block->bus_reads = 0;
+    block->bus_writes = 0;
+    memset(block->reg_reads, 0, (block->size / 4U) * sizeof(uint32_t));
+    memset(block->reg_writes, 0, (block->size / 4U) * sizeof(uint32_t));
+}
+
+uint32_t *hpm_host_sim_reg(hpm_host_sim_block_t *block, uint32_t offset)
+{
+    return (uint32_t *)((uint8_t *)block->base + offset);
+}
+
+uint32_t hpm_host_sim_peek(hpm_host_sim_block_t *block, uint32_t offset)
+{
+    bool open = block->open;
+    uint32_t value;
+
+    if (!open) {
+        host_sim_protect(block, true);
+    }
+    value = *hpm_host_sim_reg(block, offset);
+    if (!open) {
+        host_sim_protect(block, false);
+    }
+    return value;
+}
+
+void hpm_host_sim_poke(hpm_host_sim_block_t *block, uint32_t offset, uint32_t value)
+{
+    bool open = block->open;
+
+    if (!open) {
+        host_sim_protect(block, true);
+    }
+    *hpm_host_sim_reg(block, offset) = value;
+    if (!open) {
+        host_sim_protect(block, false);
+    }
+}
+
+void hpm_host_sim_block_open(hpm_host_sim_block_t *block)
+{
+    host_sim_protect(block, true);
+}
+
+void hpm_host_sim_block_close(hpm_host_sim_block_t *block)
+{
+    host_sim_protect(block, false);
+}
+
+uint32_t hpm_host_sim_bus_read(uint32_t addr, uint8_t width)
+{
+    hpm_host_sim_block_t *block = hpm_host_sim_find(addr);
+    uintptr_t p = (uintptr_t)addr;
+    uint32_t offset;
+    uint32_t *reg;
+    uint32_t value;
+    bool open;
+
+    if (block == NULL) {
+        return (width == 1U) ? *(volatile uint8_t *)p : ((width == 2U) ? *(volatile uint16_t *)p : *(volatile uint32_t *)p);
+    }
+
+    offset = (addr - (uint32_t)(uintptr_t)block->base) & ~3U;
+    open = block->open;
+    if (!open) {
+        host_sim_protect(block, true);
+    }
+    reg = hpm_host_sim_reg(block, offset);
+    block->bus_reads++;
+    if (block->hook != NULL) {
+        block->hook(block, offset, hpm_host_sim_read, *reg, reg);
+    }
+    value = *reg >> ((addr & 3U) * 8U);
+    if (!open) {
+        host_sim_protect(block, false);
+    }
+    return (width == 4U) ? value : (value & ((1UL << (width * 8U)) - 1U));
+}
+
+void hpm_host_sim_bus_write(uint32_t addr, uint32_t value, uint8_t width)
+{
+    hpm_host_sim_block_t *block = hpm_host_sim_find(addr);
+    uintptr_t p = (uintptr_t)addr;
+    uint32_t offset;
+    uint32_t shift;
+    uint32_t mask;
+    uint32_t old;
+    uint32_t *reg;
+    bool open;
+
+    if (block == NULL) {
+        if (width == 1U) {
+            *(volatile uint8_t *)p = (uint8_t)value;
+        } else if (width == 2U) {
+            *(volatile uint16_t *)p = (uint16_t)value;
+        } else {
+            *(volatile uint32_t *)p = value;
+        }
+        return;
+    }
+
+    offset = (addr - (uint32_t)(uintptr_t)block->base) & ~3U;
+    shift = (addr & 3U) * 8U;
+    mask = (width == 4U) ? UINT32_MAX : (((1UL << (width * 8U)) - 1U) << shift);
+    open = block->open;
+    if (!open) {
+        host_sim_protect(block, true);
+    }
+    reg = hpm_host_sim_reg(block, offset);
+    old = *reg;
+    *reg = (old & ~mask) | ((value << shift) & mask);
+    block->bus_writes++;
+    if (block->hook != NULL) {
+        block->hook(block, offset, hpm_host_sim_write, old, reg);
+    }
+    if (!open) {
+        host_sim_protect(block, false);
+    }
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_SIM_H
+#define HPM_HOST_SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Host register simulation
+ *
+ * A register block is host memory laid out like the peripheral, drivers get
+ * it as their *_Type pointer and run unmodified. The block is kept
+ * inaccessible, every access traps, is counted per register and passed to
+ * the hook of the block, which models the peripheral: it may change the
+ * value a read returns or the value a write leaves in the register.
+ *
+ * Accesses are treated as 32-bit registers, a read-modify-write instruction
+ * counts as a write. Blocks are mapped below 4 GiB, so drivers that store
+ * register addresses in uint32_t keep working.
+ *
+ * Linux on x86_64 only: the access is single stepped with the trap flag.
+ * Hooks run in a signal handler and may only touch the memory of their own
+ * block, through the value pointer or hpm_host_sim_reg(), and plain memory.
+ *
+ * Behavioral models of bus masters, e.g. a DMA controller, run from the test
+ * and reach other blocks with hpm_host_sim_bus_read()/hpm_host_sim_bus_write().
+ * Those accesses call the hook of the target block like a CPU access but are
+ * counted apart, so the CPU counts stay the cost of the driver. Tests are
+ * linked without PIE, so static buffers lie below 4 GiB as well.
+ */
+
+#define HPM_HOST_SIM_MAX_BLOCKS (8U)
+
+typedef enum {
+    hpm_host_sim_read,
+    hpm_host_sim_write,
+} hpm_host_sim_access_t;
+
+struct hpm_host_sim_block;
+
+/**
+ * @brief Access hook
+ *
+ * For a read, called before the access, *value is what the driver reads.
+ * For a write, called after the access, old is the previous content and
+ * *value the written value, which is what the register keeps.
+ */
+typedef void (*hpm_host_sim_hook_t)(struct hpm_host_sim_block *block, uint32_t offset,
+                                    hpm_host_sim_access_t access, uint32_t old, uint32_t *value);
+
+typedef struct hpm_host_sim_block {
+    void *base;                     /**< register block, pass it to the driver */
+    size_t size;                    /**< mapped size */
+    hpm_host_sim_hook_t hook;       /**< access hook, may be NULL */
+    void *context;                  /**< hook context */
+    uint32_t reads;                 /**< register reads */
+    uint32_t writes;                /**< register writes */
+    uint32_t *reg_reads;            /**< reads per 32-bit register */
+    uint32_t *reg_writes;           /**< writes per 32-bit register */
+    uint32_t bus_reads;             /**< reads by bus master models */
+    uint32_t bus_writes;            /**< writes by bus master models */
+    bool open;                      /**< accessible, inside an access or peek/poke */
+} hpm_host_sim_block_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map a zeroed register block
+ *
+ * @param [in] size size of the *_Type struct
+ * @param [in] hook access hook, may be NULL
+ * @param [in] context hook context
+ * @return block, NULL if no more blocks can be mapped
+ */
+hpm_host_sim_block_t *hpm_host_sim_block_create(size_t size, hpm_host_sim_hook_t hook, void *context);
+
+/**
+ * @brief Map a zeroed register block at its SoC address
+ *
+ * For code that reaches a peripheral through its fixed base, e.g. HPM_HDMA or
+ * HPM_PLIC, rather than a *_Type pointer it is given.
+ *
+ * @param [in] addr page aligned address, 0 for any
+ * @param [in] size size of the *_Type struct
+ * @param [in] hook access hook, may be NULL
+ * @param [in] context hook context
+ * @return block, NULL if no more blocks can be mapped or the address is taken
+ */
+hpm_host_sim_block_t *hpm_host_sim_block_create_at(uint32_t addr, size_t size, hpm_host_sim_hook_t hook, void *context);
+
+/**
+ * @brief Unmap a register block
+ */
+void hpm_host_sim_block_destroy(hpm_host_sim_block_t *block);
+
+/**
+ * @brief Clear the access counters of a block
+ */
+void hpm_host_sim_block_reset_stat(hpm_host_sim_block_t *block);
+
+/**
+ * @brief Register content inside a hook, no access is counted
+ */
+uint32_t *hpm_host_sim_reg(hpm_host_sim_block_t *block, uint32_t offset);
+
+/**
+ * @brief Read a register without counting the access
+ */
+uint32_t hpm_host_sim_peek(hpm_host_sim_block_t *block, uint32_t offset);
+
+/**
+ * @brief Write a register without counting the access or calling the hook
+ */
+void hpm_host_sim_poke(hpm_host_sim_block_t *block, uint32_t offset, uint32_t value);
+
+/**
+ * @brief Make a block accessible to its model outside of a hook
+ *
+ * For models that update many registers at once, e.g. a DMA channel. The
+ * driver must not run until hpm_host_sim_block_close(), its accesses would
+ * not trap.
+ */
+void hpm_host_sim_block_open(hpm_host_sim_block_t *block);
+
+/**
+ * @brief Trap accesses to a block again
+ */
+void hpm_host_sim_block_close(hpm_host_sim_block_t *block);
+
+/**
+ * @brief Block an address belongs to
+ *
+ * @return block, NULL for plain memory
+ */
+hpm_host_sim_block_t *hpm_host_sim_find(uint32_t addr);
+
+/**
+ * @brief Read of a bus master model
+ *
+ * A register is read through the hook of its block, counted in bus_reads,
+ * plain memory is read directly.
+ *
+ * @param [in] addr address, aligned to width
+ * @param [in] width access width in bytes: 1, 2 or 4
+ */
+uint32_t hpm_host_sim_bus_read(uint32_t addr, uint8_t width);
+
+/**
+ * @brief Write of a bus master model
+ *
+ * A register is written through the hook of its block, counted in
+ * bus_writes, a narrow write merges into the 32-bit register. Plain memory
+ * is written directly.
+ *
+ * @param [in] addr address, aligned to width
+ * @param [in] value value, the low width bytes are written
+ * @param [in] width access width in bytes: 1, 2 or 4
+ */
+void hpm_host_sim_bus_write(uint32_t addr, uint32_t value, uint8_t width);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_HOST_SIM_H */
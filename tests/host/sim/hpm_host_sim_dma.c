@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_host_sim_dma.h"
+
+#define HOST_SIM_DMA_CH_OFFSET(ch, reg) (offsetof(DMA_Type, CHCTRL[0].reg) + (ch) * sizeof(((DMA_Type *)0)->CHCTRL[0]))
+
+static void host_sim_dma_stop(hpm_host_sim_block_t *block, uint8_t ch)
+{
+    *hpm_host_sim_reg(block, HOST_SIM_DMA_CH_OFFSET(ch, CTRL)) &= ~DMA_CHCTRL_CTRL_ENABLE_MASK;
+    *hpm_host_sim_reg(block, offsetof(DMA_Type, CHEN)) &= ~(1UL << ch);
+}
+
+static void host_sim_dma_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                              hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    uint32_t ch;
+
+    if (access == hpm_host_sim_read) {
+        return;
+    }
+
+    if (offset == offsetof(DMA_Type, INTSTATUS)) {
+        *value = old & ~*value;
+    } else if (offset == offsetof(DMA_Type, CHABORT)) {
+        for (ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+            if ((*value & (1UL << ch)) != 0U) {
+                host_sim_dma_stop(block, (uint8_t)ch);
+                *hpm_host_sim_reg(block, offsetof(DMA_Type, INTSTATUS)) |= DMA_CHANNEL_IRQ_STATUS_ABORT(ch);
+            }
+        }
+        *value = 0;
+    } else if (offset == offsetof(DMA_Type, DMACTRL)) {
+        if ((*value & DMA_DMACTRL_RESET_MASK) != 0U) {
+            for (ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+                host_sim_dma_stop(block, (uint8_t)ch);
+            }
+            *hpm_host_sim_reg(block, offsetof(DMA_Type, INTSTATUS)) = 0;
+        }
+        *value = 0;
+    } else if (offset >= offsetof(DMA_Type, CHCTRL)) {
+        ch = (offset - offsetof(DMA_Type, CHCTRL)) / sizeof(((DMA_Type *)0)->CHCTRL[0]);
+        if ((ch < DMA_SOC_CHANNEL_NUM) && (offset == HOST_SIM_DMA_CH_OFFSET(ch, CTRL))) {
+            if ((*value & DMA_CHCTRL_CTRL_ENABLE_MASK) != 0U) {
+                *hpm_host_sim_reg(block, offsetof(DMA_Type, CHEN)) |= 1UL << ch;
+            } else {
+                *hpm_host_sim_reg(block, offsetof(DMA_Type, CHEN)) &= ~(1UL << ch);
+            }
+        }
+    }
+}
+
+bool hpm_host_sim_dma_init(hpm_host_sim_dma_t *dma)
+{
+    return hpm_host_sim_dma_init_at(dma, 0);
+}
+
+bool hpm_host_sim_dma_init_at(hpm_host_sim_dma_t *dma, uint32_t addr)
+{
+    memset(dma, 0, sizeof(*dma));
+    dma->block = hpm_host_sim_block_create_at(addr, sizeof(DMA_Type), host_sim_dma_hook, dma);
+    return dma->block != NULL;
+}
+
+void hpm_host_sim_dma_deinit(hpm_host_sim_dma_t *dma)
+{
+    hpm_host_sim_block_destroy(dma->block);
+    dma->block = NULL;
+}
+
+void hpm_host_sim_dma_set_request(hpm_host_sim_dma_t *dma, uint8_t ch, hpm_host_sim_dma_request_t request, void *context)
+{
+    dma->request[ch] = request;
+    dma->request_context[ch] = context;
+}
+
+static uint32_t host_sim_dma_next_addr(uint32_t addr, uint32_t addr_ctrl, uint32_t step)
+{
+    if (addr_ctrl == DMA_ADDRESS_CONTROL_INCREMENT) {
+        return addr + step;
+    } else if (addr_ctrl == DMA_ADDRESS_CONTROL_DECREMENT) {
+        return addr - step;
+    }
+    return addr;
+}
+
+/* one source unit of a channel, false if the channel waits for its request */
+static bool host_sim_dma_unit(hpm_host_sim_dma_t *dma, uint8_t ch)
+{
+    hpm_host_sim_block_t *block = dma->block;
+    uint32_t *ctrl = hpm_host_sim_reg(block, HOST_SIM_DMA_CH_OFFSET(ch, CTRL));
+    uint32_t *transize = hpm_host_sim_reg(block, HOST_SIM_DMA_CH_OFFSET(ch, TRANSIZE));
+    uint32_t *src = hpm_host_sim_reg(block, HOST_SIM_DMA_CH_OFFSET(ch, SRCADDR));
+    uint32_t *dst = hpm_host_sim_reg(block, HOST_SIM_DMA_CH_OFFSET(ch, DSTADDR));
+    uint32_t *llp = hpm_host_sim_reg(block, HOST_SIM_DMA_CH_OFFSET(ch, LLPOINTER));
+    uint32_t src_width = 1UL << DMA_CHCTRL_CTRL_SRCWIDTH_GET(*ctrl);
+    uint32_t dst_width = 1UL << DMA_CHCTRL_CTRL_DSTWIDTH_GET(*ctrl);
+    uint32_t src_step = MIN(src_width, 4U);
+    uint32_t dst_step = MIN(dst_width, 4U);
+    uint32_t dst_addr = *dst;
+    uint8_t data[8];
+    uint32_t value;
+    uint32_t i;
+
+    if ((DMA_CHCTRL_CTRL_SRCMODE_GET(*ctrl) == DMA_HANDSHAKE_MODE_HANDSHAKE)
+        || (DMA_CHCTRL_CTRL_DSTMODE_GET(*ctrl) == DMA_HANDSHAKE_MODE_HANDSHAKE)) {
+        if ((dma->request[ch] != NULL) && !dma->request[ch](dma->request_context[ch])) {
+            return false;
+        }
+    }
+
+    if (*transize != 0U) {
+        for (i = 0; i < src_width; i += src_step) {
+            value = hpm_host_sim_bus_read(*src + i, (uint8_t)src_step);
+            memcpy(&data[i], &value, src_step);
+        }
+        for (i = 0; i < src_width; i += dst_step) {
+            memcpy(&value, &data[i], dst_step);
+            hpm_host_sim_bus_write(dst_addr + (i % dst_width), value, (uint8_t)dst_step);
+            if (((i + dst_step) % dst_width) == 0U) {
+                dst_addr = host_sim_dma_next_addr(dst_addr, DMA_CHCTRL_CTRL_DSTADDRCTRL_GET(*ctrl), dst_width);
+            }
+        }
+        *src = host_sim_dma_next_addr(*src, DMA_CHCTRL_CTRL_SRCADDRCTRL_GET(*ctrl), src_width);
+        *dst = dst_addr;
+        (*transize)--;
+        dma->units++;
+    }
+
+    if (*transize == 0U) {
+        *hpm_host_sim_reg(block, offsetof(DMA_Type, INTSTATUS)) |= DMA_CHANNEL_IRQ_STATUS_TC(ch);
+        if (*llp != 0U) {
+            dma_linked_descriptor_t *desc = (dma_linked_descriptor_t *)(uintptr_t)(*llp & DMA_CHCTRL_LLPOINTER_LLPOINTERL_MASK);
+
+            *ctrl = desc->ctrl;
+            *transize = desc->trans_size;
+            *src = desc->src_addr;
+            *dst = desc->dst_addr;
+            *llp = desc->linked_ptr;
+            dma->descriptors++;
+            if ((*ctrl & DMA_CHCTRL_CTRL_ENABLE_MASK) == 0U) {
+                host_sim_dma_stop(block, ch);
+            }
+        } else {
+            host_sim_dma_stop(block, ch);
+        }
+    }
+    return true;
+}
+
+uint32_t hpm_host_sim_dma_run(hpm_host_sim_dma_t *dma, uint32_t max_units)
+{
+    hpm_host_sim_block_t *block = dma->block;
+    uint32_t start = dma->units;
+    bool moved;
+
+    hpm_host_sim_block_open(block);
+    do {
+        moved = false;
+        for (uint8_t ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+            if ((max_units != 0U) && ((dma->units - start) >= max_units)) {
+                break;
+            }
+            if ((*hpm_host_sim_reg(block, offsetof(DMA_Type, CHEN)) & (1UL << ch)) != 0U) {
+                moved |= host_sim_dma_unit(dma, ch);
+            }
+        }
+    } while (moved && ((max_units == 0U) || ((dma->units - start) < max_units)));
+    hpm_host_sim_block_close(block);
+
+    return dma->units - start;
+}
+
+bool hpm_host_sim_dma_irq(hpm_host_sim_dma_t *dma)
+{
+    hpm_host_sim_block_t *block = dma->block;
+    uint32_t status = hpm_host_sim_peek(block, offsetof(DMA_Type, INTSTATUS));
+    uint32_t ctrl;
+
+    for (uint8_t ch = 0; ch < DMA_SOC_CHANNEL_NUM; ch++) {
+        ctrl = hpm_host_sim_peek(block, HOST_SIM_DMA_CH_OFFSET(ch, CTRL));
+        if ((((status & DMA_CHANNEL_IRQ_STATUS_TC(ch)) != 0U) && ((ctrl & DMA_INTERRUPT_MASK_TERMINAL_COUNT) == 0U))
+            || (((status & DMA_CHANNEL_IRQ_STATUS_ERROR(ch)) != 0U) && ((ctrl & DMA_INTERRUPT_MASK_ERROR) == 0U))
+            || (((status & DMA_CHANNEL_IRQ_STATUS_ABORT(ch)) != 0U) && ((ctrl & DMA_INTERRUPT_MASK_ABORT) == 0U))) {
+            return true;
+        }
+    }
+    return false;
+}
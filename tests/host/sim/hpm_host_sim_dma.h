@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_SIM_DMA_H
+#define HPM_HOST_SIM_DMA_H
+
+#include "hpm_host_sim.h"
+#include "hpm_dma_drv.h"
+
+/**
+ * @brief DMA controller model, hpm_dma_regs.h layout (DMA v1)
+ *
+ * Enabling a channel sets its CHEN bit. hpm_host_sim_dma_run() moves the
+ * enabled channels one source unit at a time, round robin, through
+ * hpm_host_sim_bus_read()/hpm_host_sim_bus_write(), so a peripheral register
+ * as source or destination sees the access in its hook. A channel with a
+ * handshake side only moves a unit while its request callback returns true,
+ * the DMAMUX routing is left to the test. At the end of a descriptor the TC
+ * status is set and LLPOINTER, if not 0, loads the next descriptor, else the
+ * channel is disabled. CHABORT disables channels and sets their ABORT status,
+ * INTSTATUS is write 1 to clear.
+ */
+
+typedef bool (*hpm_host_sim_dma_request_t)(void *context);
+
+typedef struct {
+    hpm_host_sim_block_t *block;
+    hpm_host_sim_dma_request_t request[DMA_SOC_CHANNEL_NUM];    /**< handshake request, NULL: always */
+    void *request_context[DMA_SOC_CHANNEL_NUM];
+    uint32_t units;                                             /**< source units moved */
+    uint32_t descriptors;                                       /**< linked descriptors loaded */
+} hpm_host_sim_dma_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map the register block of a DMA model
+ *
+ * @return false if no block could be mapped
+ */
+bool hpm_host_sim_dma_init(hpm_host_sim_dma_t *dma);
+
+/**
+ * @brief Map the register block at its SoC address, e.g. HPM_HDMA_BASE for dma_mgr
+ *
+ * @return false if no block could be mapped there
+ */
+bool hpm_host_sim_dma_init_at(hpm_host_sim_dma_t *dma, uint32_t addr);
+
+/**
+ * @brief Unmap the register block
+ */
+void hpm_host_sim_dma_deinit(hpm_host_sim_dma_t *dma);
+
+/**
+ * @brief DMA_Type pointer to pass to the driver
+ */
+static inline DMA_Type *hpm_host_sim_dma_base(hpm_host_sim_dma_t *dma)
+{
+    return (DMA_Type *)dma->block->base;
+}
+
+/**
+ * @brief Set the handshake request of a channel
+ */
+void hpm_host_sim_dma_set_request(hpm_host_sim_dma_t *dma, uint8_t ch, hpm_host_sim_dma_request_t request, void *context);
+
+/**
+ * @brief Move data until every channel is done or waits for a request
+ *
+ * @param [in] max_units stop after this many units, 0: no limit
+ * @return units moved
+ */
+uint32_t hpm_host_sim_dma_run(hpm_host_sim_dma_t *dma, uint32_t max_units);
+
+/**
+ * @brief Interrupt line: a status bit whose interrupt is not masked
+ */
+bool hpm_host_sim_dma_irq(hpm_host_sim_dma_t *dma);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_HOST_SIM_DMA_H */
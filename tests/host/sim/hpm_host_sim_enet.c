@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_host_sim_enet.h"
+
+#define HOST_SIM_ENET_CRC_SIZE (4U)
+
+static uint32_t *host_sim_enet_reg(hpm_host_sim_enet_t *enet, uint32_t offset)
+{
+    return hpm_host_sim_reg(enet->block, offset);
+}
+
+static void host_sim_enet_set_status(hpm_host_sim_enet_t *enet, uint32_t status)
+{
+    uint32_t normal = ENET_DMA_STATUS_TI_MASK | ENET_DMA_STATUS_TU_MASK | ENET_DMA_STATUS_RI_MASK | ENET_DMA_STATUS_ERI_MASK;
+
+    *host_sim_enet_reg(enet, offsetof(ENET_Type, DMA_STATUS)) |= status
+        | (((status & normal) != 0U) ? ENET_DMA_STATUS_NIS_MASK : 0U)
+        | (((status & ~normal) != 0U) ? ENET_DMA_STATUS_AIS_MASK : 0U);
+}
+
+static uint32_t host_sim_enet_tx_next(hpm_host_sim_enet_t *enet, const enet_tx_desc_t *desc)
+{
+    if (desc->tdes0_bm.tch != 0U) {
+        return desc->tdes3_bm.next_desc;
+    }
+    return (desc->tdes0_bm.ter != 0U) ? enet->tx_list : (uint32_t)(uintptr_t)(desc + 1);
+}
+
+static uint32_t host_sim_enet_rx_next(hpm_host_sim_enet_t *enet, const enet_rx_desc_t *desc)
+{
+    if (desc->rdes1_bm.rch != 0U) {
+        return desc->rdes3_bm.next_desc;
+    }
+    return (desc->rdes1_bm.rer != 0U) ? enet->rx_list : (uint32_t)(uintptr_t)(desc + 1);
+}
+
+static void host_sim_enet_gather(hpm_host_sim_enet_t *enet, uint32_t buffer, uint32_t size)
+{
+    size = MIN(size, sizeof(enet->tx_frame) - enet->tx_length);
+    memcpy(&enet->tx_frame[enet->tx_length], (const void *)(uintptr_t)buffer, size);
+    enet->tx_length += size;
+}
+
+static void host_sim_enet_transmit(hpm_host_sim_enet_t *enet)
+{
+    enet_tx_desc_t *desc;
+    uint32_t status = 0;
+
+    if ((*host_sim_enet_reg(enet, offsetof(ENET_Type, DMA_OP_MODE)) & ENET_DMA_OP_MODE_ST_MASK) == 0U) {
+        return;
+    }
+    for (;;) {
+        desc = (enet_tx_desc_t *)(uintptr_t)enet->tx_desc;
+        if ((desc == NULL) || (desc->tdes0_bm.own == 0U)) {
+            status |= ENET_DMA_STATUS_TU_MASK;
+            break;
+        }
+        if (desc->tdes0_bm.fs != 0U) {
+            enet->tx_length = 0;
+        }
+        host_sim_enet_gather(enet, desc->tdes2_bm.buffer1, desc->tdes1_bm.tbs1);
+        if (desc->tdes0_bm.tch == 0U) {
+            host_sim_enet_gather(enet, desc->tdes3_bm.buffer2, desc->tdes1_bm.tbs2);
+        }
+        if (desc->tdes0_bm.ls != 0U) {
+            if (enet->wire != NULL) {
+                enet->wire(enet->wire_context, enet->tx_frame, enet->tx_length);
+            }
+            enet->tx_frames++;
+            if (desc->tdes0_bm.ic != 0U) {
+                status |= ENET_DMA_STATUS_TI_MASK;
+            }
+        }
+        desc->tdes0_bm.own = 0;
+        enet->tx_descriptors++;
+        enet->tx_desc = host_sim_enet_tx_next(enet, desc);
+    }
+    host_sim_enet_set_status(enet, status);
+}
+
+static void host_sim_enet_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                               hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    hpm_host_sim_enet_t *enet = (hpm_host_sim_enet_t *)block->context;
+
+    if (access == hpm_host_sim_read) {
+        if (offset == offsetof(ENET_Type, DMA_CURR_HOST_TX_DESC)) {
+            *value = enet->tx_desc;
+        } else if (offset == offsetof(ENET_Type, DMA_CURR_HOST_RX_DESC)) {
+            *value = enet->rx_desc;
+        }
+        return;
+    }
+
+    if (offset == offsetof(ENET_Type, DMA_BUS_MODE)) {
+        *value &= ~ENET_DMA_BUS_MODE_SWR_MASK;
+    } else if (offset == offsetof(ENET_Type, DMA_OP_MODE)) {
+        *value &= ~ENET_DMA_OP_MODE_FTF_MASK;
+    } else if (offset == offsetof(ENET_Type, GMII_ADDR)) {
+        *value &= ~ENET_GMII_ADDR_GB_MASK;
+    } else if (offset == offsetof(ENET_Type, DMA_STATUS)) {
+        *value = old & ~*value;
+    } else if (offset == offsetof(ENET_Type, DMA_TX_DESC_LIST_ADDR)) {
+        enet->tx_list = *value;
+        enet->tx_desc = *value;
+    } else if (offset == offsetof(ENET_Type, DMA_RX_DESC_LIST_ADDR)) {
+        enet->rx_list = *value;
+        enet->rx_desc = *value;
+    } else if (offset == offsetof(ENET_Type, DMA_TX_POLL_DEMAND)) {
+        host_sim_enet_transmit(enet);
+    } else if (offset == offsetof(ENET_Type, DMA_RX_POLL_DEMAND)) {
+        enet->rx_suspended = false;
+    }
+}
+
+bool hpm_host_sim_enet_init(hpm_host_sim_enet_t *enet, hpm_host_sim_enet_wire_t wire, void *wire_context)
+{
+    memset(enet, 0, sizeof(*enet));
+    enet->wire = wire;
+    enet->wire_context = wire_context;
+    enet->block = hpm_host_sim_block_create(sizeof(ENET_Type), host_sim_enet_hook, enet);
+    return enet->block != NULL;
+}
+
+void hpm_host_sim_enet_deinit(hpm_host_sim_enet_t *enet)
+{
+    hpm_host_sim_block_destroy(enet->block);
+    enet->block = NULL;
+}
+
+bool hpm_host_sim_enet_receive(hpm_host_sim_enet_t *enet, const uint8_t *frame, uint32_t length)
+{
+    uint32_t total = length + HOST_SIM_ENET_CRC_SIZE;
+    uint32_t addr = enet->rx_desc;
+    uint32_t room = 0;
+    uint32_t done = 0;
+    uint32_t chunk;
+    uint32_t from_frame;
+    bool stored = false;
+    enet_rx_desc_t *desc;
+
+    hpm_host_sim_block_open(enet->block);
+    if ((*host_sim_enet_reg(enet, offsetof(ENET_Type, DMA_OP_MODE)) & ENET_DMA_OP_MODE_SR_MASK) == 0U) {
+        enet->rx_dropped++;
+        hpm_host_sim_block_close(enet->block);
+        return false;
+    }
+
+    /* the frame needs enough owned descriptors, otherwise reception suspends */
+    if (!enet->rx_suspended) {
+        for (uint32_t i = 0; (room < total) && (addr != 0U); i++) {
+            desc = (enet_rx_desc_t *)(uintptr_t)addr;
+            if ((desc->rdes0_bm.own == 0U) || ((i != 0U) && (addr == enet->rx_desc))) {
+                break;
+            }
+            room += desc->rdes1_bm.rbs1;
+            addr = host_sim_enet_rx_next(enet, desc);
+        }
+    }
+
+    if (enet->rx_suspended || (room < total)) {
+        enet->rx_suspended = true;
+        enet->rx_dropped++;
+        host_sim_enet_set_status(enet, ENET_DMA_STATUS_RU_MASK);
+    } else {
+        while (done < total) {
+            desc = (enet_rx_desc_t *)(uintptr_t)enet->rx_desc;
+            chunk = MIN(total - done, (uint32_t)desc->rdes1_bm.rbs1);
+            from_frame = (done < length) ? MIN(chunk, length - done) : 0U;
+            memcpy((void *)(uintptr_t)desc->rdes2_bm.buffer1, &frame[done], from_frame);
+            memset((uint8_t *)(uintptr_t)desc->rdes2_bm.buffer1 + from_frame, 0, chunk - from_frame);
+            desc->rdes0 = 0;
+            desc->rdes0_bm.fs = (done == 0U) ? 1U : 0U;
+            done += chunk;
+            if (done == total) {
+                desc->rdes0_bm.ls = 1;
+                desc->rdes0_bm.fl = total;
+            }
+            enet->rx_descriptors++;
+            enet->rx_desc = host_sim_enet_rx_next(enet, desc);
+        }
+        enet->rx_frames++;
+        if (desc->rdes1_bm.dic == 0U) {
+            host_sim_enet_set_status(enet, ENET_DMA_STATUS_RI_MASK);
+        }
+        stored = true;
+    }
+    hpm_host_sim_block_close(enet->block);
+    return stored;
+}
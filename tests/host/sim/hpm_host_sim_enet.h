@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_SIM_ENET_H
+#define HPM_HOST_SIM_ENET_H
+
+#include "hpm_host_sim.h"
+#include "hpm_enet_drv.h"
+
+/**
+ * @brief ENET (GMAC) DMA model, hpm_enet_regs.h layout
+ *
+ * The software reset of DMA_BUS_MODE, the TX FIFO flush of DMA_OP_MODE and
+ * the busy bit of GMII_ADDR complete at once. DMA_TX_DESC_LIST_ADDR and
+ * DMA_RX_DESC_LIST_ADDR set the current descriptors, both follow tch/rch
+ * chaining or ter/rer ring wrap.
+ *
+ * A DMA_TX_POLL_DEMAND write with ST set sends the descriptors owned by the
+ * DMA: the buffers from fs to ls make one frame for the wire callback, own is
+ * cleared, TI is set for ic and TU when the DMA meets a descriptor it does not
+ * own.
+ *
+ * hpm_host_sim_enet_receive() is a frame from the wire. With SR set it fills
+ * owned RX descriptors, rbs1 bytes each, the frame and four zero CRC bytes,
+ * and reports fs, ls and fl (length with CRC) as the GMAC does, then sets RI.
+ * Without enough owned descriptors the frame is dropped, RU is set and reception
+ * stays suspended until a DMA_RX_POLL_DEMAND write. DMA_STATUS is write 1 to
+ * clear. Descriptors and buffers are plain memory at their 32-bit addresses.
+ */
+
+/* one frame on the wire, without CRC */
+typedef void (*hpm_host_sim_enet_wire_t)(void *context, const uint8_t *frame, uint32_t length);
+
+typedef struct {
+    hpm_host_sim_block_t *block;
+    hpm_host_sim_enet_wire_t wire;
+    void *wire_context;
+    uint32_t tx_list;               /**< DMA_TX_DESC_LIST_ADDR */
+    uint32_t rx_list;
+    uint32_t tx_desc;               /**< current descriptors */
+    uint32_t rx_desc;
+    bool rx_suspended;
+    uint32_t tx_length;             /**< frame being gathered */
+    uint8_t tx_frame[ENET_MAX_FRAME_SIZE];
+    uint32_t tx_frames;
+    uint32_t tx_descriptors;
+    uint32_t rx_frames;
+    uint32_t rx_descriptors;
+    uint32_t rx_dropped;
+} hpm_host_sim_enet_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map the register block of an ENET model
+ *
+ * @return false if no block could be mapped
+ */
+bool hpm_host_sim_enet_init(hpm_host_sim_enet_t *enet, hpm_host_sim_enet_wire_t wire, void *wire_context);
+
+/**
+ * @brief Unmap the register block
+ */
+void hpm_host_sim_enet_deinit(hpm_host_sim_enet_t *enet);
+
+/**
+ * @brief ENET_Type pointer to pass to the driver
+ */
+static inline ENET_Type *hpm_host_sim_enet_base(hpm_host_sim_enet_t *enet)
+{
+    return (ENET_Type *)enet->block->base;
+}
+
+/**
+ * @brief A frame from the wire, without CRC
+ *
+ * @return false if the frame was dropped
+ */
+bool hpm_host_sim_enet_receive(hpm_host_sim_enet_t *enet, const uint8_t *frame, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_HOST_SIM_ENET_H */
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_host_sim_mcan.h"
+
+/* RX FIFO 1 registers and IR flags sit at fixed distances from the FIFO 0 ones */
+#define HOST_SIM_MCAN_RXF_STRIDE    (offsetof(MCAN_Type, RXF1C) - offsetof(MCAN_Type, RXF0C))
+#define HOST_SIM_MCAN_IR_RF_SHIFT   (4U)
+/* TXFQS and RXFnS are read only for the driver, hpm_mcan_regs.h has no setters */
+#define HOST_SIM_MCAN_SET(reg, field, x) (((uint32_t)(x) << MCAN_##reg##_##field##_SHIFT) & MCAN_##reg##_##field##_MASK)
+
+static uint32_t *host_sim_mcan_reg(hpm_host_sim_mcan_t *mcan, uint32_t offset)
+{
+    return hpm_host_sim_reg(mcan->block, offset);
+}
+
+static uint32_t host_sim_mcan_elem_size(uint32_t data_size_option)
+{
+    return mcan_get_data_field_size((uint8_t)data_size_option) + MCAN_MESSAGE_HEADER_SIZE_IN_BYTES;
+}
+
+static uint32_t *host_sim_mcan_tx_elem(hpm_host_sim_mcan_t *mcan, uint32_t index)
+{
+    uint32_t txbc = *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBC));
+    uint32_t elem_size = host_sim_mcan_elem_size(MCAN_TXESC_TBDS_GET(*host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXESC))));
+
+    return host_sim_mcan_reg(mcan, offsetof(MCAN_Type, MESSAGE_BUFF)
+                             + (MCAN_TXBC_TBSA_GET(txbc) << MCAN_TXBC_TBSA_SHIFT) + elem_size * index);
+}
+
+/* TX FIFO state in TXFQS: free level, get and put index over the elements behind the dedicated buffers */
+static void host_sim_mcan_set_txfqs(hpm_host_sim_mcan_t *mcan, uint32_t free_level, uint32_t get, uint32_t put)
+{
+    *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXFQS)) = HOST_SIM_MCAN_SET(TXFQS, TFFL, free_level)
+                                                         | HOST_SIM_MCAN_SET(TXFQS, TFGI, get)
+                                                         | HOST_SIM_MCAN_SET(TXFQS, TFQPI, put)
+                                                         | ((free_level == 0U) ? MCAN_TXFQS_TFQF_MASK : 0U);
+}
+
+static uint32_t host_sim_mcan_tx_next(hpm_host_sim_mcan_t *mcan, uint32_t index)
+{
+    uint32_t txbc = *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBC));
+    uint32_t first = MCAN_TXBC_NDTB_GET(txbc);
+
+    return (index + 1U < first + MCAN_TXBC_TFQS_GET(txbc)) ? (index + 1U) : first;
+}
+
+static void host_sim_mcan_transmit(hpm_host_sim_mcan_t *mcan, uint32_t index)
+{
+    mcan_tx_frame_t frame;
+    uint32_t *elem = host_sim_mcan_tx_elem(mcan, index);
+    uint32_t *frame_u32 = (uint32_t *)&frame;
+
+    memset(&frame, 0, sizeof(frame));
+    frame_u32[0] = elem[0];
+    frame_u32[1] = elem[1];
+    memcpy(frame.data_32, &elem[2], mcan_get_message_size_from_dlc(frame.dlc));
+    if (mcan->tx != NULL) {
+        mcan->tx(mcan->tx_context, &frame);
+    }
+    *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBRP)) &= ~(1UL << index);
+    *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBTO)) |= 1UL << index;
+    *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, IR)) |= MCAN_IR_TC_MASK;
+    mcan->transmitted++;
+}
+
+/* send the pending dedicated buffers, then the FIFO elements from the get index */
+static uint32_t host_sim_mcan_send_pending(hpm_host_sim_mcan_t *mcan)
+{
+    uint32_t txbc = *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBC));
+    uint32_t txfqs = *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXFQS));
+    uint32_t free_level = MCAN_TXFQS_TFFL_GET(txfqs);
+    uint32_t get = MCAN_TXFQS_TFGI_GET(txfqs);
+    uint32_t sent = 0;
+
+    for (uint32_t i = 0; i < MCAN_TXBC_NDTB_GET(txbc); i++) {
+        if ((*host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBRP)) & (1UL << i)) != 0U) {
+            host_sim_mcan_transmit(mcan, i);
+            sent++;
+        }
+    }
+    while (free_level < MCAN_TXBC_TFQS_GET(txbc)) {
+        host_sim_mcan_transmit(mcan, get);
+        get = host_sim_mcan_tx_next(mcan, get);
+        free_level++;
+        sent++;
+    }
+    host_sim_mcan_set_txfqs(mcan, free_level, get, MCAN_TXFQS_TFQPI_GET(txfqs));
+    return sent;
+}
+
+static void host_sim_mcan_add_request(hpm_host_sim_mcan_t *mcan, uint32_t requests)
+{
+    uint32_t txbc = *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBC));
+    uint32_t txfqs = *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXFQS));
+    uint32_t free_level = MCAN_TXFQS_TFFL_GET(txfqs);
+    uint32_t put = MCAN_TXFQS_TFQPI_GET(txfqs);
+
+    for (uint32_t i = 0; i < 32U; i++) {
+        if ((requests & (1UL << i)) == 0U) {
+            continue;
+        }
+        *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBRP)) |= 1UL << i;
+        *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, TXBTO)) &= ~(1UL << i);
+        if ((i >= MCAN_TXBC_NDTB_GET(txbc)) && (i == put) && (free_level != 0U)) {
+            put = host_sim_mcan_tx_next(mcan, put);
+            free_level--;
+        }
+    }
+    host_sim_mcan_set_txfqs(mcan, free_level, MCAN_TXFQS_TFGI_GET(txfqs), put);
+    if (!mcan->tx_hold) {
+        host_sim_mcan_send_pending(mcan);
+    }
+}
+
+static void host_sim_mcan_ack(hpm_host_sim_mcan_t *mcan, uint32_t fifo, uint32_t ack_index)
+{
+    uint32_t stride = fifo * HOST_SIM_MCAN_RXF_STRIDE;
+    uint32_t size = MCAN_RXF0C_F0S_GET(*host_sim_mcan_reg(mcan, offsetof(MCAN_Type, RXF0C) + stride));
+    uint32_t *rxfs = host_sim_mcan_reg(mcan, offsetof(MCAN_Type, RXF0S) + stride);
+    uint32_t fill = MCAN_RXF0S_F0FL_GET(*rxfs);
+    uint32_t get = MCAN_RXF0S_F0GI_GET(*rxfs);
+    uint32_t released;
+
+    if ((fill == 0U) || (size == 0U)) {
+        return;
+    }
+    released = ((ack_index + size - get) % size) + 1U;
+    if (released > fill) {
+        return;
+    }
+    fill -= released;
+    get = (ack_index + 1U) % size;
+    *rxfs = (*rxfs & ~(MCAN_RXF0S_F0FL_MASK | MCAN_RXF0S_F0GI_MASK | MCAN_RXF0S_F0F_MASK))
+          | HOST_SIM_MCAN_SET(RXF0S, F0FL, fill) | HOST_SIM_MCAN_SET(RXF0S, F0GI, get);
+}
+
+static void host_sim_mcan_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                               hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    hpm_host_sim_mcan_t *mcan = (hpm_host_sim_mcan_t *)block->context;
+
+    if (access == hpm_host_sim_read) {
+        return;
+    }
+
+    if (offset == offsetof(MCAN_Type, IR)) {
+        *value = old & ~*value;
+    } else if (offset == offsetof(MCAN_Type, CCCR)) {
+        /* clock stop is never requested, INIT takes effect at once */
+        *value &= ~(MCAN_CCCR_CSR_MASK | MCAN_CCCR_CSA_MASK);
+    } else if (offset == offsetof(MCAN_Type, TXBC)) {
+        host_sim_mcan_set_txfqs(mcan, MCAN_TXBC_TFQS_GET(*value), MCAN_TXBC_NDTB_GET(*value), MCAN_TXBC_NDTB_GET(*value));
+    } else if (offset == offsetof(MCAN_Type, TXBAR)) {
+        uint32_t requests = *value;
+
+        *value = 0;
+        host_sim_mcan_add_request(mcan, requests);
+    } else if (offset == offsetof(MCAN_Type, RXF0A)) {
+        host_sim_mcan_ack(mcan, 0, MCAN_RXF0A_F0AI_GET(*value));
+    } else if (offset == offsetof(MCAN_Type, RXF1A)) {
+        host_sim_mcan_ack(mcan, 1, MCAN_RXF1A_F1AI_GET(*value));
+    }
+}
+
+bool hpm_host_sim_mcan_init(hpm_host_sim_mcan_t *mcan, hpm_host_sim_mcan_tx_t tx, void *tx_context)
+{
+    memset(mcan, 0, sizeof(*mcan));
+    mcan->tx = tx;
+    mcan->tx_context = tx_context;
+    mcan->block = hpm_host_sim_block_create(sizeof(MCAN_Type), host_sim_mcan_hook, mcan);
+    if (mcan->block == NULL) {
+        return false;
+    }
+    hpm_host_sim_poke(mcan->block, offsetof(MCAN_Type, ENDN), 0x87654321UL);
+    return true;
+}
+
+void hpm_host_sim_mcan_deinit(hpm_host_sim_mcan_t *mcan)
+{
+    hpm_host_sim_block_destroy(mcan->block);
+    mcan->block = NULL;
+}
+
+bool hpm_host_sim_mcan_receive(hpm_host_sim_mcan_t *mcan, uint32_t fifo, const mcan_rx_message_t *frame)
+{
+    uint32_t stride = fifo * HOST_SIM_MCAN_RXF_STRIDE;
+    uint32_t rxfc;
+    uint32_t *rxfs;
+    uint32_t *ir;
+    uint32_t size;
+    uint32_t fill;
+    uint32_t put;
+    uint32_t elem_size;
+    uint32_t *elem;
+    const uint32_t *frame_u32 = (const uint32_t *)frame;
+    bool stored = false;
+
+    hpm_host_sim_block_open(mcan->block);
+    rxfc = *host_sim_mcan_reg(mcan, offsetof(MCAN_Type, RXF0C) + stride);
+    rxfs = host_sim_mcan_reg(mcan, offsetof(MCAN_Type, RXF0S) + stride);
+    ir = host_sim_mcan_reg(mcan, offsetof(MCAN_Type, IR));
+    size = MCAN_RXF0C_F0S_GET(rxfc);
+    fill = MCAN_RXF0S_F0FL_GET(*rxfs);
+    put = MCAN_RXF0S_F0PI_GET(*rxfs);
+
+    if (fill < size) {
+        elem_size = host_sim_mcan_elem_size((fifo == 0U) ? MCAN_RXESC_F0DS_GET(*host_sim_mcan_reg(mcan, offsetof(MCAN_Type, RXESC)))
+                                                         : MCAN_RXESC_F1DS_GET(*host_sim_mcan_reg(mcan, offsetof(MCAN_Type, RXESC))));
+        elem = host_sim_mcan_reg(mcan, offsetof(MCAN_Type, MESSAGE_BUFF) + (MCAN_RXF0C_F0SA_GET(rxfc) << 2) + elem_size * put);
+        elem[0] = frame_u32[0];
+        elem[1] = frame_u32[1];
+        memcpy(&elem[2], frame->data_8, MIN(mcan_get_message_size_from_dlc(frame->dlc), elem_size - MCAN_MESSAGE_HEADER_SIZE_IN_BYTES));
+        fill++;
+        put = (put + 1U) % size;
+        *rxfs = (*rxfs & ~(MCAN_RXF0S_F0FL_MASK | MCAN_RXF0S_F0PI_MASK | MCAN_RXF0S_F0F_MASK))
+              | HOST_SIM_MCAN_SET(RXF0S, F0FL, fill) | HOST_SIM_MCAN_SET(RXF0S, F0PI, put) | ((fill == size) ? MCAN_RXF0S_F0F_MASK : 0U);
+        *ir |= MCAN_IR_RF0N_MASK << (fifo * HOST_SIM_MCAN_IR_RF_SHIFT);
+        if ((MCAN_RXF0C_F0WM_GET(rxfc) != 0U) && (fill == MCAN_RXF0C_F0WM_GET(rxfc))) {
+            *ir |= MCAN_IR_RF0W_MASK << (fifo * HOST_SIM_MCAN_IR_RF_SHIFT);
+        }
+        if (fill == size) {
+            *ir |= MCAN_IR_RF0F_MASK << (fifo * HOST_SIM_MCAN_IR_RF_SHIFT);
+        }
+        mcan->received[fifo]++;
+        stored = true;
+    } else {
+        *rxfs |= MCAN_RXF0S_RF0L_MASK;
+        *ir |= MCAN_IR_RF0L_MASK << (fifo * HOST_SIM_MCAN_IR_RF_SHIFT);
+        mcan->lost[fifo]++;
+    }
+    hpm_host_sim_block_close(mcan->block);
+    return stored;
+}
+
+uint32_t hpm_host_sim_mcan_release_tx(hpm_host_sim_mcan_t *mcan)
+{
+    uint32_t sent;
+
+    hpm_host_sim_block_open(mcan->block);
+    sent = host_sim_mcan_send_pending(mcan);
+    hpm_host_sim_block_close(mcan->block);
+    return sent;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_SIM_MCAN_H
+#define HPM_HOST_SIM_MCAN_H
+
+#include "hpm_host_sim.h"
+#include "hpm_mcan_drv.h"
+
+/**
+ * @brief MCAN model, hpm_mcan_regs.h layout with the message RAM in MESSAGE_BUFF
+ *
+ * hpm_host_sim_mcan_receive() stores a frame in RX FIFO 0 or 1 at the put
+ * index, as configured by RXFnC and RXESC, updates RXFnS and sets the new
+ * message, watermark, full and lost flags in IR. An RXFnA write releases the
+ * elements up to the acknowledged index.
+ *
+ * A TXBAR write sends the requested TX buffers, the frame read from the
+ * message RAM goes to the tx callback and TXBTO and IR.TC are set. With
+ * tx_hold set the requests stay pending in TXBRP and take TX FIFO space until
+ * hpm_host_sim_mcan_release_tx(). TXFQS follows the put and get indexes of the
+ * TX FIFO elements behind the dedicated buffers. IR is write 1 to clear, the
+ * clock and INIT handshakes of CCCR complete at once.
+ */
+
+typedef void (*hpm_host_sim_mcan_tx_t)(void *context, const mcan_tx_frame_t *frame);
+
+typedef struct {
+    hpm_host_sim_block_t *block;
+    hpm_host_sim_mcan_tx_t tx;
+    void *tx_context;
+    bool tx_hold;                   /**< keep TX requests pending */
+    uint32_t received[2];           /**< frames stored per RX FIFO */
+    uint32_t lost[2];               /**< frames lost to a full RX FIFO */
+    uint32_t transmitted;
+} hpm_host_sim_mcan_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map the register block of an MCAN model
+ *
+ * @return false if no block could be mapped
+ */
+bool hpm_host_sim_mcan_init(hpm_host_sim_mcan_t *mcan, hpm_host_sim_mcan_tx_t tx, void *tx_context);
+
+/**
+ * @brief Unmap the register block
+ */
+void hpm_host_sim_mcan_deinit(hpm_host_sim_mcan_t *mcan);
+
+/**
+ * @brief MCAN_Type pointer to pass to the driver
+ */
+static inline MCAN_Type *hpm_host_sim_mcan_base(hpm_host_sim_mcan_t *mcan)
+{
+    return (MCAN_Type *)mcan->block->base;
+}
+
+/**
+ * @brief A frame from the bus into an RX FIFO
+ *
+ * @return false if the FIFO was full and the frame is lost
+ */
+bool hpm_host_sim_mcan_receive(hpm_host_sim_mcan_t *mcan, uint32_t fifo, const mcan_rx_message_t *frame);
+
+/**
+ * @brief Send the TX requests kept pending by tx_hold
+ *
+ * @return frames sent
+ */
+uint32_t hpm_host_sim_mcan_release_tx(hpm_host_sim_mcan_t *mcan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_HOST_SIM_MCAN_H */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_host_sim_sdm.h"
+
+#define HOST_SIM_SDM_CH_STRIDE  (offsetof(SDM_Type, CH[1]) - offsetof(SDM_Type, CH[0]))
+#define HOST_SIM_SDM_CH_REG(ch, reg) (offsetof(SDM_Type, CH[0].reg) + (ch) * HOST_SIM_SDM_CH_STRIDE)
+#define HOST_SIM_SDM_SDST_ERRORS (SDM_CH_SDST_DOV_ERR_MASK | SDM_CH_SDST_DSAT_ERR_MASK)
+#define HOST_SIM_SDM_SCST_FLAGS  (SDM_CH_SCST_HZ_MASK | SDM_CH_SCST_MF_MASK | SDM_CH_SCST_CMPH_MASK | SDM_CH_SCST_CMPL_MASK)
+/* FILL is read only for the driver, hpm_sdm_regs.h has no setter */
+#define HOST_SIM_SDM_SDST_FILL(x) (((uint32_t)(x) << SDM_CH_SDST_FILL_SHIFT) & SDM_CH_SDST_FILL_MASK)
+
+/* FILL and FIFO_DR of SDST and the bits of the channel in STATUS after the FIFO or the errors changed */
+static void host_sim_sdm_update(hpm_host_sim_sdm_t *sdm, uint8_t ch, uint32_t sdst)
+{
+    uint32_t *status = hpm_host_sim_reg(sdm->block, offsetof(SDM_Type, STATUS));
+    uint32_t threshold = SDM_CH_SDFIFOCTRL_THRSH_GET(*hpm_host_sim_reg(sdm->block, HOST_SIM_SDM_CH_REG(ch, SDFIFOCTRL)));
+    uint32_t level = sdm->level[ch];
+
+    sdst = (sdst & ~(SDM_CH_SDST_FILL_MASK | SDM_CH_SDST_FIFO_DR_MASK)) | HOST_SIM_SDM_SDST_FILL(level)
+         | (((threshold != 0U) && (level >= threshold)) ? SDM_CH_SDST_FIFO_DR_MASK : 0U);
+    *hpm_host_sim_reg(sdm->block, HOST_SIM_SDM_CH_REG(ch, SDST)) = sdst;
+    *status = (*status & ~(CHN_DRY_MASK(ch) | CHN_ERR_MASK(ch)))
+            | ((level != 0U) ? CHN_DRY_MASK(ch) : 0U)
+            | (((sdst & HOST_SIM_SDM_SDST_ERRORS) != 0U) ? CHN_ERR_MASK(ch) : 0U);
+}
+
+static void host_sim_sdm_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                              hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    hpm_host_sim_sdm_t *sdm = (hpm_host_sim_sdm_t *)block->context;
+    uint32_t reg;
+    uint8_t ch;
+
+    if (offset < offsetof(SDM_Type, CH[0])) {
+        return;
+    }
+    ch = (uint8_t)((offset - offsetof(SDM_Type, CH[0])) / HOST_SIM_SDM_CH_STRIDE);
+    /* the offset of the register in CH[0] */
+    reg = (uint32_t)offsetof(SDM_Type, CH[0]) + (offset - (uint32_t)offsetof(SDM_Type, CH[0])) % HOST_SIM_SDM_CH_STRIDE;
+
+    if (access == hpm_host_sim_read) {
+        if ((reg == offsetof(SDM_Type, CH[0].SDFIFO)) && (sdm->level[ch] != 0U)) {
+            *value = (uint32_t)sdm->fifo[ch][0];
+            memmove(sdm->fifo[ch], &sdm->fifo[ch][1], --sdm->level[ch] * sizeof(int32_t));
+            host_sim_sdm_update(sdm, ch, *hpm_host_sim_reg(block, HOST_SIM_SDM_CH_REG(ch, SDST)));
+        }
+        return;
+    }
+    switch (reg) {
+    case offsetof(SDM_Type, CH[0].SDST):
+        *value = old & ~(*value & HOST_SIM_SDM_SDST_ERRORS);
+        host_sim_sdm_update(sdm, ch, *value);
+        break;
+    case offsetof(SDM_Type, CH[0].SCST):
+        *value = old & ~(*value & HOST_SIM_SDM_SCST_FLAGS);
+        break;
+    case offsetof(SDM_Type, CH[0].SDFIFOCTRL):
+        host_sim_sdm_update(sdm, ch, *hpm_host_sim_reg(block, HOST_SIM_SDM_CH_REG(ch, SDST)));
+        break;
+    default:
+        break;
+    }
+}
+
+bool hpm_host_sim_sdm_init(hpm_host_sim_sdm_t *sdm)
+{
+    memset(sdm, 0, sizeof(*sdm));
+    sdm->block = hpm_host_sim_block_create(sizeof(SDM_Type), host_sim_sdm_hook, sdm);
+    return sdm->block != NULL;
+}
+
+void hpm_host_sim_sdm_deinit(hpm_host_sim_sdm_t *sdm)
+{
+    hpm_host_sim_block_destroy(sdm->block);
+    sdm->block = NULL;
+}
+
+bool hpm_host_sim_sdm_sample(hpm_host_sim_sdm_t *sdm, uint8_t ch, int32_t value)
+{
+    uint32_t sdst;
+    bool stored = false;
+
+    hpm_host_sim_block_open(sdm->block);
+    sdst = *hpm_host_sim_reg(sdm->block, HOST_SIM_SDM_CH_REG(ch, SDST));
+    if (sdm->level[ch] < HPM_HOST_SIM_SDM_FIFO_DEPTH) {
+        sdm->fifo[ch][sdm->level[ch]++] = value;
+        sdm->samples[ch]++;
+        stored = true;
+    } else {
+        sdst |= SDM_CH_SDST_DOV_ERR_MASK;
+        sdm->lost[ch]++;
+    }
+    host_sim_sdm_update(sdm, ch, sdst);
+    hpm_host_sim_block_close(sdm->block);
+    return stored;
+}
+
+void hpm_host_sim_sdm_event(hpm_host_sim_sdm_t *sdm, uint8_t ch, uint32_t flags)
+{
+    hpm_host_sim_block_open(sdm->block);
+    *hpm_host_sim_reg(sdm->block, HOST_SIM_SDM_CH_REG(ch, SCST)) |= flags & HOST_SIM_SDM_SCST_FLAGS;
+    hpm_host_sim_block_close(sdm->block);
+}
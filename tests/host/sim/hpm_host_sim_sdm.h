@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_SIM_SDM_H
+#define HPM_HOST_SIM_SDM_H
+
+#include "hpm_host_sim.h"
+#include "hpm_sdm_drv.h"
+
+/**
+ * @brief SDM model, hpm_sdm_regs.h layout, filter output FIFOs only
+ *
+ * hpm_host_sim_sdm_sample() puts a filter output word in the FIFO of a
+ * channel, SDFIFO reads pop it. A word arriving at a full FIFO is lost and
+ * sets SDST DOV_ERR. SDST reports FILL, FIFO_DR at the SDFIFOCTRL threshold
+ * and the error bits, which are write 1 to clear, STATUS the data ready and
+ * error bits of every channel. hpm_host_sim_sdm_event() raises comparator
+ * flags in SCST, write 1 to clear as well. The modulator clock, the filters
+ * and the amplitude path are not modelled, other registers are plain storage.
+ */
+
+#define HPM_HOST_SIM_SDM_CHANNELS   (4U)
+#define HPM_HOST_SIM_SDM_FIFO_DEPTH (16U)
+
+typedef struct {
+    hpm_host_sim_block_t *block;
+    int32_t fifo[HPM_HOST_SIM_SDM_CHANNELS][HPM_HOST_SIM_SDM_FIFO_DEPTH];
+    uint32_t level[HPM_HOST_SIM_SDM_CHANNELS];
+    uint32_t samples[HPM_HOST_SIM_SDM_CHANNELS];    /**< words stored in the FIFO */
+    uint32_t lost[HPM_HOST_SIM_SDM_CHANNELS];       /**< words lost to a full FIFO */
+} hpm_host_sim_sdm_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map the register block of an SDM model
+ *
+ * @return false if no block could be mapped
+ */
+bool hpm_host_sim_sdm_init(hpm_host_sim_sdm_t *sdm);
+
+/**
+ * @brief Unmap the register block
+ */
+void hpm_host_sim_sdm_deinit(hpm_host_sim_sdm_t *sdm);
+
+/**
+ * @brief SDM_Type pointer to pass to the driver
+ */
+static inline SDM_Type *hpm_host_sim_sdm_base(hpm_host_sim_sdm_t *sdm)
+{
+    return (SDM_Type *)sdm->block->base;
+}
+
+/**
+ * @brief A filter output word into the FIFO of a channel
+ *
+ * @return false if the FIFO was full and the word is lost
+ */
+bool hpm_host_sim_sdm_sample(hpm_host_sim_sdm_t *sdm, uint8_t ch, int32_t value);
+
+/**
+ * @brief Raise comparator flags of a channel
+ *
+ * @param [in] flags SCST HZ, MF, CMPH and CMPL bits
+ */
+void hpm_host_sim_sdm_event(hpm_host_sim_sdm_t *sdm, uint8_t ch, uint32_t flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_HOST_SIM_SDM_H */
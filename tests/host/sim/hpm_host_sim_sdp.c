@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_host_sim_sdp.h"
+/* the driver header has its own AES_BLOCK_SIZE */
+#undef AES_BLOCK_SIZE
+#include <openssl/aes.h>
+#include <openssl/sha.h>
+
+#define SDP_REG(sdp, reg) (*hpm_host_sim_reg((sdp)->block, offsetof(SDP_Type, reg)))
+
+/* no allocation, the hooks run in a signal handler */
+typedef struct {
+    union {
+        SHA_CTX sha1;
+        SHA256_CTX sha256;
+    } hash;
+    AES_KEY aes_key;
+} host_sim_sdp_engine_t;
+
+_Static_assert(sizeof(host_sim_sdp_engine_t) <= sizeof(((hpm_host_sim_sdp_t *)0)->engine), "SDP engine state too large");
+
+static uint32_t host_sim_sdp_cipher(hpm_host_sim_sdp_t *sdp, uint32_t ctrl, const uint8_t *src, uint8_t *dst,
+                                    uint32_t length)
+{
+    uint32_t modctrl = SDP_REG(sdp, MODCTRL);
+    uint32_t slot = SDP_MODCTRL_AESKS_GET(modctrl);
+    bool cbc = SDP_MODCTRL_AESMOD_GET(modctrl) == 1U;
+    bool decrypt = SDP_MODCTRL_AESDIR_GET(modctrl) != 0U;
+    AES_KEY *aes_key = &((host_sim_sdp_engine_t *)sdp->engine)->aes_key;
+    uint32_t key_slots;
+    uint8_t in[16];
+    uint8_t out[16];
+
+    switch (SDP_MODCTRL_AESALG_GET(modctrl)) {
+    case 0:
+        key_slots = 1U;
+        break;
+    case 1:
+        key_slots = 2U;
+        break;
+    default:
+        return SDP_STA_ERRSET_MASK;
+    }
+    if ((slot + key_slots > HPM_HOST_SIM_SDP_KEY_SLOTS) || (SDP_MODCTRL_AESMOD_GET(modctrl) > 1U)
+     || ((length % 16U) != 0U)) {
+        return SDP_STA_ERRSET_MASK;
+    }
+    if ((length != 0U) && ((src == NULL) || (dst == NULL))) {
+        return (src == NULL) ? SDP_STA_ERRSRC_MASK : SDP_STA_ERRDST_MASK;
+    }
+
+    /* the key RAM words hold the key bytes in memory order, AES-256 spans two slots */
+    if (decrypt) {
+        AES_set_decrypt_key((const uint8_t *)sdp->key_ram[slot], (int)(key_slots * 128U), aes_key);
+    } else {
+        AES_set_encrypt_key((const uint8_t *)sdp->key_ram[slot], (int)(key_slots * 128U), aes_key);
+    }
+    if ((ctrl & SDP_PKT_CTRL_CIPHIV_MASK) != 0U) {
+        memcpy(sdp->chain_iv, &SDP_REG(sdp, CIPHIV[0]), sizeof(sdp->chain_iv));
+    }
+
+    /* block by block through copies, source and destination may overlap */
+    for (uint32_t pos = 0; pos < length; pos += 16U) {
+        memcpy(in, &src[pos], 16);
+        if (!decrypt) {
+            if (cbc) {
+                for (uint32_t i = 0; i < 16U; i++) {
+                    in[i] ^= sdp->chain_iv[i];
+                }
+            }
+            AES_encrypt(in, out, aes_key);
+            if (cbc) {
+                memcpy(sdp->chain_iv, out, 16);
+            }
+        } else {
+            AES_decrypt(in, out, aes_key);
+            if (cbc) {
+                for (uint32_t i = 0; i < 16U; i++) {
+                    out[i] ^= sdp->chain_iv[i];
+                }
+                memcpy(sdp->chain_iv, in, 16);
+            }
+        }
+        memcpy(&dst[pos], out, 16);
+    }
+    sdp->cipher_packets++;
+    sdp->cipher_bytes += length;
+    return 0;
+}
+
+static uint32_t host_sim_sdp_hash(hpm_host_sim_sdp_t *sdp, uint32_t ctrl, const uint8_t *src, uint32_t length)
+{
+    host_sim_sdp_engine_t *engine = (host_sim_sdp_engine_t *)sdp->engine;
+    uint32_t alg = SDP_MODCTRL_HASALG_GET(SDP_REG(sdp, MODCTRL));
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+
+    if ((alg != sdp_hash_alg_sha1) && (alg != sdp_hash_alg_sha256)) {
+        return SDP_STA_ERRSET_MASK;
+    }
+    if ((length != 0U) && (src == NULL)) {
+        return SDP_STA_ERRSRC_MASK;
+    }
+    if ((ctrl & SDP_PKT_CTRL_HASHINIT_MASK) != 0U) {
+        sdp->hash_alg = alg;
+        if (alg == sdp_hash_alg_sha1) {
+            SHA1_Init(&engine->hash.sha1);
+        } else {
+            SHA256_Init(&engine->hash.sha256);
+        }
+    } else if (alg != sdp->hash_alg) {
+        return SDP_STA_ERRHAS_MASK;
+    }
+
+    if (alg == sdp_hash_alg_sha1) {
+        SHA1_Update(&engine->hash.sha1, src, length);
+    } else {
+        SHA256_Update(&engine->hash.sha256, src, length);
+    }
+    if ((ctrl & SDP_PKT_CTRL_HASHFINISH_MASK) != 0U) {
+        /* HASWRD holds the digest bytes in memory order */
+        if (alg == sdp_hash_alg_sha1) {
+            SHA1_Final(digest, &engine->hash.sha1);
+            memcpy(&SDP_REG(sdp, HASWRD[0]), digest, SHA_DIGEST_LENGTH);
+        } else {
+            SHA256_Final(digest, &engine->hash.sha256);
+            memcpy(&SDP_REG(sdp, HASWRD[0]), digest, SHA256_DIGEST_LENGTH);
+        }
+    }
+    sdp->hash_packets++;
+    sdp->hash_bytes += length;
+    return 0;
+}
+
+static void host_sim_sdp_run(hpm_host_sim_sdp_t *sdp)
+{
+    uint32_t sdpcr = SDP_REG(sdp, SDPCR);
+    const sdp_pkt_struct_t *pkt;
+    uint32_t ctrl;
+    uint32_t src;
+    uint32_t dst;
+    uint32_t length;
+    uint32_t error = 0;
+
+    if ((sdpcr & SDP_SDPCR_RDSCEN_MASK) != 0U) {
+        ctrl = SDP_REG(sdp, PKTCTL);
+        src = SDP_REG(sdp, PKTSRC);
+        dst = SDP_REG(sdp, PKTDST);
+        length = SDP_REG(sdp, PKTBUF);
+    } else {
+        pkt = (const sdp_pkt_struct_t *)(uintptr_t)SDP_REG(sdp, CMDPTR);
+        if (pkt == NULL) {
+            SDP_REG(sdp, STA) |= SDP_STA_ERRPKT_MASK | SDP_STA_PKTCNT0_MASK;
+            sdp->errors++;
+            return;
+        }
+        ctrl = pkt->pkt_ctrl.PKT_CTRL;
+        src = pkt->src_addr;
+        dst = pkt->dst_addr;
+        length = pkt->buf_size;
+    }
+
+    sdp->packets++;
+    if ((sdpcr & SDP_SDPCR_CIPHEN_MASK) != 0U) {
+        error = host_sim_sdp_cipher(sdp, ctrl, (const uint8_t *)(uintptr_t)src, (uint8_t *)(uintptr_t)dst, length);
+    } else if ((sdpcr & SDP_SDPCR_HASHEN_MASK) != 0U) {
+        error = host_sim_sdp_hash(sdp, ctrl, (const uint8_t *)(uintptr_t)src, length);
+    } else if ((sdpcr & SDP_SDPCR_MCPEN_MASK) != 0U) {
+        memmove((void *)(uintptr_t)dst, (const void *)(uintptr_t)src, length);
+        sdp->copy_packets++;
+    } else if ((sdpcr & SDP_SDPCR_CONFEN_MASK) != 0U) {
+        for (uint32_t i = 0; i < length; i++) {
+            ((uint8_t *)(uintptr_t)dst)[i] = (uint8_t)(src >> (8U * (i % 4U)));
+        }
+        sdp->copy_packets++;
+    } else {
+        error = SDP_STA_ERRSET_MASK;
+    }
+    if (error != 0U) {
+        sdp->errors++;
+    }
+    SDP_REG(sdp, STA) |= error | SDP_STA_PKTDON_MASK | SDP_STA_PKTCNT0_MASK;
+}
+
+static void host_sim_sdp_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                              hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    hpm_host_sim_sdp_t *sdp = (hpm_host_sim_sdp_t *)block->context;
+
+    if (access == hpm_host_sim_read) {
+        return;
+    }
+    switch (offset) {
+    case offsetof(SDP_Type, KEYADDR):
+        sdp->key_index = SDP_KEYADDR_INDEX_GET(*value);
+        sdp->key_word = SDP_KEYADDR_SUBWRD_GET(*value);
+        break;
+    case offsetof(SDP_Type, KEYDAT):
+        if (sdp->key_index < HPM_HOST_SIM_SDP_KEY_SLOTS) {
+            sdp->key_ram[sdp->key_index][sdp->key_word] = *value;
+        }
+        sdp->key_writes++;
+        if (++sdp->key_word == 4U) {
+            sdp->key_word = 0;
+            sdp->key_index++;
+        }
+        break;
+    case offsetof(SDP_Type, STA):
+        *value = old & ~*value;
+        break;
+    case offsetof(SDP_Type, PKTCNT):
+        if (SDP_PKTCNT_CNTINCR_GET(*value) != 0U) {
+            host_sim_sdp_run(sdp);
+        }
+        *value = 0;
+        break;
+    default:
+        break;
+    }
+}
+
+bool hpm_host_sim_sdp_init(hpm_host_sim_sdp_t *sdp)
+{
+    return hpm_host_sim_sdp_init_at(sdp, 0);
+}
+
+bool hpm_host_sim_sdp_init_at(hpm_host_sim_sdp_t *sdp, uint32_t addr)
+{
+    memset(sdp, 0, sizeof(*sdp));
+    sdp->block = hpm_host_sim_block_create_at(addr, sizeof(SDP_Type), host_sim_sdp_hook, sdp);
+    return sdp->block != NULL;
+}
+
+void hpm_host_sim_sdp_deinit(hpm_host_sim_sdp_t *sdp)
+{
+    hpm_host_sim_block_destroy(sdp->block);
+    sdp->block = NULL;
+}
+
+void hpm_host_sim_sdp_reset_stat(hpm_host_sim_sdp_t *sdp)
+{
+    sdp->packets = 0;
+    sdp->cipher_packets = 0;
+    sdp->cipher_bytes = 0;
+    sdp->hash_packets = 0;
+    sdp->hash_bytes = 0;
+    sdp->copy_packets = 0;
+    sdp->key_writes = 0;
+    sdp->errors = 0;
+    hpm_host_sim_block_reset_stat(sdp->block);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_SIM_SDP_H
+#define HPM_HOST_SIM_SDP_H
+
+#include "hpm_host_sim.h"
+#include "hpm_common.h"
+#include "hpm_sdp_drv.h"
+
+/**
+ * @brief SDP model, hpm_sdp_regs.h layout, AES and SHA of the host libcrypto
+ *
+ * A PKTCNT write runs one packet to completion: from PKTCTL/PKTSRC/PKTDST/
+ * PKTBUF with the register descriptor enabled (SDPCR bit 8), from the
+ * sdp_pkt_struct_t at CMDPTR otherwise. Chained packets are not modelled.
+ * The engine is selected by SDPCR: CIPHEN runs AES ECB or CBC with the key
+ * RAM slot of MODCTRL AESKS (AES-256 uses the slot and the next one) and
+ * the IV of CIPHIV if the packet has CIPHIV set, else the chained IV.
+ * HASHEN runs SHA-1 or SHA-256, HASHINIT restarts the hash, HASHFINISH
+ * leaves the digest in HASWRD. MCPEN copies, CONFEN fills with PKTSRC.
+ * Then STA PKTCNT0 and PKTDON are set, STA is write 1 to clear.
+ *
+ * KEYADDR selects a 128-bit key slot and word, KEYDAT writes the word and
+ * moves to the next one. Unsupported algorithms, key slots outside the key
+ * RAM and cipher lengths that are no multiple of 16 set ERRSET.
+ */
+
+#define HPM_HOST_SIM_SDP_KEY_SLOTS (16U)
+
+typedef struct {
+    hpm_host_sim_block_t *block;
+    uint32_t key_ram[HPM_HOST_SIM_SDP_KEY_SLOTS][4];
+    uint32_t key_index;             /**< KEYADDR INDEX */
+    uint32_t key_word;              /**< KEYADDR SUBWRD */
+    uint8_t chain_iv[16];           /**< CBC IV of the next packet without CIPHIV */
+    uint32_t hash_alg;
+    uint64_t engine[64];            /**< libcrypto AES key and hash state */
+    uint32_t packets;               /**< packets run */
+    uint32_t cipher_packets;
+    uint32_t cipher_bytes;
+    uint32_t hash_packets;
+    uint32_t hash_bytes;
+    uint32_t copy_packets;          /**< memcpy and memset packets */
+    uint32_t key_writes;            /**< KEYDAT writes */
+    uint32_t errors;                /**< packets ended with an error bit */
+} hpm_host_sim_sdp_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map the register block of an SDP model
+ *
+ * @return false if no block could be mapped
+ */
+bool hpm_host_sim_sdp_init(hpm_host_sim_sdp_t *sdp);
+
+/**
+ * @brief Map the register block at its SoC address, for code using HPM_SDP
+ *
+ * @return false if the block could not be mapped there
+ */
+bool hpm_host_sim_sdp_init_at(hpm_host_sim_sdp_t *sdp, uint32_t addr);
+
+/**
+ * @brief Unmap the register block
+ */
+void hpm_host_sim_sdp_deinit(hpm_host_sim_sdp_t *sdp);
+
+/**
+ * @brief SDP_Type pointer to pass to the driver
+ */
+static inline SDP_Type *hpm_host_sim_sdp_base(hpm_host_sim_sdp_t *sdp)
+{
+    return (SDP_Type *)sdp->block->base;
+}
+
+/**
+ * @brief Clear the packet and key counters
+ */
+void hpm_host_sim_sdp_reset_stat(hpm_host_sim_sdp_t *sdp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_HOST_SIM_SDP_H */
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_host_sim_spi.h"
+
+static uint32_t host_sim_spi_reg(hpm_host_sim_spi_t *spi, uint32_t offset)
+{
+    return spi->block->open ? *hpm_host_sim_reg(spi->block, offset) : hpm_host_sim_peek(spi->block, offset);
+}
+
+static void host_sim_spi_set_reg(hpm_host_sim_spi_t *spi, uint32_t offset, uint32_t value)
+{
+    if (spi->block->open) {
+        *hpm_host_sim_reg(spi->block, offset) = value;
+    } else {
+        hpm_host_sim_poke(spi->block, offset, value);
+    }
+}
+
+static void host_sim_spi_start(hpm_host_sim_spi_t *spi)
+{
+    uint32_t transctrl = host_sim_spi_reg(spi, offsetof(SPI_Type, TRANSCTRL));
+    uint32_t write_count;
+    uint32_t read_count;
+
+#if defined(HPM_IP_FEATURE_SPI_NEW_TRANS_COUNT) && (HPM_IP_FEATURE_SPI_NEW_TRANS_COUNT == 1)
+    write_count = host_sim_spi_reg(spi, offsetof(SPI_Type, WR_TRANS_CNT)) + 1U;
+    read_count = host_sim_spi_reg(spi, offsetof(SPI_Type, RD_TRANS_CNT)) + 1U;
+#else
+    write_count = SPI_TRANSCTRL_WRTRANCNT_GET(transctrl) + 1U;
+    read_count = SPI_TRANSCTRL_RDTRANCNT_GET(transctrl) + 1U;
+#endif
+
+    spi->mode = (uint8_t)SPI_TRANSCTRL_TRANSMODE_GET(transctrl);
+    switch (spi->mode) {
+    case spi_trans_write_read_together:
+    case spi_trans_write_only:
+    case spi_trans_dummy_write:
+        spi->write_left = write_count;
+        spi->read_left = (spi->mode == spi_trans_write_read_together) ? write_count : 0U;
+        break;
+    case spi_trans_read_only:
+    case spi_trans_dummy_read:
+        spi->write_left = 0;
+        spi->read_left = read_count;
+        break;
+    case spi_trans_no_data:
+        spi->write_left = 0;
+        spi->read_left = 0;
+        break;
+    default:
+        /* write then read or read then write */
+        spi->write_left = write_count;
+        spi->read_left = read_count;
+        break;
+    }
+    spi->active = true;
+    spi->transfers++;
+}
+
+static void host_sim_spi_end(hpm_host_sim_spi_t *spi)
+{
+    spi->active = false;
+    host_sim_spi_set_reg(spi, offsetof(SPI_Type, INTRST),
+                         host_sim_spi_reg(spi, offsetof(SPI_Type, INTRST)) | SPI_INTRST_ENDINT_MASK);
+    if (spi->start_pending) {
+        spi->start_pending = false;
+        host_sim_spi_start(spi);
+    }
+}
+
+/* one frame, false if the FIFOs hold it up */
+static bool host_sim_spi_frame(hpm_host_sim_spi_t *spi)
+{
+    bool together = (spi->mode == spi_trans_write_read_together);
+    bool read_first = (spi->mode == spi_trans_read_write) || (spi->mode == spi_trans_read_dummy_write);
+    bool write = (spi->write_left != 0U) && (together || !read_first || (spi->read_left == 0U));
+    bool read = (spi->read_left != 0U) && (together || !write);
+    uint32_t mosi = 0;
+    uint32_t miso;
+
+    if ((write && (spi->tx_level == 0U)) || (read && (spi->rx_level == SPI_SOC_FIFO_DEPTH))) {
+        return false;
+    }
+    if (write) {
+        mosi = spi->tx_fifo[0];
+        memmove(&spi->tx_fifo[0], &spi->tx_fifo[1], --spi->tx_level * sizeof(uint32_t));
+        spi->write_left--;
+    }
+    miso = (spi->device != NULL) ? spi->device(spi->device_context, mosi, write, read) : 0U;
+    if (read) {
+        spi->rx_fifo[spi->rx_level++] = miso;
+        spi->read_left--;
+    }
+    spi->frames++;
+    return true;
+}
+
+uint32_t hpm_host_sim_spi_shift(hpm_host_sim_spi_t *spi, uint32_t frames)
+{
+    uint32_t shifted = 0;
+
+    while ((shifted < frames) && spi->active) {
+        if ((spi->write_left == 0U) && (spi->read_left == 0U)) {
+            host_sim_spi_end(spi);
+            continue;
+        }
+        if (!host_sim_spi_frame(spi)) {
+            break;
+        }
+        shifted++;
+        if ((spi->write_left == 0U) && (spi->read_left == 0U)) {
+            host_sim_spi_end(spi);
+        }
+    }
+    return shifted;
+}
+
+static uint32_t host_sim_spi_status(hpm_host_sim_spi_t *spi)
+{
+    return (spi->active ? SPI_STATUS_SPIACTIVE_MASK : 0U)
+         | ((spi->tx_level & 0x3FU) << SPI_STATUS_TXNUM_5_0_SHIFT)
+         | ((spi->tx_level == 0U) ? SPI_STATUS_TXEMPTY_MASK : 0U)
+         | ((spi->tx_level == SPI_SOC_FIFO_DEPTH) ? SPI_STATUS_TXFULL_MASK : 0U)
+         | ((spi->rx_level & 0x3FU) << SPI_STATUS_RXNUM_5_0_SHIFT)
+         | ((spi->rx_level == 0U) ? SPI_STATUS_RXEMPTY_MASK : 0U)
+         | ((spi->rx_level == SPI_SOC_FIFO_DEPTH) ? SPI_STATUS_RXFULL_MASK : 0U);
+}
+
+static void host_sim_spi_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                              hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    hpm_host_sim_spi_t *spi = (hpm_host_sim_spi_t *)block->context;
+
+    if (access == hpm_host_sim_read) {
+        if (offset == offsetof(SPI_Type, STATUS)) {
+            hpm_host_sim_spi_shift(spi, 1);
+            *value = host_sim_spi_status(spi);
+        } else if (offset == offsetof(SPI_Type, DATA)) {
+            if (spi->rx_level != 0U) {
+                *value = spi->rx_fifo[0];
+                memmove(&spi->rx_fifo[0], &spi->rx_fifo[1], --spi->rx_level * sizeof(uint32_t));
+            } else {
+                spi->rx_underflows++;
+            }
+        }
+        return;
+    }
+
+    if (offset == offsetof(SPI_Type, DATA)) {
+        if (spi->tx_level < SPI_SOC_FIFO_DEPTH) {
+            spi->tx_fifo[spi->tx_level++] = *value;
+        } else {
+            spi->tx_overflows++;
+        }
+    } else if (offset == offsetof(SPI_Type, CMD)) {
+        if (spi->active) {
+            spi->cmd_while_active++;
+            spi->start_pending = true;
+        } else {
+            host_sim_spi_start(spi);
+        }
+    } else if (offset == offsetof(SPI_Type, CTRL)) {
+        if ((*value & SPI_CTRL_TXFIFORST_MASK) != 0U) {
+            spi->tx_level = 0;
+        }
+        if ((*value & SPI_CTRL_RXFIFORST_MASK) != 0U) {
+            spi->rx_level = 0;
+        }
+        if ((*value & SPI_CTRL_SPIRST_MASK) != 0U) {
+            spi->active = false;
+            spi->start_pending = false;
+        }
+        *value &= ~(SPI_CTRL_TXFIFORST_MASK | SPI_CTRL_RXFIFORST_MASK | SPI_CTRL_SPIRST_MASK);
+    } else if (offset == offsetof(SPI_Type, INTRST)) {
+        *value = old & ~*value;
+    }
+}
+
+bool hpm_host_sim_spi_init(hpm_host_sim_spi_t *spi, hpm_host_sim_spi_device_t device, void *device_context)
+{
+    memset(spi, 0, sizeof(*spi));
+    spi->device = device;
+    spi->device_context = device_context;
+    spi->block = hpm_host_sim_block_create(sizeof(SPI_Type), host_sim_spi_hook, spi);
+    return spi->block != NULL;
+}
+
+void hpm_host_sim_spi_deinit(hpm_host_sim_spi_t *spi)
+{
+    hpm_host_sim_block_destroy(spi->block);
+    spi->block = NULL;
+}
+
+bool hpm_host_sim_spi_tx_request(void *context)
+{
+    hpm_host_sim_spi_t *spi = (hpm_host_sim_spi_t *)context;
+
+    hpm_host_sim_spi_shift(spi, 1);
+    return ((host_sim_spi_reg(spi, offsetof(SPI_Type, CTRL)) & SPI_CTRL_TXDMAEN_MASK) != 0U)
+        && (spi->tx_level < SPI_SOC_FIFO_DEPTH);
+}
+
+bool hpm_host_sim_spi_rx_request(void *context)
+{
+    hpm_host_sim_spi_t *spi = (hpm_host_sim_spi_t *)context;
+
+    hpm_host_sim_spi_shift(spi, 1);
+    return ((host_sim_spi_reg(spi, offsetof(SPI_Type, CTRL)) & SPI_CTRL_RXDMAEN_MASK) != 0U)
+        && (spi->rx_level != 0U);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_SIM_SPI_H
+#define HPM_HOST_SIM_SPI_H
+
+#include "hpm_host_sim.h"
+#include "hpm_common.h"
+#include "hpm_spi_drv.h"
+
+/**
+ * @brief SPI master model, hpm_spi_regs.h layout
+ *
+ * A CMD write starts a transfer with the mode and counts of TRANSCTRL (or
+ * WR_TRANS_CNT/RD_TRANS_CNT where the IP has them), latched at the start. A
+ * CMD write while a transfer runs starts the next one when it ends and is
+ * counted in cmd_while_active. DATA writes fill the TX FIFO, DATA reads pop
+ * the RX FIFO, both SPI_SOC_FIFO_DEPTH deep.
+ *
+ * The shifter moves one frame for every STATUS read and every DMA request
+ * check, so polling and DMA both take time: a write frame needs TX FIFO
+ * data, a read frame RX FIFO room. Each frame goes to the device callback,
+ * which returns MISO. STATUS reports SPIACTIVE and the FIFO levels, the end
+ * of a transfer sets ENDINT in INTRST (write 1 to clear). The FIFO and SPI
+ * reset bits of CTRL clear themselves, SPIRST ends a running transfer.
+ */
+
+/* one frame on the wire, mosi is valid for write frames, returns MISO for read frames */
+typedef uint32_t (*hpm_host_sim_spi_device_t)(void *context, uint32_t mosi, bool write, bool read);
+
+typedef struct {
+    hpm_host_sim_block_t *block;
+    hpm_host_sim_spi_device_t device;
+    void *device_context;
+    uint32_t tx_fifo[SPI_SOC_FIFO_DEPTH];
+    uint32_t tx_level;
+    uint32_t rx_fifo[SPI_SOC_FIFO_DEPTH];
+    uint32_t rx_level;
+    bool active;
+    bool start_pending;             /**< CMD written while active */
+    uint8_t mode;                   /**< latched TRANSMODE */
+    uint32_t write_left;            /**< frames of the running transfer */
+    uint32_t read_left;
+    uint32_t transfers;             /**< transfers started */
+    uint32_t frames;                /**< frames shifted */
+    uint32_t cmd_while_active;
+    uint32_t tx_overflows;          /**< DATA writes to a full TX FIFO */
+    uint32_t rx_underflows;         /**< DATA reads of an empty RX FIFO */
+} hpm_host_sim_spi_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map the register block of an SPI model
+ *
+ * @return false if no block could be mapped
+ */
+bool hpm_host_sim_spi_init(hpm_host_sim_spi_t *spi, hpm_host_sim_spi_device_t device, void *device_context);
+
+/**
+ * @brief Unmap the register block
+ */
+void hpm_host_sim_spi_deinit(hpm_host_sim_spi_t *spi);
+
+/**
+ * @brief SPI_Type pointer to pass to the driver
+ */
+static inline SPI_Type *hpm_host_sim_spi_base(hpm_host_sim_spi_t *spi)
+{
+    return (SPI_Type *)spi->block->base;
+}
+
+/**
+ * @brief Shift up to frames frames, returns the frames shifted
+ */
+uint32_t hpm_host_sim_spi_shift(hpm_host_sim_spi_t *spi, uint32_t frames);
+
+/**
+ * @brief TX DMA request, a hpm_host_sim_dma_request_t: TXDMAEN and TX FIFO room
+ */
+bool hpm_host_sim_spi_tx_request(void *spi);
+
+/**
+ * @brief RX DMA request, a hpm_host_sim_dma_request_t: RXDMAEN and RX FIFO data
+ */
+bool hpm_host_sim_spi_rx_request(void *spi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_HOST_SIM_SPI_H */
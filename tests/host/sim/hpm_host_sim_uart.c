@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include "hpm_host_sim_uart.h"
+
+static void host_sim_uart_hook(hpm_host_sim_block_t *block, uint32_t offset,
+                               hpm_host_sim_access_t access, uint32_t old, uint32_t *value)
+{
+    hpm_host_sim_uart_t *uart = (hpm_host_sim_uart_t *)block->context;
+    uint8_t byte;
+
+    (void)old;
+    if (access == hpm_host_sim_read) {
+        if (offset == offsetof(UART_Type, LSR)) {
+            *value = ((uart->tx_level < HPM_HOST_SIM_UART_FIFO_DEPTH) ? UART_LSR_THRE_MASK : 0U)
+                   | ((uart->tx_level == 0U) ? UART_LSR_TEMT_MASK : 0U)
+                   | ((uart->rx_level != 0U) ? UART_LSR_DR_MASK : 0U)
+                   | (uart->overrun ? UART_LSR_OE_MASK : 0U);
+            uart->overrun = false;
+            if (uart->tx_level != 0U) {
+                byte = uart->tx_fifo[0];
+                memmove(uart->tx_fifo, &uart->tx_fifo[1], --uart->tx_level);
+                uart->tx_bytes++;
+                if (uart->wire != NULL) {
+                    uart->wire(uart->wire_context, byte);
+                }
+            }
+        } else if ((offset == offsetof(UART_Type, RBR)) && (uart->rx_level != 0U)) {
+            *value = uart->rx_fifo[0];
+            memmove(uart->rx_fifo, &uart->rx_fifo[1], --uart->rx_level);
+        }
+    } else if ((offset == offsetof(UART_Type, THR)) && (uart->tx_level < HPM_HOST_SIM_UART_FIFO_DEPTH)) {
+        /* RBR and THR share the offset */
+        uart->tx_fifo[uart->tx_level++] = (uint8_t)*value;
+    }
+}
+
+bool hpm_host_sim_uart_init(hpm_host_sim_uart_t *uart, hpm_host_sim_uart_wire_t wire, void *wire_context)
+{
+    memset(uart, 0, sizeof(*uart));
+    uart->wire = wire;
+    uart->wire_context = wire_context;
+    uart->block = hpm_host_sim_block_create(sizeof(UART_Type), host_sim_uart_hook, uart);
+    return uart->block != NULL;
+}
+
+void hpm_host_sim_uart_deinit(hpm_host_sim_uart_t *uart)
+{
+    hpm_host_sim_block_destroy(uart->block);
+    uart->block = NULL;
+}
+
+bool hpm_host_sim_uart_receive(hpm_host_sim_uart_t *uart, uint8_t byte)
+{
+    if (uart->rx_level == HPM_HOST_SIM_UART_FIFO_DEPTH) {
+        uart->overrun = true;
+        uart->rx_lost++;
+        return false;
+    }
+    uart->rx_fifo[uart->rx_level++] = byte;
+    uart->rx_bytes++;
+    return true;
+}
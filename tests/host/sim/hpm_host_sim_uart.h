@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef HPM_HOST_SIM_UART_H
+#define HPM_HOST_SIM_UART_H
+
+#include "hpm_host_sim.h"
+#include "hpm_uart_drv.h"
+
+/**
+ * @brief UART model, hpm_uart_regs.h layout
+ *
+ * THR writes fill a TX FIFO, one byte leaves it for the wire callback on every
+ * LSR read, so polling takes time. hpm_host_sim_uart_receive() puts a byte from
+ * the wire in the RX FIFO, RBR reads pop it; a byte arriving at a full FIFO is
+ * lost and sets OE until the next LSR read. The wire callback may call
+ * hpm_host_sim_uart_receive(), e.g. to echo the bus as a LIN transceiver does.
+ * LSR reports DR, OE, THRE and TEMT, other registers are plain storage.
+ */
+
+#define HPM_HOST_SIM_UART_FIFO_DEPTH (16U)
+
+/* one byte on the wire */
+typedef void (*hpm_host_sim_uart_wire_t)(void *context, uint8_t byte);
+
+typedef struct {
+    hpm_host_sim_block_t *block;
+    hpm_host_sim_uart_wire_t wire;
+    void *wire_context;
+    uint8_t tx_fifo[HPM_HOST_SIM_UART_FIFO_DEPTH];
+    uint32_t tx_level;
+    uint8_t rx_fifo[HPM_HOST_SIM_UART_FIFO_DEPTH];
+    uint32_t rx_level;
+    bool overrun;
+    uint32_t tx_bytes;              /**< bytes sent to the wire */
+    uint32_t rx_bytes;              /**< bytes stored in the RX FIFO */
+    uint32_t rx_lost;
+} hpm_host_sim_uart_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Map the register block of a UART model
+ *
+ * @return false if no block could be mapped
+ */
+bool hpm_host_sim_uart_init(hpm_host_sim_uart_t *uart, hpm_host_sim_uart_wire_t wire, void *wire_context);
+
+/**
+ * @brief Unmap the register block
+ */
+void hpm_host_sim_uart_deinit(hpm_host_sim_uart_t *uart);
+
+/**
+ * @brief UART_Type pointer to pass to the driver
+ */
+static inline UART_Type *hpm_host_sim_uart_base(hpm_host_sim_uart_t *uart)
+{
+    return (UART_Type *)uart->block->base;
+}
+
+/**
+ * @brief A byte from the wire into the RX FIFO
+ *
+ * @return false if the FIFO was full and the byte is lost
+ */
+bool hpm_host_sim_uart_receive(hpm_host_sim_uart_t *uart, uint8_t byte);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HPM_HOST_SIM_UART_H */
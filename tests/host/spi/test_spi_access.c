@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim_dma.h"
+#include "hpm_host_sim_spi.h"
+
+/*
+ * SPI driver against sim/hpm_host_sim_spi.c: register accesses per frame of
+ * the polled spi_transfer() modes, taken as the difference between a long and
+ * a short transfer so the setup does not count, and the CPU accesses of a DMA
+ * transfer through sim/hpm_host_sim_dma.c, which do not grow with its length.
+ * The device loops MOSI back and counts up on read only frames.
+ */
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_SHORT     (16U)
+#define TEST_LONG      (64U)
+#define TEST_DMA_SHORT (32U)
+#define TEST_DMA_LONG  (256U)
+#define TEST_DMA_CH    (0U)
+
+typedef struct {
+    uint8_t mosi[TEST_DMA_LONG];
+    uint32_t written;
+    uint32_t counter;
+} test_device_t;
+
+static hpm_host_sim_spi_t s_spi;
+static hpm_host_sim_dma_t s_dma;
+static test_device_t s_device;
+static uint8_t s_wbuff[TEST_DMA_LONG];
+static uint8_t s_rbuff[TEST_DMA_LONG];
+
+static uint32_t device_frame(void *context, uint32_t mosi, bool write, bool read)
+{
+    test_device_t *device = (test_device_t *)context;
+
+    if (write) {
+        if (device->written < sizeof(device->mosi)) {
+            device->mosi[device->written] = (uint8_t)mosi;
+        }
+        device->written++;
+        return mosi & 0xFFU;
+    }
+    return read ? (device->counter++ & 0xFFU) : 0U;
+}
+
+typedef struct {
+    uint32_t reads;
+    uint32_t writes;
+} test_cost_t;
+
+static hpm_stat_t polled_transfer(SPI_Type *spi, uint8_t trans_mode, uint32_t count, test_cost_t *cost)
+{
+    spi_control_config_t control;
+    hpm_stat_t stat;
+
+    spi_master_get_default_control_config(&control);
+    control.common_config.trans_mode = trans_mode;
+    memset(&s_device, 0, sizeof(s_device));
+    memset(s_rbuff, 0, sizeof(s_rbuff));
+    hpm_host_sim_block_reset_stat(s_spi.block);
+    stat = spi_transfer(spi, &control, NULL, NULL, s_wbuff, count, s_rbuff, count);
+    cost->reads = s_spi.block->reads;
+    cost->writes = s_spi.block->writes;
+    return stat;
+}
+
+static hpm_stat_t dma_transfer(SPI_Type *spi, bool tx, uint32_t count, test_cost_t *cost)
+{
+    DMA_Type *dma = hpm_host_sim_dma_base(&s_dma);
+    spi_control_config_t control;
+    dma_handshake_config_t handshake;
+    uint32_t runs = 0;
+    hpm_stat_t stat;
+
+    spi_master_get_default_control_config(&control);
+    control.common_config.trans_mode = tx ? spi_trans_write_only : spi_trans_read_only;
+    control.common_config.tx_dma_enable = tx;
+    control.common_config.rx_dma_enable = !tx;
+    memset(&s_device, 0, sizeof(s_device));
+    memset(s_rbuff, 0, sizeof(s_rbuff));
+    hpm_host_sim_dma_set_request(&s_dma, TEST_DMA_CH, tx ? hpm_host_sim_spi_tx_request : hpm_host_sim_spi_rx_request, &s_spi);
+
+    dma_default_handshake_config(dma, &handshake);
+    handshake.ch_index = TEST_DMA_CH;
+    handshake.data_width = DMA_TRANSFER_WIDTH_BYTE;
+    handshake.size_in_byte = count;
+    handshake.src = tx ? (uint32_t)s_wbuff : (uint32_t)&spi->DATA;
+    handshake.dst = tx ? (uint32_t)&spi->DATA : (uint32_t)s_rbuff;
+    handshake.dst_fixed = tx;
+    handshake.src_fixed = !tx;
+    if (dma_setup_handshake(dma, &handshake, true) != status_success) {
+        return status_fail;
+    }
+
+    hpm_host_sim_block_reset_stat(s_spi.block);
+    stat = spi_setup_dma_transfer(spi, &control, NULL, NULL, count, count);
+    if (stat != status_success) {
+        return stat;
+    }
+    while (dma_channel_is_enable(dma, TEST_DMA_CH) && (runs++ < 4U * count)) {
+        hpm_host_sim_dma_run(&s_dma, 0);
+    }
+    stat = spi_wait_for_idle_status(spi);
+    cost->reads = s_spi.block->reads;
+    cost->writes = s_spi.block->writes;
+    if (dma_check_transfer_status(dma, TEST_DMA_CH) != DMA_CHANNEL_STATUS_TC) {
+        return status_fail;
+    }
+    return stat;
+}
+
+int main(void)
+{
+    static const struct {
+        const char *name;
+        uint8_t mode;
+    } modes[] = {
+        { "write only", spi_trans_write_only },
+        { "read only", spi_trans_read_only },
+        { "write read together", spi_trans_write_read_together },
+    };
+    SPI_Type *spi;
+    spi_format_config_t format;
+    test_cost_t short_cost;
+    test_cost_t long_cost;
+    uint32_t cpu_short;
+    uint32_t cpu_long;
+
+    CHECK(hpm_host_sim_spi_init(&s_spi, device_frame, &s_device));
+    CHECK(hpm_host_sim_dma_init(&s_dma));
+    spi = hpm_host_sim_spi_base(&s_spi);
+    for (uint32_t i = 0; i < sizeof(s_wbuff); i++) {
+        s_wbuff[i] = (uint8_t)(i * 13U + 5U);
+    }
+
+    spi_master_get_default_format_config(&format);
+    format.common_config.data_len_in_bits = 8;
+    format.common_config.mode = spi_master_mode;
+    spi_format_init(spi, &format);
+
+    for (uint32_t m = 0; m < ARRAY_SIZE(modes); m++) {
+        CHECK(polled_transfer(spi, modes[m].mode, TEST_SHORT, &short_cost) == status_success);
+        CHECK(polled_transfer(spi, modes[m].mode, TEST_LONG, &long_cost) == status_success);
+        CHECK(s_spi.transfers != 0U);
+        if (modes[m].mode != spi_trans_read_only) {
+            CHECK(s_device.written == TEST_LONG);
+            CHECK(memcmp(s_device.mosi, s_wbuff, TEST_LONG) == 0);
+        }
+        if (modes[m].mode == spi_trans_write_read_together) {
+            CHECK(memcmp(s_rbuff, s_wbuff, TEST_LONG) == 0);
+        } else if (modes[m].mode == spi_trans_read_only) {
+            for (uint32_t i = 0; i < TEST_LONG; i++) {
+                CHECK(s_rbuff[i] == (uint8_t)i);
+            }
+        }
+        printf("spi_transfer %s: %.2f reads, %.2f writes per frame, %u reads, %u writes for %u frames\n",
+               modes[m].name,
+               (double)(long_cost.reads - short_cost.reads) / (TEST_LONG - TEST_SHORT),
+               (double)(long_cost.writes - short_cost.writes) / (TEST_LONG - TEST_SHORT),
+               long_cost.reads, long_cost.writes, TEST_LONG);
+        /* a frame costs one DATA access and at least one STATUS read */
+        CHECK((long_cost.reads - short_cost.reads) >= (TEST_LONG - TEST_SHORT));
+        CHECK((long_cost.writes - short_cost.writes)
+              == ((modes[m].mode == spi_trans_read_only) ? 0U : (TEST_LONG - TEST_SHORT)));
+    }
+    CHECK((s_spi.tx_overflows == 0U) && (s_spi.rx_underflows == 0U));
+
+    /* DMA: the CPU sets the transfer up and waits for the end, the DMA moves the frames */
+    for (uint32_t tx = 0; tx < 2U; tx++) {
+        CHECK(dma_transfer(spi, tx != 0U, TEST_DMA_SHORT, &short_cost) == status_success);
+        cpu_short = short_cost.reads + short_cost.writes;
+        hpm_host_sim_block_reset_stat(s_spi.block);
+        CHECK(dma_transfer(spi, tx != 0U, TEST_DMA_LONG, &long_cost) == status_success);
+        cpu_long = long_cost.reads + long_cost.writes;
+        if (tx != 0U) {
+            CHECK(s_device.written == TEST_DMA_LONG);
+            CHECK(memcmp(s_device.mosi, s_wbuff, TEST_DMA_LONG) == 0);
+            CHECK(s_spi.block->bus_writes == TEST_DMA_LONG);
+        } else {
+            for (uint32_t i = 0; i < TEST_DMA_LONG; i++) {
+                CHECK(s_rbuff[i] == (uint8_t)i);
+            }
+            CHECK(s_spi.block->bus_reads == TEST_DMA_LONG);
+        }
+        printf("spi_setup_dma_transfer %s: %u CPU accesses for %u frames, %u for %u frames\n",
+               (tx != 0U) ? "write" : "read", cpu_short, TEST_DMA_SHORT, cpu_long, TEST_DMA_LONG);
+        /* only the wait for the end of the transfer may depend on its length */
+        CHECK((long_cost.writes == short_cost.writes) && (cpu_long <= cpu_short + 4U));
+    }
+
+    hpm_host_sim_dma_deinit(&s_dma);
+    hpm_host_sim_spi_deinit(&s_spi);
+    return 0;
+}
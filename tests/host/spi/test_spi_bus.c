@@ -0,0 +1,445 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "hpm_host_sim_dma.h"
+#include "hpm_host_sim_spi.h"
+#include "hpm_spi.h"
+
+/*
+ * components/spi bus of prepared transactions against sim/hpm_host_sim_spi.c
+ * and sim/hpm_host_sim_dma.c, three devices on one SPI: write only, read
+ * only and write read together, each chained over up to TEST_MAX_CHUNKS
+ * chunks of TEST_PER_TRANS frames. After every rearm the descriptor chain is
+ * checked against the layout the SPI expects (TRANSCTRL, CMD, DATA per chunk,
+ * the data sizes of a transmit chain shifted by one). The transactions are
+ * queued together with random lengths, the interrupts are served from the
+ * loop moving the models, the DMA as soon as it can, the SPI a frame a round: the wire must carry each device's data under its
+ * own chip select only, and a chip select must never change while the SPI
+ * still shifts. Reports the register accesses of a start and of each
+ * interrupt, none of which may poll the SPI, and the time of a rearm against
+ * building the descriptors per transfer as hpm_spi_setup_dma_transfer() does.
+ */
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_PER_TRANS   (16U)
+#define TEST_MAX_CHUNKS  (4U)
+#define TEST_MAX_COUNT   (TEST_PER_TRANS * TEST_MAX_CHUNKS)
+#define TEST_DEVICES     (3U)
+#define TEST_ROUNDS      (150U)
+#define TEST_TX_CH       (0U)
+#define TEST_RX_CH       (1U)
+#define TEST_TIMED_CALLS (200000U)
+#define TEST_STATUS_REG  (offsetof(SPI_Type, STATUS) / sizeof(uint32_t))
+
+typedef struct {
+    spi_context_t context;
+    spi_control_config_t control;
+    hpm_spi_trans_t trans;
+    dma_linked_descriptor_t descriptors[SPI_DMA_DESC_COUNT_PER_TRANS * TEST_MAX_CHUNKS] __attribute__((aligned(8)));
+    uint32_t transctrl[TEST_MAX_CHUNKS];
+    uint8_t tx[TEST_MAX_COUNT];
+    uint8_t rx[TEST_MAX_COUNT];
+    uint8_t wire[TEST_MAX_COUNT];   /* MOSI since the chip select was asserted */
+    uint32_t wire_len;
+    uint32_t read_frames;
+    uint8_t miso;
+    bool selected;
+    bool queued;
+    uint32_t done;
+} test_device_t;
+
+typedef struct {
+    uint32_t spi;
+    uint32_t dma;
+    uint32_t dmamux;
+    uint32_t status_reads;
+} test_cost_t;
+
+static hpm_host_sim_spi_t s_spi;
+static hpm_host_sim_dma_t s_dma;
+static hpm_host_sim_block_t *s_dmamux;
+static hpm_spi_bus_t s_bus;
+static test_device_t s_devices[TEST_DEVICES];
+static uint32_t s_seed = 1;
+static uint32_t s_errors;
+static test_cost_t s_isr_max;
+static test_cost_t s_start_max;
+static uint32_t s_dma_irqs;
+static uint32_t s_spi_irqs;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static void error(const char *what, uint32_t device)
+{
+    printf("device %u: %s\n", (unsigned int)device, what);
+    s_errors++;
+}
+
+static void reset_cost(void)
+{
+    hpm_host_sim_block_reset_stat(s_spi.block);
+    hpm_host_sim_block_reset_stat(s_dma.block);
+    hpm_host_sim_block_reset_stat(s_dmamux);
+}
+
+static void take_cost(test_cost_t *max)
+{
+    uint32_t dma = s_dma.block->reads + s_dma.block->writes;
+    uint32_t spi = s_spi.block->reads + s_spi.block->writes;
+    uint32_t dmamux = s_dmamux->reads + s_dmamux->writes;
+
+    max->spi = MAX(max->spi, spi);
+    max->dma = MAX(max->dma, dma);
+    max->dmamux = MAX(max->dmamux, dmamux);
+    max->status_reads = MAX(max->status_reads, s_spi.block->reg_reads[TEST_STATUS_REG]);
+}
+
+static uint32_t device_frame(void *context, uint32_t mosi, bool write, bool read)
+{
+    test_device_t *device = NULL;
+    uint32_t selected = 0;
+
+    (void)context;
+    for (uint32_t i = 0; i < TEST_DEVICES; i++) {
+        if (s_devices[i].selected) {
+            device = &s_devices[i];
+            selected++;
+        }
+    }
+    if (selected != 1U) {
+        error("frame without a single chip select", selected);
+        return 0;
+    }
+    if (write) {
+        if (device->wire_len < sizeof(device->wire)) {
+            device->wire[device->wire_len] = (uint8_t)mosi;
+        }
+        device->wire_len++;
+    }
+    if (!read) {
+        return 0;
+    }
+    device->read_frames++;
+    /* full duplex answers with the inverted MOSI, read only counts up */
+    return write ? (~mosi & 0xFFU) : device->miso++;
+}
+
+static void write_cs(uint32_t cs_pin, uint8_t state)
+{
+    test_device_t *device = &s_devices[cs_pin];
+
+    if (state == SPI_CS_ACTIVE) {
+        for (uint32_t i = 0; i < TEST_DEVICES; i++) {
+            if (s_devices[i].selected) {
+                error("selected while another device is", cs_pin);
+            }
+        }
+        device->wire_len = 0;
+        device->read_frames = 0;
+    } else if (s_spi.active || (s_spi.tx_level != 0U)) {
+        error("released while the SPI shifts", cs_pin);
+    }
+    device->selected = (state == SPI_CS_ACTIVE);
+}
+
+static void trans_done(hpm_spi_trans_t *trans, void *cb_context)
+{
+    test_device_t *device = (test_device_t *)cb_context;
+    uint32_t index = (uint32_t)(device - s_devices);
+    uint8_t mode = trans->config.common_config.trans_mode;
+    uint8_t expect = (uint8_t)(device->miso - trans->count);
+
+    if (trans->status != status_success) {
+        error("transaction failed", index);
+    }
+    if ((mode != spi_trans_read_only) && ((device->wire_len != trans->count) || (memcmp(device->wire, trans->tx_buff, trans->count) != 0))) {
+        error("MOSI differs", index);
+    }
+    if ((mode != spi_trans_write_only) && (device->read_frames != trans->count)) {
+        error("read frames differ", index);
+    }
+    for (uint32_t i = 0; (mode == spi_trans_read_only) && (i < trans->count); i++) {
+        if (trans->rx_buff[i] != (uint8_t)(expect + i)) {
+            error("MISO differs", index);
+            break;
+        }
+    }
+    for (uint32_t i = 0; (mode == spi_trans_write_read_together) && (i < trans->count); i++) {
+        if (trans->rx_buff[i] != (uint8_t)~trans->tx_buff[i]) {
+            error("full duplex MISO differs", index);
+            break;
+        }
+    }
+    device->queued = false;
+    device->done++;
+}
+
+/* the chain hpm_spi_trans_rearm() left for count frames */
+static int check_descriptors(test_device_t *device, uint32_t count)
+{
+    hpm_spi_trans_t *trans = &device->trans;
+    SPI_Type *spi = device->context.ptr;
+    uint8_t mode = device->control.common_config.trans_mode;
+    bool tx = (mode != spi_trans_read_only);
+    uint32_t chunks = (count + TEST_PER_TRANS - 1U) / TEST_PER_TRANS;
+    uint32_t transmode = SPI_TRANSCTRL_TRANSMODE_SET(tx ? mode : spi_trans_read_only);
+    uint32_t buff = (uint32_t)(tx ? device->tx : device->rx);
+    uint32_t left = count;
+    dma_linked_descriptor_t *d;
+    uint32_t frames;
+    uint32_t dma_frames;
+
+    CHECK(trans->chunks == chunks);
+    CHECK(trans->chain_dma_ch == (tx ? TEST_TX_CH : TEST_RX_CH));
+    CHECK(trans->chain_start.size_in_byte == 4U);
+    CHECK(trans->chain_start.linked_ptr == (uint32_t)&device->descriptors[2]);
+    for (uint32_t i = 0; i < chunks; i++) {
+        d = &device->descriptors[i * SPI_DMA_DESC_COUNT_PER_TRANS];
+        frames = MIN(left, TEST_PER_TRANS);
+        left -= frames;
+        /* a transmit chain runs one frame ahead so the FIFO is never empty when the next CMD is written */
+        dma_frames = frames + ((tx && (i == 0U)) ? 1U : 0U) - ((tx && (i == chunks - 1U)) ? 1U : 0U);
+
+        CHECK(device->transctrl[i] == (transmode | SPI_TRANSCTRL_WRTRANCNT_SET(frames - 1U) | SPI_TRANSCTRL_RDTRANCNT_SET(frames - 1U)));
+        CHECK((d[0].src_addr == (uint32_t)&device->transctrl[i]) && (d[0].dst_addr == (uint32_t)&spi->TRANSCTRL));
+        CHECK((d[0].trans_size == 1U) && (d[0].linked_ptr == (uint32_t)&d[1]));
+        CHECK((d[1].dst_addr == (uint32_t)&spi->CMD) && (d[1].trans_size == 1U) && (d[1].linked_ptr == (uint32_t)&d[2]));
+        CHECK(d[2].trans_size == dma_frames);
+        if (tx) {
+            CHECK((d[2].src_addr == buff) && (d[2].dst_addr == (uint32_t)&spi->DATA));
+            CHECK((d[2].ctrl & DMA_CHCTRL_CTRL_DSTMODE_MASK) && !(d[2].ctrl & DMA_CHCTRL_CTRL_SRCMODE_MASK));
+        } else {
+            CHECK((d[2].src_addr == (uint32_t)&spi->DATA) && (d[2].dst_addr == buff));
+            CHECK((d[2].ctrl & DMA_CHCTRL_CTRL_SRCMODE_MASK) && !(d[2].ctrl & DMA_CHCTRL_CTRL_DSTMODE_MASK));
+        }
+        CHECK(d[2].linked_ptr == ((i == chunks - 1U) ? 0U : (uint32_t)&d[3]));
+        buff += dma_frames;
+    }
+    CHECK(buff == (uint32_t)(tx ? device->tx : device->rx) + count);
+    if (mode == spi_trans_write_read_together) {
+        CHECK((trans->rx_config.dst_addr == (uint32_t)device->rx) && (trans->rx_config.size_in_byte == count));
+    }
+    return 0;
+}
+
+/*
+ * DMA requests that leave the wire alone, the loop shifts one frame per round:
+ * the DMA keeps the FIFOs full or empty as a bus much faster than the SPI does
+ */
+static bool tx_request(void *context)
+{
+    hpm_host_sim_spi_t *spi = (hpm_host_sim_spi_t *)context;
+
+    return ((hpm_host_sim_peek(spi->block, offsetof(SPI_Type, CTRL)) & SPI_CTRL_TXDMAEN_MASK) != 0U)
+        && (spi->tx_level < SPI_SOC_FIFO_DEPTH);
+}
+
+static bool rx_request(void *context)
+{
+    hpm_host_sim_spi_t *spi = (hpm_host_sim_spi_t *)context;
+
+    return ((hpm_host_sim_peek(spi->block, offsetof(SPI_Type, CTRL)) & SPI_CTRL_RXDMAEN_MASK) != 0U)
+        && (spi->rx_level != 0U);
+}
+
+static bool spi_irq(void)
+{
+    return (hpm_host_sim_peek(s_spi.block, offsetof(SPI_Type, INTRST))
+            & hpm_host_sim_peek(s_spi.block, offsetof(SPI_Type, INTREN)) & SPI_INTRST_ENDINT_MASK) != 0U;
+}
+
+/* move the models and serve the interrupts until the queue is empty */
+static int run_bus(void)
+{
+    uint32_t steps = 0;
+
+    while (hpm_spi_bus_is_busy(&s_bus)) {
+        CHECK(steps++ < 100000U);
+        /* the interrupt is taken as soon as the DMA is done, the SPI shifts on meanwhile */
+        hpm_host_sim_dma_run(&s_dma, 0);
+        if (hpm_host_sim_dma_irq(&s_dma)) {
+            reset_cost();
+            hpm_spi_bus_dma_isr_handler(&s_bus);
+            take_cost(&s_isr_max);
+            s_dma_irqs++;
+        }
+        if (spi_irq()) {
+            reset_cost();
+            hpm_spi_bus_spi_isr_handler(&s_bus);
+            take_cost(&s_isr_max);
+            s_spi_irqs++;
+        }
+        hpm_host_sim_spi_shift(&s_spi, 1);
+    }
+    CHECK(!hpm_host_sim_dma_irq(&s_dma) && !spi_irq());
+    return 0;
+}
+
+static int setup_device(uint32_t index, uint8_t mode)
+{
+    test_device_t *device = &s_devices[index];
+    spi_context_t *context = &device->context;
+
+    context->ptr = hpm_host_sim_spi_base(&s_spi);
+    context->cs_pin = index;
+    context->cmd = 0x0B;
+    context->tx_buff = device->tx;
+    context->rx_buff = device->rx;
+    context->tx_count = TEST_MAX_COUNT;
+    context->rx_count = TEST_MAX_COUNT;
+    context->tx_size = TEST_MAX_COUNT;
+    context->rx_size = TEST_MAX_COUNT;
+    context->data_len_in_byte = 1;
+    context->per_trans_max = TEST_PER_TRANS;
+    context->write_cs = write_cs;
+    context->dma_context.dma_ptr = hpm_host_sim_dma_base(&s_dma);
+    context->dma_context.dmamux_ptr = (DMAMUX_Type *)s_dmamux->base;
+    context->dma_context.tx_dma_ch = TEST_TX_CH;
+    context->dma_context.rx_dma_ch = TEST_RX_CH;
+    context->dma_context.tx_dmamux_ch = TEST_TX_CH;
+    context->dma_context.rx_dmamux_ch = TEST_RX_CH;
+    context->dma_context.tx_req = 1;
+    context->dma_context.rx_req = 2;
+    context->dma_context.data_width = DMA_TRANSFER_WIDTH_BYTE;
+
+    spi_master_get_default_control_config(&device->control);
+    device->control.common_config.trans_mode = mode;
+    device->control.common_config.tx_dma_enable = (mode != spi_trans_read_only);
+    device->control.common_config.rx_dma_enable = (mode != spi_trans_write_only);
+    CHECK(hpm_spi_trans_prepare(&device->trans, context, &device->control, device->descriptors, device->transctrl,
+                                TEST_MAX_CHUNKS) == status_success);
+    CHECK(check_descriptors(device, TEST_MAX_COUNT) == 0);
+    return 0;
+}
+
+/* rearm with a random length, check the chain and queue it */
+static int submit(test_device_t *device)
+{
+    uint32_t count = 1U + rnd() % TEST_MAX_COUNT;
+    uint8_t mode = device->control.common_config.trans_mode;
+
+    for (uint32_t i = 0; i < count; i++) {
+        device->tx[i] = (uint8_t)rnd();
+    }
+    memset(device->rx, 0, sizeof(device->rx));
+    CHECK(hpm_spi_trans_rearm(&device->trans, (mode != spi_trans_read_only) ? device->tx : NULL,
+                              (mode != spi_trans_write_only) ? device->rx : NULL, count) == status_success);
+    CHECK(check_descriptors(device, count) == 0);
+    device->queued = true;
+    CHECK(hpm_spi_bus_submit(&s_bus, &device->trans, trans_done, device) == status_success);
+    CHECK(hpm_spi_bus_submit(&s_bus, &device->trans, trans_done, device) == status_spi_trans_busy);
+    CHECK(hpm_spi_trans_rearm(&device->trans, device->tx, device->rx, count) == status_spi_trans_busy);
+    return 0;
+}
+
+int main(void)
+{
+    static const uint8_t modes[TEST_DEVICES] = { spi_trans_write_only, spi_trans_read_only, spi_trans_write_read_together };
+    spi_format_config_t format;
+    test_device_t *device;
+    uint32_t transfers = 0;
+    uint64_t start;
+    double rearm_ns;
+    double build_ns;
+
+    CHECK(hpm_host_sim_spi_init(&s_spi, device_frame, NULL));
+    CHECK(hpm_host_sim_dma_init(&s_dma));
+    s_dmamux = hpm_host_sim_block_create(sizeof(DMAMUX_Type), NULL, NULL);
+    CHECK(s_dmamux != NULL);
+    hpm_host_sim_dma_set_request(&s_dma, TEST_TX_CH, tx_request, &s_spi);
+    hpm_host_sim_dma_set_request(&s_dma, TEST_RX_CH, rx_request, &s_spi);
+
+    spi_master_get_default_format_config(&format);
+    format.common_config.data_len_in_bits = 8;
+    format.common_config.mode = spi_master_mode;
+    spi_format_init(hpm_host_sim_spi_base(&s_spi), &format);
+    hpm_spi_bus_init(&s_bus, hpm_host_sim_spi_base(&s_spi));
+    for (uint32_t i = 0; i < TEST_DEVICES; i++) {
+        CHECK(setup_device(i, modes[i]) == 0);
+    }
+
+    /* a start on the idle bus: chip select, SPI, DMAMUX and the chain start, no descriptor is written */
+    reset_cost();
+    CHECK(submit(&s_devices[0]) == 0);
+    take_cost(&s_start_max);
+    CHECK(run_bus() == 0);
+    CHECK(s_errors == 0U);
+
+    for (uint32_t round = 0; round < TEST_ROUNDS; round++) {
+        /* all devices queued at once, in a random order */
+        for (uint32_t n = 0, first = rnd() % TEST_DEVICES; n < TEST_DEVICES; n++) {
+            CHECK(submit(&s_devices[(first + n) % TEST_DEVICES]) == 0);
+        }
+        CHECK(s_bus.queued == TEST_DEVICES);
+        CHECK(run_bus() == 0);
+        CHECK(s_errors == 0U);
+    }
+    for (uint32_t i = 0; i < TEST_DEVICES; i++) {
+        CHECK(!s_devices[i].queued && !s_devices[i].selected);
+        transfers += s_devices[i].done;
+    }
+    CHECK(transfers == 1U + TEST_ROUNDS * TEST_DEVICES);
+    CHECK((s_bus.stat.transfers == transfers) && (s_bus.stat.errors == 0U) && (s_bus.stat.max_queued == TEST_DEVICES));
+    CHECK((s_spi.tx_overflows == 0U) && (s_spi.rx_underflows == 0U));
+    /* the interrupts read STATUS once at most: a transmit chain that ends with data in the FIFO waits for the end interrupt */
+    CHECK(s_isr_max.status_reads <= 1U);
+    CHECK(s_spi_irqs != 0U);
+
+    /* per transfer CPU time: rearming the prepared chain against building it, which prepare does */
+    device = &s_devices[0];
+    start = now_ns();
+    for (uint32_t i = 0; i < TEST_TIMED_CALLS; i++) {
+        (void)hpm_spi_trans_rearm(&device->trans, device->tx, NULL, TEST_MAX_COUNT - (i & 7U));
+    }
+    rearm_ns = (double)(now_ns() - start) / TEST_TIMED_CALLS;
+    start = now_ns();
+    for (uint32_t i = 0; i < TEST_TIMED_CALLS; i++) {
+        device->context.tx_count = TEST_MAX_COUNT - (i & 7U);
+        (void)hpm_spi_trans_prepare(&device->trans, &device->context, &device->control, device->descriptors,
+                                    device->transctrl, TEST_MAX_CHUNKS);
+    }
+    build_ns = (double)(now_ns() - start) / TEST_TIMED_CALLS;
+    CHECK(check_descriptors(device, TEST_MAX_COUNT - 7U) == 0);
+
+    printf("%u transactions of 1..%u frames in up to %u chunks, %u DMA and %u SPI interrupts\n",
+           (unsigned int)transfers, (unsigned int)TEST_MAX_COUNT, (unsigned int)TEST_MAX_CHUNKS,
+           (unsigned int)s_dma_irqs, (unsigned int)s_spi_irqs);
+    printf("start on an idle bus: %u SPI, %u DMA, %u DMAMUX register accesses\n",
+           (unsigned int)s_start_max.spi, (unsigned int)s_start_max.dma, (unsigned int)s_start_max.dmamux);
+    printf("interrupt, most: %u SPI (%u STATUS reads), %u DMA, %u DMAMUX register accesses\n",
+           (unsigned int)s_isr_max.spi, (unsigned int)s_isr_max.status_reads, (unsigned int)s_isr_max.dma,
+           (unsigned int)s_isr_max.dmamux);
+    printf("%u chunk chain: rearm %.1f ns, descriptor build %.1f ns per transfer\n",
+           (unsigned int)TEST_MAX_CHUNKS, rearm_ns, build_ns);
+
+    hpm_host_sim_block_destroy(s_dmamux);
+    hpm_host_sim_dma_deinit(&s_dma);
+    hpm_host_sim_spi_deinit(&s_spi);
+    return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim_uart.h"
+
+/*
+ * Register accesses per byte of the polled UART calls, sim/hpm_host_sim_uart.c
+ * sends one byte to the wire for every LSR read.
+ */
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+static hpm_host_sim_uart_t s_model;
+static uint8_t s_wire[64];
+static uint32_t s_wire_len;
+
+static void uart_wire(void *context, uint8_t byte)
+{
+    (void)context;
+    s_wire[s_wire_len++] = byte;
+}
+
+int main(void)
+{
+    const uint8_t text[] = "hello";
+    const uint8_t rx[] = { 0x55, 0xAA, 0x01 };
+    hpm_host_sim_block_t *block;
+    UART_Type *uart;
+    uint8_t byte;
+
+    CHECK(hpm_host_sim_uart_init(&s_model, uart_wire, NULL));
+    block = s_model.block;
+    uart = hpm_host_sim_uart_base(&s_model);
+
+    CHECK(uart_send_data(uart, (uint8_t *)text, 5) == status_success);
+    printf("uart_send_byte: %u reads, %u writes per byte\n", block->reads / 5U, block->writes / 5U);
+    CHECK(block->reads == 5U);
+    CHECK(block->writes == 5U);
+
+    hpm_host_sim_block_reset_stat(block);
+    CHECK(uart_flush(uart) == status_success);
+    printf("uart_flush: %u reads\n", block->reads);
+    CHECK((s_wire_len == 5U) && (memcmp(s_wire, text, 5) == 0));
+
+    for (uint32_t i = 0; i < sizeof(rx); i++) {
+        CHECK(hpm_host_sim_uart_receive(&s_model, rx[i]));
+    }
+    hpm_host_sim_block_reset_stat(block);
+    for (uint32_t i = 0; i < sizeof(rx); i++) {
+        CHECK(uart_receive_byte(uart, &byte) == status_success);
+        CHECK(byte == rx[i]);
+    }
+    printf("uart_receive_byte: %u reads per byte\n", block->reads / (uint32_t)sizeof(rx));
+    CHECK(block->reads == 2U * sizeof(rx));
+    CHECK(block->writes == 0U);
+
+    hpm_host_sim_uart_deinit(&s_model);
+    return 0;
+}
@@ -0,0 +1,705 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hpm_host_sim_uart.h"
+#include "hpm_uart_lin.h"
+
+/*
+ * Schedule table master of uart_lin on a simulated LIN bus, time in ns. The
+ * UART model's TX FIFO drains onto the bus one byte per 10 bit times, the
+ * break is the LCR break control bit seen by the test after every timer call
+ * and reads back as a 0x00 byte. Every byte on the bus is the wired AND of
+ * the master and the slaves driving it, is read back into the master's RX
+ * FIFO and the UART interrupt handler runs while its RX interrupt is
+ * enabled. Slaves are UART based: they compare every byte they send with the
+ * bus and stop on a mismatch.
+ * The schedule has a publish, three subscribe (one never answered), an
+ * event triggered and a sporadic slot. Two slaves are associated with the
+ * event triggered frame; their PIDs AND to a value neither sent, so when
+ * both have an update both stop after the first byte, the master sees a
+ * collision and runs the collision table, which polls both, once.
+ * TEST_SLOTS slots run with random updates and checksum errors injected by
+ * a slave. A reference schedule predicts each slot and its outcome:
+ *  - slot timing: the break starts exactly at the slot start, is at least
+ *    13 bits, the delimiter at least 1 bit, the frame ends inside its slot
+ *    and within 1.4 times its nominal length;
+ *  - PID parity and classic/enhanced checksums against an independent
+ *    implementation, in both directions;
+ *  - the frame and status each callback reports, the data delivered,
+ *    sporadic slots silent without an update, the collision table run once
+ *    and the interrupted table resumed after the event triggered slot.
+ * Reports bus load, collisions, timer and interrupt calls and register
+ * accesses per frame.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define TEST_BAUDRATE    (19200U)
+#define TEST_BIT_NS      (1000000000ULL / TEST_BAUDRATE)
+#define TEST_BYTE_NS     (10U * TEST_BIT_NS)
+#define TEST_SLOT_US     (10000U)
+#define TEST_SLOTS       (6000U)
+#define TEST_DRAIN_SLOTS (60U)      /* last slots without updates */
+#define TEST_NO_FRAME    (0xFFU)
+
+/* frame indices */
+enum {
+    FRAME_PUB = 0,                  /* publish, enhanced */
+    FRAME_SUB_A,                    /* subscribe, slave A, errors injected */
+    FRAME_SUB_B,                    /* subscribe, slave B, classic checksum */
+    FRAME_ET_C,                     /* subscribe, slave C, associated with FRAME_ET */
+    FRAME_ET_D,                     /* subscribe, slave D, associated with FRAME_ET */
+    FRAME_ET,                       /* event triggered */
+    FRAME_SPORADIC,                 /* sporadic over FRAME_SPOR_X and FRAME_SPOR_Y */
+    FRAME_SPOR_X,                   /* publish, classic */
+    FRAME_SPOR_Y,                   /* publish, enhanced */
+    FRAME_SILENT,                   /* subscribe, nobody answers */
+    FRAME_COUNT
+};
+
+typedef struct {
+    uint8_t frame;                  /* unconditional frame the slave answers */
+    bool et;                        /* also answers FRAME_ET while pending */
+    uint8_t data[8];
+    bool pending;                   /* update not yet delivered */
+    /* response on the bus */
+    uint8_t tx[9];
+    uint8_t tx_len;
+    uint8_t tx_pos;
+    bool tx_active;
+    bool drove;                     /* drove the byte on the bus */
+} test_slave_t;
+
+/* one slot as predicted and as seen on the bus */
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint8_t frame;                  /* frame of the slot */
+    uint8_t bus_frame;              /* frame on the bus, TEST_NO_FRAME for a silent slot */
+    bool breaks;
+    uint64_t break_start;
+    uint64_t break_end;
+    uint64_t first_byte;
+    uint64_t last_byte_end;
+    uint8_t header[2];
+    uint8_t bytes;                  /* bytes on the bus after the break */
+    uint8_t responders;
+    uint8_t responder;              /* frame of the last slave answering */
+    bool corrupt;
+    uint8_t callbacks;
+    uint8_t cb_frame;
+    uart_lin_stat_t cb_stat;
+} test_slot_t;
+
+static const uint8_t s_et_assoc[] = { FRAME_ET_C, FRAME_ET_D };
+static const uint8_t s_sporadic_assoc[] = { FRAME_SPOR_X, FRAME_SPOR_Y };
+
+static const uart_lin_slot_t s_main_slots[] = {
+    { FRAME_PUB, TEST_SLOT_US },
+    { FRAME_SUB_A, TEST_SLOT_US },
+    { FRAME_ET, TEST_SLOT_US },
+    { FRAME_SUB_B, TEST_SLOT_US },
+    { FRAME_SPORADIC, TEST_SLOT_US },
+    { FRAME_SILENT, TEST_SLOT_US },
+};
+static const uart_lin_schedule_t s_main_table = { s_main_slots, ARRAY_SIZE(s_main_slots) };
+
+static const uart_lin_slot_t s_collision_slots[] = {
+    { FRAME_ET_C, TEST_SLOT_US },
+    { FRAME_ET_D, TEST_SLOT_US },
+};
+static const uart_lin_schedule_t s_collision_table = { s_collision_slots, ARRAY_SIZE(s_collision_slots) };
+
+static uart_lin_frame_t s_frames[FRAME_COUNT] = {
+    [FRAME_PUB] = { .id = 0x10, .type = uart_lin_frame_publish, .length = 4, .enhance_checksum = true },
+    [FRAME_SUB_A] = { .id = 0x21, .type = uart_lin_frame_subscribe, .length = 2, .enhance_checksum = true },
+    [FRAME_SUB_B] = { .id = 0x22, .type = uart_lin_frame_subscribe, .length = 8, .enhance_checksum = false },
+    [FRAME_ET_C] = { .id = 0x23, .type = uart_lin_frame_subscribe, .length = 4, .enhance_checksum = true },
+    [FRAME_ET_D] = { .id = 0x24, .type = uart_lin_frame_subscribe, .length = 4, .enhance_checksum = true },
+    [FRAME_ET] = { .id = 0x30, .type = uart_lin_frame_event_triggered, .length = 4, .enhance_checksum = true,
+                   .assoc = s_et_assoc, .assoc_count = ARRAY_SIZE(s_et_assoc),
+                   .collision_table = &s_collision_table },
+    [FRAME_SPORADIC] = { .id = 0x31, .type = uart_lin_frame_sporadic, .length = 1,
+                         .assoc = s_sporadic_assoc, .assoc_count = ARRAY_SIZE(s_sporadic_assoc) },
+    [FRAME_SPOR_X] = { .id = 0x12, .type = uart_lin_frame_publish, .length = 2, .enhance_checksum = false },
+    [FRAME_SPOR_Y] = { .id = 0x13, .type = uart_lin_frame_publish, .length = 3, .enhance_checksum = true },
+    [FRAME_SILENT] = { .id = 0x25, .type = uart_lin_frame_subscribe, .length = 2, .enhance_checksum = true },
+};
+
+static test_slave_t s_slaves[] = {
+    { .frame = FRAME_SUB_A },
+    { .frame = FRAME_SUB_B },
+    { .frame = FRAME_ET_C, .et = true },
+    { .frame = FRAME_ET_D, .et = true },
+};
+
+static hpm_host_sim_uart_t s_model;
+static UART_Type *s_uart;
+static uart_lin_master_t s_master;
+static uint32_t s_seed = 1;
+static uint32_t s_errors;
+
+/* master TX shifter, fed by the UART model */
+static uint8_t s_master_queue[32];
+static uint32_t s_master_queued;
+
+/* bus */
+static uint64_t s_now;
+static bool s_break;
+static bool s_byte_active;
+static uint64_t s_byte_end;
+static uint8_t s_byte;
+static uint64_t s_busy_ns;
+static uint8_t s_frame_pos;         /* bytes since the break */
+static uint8_t s_bus_frame;         /* frame whose PID is on the bus */
+static uint8_t s_listen[8];         /* response to a published frame */
+
+/* reference schedule */
+static const uart_lin_schedule_t *s_ref_table;
+static uint8_t s_ref_slot;
+static uint8_t s_ref_resume;
+static bool s_ref_collision;
+static test_slot_t s_slot;
+static bool s_slot_open;
+
+/* counts */
+static uint32_t s_isr_calls;
+static uint32_t s_timer_calls;
+static uint32_t s_frames_on_bus;
+static uint32_t s_silent_slots;
+static uint32_t s_collisions;
+static uint32_t s_collision_runs;
+static uint32_t s_injected;
+static uart_lin_frame_stat_t s_expect[FRAME_COUNT];
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+/* LIN 2.x protected identifier, written out from the parity equations */
+static uint8_t ref_pid(uint8_t id)
+{
+    uint8_t b[6];
+    uint8_t p0, p1;
+
+    for (uint32_t i = 0; i < 6U; i++) {
+        b[i] = (id >> i) & 1U;
+    }
+    p0 = b[0] ^ b[1] ^ b[2] ^ b[4];
+    p1 = (b[1] ^ b[3] ^ b[4] ^ b[5]) ^ 1U;
+    return (uint8_t)((p1 << 7) | (p0 << 6) | id);
+}
+
+/* inverted eight bit sum with carry, the PID included for the enhanced checksum */
+static uint8_t ref_checksum(uint8_t pid, const uint8_t *data, uint8_t length, bool enhanced)
+{
+    uint32_t sum = enhanced ? pid : 0U;
+
+    for (uint8_t i = 0; i < length; i++) {
+        sum += data[i];
+        if (sum > 0xFFU) {
+            sum -= 0xFFU;
+        }
+    }
+    return (uint8_t)~sum;
+}
+
+static void error(const char *what)
+{
+    printf("slot at %.3f ms, frame %u: %s\n", (double)s_slot.start / 1e6, (unsigned int)s_slot.frame, what);
+    s_errors++;
+}
+
+static void frame_cb(struct uart_lin_master *master, uint8_t frame, uart_lin_stat_t stat, void *cb_context)
+{
+    (void)master;
+    (void)cb_context;
+    s_slot.callbacks++;
+    s_slot.cb_frame = frame;
+    s_slot.cb_stat = stat;
+}
+
+static void uart_wire(void *context, uint8_t byte)
+{
+    (void)context;
+    if (s_master_queued == sizeof(s_master_queue)) {
+        error("master shifter overflow");
+        return;
+    }
+    s_master_queue[s_master_queued++] = byte;
+}
+
+static test_slave_t *slave_of(uint8_t frame)
+{
+    for (uint32_t i = 0; i < ARRAY_SIZE(s_slaves); i++) {
+        if (s_slaves[i].frame == frame) {
+            return &s_slaves[i];
+        }
+    }
+    return NULL;
+}
+
+static void slave_respond(test_slave_t *slave, uint8_t pid)
+{
+    const uart_lin_frame_t *frame = &s_frames[slave->frame];
+
+    memcpy(slave->tx, slave->data, frame->length);
+    slave->tx[frame->length] = ref_checksum(pid, slave->data, frame->length, frame->enhance_checksum);
+    slave->tx_len = frame->length + 1U;
+    slave->tx_pos = 0;
+    slave->tx_active = true;
+    /* slave A sends a bad checksum now and then */
+    if ((slave->frame == FRAME_SUB_A) && ((rnd() % 8U) == 0U)) {
+        slave->tx[frame->length] ^= 0x01U;
+        s_slot.corrupt = true;
+        s_injected++;
+    }
+    s_slot.responders++;
+    s_slot.responder = slave->frame;
+}
+
+/* the PID byte has been read by every node */
+static void bus_header_done(uint8_t pid)
+{
+    test_slave_t *slave;
+
+    s_bus_frame = TEST_NO_FRAME;
+    for (uint8_t i = 0; i < FRAME_COUNT; i++) {
+        if ((s_frames[i].type != uart_lin_frame_sporadic) && (ref_pid(s_frames[i].id) == pid)) {
+            s_bus_frame = i;
+        }
+    }
+    if (s_bus_frame == TEST_NO_FRAME) {
+        return;
+    }
+    if (s_frames[s_bus_frame].type == uart_lin_frame_event_triggered) {
+        for (uint32_t i = 0; i < ARRAY_SIZE(s_slaves); i++) {
+            if (s_slaves[i].et && s_slaves[i].pending) {
+                slave_respond(&s_slaves[i], pid);
+            }
+        }
+    } else if (s_frames[s_bus_frame].type == uart_lin_frame_subscribe) {
+        slave = slave_of(s_bus_frame);
+        if (slave != NULL) {
+            slave_respond(slave, pid);
+        }
+    }
+}
+
+/* a listening slave checks the responses the master publishes */
+static void bus_listen(uint8_t byte)
+{
+    const uart_lin_frame_t *frame;
+    uint8_t pos;
+
+    if ((s_bus_frame == TEST_NO_FRAME) || (s_frames[s_bus_frame].type != uart_lin_frame_publish)) {
+        return;
+    }
+    frame = &s_frames[s_bus_frame];
+    pos = s_frame_pos - 3U;
+    if (pos < frame->length) {
+        s_listen[pos] = byte;
+    } else if (pos == frame->length) {
+        if (byte != ref_checksum(ref_pid(frame->id), s_listen, frame->length, frame->enhance_checksum)) {
+            error("published checksum");
+        }
+        if (memcmp(s_listen, frame->data, frame->length) != 0) {
+            error("published data");
+        }
+    }
+}
+
+static void bus_start_byte(void)
+{
+    bool driven = false;
+    uint8_t byte = 0xFFU;
+
+    if (s_byte_active || s_break) {
+        return;
+    }
+    /* the transmitter takes the next byte from the FIFO */
+    if ((s_master_queued == 0U) && (s_model.tx_level != 0U)) {
+        (void)hpm_host_sim_bus_read((uint32_t)(uintptr_t)&s_uart->LSR, 4);
+    }
+    if (s_master_queued != 0U) {
+        byte &= s_master_queue[0];
+        memmove(s_master_queue, &s_master_queue[1], --s_master_queued);
+        driven = true;
+    }
+    for (uint32_t i = 0; i < ARRAY_SIZE(s_slaves); i++) {
+        s_slaves[i].drove = s_slaves[i].tx_active;
+        if (s_slaves[i].tx_active) {
+            byte &= s_slaves[i].tx[s_slaves[i].tx_pos];
+            driven = true;
+        }
+    }
+    if (!driven) {
+        return;
+    }
+    if (s_slot.bytes == 0U) {
+        s_slot.first_byte = s_now;
+    }
+    s_byte = byte;
+    s_byte_active = true;
+    s_byte_end = s_now + TEST_BYTE_NS;
+    s_busy_ns += TEST_BYTE_NS;
+}
+
+static void bus_end_byte(void)
+{
+    test_slave_t *slave;
+
+    s_byte_active = false;
+    s_slot.last_byte_end = s_now;
+    s_slot.bytes++;
+    for (uint32_t i = 0; i < ARRAY_SIZE(s_slaves); i++) {
+        slave = &s_slaves[i];
+        if (!slave->drove) {
+            continue;
+        }
+        slave->drove = false;
+        if (s_byte != slave->tx[slave->tx_pos]) {
+            /* bit error, the slave stops and keeps its update */
+            slave->tx_active = false;
+        } else if (++slave->tx_pos == slave->tx_len) {
+            slave->tx_active = false;
+            slave->pending = false;
+        }
+    }
+
+    if (s_frame_pos < 2U) {
+        s_slot.header[s_frame_pos] = s_byte;
+    }
+    s_frame_pos++;
+    if (s_frame_pos == 2U) {
+        bus_header_done(s_byte);
+    } else if (s_frame_pos > 2U) {
+        bus_listen(s_byte);
+    }
+
+    if (!hpm_host_sim_uart_receive(&s_model, s_byte)) {
+        error("master RX FIFO overrun");
+    }
+    if ((hpm_host_sim_peek(s_model.block, offsetof(UART_Type, IER)) & uart_intr_rx_data_avail_or_timeout) != 0U) {
+        s_isr_calls++;
+        hpm_uart_lin_master_uart_isr_handler(&s_master);
+    }
+}
+
+/* break control as the master left it after a timer call */
+static void bus_track_break(void)
+{
+    bool bc = (hpm_host_sim_peek(s_model.block, offsetof(UART_Type, LCR)) & UART_LCR_BC_MASK) != 0U;
+
+    if (bc && !s_break) {
+        if (s_byte_active || (s_master_queued != 0U) || (s_model.tx_level != 0U)) {
+            error("break while the bus is busy");
+        }
+        s_break = true;
+        s_slot.breaks = true;
+        s_slot.break_start = s_now;
+        for (uint32_t i = 0; i < ARRAY_SIZE(s_slaves); i++) {
+            s_slaves[i].tx_active = false;
+        }
+    } else if (!bc && s_break) {
+        s_break = false;
+        s_slot.break_end = s_now;
+        s_frame_pos = 0;
+        s_bus_frame = TEST_NO_FRAME;
+        /* the break reads back as a zero byte */
+        (void)hpm_host_sim_uart_receive(&s_model, 0x00);
+    }
+}
+
+/* application side, runs at slot boundaries */
+static void update(bool enabled)
+{
+    test_slave_t *slave;
+
+    if (!enabled) {
+        return;
+    }
+    if ((rnd() % 4U) == 0U) {
+        for (uint8_t i = 0; i < s_frames[FRAME_PUB].length; i++) {
+            s_frames[FRAME_PUB].data[i] = (uint8_t)rnd();
+        }
+    }
+    for (uint32_t j = 0; j < ARRAY_SIZE(s_sporadic_assoc); j++) {
+        uart_lin_frame_t *frame = &s_frames[s_sporadic_assoc[j]];
+
+        if ((rnd() % 6U) == 0U) {
+            for (uint8_t i = 0; i < frame->length; i++) {
+                frame->data[i] = (uint8_t)rnd();
+            }
+            frame->updated = true;
+        }
+    }
+    for (uint32_t j = 0; j < ARRAY_SIZE(s_slaves); j++) {
+        slave = &s_slaves[j];
+        if (slave->et && ((rnd() % 10U) != 0U)) {
+            continue;
+        }
+        for (uint8_t i = 0; i < s_frames[slave->frame].length; i++) {
+            slave->data[i] = (uint8_t)rnd();
+        }
+        /* frames associated with an event triggered frame lead with their PID */
+        if (slave->et) {
+            slave->data[0] = ref_pid(s_frames[slave->frame].id);
+            slave->pending = true;
+        }
+    }
+}
+
+/* the slot the master must start next */
+static void open_slot(uint64_t now)
+{
+    const uart_lin_slot_t *slot;
+    const uart_lin_frame_t *frame;
+
+    if (s_ref_collision) {
+        s_ref_collision = false;
+        s_ref_resume = s_ref_slot;
+        s_ref_table = &s_collision_table;
+        s_ref_slot = 0;
+        s_collision_runs++;
+    } else if (s_ref_slot >= s_ref_table->count) {
+        s_ref_slot = 0;
+        if (s_ref_table == &s_collision_table) {
+            s_ref_table = &s_main_table;
+            s_ref_slot = (s_ref_resume < s_main_table.count) ? s_ref_resume : 0U;
+        }
+    }
+    slot = &s_ref_table->slots[s_ref_slot++];
+
+    memset(&s_slot, 0, sizeof(s_slot));
+    s_slot.start = now;
+    s_slot.end = now + (uint64_t)slot->slot_us * 1000U;
+    s_slot.frame = slot->frame;
+    s_slot.bus_frame = slot->frame;
+    frame = &s_frames[slot->frame];
+    if (frame->type == uart_lin_frame_sporadic) {
+        s_slot.bus_frame = TEST_NO_FRAME;
+        for (uint8_t j = 0; j < frame->assoc_count; j++) {
+            if (s_frames[frame->assoc[j]].updated) {
+                s_slot.bus_frame = frame->assoc[j];
+                break;
+            }
+        }
+    }
+    s_slot_open = true;
+}
+
+/* judge the slot that just ended against the prediction */
+static int close_slot(void)
+{
+    const uart_lin_frame_t *frame;
+    uint8_t expect_frame;
+    uart_lin_stat_t expect_stat;
+    uint64_t nominal_ns;
+
+    if (s_slot.bus_frame == TEST_NO_FRAME) {
+        CHECK(!s_slot.breaks && (s_slot.bytes == 0U) && (s_slot.callbacks == 0U));
+        s_silent_slots++;
+        return 0;
+    }
+    frame = &s_frames[s_slot.bus_frame];
+    s_frames_on_bus++;
+
+    /* slot timing */
+    CHECK(s_slot.breaks && (s_slot.break_start == s_slot.start));
+    CHECK(s_slot.break_end - s_slot.break_start >= 13U * TEST_BIT_NS);
+    CHECK(s_slot.first_byte - s_slot.break_end >= TEST_BIT_NS);
+    CHECK(s_slot.last_byte_end <= s_slot.end);
+    nominal_ns = (34U + 10U * (frame->length + 1U)) * TEST_BIT_NS;
+    CHECK((s_slot.last_byte_end - s_slot.break_start) * 10U <= nominal_ns * 14U);
+
+    /* header */
+    CHECK(s_slot.bytes >= 2U);
+    CHECK((s_slot.header[0] == 0x55U) && (s_slot.header[1] == ref_pid(frame->id)));
+
+    /* outcome */
+    expect_frame = s_slot.bus_frame;
+    if (frame->type == uart_lin_frame_publish) {
+        expect_stat = uart_lin_success;
+    } else if (s_slot.responders == 0U) {
+        expect_stat = uart_lin_timeout;
+    } else if (s_slot.responders > 1U) {
+        expect_stat = uart_lin_collision;
+        s_ref_collision = true;
+        s_collisions++;
+    } else if (s_slot.corrupt) {
+        expect_stat = uart_lin_checksum_error;
+    } else {
+        expect_stat = uart_lin_success;
+        if (frame->type == uart_lin_frame_event_triggered) {
+            expect_frame = s_slot.responder;
+        }
+    }
+    CHECK(s_slot.callbacks == 1U);
+    CHECK((s_slot.cb_frame == expect_frame) && (s_slot.cb_stat == expect_stat));
+    if ((expect_stat == uart_lin_success) && (s_frames[expect_frame].type == uart_lin_frame_subscribe)) {
+        CHECK(s_frames[expect_frame].updated);
+        CHECK(memcmp(s_frames[expect_frame].data, slave_of(expect_frame)->data, s_frames[expect_frame].length) == 0);
+        s_frames[expect_frame].updated = false;
+    }
+
+    switch (expect_stat) {
+    case uart_lin_success:
+        s_expect[expect_frame].ok++;
+        break;
+    case uart_lin_timeout:
+        s_expect[expect_frame].no_response++;
+        break;
+    case uart_lin_checksum_error:
+        s_expect[expect_frame].checksum_error++;
+        break;
+    default:
+        s_expect[expect_frame].collision++;
+        break;
+    }
+    return 0;
+}
+
+/* run the master and the bus until it has started slots slots or has stopped */
+static int run(uint32_t slots, bool updates)
+{
+    static uint64_t timer_at;
+    static uint64_t boundary;
+    uint32_t delay;
+    bool at_boundary;
+
+    while (slots != 0U) {
+        bus_start_byte();
+        if (s_byte_active && (s_byte_end <= timer_at)) {
+            s_now = s_byte_end;
+            bus_end_byte();
+            continue;
+        }
+        s_now = timer_at;
+        at_boundary = (s_now == boundary);
+        delay = hpm_uart_lin_master_timer_handler(&s_master);
+        s_timer_calls++;
+        if (at_boundary) {
+            if (s_slot_open && (close_slot() != 0)) {
+                return 1;
+            }
+            if (delay == 0U) {
+                /* stopped at a slot boundary, no table */
+                s_slot_open = false;
+                return 0;
+            }
+            open_slot(s_now);
+            boundary = s_slot.end;
+            /* after the slot has been judged and the next one picked */
+            update(updates);
+            slots--;
+        }
+        CHECK(delay != 0U);
+        timer_at = s_now + (uint64_t)delay * 1000U;
+        CHECK(timer_at <= boundary);
+        bus_track_break();
+        CHECK(s_errors == 0U);
+    }
+    return 0;
+}
+
+int main(void)
+{
+    uart_lin_master_sched_config_t config;
+    uart_lin_frame_t bad_frames[FRAME_COUNT];
+    uint32_t reads, writes;
+
+    /* PID parity for every identifier */
+    for (uint8_t id = 0; id < 64U; id++) {
+        CHECK(hpm_uart_lin_calculate_protected_id(id) == ref_pid(id));
+    }
+    CHECK((ref_pid(0x00) == 0x80U) && (ref_pid(0x3C) == 0x3CU) && (ref_pid(0x3D) == 0x7DU));
+
+    CHECK(hpm_host_sim_uart_init(&s_model, uart_wire, NULL));
+    s_uart = hpm_host_sim_uart_base(&s_model);
+
+    config.ptr = s_uart;
+    config.baudrate = TEST_BAUDRATE;
+    config.frames = bad_frames;
+    config.frame_count = FRAME_COUNT;
+    config.callback = frame_cb;
+    config.cb_context = NULL;
+    /* an event triggered frame over a publish frame and a length mismatch are refused */
+    memcpy(bad_frames, s_frames, sizeof(s_frames));
+    bad_frames[FRAME_ET_C].type = uart_lin_frame_publish;
+    CHECK(hpm_uart_lin_master_sched_init(&s_master, &config) == uart_lin_invalid_argument);
+    memcpy(bad_frames, s_frames, sizeof(s_frames));
+    bad_frames[FRAME_ET_D].length = 3;
+    CHECK(hpm_uart_lin_master_sched_init(&s_master, &config) == uart_lin_invalid_argument);
+    config.frames = s_frames;
+    CHECK(hpm_uart_lin_master_sched_init(&s_master, &config) == uart_lin_success);
+
+    for (uint32_t j = 0; j < ARRAY_SIZE(s_slaves); j++) {
+        s_slaves[j].data[0] = ref_pid(s_frames[s_slaves[j].frame].id);
+    }
+    /* both event triggered slaves answering wipe out each other's first byte */
+    CHECK((ref_pid(s_frames[FRAME_ET_C].id) & ref_pid(s_frames[FRAME_ET_D].id)) != ref_pid(s_frames[FRAME_ET_C].id));
+    CHECK((ref_pid(s_frames[FRAME_ET_C].id) & ref_pid(s_frames[FRAME_ET_D].id)) != ref_pid(s_frames[FRAME_ET_D].id));
+
+    s_ref_table = &s_main_table;
+    s_bus_frame = TEST_NO_FRAME;
+    hpm_uart_lin_master_set_schedule(&s_master, &s_main_table);
+    hpm_host_sim_block_reset_stat(s_model.block);
+    if (run(TEST_SLOTS - TEST_DRAIN_SLOTS, true) != 0) {
+        return 1;
+    }
+    if (run(TEST_DRAIN_SLOTS, false) != 0) {
+        return 1;
+    }
+    reads = s_model.block->reads;
+    writes = s_model.block->writes;
+
+    /* stop: the running slot ends, then the master goes idle */
+    hpm_uart_lin_master_set_schedule(&s_master, NULL);
+    if (run(UINT32_MAX, false) != 0) {
+        return 1;
+    }
+    CHECK(!s_slot_open && !s_byte_active && (s_master_queued == 0U));
+
+    /* every update has been delivered */
+    for (uint32_t j = 0; j < ARRAY_SIZE(s_slaves); j++) {
+        CHECK(!s_slaves[j].pending);
+        CHECK(memcmp(s_frames[s_slaves[j].frame].data, s_slaves[j].data, s_frames[s_slaves[j].frame].length) == 0);
+    }
+    CHECK(!s_frames[FRAME_SPOR_X].updated && !s_frames[FRAME_SPOR_Y].updated);
+    for (uint32_t i = 0; i < FRAME_COUNT; i++) {
+        CHECK(memcmp(&s_frames[i].stat, &s_expect[i], sizeof(s_expect[i])) == 0);
+    }
+    CHECK((s_collisions != 0U) && (s_collision_runs == s_collisions));
+    CHECK((s_injected != 0U) && (s_frames[FRAME_SUB_A].stat.checksum_error == s_injected));
+    CHECK((s_frames[FRAME_ET].stat.no_response != 0U) && (s_frames[FRAME_ET_C].stat.ok != 0U));
+    CHECK(s_frames[FRAME_SILENT].stat.no_response != 0U);
+    CHECK(s_silent_slots != 0U);
+
+    printf("%u slots at %u baud, %u frames on the bus, %u silent sporadic slots, bus load %.1f %%\n",
+           (unsigned int)TEST_SLOTS, (unsigned int)TEST_BAUDRATE, (unsigned int)s_frames_on_bus,
+           (unsigned int)s_silent_slots, s_busy_ns * 100.0 / (double)s_now);
+    printf("%u collisions each resolved by one collision table run, %u checksum errors injected and caught, "
+           "%u event triggered slots unanswered\n",
+           (unsigned int)s_collisions, (unsigned int)s_injected, (unsigned int)s_frames[FRAME_ET].stat.no_response);
+    printf("per frame: %.2f timer calls, %.2f UART interrupts, %.1f register reads, %.1f writes "
+           "(interrupt per received byte)\n",
+           (double)s_timer_calls / s_frames_on_bus, (double)s_isr_calls / s_frames_on_bus,
+           (double)reads / s_frames_on_bus, (double)writes / s_frames_on_bus);
+
+    hpm_host_sim_uart_deinit(&s_model);
+    return 0;
+}
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "usbd_fake_dcd.h"
+#include "usbd_cdc_acm_stream.h"
+
+/*
+ * CDC ACM streaming layer against the fake DCD, the application echoes what
+ * it reads back to the host. The host sends 1 MiB in writes of random
+ * length and must get it back unchanged. Every completion is checked: the
+ * OUT endpoint is armed exactly while the rx ring has room for a packet, an
+ * IN transfer of whole packets is followed by more data or a ZLP, and a ZLP
+ * only follows such a transfer. Runs with rings large enough to stream and
+ * with a slow application on the smallest rx ring to cover the pause, then
+ * small writes while the IN endpoint is busy to show the coalescing, and a
+ * stop with transfers on the bus, completed or flushed, then a start.
+ *
+ * Each completion interrupt costs TEST_IRQ_NS and the echo costs
+ * TEST_APP_NS_PER_KB, the bus runs meanwhile. Reports the loopback rate in
+ * simulated time next to the per packet echo of the CDC ACM samples: one
+ * max size read, written back, the read armed again once the IN side is
+ * done.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define CDC_OUT_EP           (0x02U)
+#define CDC_IN_EP            (0x81U)
+#define CDC_MPS              (512U)
+#define BUS_BYTES_PER_US     (40U)
+#define TEST_BYTES           (1024U * 1024U)
+#define TEST_MAX_HOST_WRITE  (8192U)
+#define TEST_IRQ_NS          (1500U)
+#define TEST_APP_NS_PER_KB   (1000U)
+#define TEST_SMALL_WRITES    (20000U)
+#define TEST_WRITE_PERIOD_NS (700U)
+
+static struct usbd_cdc_acm_stream s_stream;
+static uint8_t s_rx_pool[16384];
+static uint8_t s_tx_pool[16384];
+static uint8_t s_src[TEST_BYTES];
+static uint8_t s_sink[TEST_BYTES];
+static uint8_t s_app_buf[4096];
+static usbd_endpoint_callback s_out_cb;
+static usbd_endpoint_callback s_in_cb;
+static uint32_t s_out_transfers;
+static uint32_t s_in_transfers;
+static uint32_t s_zlps;
+static uint32_t s_last_in_len;
+static uint32_t s_events[4];
+static uint32_t s_errors;
+static uint32_t s_app_ns_per_kb;
+static uint32_t s_host_sent;
+static uint32_t s_small_written;
+static uint32_t s_small_writes;
+static uint64_t s_small_start_ns;
+static uint32_t s_seed = 1;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static void error(const char *what)
+{
+    printf("at %llu ns: %s\n", (unsigned long long)usbd_fake_dcd_now(), what);
+    s_errors++;
+}
+
+static void check_rx_armed(void)
+{
+    bool room = chry_ringbuffer_get_free(&s_stream.rx_rb) >= CDC_MPS;
+
+    if (s_stream.active && (usbd_fake_dcd_ep(CDC_OUT_EP)->armed != room)) {
+        error(room ? "rx ring has room, OUT endpoint idle" : "OUT endpoint armed without room");
+    }
+}
+
+static void stream_event(struct usbd_cdc_acm_stream *stream, uint32_t event)
+{
+    (void)stream;
+    for (uint32_t i = 0; i < ARRAY_SIZE(s_events); i++) {
+        if (event == (1U << i)) {
+            s_events[i]++;
+        }
+    }
+}
+
+/* completion interrupts of the stream, with the checks around them */
+static void test_bulk_out(uint8_t busid, uint8_t ep, uint32_t nbytes)
+{
+    usbd_fake_dcd_cpu(TEST_IRQ_NS);
+    s_out_transfers++;
+    s_out_cb(busid, ep, nbytes);
+    check_rx_armed();
+}
+
+static void test_bulk_in(uint8_t busid, uint8_t ep, uint32_t nbytes)
+{
+    usbd_fake_ep_t *e = usbd_fake_dcd_ep(ep);
+
+    usbd_fake_dcd_cpu(TEST_IRQ_NS);
+    if (nbytes == 0U) {
+        s_zlps++;
+        if ((s_last_in_len == 0U) || ((s_last_in_len % CDC_MPS) != 0U)) {
+            error("ZLP after a short transfer");
+        }
+    } else {
+        s_in_transfers++;
+    }
+    s_last_in_len = nbytes;
+    s_in_cb(busid, ep, nbytes);
+    if (s_stream.active && !e->armed && (nbytes != 0U) && ((nbytes % CDC_MPS) == 0U)) {
+        error("transfer of whole packets ended without a ZLP");
+    }
+}
+
+static int stream_setup(uint32_t rx_size, uint32_t tx_size, uint32_t app_ns_per_kb)
+{
+    usbd_fake_dcd_reset(BUS_BYTES_PER_US);
+    CHECK(usbd_cdc_acm_stream_init(0, &s_stream, CDC_OUT_EP, CDC_IN_EP, CDC_MPS, s_rx_pool, rx_size, s_tx_pool,
+                                   tx_size, stream_event) == 0);
+    s_out_cb = usbd_fake_dcd_ep(CDC_OUT_EP)->cb;
+    s_in_cb = usbd_fake_dcd_ep(CDC_IN_EP)->cb;
+    usbd_fake_dcd_ep(CDC_OUT_EP)->cb = test_bulk_out;
+    usbd_fake_dcd_ep(CDC_IN_EP)->cb = test_bulk_in;
+    usbd_fake_dcd_host_receive(CDC_IN_EP, s_sink, sizeof(s_sink));
+    s_out_transfers = 0;
+    s_in_transfers = 0;
+    s_zlps = 0;
+    s_last_in_len = 0;
+    s_host_sent = 0;
+    s_app_ns_per_kb = app_ns_per_kb;
+    memset(s_events, 0, sizeof(s_events));
+    memset(s_sink, 0, sizeof(s_sink));
+    return 0;
+}
+
+/* next host write once the previous one is taken */
+static bool host_feed(void)
+{
+    usbd_fake_ep_t *e = usbd_fake_dcd_ep(CDC_OUT_EP);
+    uint32_t len;
+
+    if ((e->out_left != 0U) || (s_host_sent == TEST_BYTES)) {
+        return false;
+    }
+    len = 1U + rnd() % TEST_MAX_HOST_WRITE;
+    len = MIN(len, TEST_BYTES - s_host_sent);
+    usbd_fake_dcd_host_send(CDC_OUT_EP, &s_src[s_host_sent], len);
+    s_host_sent += len;
+    return true;
+}
+
+/* echo what was received, as far as the tx ring takes it */
+static bool app_echo(void)
+{
+    uint32_t len = MIN(usbd_cdc_acm_stream_get_rx_used(&s_stream), usbd_cdc_acm_stream_get_tx_free(&s_stream));
+
+    len = MIN(len, sizeof(s_app_buf));
+    if (len == 0U) {
+        return false;
+    }
+    usbd_fake_dcd_cpu((uint64_t)len * s_app_ns_per_kb / 1024U);
+    if ((usbd_cdc_acm_stream_read(&s_stream, s_app_buf, len) != len)
+     || (usbd_cdc_acm_stream_write(&s_stream, s_app_buf, len) != len)) {
+        error("ring buffer lost data");
+    }
+    check_rx_armed();
+    return true;
+}
+
+static int test_loopback(uint32_t rx_size, uint32_t tx_size, uint32_t app_ns_per_kb, double *mbps)
+{
+    usbd_fake_ep_t *in = usbd_fake_dcd_ep(CDC_IN_EP);
+
+    CHECK(stream_setup(rx_size, tx_size, app_ns_per_kb) == 0);
+    for (uint32_t i = 0; i < TEST_BYTES; i++) {
+        s_src[i] = (uint8_t)rnd();
+    }
+    s_errors = 0;
+    usbd_cdc_acm_stream_start(&s_stream);
+    check_rx_armed();
+
+    while (host_feed() || app_echo() || usbd_fake_dcd_step()) {
+    }
+
+    CHECK(s_errors == 0U);
+    CHECK((in->in_len == TEST_BYTES) && (memcmp(s_sink, s_src, TEST_BYTES) == 0));
+    CHECK((s_stream.rx_bytes == TEST_BYTES) && (s_stream.tx_bytes == TEST_BYTES));
+    CHECK((usbd_fake_dcd_ep(CDC_OUT_EP)->double_arms == 0U) && (in->double_arms == 0U));
+    CHECK(s_events[3] > 0U);
+    CHECK(s_stream.rx_pause_count == s_events[1]);
+    *mbps = (double)TEST_BYTES * 1000.0 / (double)usbd_fake_dcd_now();
+    printf("rx ring %5u, tx ring %5u, echo %4u ns/KiB: loopback %.1f MB/s, %u OUT and %u IN transfers, "
+           "%.0f bytes per IN transfer, %u ZLPs, %u rx pauses\n",
+           (unsigned)rx_size, (unsigned)tx_size, (unsigned)app_ns_per_kb, *mbps, (unsigned)s_out_transfers,
+           (unsigned)s_in_transfers, (double)TEST_BYTES / s_in_transfers, (unsigned)s_zlps,
+           (unsigned)s_stream.rx_pause_count);
+    usbd_cdc_acm_stream_stop(&s_stream);
+    return 0;
+}
+
+/* small writes at a fixed rate, the ones due while the CPU was in an interrupt come late and back to back */
+static void small_write(void *arg)
+{
+    uint32_t len = 1U + rnd() % 40U;
+    uint64_t next;
+
+    (void)arg;
+    len = MIN(len, TEST_BYTES - s_small_written);
+    if (usbd_cdc_acm_stream_write(&s_stream, &s_src[s_small_written], len) != len) {
+        error("tx ring full");
+    }
+    s_small_written += len;
+    if (++s_small_writes < TEST_SMALL_WRITES) {
+        next = s_small_start_ns + (uint64_t)s_small_writes * TEST_WRITE_PERIOD_NS;
+        usbd_fake_dcd_timer((next > usbd_fake_dcd_now()) ? next - usbd_fake_dcd_now() : 0U, small_write, NULL);
+    }
+}
+
+static int test_coalesce(void)
+{
+    usbd_fake_ep_t *in = usbd_fake_dcd_ep(CDC_IN_EP);
+    CHECK(stream_setup(sizeof(s_rx_pool), sizeof(s_tx_pool), TEST_APP_NS_PER_KB) == 0);
+    s_errors = 0;
+    usbd_cdc_acm_stream_start(&s_stream);
+
+    /* one write of whole packets when idle: one transfer and a ZLP */
+    CHECK(usbd_cdc_acm_stream_write(&s_stream, s_src, 4U * CDC_MPS) == 4U * CDC_MPS);
+    usbd_fake_dcd_run();
+    CHECK((s_in_transfers == 1U) && (s_zlps == 1U) && (in->in_len == 4U * CDC_MPS));
+    CHECK(memcmp(s_sink, s_src, 4U * CDC_MPS) == 0);
+
+    usbd_fake_dcd_host_receive(CDC_IN_EP, s_sink, sizeof(s_sink));
+    s_in_transfers = 0;
+    s_zlps = 0;
+    s_small_written = 0;
+    s_small_writes = 0;
+    s_small_start_ns = usbd_fake_dcd_now();
+    usbd_fake_dcd_timer(0, small_write, NULL);
+    usbd_fake_dcd_run();
+    CHECK(s_errors == 0U);
+    CHECK((in->in_len == s_small_written) && (memcmp(s_sink, s_src, s_small_written) == 0));
+    CHECK(s_in_transfers * 4U < s_small_writes);
+    printf("%u writes of 1 - 40 bytes every %u ns: %u IN transfers, %.1f writes per transfer, %u ZLPs\n",
+           (unsigned)s_small_writes, (unsigned)TEST_WRITE_PERIOD_NS, (unsigned)s_in_transfers,
+           (double)s_small_writes / s_in_transfers, (unsigned)s_zlps);
+    usbd_cdc_acm_stream_stop(&s_stream);
+    return 0;
+}
+
+/* stop with both transfers on the bus, then start as on the next SET_CONFIGURATION */
+static int test_stop_start(bool flush)
+{
+    usbd_fake_ep_t *out = usbd_fake_dcd_ep(CDC_OUT_EP);
+    usbd_fake_ep_t *in = usbd_fake_dcd_ep(CDC_IN_EP);
+
+    CHECK(stream_setup(sizeof(s_rx_pool), sizeof(s_tx_pool), TEST_APP_NS_PER_KB) == 0);
+    s_errors = 0;
+    usbd_cdc_acm_stream_start(&s_stream);
+    CHECK(usbd_cdc_acm_stream_write(&s_stream, s_src, 3000) == 3000U);
+    usbd_fake_dcd_host_send(CDC_OUT_EP, s_src, 100);
+    CHECK(out->armed && in->armed);
+
+    usbd_cdc_acm_stream_stop(&s_stream);
+    CHECK(usbd_cdc_acm_stream_write(&s_stream, s_src, 10) == 10U);
+    CHECK(in->double_arms == 0U);
+    if (flush) {
+        /* the bus reset flushes the endpoints, no completion */
+        usbd_ep_close(0, CDC_OUT_EP);
+        usbd_ep_close(0, CDC_IN_EP);
+    } else {
+        usbd_fake_dcd_run();
+        CHECK((usbd_cdc_acm_stream_get_rx_used(&s_stream) == 0U)
+           && (usbd_cdc_acm_stream_get_tx_free(&s_stream) == sizeof(s_tx_pool)));
+    }
+    CHECK(!out->armed && !in->armed);
+
+    usbd_cdc_acm_stream_start(&s_stream);
+    CHECK(out->armed && !in->armed);
+    CHECK((usbd_cdc_acm_stream_get_rx_used(&s_stream) == 0U)
+       && (usbd_cdc_acm_stream_get_tx_free(&s_stream) == sizeof(s_tx_pool)));
+    CHECK((out->double_arms == 0U) && (in->double_arms == 0U));
+
+    /* and echoes again */
+    usbd_fake_dcd_host_receive(CDC_IN_EP, s_sink, sizeof(s_sink));
+    usbd_fake_dcd_host_send(CDC_OUT_EP, s_src, 1000);
+    while (app_echo() || usbd_fake_dcd_step()) {
+    }
+    CHECK((in->in_len == 1000U) && (memcmp(s_sink, s_src, 1000) == 0));
+    CHECK(s_errors == 0U);
+    printf("stop with transfers %s, start: rings empty, no double arm, echoes again\n",
+           flush ? "flushed" : "completed");
+    usbd_cdc_acm_stream_stop(&s_stream);
+    return 0;
+}
+
+/* per packet echo of the CDC ACM samples */
+static uint8_t s_packet[CDC_MPS];
+
+static void packet_bulk_out(uint8_t busid, uint8_t ep, uint32_t nbytes)
+{
+    (void)ep;
+    usbd_fake_dcd_cpu(TEST_IRQ_NS + (uint64_t)nbytes * TEST_APP_NS_PER_KB / 1024U);
+    usbd_ep_start_write(busid, CDC_IN_EP, s_packet, nbytes);
+}
+
+static void packet_bulk_in(uint8_t busid, uint8_t ep, uint32_t nbytes)
+{
+    usbd_fake_dcd_cpu(TEST_IRQ_NS);
+    if ((nbytes != 0U) && ((nbytes % CDC_MPS) == 0U)) {
+        usbd_ep_start_write(busid, ep, NULL, 0);
+    } else {
+        usbd_ep_start_read(busid, CDC_OUT_EP, s_packet, CDC_MPS);
+    }
+}
+
+static int test_packet_echo(double *mbps)
+{
+    static struct usbd_endpoint out_ep = { .ep_addr = CDC_OUT_EP, .ep_cb = packet_bulk_out };
+    static struct usbd_endpoint in_ep = { .ep_addr = CDC_IN_EP, .ep_cb = packet_bulk_in };
+
+    usbd_fake_dcd_reset(BUS_BYTES_PER_US);
+    usbd_add_endpoint(0, &out_ep);
+    usbd_add_endpoint(0, &in_ep);
+    usbd_fake_dcd_host_receive(CDC_IN_EP, s_sink, sizeof(s_sink));
+    s_host_sent = 0;
+    usbd_ep_start_read(0, CDC_OUT_EP, s_packet, CDC_MPS);
+    while (host_feed() || usbd_fake_dcd_step()) {
+    }
+    CHECK((usbd_fake_dcd_ep(CDC_IN_EP)->in_len == TEST_BYTES) && (memcmp(s_sink, s_src, TEST_BYTES) == 0));
+    *mbps = (double)TEST_BYTES * 1000.0 / (double)usbd_fake_dcd_now();
+    printf("per packet echo: loopback %.1f MB/s, %u transfers per direction\n", *mbps,
+           (unsigned)usbd_fake_dcd_ep(CDC_OUT_EP)->starts);
+    return 0;
+}
+
+int main(void)
+{
+    double stream_mbps;
+    double packet_mbps;
+    double mbps;
+
+    if ((test_loopback(sizeof(s_rx_pool), sizeof(s_tx_pool), TEST_APP_NS_PER_KB, &stream_mbps) != 0)
+     || (test_loopback(4096, 4096, TEST_APP_NS_PER_KB, &mbps) != 0)
+     || (test_loopback(2U * CDC_MPS, 4096, 20U * TEST_APP_NS_PER_KB, &mbps) != 0)) {
+        return 1;
+    }
+    CHECK(s_stream.rx_pause_count > 0U);
+    if ((test_coalesce() != 0) || (test_stop_start(false) != 0) || (test_stop_start(true) != 0)) {
+        return 1;
+    }
+    if (test_packet_echo(&packet_mbps) != 0) {
+        return 1;
+    }
+    printf("stream %.1f MB/s against %.1f MB/s per packet, bus %u MB/s shared by both directions\n", stream_mbps,
+           packet_mbps, (unsigned)BUS_BYTES_PER_US);
+    return 0;
+}
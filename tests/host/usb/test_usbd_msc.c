@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "usbd_fake_dcd.h"
+#include "usbd_msc.h"
+#include "usb_scsi.h"
+
+/*
+ * MSC bulk-only transport against a RAM disk. The media charges a latency
+ * plus a rate per access, blocking accesses as CPU time, asynchronous reads
+ * on a timer. Reports MB/s for the buffer count this binary is built with
+ * and checks a media write error mid transfer: the data stage ends with a
+ * stall, the CSW carries the residue and the next command is decoded.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define MSC_OUT_EP          (0x01U)
+#define MSC_IN_EP           (0x81U)
+#define DISK_BLOCK_SIZE     (512U)
+#define DISK_BLOCKS         (1024U)
+#define BUS_BYTES_PER_US    (40U)       /* bulk payload rate of a high speed link */
+#define MEDIA_LATENCY_NS    (100000U)
+#define MEDIA_BYTES_PER_US  (20U)
+#define TEST_LBA            (16U)
+#define TEST_BLOCKS         (256U)
+#define CHUNK_BLOCKS        (CONFIG_USBDEV_MSC_MAX_BUFSIZE / DISK_BLOCK_SIZE)
+
+static uint8_t s_disk[DISK_BLOCKS * DISK_BLOCK_SIZE];
+static uint8_t s_host_out[USB_SIZEOF_MSC_CBW + TEST_BLOCKS * DISK_BLOCK_SIZE];
+static uint8_t s_host_in[TEST_BLOCKS * DISK_BLOCK_SIZE + USB_SIZEOF_MSC_CSW];
+static uint8_t s_pattern[TEST_BLOCKS * DISK_BLOCK_SIZE];
+static uint32_t s_fail_lba = UINT32_MAX;
+static uint32_t s_tag;
+
+static uint64_t media_ns(uint32_t length)
+{
+    return MEDIA_LATENCY_NS + (uint64_t)length * 1000U / MEDIA_BYTES_PER_US;
+}
+
+void usbd_msc_get_cap(uint8_t busid, uint8_t lun, uint32_t *block_num, uint32_t *block_size)
+{
+    (void)busid;
+    (void)lun;
+    *block_num = DISK_BLOCKS;
+    *block_size = DISK_BLOCK_SIZE;
+}
+
+int usbd_msc_sector_read(uint8_t busid, uint8_t lun, uint32_t sector, uint8_t *buffer, uint32_t length)
+{
+    (void)busid;
+    (void)lun;
+    usbd_fake_dcd_cpu(media_ns(length));
+    memcpy(buffer, &s_disk[sector * DISK_BLOCK_SIZE], length);
+    return 0;
+}
+
+int usbd_msc_sector_write(uint8_t busid, uint8_t lun, uint32_t sector, uint8_t *buffer, uint32_t length)
+{
+    (void)busid;
+    (void)lun;
+    usbd_fake_dcd_cpu(media_ns(length));
+    if ((sector + length / DISK_BLOCK_SIZE) > s_fail_lba) {
+        return -1;
+    }
+    memcpy(&s_disk[sector * DISK_BLOCK_SIZE], buffer, length);
+    return 0;
+}
+
+#ifdef CONFIG_USBDEV_MSC_ASYNC_READ
+static struct {
+    uint32_t sector;
+    uint8_t *buffer;
+    uint32_t length;
+} s_async;
+
+static void media_read_done(void *arg)
+{
+    (void)arg;
+    memcpy(s_async.buffer, &s_disk[s_async.sector * DISK_BLOCK_SIZE], s_async.length);
+    usbd_msc_sector_read_done(0, 0);
+}
+
+int usbd_msc_sector_read_async(uint8_t busid, uint8_t lun, uint32_t sector, uint8_t *buffer, uint32_t length)
+{
+    (void)busid;
+    (void)lun;
+    s_async.sector = sector;
+    s_async.buffer = buffer;
+    s_async.length = length;
+    usbd_fake_dcd_timer(media_ns(length), media_read_done, NULL);
+    return 0;
+}
+#endif
+
+/* one bulk-only command, returns the bytes of the data stage the host received */
+static uint32_t bot_command(uint8_t opcode, uint32_t lba, uint16_t blocks, const uint8_t *wdata,
+                            struct CSW *csw, bool *stalled)
+{
+    struct CBW cbw;
+    uint32_t data_len = (uint32_t)blocks * DISK_BLOCK_SIZE;
+    bool read = (opcode == SCSI_CMD_READ10);
+    usbd_fake_ep_t *in = usbd_fake_dcd_ep(MSC_IN_EP);
+
+    memset(&cbw, 0, sizeof(cbw));
+    cbw.dSignature = MSC_CBW_Signature;
+    cbw.dTag = ++s_tag;
+    cbw.dDataLength = data_len;
+    cbw.bmFlags = read ? 0x80U : 0U;
+    cbw.bCBLength = 10;
+    cbw.CB[0] = opcode;
+    SET_BE32(&cbw.CB[2], lba);
+    SET_BE16(&cbw.CB[7], blocks);
+
+    memcpy(s_host_out, &cbw, USB_SIZEOF_MSC_CBW);
+    if (wdata != NULL) {
+        memcpy(&s_host_out[USB_SIZEOF_MSC_CBW], wdata, data_len);
+    }
+    usbd_fake_dcd_host_send(MSC_OUT_EP, s_host_out, USB_SIZEOF_MSC_CBW + ((wdata != NULL) ? data_len : 0U));
+    usbd_fake_dcd_host_receive(MSC_IN_EP, s_host_in, sizeof(s_host_in));
+    usbd_fake_dcd_run();
+
+    /* a stalled data stage: the host clears the halt, drops the rest and reads the CSW */
+    *stalled = usbd_fake_dcd_ep(MSC_OUT_EP)->stalled;
+    if (*stalled) {
+        usbd_fake_dcd_host_clear_halt(MSC_OUT_EP);
+        usbd_fake_dcd_host_send(MSC_OUT_EP, NULL, 0);
+        usbd_fake_dcd_run();
+    }
+    memset(csw, 0, sizeof(*csw));
+    if (in->in_len < USB_SIZEOF_MSC_CSW) {
+        return 0;
+    }
+    memcpy(csw, &s_host_in[in->in_len - USB_SIZEOF_MSC_CSW], USB_SIZEOF_MSC_CSW);
+    return in->in_len - USB_SIZEOF_MSC_CSW;
+}
+
+static bool csw_ok(const struct CSW *csw, uint8_t status, uint32_t residue)
+{
+    return (csw->dSignature == MSC_CSW_Signature) && (csw->dTag == s_tag) && (csw->bStatus == status)
+           && (csw->dDataResidue == residue);
+}
+
+int main(void)
+{
+    struct usbd_interface intf;
+    struct CSW csw;
+    uint64_t start;
+    uint32_t bytes = TEST_BLOCKS * DISK_BLOCK_SIZE;
+    uint32_t chunk = CHUNK_BLOCKS * DISK_BLOCK_SIZE;
+    double write_mbps, read_mbps, serial_mbps;
+    bool stalled;
+
+    usbd_fake_dcd_reset(BUS_BYTES_PER_US);
+    CHECK(usbd_msc_init_intf(0, &intf, MSC_OUT_EP, MSC_IN_EP) != NULL);
+    intf.notify_handler(0, USBD_EVENT_CONFIGURED, NULL);
+    for (uint32_t i = 0; i < sizeof(s_pattern); i++) {
+        s_pattern[i] = (uint8_t)(i * 131U + (i >> 9));
+    }
+
+    start = usbd_fake_dcd_now();
+    CHECK(bot_command(SCSI_CMD_WRITE10, TEST_LBA, TEST_BLOCKS, s_pattern, &csw, &stalled) == 0U);
+    write_mbps = (double)bytes / (double)(usbd_fake_dcd_now() - start) * 1000.0;
+    CHECK(!stalled && csw_ok(&csw, CSW_STATUS_CMD_PASSED, 0));
+    CHECK(memcmp(&s_disk[TEST_LBA * DISK_BLOCK_SIZE], s_pattern, bytes) == 0);
+
+    start = usbd_fake_dcd_now();
+    CHECK(bot_command(SCSI_CMD_READ10, TEST_LBA, TEST_BLOCKS, NULL, &csw, &stalled) == bytes);
+    read_mbps = (double)bytes / (double)(usbd_fake_dcd_now() - start) * 1000.0;
+    CHECK(!stalled && csw_ok(&csw, CSW_STATUS_CMD_PASSED, 0));
+    CHECK(memcmp(s_host_in, s_pattern, bytes) == 0);
+
+    /* media and bus one after the other for every chunk */
+    serial_mbps = (double)chunk / (double)(media_ns(chunk) + (uint64_t)chunk * 1000U / BUS_BYTES_PER_US) * 1000.0;
+    printf("%u x %u byte buffers%s: write %.1f MB/s, read %.1f MB/s, serial media and bus %.1f MB/s\n",
+           CONFIG_USBDEV_MSC_BUF_COUNT, CONFIG_USBDEV_MSC_MAX_BUFSIZE,
+#ifdef CONFIG_USBDEV_MSC_ASYNC_READ
+           ", async read",
+#else
+           "",
+#endif
+           write_mbps, read_mbps, serial_mbps);
+    if (CONFIG_USBDEV_MSC_BUF_COUNT == 1) {
+        CHECK((read_mbps < serial_mbps * 1.05) && (write_mbps < serial_mbps * 1.05));
+    } else {
+        CHECK((read_mbps > serial_mbps * 1.2) && (write_mbps > serial_mbps * 1.2));
+    }
+
+    /* the media fails from the third chunk on, the rest of the data stage is stalled */
+    memset(s_disk, 0, sizeof(s_disk));
+    s_fail_lba = TEST_LBA + 2U * CHUNK_BLOCKS;
+    CHECK(bot_command(SCSI_CMD_WRITE10, TEST_LBA, 8U * CHUNK_BLOCKS, s_pattern, &csw, &stalled) == 0U);
+    CHECK(stalled);
+    CHECK(csw_ok(&csw, CSW_STATUS_CMD_FAILED, 6U * chunk));
+    CHECK(memcmp(&s_disk[TEST_LBA * DISK_BLOCK_SIZE], s_pattern, 2U * chunk) == 0);
+    s_fail_lba = UINT32_MAX;
+
+    /* the next CBW is read into the CBW, not into a block buffer armed before the failure */
+    CHECK(bot_command(SCSI_CMD_TESTUNITREADY, 0, 0, NULL, &csw, &stalled) == 0U);
+    CHECK(!stalled && csw_ok(&csw, CSW_STATUS_CMD_PASSED, 0));
+    CHECK(bot_command(SCSI_CMD_READ10, TEST_LBA, CHUNK_BLOCKS, NULL, &csw, &stalled) == chunk);
+    CHECK(!stalled && csw_ok(&csw, CSW_STATUS_CMD_PASSED, 0));
+    CHECK(memcmp(s_host_in, s_pattern, chunk) == 0);
+
+    /* failing the last chunk: all data is received, the endpoint is not stalled */
+    s_fail_lba = TEST_LBA + CHUNK_BLOCKS;
+    CHECK(bot_command(SCSI_CMD_WRITE10, TEST_LBA, 2U * CHUNK_BLOCKS, s_pattern, &csw, &stalled) == 0U);
+    CHECK(!stalled && csw_ok(&csw, CSW_STATUS_CMD_FAILED, chunk));
+    s_fail_lba = UINT32_MAX;
+    CHECK(bot_command(SCSI_CMD_TESTUNITREADY, 0, 0, NULL, &csw, &stalled) == 0U);
+    CHECK(!stalled && csw_ok(&csw, CSW_STATUS_CMD_PASSED, 0));
+
+    CHECK(usbd_fake_dcd_ep(MSC_OUT_EP)->double_arms == 0U);
+    CHECK(usbd_fake_dcd_ep(MSC_IN_EP)->double_arms == 0U);
+    printf("media write error: stall, failed CSW with residue, next command decoded\n");
+    return 0;
+}
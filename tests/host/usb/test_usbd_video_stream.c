@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "usbd_fake_dcd.h"
+#include "usbd_video_stream.h"
+
+/*
+ * UVC payload engine streaming 600 frames of random sizes through three
+ * buffers against the fake DCD. The host side checks every payload header
+ * (length, FID per frame, EOF on the last payload) and the data, the frame
+ * callback checks each frame comes back unchanged and never while a transfer
+ * the DCD still reads points into it. Every 40 frames the stream is stopped
+ * mid frame, either with the transfer left to complete or after the endpoint
+ * was closed as on SET_INTERFACE alternate setting 0, then started again.
+ * Reports payloads per frame and the bus rate in simulated time.
+ */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            return 1; \
+        } \
+    } while (0)
+
+#define VIDEO_IN_EP        (0x81U)
+#define PAYLOAD_SIZE       (1024U)
+#define PAYLOAD_DATA       (PAYLOAD_SIZE - USBD_VIDEO_STREAM_HEADER_SIZE)
+#define BUS_BYTES_PER_US   (40U)
+#define TEST_FRAMES        (600U)
+#define TEST_BUFFERS       (3U)
+#define TEST_MAX_FRAME     (8U * PAYLOAD_DATA + 17U)
+#define TEST_STOP_EVERY    (40U)
+
+typedef struct {
+    uint8_t mem[USBD_VIDEO_STREAM_HEADROOM + TEST_MAX_FRAME];
+    uint8_t copy[TEST_MAX_FRAME];
+    uint32_t len;
+    bool queued;
+} test_buffer_t;
+
+static struct usbd_video_stream s_stream;
+static test_buffer_t s_buffers[TEST_BUFFERS];
+static uint8_t s_sink[TEST_MAX_FRAME + 16U * PAYLOAD_SIZE];
+static uint32_t s_seed = 1;
+static uint32_t s_sent;
+static uint32_t s_dropped;
+static uint32_t s_errors;
+static uint8_t s_fid;
+static bool s_fid_known;
+
+static uint32_t rnd(void)
+{
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+static test_buffer_t *buffer_of(uint8_t *frame)
+{
+    for (uint32_t i = 0; i < TEST_BUFFERS; i++) {
+        if (frame == &s_buffers[i].mem[USBD_VIDEO_STREAM_HEADROOM]) {
+            return &s_buffers[i];
+        }
+    }
+    return NULL;
+}
+
+static void error(const char *what, uint32_t frame)
+{
+    printf("frame %u: %s\n", (unsigned int)frame, what);
+    s_errors++;
+}
+
+/* the payloads of one frame in the sink, all PAYLOAD_SIZE but the last */
+static void host_check_frame(const test_buffer_t *b)
+{
+    usbd_fake_ep_t *ep = usbd_fake_dcd_ep(VIDEO_IN_EP);
+    uint32_t pos = 0;
+    uint32_t data = 0;
+    uint32_t chunk;
+    const uint8_t *header;
+
+    while (pos < ep->in_len) {
+        chunk = MIN(PAYLOAD_SIZE, ep->in_len - pos);
+        header = &s_sink[pos];
+        if (!s_fid_known) {
+            s_fid = header[1] & USBD_VIDEO_STREAM_BFH_FID;
+            s_fid_known = true;
+        }
+        if ((header[0] != USBD_VIDEO_STREAM_HEADER_SIZE)
+         || (header[1] != (USBD_VIDEO_STREAM_BFH_EOH | s_fid | (((pos + chunk) == ep->in_len) ? USBD_VIDEO_STREAM_BFH_EOF : 0U)))) {
+            error("payload header", s_sent);
+            return;
+        }
+        if ((data + chunk - USBD_VIDEO_STREAM_HEADER_SIZE > b->len)
+         || (memcmp(&header[USBD_VIDEO_STREAM_HEADER_SIZE], &b->copy[data], chunk - USBD_VIDEO_STREAM_HEADER_SIZE) != 0)) {
+            error("payload data", s_sent);
+            return;
+        }
+        data += chunk - USBD_VIDEO_STREAM_HEADER_SIZE;
+        pos += chunk;
+    }
+    if (data != b->len) {
+        error("frame length", s_sent);
+    }
+    s_fid ^= USBD_VIDEO_STREAM_BFH_FID;
+}
+
+static void frame_done(struct usbd_video_stream *stream, uint8_t *frame, bool sent)
+{
+    test_buffer_t *b = buffer_of(frame);
+    usbd_fake_ep_t *ep = usbd_fake_dcd_ep(VIDEO_IN_EP);
+
+    (void)stream;
+    if ((b == NULL) || !b->queued) {
+        error("unknown frame handed back", s_sent);
+        return;
+    }
+    /* the DCD must be done with the payload and its header in the headroom or the previous tail */
+    if (ep->armed && (ep->buf >= b->mem) && (ep->buf < &frame[b->len])) {
+        error("handed back while its transfer is armed", s_sent);
+    }
+    if (memcmp(frame, b->copy, b->len) != 0) {
+        error("frame changed", s_sent);
+    }
+    if (sent) {
+        host_check_frame(b);
+        s_sent++;
+    } else {
+        s_dropped++;
+    }
+    usbd_fake_dcd_host_receive(VIDEO_IN_EP, s_sink, sizeof(s_sink));
+    b->queued = false;
+}
+
+/* fill a free buffer and submit it, false if no buffer is free or both slots are taken */
+static bool produce(void)
+{
+    test_buffer_t *b = NULL;
+    uint32_t len;
+
+    for (uint32_t i = 0; i < TEST_BUFFERS; i++) {
+        if (!s_buffers[i].queued) {
+            b = &s_buffers[i];
+            break;
+        }
+    }
+    if (b == NULL) {
+        return false;
+    }
+    /* single byte frames, whole payloads and odd sizes */
+    switch (rnd() % 4U) {
+    case 0:
+        len = 1U + rnd() % 8U;
+        break;
+    case 1:
+        len = (1U + rnd() % 8U) * PAYLOAD_DATA;
+        break;
+    default:
+        len = 1U + rnd() % TEST_MAX_FRAME;
+        break;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        b->copy[i] = (uint8_t)rnd();
+    }
+    memcpy(&b->mem[USBD_VIDEO_STREAM_HEADROOM], b->copy, len);
+    b->len = len;
+    b->queued = true;
+    if (usbd_video_stream_submit(&s_stream, &b->mem[USBD_VIDEO_STREAM_HEADROOM], len) != 0) {
+        b->queued = false;
+        return false;
+    }
+    return true;
+}
+
+static bool all_returned(void)
+{
+    for (uint32_t i = 0; i < TEST_BUFFERS; i++) {
+        if (s_buffers[i].queued) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(void)
+{
+    struct usbd_video_stream_stat stat;
+    usbd_fake_ep_t *ep;
+    uint32_t stops = 0;
+    uint32_t closes = 0;
+    uint32_t dropped;
+    uint64_t bus_ns;
+
+    usbd_fake_dcd_reset(BUS_BYTES_PER_US);
+    ep = usbd_fake_dcd_ep(VIDEO_IN_EP);
+    usbd_fake_dcd_host_receive(VIDEO_IN_EP, s_sink, sizeof(s_sink));
+    CHECK(usbd_video_stream_init(0, &s_stream, VIDEO_IN_EP, PAYLOAD_SIZE, frame_done) == 0);
+    CHECK(usbd_video_stream_submit(&s_stream, &s_buffers[0].mem[USBD_VIDEO_STREAM_HEADROOM], 1) == -USB_ERR_NOTCONN);
+    usbd_video_stream_start(&s_stream);
+
+    while (s_sent < TEST_FRAMES) {
+        while (produce()) {
+        }
+        CHECK(usbd_fake_dcd_step());
+
+        /* once per TEST_STOP_EVERY frames, at the first chance */
+        if ((s_sent / TEST_STOP_EVERY > stops) && ep->armed && (s_stream.offset != 0U)) {
+            /* mid frame, a payload on the bus and a frame queued behind it */
+            dropped = s_dropped;
+            stops++;
+            if ((stops & 1U) != 0U) {
+                /* the transfer is left to complete: only the queued frame goes back now */
+                usbd_video_stream_stop(&s_stream);
+                CHECK(s_dropped <= dropped + 1U);
+                CHECK(!all_returned());
+                CHECK(usbd_video_stream_submit(&s_stream, s_sink, 1) == -USB_ERR_NOTCONN);
+                CHECK(usbd_fake_dcd_step());
+            } else {
+                /* alternate setting 0: the endpoint is closed, the frame goes back on the next start */
+                CHECK(usbd_ep_close(0, VIDEO_IN_EP) == 0);
+                usbd_video_stream_stop(&s_stream);
+                CHECK(!all_returned());
+                CHECK(!usbd_fake_dcd_step());
+                closes++;
+                usbd_video_stream_start(&s_stream);
+            }
+            CHECK(all_returned());
+            CHECK(!ep->armed);
+            if ((stops & 1U) != 0U) {
+                usbd_video_stream_start(&s_stream);
+            }
+            /* the host drops the partial frame and syncs to the FID again */
+            s_fid_known = false;
+        }
+    }
+    usbd_video_stream_stop(&s_stream);
+    CHECK(usbd_fake_dcd_run() <= 1U);
+    CHECK(all_returned());
+
+    CHECK(s_errors == 0U);
+    CHECK(ep->double_arms == 0U);
+    CHECK((stops >= TEST_FRAMES / TEST_STOP_EVERY - 1U) && (closes >= 1U));
+    bus_ns = usbd_fake_dcd_now();
+    usbd_video_stream_get_stat(&s_stream, 1000, &stat);
+    CHECK(stat.frames == s_sent);
+    CHECK(stat.dropped == s_dropped);
+    printf("%u frames sent, %u dropped over %u stops (%u with the endpoint closed), %.2f payloads per frame, "
+           "%.1f MB/s in simulated time\n",
+           (unsigned int)stat.frames, (unsigned int)stat.dropped, (unsigned int)stops, (unsigned int)closes,
+           (double)stat.payloads / (stat.frames + stat.dropped), (double)stat.bytes * 1000.0 / bus_ns);
+    return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef CHERRYUSB_CONFIG_H
+#define CHERRYUSB_CONFIG_H
+
+/* CherryUSB device classes on the host, against the fake DCD in usbd_fake_dcd.c */
+#include <stdio.h>
+
+#define CHERRYUSB_VERSION     0x010100
+#define CHERRYUSB_VERSION_STR "v1.1.0"
+
+#define CONFIG_USB_PRINTF(...) printf(__VA_ARGS__)
+
+#define usb_malloc(size) malloc(size)
+#define usb_free(ptr)    free(ptr)
+
+#ifndef CONFIG_USB_DBG_LEVEL
+#define CONFIG_USB_DBG_LEVEL USB_DBG_ERROR
+#endif
+
+#define CONFIG_USB_HS
+
+#ifndef CONFIG_USB_ALIGN_SIZE
+#define CONFIG_USB_ALIGN_SIZE 4
+#endif
+
+#define USB_NOCACHE_RAM_SECTION
+
+#define CONFIG_USBDEV_MAX_BUS 1
+#define CONFIG_USBDEV_REQUEST_BUFFER_LEN 512
+
+#ifndef CONFIG_USBDEV_MSC_MAX_LUN
+#define CONFIG_USBDEV_MSC_MAX_LUN 1
+#endif
+
+#ifndef CONFIG_USBDEV_MSC_MAX_BUFSIZE
+#define CONFIG_USBDEV_MSC_MAX_BUFSIZE 512
+#endif
+
+#define CONFIG_USBDEV_MSC_MANUFACTURER_STRING ""
+#define CONFIG_USBDEV_MSC_PRODUCT_STRING ""
+#define CONFIG_USBDEV_MSC_VERSION_STRING "0.01"
+
+#endif
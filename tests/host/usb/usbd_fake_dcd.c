@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "usbd_fake_dcd.h"
+#include "usb_osal.h"
+
+typedef struct {
+    uint64_t at_ns;
+    usbd_fake_dcd_timer_cb_t fn;
+    void *arg;
+} usbd_fake_timer_t;
+
+static usbd_fake_ep_t s_out_ep[USBD_FAKE_DCD_MAX_EP];
+static usbd_fake_ep_t s_in_ep[USBD_FAKE_DCD_MAX_EP];
+static usbd_fake_timer_t s_timers[USBD_FAKE_DCD_MAX_TIMERS];
+static uint64_t s_now_ns;
+static uint64_t s_bus_free_ns;
+static uint32_t s_bytes_per_us = 1;
+
+void usbd_fake_dcd_reset(uint32_t bytes_per_us)
+{
+    memset(s_out_ep, 0, sizeof(s_out_ep));
+    memset(s_in_ep, 0, sizeof(s_in_ep));
+    memset(s_timers, 0, sizeof(s_timers));
+    s_now_ns = 0;
+    s_bus_free_ns = 0;
+    s_bytes_per_us = bytes_per_us;
+}
+
+usbd_fake_ep_t *usbd_fake_dcd_ep(uint8_t ep)
+{
+    return USB_EP_DIR_IS_OUT(ep) ? &s_out_ep[USB_EP_GET_IDX(ep)] : &s_in_ep[USB_EP_GET_IDX(ep)];
+}
+
+void usbd_fake_dcd_host_send(uint8_t ep, const uint8_t *data, uint32_t len)
+{
+    usbd_fake_ep_t *e = usbd_fake_dcd_ep(ep);
+
+    e->out_data = data;
+    e->out_left = len;
+}
+
+void usbd_fake_dcd_host_receive(uint8_t ep, uint8_t *sink, uint32_t size)
+{
+    usbd_fake_ep_t *e = usbd_fake_dcd_ep(ep);
+
+    e->in_sink = sink;
+    e->in_size = size;
+    e->in_len = 0;
+}
+
+void usbd_fake_dcd_host_clear_halt(uint8_t ep)
+{
+    usbd_fake_dcd_ep(ep)->stalled = false;
+}
+
+void usbd_fake_dcd_cpu(uint64_t ns)
+{
+    s_now_ns += ns;
+}
+
+void usbd_fake_dcd_timer(uint64_t ns, usbd_fake_dcd_timer_cb_t fn, void *arg)
+{
+    for (uint32_t i = 0; i < USBD_FAKE_DCD_MAX_TIMERS; i++) {
+        if (s_timers[i].fn == NULL) {
+            s_timers[i].at_ns = s_now_ns + ns;
+            s_timers[i].fn = fn;
+            s_timers[i].arg = arg;
+            return;
+        }
+    }
+    USB_LOG_ERR("fake dcd: out of timers\r\n");
+}
+
+uint64_t usbd_fake_dcd_now(void)
+{
+    return s_now_ns;
+}
+
+/* bytes the armed transfer moves once the bus takes it, 0 if it cannot complete */
+static uint32_t usbd_fake_dcd_ready(usbd_fake_ep_t *e, bool out)
+{
+    if (!e->armed || e->stalled) {
+        return 0;
+    }
+    if (out) {
+        return MIN(e->len, e->out_left);
+    }
+    /* zero length packets complete too */
+    return ((e->in_sink != NULL) && (e->in_len + e->len <= e->in_size)) ? MAX(e->len, 1U) : 0;
+}
+
+bool usbd_fake_dcd_step(void)
+{
+    usbd_fake_ep_t *best = NULL;
+    usbd_fake_timer_t *timer = NULL;
+    uint64_t best_ns = UINT64_MAX;
+    uint64_t done_ns;
+    uint32_t bytes = 0;
+    uint32_t n;
+    uint8_t ep = 0;
+
+    for (uint32_t i = 0; i < 2U * USBD_FAKE_DCD_MAX_EP; i++) {
+        bool out = i < USBD_FAKE_DCD_MAX_EP;
+        usbd_fake_ep_t *e = out ? &s_out_ep[i] : &s_in_ep[i - USBD_FAKE_DCD_MAX_EP];
+
+        n = usbd_fake_dcd_ready(e, out);
+        if (n == 0) {
+            continue;
+        }
+        done_ns = MAX(e->armed_ns, s_bus_free_ns) + ((uint64_t)n * 1000U + s_bytes_per_us - 1U) / s_bytes_per_us;
+        if (done_ns < best_ns) {
+            best_ns = done_ns;
+            best = e;
+            bytes = n;
+            ep = out ? (uint8_t)i : (uint8_t)(0x80U | (i - USBD_FAKE_DCD_MAX_EP));
+        }
+    }
+    for (uint32_t i = 0; i < USBD_FAKE_DCD_MAX_TIMERS; i++) {
+        if ((s_timers[i].fn != NULL) && (s_timers[i].at_ns < best_ns)) {
+            best_ns = s_timers[i].at_ns;
+            timer = &s_timers[i];
+        }
+    }
+
+    if (timer != NULL) {
+        usbd_fake_dcd_timer_cb_t fn = timer->fn;
+
+        s_now_ns = MAX(s_now_ns, best_ns);
+        timer->fn = NULL;
+        fn(timer->arg);
+        return true;
+    }
+    if (best == NULL) {
+        return false;
+    }
+
+    s_bus_free_ns = best_ns;
+    s_now_ns = MAX(s_now_ns, best_ns);
+    best->armed = false;
+    if (USB_EP_DIR_IS_OUT(ep)) {
+        memcpy(best->buf, best->out_data, bytes);
+        best->out_data += bytes;
+        best->out_left -= bytes;
+    } else {
+        bytes = best->len;
+        memcpy(&best->in_sink[best->in_len], best->buf, bytes);
+        best->in_len += bytes;
+    }
+    if (best->cb != NULL) {
+        best->cb(0, ep, bytes);
+    }
+    return true;
+}
+
+uint32_t usbd_fake_dcd_run(void)
+{
+    uint32_t steps = 0;
+
+    while (usbd_fake_dcd_step()) {
+        steps++;
+    }
+    return steps;
+}
+
+void usbd_add_endpoint(uint8_t busid, struct usbd_endpoint *ep)
+{
+    (void)busid;
+    usbd_fake_dcd_ep(ep->ep_addr)->cb = ep->ep_cb;
+}
+
+static int usbd_fake_dcd_arm(uint8_t ep, uint8_t *data, uint32_t data_len)
+{
+    usbd_fake_ep_t *e = usbd_fake_dcd_ep(ep);
+
+    e->starts++;
+    if (e->armed) {
+        e->double_arms++;
+        return -USB_ERR_BUSY;
+    }
+    e->buf = data;
+    e->len = data_len;
+    e->armed_ns = s_now_ns;
+    e->armed = true;
+    return 0;
+}
+
+int usbd_ep_start_write(uint8_t busid, const uint8_t ep, const uint8_t *data, uint32_t data_len)
+{
+    (void)busid;
+    return usbd_fake_dcd_arm(ep, (uint8_t *)data, data_len);
+}
+
+int usbd_ep_start_read(uint8_t busid, const uint8_t ep, uint8_t *data, uint32_t data_len)
+{
+    (void)busid;
+    return usbd_fake_dcd_arm(ep, data, data_len);
+}
+
+/* drops the armed transfer without completing it, as the HPM DCD flushes the endpoint */
+int usbd_ep_close(uint8_t busid, const uint8_t ep)
+{
+    (void)busid;
+    usbd_fake_dcd_ep(ep)->armed = false;
+    return 0;
+}
+
+int usbd_ep_set_stall(uint8_t busid, const uint8_t ep)
+{
+    (void)busid;
+    usbd_fake_dcd_ep(ep)->stalled = true;
+    return 0;
+}
+
+int usbd_ep_clear_stall(uint8_t busid, const uint8_t ep)
+{
+    (void)busid;
+    usbd_fake_dcd_ep(ep)->stalled = false;
+    return 0;
+}
+
+int usbd_ep_is_stalled(uint8_t busid, const uint8_t ep, uint8_t *stalled)
+{
+    (void)busid;
+    *stalled = usbd_fake_dcd_ep(ep)->stalled ? 1U : 0U;
+    return 0;
+}
+
+/* single threaded, endpoint callbacks only run from usbd_fake_dcd_step() */
+size_t usb_osal_enter_critical_section(void)
+{
+    return 0;
+}
+
+void usb_osal_leave_critical_section(size_t flag)
+{
+    (void)flag;
+}
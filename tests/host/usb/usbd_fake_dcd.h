@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 HPMicro
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef USBD_FAKE_DCD_H
+#define USBD_FAKE_DCD_H
+
+#include "usbd_core.h"
+
+/*
+ * Fake device controller for the CherryUSB device classes on the host.
+ *
+ * It implements the usb_dc.h endpoint calls and usbd_add_endpoint(), the
+ * test plays the USB host. Data the host sends on an OUT endpoint is queued
+ * as a byte stream and consumed by the transfers the class starts, data the
+ * class sends on an IN endpoint is appended to a sink per endpoint.
+ *
+ * Time is simulated: the bus moves one transfer at a time at a fixed rate,
+ * a transfer starts when it is armed and the bus is free, so the bus runs in
+ * parallel with CPU time charged by usbd_fake_dcd_cpu(), e.g. a blocking
+ * media access. Timers model work done elsewhere, e.g. an SD card DMA.
+ *
+ * Starting a transfer on an endpoint that already has one armed is counted
+ * as a double arm and the new transfer is ignored, like a controller whose
+ * queue head still holds the first one. usbd_ep_close() drops the armed
+ * transfer without a completion.
+ */
+
+#define USBD_FAKE_DCD_MAX_EP     (8U)
+#define USBD_FAKE_DCD_MAX_TIMERS (4U)
+
+typedef struct {
+    usbd_endpoint_callback cb;
+    uint8_t *buf;                   /**< armed transfer */
+    uint32_t len;
+    uint64_t armed_ns;
+    bool armed;
+    bool stalled;
+    uint32_t starts;                /**< transfers started by the class */
+    uint32_t double_arms;           /**< transfers started while one was armed */
+    /* host side */
+    const uint8_t *out_data;        /**< bytes the host sends, OUT */
+    uint32_t out_left;
+    uint8_t *in_sink;               /**< bytes the host received, IN */
+    uint32_t in_size;
+    uint32_t in_len;
+} usbd_fake_ep_t;
+
+typedef void (*usbd_fake_dcd_timer_cb_t)(void *arg);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reset endpoints, timers and time, the bus moves bytes_per_us bytes per microsecond
+ */
+void usbd_fake_dcd_reset(uint32_t bytes_per_us);
+
+/**
+ * @brief Endpoint state, ep is the endpoint address
+ */
+usbd_fake_ep_t *usbd_fake_dcd_ep(uint8_t ep);
+
+/**
+ * @brief Queue host data on an OUT endpoint, replacing what was left
+ */
+void usbd_fake_dcd_host_send(uint8_t ep, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Collect the data of an IN endpoint in sink, from its start
+ */
+void usbd_fake_dcd_host_receive(uint8_t ep, uint8_t *sink, uint32_t size);
+
+/**
+ * @brief Clear a halt as the host does with CLEAR_FEATURE(ENDPOINT_HALT)
+ */
+void usbd_fake_dcd_host_clear_halt(uint8_t ep);
+
+/**
+ * @brief Charge CPU time, the bus keeps moving armed transfers meanwhile
+ */
+void usbd_fake_dcd_cpu(uint64_t ns);
+
+/**
+ * @brief Call fn at now + ns
+ */
+void usbd_fake_dcd_timer(uint64_t ns, usbd_fake_dcd_timer_cb_t fn, void *arg);
+
+/**
+ * @brief Complete the next transfer or timer in time order
+ *
+ * @return false if nothing can complete: no timer, and every armed transfer
+ * is stalled, has no host data (OUT) or no sink space (IN)
+ */
+bool usbd_fake_dcd_step(void);
+
+/**
+ * @brief Step until nothing can complete, returns the completions
+ */
+uint32_t usbd_fake_dcd_run(void);
+
+/**
+ * @brief Simulated time in ns
+ */
+uint64_t usbd_fake_dcd_now(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USBD_FAKE_DCD_H */